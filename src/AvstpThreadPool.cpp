@@ -0,0 +1,324 @@
+/*****************************************************************************
+
+        AvstpThreadPool.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "AvstpThreadPool.h"
+
+#include <cassert>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*
+==============================================================================
+Name: ctor
+Description:
+	Starts the worker threads.
+Input parameters:
+	- nbr_workers: number of threads to launch, > 0. The threads calling
+		wait_completion() take part in the processing too.
+Throws:
+	std::system_error if a thread cannot be created, memory errors.
+==============================================================================
+*/
+
+AvstpThreadPool::AvstpThreadPool (int nbr_workers)
+:	_nbr_workers (nbr_workers)
+,	_queue_arr ()
+,	_thread_arr ()
+,	_task_pool ()
+,	_disp_pool ()
+,	_sleep_mtx ()
+,	_sleep_cv ()
+,	_wait_cv ()
+{
+	assert (nbr_workers > 0);
+
+	_task_pool.expand_to (256);
+	_disp_pool.expand_to (64);
+
+	_queue_arr.reserve (_nbr_workers);
+	for (int k = 0; k < _nbr_workers; ++k)
+	{
+		_queue_arr.emplace_back (std::make_unique <TaskQueue> ());
+	}
+
+	try
+	{
+		_thread_arr.reserve (_nbr_workers);
+		for (int k = 0; k < _nbr_workers; ++k)
+		{
+			_thread_arr.emplace_back (&AvstpThreadPool::worker_loop, this, k);
+		}
+	}
+	catch (...)
+	{
+		_quit_flag = true;
+		{
+			std::lock_guard <std::mutex> lock (_sleep_mtx);
+		}
+		_sleep_cv.notify_all ();
+		for (auto &t : _thread_arr)
+		{
+			t.join ();
+		}
+		throw;
+	}
+}
+
+
+
+/*
+==============================================================================
+Name: dtor
+Description:
+	Stops and joins the worker threads. All the dispatchers should have been
+	waited for and destroyed before.
+==============================================================================
+*/
+
+AvstpThreadPool::~AvstpThreadPool ()
+{
+	assert (_nbr_queued.load () == 0);
+
+	_quit_flag = true;
+	{
+		// Makes sure no worker is between its predicate check and the wait
+		std::lock_guard <std::mutex> lock (_sleep_mtx);
+	}
+	_sleep_cv.notify_all ();
+
+	for (auto &t : _thread_arr)
+	{
+		t.join ();
+	}
+}
+
+
+
+int	AvstpThreadPool::get_nbr_threads () const noexcept
+{
+	return _nbr_workers + 1;
+}
+
+
+
+AvstpThreadPool::Dispatcher *	AvstpThreadPool::create_dispatcher ()
+{
+	Dispatcher *   disp_ptr = _disp_pool.take_cell (true);
+	if (disp_ptr != nullptr)
+	{
+		disp_ptr->_val._nbr_pending.store (0);
+	}
+
+	return disp_ptr;
+}
+
+
+
+void	AvstpThreadPool::destroy_dispatcher (Dispatcher &disp) noexcept
+{
+	assert (disp._val._nbr_pending.load () == 0);
+
+	_disp_pool.return_cell (disp);
+}
+
+
+
+int	AvstpThreadPool::enqueue_task (Dispatcher &disp, avstp_TaskPtr task_ptr, void *user_data_ptr)
+{
+	if (task_ptr == nullptr)
+	{
+		return avstp_Err_INVALID_ARG;
+	}
+
+	TaskCell *     cell_ptr = _task_pool.take_cell (true);
+	if (cell_ptr == nullptr)
+	{
+		// Out of cells: processes the task synchronously.
+		task_ptr (reinterpret_cast <avstp_TaskDispatcher *> (&disp), user_data_ptr);
+		return avstp_Err_OK;
+	}
+
+	cell_ptr->_val._disp_ptr      = &disp;
+	cell_ptr->_val._task_ptr      = task_ptr;
+	cell_ptr->_val._user_data_ptr = user_data_ptr;
+
+	disp._val._nbr_pending.fetch_add (1);
+
+	int            q_idx = _worker_index;
+	if (q_idx < 0)
+	{
+		q_idx = int (_enq_pos.fetch_add (1) % unsigned (_nbr_workers));
+	}
+	_queue_arr [q_idx]->enqueue (*cell_ptr);
+	_nbr_queued.fetch_add (1);
+
+	const bool     sleep_flag = (_nbr_sleeping.load () > 0);
+	const bool     wait_flag  = (_nbr_waiting.load () > 0);
+	if (sleep_flag || wait_flag)
+	{
+		{
+			std::lock_guard <std::mutex> lock (_sleep_mtx);
+		}
+		if (sleep_flag)
+		{
+			_sleep_cv.notify_one ();
+		}
+		if (wait_flag)
+		{
+			_wait_cv.notify_all ();
+		}
+	}
+
+	return avstp_Err_OK;
+}
+
+
+
+// The calling thread processes the queued tasks while waiting. When there is
+// nothing left to run, it sleeps until the tasks running in the other
+// threads are done or a new task is queued.
+int	AvstpThreadPool::wait_completion (Dispatcher &disp)
+{
+	const int      q_beg = (_worker_index >= 0) ? _worker_index : 0;
+	auto &         nbr_pending = disp._val._nbr_pending;
+
+	while (nbr_pending.load () > 0)
+	{
+		if (! run_one_task (q_beg))
+		{
+			std::unique_lock <std::mutex> lock (_sleep_mtx);
+			_nbr_waiting.fetch_add (1);
+			_wait_cv.wait (lock, [this, &nbr_pending] () {
+				return (nbr_pending.load () <= 0 || _nbr_queued.load () > 0);
+			});
+			_nbr_waiting.fetch_sub (1);
+		}
+	}
+
+	return avstp_Err_OK;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	AvstpThreadPool::worker_loop (int index)
+{
+	_worker_index = index;
+
+	while (! _quit_flag.load ())
+	{
+		if (! run_one_task (index))
+		{
+			std::unique_lock <std::mutex> lock (_sleep_mtx);
+			_nbr_sleeping.fetch_add (1);
+			_sleep_cv.wait (lock, [this] () {
+				return (_nbr_queued.load () > 0 || _quit_flag.load ());
+			});
+			_nbr_sleeping.fetch_sub (1);
+		}
+	}
+}
+
+
+
+// Pops a task from the queue q_beg, or steals one from the other queues.
+// Returns true if a task has been run.
+bool	AvstpThreadPool::run_one_task (int q_beg)
+{
+	assert (q_beg >= 0);
+	assert (q_beg < _nbr_workers);
+
+	int            q_idx = q_beg;
+	for (int k = 0; k < _nbr_workers; ++k)
+	{
+		TaskCell *     cell_ptr = _queue_arr [q_idx]->dequeue ();
+		if (cell_ptr != nullptr)
+		{
+			_nbr_queued.fetch_sub (1);
+			run_task (*cell_ptr);
+			return true;
+		}
+
+		++ q_idx;
+		if (q_idx >= _nbr_workers)
+		{
+			q_idx = 0;
+		}
+	}
+
+	return false;
+}
+
+
+
+void	AvstpThreadPool::run_task (TaskCell &cell) noexcept
+{
+	const Task     task = cell._val;
+	_task_pool.return_cell (cell);
+
+	try
+	{
+		task._task_ptr (
+			reinterpret_cast <avstp_TaskDispatcher *> (task._disp_ptr),
+			task._user_data_ptr
+		);
+	}
+	catch (...)
+	{
+		assert (false);
+	}
+
+	// The dispatcher may be destroyed as soon as the counter reaches 0,
+	// don't access it afterwards.
+	const int      nbr_left = task._disp_ptr->_val._nbr_pending.fetch_sub (1) - 1;
+	if (nbr_left <= 0 && _nbr_waiting.load () > 0)
+	{
+		{
+			// Makes sure no waiter is between its predicate check and the wait
+			std::lock_guard <std::mutex> lock (_sleep_mtx);
+		}
+		_wait_cv.notify_all ();
+	}
+}
+
+
+
+thread_local int	AvstpThreadPool::_worker_index = -1;
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,163 @@
+/*****************************************************************************
+
+        AvstpThreadPool.h
+        Author: Laurent de Soras, 2024
+
+Portable thread pool used by AvstpWrapper when the avstp library is not
+available. It implements the same dispatcher/task semantics.
+
+Each worker thread owns a lock-free task queue. Tasks enqueued from a worker
+go to its own queue, the other ones are distributed in a round-robin manner.
+Idle workers steal tasks from the other queues before going to sleep.
+A thread waiting for the completion of a dispatcher runs the pending tasks
+too, so the number of running threads is the number of workers + 1.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (AvstpThreadPool_HEADER_INCLUDED)
+#define	AvstpThreadPool_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma once
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "conc/CellPool.h"
+#include "conc/LockFreeCell.h"
+#include "conc/LockFreeQueue.h"
+#include "avstp.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+class AvstpThreadPool
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	class DispData
+	{
+	public:
+		std::atomic <int>
+		               _nbr_pending { 0 };
+	};
+	typedef conc::LockFreeCell <DispData> Dispatcher;
+
+	explicit       AvstpThreadPool (int nbr_workers);
+	virtual        ~AvstpThreadPool ();
+
+	int            get_nbr_threads () const noexcept;
+	Dispatcher *   create_dispatcher ();
+	void           destroy_dispatcher (Dispatcher &disp) noexcept;
+	int            enqueue_task (Dispatcher &disp, avstp_TaskPtr task_ptr, void *user_data_ptr);
+	int            wait_completion (Dispatcher &disp);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	class Task
+	{
+	public:
+		Dispatcher *   _disp_ptr      = nullptr;
+		avstp_TaskPtr  _task_ptr      = nullptr;
+		void *         _user_data_ptr = nullptr;
+	};
+
+	typedef conc::LockFreeQueue <Task> TaskQueue;
+	typedef TaskQueue::CellType TaskCell;
+	typedef std::unique_ptr <TaskQueue> TaskQueueUPtr;
+
+	void           worker_loop (int index);
+	bool           run_one_task (int q_beg);
+	void           run_task (TaskCell &cell) noexcept;
+
+	const int      _nbr_workers;
+	std::vector <TaskQueueUPtr>         // One queue per worker
+	               _queue_arr;
+	std::vector <std::thread>
+	               _thread_arr;
+	conc::CellPool <Task>
+	               _task_pool;
+	conc::CellPool <DispData>
+	               _disp_pool;
+
+	std::atomic <int>                   // Tasks waiting in the queues
+	               _nbr_queued { 0 };
+	std::atomic <int>                   // Workers waiting on the condition
+	               _nbr_sleeping { 0 };
+	std::atomic <int>                   // Threads blocked in wait_completion()
+	               _nbr_waiting { 0 };
+	std::atomic <unsigned int>          // Round-robin for external threads
+	               _enq_pos { 0 };
+	std::atomic <bool>
+	               _quit_flag { false };
+	std::mutex     _sleep_mtx;
+	std::condition_variable
+	               _sleep_cv;
+	std::condition_variable             // For the threads in wait_completion()
+	               _wait_cv;
+
+	// Index of the worker running the current thread, -1 if external
+	static thread_local int
+	               _worker_index;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               AvstpThreadPool ()                               = delete;
+	               AvstpThreadPool (const AvstpThreadPool &other)   = delete;
+	               AvstpThreadPool (AvstpThreadPool &&other)        = delete;
+	AvstpThreadPool &
+	               operator = (const AvstpThreadPool &other)        = delete;
+	AvstpThreadPool &
+	               operator = (AvstpThreadPool &&other)             = delete;
+	bool           operator == (const AvstpThreadPool &other) const = delete;
+	bool           operator != (const AvstpThreadPool &other) const = delete;
+
+};	// class AvstpThreadPool
+
+
+
+//#include "AvstpThreadPool.hpp"
+
+
+
+#endif	// AvstpThreadPool_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -18,6 +18,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #if defined (_MSC_VER)
 	#pragma warning (1 : 4130 4223 4705 4706)
 	#pragma warning (4 : 4355 4786 4800)
+	#pragma warning (disable : 4996) // getenv
 #endif
 
 
@@ -38,15 +39,19 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #if defined (_MSC_VER)
  #include "AvstpFinder.h"
 #endif
+#include "AvstpThreadPool.h"
 #include "AvstpWrapper.h"
 
 #if defined (_MSC_VER)
  #include "Windows.h"
 #endif
 
+#include <algorithm>
 #include <stdexcept>
+#include <thread>
 
 #include <cassert>
+#include <cstdlib>
 
 
 
@@ -54,16 +59,43 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 
 
+AvstpWrapper::PoolRef::PoolRef ()
+{
+	use_instance ().retain_pool ();
+}
+
+
+
+AvstpWrapper::PoolRef::PoolRef (const PoolRef &)
+{
+	use_instance ().retain_pool ();
+}
+
+
+
+AvstpWrapper::PoolRef::~PoolRef ()
+{
+	use_instance ().release_pool ();
+}
+
+
+
 /*
 ==============================================================================
 Name: dtor
 	Please do not destroy directly the object. This will be done automatically
 	at the end of the process.
+	The built-in thread pool should have been stopped at this point, when the
+	host released the last filter. Joining threads from here is unsafe when
+	the library is being unloaded.
 ==============================================================================
 */
 
 AvstpWrapper::~AvstpWrapper ()
 {
+	assert (_pool_ref_cnt == 0);
+	_pool_uptr.reset ();
+
 #if defined (_MSC_VER)
 	::FreeLibrary (reinterpret_cast < ::HMODULE> (_dll_hnd));
 	_dll_hnd = 0;
@@ -161,6 +193,9 @@ AvstpWrapper::AvstpWrapper ()
 		0
 #endif
 	)
+,	_pool_uptr ()
+,	_pool_mtx ()
+,	_pool_ref_cnt (0)
 {
 #if defined (_MSC_VER)
 	if (_dll_hnd == 0)
@@ -173,6 +208,7 @@ AvstpWrapper::AvstpWrapper ()
 #endif
 //		throw std::runtime_error ("Cannot find avstp.dll.");
 #endif
+		// The built-in pool is started on demand, see retain_pool().
 		assign_fallback ();
 #if defined (_MSC_VER)
 	}
@@ -243,6 +279,72 @@ void	AvstpWrapper::assign_fallback ()
 
 
 
+// Returns false if the pool cannot or should not be used.
+bool	AvstpWrapper::assign_pool ()
+{
+	const int      nbr_threads = compute_nbr_pool_threads ();
+	if (nbr_threads <= 1)
+	{
+		return false;
+	}
+
+	try
+	{
+		_pool_uptr = std::make_unique <AvstpThreadPool> (nbr_threads - 1);
+	}
+	catch (...)
+	{
+		_pool_uptr.reset ();
+		return false;
+	}
+
+	_avstp_get_interface_version_ptr = &fallback_get_interface_version_ptr;
+	_avstp_create_dispatcher_ptr     = &pool_create_dispatcher_ptr;
+	_avstp_destroy_dispatcher_ptr    = &pool_destroy_dispatcher_ptr;
+	_avstp_get_nbr_threads_ptr       = &pool_get_nbr_threads_ptr;
+	_avstp_enqueue_task_ptr          = &pool_enqueue_task_ptr;
+	_avstp_wait_completion_ptr       = &pool_wait_completion_ptr;
+
+	return true;
+}
+
+
+
+// Starts the built-in pool if this is the first reference.
+// Falls back to serial processing if the pool cannot be started.
+void	AvstpWrapper::retain_pool ()
+{
+	std::lock_guard <std::mutex> lock (_pool_mtx);
+
+	if (_pool_ref_cnt == 0 && _dll_hnd == 0)
+	{
+		if (! assign_pool ())
+		{
+			assign_fallback ();
+		}
+	}
+	++ _pool_ref_cnt;
+}
+
+
+
+// Stops the built-in pool and joins its threads when the last reference is
+// released. All the dispatchers must have been destroyed before.
+void	AvstpWrapper::release_pool () noexcept
+{
+	std::lock_guard <std::mutex> lock (_pool_mtx);
+
+	assert (_pool_ref_cnt > 0);
+	-- _pool_ref_cnt;
+	if (_pool_ref_cnt == 0 && _pool_uptr)
+	{
+		assign_fallback ();
+		_pool_uptr.reset ();
+	}
+}
+
+
+
 int	AvstpWrapper::fallback_get_interface_version_ptr ()
 {
 	return (avstp_INTERFACE_VERSION);
@@ -310,6 +412,93 @@ int	AvstpWrapper::fallback_wait_completion_ptr (avstp_TaskDispatcher *td_ptr)
 
 
 
+avstp_TaskDispatcher *	AvstpWrapper::pool_create_dispatcher_ptr ()
+{
+	AvstpThreadPool & pool = *use_instance ()._pool_uptr;
+
+	return reinterpret_cast <avstp_TaskDispatcher *> (
+		pool.create_dispatcher ()
+	);
+}
+
+
+
+void	AvstpWrapper::pool_destroy_dispatcher_ptr (avstp_TaskDispatcher *td_ptr)
+{
+	if (td_ptr != nullptr)
+	{
+		AvstpThreadPool & pool = *use_instance ()._pool_uptr;
+		pool.destroy_dispatcher (
+			*reinterpret_cast <AvstpThreadPool::Dispatcher *> (td_ptr)
+		);
+	}
+}
+
+
+
+int	AvstpWrapper::pool_get_nbr_threads_ptr ()
+{
+	return use_instance ()._pool_uptr->get_nbr_threads ();
+}
+
+
+
+int	AvstpWrapper::pool_enqueue_task_ptr (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr)
+{
+	if (td_ptr == nullptr)
+	{
+		return avstp_Err_INVALID_ARG;
+	}
+
+	AvstpThreadPool & pool = *use_instance ()._pool_uptr;
+
+	return pool.enqueue_task (
+		*reinterpret_cast <AvstpThreadPool::Dispatcher *> (td_ptr),
+		task_ptr, user_data_ptr
+	);
+}
+
+
+
+int	AvstpWrapper::pool_wait_completion_ptr (avstp_TaskDispatcher *td_ptr)
+{
+	if (td_ptr == nullptr)
+	{
+		return avstp_Err_INVALID_ARG;
+	}
+
+	AvstpThreadPool & pool = *use_instance ()._pool_uptr;
+
+	return pool.wait_completion (
+		*reinterpret_cast <AvstpThreadPool::Dispatcher *> (td_ptr)
+	);
+}
+
+
+
+// Total number of threads for the built-in pool, including the threads
+// waiting for the task completion. Defaults to the number of hardware
+// threads. The FMTCONV_NBR_THREADS environment variable overrides it,
+// 1 disables the pool.
+int	AvstpWrapper::compute_nbr_pool_threads ()
+{
+	int            nbr_threads = int (std::thread::hardware_concurrency ());
+
+	const char *   nt_0 = std::getenv ("FMTCONV_NBR_THREADS");
+	if (nt_0 != nullptr && nt_0 [0] != '\0')
+	{
+		const long     val = std::strtol (nt_0, nullptr, 10);
+		if (val > 0)
+		{
+			nbr_threads = int (std::min (val, 1024L));
+		}
+	}
+
+	return nbr_threads;
+}
+
+
+
 int	AvstpWrapper::_dummy_dispatcher;
 
 
@@ -40,8 +40,13 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "avstp.h"
 
+#include <memory>
+#include <mutex>
 
 
+
+class AvstpThreadPool;
+
 class AvstpWrapper
 {
 
@@ -49,6 +54,19 @@ class AvstpWrapper
 
 public:
 
+	// Keeps the built-in thread pool running during its lifetime. The pool
+	// is started with the first reference and its threads are joined when
+	// the last one is released, so the objects dispatching tasks should hold
+	// one. The wrapped functions should not be called without a reference.
+	class PoolRef
+	{
+	public:
+		               PoolRef ();
+		               PoolRef (const PoolRef &other);
+		               ~PoolRef ();
+		PoolRef &      operator = (const PoolRef &other) = default;
+	};
+
 	virtual        ~AvstpWrapper ();
 
 	static AvstpWrapper &
@@ -82,6 +100,9 @@ private:
 
 	void           assign_normal ();
 	void           assign_fallback ();
+	bool           assign_pool ();
+	void           retain_pool ();
+	void           release_pool () noexcept;
 
 	static int     fallback_get_interface_version_ptr ();
 	static avstp_TaskDispatcher *
@@ -91,6 +112,14 @@ private:
 	static int     fallback_enqueue_task_ptr (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr);
 	static int     fallback_wait_completion_ptr (avstp_TaskDispatcher *td_ptr);
 
+	static avstp_TaskDispatcher *
+	               pool_create_dispatcher_ptr ();
+	static void    pool_destroy_dispatcher_ptr (avstp_TaskDispatcher *td_ptr);
+	static int     pool_get_nbr_threads_ptr ();
+	static int     pool_enqueue_task_ptr (avstp_TaskDispatcher *td_ptr, avstp_TaskPtr task_ptr, void *user_data_ptr);
+	static int     pool_wait_completion_ptr (avstp_TaskDispatcher *td_ptr);
+	static int     compute_nbr_pool_threads ();
+
 	int            (*_avstp_get_interface_version_ptr) ();
 	avstp_TaskDispatcher *
 	               (*_avstp_create_dispatcher_ptr) ();
@@ -101,6 +130,12 @@ private:
 
 	void *         _dll_hnd;	// Avoids loading windows.h just for HMODULE
 
+	// Built-in thread pool, used when the avstp library is not available
+	std::unique_ptr <AvstpThreadPool>
+	               _pool_uptr;
+	std::mutex     _pool_mtx;
+	int            _pool_ref_cnt;    // Number of living PoolRef, under _pool_mtx
+
 	static int     _dummy_dispatcher;
 
 
@@ -28,13 +28,19 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/Dither.h"
+#include "fmtcl/PerfTrace.h"
 #include "vsutl/FilterBase.h"
+#include "vsutl/FrameRefSPtr.h"
 #include "vsutl/NodeRefSPtr.h"
 #include "vsutl/PlaneProcCbInterface.h"
 #include "vsutl/PlaneProcessor.h"
+#include "avstp.h"
+#include "AvstpWrapper.h"
 #include "VapourSynth4.h"
 
+#include <array>
 #include <memory>
+#include <string>
 
 
 
@@ -80,8 +86,41 @@ protected:
 
 private:
 
+	// Data for a single plane processed asynchronously
+	class TaskPlane
+	{
+	public:
+		Bitdepth *     _this_ptr     = nullptr;
+		vsutl::FrameRefSPtr           // Keeps the source frame alive
+		               _src_sptr;
+		uint8_t *      _dst_ptr      = nullptr;
+		ptrdiff_t      _dst_stride   = 0;
+		const uint8_t* _src_ptr      = nullptr;
+		ptrdiff_t      _src_stride   = 0;
+		int            _w            = 0;
+		int            _h            = 0;
+		int            _frame_index  = 0;
+		int            _plane_index  = 0;
+		std::string    _err_msg;      // Empty if the processing succeeded
+		fmtcl::PerfTrace::FrameCapture * // Capture of the requesting thread, may be 0
+		               _capture_ptr  = nullptr;
+	};
+
+	// Passed as frame_data_ptr to do_process_plane() in multi-threaded mode
+	class TaskFrame
+	{
+	public:
+		avstp_TaskDispatcher *
+		               _dispatcher_ptr = nullptr;
+		std::array <TaskPlane, fmtcl::Dither::_max_nbr_planes>
+		               _plane_arr;
+	};
+
 	::VSVideoFormat
 	               get_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSCore &core, const ::VSVideoFormat &fmt_src) const;
+	void           process_task_plane (TaskPlane &tp) noexcept;
+
+	static void    redirect_task_plane (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
 
 	vsutl::NodeRefSPtr
 	               _clip_src_sptr;
@@ -99,6 +138,16 @@ private:
 	std::unique_ptr <fmtcl::Dither>
 	               _engine_uptr;
 
+	// Processes the planes of a frame concurrently. The engine keeps the
+	// error diffusion serial within a plane so the output is identical.
+	bool           _mt_flag             = false;
+	AvstpWrapper::PoolRef
+	               _avstp_ref;
+	AvstpWrapper & _avstp;
+
+	// Single pass on the 3 planes, when the engine supports it
+	bool           _proc_3p_flag        = false;
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
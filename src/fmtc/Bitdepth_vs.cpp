@@ -60,6 +60,8 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 #if defined (_MSC_VER)
 #pragma warning (pop)
 #endif
+,	_avstp_ref ()
+,	_avstp (AvstpWrapper::use_instance ())
 {
 	fstb::unused (user_data_ptr);
 
@@ -85,6 +87,7 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 		                                                 && res <= 12)
 		                                             || res == 14
 		                                             || res == 16))
+		       || (st == ::stFloat   && bps == 2 &&     res == 16 )
 		       || (st == ::stFloat   && bps == 4 &&     res == 32 )))
 		{
 			throw_inval_arg ("input pixel bitdepth not supported.");
@@ -116,6 +119,7 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 		                                             || res == 10
 		                                             || res == 12
 		                                             || res == 16))
+		       || (st == ::stFloat   && bps == 2 &&     res == 16 )
 		       || (st == ::stFloat   && bps == 4 &&     res == 32 )))
 		{
 			throw_inval_arg ("output pixel bitdepth not supported.");
@@ -182,6 +186,8 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 	const bool     correlated_planes_flag = (get_arg_int (in, out, "corplane", 0) != 0);
 	const bool     tpdfo_flag = (get_arg_int (in, out, "tpdfo", 0) != 0);
 	const bool     tpdfn_flag = (get_arg_int (in, out, "tpdfn", 0) != 0);
+	_mt_flag = (get_arg_int (in, out, "mt", 0) != 0);
+	const bool     ed3p_flag = (get_arg_int (in, out, "ed3p", 1) != 0);
 
 	_engine_uptr = std::make_unique <fmtcl::Dither> (
 		splfmt_src, fmt_src.bitsPerSample, _full_range_in_flag,
@@ -192,6 +198,29 @@ Bitdepth::Bitdepth (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 		tpdfo_flag, tpdfn_flag,
 		sse2_flag, avx2_flag
 	);
+
+	// The 3 planes can be dithered in a single pass when they share the
+	// same size and are all processed.
+	if (   ed3p_flag
+	    && ! _mt_flag
+	    && fmt_dst.numPlanes == fmtcl::ProcComp3Arg::_nbr_planes
+	    && fmt_dst.subSamplingW == 0
+	    && fmt_dst.subSamplingH == 0
+	    && _engine_uptr->can_process_3_planes ())
+	{
+		_proc_3p_flag = true;
+		for (int plane_index = 0
+		;	plane_index < fmtcl::ProcComp3Arg::_nbr_planes
+		;	++ plane_index)
+		{
+			const vsutl::PlaneProcMode proc_mode =
+				_plane_processor.get_mode (plane_index);
+			if (proc_mode != vsutl::PlaneProcMode_PROCESS)
+			{
+				_proc_3p_flag = false;
+			}
+		}
+	}
 }
 
 
@@ -232,13 +261,65 @@ const ::VSFrame *	Bitdepth::get_frame (int n, int activation_reason, void * &fra
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.bitdepth");
+
 		const int      w = _vsapi.getFrameWidth (&src, 0);
 		const int      h = _vsapi.getFrameHeight (&src, 0);
 		dst_ptr = _vsapi.newVideoFrame (&_vi_out.format, w, h, &src, &core);
 
-		const int      ret_val = _plane_processor.process_frame (
-			*dst_ptr, n, frame_data_ptr, frame_ctx, core, _clip_src_sptr
-		);
+		// In multi-threaded mode, do_process_plane() only enqueues the
+		// planes. We wait for all of them here.
+		TaskFrame      task_frame;
+		void *         proc_data_ptr = frame_data_ptr;
+		if (_mt_flag)
+		{
+			task_frame._dispatcher_ptr = _avstp.create_dispatcher ();
+			proc_data_ptr = &task_frame;
+		}
+
+		int            ret_val = 0;
+		if (_proc_3p_flag)
+		{
+			try
+			{
+				const fmtcl::ProcComp3Arg  pa =
+					build_mat_proc (_vsapi, *dst_ptr, src);
+				_engine_uptr->process_3_planes (pa, n);
+			}
+			catch (std::exception &e)
+			{
+				_vsapi.setFilterError (e.what (), &frame_ctx);
+				ret_val = -1;
+			}
+			catch (...)
+			{
+				_vsapi.setFilterError ("bitdepth: exception.", &frame_ctx);
+				ret_val = -1;
+			}
+		}
+		else
+		{
+			ret_val = _plane_processor.process_frame (
+				*dst_ptr, n, proc_data_ptr, frame_ctx, core, _clip_src_sptr
+			);
+		}
+
+		if (_mt_flag)
+		{
+			_avstp.wait_completion (task_frame._dispatcher_ptr);
+			_avstp.destroy_dispatcher (task_frame._dispatcher_ptr);
+			task_frame._dispatcher_ptr = nullptr;
+
+			for (const auto &tp : task_frame._plane_arr)
+			{
+				if (ret_val == 0 && ! tp._err_msg.empty ())
+				{
+					_vsapi.setFilterError (tp._err_msg.c_str (), &frame_ctx);
+					ret_val = -1;
+				}
+			}
+		}
+
 		if (ret_val != 0)
 		{
 			_vsapi.freeFrame (dst_ptr);
@@ -252,6 +333,11 @@ const ::VSFrame *	Bitdepth::get_frame (int n, int activation_reason, void * &fra
 			const int      cr_val = (_full_range_out_flag) ? 0 : 1;
 			_vsapi.mapSetInt (&dst_prop, "_ColorRange", cr_val, ::maReplace);
 		}
+
+		if (dst_ptr != nullptr)
+		{
+			export_perf_capture (perf_capture, *dst_ptr, _vsapi);
+		}
 	}
 
 	return dst_ptr;
@@ -289,24 +375,49 @@ int	Bitdepth::do_process_plane (::VSFrame &dst, int n, int plane_index, void *fr
 		uint8_t *      data_dst_ptr = _vsapi.getWritePtr (&dst, plane_index);
 		const auto     stride_dst   = _vsapi.getStride (&dst, plane_index);
 
-		try
+		if (_mt_flag)
 		{
-			_engine_uptr->process_plane (
-				data_dst_ptr, stride_dst,
-				data_src_ptr, stride_src,
-				w, h, n, plane_index
+			assert (frame_data_ptr != nullptr);
+			TaskFrame &    task_frame =
+				*reinterpret_cast <TaskFrame *> (frame_data_ptr);
+			TaskPlane &    tp = task_frame._plane_arr [plane_index];
+			tp._this_ptr    = this;
+			tp._src_sptr    = src_sptr;
+			tp._dst_ptr     = data_dst_ptr;
+			tp._dst_stride  = stride_dst;
+			tp._src_ptr     = data_src_ptr;
+			tp._src_stride  = stride_src;
+			tp._w           = w;
+			tp._h           = h;
+			tp._frame_index = n;
+			tp._plane_index = plane_index;
+			tp._capture_ptr = fmtcl::PerfTrace::get_thread_capture ();
+			_avstp.enqueue_task (
+				task_frame._dispatcher_ptr, &redirect_task_plane, &tp
 			);
 		}
 
-		catch (std::exception &e)
-		{
-			_vsapi.setFilterError (e.what (), &frame_ctx);
-			ret_val = -1;
-		}
-		catch (...)
+		else
 		{
-			_vsapi.setFilterError ("bitdepth: exception.", &frame_ctx);
-			ret_val = -1;
+			try
+			{
+				_engine_uptr->process_plane (
+					data_dst_ptr, stride_dst,
+					data_src_ptr, stride_src,
+					w, h, n, plane_index
+				);
+			}
+
+			catch (std::exception &e)
+			{
+				_vsapi.setFilterError (e.what (), &frame_ctx);
+				ret_val = -1;
+			}
+			catch (...)
+			{
+				_vsapi.setFilterError ("bitdepth: exception.", &frame_ctx);
+				ret_val = -1;
+			}
 		}
 	}
 
@@ -412,6 +523,40 @@ int	Bitdepth::do_process_plane (::VSFrame &dst, int n, int plane_index, void *fr
 
 
 
+void	Bitdepth::process_task_plane (TaskPlane &tp) noexcept
+{
+	fmtcl::PerfTrace::ThreadLink  perf_link (tp._capture_ptr);
+
+	try
+	{
+		_engine_uptr->process_plane (
+			tp._dst_ptr, tp._dst_stride,
+			tp._src_ptr, tp._src_stride,
+			tp._w, tp._h, tp._frame_index, tp._plane_index
+		);
+	}
+	catch (std::exception &e)
+	{
+		tp._err_msg = e.what ();
+	}
+	catch (...)
+	{
+		tp._err_msg = "bitdepth: exception.";
+	}
+}
+
+
+
+void	Bitdepth::redirect_task_plane (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr)
+{
+	fstb::unused (dispatcher_ptr);
+
+	TaskPlane *    tp_ptr = reinterpret_cast <TaskPlane *> (data_ptr);
+	tp_ptr->_this_ptr->process_task_plane (*tp_ptr);
+}
+
+
+
 }	// namespace fmtc
 
 
@@ -3,10 +3,6 @@
         Convert.cpp
         Author: Laurent de Soras, 2014
 
-	========================
-	*** WORK IN PROGRESS ***
-	========================
-
 --- Legal stuff ---
 
 This program is free software. It comes without any warranty, to
@@ -29,14 +25,21 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtc/Convert.h"
+#include "fmtc/CpuOpt.h"
 #include "fmtc/fnc.h"
 #include "fmtc/Matrix.h"
 #include "fmtc/Resample.h"
-#include "fmtc/version.h"
 #include "fmtcl/MatrixUtil.h"
-#include "fmtcl/ResampleUtil.h"
+#include "fmtcl/PerfTrace.h"
+#include "fmtcl/PrimUtil.h"
+#include "fmtcl/TransUtil.h"
 #include "fstb/def.h"
+#include "fstb/fnc.h"
 #include "vsutl/fnc.h"
+#include "vsutl/FrameRefSPtr.h"
+
+#include <algorithm>
+#include <stdexcept>
 
 #include <cassert>
 
@@ -56,76 +59,251 @@ Convert::Convert (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCore
 ,	_clip_src_sptr (vsapi.mapGetNode (&in, "clip", 0, 0), vsapi)
 ,	_vi_in (*_vsapi.getVideoInfo (_clip_src_sptr.get ()))
 ,	_vi_out (_vi_in)
-,	_fmtc (*(vsapi.getPluginByID (fmtc_PLUGIN_NAME, &core)))
-,	_step_list ()
-,	_col_fam (-1)
-,	_mats (fmtcl::ColorSpaceH265_UNSPECIFIED)
-,	_matd (fmtcl::ColorSpaceH265_UNSPECIFIED)
-,	_cplaces (fmtcl::ChromaPlacement_UNDEF)
-,	_cplaced (fmtcl::ChromaPlacement_UNDEF)
-,	_fulls (ConvStep::Range_UNDEF)
-,	_fulld (ConvStep::Range_UNDEF)
-,	_transs (fmtcl::TransCurve_UNDEF)
-,	_transd (fmtcl::TransCurve_UNDEF)
-,	_gcors (get_arg_flt (in, out, "gcors", 1))
-,	_gcord (get_arg_flt (in, out, "gcord", 1))
+,	_interlaced (static_cast <Ru::InterlacingParam> (
+		get_arg_int (in, out, "interlaced", Ru::InterlacingParam_AUTO)
+	))
+,	_field_order (static_cast <Ru::FieldOrder> (
+		get_arg_int (in, out, "tff", Ru::FieldOrder_AUTO)
+	))
+,	_proc_uptr ()
 {
 	fstb::unused (user_data_ptr);
 
+	const fmtc::CpuOpt   cpu_opt (*this, in, out);
+
+	// Checks the input clip
+	if (! vsutl::is_constant_format (_vi_in))
+	{
+		throw_inval_arg ("only constant formats are supported.");
+	}
+
 	const auto &   fmt_src = _vi_in.format;
-	retrieve_output_colorspace (in, out, core, fmt_src);
-	const auto &   fmt_dst = _vi_out.format;
 
-	// Range
-	_fulls = retrieve_range (fmt_src, in, out, "fulls");
-	_fulld = retrieve_range (fmt_dst, in, out, "fulld");
+	{
+		const int            st  = fmt_src.sampleType;
+		const int            bps = fmt_src.bytesPerSample;
+		const int            res = fmt_src.bitsPerSample;
+		if (! (   (st == ::stInteger && bps == 1 &&     res ==  8 )
+		       || (st == ::stInteger && bps == 2 && (   res ==  9
+		                                             || res == 10
+		                                             || res == 12
+		                                             || res == 14
+		                                             || res == 16))
+		       || (st == ::stFloat   && bps == 4 &&     res == 32 )))
+		{
+			throw_inval_arg ("input pixel bitdepth not supported.");
+		}
+	}
 
-	// Chroma placement
-	const std::string cplace_str = get_arg_str (in, out, "cplace", "mpeg2");
-	if (vsutl::has_chroma (fmt_src))
+	if (   _interlaced < 0
+	    || _interlaced >= Ru::InterlacingParam_NBR_ELT)
+	{
+		throw_inval_arg ("interlaced argument out of range.");
+	}
+	if (   _field_order < 0
+	    || _field_order >= Ru::FieldOrder_NBR_ELT)
 	{
-		const std::string cplacex_str =
-			get_arg_str (in, out, "cplaces", cplace_str);
-		_cplaces = Resample::conv_str_to_chroma_placement (*this, cplacex_str);
+		throw_inval_arg ("tff argument out of range.");
 	}
-	if (vsutl::has_chroma (fmt_dst))
+
+	// Destination colorspace and size
+	retrieve_output_colorspace (in, out, core, fmt_src);
+	const auto &   fmt_dst = _vi_out.format;
+
 	{
-		const std::string cplacex_str =
-			get_arg_str (in, out, "cplaced", cplace_str);
-		_cplaced = Resample::conv_str_to_chroma_placement (*this, cplacex_str);
+		const int            st  = fmt_dst.sampleType;
+		const int            bps = fmt_dst.bytesPerSample;
+		const int            res = fmt_dst.bitsPerSample;
+		if (! (   (st == ::stInteger && bps == 1 &&     res ==  8 )
+		       || (st == ::stInteger && bps == 2 && (   res ==  9
+		                                             || res == 10
+		                                             || res == 12
+		                                             || res == 16))
+		       || (st == ::stFloat   && bps == 2 &&     res == 16 )
+		       || (st == ::stFloat   && bps == 4 &&     res == 32 )))
+		{
+			throw_inval_arg ("output pixel bitdepth not supported.");
+		}
 	}
 
-	// Matrix presets
+	retrieve_output_size (in, out);
+
+	fmtcl::ConvertProc::Param  param;
+	auto &         s = param._src;
+	auto &         d = param._dst;
+	const auto     cf_s = conv_vsfmt_to_colfam (fmt_src);
+	const auto     cf_d = conv_vsfmt_to_colfam (fmt_dst);
+
+	// Range. The destination keeps the source range only if the color family
+	// is the same.
+	const bool     full_range_src_flag = (get_arg_int (
+		in, out, "fulls", vsutl::is_full_range_default (fmt_src) ? 1 : 0
+	) != 0);
+	const bool     full_range_dst_def_flag =
+		  (cf_s == cf_d)
+		? full_range_src_flag
+		: vsutl::is_full_range_default (fmt_dst);
+	_full_range_dst_flag = (get_arg_int (
+		in, out, "fulld", (full_range_dst_def_flag) ? 1 : 0
+	) != 0);
+
+	s._fmt  = conv_vsfmt_to_picfmt (fmt_src, full_range_src_flag);
+	s._w    = _vi_in.width;
+	s._h    = _vi_in.height;
+	s._ss_h = fmt_src.subSamplingW;
+	s._ss_v = fmt_src.subSamplingH;
+	d._fmt  = conv_vsfmt_to_picfmt (fmt_dst, _full_range_dst_flag);
+	d._w    = _vi_out.width;
+	d._h    = _vi_out.height;
+	d._ss_h = fmt_dst.subSamplingW;
+	d._ss_v = fmt_dst.subSamplingH;
+
+	// Chroma placement
+	const std::string cplace_str = get_arg_str (in, out, "cplace", "mpeg2");
+	s._cplace = Resample::conv_str_to_chroma_placement (
+		*this, get_arg_str (in, out, "cplaces", cplace_str)
+	);
+	d._cplace = Resample::conv_str_to_chroma_placement (
+		*this, get_arg_str (in, out, "cplaced", cplace_str)
+	);
+
+	// Matrices. A gray destination is the luma of the source matrix, or of
+	// BT.601 for RGB.
+	const bool     yuv_s_flag  = (cf_s == fmtcl::ColorFamily_YUV);
+	const bool     yuv_d_flag  = (cf_d == fmtcl::ColorFamily_YUV);
+	const bool     luma_d_flag = (
+		   cf_d == fmtcl::ColorFamily_GRAY
+		&& cf_s != fmtcl::ColorFamily_GRAY
+	);
 	std::string    mat (get_arg_str (in, out, "mat", ""));
-	std::string    mats ((   vsutl::is_vs_yuv ( fmt_src.colorFamily)) ? mat : "");
-	std::string    matd ((   vsutl::is_vs_yuv ( fmt_dst.colorFamily)
-	                      || vsutl::is_vs_gray (fmt_dst.colorFamily)) ? mat : "");
+	std::string    mats ((yuv_s_flag                ) ? mat : "");
+	std::string    matd ((yuv_d_flag || luma_d_flag) ? mat : "");
 	mats = get_arg_str (in, out, "mats", mats);
 	matd = get_arg_str (in, out, "matd", matd);
-	if (! mats.empty () || ! matd.empty ())
+	fstb::conv_to_lower_case (mats);
+	fstb::conv_to_lower_case (matd);
+	fmtcl::MatrixUtil::select_def_mat (mats, cf_s);
+	if (luma_d_flag && matd.empty ())
 	{
-		fstb::conv_to_lower_case (mats);
-		fstb::conv_to_lower_case (matd);
-		const auto     col_fam_src = fmtc::conv_vsfmt_to_colfam (fmt_src);
-		const auto     col_fam_dst = fmtc::conv_vsfmt_to_colfam (fmt_dst);
-		fmtcl::MatrixUtil::select_def_mat (mats, col_fam_src);
-		fmtcl::MatrixUtil::select_def_mat (matd, col_fam_dst);
-		_mats = Matrix::find_cs_from_mat_str (*this, mats, true);
-		_matd = Matrix::find_cs_from_mat_str (*this, matd, true);
+		matd = (yuv_s_flag) ? mats : "601";
 	}
+	fmtcl::MatrixUtil::select_def_mat (matd, cf_d);
 
-	// Transfer curve
-	_transs = retrieve_tcurve (fmt_src, in, out, "transs", "");
-	_transd = retrieve_tcurve (fmt_dst, in, out, "transd", "");
+	auto           csp_s = fmtcl::ColorSpaceH265_RGB;
+	if (yuv_s_flag)
+	{
+		retrieve_matrix (s, csp_s, mats, true);
+	}
+	_csp_out = fmtcl::ColorSpaceH265_UNSPECIFIED;
+	if (yuv_d_flag || luma_d_flag)
+	{
+		retrieve_matrix (d, _csp_out, matd, false);
+	}
+	if (luma_d_flag)
+	{
+		_csp_out = fmtcl::ColorSpaceH265_UNSPECIFIED;
+	}
+	else if (cf_d == fmtcl::ColorFamily_RGB)
+	{
+		_csp_out = fmtcl::ColorSpaceH265_RGB;
+	}
 
+	// Transfer curves. If only one is specified, the other one is the same.
+	// The BT.2020 constant luminance implies the BT.2020 curve.
+	auto           curve_s = retrieve_tcurve (in, out, "transs");
+	auto           curve_d = retrieve_tcurve (in, out, "transd");
+	if (s._cl_flag && curve_s == fmtcl::TransCurve_UNDEF)
+	{
+		curve_s = fmtcl::TransCurve_2020_12;
+	}
+	if (d._cl_flag && curve_d == fmtcl::TransCurve_UNDEF)
+	{
+		curve_d = fmtcl::TransCurve_2020_12;
+	}
+	if (curve_s == fmtcl::TransCurve_UNDEF)
+	{
+		curve_s = curve_d;
+	}
+	else if (curve_d == fmtcl::TransCurve_UNDEF)
+	{
+		curve_d = curve_s;
+	}
 
+	s._gcor = get_arg_flt (in, out, "gcors", 1);
+	d._gcor = get_arg_flt (in, out, "gcord", 1);
+	if (s._gcor <= 0)
+	{
+		throw_inval_arg ("invalid gcors value.");
+	}
+	if (d._gcor <= 0)
+	{
+		throw_inval_arg ("invalid gcord value.");
+	}
+	param._contrast = get_arg_flt (in, out, "cont", 1);
+	if (param._contrast <= 0)
+	{
+		throw_inval_arg ("invalid cont value.");
+	}
 
-	/*** To do ***/
+	// Primaries. The destination defaults to the source.
+	s._prim = retrieve_primaries (in, out, "prims");
+	d._prim = retrieve_primaries (in, out, "primd");
+	if (d._prim == fmtcl::PrimariesPreset_UNDEF)
+	{
+		d._prim = s._prim;
+	}
+	param._wconv_flag = (get_arg_int (in, out, "wconv", 0) != 0);
 
-	find_conversion_steps (in, out);
+	// The transfer curves, the primaries and the BT.2020 constant luminance
+	// are converted on linear RGB.
+	_lin_flag = (
+		   curve_s != curve_d
+		|| s._gcor != d._gcor
+		|| param._contrast != 1
+		|| s._prim != d._prim
+		|| s._cl_flag != d._cl_flag
+	);
+	if (_lin_flag && curve_s == fmtcl::TransCurve_UNDEF)
+	{
+		throw_inval_arg (
+			"transs or transd must be specified to convert the gamma, the "
+			"primaries or the BT.2020 constant luminance."
+		);
+	}
+	s._curve        = curve_s;
+	d._curve        = curve_d;
+	param._lin_flag = _lin_flag;
+	_curve_d        = curve_d;
+	_prim_d         = d._prim;
+
+	// Resizing. The kernels for the chroma subsampling of the destination
+	// use the same parameters.
+	Resample::read_plane_data (
+		param._rsz_in, *this, in, out, _vsapi,
+		fmt_src.numPlanes, s._w, s._h
+	);
+	Resample::read_plane_data (
+		param._rsz_out, *this, in, out, _vsapi,
+		Resample::_max_nbr_planes, s._w, s._h
+	);
+	param._norm_flag = (get_arg_int (in, out, "cnorm", 1) != 0);
+	param._itl_flag  = (_interlaced != Ru::InterlacingParam_FRAMES);
 
-	/*** To do ***/
+	// Bitdepth conversion
+	retrieve_dither (param, in, out);
 
+	try
+	{
+		_proc_uptr = std::make_unique <fmtcl::ConvertProc> (
+			std::move (param),
+			cpu_opt.has_sse (), cpu_opt.has_sse2 (), cpu_opt.has_avx (),
+			cpu_opt.has_avx2 (), cpu_opt.has_avx512bw ()
+		);
+	}
+	catch (const std::invalid_argument &e)
+	{
+		throw_inval_arg (e.what ());
+	}
 }
 
 
@@ -148,7 +326,7 @@ std::vector <::VSFilterDependency>	Convert::get_dependencies () const
 
 const ::VSFrame *	Convert::get_frame (int n, int activation_reason, void * &frame_data_ptr, ::VSFrameContext &frame_ctx, ::VSCore &core)
 {
-	fstb::unused (frame_data_ptr, core);
+	fstb::unused (frame_data_ptr);
 
 	assert (n >= 0);
 
@@ -161,9 +339,117 @@ const ::VSFrame *	Convert::get_frame (int n, int activation_reason, void * &fram
 	}
 	else if (activation_reason == ::arAllFramesReady)
 	{
+		vsutl::FrameRefSPtr	src_sptr (
+			_vsapi.getFrameFilter (n, &node, &frame_ctx),
+			_vsapi
+		);
+		const ::VSFrame & src = *src_sptr;
+
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.convert");
+
+		dst_ptr = _vsapi.newVideoFrame (
+			&_vi_out.format, _vi_out.width, _vi_out.height, &src, &core
+		);
+
+		// Interlacing, from the frame properties
+		Ru::FieldBased prop_fieldbased = Ru::FieldBased_INVALID;
+		Ru::Field      prop_field      = Ru::Field_INVALID;
+		const ::VSMap* src_prop_ptr    = _vsapi.getFramePropertiesRO (&src);
+		if (src_prop_ptr != nullptr)
+		{
+			int            err      = 0;
+			int64_t        prop_val = -1;
+			prop_val = _vsapi.mapGetInt (src_prop_ptr, "_FieldBased", 0, &err);
+			prop_fieldbased =
+				  (err      != 0) ? Ru::FieldBased_INVALID
+				: (prop_val == 0) ? Ru::FieldBased_FRAMES
+				: (prop_val == 1) ? Ru::FieldBased_BFF
+				: (prop_val == 2) ? Ru::FieldBased_TFF
+				:                   Ru::FieldBased_INVALID;
+			prop_val = _vsapi.mapGetInt (src_prop_ptr, "_Field", 0, &err);
+			prop_field =
+				  (err      != 0) ? Ru::Field_INVALID
+				: (prop_val == 0) ? Ru::Field_BOT
+				: (prop_val == 1) ? Ru::Field_TOP
+				:                   Ru::Field_INVALID;
+		}
+		bool           itl_flag = false;
+		bool           top_flag = true;
+		Ru::get_interlacing_param (
+			itl_flag, top_flag,
+			n, _interlaced, _field_order, prop_fieldbased, prop_field,
+			false
+		);
+		const auto     itl = fmtcl::InterlacingType_get (itl_flag, top_flag);
 
-		/*** To do ***/
+		// The source and destination may have a different number of planes
+		fmtcl::Frame <>   frame_dst;
+		fmtcl::FrameRO <> frame_src;
+		for (int p_idx = 0; p_idx < _vi_out.format.numPlanes; ++p_idx)
+		{
+			frame_dst [p_idx]._ptr    = _vsapi.getWritePtr (dst_ptr, p_idx);
+			frame_dst [p_idx]._stride = _vsapi.getStride (dst_ptr, p_idx);
+		}
+		for (int p_idx = 0; p_idx < _vi_in.format.numPlanes; ++p_idx)
+		{
+			frame_src [p_idx]._ptr    = _vsapi.getReadPtr (&src, p_idx);
+			frame_src [p_idx]._stride = _vsapi.getStride (&src, p_idx);
+		}
+
+		try
+		{
+			_proc_uptr->process_frame (frame_dst, frame_src, n, itl);
+		}
+		catch (const std::exception &e)
+		{
+			_vsapi.setFilterError (e.what (), &frame_ctx);
+			_vsapi.freeFrame (dst_ptr);
+			dst_ptr = nullptr;
+		}
+		catch (...)
+		{
+			_vsapi.setFilterError ("convert: exception.", &frame_ctx);
+			_vsapi.freeFrame (dst_ptr);
+			dst_ptr = nullptr;
+		}
+
+		// Output frame properties
+		if (dst_ptr != nullptr)
+		{
+			::VSMap &      dst_prop = *(_vsapi.getFramePropertiesRW (dst_ptr));
+
+			const int      cr_val = (_full_range_dst_flag) ? 0 : 1;
+			_vsapi.mapSetInt (&dst_prop, "_ColorRange", cr_val, ::maReplace);
+
+			if (   _csp_out != fmtcl::ColorSpaceH265_UNSPECIFIED
+			    && _csp_out <= fmtcl::ColorSpaceH265_ISO_RANGE_LAST)
+			{
+				_vsapi.mapSetInt (&dst_prop, "_Matrix"    , int (_csp_out), ::maReplace);
+				_vsapi.mapSetInt (&dst_prop, "_ColorSpace", int (_csp_out), ::maReplace);
+			}
+			else
+			{
+				_vsapi.mapDeleteKey (&dst_prop, "_Matrix");
+				_vsapi.mapDeleteKey (&dst_prop, "_ColorSpace");
+			}
+
+			if (_lin_flag)
+			{
+				int            transfer = fmtcl::TransCurve_UNSPECIFIED;
+				if (_curve_d >= 0 && _curve_d <= fmtcl::TransCurve_ISO_RANGE_LAST)
+				{
+					transfer = _curve_d;
+				}
+				_vsapi.mapSetInt (&dst_prop, "_Transfer", transfer, ::maReplace);
+			}
 
+			if (_prim_d >= 0 && _prim_d < fmtcl::PrimariesPreset_NBR_ELT)
+			{
+				_vsapi.mapSetInt (&dst_prop, "_Primaries", int (_prim_d), ::maReplace);
+			}
+
+			export_perf_capture (perf_capture, *dst_ptr, _vsapi);
+		}
 	}
 
 	return dst_ptr;
@@ -202,18 +488,18 @@ void	Convert::retrieve_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSC
 	int            ssv      = fmt_dst.subSamplingH;
 
 	// Color family
-	_col_fam = get_arg_int (in, out, "col_fam", col_fam);
+	col_fam = get_arg_int (in, out, "col_fam", col_fam);
 
 	// Chroma subsampling
 	std::string    css (get_arg_str (in, out, "css", ""));
 	if (! css.empty ())
 	{
-		const int      ret_val =
-			fmtcl::ResampleUtil::conv_str_to_chroma_subspl (ssh, ssv, css);
-		if (ret_val != 0)
-		{
-			throw_inval_arg ("unsupported css value.");
-		}
+		Resample::conv_str_to_chroma_subspl (*this, ssh, ssv, css);
+	}
+	if (col_fam == ::cfGray || col_fam == ::cfRGB)
+	{
+		ssh = 0;
+		ssv = 0;
 	}
 
 	// Destination bit depth and sample type
@@ -258,7 +544,7 @@ void	Convert::retrieve_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSC
 	{
 		ok_flag = register_format (
 			fmt_dst,
-			_col_fam, spl_type, bits, ssh, ssv,
+			col_fam, spl_type, bits, ssh, ssv,
 			core
 		);
 	}
@@ -283,311 +569,192 @@ void	Convert::retrieve_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSC
 
 
 
-ConvStep::Range	Convert::retrieve_range (const ::VSVideoFormat &fmt, const ::VSMap &in, ::VSMap &out, const char arg_0 [])
+// Same rules as fmtc.resample
+void	Convert::retrieve_output_size (const ::VSMap &in, ::VSMap &out)
 {
-	assert (arg_0 != 0);
-
-	bool           range_set_flag  = false;
-	const bool     full_range_flag = (get_arg_int (
-		in, out, arg_0,
-		vsutl::is_full_range_default (fmt) ? 1 : 0,
-		0, &range_set_flag
-	) != 0);
-
-	return (
-		  (! range_set_flag) ? ConvStep::Range_UNDEF
-		: (full_range_flag ) ? ConvStep::Range_FULL
-		:                      ConvStep::Range_TV
-	);
-}
-
-
-
-fmtcl::TransCurve	Convert::retrieve_tcurve (const ::VSVideoFormat &fmt, const ::VSMap &in, ::VSMap &out, const char arg_0 [], const char def_0 [])
-{
-	fstb::unused (fmt);
-
-	fmtcl::TransCurve tcurve = fmtcl::TransCurve_UNDEF;
-
-	bool           curve_flag = false;
-	std::string    curve_str =
-		get_arg_str (in, out, arg_0, def_0, 0, &curve_flag);
-	fstb::conv_to_lower_case (curve_str);
+	const auto &   fmt_dst = _vi_out.format;
 
-	if (! curve_flag || curve_str.empty ())
-	{
-		tcurve = fmtcl::TransCurve_UNDEF;
-	}
-	else if (curve_str == "linear")
-	{
-		tcurve = fmtcl::TransCurve_LINEAR;
-	}
-	else if (curve_str == "srgb" || curve_str == "6196621")
+	// Target size: scale
+	const double   scale  = get_arg_flt (in, out, "scale" ,     0);
+	const double   scaleh = get_arg_flt (in, out, "scaleh", scale);
+	const double   scalev = get_arg_flt (in, out, "scalev", scale);
+	if (scaleh < 0 || scalev < 0)
 	{
-		tcurve = fmtcl::TransCurve_SRGB;
+		throw_inval_arg ("scale parameters must be positive or 0.");
 	}
-	else if (curve_str == "709")
+	if (scaleh > 0)
 	{
-		tcurve = fmtcl::TransCurve_709;
+		const int      cssh = 1 << fmt_dst.subSamplingW;
+		const int      wtmp = fstb::round_int (_vi_out.width  * scaleh / cssh);
+		_vi_out.width = std::max (wtmp, 1) * cssh;
 	}
-	else if (curve_str == "601" || curve_str == "170")
+	if (scalev > 0)
 	{
-		tcurve = fmtcl::TransCurve_601;
+		const int      cssv = 1 << fmt_dst.subSamplingH;
+		const int      htmp = fstb::round_int (_vi_out.height * scalev / cssv);
+		_vi_out.height = std::max (htmp, 1) * cssv;
 	}
-	else if (curve_str == "470m")
-	{
-		tcurve = fmtcl::TransCurve_470M;
-	}
-	else if (curve_str == "470bg")
-	{
-		tcurve = fmtcl::TransCurve_470BG;
-	}
-	else if (curve_str == "240")
-	{
-		tcurve = fmtcl::TransCurve_240;
-	}
-	else if (curve_str == "2020")
-	{
-		tcurve = fmtcl::TransCurve_2020_12;
-	}
-	else if (curve_str == "log100")
+
+	// Target size: explicit dimensions
+	_vi_out.width = get_arg_int (in, out, "w", _vi_out.width);
+	if (_vi_out.width < 1)
 	{
-		tcurve = fmtcl::TransCurve_LOG100;
+		throw_inval_arg ("w must be positive.");
 	}
-	else if (curve_str == "log316")
+	else if ((_vi_out.width & ((1 << fmt_dst.subSamplingW) - 1)) != 0)
 	{
-		tcurve = fmtcl::TransCurve_LOG316;
+		throw_inval_arg (
+			"w is not compatible with the output chroma subsampling."
+		);
 	}
-	else if (curve_str == "6196624")
+
+	_vi_out.height = get_arg_int (in, out, "h", _vi_out.height);
+	if (_vi_out.height < 1)
 	{
-		tcurve = fmtcl::TransCurve_61966_2_4;
+		throw_inval_arg ("h must be positive.");
 	}
-	else if (curve_str == "1361")
+	else if ((_vi_out.height & ((1 << fmt_dst.subSamplingH) - 1)) != 0)
 	{
-		tcurve = fmtcl::TransCurve_1361;
+		throw_inval_arg (
+			"h is not compatible with the output chroma subsampling."
+		);
 	}
-	else if (curve_str == "1886")
+}
+
+
+
+// mat should be already converted to lower case, with the default matrix
+// selected. csp is set to a valid H265 colorspace.
+void	Convert::retrieve_matrix (fmtcl::ConvertProc::Side &side, fmtcl::ColorSpaceH265 &csp, const std::string &mat, bool to_rgb_flag) const
+{
+	csp = Matrix::find_cs_from_mat_str (*this, mat, true);
+	if (csp == fmtcl::ColorSpaceH265_BT2020CL)
 	{
-		tcurve = fmtcl::TransCurve_1886;
+		side._cl_flag = true;
 	}
-	else if (curve_str == "1886a")
+	else if (fmtcl::MatrixUtil::make_mat_from_str (side._mat, mat, to_rgb_flag) != 0)
 	{
-		tcurve = fmtcl::TransCurve_1886A;
+		throw_inval_arg ("unknown matrix identifier.");
 	}
-	else
+
+	switch (csp)
 	{
-		throw_inval_arg ("unexpected string for the transfer curve.");
+	case fmtcl::ColorSpaceH265_LMS:
+		csp = fmtcl::ColorSpaceH265_RGB;
+		break;
+	case fmtcl::ColorSpaceH265_ICTCP_PQ:
+	case fmtcl::ColorSpaceH265_ICTCP_HLG:
+		csp = fmtcl::ColorSpaceH265_ICTCP;
+		break;
+	default:
+		// Nothing to do
+		break;
 	}
-
-	return (tcurve);
 }
 
 
 
-void	Convert::find_conversion_steps (const ::VSMap &in, ::VSMap &out)
+fmtcl::TransCurve	Convert::retrieve_tcurve (const ::VSMap &in, ::VSMap &out, const char arg_0 []) const
 {
-	fstb::unused (in, out);
+	assert (arg_0 != nullptr);
 
-	_step_list.clear ();
-
-	// -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-	// First, creates the first and last nodes
-
-	_step_list.emplace_back ();
-	_step_list.emplace_back ();
-	ConvStep &     beg = _step_list.front ();
-	ConvStep &     end = _step_list.back ();
-
-	// Colorspace information
-	fill_conv_step_with_cs (beg, _vi_in.format);
-	fill_conv_step_with_cs (end, _vi_out.format);
-
-	// Range
-	beg._range = _fulls;
-	end._range = _fulld;
-
-	// Chroma placement
-	beg._cplace = _cplaces;
-	end._cplace = _cplaced;
-
-	// Transfer curve
-	const bool     transs_flag =
-		fill_conv_step_with_curve (beg, _vi_in.format , _transs, _mats);
-	const bool     transd_flag =
-		fill_conv_step_with_curve (end, _vi_out.format, _transd, _matd);
-
-	// If one is undefined, copy it from the other side
-	if (   beg._tcurve == fmtcl::TransCurve_UNDEF
-	    && end._tcurve != fmtcl::TransCurve_UNDEF)
+	std::string    curve_str = get_arg_str (in, out, arg_0, "");
+	fstb::conv_to_lower_case (curve_str);
+	if (curve_str.empty ())
 	{
-		beg._tcurve = end._tcurve;
+		return fmtcl::TransCurve_UNDEF;
 	}
-	else if (   end._tcurve == fmtcl::TransCurve_UNDEF
-	         && beg._tcurve != fmtcl::TransCurve_UNDEF)
+
+	const auto     curve = fmtcl::TransUtil::conv_string_to_curve (curve_str);
+	if (curve == fmtcl::TransCurve_UNDEF)
 	{
-		end._tcurve = beg._tcurve;
+		fstb::snprintf4all (
+			_filter_error_msg_0,
+			_max_error_buf_len,
+			"invalid %s value.",
+			arg_0
+		);
+		throw_inval_arg (_filter_error_msg_0);
 	}
-	// Now all curves are defined or all undefined.
-
-	// Addtional gamma correction
-	beg._gammac = _gcors;
-	end._gammac = _gcord;
-
-	end._resized_flag = true;
 
-	// -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-	// Do we need an intermediate linear RGB step?
+	return curve;
+}
 
-	bool           add_lin_rgb_flag = false;
 
-	bool           beg_nonlin_flag = 
-		(   beg._tcurve != fmtcl::TransCurve_UNDEF
-	    && beg._tcurve != fmtcl::TransCurve_LINEAR);
-	bool           end_nonlin_flag =
-		(   end._tcurve != fmtcl::TransCurve_UNDEF
-		 && end._tcurve != fmtcl::TransCurve_LINEAR);
 
-	if (beg_nonlin_flag && end_nonlin_flag)
-	{
-		// Needs at least one curve to be explicitely specified
-		if (transs_flag || transd_flag)
-		{
-			add_lin_rgb_flag = true;
-		}
-		// Force the linear processing if BT.2020CL is used with another
-		// colorspace.
-		else if (  (_mats == fmtcl::ColorSpaceH265_BT2020CL)
-		         ^ (_matd == fmtcl::ColorSpaceH265_BT2020CL))
-		{
-			add_lin_rgb_flag = true;
-		}
-	}
+fmtcl::PrimariesPreset	Convert::retrieve_primaries (const ::VSMap &in, ::VSMap &out, const char arg_0 []) const
+{
+	assert (arg_0 != nullptr);
 
-	// If the transfer curves are unknown, we cannot use a linear step.
-	if (beg._tcurve == fmtcl::TransCurve_UNDEF)
+	std::string    preset_str = get_arg_str (in, out, arg_0, "");
+	fstb::conv_to_lower_case (preset_str);
+	if (preset_str.empty ())
 	{
-		add_lin_rgb_flag = false;
+		return fmtcl::PrimariesPreset_UNDEF;
 	}
 
-	// Yes? Inserts this step
-	if (add_lin_rgb_flag)
+	const auto     preset =
+		fmtcl::PrimUtil::conv_string_to_primaries (preset_str);
+	if (preset < 0)
 	{
-		// Clone the end node
-		StepList::iterator   lin_it =
-			_step_list.insert (++ _step_list.begin (), end);
-		ConvStep &     lin = *lin_it;
-
-		lin._col_fam      = ::cfRGB;
-		lin._css_h        = 0;
-		lin._css_v        = 0;
-		lin._tcurve       = fmtcl::TransCurve_LINEAR;
-		lin._gammac       = 1;
-
-		lin._resized_flag = false;
-		lin._sample_type  = -1;
-		lin._bitdepth     = -1;
+		fstb::snprintf4all (
+			_filter_error_msg_0,
+			_max_error_buf_len,
+			"%s: invalid preset name.",
+			arg_0
+		);
+		throw_inval_arg (_filter_error_msg_0);
 	}
 
-
-	/*** To do ***/
-
-
-
+	return preset;
 }
 
 
 
-// Set here: _col_fam, _css_h, _css_v, _sample_type, _bitdepth
-void	Convert::fill_conv_step_with_cs (ConvStep &step, const ::VSVideoFormat &fmt)
+// Same parameters as fmtc.bitdepth
+void	Convert::retrieve_dither (fmtcl::ConvertProc::Param &param, const ::VSMap &in, ::VSMap &out) const
 {
-	step._col_fam = fmt.colorFamily;
-	if (vsutl::has_chroma (fmt))
+	auto           dmode = static_cast <fmtcl::Dither::DMode> (
+		get_arg_int (in, out, "dmode", fmtcl::Dither::DMode_FILTERLITE)
+	);
+	if (dmode == fmtcl::Dither::DMode_ROUND_ALIAS)
 	{
-		step._css_h = fmt.subSamplingW;
-		step._css_v = fmt.subSamplingH;
+		dmode = fmtcl::Dither::DMode_ROUND;
 	}
-
-	step._sample_type = fmt.sampleType;
-	step._bitdepth    = fmt.bitsPerSample;
-}
-
-
-
-// Returns true if explicitely specified
-bool	Convert::fill_conv_step_with_curve (ConvStep &step, const ::VSVideoFormat &fmt, fmtcl::TransCurve tcurve, fmtcl::ColorSpaceH265 mat)
-{
-	bool           curve_flag = (tcurve != fmtcl::TransCurve_UNDEF);
-	step._tcurve = tcurve;
-
-	// Try to guess unspecified transfer curves
-	if (! curve_flag)
+	if (   dmode <  0
+	    || (dmode & 0xFFFF) >= fmtcl::Dither::DMode_NBR_ELT)
 	{
-		if (mat == fmtcl::ColorSpaceH265_UNSPECIFIED)
-		{
-			if (vsutl::is_vs_rgb (fmt.colorFamily))
-			{
-				step._tcurve = fmtcl::TransCurve_SRGB;
-			}
-			else  // All luma-based colorspaces
-			{
-				step._tcurve = fmtcl::TransCurve_601;
-			}
-		}
-		else
-		{
-			// We don't check if the matrix is compatible with the specified
-			// colorspace.
-			switch (mat)
-			{
-			case fmtcl::ColorSpaceH265_RGB:
-				step._tcurve = fmtcl::TransCurve_SRGB;
-				break;
-			case fmtcl::ColorSpaceH265_BT709:
-			case fmtcl::ColorSpaceH265_YCGCO:
-				step._tcurve = fmtcl::TransCurve_709;
-				break;
-			case fmtcl::ColorSpaceH265_FCC:
-				step._tcurve = fmtcl::TransCurve_470M;
-				break;
-			case fmtcl::ColorSpaceH265_BT470BG:
-				step._tcurve = fmtcl::TransCurve_470BG;
-				break;
-			case fmtcl::ColorSpaceH265_SMPTE170M:
-				step._tcurve = fmtcl::TransCurve_601;
-				break;
-			case fmtcl::ColorSpaceH265_SMPTE240M:
-				step._tcurve = fmtcl::TransCurve_240;
-				break;
-			case fmtcl::ColorSpaceH265_BT2020NCL:
-			case fmtcl::ColorSpaceH265_BT2020CL:
-				step._tcurve = fmtcl::TransCurve_2020_12;
-				break;
-			case fmtcl::ColorSpaceH265_UNSPECIFIED:
-			case fmtcl::ColorSpaceH265_RESERVED:
-				// Should not happen
-				assert (false);
-				break;
-			case fmtcl::ColorSpaceH265_CUSTOM:
-			default:
-				// Nothing, keep it undefined
-				break;
-			}
-		}
+		throw_inval_arg ("invalid dmode.");
 	}
+	param._dmode = dmode;
 
-	return (curve_flag);
-}
-
+	param._ampo = get_arg_flt (in, out, "ampo", 1.0);
+	if (param._ampo < 0)
+	{
+		throw_inval_arg ("ampo cannot be negative.");
+	}
 
+	param._ampn = get_arg_flt (in, out, "ampn", 0.0);
+	if (param._ampn < 0)
+	{
+		throw_inval_arg ("ampn cannot be negative.");
+	}
 
-void	Convert::fill_conv_step_with_gcor (ConvStep &step, const ::VSMap &in, ::VSMap &out, const char arg_0 [])
-{
-	double         gcor = get_arg_flt (in, out, arg_0, -1);
-	if (gcor <= 0)
+	param._pat_size = get_arg_int (in, out, "patsize", 32);
+	if (   param._pat_size < 4
+	    || param._pat_size > fmtcl::Dither::_pat_max_size
+	    || ! fstb::is_pow_2 (param._pat_size))
 	{
-		gcor = -1;
+		throw_inval_arg ("Wrong value for patsize.");
 	}
-	step._gammac = gcor;
+
+	param._dyn_flag = (get_arg_int (in, out, "dyn", 0) != 0);
+	param._static_noise_flag =
+		(get_arg_int (in, out, "staticnoise", 0) != 0);
+	param._correlated_planes_flag =
+		(get_arg_int (in, out, "corplane", 0) != 0);
+	param._tpdfo_flag = (get_arg_int (in, out, "tpdfo", 0) != 0);
+	param._tpdfn_flag = (get_arg_int (in, out, "tpdfn", 0) != 0);
 }
 
 
@@ -3,9 +3,9 @@
         Convert.h
         Author: Laurent de Soras, 2014
 
-	========================
-	*** WORK IN PROGRESS ***
-	========================
+Complete format conversion in a single filter: resizing, chroma subsampling,
+matrix, transfer curves, primaries and bitdepth. The work is done by
+fmtcl::ConvertProc.
 
 --- Legal stuff ---
 
@@ -31,13 +31,16 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
-#include "fmtc/ConvStep.h"
-#include "fmtcl/ChromaPlacement.h"
 #include "fmtcl/ColorSpaceH265.h"
+#include "fmtcl/ConvertProc.h"
+#include "fmtcl/PrimariesPreset.h"
+#include "fmtcl/ResampleUtil.h"
+#include "fmtcl/TransCurve.h"
 #include "vsutl/FilterBase.h"
 #include "vsutl/NodeRefSPtr.h"
 
-#include <list>
+#include <memory>
+#include <string>
 
 
 
@@ -73,51 +76,43 @@ protected:
 
 
 
-/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 private:
 
-	typedef	std::list <ConvStep>	StepList;
+	using Ru = fmtcl::ResampleUtil;
 
 	void           retrieve_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSCore &core, const ::VSVideoFormat &fmt_src);
-	ConvStep::Range
-	               retrieve_range (const ::VSVideoFormat &fmt, const ::VSMap &in, ::VSMap &out, const char arg_0 []);
+	void           retrieve_output_size (const ::VSMap &in, ::VSMap &out);
+	void           retrieve_matrix (fmtcl::ConvertProc::Side &side, fmtcl::ColorSpaceH265 &csp, const std::string &mat, bool to_rgb_flag) const;
 	fmtcl::TransCurve
-						retrieve_tcurve (const ::VSVideoFormat &fmt, const ::VSMap &in, ::VSMap &out, const char arg_0 [], const char def_0 []);
-	void           find_conversion_steps (const ::VSMap &in, ::VSMap &out);
-	void           fill_conv_step_with_cs (ConvStep &step, const ::VSVideoFormat &fmt);
-	bool           fill_conv_step_with_curve (ConvStep &step, const ::VSVideoFormat &fmt, fmtcl::TransCurve tcurve, fmtcl::ColorSpaceH265 mat);
-	void           fill_conv_step_with_gcor (ConvStep &step, const ::VSMap &in, ::VSMap &out, const char arg_0 []);
+	               retrieve_tcurve (const ::VSMap &in, ::VSMap &out, const char arg_0 []) const;
+	fmtcl::PrimariesPreset
+	               retrieve_primaries (const ::VSMap &in, ::VSMap &out, const char arg_0 []) const;
+	void           retrieve_dither (fmtcl::ConvertProc::Param &param, const ::VSMap &in, ::VSMap &out) const;
 
 	vsutl::NodeRefSPtr
 	               _clip_src_sptr;
-	const ::VSVideoInfo             
+	const ::VSVideoInfo
 	               _vi_in;        // Input. Must be declared after _clip_src_sptr because of initialisation order.
 	::VSVideoInfo  _vi_out;       // Output. Must be declared after _vi_in.
-	::VSPlugin &   _fmtc;
 
-	StepList       _step_list;
+	Ru::InterlacingParam
+	               _interlaced = Ru::InterlacingParam_AUTO;
+	Ru::FieldOrder _field_order = Ru::FieldOrder_AUTO;
 
-	// Cached input parameters
-	int            _col_fam;
+	// Output frame properties
+	bool           _full_range_dst_flag = false;
 	fmtcl::ColorSpaceH265
-	               _mats;         // Custom not allowed here
-	fmtcl::ColorSpaceH265
-	               _matd;         // Can be ColorSpaceH265_CUSTOM
-	fmtcl::ChromaPlacement
-	               _cplaces;
-	fmtcl::ChromaPlacement
-	               _cplaced;
-	ConvStep::Range
-	               _fulls;
-	ConvStep::Range
-	               _fulld;
-	fmtcl::TransCurve             // Transfer curve for source clip. Can be undefined.
-	               _transs;
-	fmtcl::TransCurve             // Same, for destination clip.
-	               _transd;
-	double         _gcors;        // Additionnal gamma correction for source clip. 1: neutral or not defined.
-	double         _gcord;        // Same, for destination clip.
+	               _csp_out = fmtcl::ColorSpaceH265_UNSPECIFIED;
+	bool           _lin_flag = false;
+	fmtcl::TransCurve
+	               _curve_d = fmtcl::TransCurve_UNDEF;
+	fmtcl::PrimariesPreset
+	               _prim_d  = fmtcl::PrimariesPreset_UNDEF;
+
+	std::unique_ptr <fmtcl::ConvertProc>
+	               _proc_uptr;
 
 
 
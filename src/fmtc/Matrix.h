@@ -114,6 +114,7 @@ private:
 	bool           _sse2_flag;
 	bool           _avx_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;
 
 	bool           _range_set_src_flag;
 	bool           _range_set_dst_flag;
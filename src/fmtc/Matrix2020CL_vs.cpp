@@ -62,11 +62,12 @@ Matrix2020CL::Matrix2020CL (const ::VSMap &in, ::VSMap &out, void *user_data_ptr
 	fstb::unused (user_data_ptr);
 
 	const fmtc::CpuOpt   cpu_opt (*this, in, out);
-	const bool     sse2_flag = cpu_opt.has_sse2 ();
-	const bool     avx2_flag = cpu_opt.has_avx2 ();
+	const bool     sse2_flag   = cpu_opt.has_sse2 ();
+	const bool     avx2_flag   = cpu_opt.has_avx2 ();
+	const bool     avx512_flag = cpu_opt.has_avx512bw ();
 
 	_proc_uptr = std::unique_ptr <fmtcl::Matrix2020CLProc> (
-		new fmtcl::Matrix2020CLProc (sse2_flag, avx2_flag)
+		new fmtcl::Matrix2020CLProc (sse2_flag, avx2_flag, avx512_flag)
 	);
 
 	// Checks the input clip
@@ -224,6 +225,8 @@ const ::VSFrame *	Matrix2020CL::get_frame (int n, int activation_reason, void *
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.matrix2020cl");
+
 		const int      w = _vsapi.getFrameWidth (&src, 0);
 		const int      h = _vsapi.getFrameHeight (&src, 0);
 		dst_ptr = _vsapi.newVideoFrame (&_vi_out.format, w, h, &src, &core);
@@ -252,6 +255,8 @@ const ::VSFrame *	Matrix2020CL::get_frame (int n, int activation_reason, void *
 			const int      cr_val = (! _to_yuv_flag || _full_range_flag) ? 0 : 1;
 			_vsapi.mapSetInt (&dst_prop, "_ColorRange", cr_val, ::maReplace);
 		}
+
+		export_perf_capture (perf_capture, *dst_ptr, _vsapi);
 	}
 
 	return dst_ptr;
@@ -62,6 +62,7 @@ Matrix::Matrix (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, ::VSC
 ,	_sse2_flag (false)
 ,	_avx_flag (false)
 ,	_avx2_flag (false)
+,	_avx512_flag (false)
 ,	_range_set_src_flag (false)
 ,	_range_set_dst_flag (false)
 ,	_full_range_src_flag (false)
@@ -72,13 +73,14 @@ Matrix::Matrix (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, ::VSC
 ,	_proc_uptr ()
 {
 	const fmtc::CpuOpt   cpu_opt (*this, in, out);
-	_sse_flag  = cpu_opt.has_sse ();
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx_flag  = cpu_opt.has_avx ();
-	_avx2_flag = cpu_opt.has_avx2 ();
+	_sse_flag    = cpu_opt.has_sse ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx_flag    = cpu_opt.has_avx ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
 
 	_proc_uptr = std::make_unique <fmtcl::MatrixProc> (
-		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag
+		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag, _avx512_flag
 	);
 
 	// Checks the input clip
@@ -366,6 +368,8 @@ const ::VSFrame *	Matrix::get_frame (int n, int activation_reason, void * &frame
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.matrix");
+
 		const int      w = _vsapi.getFrameWidth (&src, 0);
 		const int      h = _vsapi.getFrameHeight (&src, 0);
 		dst_ptr = _vsapi.newVideoFrame (&_vi_out.format, w, h, &src, &core);
@@ -395,6 +399,8 @@ const ::VSFrame *	Matrix::get_frame (int n, int activation_reason, void * &frame
 			_vsapi.mapDeleteKey (&dst_prop, "_Matrix");
 			_vsapi.mapDeleteKey (&dst_prop, "_ColorSpace");
 		}
+
+		export_perf_capture (perf_capture, *dst_ptr, _vsapi);
 	}
 
 	return dst_ptr;
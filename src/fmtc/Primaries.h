@@ -27,8 +27,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
-#include "fmtcl/MatrixProc.h"
 #include "fmtcl/PrimariesPreset.h"
+#include "fmtcl/PrimariesProc.h"
 #include "fmtcl/RgbSystem.h"
 #include "vsutl/FilterBase.h"
 #include "vsutl/NodeRefSPtr.h"
@@ -87,10 +87,11 @@ private:
 	               _vi_in;        // Input. Must be declared after _clip_src_sptr because of initialisation order.
 	::VSVideoInfo  _vi_out;       // Output. Must be declared after _vi_in.
 
-	bool           _sse_flag  = false;
-	bool           _sse2_flag = false;
-	bool           _avx_flag  = false;
-	bool           _avx2_flag = false;
+	bool           _sse_flag    = false;
+	bool           _sse2_flag   = false;
+	bool           _avx_flag    = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 
 	fmtcl::RgbSystem
 	               _prim_s;
@@ -99,7 +100,7 @@ private:
 
 	fmtcl::Mat4    _mat_main { 1.0, fmtcl::Mat4::Preset_DIAGONAL };
 
-	std::unique_ptr <fmtcl::MatrixProc>
+	std::unique_ptr <fmtcl::PrimariesProc>
 	               _proc_uptr;
 
 
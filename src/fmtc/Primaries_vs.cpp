@@ -30,6 +30,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/fnc.h"
 #include "fmtcl/Mat3.h"
 #include "fmtcl/PrimUtil.h"
+#include "fmtcl/TransUtil.h"
 #include "fstb/def.h"
 #include "fstb/fnc.h"
 #include "vsutl/fnc.h"
@@ -58,6 +59,7 @@ Primaries::Primaries (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VS
 ,	_sse2_flag (false)
 ,	_avx_flag (false)
 ,	_avx2_flag (false)
+,	_avx512_flag (false)
 ,	_prim_s ()
 ,	_prim_d ()
 ,	_mat_main ()
@@ -66,14 +68,15 @@ Primaries::Primaries (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VS
 	fstb::unused (user_data_ptr, core);
 
 	const fmtc::CpuOpt   cpu_opt (*this, in, out);
-	_sse_flag  = cpu_opt.has_sse ();
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx_flag  = cpu_opt.has_avx ();
-	_avx2_flag = cpu_opt.has_avx2 ();
-
-	_proc_uptr = std::unique_ptr <fmtcl::MatrixProc> (new fmtcl::MatrixProc (
-		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag
-	));
+	_sse_flag    = cpu_opt.has_sse ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx_flag    = cpu_opt.has_avx ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
+
+	_proc_uptr = std::make_unique <fmtcl::PrimariesProc> (
+		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag, _avx512_flag
+	);
 
 	// Checks the input clip
 	if (! vsutl::is_constant_format (_vi_in))
@@ -112,11 +115,45 @@ Primaries::Primaries (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VS
 	_mat_main.insert3 (mat_conv);
 	_mat_main.clean3 (1);
 
-	prepare_matrix_coef (
-		*this, *_proc_uptr, _mat_main,
-		fmt_dst, true,
-		fmt_src, true
+	// Transfer curves. Empty strings: linear
+	std::string    transs = get_arg_str (in, out, "transs", "");
+	std::string    transd = get_arg_str (in, out, "transd", transs);
+	fstb::conv_to_lower_case (transs);
+	fstb::conv_to_lower_case (transd);
+	auto           curve_s = fmtcl::TransCurve_UNDEF;
+	auto           curve_d = fmtcl::TransCurve_UNDEF;
+	if (! transs.empty ())
+	{
+		curve_s = fmtcl::TransUtil::conv_string_to_curve (transs);
+		if (curve_s == fmtcl::TransCurve_UNDEF)
+		{
+			throw_inval_arg ("invalid transs value.");
+		}
+	}
+	if (! transd.empty ())
+	{
+		curve_d = fmtcl::TransUtil::conv_string_to_curve (transd);
+		if (curve_d == fmtcl::TransCurve_UNDEF)
+		{
+			throw_inval_arg ("invalid transd value.");
+		}
+	}
+
+	const int      lut3d_res = get_arg_int (in, out, "lut3d", 0);
+	if (   lut3d_res != 0
+	    && (   lut3d_res < fmtcl::Lut3d::_min_res
+	        || lut3d_res > fmtcl::Lut3d::_max_res))
+	{
+		throw_inval_arg ("lut3d must be 0 or in the 2-129 range.");
+	}
+
+	const int      ret_val = _proc_uptr->configure (
+		_mat_main,
+		conv_vsfmt_to_picfmt (fmt_dst, true), curve_d,
+		conv_vsfmt_to_picfmt (fmt_src, true), curve_s,
+		lut3d_res
 	);
+	check_matrix_coef_err (*this, ret_val);
 
 	if (_vsapi.mapGetError (&out) != nullptr)
 	{
@@ -163,6 +200,8 @@ const ::VSFrame *	Primaries::get_frame (int n, int activation_reason, void * &fr
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.primaries");
+
 		const int      w = _vsapi.getFrameWidth (&src, 0);
 		const int      h = _vsapi.getFrameHeight (&src, 0);
 		dst_ptr = _vsapi.newVideoFrame (&_vi_out.format, w, h, &src, &core);
@@ -182,6 +221,8 @@ const ::VSFrame *	Primaries::get_frame (int n, int activation_reason, void * &fr
 		{
 			_vsapi.mapDeleteKey (&dst_prop, "_Primaries");
 		}
+
+		export_perf_capture (perf_capture, *dst_ptr, _vsapi);
 	}
 
 	return dst_ptr;
@@ -220,7 +261,7 @@ void	Primaries::check_colorspace (const ::VSVideoFormat &fmt, const char *inout_
 		fstb::snprintf4all (
 			_filter_error_msg_0,
 			_max_error_buf_len,
-			"%s colorspace must be RGB (assumed linear).",
+			"%s colorspace must be RGB.",
 			inout_0
 		);
 		throw_inval_arg (_filter_error_msg_0);
@@ -27,6 +27,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include "conc/AtomicPtr.h"
 #include "fmtcl/ChromaPlacement.h"
 #include "fmtcl/FilterResize.h"
 #include "fmtcl/InterlacingType.h"
@@ -76,6 +77,12 @@ public:
 	               conv_str_to_chroma_placement (const vsutl::FilterBase &flt, std::string cplace);
 	static void    conv_str_to_chroma_subspl (const vsutl::FilterBase &flt, int &ssh, int &ssv, std::string css);
 
+	static constexpr int _max_nbr_planes = 3;
+
+	typedef std::array <fmtcl::ResamplePlaneData, _max_nbr_planes> PlaneDataArray;
+
+	static void    read_plane_data (PlaneDataArray &pd_arr, const vsutl::FilterBase &flt, const ::VSMap &in, ::VSMap &out, const ::VSAPI &vsapi, int nbr_planes, int src_w, int src_h);
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -93,13 +100,21 @@ private:
 
 	using Ru = fmtcl::ResampleUtil;
 
-	static constexpr int _max_nbr_planes = 3;
-
-	typedef std::array <fmtcl::ResamplePlaneData, _max_nbr_planes> PlaneDataArray;
+	// Filter pointers, indexed by plane, itl_d and itl_s
+	typedef std::array <
+		std::array <
+			std::array <
+				conc::AtomicPtr <fmtcl::FilterResize>,
+				fmtcl::InterlacingType_NBR_ELT
+			>,
+			fmtcl::InterlacingType_NBR_ELT
+		>,
+		_max_nbr_planes
+	> FilterPtrArray;
 
 	::VSVideoFormat
 	               get_output_colorspace (const ::VSMap &in, ::VSMap &out, ::VSCore &core, const ::VSVideoFormat &fmt_src) const;
-	bool           cumulate_flag (bool flag, const ::VSMap &in, ::VSMap &out, const char name_0 [], int pos = 0) const;
+	static bool    cumulate_flag (const vsutl::FilterBase &flt, bool flag, const ::VSMap &in, ::VSMap &out, const char name_0 [], int pos = 0);
 	int            process_plane_proc (::VSFrame &dst, int n, int plane_index, ::VSFrameContext &frame_ctx, const vsutl::NodeRefSPtr &src_node1_sptr, const Ru::FrameInfo &frame_info);
 	int            process_plane_copy (::VSFrame &dst, int n, int plane_index, ::VSFrameContext &frame_ctx, const vsutl::NodeRefSPtr &src_node1_sptr);
 	fmtcl::FilterResize *
@@ -136,13 +151,15 @@ private:
 	fmtcl::ChromaPlacement
 	               _cplace_d   = fmtcl::ChromaPlacement_MPEG2;
 
-	bool           _sse2_flag  = false;
-	bool           _avx2_flag  = false;
+	bool           _sse2_flag   = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 	vsutl::PlaneProcessor
 	               _plane_processor;
 	std::mutex     _filter_mutex;          // To access _filter_uptr_map.
 	std::map <fmtcl::ResampleSpecPlane, std::unique_ptr <fmtcl::FilterResize> >
 	               _filter_uptr_map;       // Created only on request.
+	FilterPtrArray _filter_ptr_arr;        // Shortcuts to the _filter_uptr_map content, readable without lock. Set once, 0 = not set yet.
 
 	PlaneDataArray _plane_data_arr;
 
@@ -88,8 +88,9 @@ Resample::Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 	fstb::unused (user_data_ptr);
 
 	const fmtc::CpuOpt   cpu_opt (*this, in, out);
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx2_flag = cpu_opt.has_avx2 ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
 
 	// Checks the input clip
 	if (! vsutl::is_constant_format (_vi_in))
@@ -258,182 +259,11 @@ Resample::Resample (const ::VSMap &in, ::VSMap &out, void *user_data_ptr, ::VSCo
 		*this, get_arg_str (in, out, "cplaced", cplace_str, 0, &_cplace_d_set_flag)
 	);
 
-	// Could be per-plane, but it would be more complicated to use with the
-	// Vapoursynth interface
-	const std::vector <double> impulse   =
-		get_arg_vflt (in, out, "impulse" , { });
-	const std::vector <double> impulse_h =
-		get_arg_vflt (in, out, "impulseh", impulse);
-	const std::vector <double> impulse_v =
-		get_arg_vflt (in, out, "impulsev", impulse);
-
 	// Per-plane parameters
-	const int      nbr_sx = _vsapi.mapNumElements (&in, "sx");
-	const int      nbr_sy = _vsapi.mapNumElements (&in, "sy");
-	const int      nbr_sw = _vsapi.mapNumElements (&in, "sw");
-	const int      nbr_sh = _vsapi.mapNumElements (&in, "sh");
-	for (int plane_index = 0; plane_index < fmt_src.numPlanes; ++plane_index)
-	{
-		auto &         plane_data = _plane_data_arr [plane_index];
-
-		// Source window
-		auto &         s = plane_data._win;
-		if (plane_index > 0)
-		{
-			s = _plane_data_arr [plane_index - 1]._win;
-		}
-		else
-		{
-			s._x = 0;
-			s._y = 0;
-			s._w = 0;
-			s._h = 0;
-		}
-
-		if (plane_index < nbr_sx)
-		{
-			s._x = get_arg_flt (in, out, "sx", s._x, plane_index);
-		}
-		if (plane_index < nbr_sy)
-		{
-			s._y = get_arg_flt (in, out, "sy", s._y, plane_index);
-		}
-		if (plane_index < nbr_sw)
-		{
-			s._w = get_arg_flt (in, out, "sw", s._w, plane_index);
-		}
-		if (plane_index < nbr_sh)
-		{
-			s._h = get_arg_flt (in, out, "sh", s._h, plane_index);
-		}
-
-		const double   eps = 1e-9;
-
-		if (fstb::is_null (s._w, eps))
-		{
-			s._w = _src_width;
-		}
-		else if (s._w < 0)
-		{
-			s._w = _src_width + s._w - s._x;
-			if (s._w <= eps)
-			{
-				throw_inval_arg ("sw must be positive.");
-			}
-		}
-
-		if (fstb::is_null (s._h, eps))
-		{
-			s._h = _src_height;
-		}
-		else if (s._h < 0)
-		{
-			s._h = _src_height + s._h - s._y;
-			if (s._h <= eps)
-			{
-				throw_inval_arg ("sh must be positive.");
-			}
-		}
-
-		// Kernel
-		std::string    kernel_fnc     = get_arg_str (in, out, "kernel", "spline36", -plane_index);
-		std::string    kernel_fnc_h   = get_arg_str (in, out, "kernelh", ""       , -plane_index);
-		std::string    kernel_fnc_v   = get_arg_str (in, out, "kernelv", ""       , -plane_index);
-		const int      kovrspl        = get_arg_int (in, out, "kovrspl", 0   , -plane_index);
-		const int      taps           = get_arg_int (in, out, "taps"   , 4   , -plane_index);
-		const int      taps_h         = get_arg_int (in, out, "tapsh"  , taps, -plane_index);
-		const int      taps_v         = get_arg_int (in, out, "tapsv"  , taps, -plane_index);
-		bool           a1_flag, a1_h_flag, a1_v_flag;
-		bool           a2_flag, a2_h_flag, a2_v_flag;
-		bool           a3_flag, a3_h_flag, a3_v_flag;
-		const double   a1             = get_arg_flt (in, out, "a1", 0.0, -plane_index, &a1_flag);
-		const double   a2             = get_arg_flt (in, out, "a2", 0.0, -plane_index, &a2_flag);
-		const double   a3             = get_arg_flt (in, out, "a3", 0.0, -plane_index, &a3_flag);
-		const double   a1_h           = get_arg_flt (in, out, "a1h", a1, -plane_index, &a1_h_flag);
-		const double   a2_h           = get_arg_flt (in, out, "a2h", a2, -plane_index, &a2_h_flag);
-		const double   a3_h           = get_arg_flt (in, out, "a3h", a3, -plane_index, &a3_h_flag);
-		const double   a1_v           = get_arg_flt (in, out, "a1v", a1, -plane_index, &a1_v_flag);
-		const double   a2_v           = get_arg_flt (in, out, "a2v", a2, -plane_index, &a2_v_flag);
-		const double   a3_v           = get_arg_flt (in, out, "a3v", a3, -plane_index, &a3_v_flag);
-		const double   total          = get_arg_flt (in, out, "total", 0.0, -plane_index);
-		plane_data._norm_val_h        = get_arg_flt (in, out, "totalh", total, -plane_index);
-		plane_data._norm_val_v        = get_arg_flt (in, out, "totalv", total, -plane_index);
-		const bool     invks_flag     = (get_arg_int (in, out, "invks", 0, -plane_index) != 0);
-		const bool     invks_h_flag   = cumulate_flag (invks_flag, in, out, "invksh", -plane_index);
-		const bool     invks_v_flag   = cumulate_flag (invks_flag, in, out, "invksv", -plane_index);
-		const int      invks_taps     = get_arg_int (in, out, "invkstaps" , 4         , -plane_index);
-		const int      invks_taps_h   = get_arg_int (in, out, "invkstapsh", invks_taps, -plane_index);
-		const int      invks_taps_v   = get_arg_int (in, out, "invkstapsv", invks_taps, -plane_index);
-		plane_data._kernel_scale_h    = get_arg_flt (in, out, "fh", 1.0, -plane_index);
-		plane_data._kernel_scale_v    = get_arg_flt (in, out, "fv", 1.0, -plane_index);
-		plane_data._preserve_center_flag = (get_arg_int (in, out, "center", 1, -plane_index) != 0);
-		if (kernel_fnc_h.empty ())
-		{
-			kernel_fnc_h = kernel_fnc;
-		}
-		if (kernel_fnc_v.empty ())
-		{
-			kernel_fnc_v = kernel_fnc;
-		}
-		if (fstb::is_null (plane_data._kernel_scale_h))
-		{
-			throw_inval_arg ("fh cannot be null.");
-		}
-		if (fstb::is_null (plane_data._kernel_scale_v))
-		{
-			throw_inval_arg ("fv cannot be null.");
-		}
-		if (   taps_h < 1 || taps_h > Ru::_max_nbr_taps
-		    || taps_v < 1 || taps_v > Ru::_max_nbr_taps)
-		{
-			throw_inval_arg ("taps* must be in the 1-128 range.");
-		}
-		if (plane_data._norm_val_h < 0)
-		{
-			throw_inval_arg ("totalh must be positive or null.");
-		}
-		if (plane_data._norm_val_v < 0)
-		{
-			throw_inval_arg ("totalv must be positive or null.");
-		}
-		if (   invks_taps_h < 1 || invks_taps_h > Ru::_max_nbr_taps
-		    || invks_taps_v < 1 || invks_taps_v > Ru::_max_nbr_taps)
-		{
-			throw_inval_arg ("invkstaps* must be in the 1-128 range.");
-		}
-
-		// Serious stuff now
-		try
-		{
-			plane_data._kernel_arr [fmtcl::FilterResize::Dir_H].create_kernel (
-				kernel_fnc_h, impulse_h, taps_h,
-				(a1_flag || a1_h_flag), a1_h,
-				(a2_flag || a2_h_flag), a2_h,
-				(a3_flag || a3_h_flag), a3_h,
-				kovrspl,
-				invks_h_flag,
-				invks_taps_h
-			);
-
-			plane_data._kernel_arr [fmtcl::FilterResize::Dir_V].create_kernel (
-				kernel_fnc_v, impulse_v, taps_v,
-				(a1_flag || a1_v_flag), a1_v,
-				(a2_flag || a2_v_flag), a2_v,
-				(a3_flag || a3_v_flag), a3_v,
-				kovrspl,
-				invks_v_flag,
-				invks_taps_v
-			);
-		}
-		catch (const std::exception &e)
-		{
-			throw_inval_arg (e.what ());
-		}
-		catch (...)
-		{
-			throw_inval_arg ("resample: failed to create kernel.");
-		}
-	}
+	read_plane_data (
+		_plane_data_arr, *this, in, out, _vsapi,
+		fmt_src.numPlanes, _src_width, _src_height
+	);
 
 	create_all_plane_specs ();
 }
@@ -475,6 +305,8 @@ const ::VSFrame *	Resample::get_frame (int n, int activation_reason, void * &fra
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.resample");
+
 		dst_ptr = _vsapi.newVideoFrame (
 			&_vi_out.format,
 			_vi_out.width,
@@ -597,6 +429,11 @@ const ::VSFrame *	Resample::get_frame (int n, int activation_reason, void * &fra
 			_vsapi.freeFrame (dst_ptr);
 			dst_ptr = nullptr;
 		}
+
+		if (dst_ptr != nullptr)
+		{
+			export_perf_capture (perf_capture, *dst_ptr, _vsapi);
+		}
 	}
 
 	return dst_ptr;
@@ -628,6 +465,194 @@ void	Resample::conv_str_to_chroma_subspl (const vsutl::FilterBase &flt, int &ssh
 
 
 
+// Reads the source windows and creates the kernels. The windows are
+// converted to absolute coordinates.
+void	Resample::read_plane_data (PlaneDataArray &pd_arr, const vsutl::FilterBase &flt, const ::VSMap &in, ::VSMap &out, const ::VSAPI &vsapi, int nbr_planes, int src_w, int src_h)
+{
+	assert (nbr_planes > 0);
+	assert (nbr_planes <= _max_nbr_planes);
+	assert (src_w > 0);
+	assert (src_h > 0);
+
+	// Could be per-plane, but it would be more complicated to use with the
+	// Vapoursynth interface
+	const std::vector <double> impulse   =
+		flt.get_arg_vflt (in, out, "impulse" , { });
+	const std::vector <double> impulse_h =
+		flt.get_arg_vflt (in, out, "impulseh", impulse);
+	const std::vector <double> impulse_v =
+		flt.get_arg_vflt (in, out, "impulsev", impulse);
+
+	const int      nbr_sx = vsapi.mapNumElements (&in, "sx");
+	const int      nbr_sy = vsapi.mapNumElements (&in, "sy");
+	const int      nbr_sw = vsapi.mapNumElements (&in, "sw");
+	const int      nbr_sh = vsapi.mapNumElements (&in, "sh");
+	for (int plane_index = 0; plane_index < nbr_planes; ++plane_index)
+	{
+		auto &         plane_data = pd_arr [plane_index];
+
+		// Source window
+		auto &         s = plane_data._win;
+		if (plane_index > 0)
+		{
+			s = pd_arr [plane_index - 1]._win;
+		}
+		else
+		{
+			s._x = 0;
+			s._y = 0;
+			s._w = 0;
+			s._h = 0;
+		}
+
+		if (plane_index < nbr_sx)
+		{
+			s._x = flt.get_arg_flt (in, out, "sx", s._x, plane_index);
+		}
+		if (plane_index < nbr_sy)
+		{
+			s._y = flt.get_arg_flt (in, out, "sy", s._y, plane_index);
+		}
+		if (plane_index < nbr_sw)
+		{
+			s._w = flt.get_arg_flt (in, out, "sw", s._w, plane_index);
+		}
+		if (plane_index < nbr_sh)
+		{
+			s._h = flt.get_arg_flt (in, out, "sh", s._h, plane_index);
+		}
+
+		const double   eps = 1e-9;
+
+		if (fstb::is_null (s._w, eps))
+		{
+			s._w = src_w;
+		}
+		else if (s._w < 0)
+		{
+			s._w = src_w + s._w - s._x;
+			if (s._w <= eps)
+			{
+				flt.throw_inval_arg ("sw must be positive.");
+			}
+		}
+
+		if (fstb::is_null (s._h, eps))
+		{
+			s._h = src_h;
+		}
+		else if (s._h < 0)
+		{
+			s._h = src_h + s._h - s._y;
+			if (s._h <= eps)
+			{
+				flt.throw_inval_arg ("sh must be positive.");
+			}
+		}
+
+		// Kernel
+		std::string    kernel_fnc     = flt.get_arg_str (in, out, "kernel", "spline36", -plane_index);
+		std::string    kernel_fnc_h   = flt.get_arg_str (in, out, "kernelh", ""       , -plane_index);
+		std::string    kernel_fnc_v   = flt.get_arg_str (in, out, "kernelv", ""       , -plane_index);
+		const int      kovrspl        = flt.get_arg_int (in, out, "kovrspl", 0   , -plane_index);
+		const int      taps           = flt.get_arg_int (in, out, "taps"   , 4   , -plane_index);
+		const int      taps_h         = flt.get_arg_int (in, out, "tapsh"  , taps, -plane_index);
+		const int      taps_v         = flt.get_arg_int (in, out, "tapsv"  , taps, -plane_index);
+		bool           a1_flag, a1_h_flag, a1_v_flag;
+		bool           a2_flag, a2_h_flag, a2_v_flag;
+		bool           a3_flag, a3_h_flag, a3_v_flag;
+		const double   a1             = flt.get_arg_flt (in, out, "a1", 0.0, -plane_index, &a1_flag);
+		const double   a2             = flt.get_arg_flt (in, out, "a2", 0.0, -plane_index, &a2_flag);
+		const double   a3             = flt.get_arg_flt (in, out, "a3", 0.0, -plane_index, &a3_flag);
+		const double   a1_h           = flt.get_arg_flt (in, out, "a1h", a1, -plane_index, &a1_h_flag);
+		const double   a2_h           = flt.get_arg_flt (in, out, "a2h", a2, -plane_index, &a2_h_flag);
+		const double   a3_h           = flt.get_arg_flt (in, out, "a3h", a3, -plane_index, &a3_h_flag);
+		const double   a1_v           = flt.get_arg_flt (in, out, "a1v", a1, -plane_index, &a1_v_flag);
+		const double   a2_v           = flt.get_arg_flt (in, out, "a2v", a2, -plane_index, &a2_v_flag);
+		const double   a3_v           = flt.get_arg_flt (in, out, "a3v", a3, -plane_index, &a3_v_flag);
+		const double   total          = flt.get_arg_flt (in, out, "total", 0.0, -plane_index);
+		plane_data._norm_val_h        = flt.get_arg_flt (in, out, "totalh", total, -plane_index);
+		plane_data._norm_val_v        = flt.get_arg_flt (in, out, "totalv", total, -plane_index);
+		const bool     invks_flag     = (flt.get_arg_int (in, out, "invks", 0, -plane_index) != 0);
+		const bool     invks_h_flag   = cumulate_flag (flt, invks_flag, in, out, "invksh", -plane_index);
+		const bool     invks_v_flag   = cumulate_flag (flt, invks_flag, in, out, "invksv", -plane_index);
+		const int      invks_taps     = flt.get_arg_int (in, out, "invkstaps" , 4         , -plane_index);
+		const int      invks_taps_h   = flt.get_arg_int (in, out, "invkstapsh", invks_taps, -plane_index);
+		const int      invks_taps_v   = flt.get_arg_int (in, out, "invkstapsv", invks_taps, -plane_index);
+		plane_data._kernel_scale_h    = flt.get_arg_flt (in, out, "fh", 1.0, -plane_index);
+		plane_data._kernel_scale_v    = flt.get_arg_flt (in, out, "fv", 1.0, -plane_index);
+		plane_data._preserve_center_flag = (flt.get_arg_int (in, out, "center", 1, -plane_index) != 0);
+		if (kernel_fnc_h.empty ())
+		{
+			kernel_fnc_h = kernel_fnc;
+		}
+		if (kernel_fnc_v.empty ())
+		{
+			kernel_fnc_v = kernel_fnc;
+		}
+		if (fstb::is_null (plane_data._kernel_scale_h))
+		{
+			flt.throw_inval_arg ("fh cannot be null.");
+		}
+		if (fstb::is_null (plane_data._kernel_scale_v))
+		{
+			flt.throw_inval_arg ("fv cannot be null.");
+		}
+		if (   taps_h < 1 || taps_h > Ru::_max_nbr_taps
+		    || taps_v < 1 || taps_v > Ru::_max_nbr_taps)
+		{
+			flt.throw_inval_arg ("taps* must be in the 1-128 range.");
+		}
+		if (plane_data._norm_val_h < 0)
+		{
+			flt.throw_inval_arg ("totalh must be positive or null.");
+		}
+		if (plane_data._norm_val_v < 0)
+		{
+			flt.throw_inval_arg ("totalv must be positive or null.");
+		}
+		if (   invks_taps_h < 1 || invks_taps_h > Ru::_max_nbr_taps
+		    || invks_taps_v < 1 || invks_taps_v > Ru::_max_nbr_taps)
+		{
+			flt.throw_inval_arg ("invkstaps* must be in the 1-128 range.");
+		}
+
+		// Serious stuff now
+		try
+		{
+			plane_data._kernel_arr [fmtcl::FilterResize::Dir_H].create_kernel (
+				kernel_fnc_h, impulse_h, taps_h,
+				(a1_flag || a1_h_flag), a1_h,
+				(a2_flag || a2_h_flag), a2_h,
+				(a3_flag || a3_h_flag), a3_h,
+				kovrspl,
+				invks_h_flag,
+				invks_taps_h
+			);
+
+			plane_data._kernel_arr [fmtcl::FilterResize::Dir_V].create_kernel (
+				kernel_fnc_v, impulse_v, taps_v,
+				(a1_flag || a1_v_flag), a1_v,
+				(a2_flag || a2_v_flag), a2_v,
+				(a3_flag || a3_v_flag), a3_v,
+				kovrspl,
+				invks_v_flag,
+				invks_taps_v
+			);
+		}
+		catch (const std::exception &e)
+		{
+			flt.throw_inval_arg (e.what ());
+		}
+		catch (...)
+		{
+			flt.throw_inval_arg ("resample: failed to create kernel.");
+		}
+	}
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -742,13 +767,13 @@ constexpr int	Resample::_max_nbr_planes;
 
 
 
-bool	Resample::cumulate_flag (bool flag, const ::VSMap &in, ::VSMap &out, const char name_0 [], int pos) const
+bool	Resample::cumulate_flag (const vsutl::FilterBase &flt, bool flag, const ::VSMap &in, ::VSMap &out, const char name_0 [], int pos)
 {
 	assert (name_0 != nullptr);
 
-	if (is_arg_defined (in, name_0))
+	if (flt.is_arg_defined (in, name_0))
 	{
-		const int      val = get_arg_int (in, out, name_0, 0, pos);
+		const int      val = flt.get_arg_int (in, out, name_0, 0, pos);
 		flag = (val != 0);
 	}
 
@@ -848,7 +873,7 @@ int	Resample::process_plane_copy (::VSFrame &dst, int n, int plane_index, ::VSFr
 		scale_info_ptr = &scale_info;
 	}
 
-	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag);
+	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, _avx512_flag);
 	blitter.bitblt (
 		_dst_type, _dst_res, data_dst_ptr, stride_dst,
 		_src_type, _src_res, data_src_ptr, stride_src,
@@ -869,6 +894,18 @@ fmtcl::FilterResize *	Resample::create_or_access_plane_filter (int plane_index,
 	assert (itl_s >= 0);
 	assert (itl_s < fmtcl::InterlacingType_NBR_ELT);
 
+	// Fast path, the filter has already been accessed for this combination
+	conc::AtomicPtr <fmtcl::FilterResize> &   filter_aptr =
+		_filter_ptr_arr [plane_index] [itl_d] [itl_s];
+	fmtcl::FilterResize *   filter_ptr = filter_aptr;
+	if (filter_ptr != nullptr)
+	{
+		return filter_ptr;
+	}
+
+	// First access: finds the filter or creates it. Several plane and
+	// interlacing combinations may share the same specs, hence the same
+	// filter.
 	const auto &   plane_data = _plane_data_arr [plane_index];
 	const fmtcl::ResampleSpecPlane & key = plane_data._spec_arr [itl_d] [itl_s];
 
@@ -884,11 +921,15 @@ fmtcl::FilterResize *	Resample::create_or_access_plane_filter (int plane_index,
 			_norm_flag, plane_data._norm_val_h, plane_data._norm_val_v,
 			plane_data._gain,
 			_src_type, _src_res, _dst_type, _dst_res,
-			_int_flag, _sse2_flag, _avx2_flag
+			_int_flag, _sse2_flag, _avx2_flag, _avx512_flag
 		);
 	}
 
-	return filter_uptr.get ();
+	// The filter is fully constructed at this point, it can be published.
+	filter_ptr  = filter_uptr.get ();
+	filter_aptr = filter_ptr;
+
+	return filter_ptr;
 }
 
 
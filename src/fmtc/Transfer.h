@@ -88,8 +88,9 @@ private:
 	               _vi_in;     // Input. Must be declared after _clip_src_sptr because of initialisation order.
 	::VSVideoInfo  _vi_out;    // Output. Must be declared after _vi_in.
 
-	bool           _sse2_flag = false;
-	bool           _avx2_flag = false;
+	bool           _sse2_flag   = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 	std::string    _transs;
 	std::string    _transd;
 	double         _contrast  = 1;
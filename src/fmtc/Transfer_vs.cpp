@@ -67,8 +67,9 @@ Transfer::Transfer (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, :
 	fstb::conv_to_lower_case (_transd);
 
 	const fmtc::CpuOpt   cpu_opt (*this, in, out);
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx2_flag = cpu_opt.has_avx2 ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
 
 	// Checks the input clip
 	if (! vsutl::is_constant_format (_vi_in))
@@ -238,6 +239,8 @@ Transfer::Transfer (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, :
 		}
 	}
 
+	const bool     direct_flag = (get_arg_int (in, out, "direct", 0) != 0);
+
 	// Finally...
 	const fmtcl::PicFmt  src_fmt =
 		conv_vsfmt_to_picfmt (_vi_in.format , _full_range_src_flag);
@@ -247,8 +250,8 @@ Transfer::Transfer (const ::VSMap &in, ::VSMap &out, void * /*user_data_ptr*/, :
 		dst_fmt, _curve_d, _logc_ei_d,
 		src_fmt, _curve_s, _logc_ei_s,
 		_contrast, _gcor, lb, lws, lwd, lamb, scene_flag, match, gy_proc,
-		sig_c, sig_t,
-		_sse2_flag, _avx2_flag
+		sig_c, sig_t, direct_flag,
+		_sse2_flag, _avx2_flag, _avx512_flag
 	);
 }
 
@@ -292,6 +295,8 @@ const ::VSFrame *	Transfer::get_frame (int n, int activation_reason, void * &fra
 		);
 		const ::VSFrame & src = *src_sptr;
 
+		fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc.transfer");
+
 		const int         w  =  _vsapi.getFrameWidth (&src, 0);
 		const int         h  =  _vsapi.getFrameHeight (&src, 0);
 		dst_ptr = _vsapi.newVideoFrame (&_vi_out.format, w, h, &src, &core);
@@ -320,6 +325,8 @@ const ::VSFrame *	Transfer::get_frame (int n, int activation_reason, void * &fra
 				txt.c_str (), int (txt.length () + 1), ::dtUtf8, ::maReplace
 			);
 		}
+
+		export_perf_capture (perf_capture, *dst_ptr, _vsapi);
 	}
 
 	return dst_ptr;
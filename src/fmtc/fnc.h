@@ -29,6 +29,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fmtcl/ColorFamily.h"
 #include "fmtcl/ColorSpaceH265.h"
+#include "fmtcl/PerfTrace.h"
 #include "fmtcl/ProcComp3Arg.h"
 #include "fmtcl/PicFmt.h"
 #include "fmtcl/SplFmt.h"
@@ -60,7 +61,9 @@ void conv_vsfmt_to_splfmt (fmtcl::SplFmt &type, int &bitdepth, const ::VSVideoFo
 fmtcl::ColorFamily conv_vsfmt_to_colfam (const ::VSVideoFormat &fmt);
 int conv_fmtcl_colfam_to_vs (fmtcl::ColorFamily cf);
 void prepare_matrix_coef (const vsutl::FilterBase &filter, fmtcl::MatrixProc &mat_proc, const fmtcl::Mat4 &mat_main, const ::VSVideoFormat &fmt_dst, bool full_range_dst_flag, const ::VSVideoFormat &fmt_src, bool full_range_src_flag, fmtcl::ColorSpaceH265 csp_out = fmtcl::ColorSpaceH265_UNSPECIFIED, int plane_out = -1);
+void check_matrix_coef_err (const vsutl::FilterBase &filter, int ret_val);
 fmtcl::ProcComp3Arg build_mat_proc (const ::VSAPI &vsapi, ::VSFrame &dst, const ::VSFrame &src, bool single_plane_flag = false);
+void export_perf_capture (fmtcl::PerfTrace::FrameCapture &capture, ::VSFrame &dst, const ::VSAPI &vsapi);
 
 
 
@@ -71,6 +71,10 @@ fmtcl::SplFmt	conv_vsfmt_to_splfmt (const ::VSVideoFormat &fmt)
 	{
 		splfmt = fmtcl::SplFmt_FLOAT;
 	}
+	else if (fmt.sampleType == ::stFloat && fmt.bitsPerSample == 16)
+	{
+		splfmt = fmtcl::SplFmt_FLOAT16;
+	}
 	else
 	{
 		if (fmt.bitsPerSample <= 8)
@@ -153,6 +157,14 @@ void	prepare_matrix_coef (const vsutl::FilterBase &filter, fmtcl::MatrixProc &ma
 		mat_proc, mat_main, fmt_dst_fmtcl, fmt_src_fmtcl, csp_out, plane_out
 	);
 
+	check_matrix_coef_err (filter, ret_val);
+}
+
+
+
+// ret_val is a fmtcl::MatrixProc::Err code
+void	check_matrix_coef_err (const vsutl::FilterBase &filter, int ret_val)
+{
 	if (ret_val != fmtcl::MatrixProc::Err_OK)
 	{
 		if (ret_val == fmtcl::MatrixProc::Err_POSSIBLE_OVERFLOW)
@@ -214,6 +226,38 @@ fmtcl::ProcComp3Arg	build_mat_proc (const ::VSAPI &vsapi, ::VSFrame &dst, const
 
 
 
+// Stops the capture and appends the recorded stages to the frame properties.
+// Properties are inherited from the source frame, so each fmtconv filter of
+// a chain adds its own entries to the arrays:
+// FmtcPerfStage (data), FmtcPerfSimd (data), FmtcPerfNs and FmtcPerfPix.
+void	export_perf_capture (fmtcl::PerfTrace::FrameCapture &capture, ::VSFrame &dst, const ::VSAPI &vsapi)
+{
+	if (! capture.is_active ())
+	{
+		return;
+	}
+
+	capture.stop ();
+
+	::VSMap &      dst_prop = *(vsapi.getFramePropertiesRW (&dst));
+	for (const auto &entry : capture.get_entries ())
+	{
+		vsapi.mapSetData (
+			&dst_prop, "FmtcPerfStage",
+			entry._name_0, -1, ::dtUtf8, ::maAppend
+		);
+		vsapi.mapSetData (
+			&dst_prop, "FmtcPerfSimd",
+			fmtcl::PerfTrace::get_simd_name (entry._simd), -1, ::dtUtf8,
+			::maAppend
+		);
+		vsapi.mapSetInt (&dst_prop, "FmtcPerfNs" , entry._dur_ns , ::maAppend);
+		vsapi.mapSetInt (&dst_prop, "FmtcPerfPix", entry._nbr_pix, ::maAppend);
+	}
+}
+
+
+
 }	// namespace fmtc
 
 
@@ -67,6 +67,7 @@ public:
 		Param_TPDFO,
 		Param_TPDFN,
 		Param_CORPLANE,
+		Param_ED3P,
 
 		Param_NBR_ELT,
 	};
@@ -107,6 +108,9 @@ private:
 	bool           _fulld_flag     = false;
 	bool           _fulls_flag     = false;
 
+	// Single pass on the 3 planes, when the engine supports it
+	bool           _proc_3p_flag   = false;
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -153,6 +153,7 @@ Bitdepth::Bitdepth (::IScriptEnvironment &env, const ::AVSValue &args)
 	const bool     tpdfo_flag        = args [Param_TPDFO      ].AsBool (false);
 	const bool     tpdfn_flag        = args [Param_TPDFN      ].AsBool (false);
 	const bool     corplane_flag     = args [Param_CORPLANE   ].AsBool (false);
+	const bool     ed3p_flag         = args [Param_ED3P       ].AsBool (true);
 
 	// Finally...
 	const int      nbr_planes = vi.NumComponents ();
@@ -171,6 +172,28 @@ Bitdepth::Bitdepth (::IScriptEnvironment &env, const ::AVSValue &args)
 		tpdfo_flag, tpdfn_flag,
 		sse2_flag, avx2_flag
 	);
+
+	// The 3 planes can be dithered in a single pass when they share the
+	// same size and are all processed.
+	if (   ed3p_flag
+	    && nbr_planes == fmtcl::ProcComp3Arg::_nbr_planes
+	    && (   avsutl::is_rgb (vi)
+	        || (   vi.GetPlaneWidthSubsampling (PLANAR_U) == 0
+	            && vi.GetPlaneHeightSubsampling (PLANAR_U) == 0))
+	    && _engine_uptr->can_process_3_planes ())
+	{
+		_proc_3p_flag = true;
+		for (int plane_index = 0
+		;	plane_index < fmtcl::ProcComp3Arg::_nbr_planes
+		;	++ plane_index)
+		{
+			const auto     proc_mode = _plane_proc_uptr->get_mode (plane_index);
+			if (proc_mode != avsutl::PlaneProcMode_PROCESS)
+			{
+				_proc_3p_flag = false;
+			}
+		}
+	}
 }
 
 
@@ -179,8 +202,24 @@ Bitdepth::Bitdepth (::IScriptEnvironment &env, const ::AVSValue &args)
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_bitdepth");
 
-	_plane_proc_uptr->process_frame (dst_sptr, n, *env_ptr, nullptr);
+	if (_proc_3p_flag)
+	{
+		const auto     pa { build_mat_proc (vi, dst_sptr, _vi_src, src_sptr) };
+		try
+		{
+			_engine_uptr->process_3_planes (pa, n);
+		}
+		catch (...)
+		{
+			assert (false);
+		}
+	}
+	else
+	{
+		_plane_proc_uptr->process_frame (dst_sptr, n, *env_ptr, nullptr);
+	}
 
 	// Frame properties
 	if (supports_props ())
@@ -196,6 +235,11 @@ Bitdepth::Bitdepth (::IScriptEnvironment &env, const ::AVSValue &args)
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -50,11 +50,12 @@ Matrix2020CL::Matrix2020CL (::IScriptEnvironment &env, const ::AVSValue &args)
 ,	_vi_src (vi)
 {
 	const CpuOpt   cpu_opt (args [Param_CPUOPT]);
-	const bool     sse2_flag = cpu_opt.has_sse2 ();
-	const bool     avx2_flag = cpu_opt.has_avx2 ();
+	const bool     sse2_flag   = cpu_opt.has_sse2 ();
+	const bool     avx2_flag   = cpu_opt.has_avx2 ();
+	const bool     avx512_flag = cpu_opt.has_avx512bw ();
 
 	_proc_uptr = std::unique_ptr <fmtcl::Matrix2020CLProc> (
-		new fmtcl::Matrix2020CLProc (sse2_flag, avx2_flag)
+		new fmtcl::Matrix2020CLProc (sse2_flag, avx2_flag, avx512_flag)
 	);
 
 	// Checks the input clip
@@ -200,6 +201,7 @@ Matrix2020CL::Matrix2020CL (::IScriptEnvironment &env, const ::AVSValue &args)
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_matrix2020cl");
 
 	const auto     pa { build_mat_proc (vi, dst_sptr, _vi_src, src_sptr) };
 	_proc_uptr->process (pa);
@@ -240,6 +242,11 @@ Matrix2020CL::Matrix2020CL (::IScriptEnvironment &env, const ::AVSValue &args)
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -53,13 +53,14 @@ Matrix::Matrix (::IScriptEnvironment &env, const ::AVSValue &args)
 ,	_plane_out (args [Param_SINGLEOUT].AsInt (-1))
 {
 	const CpuOpt   cpu_opt (args [Param_CPUOPT]);
-	const bool     sse_flag  = cpu_opt.has_sse ();
-	const bool     sse2_flag = cpu_opt.has_sse2 ();
-	const bool     avx_flag  = cpu_opt.has_avx ();
-	const bool     avx2_flag = cpu_opt.has_avx2 ();
+	const bool     sse_flag    = cpu_opt.has_sse ();
+	const bool     sse2_flag   = cpu_opt.has_sse2 ();
+	const bool     avx_flag    = cpu_opt.has_avx ();
+	const bool     avx2_flag   = cpu_opt.has_avx2 ();
+	const bool     avx512_flag = cpu_opt.has_avx512bw ();
 
 	_proc_uptr = std::make_unique <fmtcl::MatrixProc> (
-		sse_flag, sse2_flag, avx_flag, avx2_flag
+		sse_flag, sse2_flag, avx_flag, avx2_flag, avx512_flag
 	);
 
 	// Checks the input clip
@@ -299,6 +300,7 @@ fmtcl::ColorSpaceH265	Matrix::find_cs_from_mat_str (::IScriptEnvironment &env, c
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_matrix");
 
 	const auto     pa { build_mat_proc (
 		vi, dst_sptr, _vi_src, src_sptr, (_plane_out >= 0)
@@ -338,6 +340,11 @@ fmtcl::ColorSpaceH265	Matrix::find_cs_from_mat_str (::IScriptEnvironment &env, c
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -26,7 +26,7 @@ http://www.wtfpl.net/ for more details.
 #include "avsutl/VideoFilterBase.h"
 #include "fmtcavs/FmtAvs.h"
 #include "fmtcavs/ProcAlpha.h"
-#include "fmtcl/MatrixProc.h"
+#include "fmtcl/PrimariesProc.h"
 #include "fmtcl/RgbSystem.h"
 
 #include <memory>
@@ -64,6 +64,9 @@ public:
 		Param_PRIMD,
 		Param_WCONV,
 		Param_CPUOPT,
+		Param_TRANSS,
+		Param_TRANSD,
+		Param_LUT3D,
 
 		Param_NBR_ELT
 	};
@@ -104,16 +107,17 @@ private:
 
 	fmtcl::Mat4    _mat_main { 1.0, fmtcl::Mat4::Preset_DIAGONAL };
 
-	std::unique_ptr <fmtcl::MatrixProc>
+	std::unique_ptr <fmtcl::PrimariesProc>
 	               _proc_uptr;
 
 	std::unique_ptr <fmtcavs::ProcAlpha>
 	               _proc_alpha_uptr;
 
-	bool           _sse_flag  = false;
-	bool           _sse2_flag = false;
-	bool           _avx_flag  = false;
-	bool           _avx2_flag = false;
+	bool           _sse_flag    = false;
+	bool           _sse2_flag   = false;
+	bool           _avx_flag    = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 
 
 
@@ -31,6 +31,7 @@ http://www.wtfpl.net/ for more details.
 #include "fmtcavs/Primaries.h"
 #include "fmtcl/fnc.h"
 #include "fmtcl/PrimUtil.h"
+#include "fmtcl/TransUtil.h"
 #include "fstb/fnc.h"
 
 #include <array>
@@ -54,14 +55,15 @@ Primaries::Primaries (::IScriptEnvironment &env, const ::AVSValue &args)
 ,	_vi_src (vi)
 {
 	const CpuOpt   cpu_opt (args [Param_CPUOPT]);
-	_sse_flag  = cpu_opt.has_sse ();
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx_flag  = cpu_opt.has_avx ();
-	_avx2_flag = cpu_opt.has_avx2 ();
-
-	_proc_uptr = std::unique_ptr <fmtcl::MatrixProc> (new fmtcl::MatrixProc (
-		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag
-	));
+	_sse_flag    = cpu_opt.has_sse ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx_flag    = cpu_opt.has_avx ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
+
+	_proc_uptr = std::make_unique <fmtcl::PrimariesProc> (
+		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag, _avx512_flag
+	);
 
 	// Checks the input clip
 	const FmtAvs   fmt_src (vi);
@@ -72,9 +74,7 @@ Primaries::Primaries (::IScriptEnvironment &env, const ::AVSValue &args)
 	const auto     col_fam = fmt_src.get_col_fam ();
 	if (col_fam != fmtcl::ColorFamily_RGB)
 	{
-		env.ThrowError (
-			fmtcavs_PRIMARIES ": colorspace must be RGB (assumed linear)."
-		);
+		env.ThrowError (fmtcavs_PRIMARIES ": colorspace must be RGB.");
 	}
 	const auto     res      = fmt_src.get_bitdepth ();
 	const bool     flt_flag = fmt_src.is_float ();
@@ -117,12 +117,47 @@ Primaries::Primaries (::IScriptEnvironment &env, const ::AVSValue &args)
 	_mat_main.insert3 (mat_conv);
 	_mat_main.clean3 (1);
 
-	prepare_matrix_coef (
-		env, *_proc_uptr, _mat_main,
-		fmt_dst, true,
-		fmt_src, true,
-		fmtcl::ColorSpaceH265_RGB, -1
+	// Transfer curves. Empty strings: linear
+	std::string    transs = args [Param_TRANSS].AsString ("");
+	std::string    transd = args [Param_TRANSD].AsString (transs.c_str ());
+	fstb::conv_to_lower_case (transs);
+	fstb::conv_to_lower_case (transd);
+	auto           curve_s = fmtcl::TransCurve_UNDEF;
+	auto           curve_d = fmtcl::TransCurve_UNDEF;
+	if (! transs.empty ())
+	{
+		curve_s = fmtcl::TransUtil::conv_string_to_curve (transs);
+		if (curve_s == fmtcl::TransCurve_UNDEF)
+		{
+			env.ThrowError (fmtcavs_PRIMARIES ": invalid transs value.");
+		}
+	}
+	if (! transd.empty ())
+	{
+		curve_d = fmtcl::TransUtil::conv_string_to_curve (transd);
+		if (curve_d == fmtcl::TransCurve_UNDEF)
+		{
+			env.ThrowError (fmtcavs_PRIMARIES ": invalid transd value.");
+		}
+	}
+
+	const int      lut3d_res = args [Param_LUT3D].AsInt (0);
+	if (   lut3d_res != 0
+	    && (   lut3d_res < fmtcl::Lut3d::_min_res
+	        || lut3d_res > fmtcl::Lut3d::_max_res))
+	{
+		env.ThrowError (
+			fmtcavs_PRIMARIES ": lut3d must be 0 or in the 2-129 range."
+		);
+	}
+
+	const int      ret_val = _proc_uptr->configure (
+		_mat_main,
+		conv_fmtavs_to_picfmt (fmt_dst, true), curve_d,
+		conv_fmtavs_to_picfmt (fmt_src, true), curve_s,
+		lut3d_res
 	);
+	check_matrix_coef_err (env, ret_val);
 }
 
 
@@ -131,6 +166,7 @@ Primaries::Primaries (::IScriptEnvironment &env, const ::AVSValue &args)
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_primaries");
 
 	const auto     pa { build_mat_proc (vi, dst_sptr, _vi_src, src_sptr) };
 	_proc_uptr->process (pa);
@@ -156,6 +192,11 @@ Primaries::Primaries (::IScriptEnvironment &env, const ::AVSValue &args)
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -58,6 +58,7 @@ ProcAlpha::ProcAlpha (FmtAvs fmt_dst, FmtAvs fmt_src, int w, int h, const CpuOpt
 ,	_scale_info ()
 ,	_sse2_flag (cpu_opt.has_sse2 ())
 ,	_avx2_flag (cpu_opt.has_avx2 ())
+,	_avx512_flag (cpu_opt.has_avx512bw ())
 {
 	if (_dst_a_flag && _src_a_flag)
 	{
@@ -88,7 +89,7 @@ void	ProcAlpha::process_plane (::PVideoFrame &dst_sptr, ::PVideoFrame &src_sptr)
 			const uint8_t* src_ptr    = src_sptr->GetReadPtr (::PLANAR_A);
 			const int      src_stride = src_sptr->GetPitch (::PLANAR_A);
 
-			fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag);
+			fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, _avx512_flag);
 			blitter.bitblt (
 				_splfmt_dst, _dst_res, dst_ptr, dst_stride,
 				_splfmt_src, _src_res, src_ptr, src_stride,
@@ -71,8 +71,9 @@ private:
 	int            _h          = 0;
 	fmtcl::BitBltConv::ScaleInfo // Set only when both source and dest have an alpha plane
 	               _scale_info;
-	bool           _sse2_flag  = false;
-	bool           _avx2_flag  = false;
+	bool           _sse2_flag   = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 
 
 
@@ -24,6 +24,7 @@ http://www.wtfpl.net/ for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcavs/FmtAvs.h"
+#include "conc/AtomicPtr.h"
 #include "fmtcl/ChromaPlacement.h"
 #include "fmtcl/FilterResize.h"
 #include "fmtcl/InterlacingType.h"
@@ -153,6 +154,18 @@ private:
 
 	typedef std::array <fmtcl::ResamplePlaneData, _max_nbr_planes> PlaneDataArray;
 
+	// Filter pointers, indexed by plane, itl_d and itl_s
+	typedef std::array <
+		std::array <
+			std::array <
+				conc::AtomicPtr <fmtcl::FilterResize>,
+				fmtcl::InterlacingType_NBR_ELT
+			>,
+			fmtcl::InterlacingType_NBR_ELT
+		>,
+		_max_nbr_planes
+	> FilterPtrArray;
+
 	FmtAvs         get_output_colorspace (::IScriptEnvironment &env, const ::AVSValue &args, const FmtAvs &fmt_src);
 	void           process_plane_proc (::PVideoFrame &dst_sptr, ::IScriptEnvironment &env, int n, int plane_index, const Ru::FrameInfo &frame_info);
 	void           process_plane_copy (::PVideoFrame &dst_sptr, ::IScriptEnvironment &env, int n, int plane_index);
@@ -190,12 +203,14 @@ private:
 	fmtcl::ChromaPlacement
 	               _cplace_d   = fmtcl::ChromaPlacement_MPEG2;
 
-	bool           _sse2_flag  = false;
-	bool           _avx2_flag  = false;
+	bool           _sse2_flag   = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 
 	std::mutex     _filter_mutex;          // To access _filter_uptr_map.
 	std::map <fmtcl::ResampleSpecPlane, std::unique_ptr <fmtcl::FilterResize> >
 	               _filter_uptr_map;       // Created only on request.
+	FilterPtrArray _filter_ptr_arr;        // Shortcuts to the _filter_uptr_map content, readable without lock. Set once, 0 = not set yet.
 
 	PlaneDataArray _plane_data_arr;
 
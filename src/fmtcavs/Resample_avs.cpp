@@ -66,8 +66,9 @@ Resample::Resample (::IScriptEnvironment &env, const ::AVSValue &args)
 ,	_norm_flag (args [Param_CNORM].AsBool (true))
 {
 	const CpuOpt   cpu_opt (args [Param_CPUOPT]);
-	_sse2_flag = cpu_opt.has_sse2 ();
-	_avx2_flag = cpu_opt.has_avx2 ();
+	_sse2_flag   = cpu_opt.has_sse2 ();
+	_avx2_flag   = cpu_opt.has_avx2 ();
+	_avx512_flag = cpu_opt.has_avx512bw ();
 
 	// Checks the input clip
 	if (! _vi_src.IsPlanar ())
@@ -454,6 +455,7 @@ Resample::Resample (::IScriptEnvironment &env, const ::AVSValue &args)
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_resample");
 
 	Ru::FieldBased prop_fieldbased = Ru::FieldBased_INVALID;
 	Ru::Field      prop_field      = Ru::Field_INVALID;
@@ -571,6 +573,11 @@ Resample::Resample (::IScriptEnvironment &env, const ::AVSValue &args)
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -780,7 +787,7 @@ void	Resample::process_plane_copy (::PVideoFrame &dst_sptr, ::IScriptEnvironment
 		scale_info_ptr = &scale_info;
 	}
 
-	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag);
+	fmtcl::BitBltConv blitter (_sse2_flag, _avx2_flag, _avx512_flag);
 	blitter.bitblt (
 		_dst_type, _dst_res, data_dst_ptr, stride_dst,
 		_src_type, _src_res, data_src_ptr, stride_src,
@@ -799,6 +806,18 @@ fmtcl::FilterResize *	Resample::create_or_access_plane_filter (int plane_index,
 	assert (itl_s >= 0);
 	assert (itl_s < fmtcl::InterlacingType_NBR_ELT);
 
+	// Fast path, the filter has already been accessed for this combination
+	conc::AtomicPtr <fmtcl::FilterResize> &   filter_aptr =
+		_filter_ptr_arr [plane_index] [itl_d] [itl_s];
+	fmtcl::FilterResize *   filter_ptr = filter_aptr;
+	if (filter_ptr != nullptr)
+	{
+		return filter_ptr;
+	}
+
+	// First access: finds the filter or creates it. Several plane and
+	// interlacing combinations may share the same specs, hence the same
+	// filter.
 	const auto &   plane_data = _plane_data_arr [plane_index];
 	const fmtcl::ResampleSpecPlane & key = plane_data._spec_arr [itl_d] [itl_s];
 
@@ -814,11 +833,15 @@ fmtcl::FilterResize *	Resample::create_or_access_plane_filter (int plane_index,
 			_norm_flag, plane_data._norm_val_h, plane_data._norm_val_v,
 			plane_data._gain,
 			_src_type, _src_res, _dst_type, _dst_res,
-			_int_flag, _sse2_flag, _avx2_flag
+			_int_flag, _sse2_flag, _avx2_flag, _avx512_flag
 		);
 	}
 
-	return filter_uptr.get ();
+	// The filter is fully constructed at this point, it can be published.
+	filter_ptr  = filter_uptr.get ();
+	filter_aptr = filter_ptr;
+
+	return filter_ptr;
 }
 
 
@@ -73,6 +73,7 @@ public:
 		Param_DEBUG,
 		Param_SIG_C,
 		Param_SIG_T,
+		Param_DIRECT,
 
 		Param_NBR_ELT,
 	};
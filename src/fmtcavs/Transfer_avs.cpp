@@ -55,8 +55,9 @@ Transfer::Transfer (::IScriptEnvironment &env, const ::AVSValue &args)
 ,	_fulld_flag (args [Param_FULLD].AsBool (true))
 {
 	const CpuOpt   cpu_opt (args [Param_CPUOPT]);
-	const bool     sse2_flag = cpu_opt.has_sse2 ();
-	const bool     avx2_flag = cpu_opt.has_avx2 ();
+	const bool     sse2_flag   = cpu_opt.has_sse2 ();
+	const bool     avx2_flag   = cpu_opt.has_avx2 ();
+	const bool     avx512_flag = cpu_opt.has_avx512bw ();
 
 	// Checks the input clip
 	if (! _vi_src.IsPlanar ())
@@ -125,6 +126,7 @@ Transfer::Transfer (::IScriptEnvironment &env, const ::AVSValue &args)
 		:                  fmtcl::TransModel::GyProc::OFF;
 	const double   sig_c      = args [Param_SIG_C   ].AsFloat (6.5f);
 	const double   sig_t      = args [Param_SIG_T   ].AsFloat (0.5f);
+	const bool     direct_flag = args [Param_DIRECT  ].AsBool (false);
 
 	fstb::conv_to_lower_case (transs);
 	fstb::conv_to_lower_case (transd);
@@ -241,8 +243,8 @@ Transfer::Transfer (::IScriptEnvironment &env, const ::AVSValue &args)
 		dst_picfmt, _curve_d, logc_ei_d,
 		src_picfmt, _curve_s, logc_ei_s,
 		contrast, gcor, lb, lws, lwd, lamb, scene_flag, match, gy_proc,
-		sig_c, sig_t,
-		sse2_flag, avx2_flag
+		sig_c, sig_t, direct_flag,
+		sse2_flag, avx2_flag, avx512_flag
 	);
 }
 
@@ -252,6 +254,7 @@ Transfer::Transfer (::IScriptEnvironment &env, const ::AVSValue &args)
 {
 	::PVideoFrame  src_sptr = _clip_src_sptr->GetFrame (n, env_ptr);
 	::PVideoFrame	dst_sptr = build_new_frame (*env_ptr, vi, &src_sptr);
+	fmtcl::PerfTrace::FrameCapture   perf_capture ("fmtc_transfer");
 
 	const auto     pa { build_mat_proc (vi, dst_sptr, _vi_src, src_sptr) };
 	_model_uptr->process_frame (pa);
@@ -288,6 +291,11 @@ Transfer::Transfer (::IScriptEnvironment &env, const ::AVSValue &args)
 		}
 	}
 
+	if (supports_props ())
+	{
+		export_perf_capture (perf_capture, dst_sptr, *env_ptr);
+	}
+
 	return dst_sptr;
 }
 
@@ -26,6 +26,7 @@ http://www.wtfpl.net/ for more details.
 #include "avsutl/PlaneProcMode.h"
 #include "fmtcl/ColorFamily.h"
 #include "fmtcl/ColorSpaceH265.h"
+#include "fmtcl/PerfTrace.h"
 #include "fmtcl/PicFmt.h"
 #include "fmtcl/ProcComp3Arg.h"
 #include "fmtcl/SplFmt.h"
@@ -67,6 +68,7 @@ fmtcl::SplFmt conv_bitdepth_to_splfmt (int bitdepth);
 fmtcl::ColorFamily	conv_vi_to_colfam (const ::VideoInfo &vi);
 fmtcl::ColorFamily	conv_str_to_colfam (std::string str);
 void	prepare_matrix_coef (::IScriptEnvironment &env, fmtcl::MatrixProc &mat_proc, const fmtcl::Mat4 &mat_main, const FmtAvs &fmt_dst, bool full_range_dst_flag, const FmtAvs &fmt_src, bool full_range_src_flag, fmtcl::ColorSpaceH265 csp_out, int plane_out);
+void	check_matrix_coef_err (::IScriptEnvironment &env, int ret_val);
 fmtcl::ProcComp3Arg build_mat_proc (const ::VideoInfo &vi_dst, const ::PVideoFrame &dst_sptr, const ::VideoInfo &vi_src, const ::PVideoFrame &src_sptr, bool single_plane_flag = false);
 bool is_array_defined (const ::AVSValue &arg);
 std::vector <double> extract_array_f (::IScriptEnvironment &env, const ::AVSValue &arg, const char *filter_and_arg_0, double def_val = 0);
@@ -74,6 +76,7 @@ std::vector <int> extract_array_i (::IScriptEnvironment &env, const ::AVSValue &
 std::vector <bool> extract_array_b (::IScriptEnvironment &env, const ::AVSValue &arg, const char *filter_and_arg_0, bool def_val = false);
 std::vector <std::string> extract_array_s (::IScriptEnvironment &env, const ::AVSValue &arg, const char *filter_and_arg_0, std::string def_val = "");
 void set_masktools_planes_param (avsutl::PlaneProcessor &pp, ::IScriptEnvironment &env, const ::AVSValue &arg, const char *filter_and_arg_0, double def_val = double (avsutl::PlaneProcMode_PROCESS));
+void export_perf_capture (fmtcl::PerfTrace::FrameCapture &capture, ::PVideoFrame &dst_sptr, ::IScriptEnvironment &env);
 
 
 
@@ -228,6 +228,14 @@ void	prepare_matrix_coef (::IScriptEnvironment &env, fmtcl::MatrixProc &mat_proc
 		mat_proc, mat_main, fmt_dst_fmtcl, fmt_src_fmtcl, csp_out, plane_out
 	);
 
+	check_matrix_coef_err (env, ret_val);
+}
+
+
+
+// ret_val is a fmtcl::MatrixProc::Err code
+void	check_matrix_coef_err (::IScriptEnvironment &env, int ret_val)
+{
 	if (ret_val != fmtcl::MatrixProc::Err_OK)
 	{
 		if (ret_val == fmtcl::MatrixProc::Err_POSSIBLE_OVERFLOW)
@@ -364,6 +372,44 @@ void	set_masktools_planes_param (avsutl::PlaneProcessor &pp, ::IScriptEnvironmen
 
 
 
+
+// Stops the capture and appends the recorded stages to the frame properties.
+// The host must support frame properties. Properties are inherited from the
+// source frame, so each fmtconv filter of a chain adds its own entries to
+// the arrays: FmtcPerfStage (data), FmtcPerfSimd (data), FmtcPerfNs and
+// FmtcPerfPix.
+void	export_perf_capture (fmtcl::PerfTrace::FrameCapture &capture, ::PVideoFrame &dst_sptr, ::IScriptEnvironment &env)
+{
+	if (! capture.is_active ())
+	{
+		return;
+	}
+
+	capture.stop ();
+
+	::AVSMap *     props_ptr = env.getFramePropsRW (dst_sptr);
+	for (const auto &entry : capture.get_entries ())
+	{
+		env.propSetData (
+			props_ptr, "FmtcPerfStage",
+			entry._name_0, -1, ::PROPAPPENDMODE_APPEND
+		);
+		env.propSetData (
+			props_ptr, "FmtcPerfSimd",
+			fmtcl::PerfTrace::get_simd_name (entry._simd), -1,
+			::PROPAPPENDMODE_APPEND
+		);
+		env.propSetInt (
+			props_ptr, "FmtcPerfNs" , entry._dur_ns , ::PROPAPPENDMODE_APPEND
+		);
+		env.propSetInt (
+			props_ptr, "FmtcPerfPix", entry._nbr_pix, ::PROPAPPENDMODE_APPEND
+		);
+	}
+}
+
+
+
 }  // namespace fmtcavs
 
 
@@ -54,9 +54,11 @@ namespace fmtcl
 
 
 
-BitBltConv::BitBltConv (bool sse2_flag, bool avx2_flag)
+BitBltConv::BitBltConv (bool sse2_flag, bool avx2_flag, bool avx512_flag)
 :	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx512_flag)
+,	_fp16_conv (sse2_flag, avx2_flag)
 {
 	// Nothing
 }
@@ -92,11 +94,29 @@ void	BitBltConv::bitblt (SplFmt dst_fmt, int dst_res, uint8_t *dst_ptr, ptrdiff_
 		);
 	}
 
+	// Half-float on any side, processed as float
+	else if (src_fmt == SplFmt_FLOAT16 || dst_fmt == SplFmt_FLOAT16)
+	{
+		bitblt_fp16 (
+			dst_fmt, dst_res, dst_ptr, dst_stride,
+			src_fmt, src_res, src_ptr, src_stride,
+			w, h, scale_info_ptr
+		);
+	}
+
 	// Int to float
 	else if (src_fmt != SplFmt_FLOAT && dst_fmt == SplFmt_FLOAT)
 	{
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-		if (_avx2_flag)
+		if (_avx512_flag)
+		{
+			bitblt_int_to_flt_avx512_switch (
+				                  dst_ptr, dst_stride,
+				src_fmt, src_res, src_ptr, src_stride,
+				w, h, scale_info_ptr
+			);
+		}
+		else if (_avx2_flag)
 		{
 			bitblt_int_to_flt_avx2_switch (
 				                  dst_ptr, dst_stride,
@@ -119,7 +139,15 @@ void	BitBltConv::bitblt (SplFmt dst_fmt, int dst_res, uint8_t *dst_ptr, ptrdiff_
 	else if (src_fmt == SplFmt_FLOAT && dst_fmt != SplFmt_FLOAT && dst_res == 16)
 	{
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-		if (_avx2_flag)
+		if (_avx512_flag)
+		{
+			bitblt_flt_to_int_avx512_switch (
+				dst_fmt, dst_res, dst_ptr, dst_stride,
+				                  src_ptr, src_stride,
+				w, h, scale_info_ptr
+			);
+		}
+		else if (_avx2_flag)
 		{
 			bitblt_flt_to_int_avx2_switch (
 				dst_fmt, dst_res, dst_ptr, dst_stride,
@@ -348,6 +376,86 @@ void	BitBltConv::bitblt_int_to_int (fmtcl::SplFmt dst_fmt, int dst_res, uint8_t
 
 
 
+// Processes line by line. The half-float lines are converted from or to a
+// temporary float line, and the conversion itself is done with the float
+// functions. The temporary lines are padded because the SIMD functions
+// read and write full vectors.
+void	BitBltConv::bitblt_fp16 (fmtcl::SplFmt dst_fmt, int dst_res, uint8_t *dst_ptr, ptrdiff_t dst_stride, fmtcl::SplFmt src_fmt, int src_res, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
+{
+	const bool     src_fp16_flag = (src_fmt == SplFmt_FLOAT16);
+	const bool     dst_fp16_flag = (dst_fmt == SplFmt_FLOAT16);
+	assert (src_fp16_flag || dst_fp16_flag);
+
+	const int      w_pad   = (w + 15) & ~15;
+	Fp16Conv::BufFlt  buf_src (src_fp16_flag ? w_pad : 0);
+	Fp16Conv::BufFlt  buf_dst (dst_fp16_flag ? w_pad : 0);
+	const SplFmt   src_fmt_flt = src_fp16_flag ? SplFmt_FLOAT : src_fmt;
+	const SplFmt   dst_fmt_flt = dst_fp16_flag ? SplFmt_FLOAT : dst_fmt;
+	const int      src_res_flt = src_fp16_flag ? 32 : src_res;
+	const int      dst_res_flt = dst_fp16_flag ? 32 : dst_res;
+	const bool     flt_flag    =
+		(src_fmt_flt == SplFmt_FLOAT && dst_fmt_flt == SplFmt_FLOAT);
+	const bool     neutral_flag = is_si_neutral (scale_info_ptr);
+	const float    gain    =
+		neutral_flag ? 1.f : float (scale_info_ptr->_gain);
+	const float    add_cst =
+		neutral_flag ? 0.f : float (scale_info_ptr->_add_cst);
+
+	for (int y = 0; y < h; ++y)
+	{
+		const uint8_t *  src_line_ptr = src_ptr;
+		if (src_fp16_flag)
+		{
+			_fp16_conv.conv_to_flt (
+				buf_src.data (), reinterpret_cast <const uint16_t *> (src_ptr), w
+			);
+			src_line_ptr = reinterpret_cast <const uint8_t *> (buf_src.data ());
+		}
+
+		uint8_t *      dst_line_ptr =
+			  dst_fp16_flag
+			? reinterpret_cast <uint8_t *> (buf_dst.data ())
+			: dst_ptr;
+
+		if (flt_flag)
+		{
+			const float *  s_ptr = reinterpret_cast <const float *> (src_line_ptr);
+			float *        d_ptr = reinterpret_cast <float *> (dst_line_ptr);
+			if (neutral_flag)
+			{
+				memcpy (d_ptr, s_ptr, w * sizeof (*d_ptr));
+			}
+			else
+			{
+				for (int x = 0; x < w; ++x)
+				{
+					d_ptr [x] = s_ptr [x] * gain + add_cst;
+				}
+			}
+		}
+		else
+		{
+			bitblt (
+				dst_fmt_flt, dst_res_flt, dst_line_ptr, 0,
+				src_fmt_flt, src_res_flt, src_line_ptr, 0,
+				w, 1, scale_info_ptr
+			);
+		}
+
+		if (dst_fp16_flag)
+		{
+			_fp16_conv.conv_to_fp16 (
+				reinterpret_cast <uint16_t *> (dst_ptr), buf_dst.data (), w
+			);
+		}
+
+		src_ptr += src_stride;
+		dst_ptr += dst_stride;
+	}
+}
+
+
+
 void	BitBltConv::bitblt_same_fmt (SplFmt fmt, uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h)
 {
 	assert (fmt >= 0);
@@ -0,0 +1,260 @@
+/*****************************************************************************
+
+        BitBltConv_avx512.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX512 (AVX-512F and AVX-512BW) in order to avoid
+SSE/AVX state switch slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/BitBltConv.h"
+#include "fmtcl/ProxyRwAvx512.h"
+#include "fstb/fnc.h"
+
+#include <stdexcept>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	BitBltConv::bitblt_int_to_flt_avx512_switch (uint8_t *dst_ptr, ptrdiff_t dst_stride, fmtcl::SplFmt src_fmt, int src_res, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
+{
+	const uint8_t *                    src_i08_ptr (src_ptr);
+	const Proxy::PtrInt16Const::Type   src_i16_ptr (
+		reinterpret_cast <const uint16_t *> (src_ptr)
+	);
+
+	const bool     scale_flag = ! is_si_neutral (scale_info_ptr);
+
+#define	fmtcl_BitBltConv_CASE(SCF, SFMT, SRES, SPTR) \
+	case	((SCF << 16) + (SplFmt_##SFMT << 8) + SRES): \
+		bitblt_int_to_flt_avx512 <SCF, ProxyRwAvx512 <SplFmt_##SFMT> > ( \
+			dst_ptr, dst_stride, src_##SPTR##_ptr, src_stride, \
+			w, h, scale_info_ptr \
+		); \
+		break;
+
+	switch ((scale_flag << 16) + (src_fmt << 8) + src_res)
+	{
+	fmtcl_BitBltConv_CASE (false, INT16  , 16, i16)
+	fmtcl_BitBltConv_CASE (false, INT16  , 14, i16)
+	fmtcl_BitBltConv_CASE (false, INT16  , 12, i16)
+	fmtcl_BitBltConv_CASE (false, INT16  , 10, i16)
+	fmtcl_BitBltConv_CASE (false, INT16  ,  9, i16)
+	fmtcl_BitBltConv_CASE (false, INT8   ,  8, i08)
+	fmtcl_BitBltConv_CASE (true , INT16  , 16, i16)
+	fmtcl_BitBltConv_CASE (true , INT16  , 14, i16)
+	fmtcl_BitBltConv_CASE (true , INT16  , 12, i16)
+	fmtcl_BitBltConv_CASE (true , INT16  , 10, i16)
+	fmtcl_BitBltConv_CASE (true , INT16  ,  9, i16)
+	fmtcl_BitBltConv_CASE (true , INT8   ,  8, i08)
+	default:
+		assert (false);
+		throw std::logic_error (
+			"fmtcl::BitBltConv::bitblt: "
+			"illegal int-to-float pixel format conversion."
+		);
+	}
+
+#undef fmtcl_BitBltConv_CASE
+}
+
+
+
+void	BitBltConv::bitblt_flt_to_int_avx512_switch (fmtcl::SplFmt dst_fmt, int dst_res, uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
+{
+	fstb::unused (dst_res);
+
+	const Proxy::PtrInt16::Type   dst_i16_ptr (
+		reinterpret_cast <uint16_t *> (dst_ptr)
+	);
+
+	const bool     scale_flag = ! is_si_neutral (scale_info_ptr);
+
+#define	fmtcl_BitBltConv_CASE(SCF, DFMT, DPTR) \
+	case	(SCF << 4) + SplFmt_##DFMT: \
+		bitblt_flt_to_int_avx512 <SCF, ProxyRwAvx512 <SplFmt_##DFMT> > ( \
+			dst_##DPTR##_ptr, dst_stride, src_ptr, src_stride, \
+			w, h, scale_info_ptr \
+		); \
+		break;
+
+	switch ((scale_flag << 4) + dst_fmt)
+	{
+	fmtcl_BitBltConv_CASE (false, INT16  , i16)
+	fmtcl_BitBltConv_CASE (true , INT16  , i16)
+	default:
+		assert (false);
+		throw std::logic_error (
+			"fmtcl::BitBltConv::bitblt: "
+			"illegal float-to-int pixel format conversion."
+		);
+	}
+
+#undef fmtcl_BitBltConv_CASE
+}
+
+
+
+// Stride offsets are still in bytes
+// The end of the lines is processed with masked loads and stores, so
+// nothing is written beyond the width.
+template <bool SF, class SRC>
+void	BitBltConv::bitblt_int_to_flt_avx512 (uint8_t *dst_ptr, ptrdiff_t dst_stride, typename SRC::PtrConst::Type src_ptr, ptrdiff_t src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
+{
+	assert (dst_ptr != nullptr);
+	assert (SRC::PtrConst::check_ptr (src_ptr));
+	assert (w > 0);
+	assert (h > 0);
+	assert (! SF || scale_info_ptr != nullptr);
+
+	__m512         gain;
+	__m512         add_cst;
+	if (SF)
+	{
+		gain    = _mm512_set1_ps (float (scale_info_ptr->_gain   ));
+		add_cst = _mm512_set1_ps (float (scale_info_ptr->_add_cst));
+	}
+
+	float *        dst_flt_ptr = reinterpret_cast <float *> (dst_ptr);
+
+	src_stride /= sizeof (typename SRC::PtrConst::DataType);
+	dst_stride /= sizeof (*dst_flt_ptr);
+
+	const int      w16    = w & -16;
+	const int      w15    = w - w16;
+	const __mmask16   m_full = ProxyRwAvx512Mask::make_16 (16);
+	const __mmask16   m_last = ProxyRwAvx512Mask::make_16 (w15);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w16; x += 16)
+		{
+			__m512         val = SRC::read_flt (src_ptr + x, m_full);
+			if (SF)
+			{
+				val = _mm512_add_ps (_mm512_mul_ps (val, gain), add_cst);
+			}
+			_mm512_storeu_ps (dst_flt_ptr + x, val);
+		}
+
+		if (w15 > 0)
+		{
+			__m512         val = SRC::read_flt (src_ptr + w16, m_last);
+			if (SF)
+			{
+				val = _mm512_add_ps (_mm512_mul_ps (val, gain), add_cst);
+			}
+			_mm512_mask_storeu_ps (dst_flt_ptr + w16, m_last, val);
+		}
+
+		SRC::PtrConst::jump (src_ptr, src_stride);
+		dst_flt_ptr += dst_stride;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+// Stride offsets are still in bytes
+template <bool SF, class DST>
+void	BitBltConv::bitblt_flt_to_int_avx512 (typename DST::Ptr::Type dst_ptr, ptrdiff_t dst_stride, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, const ScaleInfo *scale_info_ptr)
+{
+	assert (DST::Ptr::check_ptr (dst_ptr));
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (h > 0);
+	assert (! SF || scale_info_ptr != nullptr);
+
+	__m512         gain;
+	__m512         add_cst;
+	if (SF)
+	{
+		gain    = _mm512_set1_ps (float (scale_info_ptr->_gain   ));
+		add_cst = _mm512_set1_ps (float (scale_info_ptr->_add_cst));
+	}
+
+	const float *  src_flt_ptr = reinterpret_cast <const float *> (src_ptr);
+
+	src_stride /= sizeof (*src_flt_ptr);
+	dst_stride /= sizeof (typename DST::Ptr::DataType);
+
+	const int      w16    = w & -16;
+	const int      w15    = w - w16;
+	const __mmask16   m_full = ProxyRwAvx512Mask::make_16 (16);
+	const __mmask16   m_last = ProxyRwAvx512Mask::make_16 (w15);
+
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w16; x += 16)
+		{
+			__m512         val = _mm512_loadu_ps (src_flt_ptr + x);
+			if (SF)
+			{
+				val = _mm512_add_ps (_mm512_mul_ps (val, gain), add_cst);
+			}
+			DST::write_flt (dst_ptr + x, val, m_full);
+		}
+
+		if (w15 > 0)
+		{
+			__m512         val = _mm512_maskz_loadu_ps (m_last, src_flt_ptr + w16);
+			if (SF)
+			{
+				val = _mm512_add_ps (_mm512_mul_ps (val, gain), add_cst);
+			}
+			DST::write_flt (dst_ptr + w16, val, m_last);
+		}
+
+		src_flt_ptr += src_stride;
+		DST::Ptr::jump (dst_ptr, dst_stride);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,756 @@
+/*****************************************************************************
+
+        ConvertProc.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ColorSpaceH265.h"
+#include "fmtcl/ConvertProc.h"
+#include "fmtcl/fnc.h"
+#include "fmtcl/PrimUtil.h"
+#include "fmtcl/ResampleUtil.h"
+#include "fmtcl/RgbSystem.h"
+#include "fmtcl/TransOpLogC.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+ConvertProc::ConvertProc (Param &&param, bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag)
+:	_sse_flag (sse_flag)
+,	_sse2_flag (sse2_flag)
+,	_avx_flag (avx_flag)
+,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_param (std::move (param))
+,	_buf_pool ()
+{
+	check_param ();
+
+	const ColorFamily cf_s = _param._src._fmt._col_fam;
+	const ColorFamily cf_d = _param._dst._fmt._col_fam;
+	const bool     gray_s_flag = (cf_s == ColorFamily_GRAY);
+	const bool     gray_d_flag = (cf_d == ColorFamily_GRAY);
+
+	_nbr_planes_s = (gray_s_flag) ? 1 : _max_nbr_planes;
+	_nbr_planes_d = (gray_d_flag) ? 1 : _max_nbr_planes;
+	_nbr_planes_i = (gray_s_flag && gray_d_flag) ? 1 : _max_nbr_planes;
+	_expand_flag  = (gray_s_flag && ! gray_d_flag);
+
+	_fmt_s_flt = PicFmt {
+		SplFmt_FLOAT, 32, (_expand_flag) ? ColorFamily_RGB : cf_s, true
+	};
+	_fmt_d_flt = PicFmt { SplFmt_FLOAT, 32, cf_d, true };
+	_fmt_lin   = PicFmt {
+		SplFmt_FLOAT, 32,
+		(_nbr_planes_i == 1) ? ColorFamily_GRAY : ColorFamily_RGB,
+		true
+	};
+
+	build_pointwise ();
+
+	// A gray destination from a color source with nothing to convert is
+	// just the source luma.
+	const bool     stage_flag = (
+		   _mat_s_uptr.get ()   != nullptr
+		|| _cl_s_uptr.get ()    != nullptr
+		|| _trans_s_uptr.get () != nullptr
+		|| _prim_uptr.get ()    != nullptr
+		|| _trans_d_uptr.get () != nullptr
+		|| _mat_d_uptr.get ()   != nullptr
+		|| _cl_d_uptr.get ()    != nullptr
+	);
+	_direct_flag = (
+		   ! stage_flag
+		&& ! _expand_flag
+		&& (cf_s == cf_d || gray_d_flag)
+	);
+
+	build_resizers ();
+	build_dither ();
+
+	const Side &   d     = _param._dst;
+	const bool     sub_flag = (
+		   ! _direct_flag
+		&& _rsz_out_arr [InterlacingType_FRAME] [1].get () != nullptr
+	);
+	const int      w_sub = (sub_flag) ? d._w >> d._ss_h : 0;
+	const int      h_sub = (sub_flag) ? d._h >> d._ss_v : 0;
+	_buf_factory_uptr = std::make_unique <WorkBufFactory> (
+		d._w, d._h, (_direct_flag) ? _nbr_planes_d : _nbr_planes_i,
+		w_sub, h_sub
+	);
+	_buf_pool.set_factory (*_buf_factory_uptr);
+}
+
+
+
+void	ConvertProc::process_frame (const Frame <> &dst, const FrameRO <> &src, int frame_index, InterlacingType itl)
+{
+	assert (dst.is_valid (_nbr_planes_d));
+	assert (src.is_valid (_nbr_planes_s));
+	assert (itl >= 0);
+	assert (itl < InterlacingType_NBR_ELT);
+	assert (itl == InterlacingType_FRAME || _param._itl_flag);
+
+	WorkBuf *      buf_ptr = _buf_pool.take_obj ();
+	if (buf_ptr == nullptr)
+	{
+		throw std::runtime_error (
+			"cannot allocate memory for temporary buffer."
+		);
+	}
+
+	try
+	{
+		process_buf (*buf_ptr, dst, src, frame_index, itl);
+	}
+	catch (...)
+	{
+		_buf_pool.return_obj (*buf_ptr);
+		throw;
+	}
+
+	_buf_pool.return_obj (*buf_ptr);
+	buf_ptr = nullptr;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+constexpr int	ConvertProc::_max_nbr_planes;
+constexpr int	ConvertProc::_stripe_size;
+
+
+
+void	ConvertProc::check_param () const
+{
+	const Side &   s = _param._src;
+	const Side &   d = _param._dst;
+
+	assert (s._fmt.is_valid ());
+	assert (s._w > 0);
+	assert (s._h > 0);
+	assert (s._ss_h >= 0);
+	assert (s._ss_v >= 0);
+	assert (d._fmt.is_valid ());
+	assert (d._w > 0);
+	assert (d._h > 0);
+	assert (d._ss_h >= 0);
+	assert (d._ss_v >= 0);
+	assert ((d._w & ((1 << d._ss_h) - 1)) == 0);
+	assert ((d._h & ((1 << d._ss_v) - 1)) == 0);
+	assert (_param._contrast > 0);
+	assert (s._gcor > 0);
+	assert (d._gcor > 0);
+
+	const bool     yuv_s_flag = (s._fmt._col_fam == ColorFamily_YUV);
+	const bool     yuv_d_flag = (d._fmt._col_fam == ColorFamily_YUV);
+	const bool     luma_d_flag = (
+		   d._fmt._col_fam == ColorFamily_GRAY
+		&& s._fmt._col_fam != ColorFamily_GRAY
+	);
+	const bool     cl_s_flag = (yuv_s_flag && s._cl_flag);
+	const bool     cl_d_flag = ((yuv_d_flag || luma_d_flag) && d._cl_flag);
+
+	if (_param._lin_flag)
+	{
+		if (   ! TransCurve_is_valid (s._curve)
+		    || ! TransCurve_is_valid (d._curve))
+		{
+			throw std::invalid_argument (
+				"the transfer curves must be known for a linear conversion."
+			);
+		}
+	}
+	else
+	{
+		if (cl_s_flag != cl_d_flag)
+		{
+			throw std::invalid_argument (
+				"BT.2020 constant luminance can only be converted "
+				"through linear RGB."
+			);
+		}
+		if (   s._prim >= 0
+		    && d._prim >= 0
+		    && s._prim != d._prim)
+		{
+			throw std::invalid_argument (
+				"primaries can only be converted through linear RGB."
+			);
+		}
+	}
+}
+
+
+
+// Non-linear conversion: a single matrix from the source to the destination
+// colorspace.
+// Linear conversion: source -> linear RGB, transfer curves (and primaries),
+// then linear RGB -> destination.
+void	ConvertProc::build_pointwise ()
+{
+	const Side &   s = _param._src;
+	const Side &   d = _param._dst;
+	const bool     yuv_s_flag  = (s._fmt._col_fam == ColorFamily_YUV);
+	const bool     yuv_d_flag  = (d._fmt._col_fam == ColorFamily_YUV);
+
+	// A gray destination is extracted from the luma of the 3 planes
+	const bool     luma_d_flag = (
+		   d._fmt._col_fam == ColorFamily_GRAY
+		&& _nbr_planes_i == _max_nbr_planes
+	);
+	const int      plane_out = (luma_d_flag) ? 0 : -1;
+	const bool     cl_s_flag = (yuv_s_flag && s._cl_flag);
+	const bool     cl_d_flag = ((yuv_d_flag || luma_d_flag) && d._cl_flag);
+
+	if (! _param._lin_flag)
+	{
+		// Both sides in BT.2020 CL: nothing to do
+		Mat4           m (1, Mat4::Preset_DIAGONAL);
+		if ((yuv_d_flag || luma_d_flag) && ! cl_d_flag)
+		{
+			m *= d._mat;
+		}
+		if (yuv_s_flag && ! cl_s_flag)
+		{
+			m *= s._mat;
+		}
+		if (! is_identity (m))
+		{
+			_mat_s_uptr = build_matrix (m, _fmt_d_flt, _fmt_s_flt, plane_out);
+		}
+
+		return;
+	}
+
+	// The constant luminance matrices include the BT.2020 curve
+	TransCurve     curve_s = s._curve;
+	TransCurve     curve_d = d._curve;
+	if (cl_s_flag)
+	{
+		_cl_s_uptr = build_matrix_cl (false);
+		curve_s    = TransCurve_LINEAR;
+	}
+	else if (yuv_s_flag)
+	{
+		_mat_s_uptr = build_matrix (s._mat, _fmt_lin, _fmt_s_flt, -1);
+	}
+	if (cl_d_flag)
+	{
+		curve_d = TransCurve_LINEAR;
+	}
+
+	const double   contrast = _param._contrast;
+	const bool     prim_flag = (
+		   _nbr_planes_i == _max_nbr_planes
+		&& s._prim >= 0
+		&& d._prim >= 0
+		&& s._prim != d._prim
+	);
+	if (prim_flag)
+	{
+		if (curve_s != TransCurve_LINEAR || s._gcor != 1)
+		{
+			_trans_s_uptr = build_trans (
+				TransCurve_LINEAR, curve_s, 1, s._gcor
+			);
+		}
+
+		RgbSystem      prim_s;
+		RgbSystem      prim_d;
+		prim_s.set (s._prim);
+		prim_d.set (d._prim);
+		Mat4           mat_prim;
+		mat_prim.insert3 (PrimUtil::compute_conversion_matrix (
+			prim_s, prim_d, _param._wconv_flag
+		));
+		mat_prim.clean3 (1);
+		_prim_uptr = build_matrix (mat_prim, _fmt_lin, _fmt_lin, -1);
+
+		if (curve_d != TransCurve_LINEAR || contrast != 1 || d._gcor != 1)
+		{
+			_trans_d_uptr = build_trans (
+				curve_d, TransCurve_LINEAR, contrast, 1 / d._gcor
+			);
+		}
+	}
+	else
+	{
+		// The model composes both curves in a single pass
+		const double   gcor = s._gcor / d._gcor;
+		if (curve_s != curve_d || contrast != 1 || gcor != 1)
+		{
+			_trans_s_uptr = build_trans (curve_d, curve_s, contrast, gcor);
+		}
+	}
+
+	if (cl_d_flag)
+	{
+		_cl_d_uptr = build_matrix_cl (true);
+	}
+	else if (yuv_d_flag || luma_d_flag)
+	{
+		_mat_d_uptr = build_matrix (d._mat, _fmt_d_flt, _fmt_lin, plane_out);
+	}
+}
+
+
+
+void	ConvertProc::build_resizers ()
+{
+	const Side &   s = _param._src;
+	const Side &   d = _param._dst;
+	const ColorFamily cf_s = s._fmt._col_fam;
+	const ColorFamily cf_d = d._fmt._col_fam;
+	const int      nbr_itl  = (_param._itl_flag) ? InterlacingType_NBR_ELT : 1;
+
+	// Source -> float, full range. At the final plane size if there is
+	// nothing else to do, otherwise 4:4:4 at the destination size.
+	const PicFmt   fmt_flt { SplFmt_FLOAT, 32, cf_s, true };
+	const int      ss_h_i = (_direct_flag) ? d._ss_h : 0;
+	const int      ss_v_i = (_direct_flag) ? d._ss_v : 0;
+	const int      nbr_planes_rsz = std::min (_nbr_planes_s, _nbr_planes_d);
+	for (int plane_index = 0
+	;	plane_index < ((_direct_flag) ? nbr_planes_rsz : _nbr_planes_s)
+	;	++ plane_index)
+	{
+		ResamplePlaneData &  plane_data = _param._rsz_in [plane_index];
+		auto &         win = plane_data._win;
+		if (win._w <= 0)
+		{
+			win._w = s._w;
+		}
+		if (win._h <= 0)
+		{
+			win._h = s._h;
+		}
+
+		compute_fmt_mac_cst (
+			plane_data._gain, plane_data._add_cst, fmt_flt, s._fmt, plane_index
+		);
+		ResampleUtil::create_plane_specs (
+			plane_data, plane_index,
+			cf_s, s._w, s._ss_h, s._h, s._ss_v, s._cplace,
+			cf_s, d._w, ss_h_i , d._h, ss_v_i , d._cplace
+		);
+		for (int itl = 0; itl < nbr_itl; ++itl)
+		{
+			_rsz_in_arr [itl] [plane_index] = build_resizer (
+				plane_data, InterlacingType (itl), s._fmt._sf, s._fmt._res
+			);
+		}
+	}
+
+	// 4:4:4 -> destination chroma subsampling
+	if (   ! _direct_flag
+	    && has_chroma (cf_d)
+	    && (d._ss_h > 0 || d._ss_v > 0))
+	{
+		for (int plane_index = 1; plane_index < _nbr_planes_d; ++plane_index)
+		{
+			ResamplePlaneData &  plane_data = _param._rsz_out [plane_index];
+			plane_data._win._x  = 0;
+			plane_data._win._y  = 0;
+			plane_data._win._w  = d._w;
+			plane_data._win._h  = d._h;
+			plane_data._gain    = 1;
+			plane_data._add_cst = 0;
+			ResampleUtil::create_plane_specs (
+				plane_data, plane_index,
+				cf_d, d._w, 0      , d._h, 0      , d._cplace,
+				cf_d, d._w, d._ss_h, d._h, d._ss_v, d._cplace
+			);
+			for (int itl = 0; itl < nbr_itl; ++itl)
+			{
+				_rsz_out_arr [itl] [plane_index] = build_resizer (
+					plane_data, InterlacingType (itl), SplFmt_FLOAT, 32
+				);
+			}
+		}
+	}
+}
+
+
+
+void	ConvertProc::build_dither ()
+{
+	const Side &   d = _param._dst;
+
+	_dither_uptr = std::make_unique <Dither> (
+		SplFmt_FLOAT, 32, true,
+		d._fmt._sf, d._fmt._res, d._fmt._full_flag,
+		d._fmt._col_fam, _nbr_planes_d, d._w,
+		_param._dmode, _param._pat_size, _param._ampo, _param._ampn,
+		_param._dyn_flag, _param._static_noise_flag,
+		_param._correlated_planes_flag,
+		_param._tpdfo_flag, _param._tpdfn_flag,
+		_sse2_flag, _avx2_flag
+	);
+
+	// The planes are dithered together when they have the same size
+	_dither_3p_flag = (
+		   _nbr_planes_d == _max_nbr_planes
+		&& (   d._fmt._col_fam == ColorFamily_RGB
+		    || (d._ss_h == 0 && d._ss_v == 0))
+		&& _dither_uptr->can_process_3_planes ()
+	);
+}
+
+
+
+// The source and destination of the filter share the same interlacing
+ConvertProc::ResizeUPtr	ConvertProc::build_resizer (const ResamplePlaneData &plane_data, InterlacingType itl, SplFmt src_fmt, int src_res) const
+{
+	const auto &   kernel_h = plane_data._kernel_arr [FilterResize::Dir_H];
+	const auto &   kernel_v = plane_data._kernel_arr [FilterResize::Dir_V];
+	assert (kernel_h._k_uptr.get () != nullptr);
+	assert (kernel_v._k_uptr.get () != nullptr);
+
+	return std::make_unique <FilterResize> (
+		plane_data._spec_arr [itl] [itl],
+		*(kernel_h._k_uptr), *(kernel_v._k_uptr),
+		_param._norm_flag, plane_data._norm_val_h, plane_data._norm_val_v,
+		plane_data._gain,
+		src_fmt, src_res, SplFmt_FLOAT, 32,
+		false, _sse2_flag, _avx2_flag, _avx512_flag
+	);
+}
+
+
+
+std::unique_ptr <MatrixProc>	ConvertProc::build_matrix (const Mat4 &mat, const PicFmt &fmt_dst, const PicFmt &fmt_src, int plane_out) const
+{
+	auto           proc_uptr = std::make_unique <MatrixProc> (
+		_sse_flag, _sse2_flag, _avx_flag, _avx2_flag, _avx512_flag
+	);
+
+	const int      ret_val = prepare_matrix_coef (
+		*proc_uptr, mat, fmt_dst, fmt_src,
+		ColorSpaceH265_UNSPECIFIED, plane_out
+	);
+	if (ret_val != MatrixProc::Err_OK)
+	{
+		throw std::invalid_argument ("cannot build the conversion matrix.");
+	}
+
+	return proc_uptr;
+}
+
+
+
+// Between full-range float BT.2020 CL and linear RGB
+std::unique_ptr <Matrix2020CLProc>	ConvertProc::build_matrix_cl (bool to_yuv_flag) const
+{
+	auto           proc_uptr = std::make_unique <Matrix2020CLProc> (
+		_sse2_flag, _avx2_flag, _avx512_flag
+	);
+
+	const auto     ret_val = proc_uptr->configure (
+		to_yuv_flag, SplFmt_FLOAT, 32, SplFmt_FLOAT, 32, true
+	);
+	if (ret_val != Matrix2020CLProc::Err_OK)
+	{
+		throw std::invalid_argument (
+			"cannot build the BT.2020 constant luminance matrix."
+		);
+	}
+
+	return proc_uptr;
+}
+
+
+
+// Default luminance and sigmoid parameters from fmtc.transfer
+std::unique_ptr <TransModel>	ConvertProc::build_trans (TransCurve curve_d, TransCurve curve_s, double contrast, double gcor) const
+{
+	const auto     logc_ei = TransOpLogC::ExpIdx_800;
+
+	return std::make_unique <TransModel> (
+		_fmt_lin, curve_d, logc_ei,
+		_fmt_lin, curve_s, logc_ei,
+		contrast, gcor, 0, 0, 0, 5, false, LumMatch_REF_WHITE,
+		TransModel::GyProc::UNDEF, 6.5, 0.5, false,
+		_sse2_flag, _avx2_flag, _avx512_flag
+	);
+}
+
+
+
+void	ConvertProc::process_buf (WorkBuf &buf, const Frame <> &dst, const FrameRO <> &src, int frame_index, InterlacingType itl)
+{
+	const Side &   s = _param._src;
+	const Side &   d = _param._dst;
+	const int      nbr_planes_rsz = (_direct_flag)
+		? std::min (_nbr_planes_s, _nbr_planes_d)
+		: _nbr_planes_s;
+
+	// Source -> float
+	for (int plane_index = 0; plane_index < nbr_planes_rsz; ++plane_index)
+	{
+		_rsz_in_arr [itl] [plane_index]->process_plane (
+			reinterpret_cast <uint8_t *> (buf._plane_arr [plane_index].data ()),
+			src [plane_index]._ptr,
+			buf._stride,
+			src [plane_index]._stride,
+			is_chroma_plane (s._fmt._col_fam, plane_index)
+		);
+	}
+
+	if (! _direct_flag)
+	{
+		if (_expand_flag)
+		{
+			const size_t   len = buf._plane_arr [0].size ();
+			for (int plane_index = 1; plane_index < _nbr_planes_i; ++plane_index)
+			{
+				memcpy (
+					buf._plane_arr [plane_index].data (),
+					buf._plane_arr [0].data (),
+					len * sizeof (float)
+				);
+			}
+		}
+
+		process_pointwise (buf);
+	}
+
+	// Chroma subsampling and bitdepth conversion
+	if (_dither_3p_flag)
+	{
+		ProcComp3Arg   pa;
+		pa._w = d._w;
+		pa._h = d._h;
+		pa._dst = dst;
+		for (int plane_index = 0; plane_index < _nbr_planes_d; ++plane_index)
+		{
+			pa._src [plane_index]._ptr = reinterpret_cast <const uint8_t *> (
+				buf._plane_arr [plane_index].data ()
+			);
+			pa._src [plane_index]._stride = buf._stride;
+		}
+		_dither_uptr->process_3_planes (pa, frame_index);
+		return;
+	}
+
+	for (int plane_index = 0; plane_index < _nbr_planes_d; ++plane_index)
+	{
+		const uint8_t* src_ptr = reinterpret_cast <const uint8_t *> (
+			buf._plane_arr [plane_index].data ()
+		);
+		ptrdiff_t      stride_src = buf._stride;
+		const auto     rsz_ptr = _rsz_out_arr [itl] [plane_index].get ();
+		if (rsz_ptr != nullptr)
+		{
+			uint8_t *      sub_ptr = reinterpret_cast <uint8_t *> (buf._sub.data ());
+			rsz_ptr->process_plane (
+				sub_ptr, src_ptr, buf._stride_sub, stride_src, true
+			);
+			src_ptr    = sub_ptr;
+			stride_src = buf._stride_sub;
+		}
+
+		const ColorFamily cf_d = d._fmt._col_fam;
+		_dither_uptr->process_plane (
+			dst [plane_index]._ptr, dst [plane_index]._stride,
+			src_ptr, stride_src,
+			compute_plane_width (cf_d, d._ss_h, d._w, plane_index),
+			compute_plane_height (cf_d, d._ss_v, d._h, plane_index),
+			frame_index, plane_index
+		);
+	}
+}
+
+
+
+// Runs the point-wise stages in place, on horizontal stripes small enough
+// to stay in the cache from one stage to the next.
+void	ConvertProc::process_pointwise (WorkBuf &buf) const noexcept
+{
+	const int      w = _param._dst._w;
+	const int      h = _param._dst._h;
+	const int      stripe_h = std::max (
+		int (_stripe_size / (buf._stride * _nbr_planes_i)), 1
+	);
+
+	ProcComp3Arg   pa;
+	pa._w = w;
+	for (int y = 0; y < h; y += stripe_h)
+	{
+		pa._h = std::min (h - y, stripe_h);
+		for (int plane_index = 0; plane_index < _nbr_planes_i; ++plane_index)
+		{
+			uint8_t *      ptr =
+				  reinterpret_cast <uint8_t *> (buf._plane_arr [plane_index].data ())
+				+ y * buf._stride;
+			pa._dst [plane_index]._ptr    = ptr;
+			pa._dst [plane_index]._stride = buf._stride;
+			pa._src [plane_index]._ptr    = ptr;
+			pa._src [plane_index]._stride = buf._stride;
+		}
+
+		process_stages (pa);
+	}
+}
+
+
+
+// Point-wise stages, in place
+void	ConvertProc::process_stages (const ProcComp3Arg &pa) const noexcept
+{
+	if (_mat_s_uptr.get () != nullptr)
+	{
+		_mat_s_uptr->process_chunk (pa);
+	}
+	if (_cl_s_uptr.get () != nullptr)
+	{
+		_cl_s_uptr->process (pa);
+	}
+	if (_trans_s_uptr.get () != nullptr)
+	{
+		_trans_s_uptr->process_frame (pa);
+	}
+	if (_prim_uptr.get () != nullptr)
+	{
+		_prim_uptr->process_chunk (pa);
+	}
+	if (_trans_d_uptr.get () != nullptr)
+	{
+		_trans_d_uptr->process_frame (pa);
+	}
+	if (_mat_d_uptr.get () != nullptr)
+	{
+		_mat_d_uptr->process_chunk (pa);
+	}
+	if (_cl_d_uptr.get () != nullptr)
+	{
+		_cl_d_uptr->process (pa);
+	}
+}
+
+
+
+// Checks the 3x4 part only. The composed matrices are exact up to the
+// rounding errors.
+bool	ConvertProc::is_identity (const Mat4 &m) noexcept
+{
+	constexpr double  eps = 1e-9;
+
+	for (int y = 0; y < _max_nbr_planes; ++y)
+	{
+		for (int x = 0; x < Mat4::VECT_SIZE; ++x)
+		{
+			const double   ref = (x == y) ? 1 : 0;
+			if (fabs (m [y] [x] - ref) > eps)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+
+ConvertProc::WorkBuf::WorkBuf (int w, int h, int nbr_planes, int w_sub, int h_sub)
+{
+	assert (w > 0);
+	assert (h > 0);
+	assert (nbr_planes > 0);
+	assert (nbr_planes <= _max_nbr_planes);
+	assert (w_sub >= 0);
+	assert (h_sub >= 0);
+
+	// Rows are padded to multiples of 64 bytes for the SIMD code
+	const int      stride_flt     = (w     + 15) & ~15;
+	const int      stride_flt_sub = (w_sub + 15) & ~15;
+	_stride     = stride_flt     * ptrdiff_t (sizeof (float));
+	_stride_sub = stride_flt_sub * ptrdiff_t (sizeof (float));
+
+	for (int plane_index = 0; plane_index < nbr_planes; ++plane_index)
+	{
+		_plane_arr [plane_index].resize (size_t (stride_flt) * size_t (h));
+	}
+	_sub.resize (size_t (stride_flt_sub) * size_t (h_sub));
+}
+
+
+
+ConvertProc::WorkBufFactory::WorkBufFactory (int w, int h, int nbr_planes, int w_sub, int h_sub)
+:	_w (w)
+,	_h (h)
+,	_nbr_planes (nbr_planes)
+,	_w_sub (w_sub)
+,	_h_sub (h_sub)
+{
+	assert (w > 0);
+	assert (h > 0);
+}
+
+
+
+ConvertProc::WorkBuf *	ConvertProc::WorkBufFactory::do_create ()
+{
+	WorkBuf *      buf_ptr = nullptr;
+	try
+	{
+		buf_ptr = new WorkBuf (_w, _h, _nbr_planes, _w_sub, _h_sub);
+	}
+	catch (...)
+	{
+		buf_ptr = nullptr;
+	}
+
+	return buf_ptr;
+}
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
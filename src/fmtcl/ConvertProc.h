@@ -0,0 +1,294 @@
+/*****************************************************************************
+
+        ConvertProc.h
+        Author: Laurent de Soras, 2024
+
+Complete format conversion in a single pass: resampling, matrix, transfer
+curves, primaries and bitdepth. The planes are first resampled to the
+destination size in 4:4:4 floating point, full range. The point-wise stages
+then run in place on horizontal stripes small enough to keep the data in
+the cache from one stage to the next. Finally the chroma planes are
+subsampled and everything is converted to the destination bitdepth.
+
+When there is no point-wise stage, each plane is resampled directly to its
+final size, without the 4:4:4 intermediate.
+
+The intermediate planes are pooled, so concurrent calls don't allocate
+memory once the pool is warm.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_ConvertProc_HEADER_INCLUDED)
+#define fmtcl_ConvertProc_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "conc/ObjFactoryInterface.h"
+#include "conc/ObjPool.h"
+#include "fmtcl/ChromaPlacement.h"
+#include "fmtcl/Dither.h"
+#include "fmtcl/FilterResize.h"
+#include "fmtcl/Frame.h"
+#include "fmtcl/FrameRO.h"
+#include "fmtcl/InterlacingType.h"
+#include "fmtcl/Mat4.h"
+#include "fmtcl/Matrix2020CLProc.h"
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/PicFmt.h"
+#include "fmtcl/PrimariesPreset.h"
+#include "fmtcl/ProcComp3Arg.h"
+#include "fmtcl/ResamplePlaneData.h"
+#include "fmtcl/TransCurve.h"
+#include "fmtcl/TransModel.h"
+#include "fstb/AllocAlign.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+
+
+namespace fmtcl
+{
+
+
+
+class ConvertProc
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static constexpr int _max_nbr_planes = ProcComp3Arg::_nbr_planes;
+
+	typedef std::array <ResamplePlaneData, _max_nbr_planes> PlaneDataArray;
+
+	// Format and colorimetry of one end of the chain
+	class Side
+	{
+	public:
+		PicFmt         _fmt;          // _full_flag is the nominal range of the clip
+		int            _w      = 0;   // Luma size, in pixels
+		int            _h      = 0;
+		int            _ss_h   = 0;   // Log2 of the chroma subsampling
+		int            _ss_v   = 0;
+		ChromaPlacement
+		               _cplace = ChromaPlacement_MPEG2;
+
+		// YUV to RGB for the source, RGB to YUV for the destination, on
+		// full-range float data. Only used for YUV, or to extract the luma
+		// of a gray destination. A gray source is handled as R = G = B.
+		Mat4           _mat { 1.0, Mat4::Preset_DIAGONAL };
+		bool           _cl_flag = false;              // BT.2020 constant luminance instead of _mat
+		TransCurve     _curve   = TransCurve_UNDEF;
+		double         _gcor    = 1;                  // Additional gamma correction
+		PrimariesPreset
+		               _prim    = PrimariesPreset_UNDEF;
+	};
+
+	class Param
+	{
+	public:
+		Side           _src;
+		Side           _dst;
+
+		// Converts the transfer curves (and the primaries) on linear RGB.
+		// Otherwise, the matrices are combined and applied to the gamma-
+		// encoded data. Required when only one side is BT.2020 CL.
+		bool           _lin_flag = false;
+		double         _contrast = 1;
+		bool           _wconv_flag = false;   // Chromatic adaptation of the white point
+
+		// Resampling. _rsz_in is for the main resizing, from the source
+		// planes; the window is in source luma coordinates, and a null width
+		// or height means the whole picture. _rsz_out is for the destination
+		// chroma subsampling: only the kernels and the normalisation values
+		// are used. The gains and additive constants are computed here.
+		PlaneDataArray _rsz_in;
+		PlaneDataArray _rsz_out;
+		bool           _norm_flag = true;
+		bool           _itl_flag  = false;    // Frames can be separated fields
+
+		// Bitdepth conversion
+		Dither::DMode  _dmode      = Dither::DMode_FILTERLITE;
+		int            _pat_size   = 32;
+		double         _ampo       = 1;
+		double         _ampn       = 0;
+		bool           _dyn_flag   = false;
+		bool           _static_noise_flag = false;
+		bool           _correlated_planes_flag = false;
+		bool           _tpdfo_flag = false;
+		bool           _tpdfn_flag = false;
+	};
+
+	// The kernels of param must be created. Throws std::invalid_argument
+	// if the conversion is not supported.
+	explicit       ConvertProc (Param &&param, bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag);
+	virtual        ~ConvertProc () = default;
+
+	// All stride values are in bytes. itl must be InterlacingType_FRAME when
+	// the processor was not set up for interlaced content.
+	// Throws std::runtime_error if memory cannot be allocated.
+	void           process_frame (const Frame <> &dst, const FrameRO <> &src, int frame_index, InterlacingType itl);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// Size in bytes of a horizontal stripe (all the planes) processed at once
+	// by the point-wise stages.
+	static constexpr int _stripe_size = 65536;
+
+	typedef std::unique_ptr <FilterResize> ResizeUPtr;
+	typedef std::array <
+		std::array <ResizeUPtr, _max_nbr_planes>,
+		InterlacingType_NBR_ELT
+	> ResizeArray;
+
+	// Full-resolution float planes, and a single subsampled plane for the
+	// chroma before its bitdepth conversion.
+	class WorkBuf
+	{
+	public:
+		typedef std::vector <float, fstb::AllocAlign <float, 64> > Buffer;
+		explicit       WorkBuf (int w, int h, int nbr_planes, int w_sub, int h_sub);
+		ptrdiff_t      _stride     = 0; // Bytes
+		ptrdiff_t      _stride_sub = 0; // Bytes
+		std::array <Buffer, _max_nbr_planes>
+		               _plane_arr;
+		Buffer         _sub;
+	};
+
+	class WorkBufFactory
+	:	public conc::ObjFactoryInterface <WorkBuf>
+	{
+	public:
+		explicit       WorkBufFactory (int w, int h, int nbr_planes, int w_sub, int h_sub);
+	protected:
+		// conc::ObjFactoryInterface
+		virtual WorkBuf *
+		               do_create ();
+	private:
+		int            _w;
+		int            _h;
+		int            _nbr_planes;
+		int            _w_sub;
+		int            _h_sub;
+	};
+
+	void           check_param () const;
+	void           build_pointwise ();
+	void           build_resizers ();
+	void           build_dither ();
+	ResizeUPtr     build_resizer (const ResamplePlaneData &plane_data, InterlacingType itl, SplFmt src_fmt, int src_res) const;
+	std::unique_ptr <MatrixProc>
+	               build_matrix (const Mat4 &mat, const PicFmt &fmt_dst, const PicFmt &fmt_src, int plane_out) const;
+	std::unique_ptr <Matrix2020CLProc>
+	               build_matrix_cl (bool to_yuv_flag) const;
+	std::unique_ptr <TransModel>
+	               build_trans (TransCurve curve_d, TransCurve curve_s, double contrast, double gcor) const;
+	void           process_buf (WorkBuf &buf, const Frame <> &dst, const FrameRO <> &src, int frame_index, InterlacingType itl);
+	void           process_pointwise (WorkBuf &buf) const noexcept;
+	void           process_stages (const ProcComp3Arg &pa) const noexcept;
+
+	static bool    is_identity (const Mat4 &m) noexcept;
+
+	bool           _sse_flag    = false;
+	bool           _sse2_flag   = false;
+	bool           _avx_flag    = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
+
+	// Owns the kernels used by the resizers
+	Param          _param;
+
+	int            _nbr_planes_s = 0;
+	int            _nbr_planes_d = 0;
+	int            _nbr_planes_i = 0;    // Intermediate planes: 1 or 3
+	bool           _expand_flag = false; // Gray source copied to the 3 planes
+	bool           _direct_flag = false; // No point-wise stage
+
+	PicFmt         _fmt_s_flt;           // Source planes after expansion, full-range float
+	PicFmt         _fmt_d_flt;           // Destination family, full-range float
+	PicFmt         _fmt_lin;             // Linear RGB or gray
+
+	// Point-wise stages, in this order. Stages set to nullptr are skipped.
+	std::unique_ptr <MatrixProc>
+	               _mat_s_uptr;          // Source -> RGB, or source -> destination
+	std::unique_ptr <Matrix2020CLProc>
+	               _cl_s_uptr;           // BT.2020 CL -> linear RGB
+	std::unique_ptr <TransModel>
+	               _trans_s_uptr;        // Source curve -> linear or destination curve
+	std::unique_ptr <MatrixProc>
+	               _prim_uptr;           // Primaries, on linear RGB
+	std::unique_ptr <TransModel>
+	               _trans_d_uptr;        // Linear -> destination curve
+	std::unique_ptr <MatrixProc>
+	               _mat_d_uptr;          // RGB -> destination
+	std::unique_ptr <Matrix2020CLProc>
+	               _cl_d_uptr;           // Linear RGB -> BT.2020 CL
+
+	ResizeArray    _rsz_in_arr;          // Source -> intermediate float
+	ResizeArray    _rsz_out_arr;         // Chroma subsampling, float -> float
+	std::unique_ptr <Dither>
+	               _dither_uptr;         // Float -> destination bitdepth
+	bool           _dither_3p_flag = false;
+
+	std::unique_ptr <WorkBufFactory>
+	               _buf_factory_uptr;
+	conc::ObjPool <WorkBuf>
+	               _buf_pool;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               ConvertProc ()                               = delete;
+	               ConvertProc (const ConvertProc &other)       = delete;
+	               ConvertProc (ConvertProc &&other)            = delete;
+	ConvertProc &  operator = (const ConvertProc &other)        = delete;
+	ConvertProc &  operator = (ConvertProc &&other)             = delete;
+	bool           operator == (const ConvertProc &other) const = delete;
+	bool           operator != (const ConvertProc &other) const = delete;
+
+}; // class ConvertProc
+
+
+
+}  // namespace fmtcl
+
+
+
+//#include "fmtcl/ConvertProc.hpp"
+
+
+
+#endif   // fmtcl_ConvertProc_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -147,6 +147,14 @@ bool	CpuOptBase::has_avx512f () const
 
 
 
+// Same level as AVX-512F
+bool	CpuOptBase::has_avx512bw () const
+{
+	return (_cpu._avx512bw_flag && has_avx512f ());
+}
+
+
+
 bool	CpuOptBase::has_f16c () const
 {
 	return (_cpu._f16c_flag && _level >= Level_F16C);
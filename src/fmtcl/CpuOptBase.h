@@ -81,6 +81,7 @@ public:
 	bool           has_avx () const;
 	bool           has_avx2 () const;
 	bool           has_avx512f () const;
+	bool           has_avx512bw () const;
 	bool           has_f16c () const;
 	bool           has_cx16 () const;
 
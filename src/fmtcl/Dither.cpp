@@ -27,16 +27,21 @@ http://www.wtfpl.net/ for more details.
 #include "fstb/def.h"
 
 #include "fmtcl/Dither.h"
+#include "fmtcl/Dither_macro.h"
 #include "fmtcl/fnc.h"
 #include "fmtcl/PicFmt.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	#include "fmtcl/ProxyRwSse2.h"
 #endif
-#include "fmtcl/VoidAndClusterPrecalc.h"
+#include "fmtcl/VoidAndClusterCache.h"
 #include "fstb/fnc.h"
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fstb/ToolsSse2.h"
+#endif
 
 #include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
 #include <cassert>
 #include <cmath>
@@ -66,16 +71,18 @@ Dither::Dither (
 	bool tpdfo_flag, bool tpdfn_flag,
 	bool sse2_flag, bool avx2_flag
 )
-:	_splfmt_src (src_fmt)
+:	_splfmt_src ((src_fmt == SplFmt_FLOAT16) ? SplFmt_FLOAT : src_fmt)
 ,	_splfmt_dst (dst_fmt)
-,	_src_res (src_res)
+,	_src_res ((src_fmt == SplFmt_FLOAT16) ? 32 : src_res)
 ,	_dst_res (dst_res)
+,	_src_fp16_flag (src_fmt == SplFmt_FLOAT16)
 ,	_full_range_in_flag (src_full_flag)
 ,	_full_range_out_flag (dst_full_flag)
 ,	_color_fam (color_fam)
 ,	_nbr_planes (nbr_planes)
 ,	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_fp16_conv (sse2_flag, avx2_flag)
 ,	_dmode (dmode & 0xFFFF)
 ,	_alt_flag (dmode >= 0xFFFF)
 ,	_pat_size (pat_size)
@@ -96,14 +103,16 @@ Dither::Dither (
 		                                      && src_res <= 12)
 		                                  ||     src_res == 14
 		                                  ||     src_res == 16))
-		|| (SplFmt_is_float (src_fmt) &&         src_res == 32 )
+		|| (src_fmt == SplFmt_FLOAT   &&         src_res == 32 )
+		|| (src_fmt == SplFmt_FLOAT16 &&         src_res == 16 )
 	);
 	assert (
 		   (SplFmt_is_int (dst_fmt)   && (   (   dst_res >=  8
 		                                      && dst_res <= 10)
 		                                  ||     dst_res == 12
 		                                  ||     dst_res == 16))
-		|| (SplFmt_is_float (dst_fmt) &&         dst_res == 32 )
+		|| (dst_fmt == SplFmt_FLOAT   &&         dst_res == 32 )
+		|| (dst_fmt == SplFmt_FLOAT16 &&         dst_res == 16 )
 	);
 	assert (color_fam >= 0);
 	assert (color_fam < ColorFamily_NBR_ELT);
@@ -160,6 +169,9 @@ Dither::Dither (
 	}
 	_buf_factory_uptr = std::make_unique <fmtcl::ErrDifBufFactory> (w);
 	_buf_pool.set_factory (*_buf_factory_uptr);
+	_buf_factory_3p_uptr =
+		std::make_unique <fmtcl::ErrDifBufFactory> (w, _nbr_lanes_3p);
+	_buf_pool_3p.set_factory (*_buf_factory_3p_uptr);
 
 	build_dither_pat ();
 
@@ -199,6 +211,12 @@ Dither::Dither (
 	if (_errdif_flag)
 	{
 		init_fnc_errdiff ();
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		if (_sse2_flag)
+		{
+			init_fnc_errdiff_3p ();
+		}
+#endif
 	}
 	else if (_dmode == DMode_QUASIRND)
 	{
@@ -212,6 +230,19 @@ Dither::Dither (
 	{
 		init_fnc_ordered ();
 	}
+
+	// The single-plane error diffusion has only a C++ implementation
+	_perf_name_0 =
+		  (_upconv_flag)              ? "Dither.upconv"
+		: (_errdif_flag)              ? "Dither.errdif"
+		: (_dmode == DMode_QUASIRND)  ? "Dither.quasirnd"
+		: (_dmode == DMode_FAST)      ? "Dither.fast"
+		:                               "Dither.ordered";
+	_perf_simd =
+		  (_errdif_flag && ! _upconv_flag) ? PerfTrace::Simd_CPP
+		: (_avx2_flag)                     ? PerfTrace::Simd_AVX2
+		: (_sse2_flag)                     ? PerfTrace::Simd_SSE2
+		:                                    PerfTrace::Simd_CPP;
 }
 
 
@@ -226,12 +257,17 @@ void	Dither::process_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_
 	assert (plane_index >= 0);
 	assert (plane_index < _max_nbr_planes);
 
+	PerfTrace::Scope  perf_scope (_perf_name_0, _perf_simd, int64_t (w) * h);
+
 	if (_upconv_flag)
 	{
-		BitBltConv blitter (_sse2_flag, _avx2_flag);
+		// The dithering engine does not use AVX-512
+		BitBltConv blitter (_sse2_flag, _avx2_flag, false);
 		blitter.bitblt (
 			_splfmt_dst, _dst_res, dst_ptr, dst_stride,
-			_splfmt_src, _src_res, src_ptr, src_stride,
+			(_src_fp16_flag) ? SplFmt_FLOAT16 : _splfmt_src,
+			(_src_fp16_flag) ? 16             : _src_res,
+			src_ptr, src_stride,
 			w, h,
 			_scale_info_arr [plane_index]._ptr
 		);
@@ -250,6 +286,96 @@ void	Dither::process_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_
 
 
 
+bool	Dither::can_process_3_planes () const noexcept
+{
+	if (   _upconv_flag
+	    || _src_fp16_flag
+	    || _nbr_planes < ProcComp3Arg::_nbr_planes)
+	{
+		return false;
+	}
+
+	// All the planes must use the same kind of processing
+	const bool     sc_flag = is_flt_proc_required (_scale_info_arr [0]._info);
+	for (int plane_index = 1
+	;	plane_index < ProcComp3Arg::_nbr_planes
+	;	++ plane_index)
+	{
+		const auto &   scale_info = _scale_info_arr [plane_index]._info;
+		if (is_flt_proc_required (scale_info) != sc_flag)
+		{
+			return false;
+		}
+	}
+
+	const auto     process_ptr =
+		  (sc_flag)
+		? _process_seg_flt_int_3p_ptr
+		: _process_seg_int_int_3p_ptr;
+
+	return (process_ptr != nullptr);
+}
+
+
+
+void	Dither::process_3_planes (const ProcComp3Arg &arg, int frame_index)
+{
+	assert (arg.is_valid ());
+	assert (frame_index >= 0);
+	assert (can_process_3_planes ());
+
+	constexpr int  nbr_planes = ProcComp3Arg::_nbr_planes;
+
+	const bool     sc_flag = is_flt_proc_required (_scale_info_arr [0]._info);
+	const auto     process_ptr =
+		  (sc_flag)
+		? _process_seg_flt_int_3p_ptr
+		: _process_seg_int_int_3p_ptr;
+	assert (process_ptr != nullptr);
+
+	PerfTrace::Scope  perf_scope (
+		"Dither.errdif_3p", PerfTrace::Simd_SSE2, int64_t (arg._w) * arg._h
+	);
+
+	ErrDifBuf *    ed_buf_ptr = _buf_pool_3p.take_obj ();
+	if (ed_buf_ptr == nullptr)
+	{
+		throw std::runtime_error (
+			"cannot allocate memory for temporary buffer."
+		);
+	}
+	ed_buf_ptr->clear (int ((sc_flag) ? sizeof (float) : sizeof (int32_t)));
+
+	SegContext3p   ctx_arr;
+	for (int plane_index = 0; plane_index < nbr_planes; ++plane_index)
+	{
+		SegContext &   ctx = ctx_arr [plane_index];
+		ctx._scale_info_ptr = &_scale_info_arr [plane_index]._info;
+		ctx._amp            = _amp;
+		ctx._rnd_state      = build_rnd_state (frame_index, plane_index);
+		ctx._ed_buf_ptr     = ed_buf_ptr;
+		ctx._src_bits       = _src_res;
+		ctx._dst_bits       = _dst_res;
+	}
+
+	Frame <>       dst_arr (arg._dst);
+	FrameRO <>     src_arr (arg._src);
+	for (int y = 0; y < arg._h; ++y)
+	{
+		ctx_arr [0]._y = y;
+
+		(*process_ptr) (dst_arr, src_arr, arg._w, ctx_arr);
+
+		dst_arr.step_line ();
+		src_arr.step_line ();
+	}
+
+	_buf_pool_3p.return_obj (*ed_buf_ptr);
+	ed_buf_ptr = nullptr;
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -263,6 +389,7 @@ constexpr int	Dither::_pat_min_size;
 constexpr int	Dither::_amp_bits;
 constexpr int	Dither::_err_res;
 constexpr int	Dither::_max_unk_width;
+constexpr int	Dither::_nbr_lanes_3p;
 
 
 
@@ -354,79 +481,18 @@ void	Dither::build_dither_pat_void_and_cluster (bool aztec_flag)
 {
 	auto           pat_data = PatData { _pat_size, _pat_size };
 
-#if 1 // From precalculated tables
-
-	const std::array <const uint64_t *, 10+1> std_arr =
-	{
-		nullptr,
-		nullptr,
-		VoidAndClusterPrecalc::_pat_2_std.data (),
-		VoidAndClusterPrecalc::_pat_3_std.data (),
-		VoidAndClusterPrecalc::_pat_4_std.data (),
-		VoidAndClusterPrecalc::_pat_5_std.data (),
-		VoidAndClusterPrecalc::_pat_6_std.data (),
-		VoidAndClusterPrecalc::_pat_7_std.data (),
-		VoidAndClusterPrecalc::_pat_8_std.data (),
-		VoidAndClusterPrecalc::_pat_9_std.data (),
-		VoidAndClusterPrecalc::_pat_10_std.data ()
-	};
-	const std::array <const uint64_t *, 10+1> alt_arr =
-	{
-		nullptr,
-		nullptr,
-		VoidAndClusterPrecalc::_pat_2_alt.data (),
-		VoidAndClusterPrecalc::_pat_3_alt.data (),
-		VoidAndClusterPrecalc::_pat_4_alt.data (),
-		VoidAndClusterPrecalc::_pat_5_alt.data (),
-		VoidAndClusterPrecalc::_pat_6_alt.data (),
-		VoidAndClusterPrecalc::_pat_7_alt.data (),
-		VoidAndClusterPrecalc::_pat_8_alt.data (),
-		VoidAndClusterPrecalc::_pat_9_alt.data (),
-		nullptr
-	};
-	const auto     size_l2    = fstb::get_prev_pow_2 (_pat_size);
-	assert (size_l2 < int (std_arr.size ()));
-	const auto     src_ptr    =
-		(aztec_flag) ? alt_arr [size_l2] : std_arr [size_l2];
-	assert (src_ptr != nullptr);
-	constexpr int  block_size = 8;
-	int            pos_block  = 0;
-	int            pos_byte   = 0;
-	uint64_t       val        = 0;
-	for (int y = 0; y < _pat_size; ++y)
-	{
-		for (int x = 0; x < _pat_size; ++x)
-		{
-			if (pos_byte == 0)
-			{
-				val = src_ptr [pos_block];
-				++ pos_block;
-			}
-			pat_data (x, y) = PatDataType (
-				int ((val >> (pos_byte * 8)) & 0xFF) - 128
-			);
-			pos_byte = (pos_byte + 1) & (block_size - 1);
-		}
-	}
-
-#else // Direct generation
-
-	VoidAndCluster   vc_gen;
-	vc_gen.set_aztec_mode (aztec_flag);
-	MatrixWrap <VoidAndCluster::Rank> pat_raw (_pat_size, _pat_size);
-	vc_gen.create_matrix (pat_raw);
-
-	const int      area = _pat_size * _pat_size;
+	const auto     src_sptr = VoidAndClusterCache::use_instance ().use_pattern (
+		_pat_size, aztec_flag
+	);
+	const auto &   src      = *src_sptr;
 	for (int y = 0; y < _pat_size; ++y)
 	{
 		for (int x = 0; x < _pat_size; ++x)
 		{
-			pat_data (x, y) = PatDataType (pat_raw (x, y) * 256 / area - 128);
+			pat_data (x, y) = PatDataType (int (src (x, y)) - 128);
 		}
 	}
 
-#endif
-
 	expand_dither_pat (pat_data);
 	build_next_dither_pat ();
 }
@@ -512,94 +578,6 @@ void	Dither::copy_dither_pat_rotate (PatData &dst, const PatData &src, int angle
 
 
 
-// All possible combinations
-#define fmtcl_Dither_SPAN_INT(SETP, NAMP, NAMF, simple_flag, tpdfo_flag, tpdfn_flag, dst_res, dst_fmt, src_res, src_fmt) \
-	switch (  (int (simple_flag) << 7) \
-	        + (int (tpdfo_flag) << 23) + (int (tpdfn_flag) << 22) \
-	        + ((dst_res) << 24) + ((dst_fmt) << 16) \
-	        + ((src_res) <<  8) +  (src_fmt)) \
-	{ \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 14, SplFmt_INT16, uint16_t, 16) \
-	}
-
-// All possible combinations using float as intermediary data
-#define fmtcl_Dither_SPAN_FLT(SETP, NAMP, NAMF, simple_flag, tpdfo_flag, tpdfn_flag, dst_res, dst_fmt, src_res, src_fmt) \
-	switch (  (int (simple_flag) << 7) \
-	        + (int (tpdfo_flag) << 23) + (int (tpdfn_flag) << 22) \
-	        + ((dst_res) << 24) + ((dst_fmt) << 16) \
-	        + ((src_res) <<  8) +  (src_fmt)) \
-	{ \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT8 , uint8_t ,  8, SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t,  9, SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 10, SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 12, SplFmt_FLOAT, float   , 32) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT8 , uint8_t ,  8) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t,  9) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t, 10) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t, 11) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t, 12) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t, 14) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_INT16, uint16_t, 16) \
-	SETP (NAMP, NAMF, SplFmt_INT16, uint16_t, 16, SplFmt_FLOAT, float   , 32) \
-	}
-
-
-
-#define fmtcl_Dither_SET_FNC_MULTI(FCASE, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (false, false, false, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (false, false, true , NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (false, true , false, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (false, true , true , NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (true , false, false, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (true , false, true , NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (true , true , false, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
-	FCASE (true , true , true , NAMP, NAMF, DF, DT, DP, SF, ST, SP)
-
 #define fmtcl_Dither_SET_FNC_INT_CASE(simple_flag, tpdfo_flag, tpdfn_flag, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
 	case   (int (simple_flag) << 7) \
 	     + (int (tpdfn_flag) << 22) + (int (tpdfo_flag) << 23) \
@@ -677,6 +655,10 @@ void	Dither::init_fnc_fast () noexcept
 			_dst_res, _splfmt_dst, _src_res, _splfmt_src
 		)
 	}
+	if (_avx2_flag)
+	{
+		init_fnc_fast_avx2 ();
+	}
 #endif
 }
 
@@ -711,6 +693,10 @@ void	Dither::init_fnc_ordered () noexcept
 			_dst_res, _splfmt_dst, _src_res, _splfmt_src
 		)
 	}
+	if (_avx2_flag)
+	{
+		init_fnc_ordered_avx2 ();
+	}
 #endif
 }
 
@@ -745,12 +731,15 @@ void	Dither::init_fnc_quasirandom () noexcept
 			_dst_res, _splfmt_dst, _src_res, _splfmt_src
 		)
 	}
+	if (_avx2_flag)
+	{
+		init_fnc_quasirandom_avx2 ();
+	}
 #endif
 }
 
 
 
-#undef fmtcl_Dither_SET_FNC_MULTI
 #undef fmtcl_Dither_SET_FNC_INT_CASE
 #undef fmtcl_Dither_SET_FNC_INT
 #undef fmtcl_Dither_SET_FNC_FLT_CASE
@@ -877,8 +866,106 @@ void	Dither::init_fnc_errdiff () noexcept
 
 
 
-#undef fmtcl_Dither_SPAN_INT
-#undef fmtcl_Dither_SPAN_FLT
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// The multi-plane kernels get the bitdepths at run time, so only the storage
+// types and the flags are template parameters. The diffusion classes are
+// instantiated with null bitdepths, their 3-plane functions don't use them.
+void	Dither::init_fnc_errdiff_3p () noexcept
+{
+	assert (_errdif_flag);
+	assert (_sse2_flag);
+
+	switch (_dmode)
+	{
+	case DMode_FILTERLITE: init_fnc_errdiff_3p_ed <DiffuseFilterLite     > (); break;
+	case DMode_STUCKI:     init_fnc_errdiff_3p_ed <DiffuseStucki         > (); break;
+	case DMode_ATKINSON:   init_fnc_errdiff_3p_ed <DiffuseAtkinson       > (); break;
+	case DMode_FLOYD:      init_fnc_errdiff_3p_ed <DiffuseFloydSteinberg > (); break;
+	case DMode_OSTRO:      init_fnc_errdiff_3p_ed <DiffuseOstromoukhov   > (); break;
+	default:
+		break;
+	}
+}
+
+
+
+// The single-plane functions are set only for the supported format
+// combinations, the multi-plane ones follow them.
+template <template <class, int, class, int> class ED>
+void	Dither::init_fnc_errdiff_3p_ed () noexcept
+{
+	const bool     dst_8_flag = (_splfmt_dst == SplFmt_INT8);
+
+	if (_process_seg_int_int_ptr != nullptr)
+	{
+		assert (_splfmt_src == SplFmt_INT16);
+		_process_seg_int_int_3p_ptr = (dst_8_flag)
+			? select_fnc_errdiff_3p_int <ED <uint8_t , 0, uint16_t, 0> > ()
+			: select_fnc_errdiff_3p_int <ED <uint16_t, 0, uint16_t, 0> > ();
+	}
+
+	if (_process_seg_flt_int_ptr != nullptr)
+	{
+		switch (_splfmt_src)
+		{
+		case SplFmt_INT8:
+			_process_seg_flt_int_3p_ptr = (dst_8_flag)
+				? select_fnc_errdiff_3p_flt <ED <uint8_t , 0, uint8_t , 0> > ()
+				: select_fnc_errdiff_3p_flt <ED <uint16_t, 0, uint8_t , 0> > ();
+			break;
+		case SplFmt_INT16:
+			_process_seg_flt_int_3p_ptr = (dst_8_flag)
+				? select_fnc_errdiff_3p_flt <ED <uint8_t , 0, uint16_t, 0> > ()
+				: select_fnc_errdiff_3p_flt <ED <uint16_t, 0, uint16_t, 0> > ();
+			break;
+		case SplFmt_FLOAT:
+			_process_seg_flt_int_3p_ptr = (dst_8_flag)
+				? select_fnc_errdiff_3p_flt <ED <uint8_t , 0, float   , 0> > ()
+				: select_fnc_errdiff_3p_flt <ED <uint16_t, 0, float   , 0> > ();
+			break;
+		default:
+			assert (false);
+			break;
+		}
+	}
+}
+
+
+
+template <class ERRDIF>
+Dither::ProcSeg3pPtr	Dither::select_fnc_errdiff_3p_int () const noexcept
+{
+	return
+		  (_simple_flag)
+		? ((_tpdfn_flag)
+			? &process_seg_errdif_int_int_3p_sse2 <true , true , ERRDIF>
+			: &process_seg_errdif_int_int_3p_sse2 <true , false, ERRDIF>)
+		: ((_tpdfn_flag)
+			? &process_seg_errdif_int_int_3p_sse2 <false, true , ERRDIF>
+			: &process_seg_errdif_int_int_3p_sse2 <false, false, ERRDIF>);
+}
+
+
+
+template <class ERRDIF>
+Dither::ProcSeg3pPtr	Dither::select_fnc_errdiff_3p_flt () const noexcept
+{
+	return
+		  (_simple_flag)
+		? ((_tpdfn_flag)
+			? &process_seg_errdif_flt_int_3p_sse2 <true , true , ERRDIF>
+			: &process_seg_errdif_flt_int_3p_sse2 <true , false, ERRDIF>)
+		: ((_tpdfn_flag)
+			? &process_seg_errdif_flt_int_3p_sse2 <false, true , ERRDIF>
+			: &process_seg_errdif_flt_int_3p_sse2 <false, false, ERRDIF>);
+}
+
+
+
+#endif   // fstb_ARCHI_X86
 
 
 
@@ -892,31 +979,9 @@ void	Dither::dither_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t
 	SegContext     ctx;
 	ctx._scale_info_ptr = &scale_info;
 	ctx._amp            = _amp;
+	ctx._rnd_state      = build_rnd_state (frame_index, plane_index);
 
-	uint32_t       rnd_state = 0;
-	if (! _correlated_planes_flag)
-	{
-		rnd_state += plane_index << 16;
-	}
-	if (_static_noise_flag)
-	{
-		rnd_state += 55555;
-	}
-	else
-	{
-		rnd_state += frame_index;
-	}
-	ctx._rnd_state = rnd_state;
-
-	const bool     sc_flag = (
-		   _splfmt_src == SplFmt_FLOAT
-		|| _src_res == _dst_res
-		|| ! fstb::is_eq (
-			scale_info._gain * double ((uint64_t (1)) << (_src_res - _dst_res)),
-			1.0, 1e-6
-		)
-		|| ! fstb::is_null (scale_info._add_cst, 1e-6)
-	);
+	const bool     sc_flag = is_flt_proc_required (scale_info);
 
 	void (* process_ptr) (uint8_t *dst_ptr, const uint8_t *src_ptr, int w, SegContext &ctx) =
 		  (sc_flag)
@@ -988,11 +1053,28 @@ void	Dither::dither_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t
 		break;
 	}
 
+	// Half-float lines are converted first. The buffer is padded with zeros
+	// for the vector functions.
+	Fp16Conv::BufFlt  buf_flt;
+	if (_src_fp16_flag)
+	{
+		buf_flt.resize ((w + 15) & ~15, 0.f);
+	}
+
 	for (int y = 0; y < h; ++y)
 	{
 		ctx._y = y;
 
-		(*process_ptr) (dst_ptr, src_ptr, w, ctx);
+		const uint8_t *  src_line_ptr = src_ptr;
+		if (_src_fp16_flag)
+		{
+			_fp16_conv.conv_to_flt (
+				buf_flt.data (), reinterpret_cast <const uint16_t *> (src_ptr), w
+			);
+			src_line_ptr = reinterpret_cast <const uint8_t *> (buf_flt.data ());
+		}
+
+		(*process_ptr) (dst_ptr, src_line_ptr, w, ctx);
 
 		src_ptr += src_stride;
 		dst_ptr += dst_stride;
@@ -1007,6 +1089,44 @@ void	Dither::dither_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t
 
 
 
+// Indicates if the conversion requires a real scaling, done with floating
+// point data.
+bool	Dither::is_flt_proc_required (const BitBltConv::ScaleInfo &scale_info) const noexcept
+{
+	return (
+		   _splfmt_src == SplFmt_FLOAT
+		|| _src_res == _dst_res
+		|| ! fstb::is_eq (
+			scale_info._gain * double ((uint64_t (1)) << (_src_res - _dst_res)),
+			1.0, 1e-6
+		)
+		|| ! fstb::is_null (scale_info._add_cst, 1e-6)
+	);
+}
+
+
+
+uint32_t	Dither::build_rnd_state (int frame_index, int plane_index) const noexcept
+{
+	uint32_t       rnd_state = 0;
+	if (! _correlated_planes_flag)
+	{
+		rnd_state += plane_index << 16;
+	}
+	if (_static_noise_flag)
+	{
+		rnd_state += 55555;
+	}
+	else
+	{
+		rnd_state += frame_index;
+	}
+
+	return rnd_state;
+}
+
+
+
 template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
 void	Dither::process_seg_fast_int_int_cpp (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
 {
@@ -2017,34 +2137,6 @@ void	Dither::process_seg_errdif_flt_int_cpp (uint8_t * fstb_RESTRICT dst_ptr, co
 
 
 
-void	Dither::generate_rnd (uint32_t &state) noexcept
-{
-	state = state * uint32_t (1664525) + 1013904223;
-}
-
-
-
-void	Dither::generate_rnd_eol (uint32_t &state) noexcept
-{
-	state = state * uint32_t (1103515245) + 12345;
-	if ((state & 0x2000000) != 0)
-	{
-		state = state * uint32_t (134775813) + 1;
-	}
-}
-
-
-
-const Dither::PatDataType *	Dither::SegContext::extract_pattern_row () const noexcept
-{
-	assert (_pattern_ptr != nullptr);
-	assert (_y >= 0);
-
-	return &(_pattern_ptr->at (0, _pattern_ptr->wrap_y (_y)));
-}
-
-
-
 template <bool S_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
 void	Dither::quantize_pix_int (DST_TYPE * fstb_RESTRICT dst_ptr, const SRC_TYPE * fstb_RESTRICT src_ptr, SRC_TYPE &src_raw, int x, int & fstb_RESTRICT err, uint32_t &rnd_state, int ampe_i, int ampn_i) noexcept
 {
@@ -2700,6 +2792,894 @@ const std::array <
 }};
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// Multi-plane error diffusion.
+// A vector contains the same pixel of the 3 planes, one plane per 32-bit
+// lane. The last lane is not used. Pixels are loaded and stored by groups
+// of 4 and transposed to this layout. Integer error buffers are kept as
+// 32-bit data but are truncated to 16 bits, exactly like the int16_t
+// buffers of the scalar code.
+
+
+
+// Loads up to 4 pixels as 32-bit integers. Float data is just bitcasted.
+static fstb_FORCEINLINE __m128i	Dither_load_4_3p (const uint8_t *ptr, int len) noexcept
+{
+	const __m128i  zero = _mm_setzero_si128 ();
+	__m128i        val  =
+		  (len == 4)
+		? _mm_cvtsi32_si128 (*reinterpret_cast <const int32_t *> (ptr))
+		: fstb::ToolsSse2::load_epi64_partial (ptr, len);
+	val = _mm_unpacklo_epi8 (val, zero);
+	val = _mm_unpacklo_epi16 (val, zero);
+
+	return val;
+}
+
+static fstb_FORCEINLINE __m128i	Dither_load_4_3p (const uint16_t *ptr, int len) noexcept
+{
+	const __m128i  zero = _mm_setzero_si128 ();
+	__m128i        val  =
+		  (len == 4)
+		? _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr))
+		: fstb::ToolsSse2::load_epi64_partial (ptr, len * 2);
+	val = _mm_unpacklo_epi16 (val, zero);
+
+	return val;
+}
+
+static fstb_FORCEINLINE __m128i	Dither_load_4_3p (const float *ptr, int len) noexcept
+{
+	const __m128   val =
+		  (len == 4)
+		? _mm_loadu_ps (ptr)
+		: fstb::ToolsSse2::load_ps_partial (ptr, len);
+
+	return _mm_castps_si128 (val);
+}
+
+
+
+// Stores up to 4 pixels, clipped to [0 ; vmax]. For 16-bit data, vmax_s16
+// contains the maximum value minus 0x8000, as signed 16-bit integers.
+static fstb_FORCEINLINE void	Dither_store_4_3p (uint8_t *ptr, __m128i val, __m128i vmax_s16, int len) noexcept
+{
+	fstb::unused (vmax_s16);
+
+	val = _mm_packs_epi32 (val, val);
+	val = _mm_packus_epi16 (val, val);
+	if (len == 4)
+	{
+		*reinterpret_cast <int32_t *> (ptr) = _mm_cvtsi128_si32 (val);
+	}
+	else
+	{
+		fstb::ToolsSse2::store_epi64_partial (ptr, val, len);
+	}
+}
+
+static fstb_FORCEINLINE void	Dither_store_4_3p (uint16_t *ptr, __m128i val, __m128i vmax_s16, int len) noexcept
+{
+	const __m128i  mask_s16 = _mm_set1_epi16 (-0x8000);
+	val = _mm_sub_epi32 (val, _mm_set1_epi32 (0x8000));
+	val = _mm_packs_epi32 (val, val);
+	val = _mm_min_epi16 (val, vmax_s16);
+	val = _mm_xor_si128 (val, mask_s16);
+	if (len == 4)
+	{
+		_mm_storel_epi64 (reinterpret_cast <__m128i *> (ptr), val);
+	}
+	else
+	{
+		fstb::ToolsSse2::store_epi64_partial (ptr, val, len * 2);
+	}
+}
+
+
+
+static fstb_FORCEINLINE void	Dither_transpose_4x4_3p (__m128i &a0, __m128i &a1, __m128i &a2, __m128i &a3) noexcept
+{
+	const __m128i  t0 = _mm_unpacklo_epi32 (a0, a1);
+	const __m128i  t1 = _mm_unpacklo_epi32 (a2, a3);
+	const __m128i  t2 = _mm_unpackhi_epi32 (a0, a1);
+	const __m128i  t3 = _mm_unpackhi_epi32 (a2, a3);
+	a0 = _mm_unpacklo_epi64 (t0, t1);
+	a1 = _mm_unpackhi_epi64 (t0, t1);
+	a2 = _mm_unpacklo_epi64 (t2, t3);
+	a3 = _mm_unpackhi_epi64 (t2, t3);
+}
+
+
+
+// Output: pix_arr [k] contains pixel x0 + k of all the planes
+template <class SRC_TYPE>
+static fstb_FORCEINLINE void	Dither_load_pix_3p (__m128i pix_arr [4], const FrameRO <> &src_arr, int x0, int len) noexcept
+{
+	for (int p = 0; p < ProcComp3Arg::_nbr_planes; ++p)
+	{
+		const SRC_TYPE *  src_ptr =
+			reinterpret_cast <const SRC_TYPE *> (src_arr [p]._ptr);
+		pix_arr [p] = Dither_load_4_3p (src_ptr + x0, len);
+	}
+	pix_arr [3] = _mm_setzero_si128 ();
+	Dither_transpose_4x4_3p (pix_arr [0], pix_arr [1], pix_arr [2], pix_arr [3]);
+}
+
+
+
+// Input: pix_arr [k] contains pixel x0 + k of all the planes.
+// pix_arr is destroyed.
+template <class DST_TYPE>
+static fstb_FORCEINLINE void	Dither_store_pix_3p (const Frame <> &dst_arr, int x0, __m128i pix_arr [4], __m128i vmax_s16, int len) noexcept
+{
+	Dither_transpose_4x4_3p (pix_arr [0], pix_arr [1], pix_arr [2], pix_arr [3]);
+	for (int p = 0; p < ProcComp3Arg::_nbr_planes; ++p)
+	{
+		DST_TYPE *     dst_ptr = reinterpret_cast <DST_TYPE *> (dst_arr [p]._ptr);
+		Dither_store_4_3p (dst_ptr + x0, pix_arr [p], vmax_s16, len);
+	}
+}
+
+
+
+static fstb_FORCEINLINE __m128i	Dither_get_vmax_s16_3p (int dst_bits) noexcept
+{
+	return _mm_set1_epi16 (int16_t ((1 << dst_bits) - 1 - 0x8000));
+}
+
+
+
+// Signed shift by a run-time amount, x * 2^s. One of the two counts is 0.
+static fstb_FORCEINLINE __m128i	Dither_sshift_l_3p (__m128i x, __m128i shl, __m128i shr) noexcept
+{
+	return _mm_sll_epi32 (_mm_sra_epi32 (x, shr), shl);
+}
+
+static fstb_FORCEINLINE void	Dither_set_shift_cnt_3p (__m128i &shl, __m128i &shr, int s) noexcept
+{
+	shl = _mm_cvtsi32_si128 (std::max ( s, 0));
+	shr = _mm_cvtsi32_si128 (std::max (-s, 0));
+}
+
+
+
+// Truncated signed integer division (same as C++), using exact double
+// precision computations.
+static fstb_FORCEINLINE __m128i	Dither_div_3p (__m128i num, __m128i den) noexcept
+{
+	constexpr int  shuf_hi = (3 << 2) + 2;
+	const __m128d  n_lo = _mm_cvtepi32_pd (num);
+	const __m128d  d_lo = _mm_cvtepi32_pd (den);
+	const __m128d  n_hi = _mm_cvtepi32_pd (_mm_shuffle_epi32 (num, shuf_hi));
+	const __m128d  d_hi = _mm_cvtepi32_pd (_mm_shuffle_epi32 (den, shuf_hi));
+	const __m128i  q_lo = _mm_cvttpd_epi32 (_mm_div_pd (n_lo, d_lo));
+	const __m128i  q_hi = _mm_cvttpd_epi32 (_mm_div_pd (n_hi, d_hi));
+
+	return _mm_unpacklo_epi64 (q_lo, q_hi);
+}
+
+
+
+// Error buffer access. Integer data emulates the int16_t storage.
+static fstb_FORCEINLINE __m128i	Dither_trunc_s16_3p (__m128i x) noexcept
+{
+	return _mm_srai_epi32 (_mm_slli_epi32 (x, 16), 16);
+}
+
+static fstb_FORCEINLINE __m128i	Dither_load_err_3p (const int32_t *ptr) noexcept
+{
+	return _mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr));
+}
+
+static fstb_FORCEINLINE __m128	Dither_load_err_3p (const float *ptr) noexcept
+{
+	return _mm_loadu_ps (ptr);
+}
+
+static fstb_FORCEINLINE void	Dither_set_err_3p (int32_t *ptr, __m128i e) noexcept
+{
+	_mm_storeu_si128 (
+		reinterpret_cast <__m128i *> (ptr), Dither_trunc_s16_3p (e)
+	);
+}
+
+static fstb_FORCEINLINE void	Dither_set_err_3p (float *ptr, __m128 e) noexcept
+{
+	_mm_storeu_ps (ptr, e);
+}
+
+static fstb_FORCEINLINE void	Dither_add_err_3p (int32_t *ptr, __m128i e) noexcept
+{
+	Dither_set_err_3p (ptr, _mm_add_epi32 (Dither_load_err_3p (ptr), e));
+}
+
+static fstb_FORCEINLINE void	Dither_add_err_3p (float *ptr, __m128 e) noexcept
+{
+	Dither_set_err_3p (ptr, _mm_add_ps (Dither_load_err_3p (ptr), e));
+}
+
+
+
+__m128i	Dither::load_rnd_state_3p (const SegContext3p &ctx_arr) noexcept
+{
+	return _mm_set_epi32 (
+		0,
+		int (ctx_arr [2]._rnd_state),
+		int (ctx_arr [1]._rnd_state),
+		int (ctx_arr [0]._rnd_state)
+	);
+}
+
+
+
+void	Dither::store_rnd_state_3p (SegContext3p &ctx_arr, __m128i rnd_state) noexcept
+{
+	fstb::ToolsSse2::VectI32   tmp;
+	_mm_store_si128 (reinterpret_cast <__m128i *> (tmp), rnd_state);
+	for (int p = 0; p < ProcComp3Arg::_nbr_planes; ++p)
+	{
+		ctx_arr [p]._rnd_state = tmp [p];
+	}
+}
+
+
+
+// Same as generate_dith_n_scalar(), on each lane
+template <bool T_FLAG>
+__m128i	Dither::generate_dith_n_3p (__m128i &rnd_state) noexcept
+{
+	generate_rnd_3p (rnd_state);
+	__m128i        dith_n = _mm_srai_epi32 (rnd_state, 24);
+	if (T_FLAG)
+	{
+		generate_rnd_3p (rnd_state);
+		dith_n = _mm_add_epi32 (dith_n, _mm_srai_epi32 (rnd_state, 24));
+	}
+
+	return dith_n;
+}
+
+
+
+void	Dither::generate_rnd_3p (__m128i &state) noexcept
+{
+	state = _mm_add_epi32 (
+		fstb::ToolsSse2::mullo_epi32 (state, _mm_set1_epi32 (1664525)),
+		_mm_set1_epi32 (1013904223)
+	);
+}
+
+
+
+void	Dither::generate_rnd_eol_3p (__m128i &state) noexcept
+{
+	state = _mm_add_epi32 (
+		fstb::ToolsSse2::mullo_epi32 (state, _mm_set1_epi32 (1103515245)),
+		_mm_set1_epi32 (12345)
+	);
+	const __m128i  alt  = _mm_add_epi32 (
+		fstb::ToolsSse2::mullo_epi32 (state, _mm_set1_epi32 (134775813)),
+		_mm_set1_epi32 (1)
+	);
+	const __m128i  bit  = _mm_set1_epi32 (0x2000000);
+	const __m128i  cond = _mm_cmpeq_epi32 (_mm_and_si128 (state, bit), bit);
+	state = fstb::ToolsSse2::select (cond, alt, state);
+}
+
+
+
+template <bool S_FLAG, bool T_FLAG, class ERRDIF>
+void	Dither::process_seg_errdif_int_int_3p_sse2 (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, SegContext3p &ctx_arr) noexcept
+{
+	assert (dst_arr.is_valid (ProcComp3Arg::_nbr_planes));
+	assert (src_arr.is_valid (ProcComp3Arg::_nbr_planes));
+	assert (w > 0);
+	assert (ctx_arr [0]._y >= 0);
+
+	typedef typename ERRDIF::SrcType SRC_TYPE;
+	typedef typename ERRDIF::DstType DST_TYPE;
+	constexpr int  nl       = _nbr_lanes_3p;
+
+	const SegContext &        ctx    = ctx_arr [0];
+	ErrDifBuf & fstb_RESTRICT ed_buf = *ctx._ed_buf_ptr;
+
+	// Same as quantize_pix_int()
+	const int      src_bits = ctx._src_bits;
+	const int      dst_bits = ctx._dst_bits;
+	const int      dif_bits = src_bits - dst_bits;
+	const int      tmp_bits =
+		  (dif_bits < 6 && src_bits < _err_res && dst_bits < _err_res)
+		? _err_res
+		: src_bits;
+	const int      tmp_shft = tmp_bits - src_bits;
+	const int      tmp_invs = tmp_bits - dst_bits;
+	const int      dit_shft = _amp_bits + 8 - tmp_invs;  // May be negative
+	const __m128i  tmp_shft_v = _mm_cvtsi32_si128 (tmp_shft);
+	const __m128i  tmp_invs_v = _mm_cvtsi32_si128 (tmp_invs);
+	__m128i        dit_shl;
+	__m128i        dit_shr;
+	Dither_set_shift_cnt_3p (dit_shl, dit_shr, -dit_shft);
+
+	// Table index for the Ostromoukhov diffusion, as in get_index()
+	__m128i        idx_shl;
+	__m128i        idx_shr;
+	Dither_set_shift_cnt_3p (
+		idx_shl, idx_shr, DiffuseOstromoukhovBase::_t_bits - dif_bits
+	);
+	const __m128i  idx_mask = _mm_set1_epi32 (DiffuseOstromoukhovBase::_t_mask);
+
+	const __m128i  vmax = Dither_get_vmax_s16_3p (dst_bits);
+	const __m128i  rcst = _mm_set1_epi32 (1 << (tmp_invs - 1));
+	const __m128i  ae   = _mm_set1_epi32 (ctx._amp._e_i);
+	const __m128i  an   = _mm_set1_epi32 (ctx._amp._n_i);
+	__m128i        rnd_state = _mm_setzero_si128 ();
+	if (! S_FLAG)
+	{
+		rnd_state = load_rnd_state_3p (ctx_arr);
+	}
+
+	int            e0 = 0;
+	int            e1 = 0;
+	if (ERRDIF::_nbr_err_lines == 2)
+	{
+		e0 =      ctx._y & 1 ;
+		e1 = 1 - (ctx._y & 1);
+	}
+	int32_t *      err0_ptr = ed_buf.get_buf <int32_t> (e0);
+	int32_t *      err1_ptr = ed_buf.get_buf <int32_t> (e1);
+
+	int32_t *      mem_ptr  = &ed_buf.use_mem <int32_t> (0);
+	__m128i        err_nxt0 = Dither_load_err_3p (mem_ptr     );
+	__m128i        err_nxt1 = Dither_load_err_3p (mem_ptr + nl);
+
+	// Returns the quantized value, updates err.
+	const auto     quantize = [&] (__m128i &err, __m128i src_raw)
+	{
+		const __m128i  src  = _mm_sll_epi32 (src_raw, tmp_shft_v);
+		const __m128i  preq = _mm_add_epi32 (src, err);
+
+		__m128i        sum  = preq;
+		if (! S_FLAG)
+		{
+			const __m128i  dith_n  = generate_dith_n_3p <T_FLAG> (rnd_state);
+			const __m128i  sign    = _mm_srai_epi32 (err, 31);
+			const __m128i  err_add = _mm_sub_epi32 (_mm_xor_si128 (ae, sign), sign);
+			// dith_n and an fit in 16 bits
+			__m128i        noise   =
+				_mm_add_epi32 (_mm_madd_epi16 (dith_n, an), err_add);
+			noise = Dither_sshift_l_3p (noise, dit_shl, dit_shr);
+			sum   = _mm_add_epi32 (sum, noise);
+		}
+
+		const __m128i  quant =
+			_mm_sra_epi32 (_mm_add_epi32 (sum, rcst), tmp_invs_v);
+		err = _mm_sub_epi32 (preq, _mm_sll_epi32 (quant, tmp_invs_v));
+
+		return quant;
+	};
+
+	__m128i        pix_arr [4];
+
+	// Forward
+	if ((ctx._y & 1) == 0)
+	{
+		for (int x0 = 0; x0 < w; x0 += 4)
+		{
+			const int      len = std::min (w - x0, 4);
+			Dither_load_pix_3p <SRC_TYPE> (pix_arr, src_arr, x0, len);
+			for (int k = 0; k < len; ++k)
+			{
+				const int      x       = x0 + k;
+				const __m128i  src_raw = pix_arr [k];
+				const __m128i  src_idx = _mm_and_si128 (
+					Dither_sshift_l_3p (src_raw, idx_shl, idx_shr), idx_mask
+				);
+				__m128i        err     = err_nxt0;
+				pix_arr [k] = quantize (err, src_raw);
+				ERRDIF::template diffuse <1> (
+					err, err_nxt0, err_nxt1,
+					err0_ptr + x * nl, err1_ptr + x * nl, src_idx
+				);
+			}
+			Dither_store_pix_3p <DST_TYPE> (dst_arr, x0, pix_arr, vmax, len);
+		}
+		for (int p = 0; p < nl; ++p)
+		{
+			ERRDIF::prepare_next_line (err1_ptr + w * nl + p);
+		}
+	}
+
+	// Backward
+	else
+	{
+		for (int x0 = (w - 1) & -4; x0 >= 0; x0 -= 4)
+		{
+			const int      len = std::min (w - x0, 4);
+			Dither_load_pix_3p <SRC_TYPE> (pix_arr, src_arr, x0, len);
+			for (int k = len - 1; k >= 0; --k)
+			{
+				const int      x       = x0 + k;
+				const __m128i  src_raw = pix_arr [k];
+				const __m128i  src_idx = _mm_and_si128 (
+					Dither_sshift_l_3p (src_raw, idx_shl, idx_shr), idx_mask
+				);
+				__m128i        err     = err_nxt0;
+				pix_arr [k] = quantize (err, src_raw);
+				ERRDIF::template diffuse <-1> (
+					err, err_nxt0, err_nxt1,
+					err0_ptr + x * nl, err1_ptr + x * nl, src_idx
+				);
+			}
+			Dither_store_pix_3p <DST_TYPE> (dst_arr, x0, pix_arr, vmax, len);
+		}
+		for (int p = 0; p < nl; ++p)
+		{
+			ERRDIF::prepare_next_line (err1_ptr - nl + p);
+		}
+	}
+
+	Dither_set_err_3p (mem_ptr     , err_nxt0);
+	Dither_set_err_3p (mem_ptr + nl, err_nxt1);
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol_3p (rnd_state);
+		store_rnd_state_3p (ctx_arr, rnd_state);
+	}
+}
+
+
+
+template <bool S_FLAG, bool T_FLAG, class ERRDIF>
+void	Dither::process_seg_errdif_flt_int_3p_sse2 (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, SegContext3p &ctx_arr) noexcept
+{
+	assert (dst_arr.is_valid (ProcComp3Arg::_nbr_planes));
+	assert (src_arr.is_valid (ProcComp3Arg::_nbr_planes));
+	assert (w > 0);
+	assert (ctx_arr [0]._y >= 0);
+
+	typedef typename ERRDIF::SrcType SRC_TYPE;
+	typedef typename ERRDIF::DstType DST_TYPE;
+	constexpr int  nl       = _nbr_lanes_3p;
+	constexpr bool src_flt_flag = std::is_same <SRC_TYPE, float>::value;
+
+	const SegContext &        ctx    = ctx_arr [0];
+	ErrDifBuf & fstb_RESTRICT ed_buf = *ctx._ed_buf_ptr;
+
+	// Table index for the Ostromoukhov diffusion with integer sources, as in
+	// get_index()
+	__m128i        idx_shl;
+	__m128i        idx_shr;
+	Dither_set_shift_cnt_3p (
+		idx_shl, idx_shr,
+		DiffuseOstromoukhovBase::_t_bits - (ctx._src_bits - ctx._dst_bits)
+	);
+	const __m128i  idx_mask = _mm_set1_epi32 (DiffuseOstromoukhovBase::_t_mask);
+
+	const __m128i  vmax = Dither_get_vmax_s16_3p (ctx._dst_bits);
+
+	const __m128   mul  = _mm_set_ps (
+		0,
+		float (ctx_arr [2]._scale_info_ptr->_gain),
+		float (ctx_arr [1]._scale_info_ptr->_gain),
+		float (ctx_arr [0]._scale_info_ptr->_gain)
+	);
+	const __m128   add  = _mm_set_ps (
+		0,
+		float (ctx_arr [2]._scale_info_ptr->_add_cst),
+		float (ctx_arr [1]._scale_info_ptr->_add_cst),
+		float (ctx_arr [0]._scale_info_ptr->_add_cst)
+	);
+	const __m128   ae   = _mm_set1_ps ( float (ctx._amp._e_f));
+	const __m128   aen  = _mm_set1_ps (-float (ctx._amp._e_f));
+	const __m128   an   = _mm_set1_ps ( float (ctx._amp._n_f));
+	const __m128   zero = _mm_setzero_ps ();
+	__m128i        rnd_state = _mm_setzero_si128 ();
+	if (! S_FLAG)
+	{
+		rnd_state = load_rnd_state_3p (ctx_arr);
+	}
+
+	int            e0 = 0;
+	int            e1 = 0;
+	if (ERRDIF::_nbr_err_lines == 2)
+	{
+		e0 =      ctx._y & 1 ;
+		e1 = 1 - (ctx._y & 1);
+	}
+	float *        err0_ptr = ed_buf.get_buf <float> (e0);
+	float *        err1_ptr = ed_buf.get_buf <float> (e1);
+
+	float *        mem_ptr  = &ed_buf.use_mem <float> (0);
+	__m128         err_nxt0 = Dither_load_err_3p (mem_ptr     );
+	__m128         err_nxt1 = Dither_load_err_3p (mem_ptr + nl);
+
+	// Returns the quantized value, updates err.
+	// src_raw is the loaded data as input, and the value passed to the
+	// diffuser as output: scaled data for float input, table index for
+	// integer input.
+	const auto     quantize = [&] (__m128 &err, __m128i &src_raw)
+	{
+		const __m128   src_read =
+			  (src_flt_flag)
+			? _mm_castsi128_ps (src_raw)
+			: _mm_cvtepi32_ps (src_raw);
+		const __m128   src      = _mm_add_ps (_mm_mul_ps (src_read, mul), add);
+		if (src_flt_flag)
+		{
+			src_raw = _mm_castps_si128 (src);
+		}
+		else
+		{
+			src_raw = _mm_and_si128 (
+				Dither_sshift_l_3p (src_raw, idx_shl, idx_shr), idx_mask
+			);
+		}
+		const __m128   preq     = _mm_add_ps (src, err);
+
+		__m128         sum      = preq;
+		if (! S_FLAG)
+		{
+			const __m128i  dith_n  = generate_dith_n_3p <T_FLAG> (rnd_state);
+			const __m128   err_add = _mm_or_ps (
+				_mm_and_ps (_mm_cmplt_ps (err, zero), aen),
+				_mm_and_ps (_mm_cmpgt_ps (err, zero), ae )
+			);
+			const __m128   noise   =
+				_mm_add_ps (_mm_mul_ps (_mm_cvtepi32_ps (dith_n), an), err_add);
+			sum = _mm_add_ps (sum, noise);
+		}
+
+		const __m128i  quant = _mm_cvtps_epi32 (sum);
+		err = _mm_sub_ps (preq, _mm_cvtepi32_ps (quant));
+
+		return quant;
+	};
+
+	__m128i        pix_arr [4];
+
+	// Forward
+	if ((ctx._y & 1) == 0)
+	{
+		for (int x0 = 0; x0 < w; x0 += 4)
+		{
+			const int      len = std::min (w - x0, 4);
+			Dither_load_pix_3p <SRC_TYPE> (pix_arr, src_arr, x0, len);
+			for (int k = 0; k < len; ++k)
+			{
+				const int      x       = x0 + k;
+				__m128i        src_raw = pix_arr [k];
+				__m128         err     = err_nxt0;
+				pix_arr [k] = quantize (err, src_raw);
+				ERRDIF::template diffuse <1> (
+					err, err_nxt0, err_nxt1,
+					err0_ptr + x * nl, err1_ptr + x * nl, src_raw
+				);
+			}
+			Dither_store_pix_3p <DST_TYPE> (dst_arr, x0, pix_arr, vmax, len);
+		}
+		for (int p = 0; p < nl; ++p)
+		{
+			ERRDIF::prepare_next_line (err1_ptr + w * nl + p);
+		}
+	}
+
+	// Backward
+	else
+	{
+		for (int x0 = (w - 1) & -4; x0 >= 0; x0 -= 4)
+		{
+			const int      len = std::min (w - x0, 4);
+			Dither_load_pix_3p <SRC_TYPE> (pix_arr, src_arr, x0, len);
+			for (int k = len - 1; k >= 0; --k)
+			{
+				const int      x       = x0 + k;
+				__m128i        src_raw = pix_arr [k];
+				__m128         err     = err_nxt0;
+				pix_arr [k] = quantize (err, src_raw);
+				ERRDIF::template diffuse <-1> (
+					err, err_nxt0, err_nxt1,
+					err0_ptr + x * nl, err1_ptr + x * nl, src_raw
+				);
+			}
+			Dither_store_pix_3p <DST_TYPE> (dst_arr, x0, pix_arr, vmax, len);
+		}
+		for (int p = 0; p < nl; ++p)
+		{
+			ERRDIF::prepare_next_line (err1_ptr - nl + p);
+		}
+	}
+
+	Dither_set_err_3p (mem_ptr     , err_nxt0);
+	Dither_set_err_3p (mem_ptr + nl, err_nxt1);
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol_3p (rnd_state);
+		store_rnd_state_3p (ctx_arr, rnd_state);
+	}
+}
+
+
+
+// Vector versions of the error diffusion kernels.
+// Same operations as the scalar versions, with one plane per lane.
+// Buffer pointers point on interleaved data.
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseFloydSteinberg <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr, src_raw);
+
+	constexpr int  d    = DIR * _nbr_lanes_3p;
+	const __m128i  c8   = _mm_set1_epi32 (8);
+	const __m128i  err5 = _mm_add_epi32 (_mm_slli_epi32 (err, 2), err);
+#if defined (fmtcl_Dither_FS_OPTIMIZED_SERPENTINE_COEF)
+	const __m128i  e1   = _mm_setzero_si128 ();
+	const __m128i  e3   = _mm_srai_epi32 (_mm_add_epi32 (_mm_slli_epi32 (err, 2), c8), 4);
+#else
+	const __m128i  err3 = _mm_add_epi32 (_mm_slli_epi32 (err, 1), err);
+	const __m128i  e1   = _mm_srai_epi32 (_mm_add_epi32 (err , c8), 4);
+	const __m128i  e3   = _mm_srai_epi32 (_mm_add_epi32 (err3, c8), 4);
+#endif
+	const __m128i  e5   = _mm_srai_epi32 (_mm_add_epi32 (err5, c8), 4);
+	const __m128i  e7   = _mm_sub_epi32 (
+		_mm_sub_epi32 (_mm_sub_epi32 (err, e1), e3), e5
+	);
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e3);
+	Dither_add_err_3p (err0_ptr    , e5);
+	Dither_set_err_3p (err0_ptr + d, e1);
+	err_nxt0 = _mm_add_epi32 (err_nxt0, e7);
+}
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseFloydSteinberg <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr, src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+#if defined (fmtcl_Dither_FS_OPTIMIZED_SERPENTINE_COEF)
+	const __m128   e1 = _mm_setzero_ps ();
+	const __m128   e3 = _mm_mul_ps (err, _mm_set1_ps (4.0f / 16));
+#else
+	const __m128   e1 = _mm_mul_ps (err, _mm_set1_ps (1.0f / 16));
+	const __m128   e3 = _mm_mul_ps (err, _mm_set1_ps (3.0f / 16));
+#endif
+	const __m128   e5 = _mm_mul_ps (err, _mm_set1_ps (5.0f / 16));
+	const __m128   e7 = _mm_mul_ps (err, _mm_set1_ps (7.0f / 16));
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e3);
+	Dither_add_err_3p (err0_ptr    , e5);
+	Dither_set_err_3p (err0_ptr + d, e1);
+	err_nxt0 = _mm_add_ps (err_nxt0, e7);
+}
+
+
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseFilterLite <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr, src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+	const __m128i  e1 = _mm_srai_epi32 (_mm_add_epi32 (err, _mm_set1_epi32 (2)), 2);
+	const __m128i  e2 = _mm_sub_epi32 (err, _mm_slli_epi32 (e1, 1));
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e1);
+	Dither_set_err_3p (err0_ptr    , e1);
+	err_nxt0 = _mm_add_epi32 (err_nxt0, e2);
+}
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseFilterLite <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr, src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+	const __m128   e1 = _mm_mul_ps (err, _mm_set1_ps (1.0f / 4));
+	const __m128   e2 = _mm_mul_ps (err, _mm_set1_ps (2.0f / 4));
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e1);
+	Dither_set_err_3p (err0_ptr    , e1);
+	err_nxt0 = _mm_add_ps (err_nxt0, e2);
+}
+
+
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseStucki <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (src_raw);
+
+	constexpr int  d   = DIR * _nbr_lanes_3p;
+	const __m128i  m   =
+		Dither_div_3p (_mm_slli_epi32 (err, 4), _mm_set1_epi32 (42));
+	const __m128i  e1  = _mm_srai_epi32 (_mm_add_epi32 (m, _mm_set1_epi32 (8)), 4);
+	const __m128i  e2  = _mm_srai_epi32 (_mm_add_epi32 (m, _mm_set1_epi32 (4)), 3);
+	const __m128i  e4  = _mm_srai_epi32 (_mm_add_epi32 (m, _mm_set1_epi32 (2)), 2);
+	const __m128i  sum = _mm_add_epi32 (
+		_mm_slli_epi32 (e1, 1),
+		_mm_slli_epi32 (_mm_add_epi32 (e2, e4), 2)
+	);
+	const __m128i  e8  = _mm_srai_epi32 (
+		_mm_add_epi32 (_mm_sub_epi32 (err, sum), _mm_set1_epi32 (1)), 1
+	);
+
+	err_nxt0 = _mm_add_epi32 (err_nxt1, e8);
+	err_nxt1 = _mm_add_epi32 (Dither_load_err_3p (err1_ptr + d * 2), e4);
+	Dither_add_err_3p (err0_ptr - d * 2, e2);
+	Dither_add_err_3p (err0_ptr - d    , e4);
+	Dither_add_err_3p (err0_ptr        , e8);
+	Dither_add_err_3p (err0_ptr + d    , e4);
+	Dither_add_err_3p (err0_ptr + d * 2, e2);
+	Dither_add_err_3p (err1_ptr - d * 2, e1);
+	Dither_add_err_3p (err1_ptr - d    , e2);
+	Dither_add_err_3p (err1_ptr        , e4);
+	Dither_add_err_3p (err1_ptr + d    , e2);
+	Dither_set_err_3p (err1_ptr + d * 2, e1);
+}
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseStucki <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+	const __m128   e1 = _mm_mul_ps (err, _mm_set1_ps (1.0f / 42));
+	const __m128   e2 = _mm_mul_ps (err, _mm_set1_ps (2.0f / 42));
+	const __m128   e4 = _mm_mul_ps (err, _mm_set1_ps (4.0f / 42));
+	const __m128   e8 = _mm_mul_ps (err, _mm_set1_ps (8.0f / 42));
+
+	err_nxt0 = _mm_add_ps (err_nxt1, e8);
+	err_nxt1 = _mm_add_ps (Dither_load_err_3p (err1_ptr + d * 2), e4);
+	Dither_add_err_3p (err0_ptr - d * 2, e2);
+	Dither_add_err_3p (err0_ptr - d    , e4);
+	Dither_add_err_3p (err0_ptr        , e8);
+	Dither_add_err_3p (err0_ptr + d    , e4);
+	Dither_add_err_3p (err0_ptr + d * 2, e2);
+	Dither_add_err_3p (err1_ptr - d * 2, e1);
+	Dither_add_err_3p (err1_ptr - d    , e2);
+	Dither_add_err_3p (err1_ptr        , e4);
+	Dither_add_err_3p (err1_ptr + d    , e2);
+	Dither_set_err_3p (err1_ptr + d * 2, e1);
+}
+
+
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseAtkinson <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+	const __m128i  e1 = _mm_srai_epi32 (_mm_add_epi32 (err, _mm_set1_epi32 (4)), 3);
+
+	err_nxt0 = _mm_add_epi32 (err_nxt1, e1);
+	err_nxt1 = _mm_add_epi32 (Dither_load_err_3p (err1_ptr + d * 2), e1);
+	Dither_add_err_3p (err0_ptr - d, e1);
+	Dither_add_err_3p (err0_ptr    , e1);
+	Dither_add_err_3p (err0_ptr + d, e1);
+	Dither_set_err_3p (err1_ptr    , e1);
+}
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseAtkinson <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (src_raw);
+
+	constexpr int  d  = DIR * _nbr_lanes_3p;
+	const __m128   e1 = _mm_mul_ps (err, _mm_set1_ps (1.0f / 8));
+
+	err_nxt0 = _mm_add_ps (err_nxt1, e1);
+	err_nxt1 = _mm_add_ps (Dither_load_err_3p (err1_ptr + d * 2), e1);
+	Dither_add_err_3p (err0_ptr - d, e1);
+	Dither_add_err_3p (err0_ptr    , e1);
+	Dither_add_err_3p (err0_ptr + d, e1);
+	Dither_set_err_3p (err1_ptr    , e1);
+}
+
+
+
+// The table lookup is done separately for each lane
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseOstromoukhov <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr);
+
+	constexpr int  d = DIR * _nbr_lanes_3p;
+
+	// src_raw contains the table indexes
+	fstb::ToolsSse2::VectI32   idx_arr;
+	_mm_store_si128 (reinterpret_cast <__m128i *> (idx_arr), src_raw);
+	fstb::ToolsSse2::VectI32   c0_arr;
+	fstb::ToolsSse2::VectI32   c1_arr;
+	fstb::ToolsSse2::VectI32   sum_arr;
+	for (int p = 0; p < _nbr_lanes_3p; ++p)
+	{
+		const int      index = int (idx_arr [p]);
+		const typename ThisType::TableEntry & fstb_RESTRICT te = ThisType::_table [index];
+		c0_arr [p]  = uint32_t (te._c0);
+		c1_arr [p]  = uint32_t (te._c1);
+		sum_arr [p] = uint32_t (te._sum);
+	}
+	const __m128i  c0  = _mm_load_si128 (reinterpret_cast <const __m128i *> (c0_arr));
+	const __m128i  c1  = _mm_load_si128 (reinterpret_cast <const __m128i *> (c1_arr));
+	const __m128i  sum = _mm_load_si128 (reinterpret_cast <const __m128i *> (sum_arr));
+
+	const __m128i  e1 = Dither_div_3p (fstb::ToolsSse2::mullo_epi32 (err, c0), sum);
+	const __m128i  e2 = Dither_div_3p (fstb::ToolsSse2::mullo_epi32 (err, c1), sum);
+	const __m128i  e3 = _mm_sub_epi32 (_mm_sub_epi32 (err, e1), e2);
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e2);
+	Dither_set_err_3p (err0_ptr    , e3);
+	err_nxt0 = _mm_add_epi32 (err_nxt0, e1);
+}
+
+template <class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
+template <int DIR>
+void	Dither::DiffuseOstromoukhov <DST_TYPE, DST_BITS, SRC_TYPE, SRC_BITS>::diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept
+{
+	fstb::unused (err_nxt1, err1_ptr);
+
+	constexpr int  d = DIR * _nbr_lanes_3p;
+
+	// src_raw contains float data if the source is float, and the table
+	// indexes otherwise.
+	fstb::ToolsSse2::VectI32   raw_i_arr;
+	fstb::ToolsSse2::VectF32   raw_f_arr;
+	_mm_store_si128 (reinterpret_cast <__m128i *> (raw_i_arr), src_raw);
+	_mm_store_ps (raw_f_arr, _mm_castsi128_ps (src_raw));
+	fstb::ToolsSse2::VectF32   c0_arr;
+	fstb::ToolsSse2::VectF32   c1_arr;
+	fstb::ToolsSse2::VectF32   invd_arr;
+	for (int p = 0; p < _nbr_lanes_3p; ++p)
+	{
+		const int      index =
+			  (std::is_same <SRC_TYPE, float>::value)
+			? ThisType::get_index (raw_f_arr [p])
+			: int (raw_i_arr [p]);
+		const typename ThisType::TableEntry & fstb_RESTRICT te = ThisType::_table [index];
+		c0_arr [p]   = float (te._c0);
+		c1_arr [p]   = float (te._c1);
+		invd_arr [p] = te._inv_sum;
+	}
+	const __m128   c0   = _mm_load_ps (c0_arr);
+	const __m128   c1   = _mm_load_ps (c1_arr);
+	const __m128   invd = _mm_load_ps (invd_arr);
+
+	const __m128   e1 = _mm_mul_ps (_mm_mul_ps (err, c0), invd);
+	const __m128   e2 = _mm_mul_ps (_mm_mul_ps (err, c1), invd);
+	const __m128   e3 = _mm_sub_ps (_mm_sub_ps (err, e1), e2);
+
+	err_nxt0 = Dither_load_err_3p (err0_ptr + d);
+	Dither_add_err_3p (err0_ptr - d, e2);
+	Dither_set_err_3p (err0_ptr    , e3);
+	err_nxt0 = _mm_add_ps (err_nxt0, e1);
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
 
 }  // namespace fmtcl
 
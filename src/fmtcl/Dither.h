@@ -26,15 +26,21 @@ http://www.wtfpl.net/ for more details.
 #include "conc/ObjPool.h"
 #include "fmtcl/ColorFamily.h"
 #include "fmtcl/BitBltConv.h"
+#include "fmtcl/Fp16Conv.h"
 #include "fmtcl/ErrDifBuf.h"
 #include "fmtcl/ErrDifBufFactory.h"
+#include "fmtcl/Frame.h"
+#include "fmtcl/FrameRO.h"
 #include "fmtcl/MatrixWrap.h"
+#include "fmtcl/PerfTrace.h"
+#include "fmtcl/ProcComp3Arg.h"
 #include "fmtcl/SplFmt.h"
 #include "fstb/def.h"
 #include "fstb/ArrayAlign.h"
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	#include <emmintrin.h>
+	#include <immintrin.h>
 #endif // fstb_ARCHI_X86
 
 #include <array>
@@ -93,6 +99,12 @@ public:
 
 	void           process_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, int frame_index, int plane_index);
 
+	// Error diffusion of the 3 first planes at once, one plane per SIMD lane.
+	// The planes must have the same size. Results are identical to separate
+	// process_plane() calls.
+	bool           can_process_3_planes () const noexcept;
+	void           process_3_planes (const ProcComp3Arg &arg, int frame_index);
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -109,8 +121,9 @@ private:
 	static constexpr int _pat_period    =     4;
 
 	// Minimum pattern size to execute operations, constrained by SIMD vector
-	// sizes. Original pattern can be smaller. Must be a power of 2
-	static constexpr int _pat_min_size  =     8;
+	// sizes (16 x int16_t for AVX2). Original pattern can be smaller.
+	// Must be a power of 2
+	static constexpr int _pat_min_size  =    16;
 
 	// Bit depth of the amplitude fractionnal part. The whole thing is 7 bits,
 	// and we need a few bits for the integer part.
@@ -124,6 +137,9 @@ private:
 	// Maximum width (pixels) for variable formats
 	static constexpr int _max_unk_width = 65536;
 
+	// Number of 32-bit lanes for the multi-plane error diffusion (SSE2)
+	static constexpr int _nbr_lanes_3p  =     4;
+
 	class SclInf
 	{
 	public:
@@ -161,8 +177,15 @@ private:
 		int            _y           = -1;      // Ordered dithering and error diffusion
 		uint32_t       _qrs_seed    = 0;       // For the quasirandom sequences
 		AmpInfo        _amp;
+		int            _src_bits    = 0;       // Multi-plane error diffusion
+		int            _dst_bits    = 0;       // Multi-plane error diffusion
 	};
 
+	// Multi-plane error diffusion. _ed_buf_ptr, _y and the bitdepths are
+	// taken from the first context.
+	typedef std::array <SegContext, ProcComp3Arg::_nbr_planes> SegContext3p;
+	typedef void (*ProcSeg3pPtr) (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, SegContext3p &ctx_arr);
+
 	void           build_dither_pat ();
 	void           build_dither_pat_round ();
 	void           build_dither_pat_bayer ();
@@ -174,8 +197,24 @@ private:
 	void           init_fnc_ordered () noexcept;
 	void           init_fnc_quasirandom () noexcept;
 	void           init_fnc_errdiff () noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           init_fnc_errdiff_3p () noexcept;
+	template <template <class, int, class, int> class ED>
+	void           init_fnc_errdiff_3p_ed () noexcept;
+	template <class ERRDIF>
+	ProcSeg3pPtr   select_fnc_errdiff_3p_int () const noexcept;
+	template <class ERRDIF>
+	ProcSeg3pPtr   select_fnc_errdiff_3p_flt () const noexcept;
+#endif
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           init_fnc_fast_avx2 () noexcept;
+	void           init_fnc_ordered_avx2 () noexcept;
+	void           init_fnc_quasirandom_avx2 () noexcept;
+#endif
 
 	void           dither_plane (uint8_t *dst_ptr, ptrdiff_t dst_stride, const uint8_t *src_ptr, ptrdiff_t src_stride, int w, int h, const BitBltConv::ScaleInfo &scale_info, int frame_index, int plane_index);
+	bool           is_flt_proc_required (const BitBltConv::ScaleInfo &scale_info) const noexcept;
+	uint32_t       build_rnd_state (int frame_index, int plane_index) const noexcept;
 
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
 	static void    process_seg_fast_int_int_cpp (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &/*ctx*/) noexcept;
@@ -187,6 +226,10 @@ private:
 	static void    process_seg_fast_int_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &/*ctx*/) noexcept;
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
 	static void    process_seg_fast_flt_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+	static void    process_seg_fast_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &/*ctx*/) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+	static void    process_seg_fast_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 #endif
 
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
@@ -199,6 +242,10 @@ private:
 	static void    process_seg_ord_int_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
 	static void    process_seg_ord_flt_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+	static void    process_seg_ord_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+	static void    process_seg_ord_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 #endif
 
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS>
@@ -211,6 +258,10 @@ private:
 	static void    process_seg_qrs_int_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
 	static void    process_seg_qrs_flt_int_sse2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+	static void    process_seg_qrs_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
+	template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+	static void    process_seg_qrs_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 #endif
 
 	template <bool S_FLAG, bool TN_FLAG, class DST_TYPE, int DST_BITS, class SRC_TYPE, int SRC_BITS, typename DFNC>
@@ -237,6 +288,18 @@ private:
 	               generate_dith_n_vec (uint32_t &rnd_state) noexcept;
 	static fstb_FORCEINLINE __m128i
 	               remap_tpdf_vec (__m128i d) noexcept;
+
+	template <bool S_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS, typename DFNC>
+	static fstb_FORCEINLINE void
+	               process_seg_common_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx, DFNC dither_fnc) noexcept;
+	template <bool S_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, typename DFNC>
+	static fstb_FORCEINLINE void
+	               process_seg_common_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx, DFNC dither_fnc) noexcept;
+	template <bool T_FLAG>
+	static fstb_FORCEINLINE __m256i
+	               generate_dith_n_vec_avx2 (uint32_t &rnd_state, int len) noexcept;
+	static fstb_FORCEINLINE __m256i
+	               remap_tpdf_vec_avx2 (__m256i d) noexcept;
 #endif
 
 	template <bool S_FLAG, bool TN_FLAG, class ERRDIF>
@@ -244,6 +307,24 @@ private:
 	template <bool S_FLAG, bool TN_FLAG, class ERRDIF>
 	static void    process_seg_errdif_flt_int_cpp (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept;
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	template <bool S_FLAG, bool TN_FLAG, class ERRDIF>
+	static void    process_seg_errdif_int_int_3p_sse2 (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, SegContext3p &ctx_arr) noexcept;
+	template <bool S_FLAG, bool TN_FLAG, class ERRDIF>
+	static void    process_seg_errdif_flt_int_3p_sse2 (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, SegContext3p &ctx_arr) noexcept;
+	static fstb_FORCEINLINE __m128i
+	               load_rnd_state_3p (const SegContext3p &ctx_arr) noexcept;
+	static fstb_FORCEINLINE void
+	               store_rnd_state_3p (SegContext3p &ctx_arr, __m128i rnd_state) noexcept;
+	template <bool T_FLAG>
+	static fstb_FORCEINLINE __m128i
+	               generate_dith_n_3p (__m128i &rnd_state) noexcept;
+	static fstb_FORCEINLINE void
+	               generate_rnd_3p (__m128i &state) noexcept;
+	static fstb_FORCEINLINE void
+	               generate_rnd_eol_3p (__m128i &state) noexcept;
+#endif
+
 	static inline void
 	               generate_rnd (uint32_t &state) noexcept;
 	static inline void
@@ -278,6 +359,14 @@ private:
 		template <int DIR>
 		static fstb_FORCEINLINE void
 		               diffuse (float err, float & fstb_RESTRICT err_nxt0, float & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, SRC_TYPE src_raw) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+#endif
 		template <typename EB>
 		static fstb_FORCEINLINE void
 		               prepare_next_line (EB * fstb_RESTRICT err_ptr) noexcept;
@@ -298,6 +387,14 @@ private:
 		template <int DIR>
 		static fstb_FORCEINLINE void
 		               diffuse (float err, float & fstb_RESTRICT err_nxt0, float & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, SRC_TYPE src_raw) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+#endif
 		template <typename EB>
 		static fstb_FORCEINLINE void
 		               prepare_next_line (EB * fstb_RESTRICT err_ptr) noexcept;
@@ -318,6 +415,14 @@ private:
 		template <int DIR>
 		static fstb_FORCEINLINE void
 		               diffuse (float err, float & fstb_RESTRICT err_nxt0, float & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, SRC_TYPE src_raw) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+#endif
 		template <typename EB>
 		static fstb_FORCEINLINE void
 		               prepare_next_line (EB * fstb_RESTRICT err_ptr) noexcept;
@@ -338,6 +443,14 @@ private:
 		template <int DIR>
 		static fstb_FORCEINLINE void
 		               diffuse (float err, float & fstb_RESTRICT err_nxt0, float & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, SRC_TYPE src_raw) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+#endif
 		template <typename EB>
 		static fstb_FORCEINLINE void
 		               prepare_next_line (EB * fstb_RESTRICT err_ptr) noexcept;
@@ -392,6 +505,14 @@ private:
 		template <int DIR>
 		static fstb_FORCEINLINE void
 		               diffuse (float err, float & fstb_RESTRICT err_nxt0, float & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, SRC_TYPE src_raw) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128i err, __m128i & fstb_RESTRICT err_nxt0, __m128i & fstb_RESTRICT err_nxt1, int32_t * fstb_RESTRICT err0_ptr, int32_t * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+		template <int DIR>
+		static fstb_FORCEINLINE void
+		               diffuse (__m128 err, __m128 & fstb_RESTRICT err_nxt0, __m128 & fstb_RESTRICT err_nxt1, float * fstb_RESTRICT err0_ptr, float * fstb_RESTRICT err1_ptr, __m128i src_raw) noexcept;
+#endif
 		template <typename EB>
 		static fstb_FORCEINLINE void
 		               prepare_next_line (EB * fstb_RESTRICT err_ptr) noexcept;
@@ -405,6 +526,7 @@ private:
 	SplFmt         _splfmt_dst = SplFmt_ILLEGAL;
 	int            _src_res    = 0;
 	int            _dst_res    = 0;
+	bool           _src_fp16_flag = false; // Half-float source, _splfmt_src and _src_res are set to float.
 	bool           _full_range_in_flag  = false;
 	bool           _full_range_out_flag = false;
 	ColorFamily    _color_fam  = ColorFamily_INVALID;
@@ -415,6 +537,7 @@ private:
 	bool           _upconv_flag = false;
 	bool           _sse2_flag   = false;
 	bool           _avx2_flag   = false;
+	Fp16Conv       _fp16_conv;
 	bool           _range_def_flag = false;
 
 	int            _dmode    = DMode_FAST;
@@ -430,6 +553,9 @@ private:
 
 	bool           _errdif_flag = false;   // Indicates a dithering method using error diffusion.
 	bool           _simple_flag = false;   // Simplified implementation for ampo == 1 and ampn == 0
+	const char *   _perf_name_0 = "";      // Stage reported by the performance traces
+	PerfTrace::Simd
+	               _perf_simd   = PerfTrace::Simd_CPP;
 	PatDataArray   _dither_pat_arr;        // Contains levels for ordered dithering
 
 	AmpInfo        _amp;
@@ -439,8 +565,16 @@ private:
 	std::unique_ptr <ErrDifBufFactory>
 	               _buf_factory_uptr;
 
+	// Interleaved buffers for the multi-plane error diffusion
+	conc::ObjPool <ErrDifBuf>
+						_buf_pool_3p;
+	std::unique_ptr <ErrDifBufFactory>
+	               _buf_factory_3p_uptr;
+
 	void (*        _process_seg_int_int_ptr) (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) = nullptr;
 	void (*        _process_seg_flt_int_ptr) (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) = nullptr;
+	ProcSeg3pPtr   _process_seg_int_int_3p_ptr = nullptr;
+	ProcSeg3pPtr   _process_seg_flt_int_3p_ptr = nullptr;
 
 
 
@@ -464,7 +598,7 @@ private:
 
 
 
-//#include "fmtcl/Dither.hpp"
+#include "fmtcl/Dither.hpp"
 
 
 
@@ -0,0 +1,82 @@
+/*****************************************************************************
+
+        Dither.hpp
+        Author: Laurent de Soras, 2021
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_Dither_CODEHEADER_INCLUDED)
+#define	fmtcl_Dither_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	Dither::generate_rnd (uint32_t &state) noexcept
+{
+	state = state * uint32_t (1664525) + 1013904223;
+}
+
+
+
+void	Dither::generate_rnd_eol (uint32_t &state) noexcept
+{
+	state = state * uint32_t (1103515245) + 12345;
+	if ((state & 0x2000000) != 0)
+	{
+		state = state * uint32_t (134775813) + 1;
+	}
+}
+
+
+
+const Dither::PatDataType *	Dither::SegContext::extract_pattern_row () const noexcept
+{
+	assert (_pattern_ptr != nullptr);
+	assert (_y >= 0);
+
+	return &(_pattern_ptr->at (0, _pattern_ptr->wrap_y (_y)));
+}
+
+
+
+}  // namespace fmtcl
+
+
+
+#endif	// fmtcl_Dither_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
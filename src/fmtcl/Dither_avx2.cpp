@@ -0,0 +1,719 @@
+/*****************************************************************************
+
+        Dither_avx2.cpp
+        Author: Laurent de Soras, 2021
+
+To be compiled with /arch:AVX2 in order to avoid SSE/AVX state switch
+slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include "fmtcl/Dither.h"
+#include "fmtcl/Dither_macro.h"
+#include "fmtcl/ProxyRwAvx2.h"
+#include "fstb/fnc.h"
+
+#include <cassert>
+#include <cmath>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+#define fmtcl_Dither_SET_FNC_INT_AVX2_CASE(simple_flag, tpdfo_flag, tpdfn_flag, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	case   (int (simple_flag) << 7) \
+	     + (int (tpdfn_flag) << 22) + (int (tpdfo_flag) << 23) \
+	     + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_int_int_ptr = &process_seg_##NAMF##_int_int_avx2 < \
+			simple_flag, tpdfo_flag, tpdfn_flag, DF, DP, SF, SP \
+		>; \
+		break;
+
+#define fmtcl_Dither_SET_FNC_INT_AVX2(NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	fmtcl_Dither_SET_FNC_MULTI (fmtcl_Dither_SET_FNC_INT_AVX2_CASE, \
+		NAMP, NAMF, DF, DT, DP, SF, ST, SP)
+
+#define fmtcl_Dither_SET_FNC_FLT_AVX2_CASE(simple_flag, tpdfo_flag, tpdfn_flag, NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	case   (int (simple_flag) << 7) \
+	     + (int (tpdfn_flag) << 22) + (int (tpdfo_flag) << 23) \
+	     + (DP << 24) + (DF << 16) + (SP << 8) + SF: \
+		_process_seg_flt_int_ptr = &process_seg_##NAMF##_flt_int_avx2 < \
+			simple_flag, tpdfo_flag, tpdfn_flag, DF, DP, SF \
+		>; \
+		break;
+
+#define fmtcl_Dither_SET_FNC_FLT_AVX2(NAMP, NAMF, DF, DT, DP, SF, ST, SP) \
+	fmtcl_Dither_SET_FNC_MULTI (fmtcl_Dither_SET_FNC_FLT_AVX2_CASE, \
+		NAMP, NAMF, DF, DT, DP, SF, ST, SP)
+
+
+
+void	Dither::init_fnc_fast_avx2 () noexcept
+{
+	fmtcl_Dither_SPAN_INT (
+		fmtcl_Dither_SET_FNC_INT_AVX2, fast, fast, false, false, false,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+	fmtcl_Dither_SPAN_FLT (
+		fmtcl_Dither_SET_FNC_FLT_AVX2, fast, fast, false, false, false,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+}
+
+
+
+void	Dither::init_fnc_ordered_avx2 () noexcept
+{
+	fmtcl_Dither_SPAN_INT (
+		fmtcl_Dither_SET_FNC_INT_AVX2,
+		ord, ord, _simple_flag, _tpdfo_flag, _tpdfn_flag,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+	fmtcl_Dither_SPAN_FLT (
+		fmtcl_Dither_SET_FNC_FLT_AVX2,
+		ord, ord, _simple_flag, _tpdfo_flag, _tpdfn_flag,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+}
+
+
+
+void	Dither::init_fnc_quasirandom_avx2 () noexcept
+{
+	fmtcl_Dither_SPAN_INT (
+		fmtcl_Dither_SET_FNC_INT_AVX2,
+		qrs, qrs, _simple_flag, _tpdfo_flag, _tpdfn_flag,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+	fmtcl_Dither_SPAN_FLT (
+		fmtcl_Dither_SET_FNC_FLT_AVX2,
+		qrs, qrs, _simple_flag, _tpdfo_flag, _tpdfn_flag,
+		_dst_res, _splfmt_dst, _src_res, _splfmt_src
+	)
+}
+
+
+
+#undef fmtcl_Dither_SET_FNC_INT_AVX2_CASE
+#undef fmtcl_Dither_SET_FNC_INT_AVX2
+#undef fmtcl_Dither_SET_FNC_FLT_AVX2_CASE
+#undef fmtcl_Dither_SET_FNC_FLT_AVX2
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+void	Dither::process_seg_fast_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	fstb::unused (ctx);
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+
+	constexpr int  dif_bits = SRC_BITS - DST_BITS;
+	static_assert (dif_bits >= 0, "This function cannot increase bidepth.");
+
+	typedef typename  ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256i  zero      = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+
+	const int      w16 = w & -16;
+	const int      w15 = w - w16;
+
+	for (int pos = 0; pos < w16; pos += 16)
+	{
+		const __m256i  s   =
+			ProxyRwAvx2 <SRC_FMT>::read_i16 (src_n_ptr + pos, zero);
+		const __m256i  pix = _mm256_srli_epi16 (s, dif_bits);
+		ProxyRwAvx2 <DST_FMT>::write_i16 (dst_n_ptr + pos, pix, mask_lsb);
+	}
+
+	if (w15 > 0)
+	{
+		const __m256i  s   = ProxyRwAvx2 <SRC_FMT>::read_i16_partial (
+			src_n_ptr + w16, zero, w15
+		);
+		const __m256i  pix = _mm256_srli_epi16 (s, dif_bits);
+		ProxyRwAvx2 <DST_FMT>::write_i16_partial (
+			dst_n_ptr + w16, pix, mask_lsb, w15
+		);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+void	Dither::process_seg_fast_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (ctx._scale_info_ptr != nullptr);
+
+	typedef typename  ProxyRwAvx2 <SRC_FMT>::PtrConst::Type  SrcPtr;
+	typedef typename  ProxyRwAvx2 <DST_FMT>::Ptr::Type       DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+
+	const __m256   mul      = _mm256_set1_ps (float (ctx._scale_info_ptr->_gain));
+	const __m256   add      = _mm256_set1_ps (float (ctx._scale_info_ptr->_add_cst));
+	const __m256   vmax     = _mm256_set1_ps (float ((1 << DST_BITS) - 1));
+	const __m256   zero_f   = _mm256_setzero_ps ();
+	const __m256i  zero_i   = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256   offset   = _mm256_set1_ps (-32768);
+
+	const int      w16 = w & -16;
+	const int      w15 = w - w16;
+
+	for (int pos = 0; pos < w16; pos += 16)
+	{
+		__m256         s0;
+		__m256         s1;
+		ProxyRwAvx2 <SRC_FMT>::read_flt (src_n_ptr + pos, s0, s1, zero_i);
+		s0 = _mm256_add_ps (_mm256_mul_ps (s0, mul), add);
+		s1 = _mm256_add_ps (_mm256_mul_ps (s1, mul), add);
+		s0 = _mm256_max_ps (_mm256_min_ps (s0, vmax), zero_f);
+		s1 = _mm256_max_ps (_mm256_min_ps (s1, vmax), zero_f);
+		ProxyRwAvx2 <DST_FMT>::write_flt (
+			dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset
+		);
+	}
+
+	if (w15 > 0)
+	{
+		__m256         s0;
+		__m256         s1;
+		ProxyRwAvx2 <SRC_FMT>::read_flt_partial (
+			src_n_ptr + w16, s0, s1, zero_i, w15
+		);
+		s0 = _mm256_add_ps (_mm256_mul_ps (s0, mul), add);
+		s1 = _mm256_add_ps (_mm256_mul_ps (s1, mul), add);
+		s0 = _mm256_max_ps (_mm256_min_ps (s0, vmax), zero_f);
+		s1 = _mm256_max_ps (_mm256_min_ps (s1, vmax), zero_f);
+		ProxyRwAvx2 <DST_FMT>::write_flt_partial (
+			dst_n_ptr + w16, s0, s1, mask_lsb, sign_bit, offset, w15
+		);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+void	Dither::process_seg_ord_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	auto * const fstb_RESTRICT pat_row_ptr = ctx.extract_pattern_row ();
+	const int      pat_x_mask = ctx._pattern_ptr->get_w () - 1;
+
+	process_seg_common_int_int_avx2 <
+		S_FLAG, TN_FLAG, DST_FMT, DST_BITS, SRC_FMT, SRC_BITS
+	> (dst_ptr, src_ptr, w, ctx,
+		[pat_row_ptr, pat_x_mask] (int pos)
+		{
+			return _mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+				pat_row_ptr + (pos & pat_x_mask)
+			)); // 16 s16 [-128 ; +127]
+		}
+	);
+}
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+void	Dither::process_seg_ord_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	auto * const fstb_RESTRICT pat_row_ptr = ctx.extract_pattern_row ();
+	const int      pat_x_mask = ctx._pattern_ptr->get_w () - 1;
+
+	process_seg_common_flt_int_avx2 <
+		S_FLAG, TN_FLAG, DST_FMT, DST_BITS, SRC_FMT
+	> (dst_ptr, src_ptr, w, ctx,
+		[pat_row_ptr, pat_x_mask] (int pos)
+		{
+			return _mm256_loadu_si256 (reinterpret_cast <const __m256i *> (
+				pat_row_ptr + (pos & pat_x_mask)
+			)); // 16 s16 [-128 ; +127]
+		}
+	);
+}
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS>
+void	Dither::process_seg_qrs_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	// alpha1 = 1 / x, with x real solution of: x^3 - x - 1 = 0
+	// Also:
+	// alpha1 =   (curt (2) * sq (curt (3)))
+	//          / (curt (9 - sqrt (69)) + curt (9 + sqrt (69)))
+	constexpr double  alpha1  = 1.0 / 1.3247179572447460259609088544781;
+	constexpr double  alpha2  = alpha1 * alpha1;
+	constexpr int     sc_l2   = 16; // 16 bits of fractional values
+	constexpr float   sc_mul  = float (1 << sc_l2);
+	constexpr int     qrs_shf = sc_l2 - 9;
+	constexpr int     qrs_inc = int (alpha1 * sc_mul + 0.5f);
+	uint32_t          qrs_cnt = uint32_t (std::llrint (
+		(alpha2 * double (ctx._y + ctx._qrs_seed)) * sc_mul
+	));
+
+	const __m256i     qrs_inc_8 = _mm256_set1_epi32 (8 * qrs_inc);
+	__m256i           qrs_cnt_8 = _mm256_set1_epi32 (qrs_cnt);
+	const __m256i     qrs_ofs   = _mm256_set_epi32 (
+		qrs_inc * 7, qrs_inc * 6, qrs_inc * 5, qrs_inc * 4,
+		qrs_inc * 3, qrs_inc * 2, qrs_inc    , 0
+	);
+	qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_ofs);
+	const __m256i     qrs_msk   = _mm256_set1_epi32 (0x1FF);
+	const __m256i     c128      = _mm256_set1_epi16 (128);
+	const __m256i     c256      = _mm256_set1_epi16 (256);
+	const __m256i     c384      = _mm256_set1_epi16 (384);
+
+	process_seg_common_int_int_avx2 <
+		S_FLAG, TN_FLAG, DST_FMT, DST_BITS, SRC_FMT, SRC_BITS
+	> (dst_ptr, src_ptr, w, ctx,
+		[&] (int /*pos*/)
+		{
+			auto           p07    = _mm256_srli_epi32 (qrs_cnt_8, qrs_shf);
+			p07 = _mm256_and_si256 (p07, qrs_msk);
+			qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_inc_8);
+			auto           p8f    = _mm256_srli_epi32 (qrs_cnt_8, qrs_shf);
+			p8f = _mm256_and_si256 (p8f, qrs_msk);
+			qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_inc_8);
+			auto           p      = _mm256_packs_epi32 (p07, p8f);
+			p = _mm256_permute4x64_epi64 (p, (0 << 0) + (2 << 2) + (1 << 4) + (3 << 6));
+			const auto     tri_a  = _mm256_sub_epi16 (p, c128);
+			const auto     tri_d  = _mm256_sub_epi16 (c384, p);
+			const auto     cond   = _mm256_cmpgt_epi16 (c256, p);
+			auto           dith_o = _mm256_blendv_epi8 (tri_d, tri_a, cond);
+
+			if (TO_FLAG)
+			{
+				dith_o = remap_tpdf_vec_avx2 (dith_o);
+			}
+
+			return dith_o; // 16 s16 [-128 ; +127] or [-256 ; +255]
+		}
+	);
+}
+
+
+
+template <bool S_FLAG, bool TO_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT>
+void	Dither::process_seg_qrs_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx) noexcept
+{
+	// alpha1 = 1 / x, with x real solution of: x^3 - x - 1 = 0
+	// Also:
+	// alpha1 =   (curt (2) * sq (curt (3)))
+	//          / (curt (9 - sqrt (69)) + curt (9 + sqrt (69)))
+	constexpr double  alpha1  = 1.0 / 1.3247179572447460259609088544781;
+	constexpr double  alpha2  = alpha1 * alpha1;
+	constexpr int     sc_l2   = 16; // 16 bits of fractional values
+	constexpr float   sc_mul  = float (1 << sc_l2);
+	constexpr int     qrs_shf = sc_l2 - 9;
+	constexpr int     qrs_inc = int (alpha1 * sc_mul + 0.5f);
+	uint32_t          qrs_cnt = uint32_t (std::llrint (
+		(alpha2 * double (ctx._y + ctx._qrs_seed)) * sc_mul
+	));
+
+	const __m256i     qrs_inc_8 = _mm256_set1_epi32 (8 * qrs_inc);
+	__m256i           qrs_cnt_8 = _mm256_set1_epi32 (qrs_cnt);
+	const __m256i     qrs_ofs   = _mm256_set_epi32 (
+		qrs_inc * 7, qrs_inc * 6, qrs_inc * 5, qrs_inc * 4,
+		qrs_inc * 3, qrs_inc * 2, qrs_inc    , 0
+	);
+	qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_ofs);
+	const __m256i     qrs_msk   = _mm256_set1_epi32 (0x1FF);
+	const __m256i     c128      = _mm256_set1_epi16 (128);
+	const __m256i     c256      = _mm256_set1_epi16 (256);
+	const __m256i     c384      = _mm256_set1_epi16 (384);
+
+	process_seg_common_flt_int_avx2 <
+		S_FLAG, TN_FLAG, DST_FMT, DST_BITS, SRC_FMT
+	> (dst_ptr, src_ptr, w, ctx,
+		[&] (int /*pos*/)
+		{
+			auto           p07    = _mm256_srli_epi32 (qrs_cnt_8, qrs_shf);
+			p07 = _mm256_and_si256 (p07, qrs_msk);
+			qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_inc_8);
+			auto           p8f    = _mm256_srli_epi32 (qrs_cnt_8, qrs_shf);
+			p8f = _mm256_and_si256 (p8f, qrs_msk);
+			qrs_cnt_8 = _mm256_add_epi32 (qrs_cnt_8, qrs_inc_8);
+			auto           p      = _mm256_packs_epi32 (p07, p8f);
+			p = _mm256_permute4x64_epi64 (p, (0 << 0) + (2 << 2) + (1 << 4) + (3 << 6));
+			const auto     tri_a  = _mm256_sub_epi16 (p, c128);
+			const auto     tri_d  = _mm256_sub_epi16 (c384, p);
+			const auto     cond   = _mm256_cmpgt_epi16 (c256, p);
+			auto           dith_o = _mm256_blendv_epi8 (tri_d, tri_a, cond);
+
+			if (TO_FLAG)
+			{
+				dith_o = remap_tpdf_vec_avx2 (dith_o);
+			}
+
+			return dith_o; // 16 s16 [-128 ; +127]
+		}
+	);
+}
+
+
+
+// __m256i dither_fnc (int pos) noexcept;
+// Must provide the ordered dither values as a vector of 16 x int16_t,
+// in [-128 ; +127] nominal range (doubled for TPDF)
+// The random generator is consumed exactly as in the SSE2 version (per
+// group of 8 pixels), so both paths give bit-identical results.
+template <bool S_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, int SRC_BITS, typename DFNC>
+void	Dither::process_seg_common_int_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx, DFNC dither_fnc) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+
+	constexpr int  dif_bits = SRC_BITS - DST_BITS;
+	static_assert (dif_bits >= 0, "This function cannot increase bidepth.");
+
+	uint32_t &     rnd_state = ctx._rnd_state;
+
+	typedef typename  ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256i  zero      = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit  = _mm256_set1_epi16 (-0x8000);
+	const __m256i  rcst      = _mm256_set1_epi16 (1 << (dif_bits - 1));
+	const __m256i  vmax      = _mm256_set1_epi16 ((1 << DST_BITS) - 1);
+
+	const __m256i  ampo_i    = _mm256_set1_epi16 (int16_t (ctx._amp._o_i)); // 16 ?16 [0 ; 255]
+	const __m256i  ampn_i    = _mm256_set1_epi16 (int16_t (ctx._amp._n_i)); // 16 ?16 [0 ; 255]
+
+	const auto     quantize  = [&] (__m256i s, int pos, int len)
+	{
+		// 16 s16 [-128 ; +127] or [-256 ; 255]
+		__m256i        dith_o = dither_fnc (pos);
+
+		__m256i        dither;
+		if (S_FLAG)
+		{
+			constexpr int  dit_shft = 8 - dif_bits;
+			dither = _mm256_srai_epi16 (dith_o, dit_shft);
+		}
+		else
+		{
+			// Random generation. 16 s16 [-128 ; 127] or [-256 ; 255]
+			__m256i        dith_n =
+				generate_dith_n_vec_avx2 <TN_FLAG> (rnd_state, len);
+
+			dith_o = _mm256_mullo_epi16 (dith_o, ampo_i);   // 16 s16 (full range)
+			dith_n = _mm256_mullo_epi16 (dith_n, ampn_i);   // 16 s16 (full range)
+			dither = _mm256_adds_epi16 (dith_o, dith_n);    // 16 s16 = s8 * s8
+
+			constexpr int  dit_shft = _amp_bits + 8 - dif_bits;
+			dither = _mm256_srai_epi16 (dither, dit_shft);  // 16 s16 = s16 >> cst
+		}
+
+		const __m256i  dith_rcst = _mm256_adds_epi16 (dither, rcst);
+
+		__m256i        quant;
+		if (S_FLAG && SRC_BITS < 16)
+		{
+			__m256i        sum = _mm256_adds_epi16 (s, dith_rcst);
+			quant = _mm256_srai_epi16 (sum, dif_bits);
+		}
+		else
+		{
+			__m256i        sum  = _mm256_xor_si256 (s, sign_bit); // 16 s16
+			sum   = _mm256_adds_epi16 (sum, dith_rcst);
+			sum   = _mm256_xor_si256 (sum, sign_bit);          // 16 u16
+			quant = _mm256_srli_epi16 (sum, dif_bits);
+		}
+
+		__m256i        pix = quant;
+		if (SRC_BITS < 16)
+		{
+			pix = _mm256_max_epi16 (pix, zero);
+			pix = _mm256_min_epi16 (pix, vmax);
+		}
+
+		return pix;
+	};
+
+	const int      w16 = w & -16;
+	const int      w15 = w - w16;
+
+	for (int pos = 0; pos < w16; pos += 16)
+	{
+		const __m256i  s   =	// 16 u16
+			ProxyRwAvx2 <SRC_FMT>::read_i16 (src_n_ptr + pos, zero);
+		const __m256i  pix = quantize (s, pos, 16);
+		ProxyRwAvx2 <DST_FMT>::write_i16 (dst_n_ptr + pos, pix, mask_lsb);
+	}
+
+	if (w15 > 0)
+	{
+		const __m256i  s   = ProxyRwAvx2 <SRC_FMT>::read_i16_partial (
+			src_n_ptr + w16, zero, w15
+		);
+		const __m256i  pix = quantize (s, w16, w15);
+		ProxyRwAvx2 <DST_FMT>::write_i16_partial (
+			dst_n_ptr + w16, pix, mask_lsb, w15
+		);
+	}
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol (rnd_state);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <bool S_FLAG, bool TN_FLAG, SplFmt DST_FMT, int DST_BITS, SplFmt SRC_FMT, typename DFNC>
+void	Dither::process_seg_common_flt_int_avx2 (uint8_t * fstb_RESTRICT dst_ptr, const uint8_t * fstb_RESTRICT src_ptr, int w, SegContext &ctx, DFNC dither_fnc) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (((_mm_getcsr () >> 13) & 3) == 0);   // 00 = Round to nearest (even)
+
+	uint32_t &     rnd_state = ctx._rnd_state;
+
+	const float    qt_cst    = 1.0f / (
+		65536.0f * float (1 << ((S_FLAG ? 0 : _amp_bits) + 8))
+	);
+
+	typedef typename  ProxyRwAvx2 <SRC_FMT>::PtrConst::Type SrcPtr;
+	typedef typename  ProxyRwAvx2 <DST_FMT>::Ptr::Type      DstPtr;
+	SrcPtr         src_n_ptr = reinterpret_cast <SrcPtr> (src_ptr);
+	DstPtr         dst_n_ptr = reinterpret_cast <DstPtr> (dst_ptr);
+	const __m256   zero_f    = _mm256_setzero_ps ();
+	const __m256i  zero_i    = _mm256_setzero_si256 ();
+	const __m256   mul       = _mm256_set1_ps (float (ctx._scale_info_ptr->_gain));
+	const __m256   add       = _mm256_set1_ps (float (ctx._scale_info_ptr->_add_cst));
+	const __m256   qt        = _mm256_set1_ps (qt_cst);
+	const __m256   vmax      = _mm256_set1_ps ((1 << DST_BITS) - 1);
+	const __m256   offset    = _mm256_set1_ps (-32768);
+	const __m256i  mask_lsb  = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit  = _mm256_set1_epi16 (-0x8000);
+
+	const __m256i  ampo_i    = _mm256_set1_epi16 (int16_t (ctx._amp._o_i)); // 16 ?16 [0 ; 255]
+	const __m256i  ampn_i    = _mm256_set1_epi16 (int16_t (ctx._amp._n_i)); // 16 ?16 [0 ; 255]
+
+	const auto     quantize  = [&] (__m256 &s0, __m256 &s1, int pos, int len)
+	{
+		s0 = _mm256_add_ps (_mm256_mul_ps (s0, mul), add);
+		s1 = _mm256_add_ps (_mm256_mul_ps (s1, mul), add);
+
+		// 16 s16 [-128 ; +127] or [-256 ; 255]
+		__m256i        dith_o = dither_fnc (pos);
+
+		__m256i        dither;
+		if (S_FLAG)
+		{
+			dither = dith_o;
+		}
+		else
+		{
+			// Random generation. 16 s16 [-128 ; 127] or [-256 ; 255]
+			__m256i        dith_n =
+				generate_dith_n_vec_avx2 <TN_FLAG> (rnd_state, len);
+
+			dith_o = _mm256_mullo_epi16 (dith_o, ampo_i);   // 16 s16 (full range)
+			dith_n = _mm256_mullo_epi16 (dith_n, ampn_i);   // 16 s16 (full range)
+			dither = _mm256_adds_epi16 (dith_o, dith_n);    // 16 s16 = s8 * s8
+		}
+
+		// 8 s32 << 16
+		__m256i        dither_07i = _mm256_slli_epi32 (
+			_mm256_cvtepi16_epi32 (_mm256_castsi256_si128 (dither)), 16
+		);
+		__m256i        dither_8fi = _mm256_slli_epi32 (
+			_mm256_cvtepi16_epi32 (_mm256_extracti128_si256 (dither, 1)), 16
+		);
+		__m256         dither_07  = _mm256_cvtepi32_ps (dither_07i);
+		__m256         dither_8f  = _mm256_cvtepi32_ps (dither_8fi);
+		dither_07 = _mm256_mul_ps (dither_07, qt);
+		dither_8f = _mm256_mul_ps (dither_8f, qt);
+
+		s0 = _mm256_add_ps (s0, dither_07);
+		s1 = _mm256_add_ps (s1, dither_8f);
+
+		s0 = _mm256_max_ps (_mm256_min_ps (s0, vmax), zero_f);
+		s1 = _mm256_max_ps (_mm256_min_ps (s1, vmax), zero_f);
+	};
+
+	const int      w16 = w & -16;
+	const int      w15 = w - w16;
+
+	for (int pos = 0; pos < w16; pos += 16)
+	{
+		__m256         s0;
+		__m256         s1;
+		ProxyRwAvx2 <SRC_FMT>::read_flt (src_n_ptr + pos, s0, s1, zero_i);
+		quantize (s0, s1, pos, 16);
+		ProxyRwAvx2 <DST_FMT>::write_flt (
+			dst_n_ptr + pos, s0, s1, mask_lsb, sign_bit, offset
+		);
+	}
+
+	if (w15 > 0)
+	{
+		__m256         s0;
+		__m256         s1;
+		ProxyRwAvx2 <SRC_FMT>::read_flt_partial (
+			src_n_ptr + w16, s0, s1, zero_i, w15
+		);
+		quantize (s0, s1, w16, w15);
+		ProxyRwAvx2 <DST_FMT>::write_flt_partial (
+			dst_n_ptr + w16, s0, s1, mask_lsb, sign_bit, offset, w15
+		);
+	}
+
+	if (! S_FLAG)
+	{
+		generate_rnd_eol (rnd_state);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+// len is the number of pixels actually processed, in [1 ; 16].
+// When it doesn't exceed 8, only the first half of the vector is generated
+// so the generator state stays in sync with the SSE2 and C++ versions.
+template <bool T_FLAG>
+__m256i	Dither::generate_dith_n_vec_avx2 (uint32_t &rnd_state, int len) noexcept
+{
+	assert (len > 0);
+	assert (len <= 16);
+
+	uint32_t       rnd [2] [4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+	const int      nbr_grp = (len > 8) ? 2 : 1;
+	const int      nbr_rnd = (T_FLAG) ? 4 : 2;
+	for (int g = 0; g < nbr_grp; ++g)
+	{
+		for (int r = 0; r < nbr_rnd; ++r)
+		{
+			generate_rnd (rnd_state);
+			rnd [g] [r] = rnd_state;
+		}
+	}
+
+	// Bytes 0-7: first group of 8 pixels, bytes 8-15: second one
+	const auto     rnd_val = _mm_set_epi32 (
+		rnd [1] [1], rnd [1] [0], rnd [0] [1], rnd [0] [0]
+	);
+	const auto     x0      = _mm256_cvtepu8_epi16 (rnd_val); // 16 ?16 [0 ; 255]
+
+	if (T_FLAG)
+	{
+		const auto     rnd_x   = _mm_set_epi32 (
+			rnd [1] [3], rnd [1] [2], rnd [0] [3], rnd [0] [2]
+		);
+		const auto     x1      = _mm256_cvtepu8_epi16 (rnd_x);
+		const auto     c256_16 = _mm256_set1_epi16 (0x100);
+		const auto     dith_n  =
+			_mm256_sub_epi16 (_mm256_add_epi16 (x0, x1), c256_16);
+
+		return dith_n; // 16 s16 [-256 ; 255]
+	}
+
+	else
+	{
+		const auto     c128_16 = _mm256_set1_epi16 (0x80);
+		const auto     dith_n  = _mm256_sub_epi16 (x0, c128_16);
+
+		return dith_n; // 16 s16 [-128 ; 127]
+	}
+}
+
+
+
+// d: 16 s16 [-128 ; 127]
+// Returns: 16 s16 [-256 ; 255]
+// See remap_tpdf_vec() for details.
+__m256i	Dither::remap_tpdf_vec_avx2 (__m256i d) noexcept
+{
+	// [-128 ; 127] to [-32767 ; +32767], representing [-1 ; 1] (15-bit scale)
+	auto           x2   = _mm256_mullo_epi16 (d  , d  );
+	x2  = _mm256_adds_epi16 (x2 , x2 ); // Saturated here because of the -min * -min overflow
+	auto           x4   = _mm256_mulhi_epi16 (x2 , x2 );
+	x4  = _mm256_add_epi16 (x4 , x4 );
+	auto           x8   = _mm256_mulhi_epi16 (x4 , x4 );
+	x8  = _mm256_add_epi16 (x8 , x8 );
+	auto           x16  = _mm256_mulhi_epi16 (x8 , x8 );
+	x16 = _mm256_add_epi16 (x16, x16);
+	auto           x32  = _mm256_mulhi_epi16 (x16, x16);
+	x32 = _mm256_add_epi16 (x32, x32);
+
+	// 15-bit scale
+	const auto     c3  = _mm256_set1_epi16 (0x8000 * 5 / 8);
+	const auto     c33 = _mm256_set1_epi16 (0x8000 * 3 / 8);
+
+	// 14-bit scale, losing a bit of precision at each mul
+	auto           sum_s14 = _mm256_mulhi_epi16 (x2, c3);
+	sum_s14 = _mm256_add_epi16 (sum_s14, _mm256_mulhi_epi16 (x32, c33));
+
+	const auto     x_s15   = _mm256_slli_epi16 (d, 8);
+	const auto     sum_s13 = _mm256_mulhi_epi16 (sum_s14, x_s15);
+
+	const auto     sum_s7  = _mm256_srai_epi16 (sum_s13, 13 - 7);
+
+	d = _mm256_add_epi16 (d, sum_s7);
+
+	return d;
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
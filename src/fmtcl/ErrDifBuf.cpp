@@ -40,13 +40,16 @@ namespace fmtcl
 
 
 
-ErrDifBuf::ErrDifBuf (long width)
+ErrDifBuf::ErrDifBuf (long width, int nbr_lanes)
 :	_buf_ptr (0)
 ,/*_mem ()
 ,*/_width (width)
-,	_stride (_width + MARGIN * 2)
+,	_nbr_lanes (nbr_lanes)
+,	_stride ((_width + MARGIN * 2) * nbr_lanes)
 {
 	assert (width > 0);
+	assert (nbr_lanes > 0);
+	assert (nbr_lanes <= MAX_NBR_LANES);
 	const long     buf_len = _stride * MAX_DATA_SIZE * NBR_LINES;
 	_buf_ptr = new uint8_t [buf_len];
 }
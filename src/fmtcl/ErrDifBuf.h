@@ -46,8 +46,9 @@ public:
 	static const int  NBR_LINES     = 2;
 	static const int  MARGIN        = 2;
 	static const int  MAX_DATA_SIZE = 4;
+	static const int  MAX_NBR_LANES = 4;
 
-	explicit       ErrDifBuf (long width);
+	explicit       ErrDifBuf (long width, int nbr_lanes = 1);
 	virtual        ~ErrDifBuf ();
 
 	inline void    clear (int ds);
@@ -73,8 +74,9 @@ protected:
 private:
 
 	uint8_t *      _buf_ptr;   // Currently not aligned with anything
-	uint8_t        _mem [MARGIN * MAX_DATA_SIZE];
+	uint8_t        _mem [MARGIN * MAX_DATA_SIZE * MAX_NBR_LANES];
 	long           _width;
+	int            _nbr_lanes; // Interleaved data, for multi-plane processing
 	long           _stride;
 
 
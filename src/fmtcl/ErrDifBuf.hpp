@@ -42,7 +42,7 @@ void	ErrDifBuf::clear (int ds)
 	assert (ds <= MAX_DATA_SIZE);
 
 	memset (_buf_ptr, 0, _stride * NBR_LINES * ds);
-	for (int m = 0; m < MARGIN * MAX_DATA_SIZE; ++m)
+	for (int m = 0; m < MARGIN * MAX_DATA_SIZE * MAX_NBR_LANES; ++m)
 	{
 		_mem [m] = 0;
 	}
@@ -54,7 +54,7 @@ template <class T>
 void	ErrDifBuf::clear ()
 {
 	memset (_buf_ptr, 0, _stride * NBR_LINES * sizeof (T));
-	for (int k = 0; k < MARGIN; ++k)
+	for (int k = 0; k < MARGIN * _nbr_lanes; ++k)
 	{
 		reinterpret_cast <T *> (&_mem [0]) [k] = 0;
 	}
@@ -68,7 +68,7 @@ T *	ErrDifBuf::get_buf (int ofy)
 	assert (ofy >= 0);
 	assert (ofy < NBR_LINES);
 
-	return (reinterpret_cast <T *> (_buf_ptr) + ofy * _stride + MARGIN);
+	return (reinterpret_cast <T *> (_buf_ptr) + ofy * _stride + MARGIN * _nbr_lanes);
 }
 
 
@@ -77,7 +77,7 @@ template <class T>
 T &	ErrDifBuf::use_mem (int pos)
 {
 	assert (pos >= 0);
-	assert (pos < MARGIN);
+	assert (pos < MARGIN * _nbr_lanes);
 
 	return (reinterpret_cast <T *> (&_mem [0]) [pos]);
 }
@@ -88,7 +88,7 @@ template <class T>
 const T&	ErrDifBuf::use_mem (int pos) const
 {
 	assert (pos >= 0);
-	assert (pos < MARGIN);
+	assert (pos < MARGIN * _nbr_lanes);
 
 	return (reinterpret_cast <const T *> (&_mem [0]) [pos]);
 }
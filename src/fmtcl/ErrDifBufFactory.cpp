@@ -39,10 +39,12 @@ namespace fmtcl
 
 
 
-ErrDifBufFactory::ErrDifBufFactory (long width)
+ErrDifBufFactory::ErrDifBufFactory (long width, int nbr_lanes)
 :	_width (width)
+,	_nbr_lanes (nbr_lanes)
 {
 	assert (width > 0);
+	assert (nbr_lanes > 0);
 }
 
 
@@ -56,7 +58,7 @@ ErrDifBuf *	ErrDifBufFactory::do_create ()
 	ErrDifBuf *    buf_ptr = 0;
 	try
 	{
-		buf_ptr = new ErrDifBuf (_width);
+		buf_ptr = new ErrDifBuf (_width, _nbr_lanes);
 	}
 	catch (...)
 	{
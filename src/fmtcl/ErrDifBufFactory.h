@@ -45,7 +45,7 @@ class ErrDifBufFactory
 
 public:
 
-	explicit       ErrDifBufFactory (long width);
+	explicit       ErrDifBufFactory (long width, int nbr_lanes = 1);
 	virtual        ~ErrDifBufFactory () {}
 
 
@@ -65,6 +65,7 @@ protected:
 private:
 
 	long           _width;
+	int            _nbr_lanes;
 
 
 
@@ -3,9 +3,6 @@
         FilterResize.cpp
         Author: Laurent de Soras, 2011
 
-TO DO:
-	- Merge the initial format conversion with the transpose to avoid a copy
-
 --- Legal stuff ---
 
 This program is free software. It comes without any warranty, to
@@ -60,8 +57,9 @@ namespace fmtcl
 
 
 
-FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag)
-:	_avstp (AvstpWrapper::use_instance ())
+FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag)
+:	_avstp_ref ()
+,	_avstp (AvstpWrapper::use_instance ())
 ,	_task_rsz_pool ()
 /*,	_src_size ()
 ,	_dst_size ()
@@ -76,22 +74,37 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 ,	_center_pos_dst ()*/
 ,	_gain (gain)
 ,	_add_cst (spec._add_cst)
-,	_src_type (src_type)
-,	_src_res (src_res)
-,	_dst_type (dst_type)
-,	_dst_res (dst_res)
+,	_src_type ((src_type == SplFmt_FLOAT16) ? SplFmt_FLOAT : src_type)
+,	_src_res ((src_type == SplFmt_FLOAT16) ? 32 : src_res)
+,	_dst_type ((dst_type == SplFmt_FLOAT16) ? SplFmt_FLOAT : dst_type)
+,	_dst_res ((dst_type == SplFmt_FLOAT16) ? 32 : dst_res)
+,	_src_fp16_flag (src_type == SplFmt_FLOAT16)
+,	_dst_fp16_flag (dst_type == SplFmt_FLOAT16)
 ,	_bd_chg_dir (Dir_H)
 ,	_int_flag (int_flag && _src_type != SplFmt_FLOAT && _dst_type != SplFmt_FLOAT)
 ,	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_perf_simd_rsz (
+		  (! sse2_flag)   ? PerfTrace::Simd_CPP
+		: (_avx512_flag)  ? PerfTrace::Simd_AVX512
+		: (avx2_flag)     ? PerfTrace::Simd_AVX2
+		:                   PerfTrace::Simd_SSE2
+	)
+,	_perf_simd_tr (
+		  (_avx512_flag && ! _int_flag) ? PerfTrace::Simd_AVX512
+		: (_avx512_flag)                ? PerfTrace::Simd_AVX2
+		:                                 _perf_simd_rsz
+	)
 ,	_pool ()
 ,	_factory_uptr ()
 /*,	_crop_pos ()
 ,	_crop_size ()*/
 ,	_scaler_uptr ()
-,	_blitter (sse2_flag, avx2_flag)
-/*,	_resize_flag ()
-,	_roadmap ()
+,	_blitter (sse2_flag, avx2_flag, avx2_flag && avx512_flag)
+/*,	_resize_flag ()*/
+,	_direct_h_flag (false)
+/*,	_roadmap ()
 ,	_tile_size_dst ()*/
 ,	_nbr_passes (0)
 ,	_buf_size (BUF_SIZE)
@@ -177,6 +190,19 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 	vert_last_flag = (vert_last_flag ||   (r_v / r_h > 8 && r_v > 4));
 	vert_last_flag = (vert_last_flag && ! (r_h / r_v > 8 && r_h > 4));
 
+	// The direct horizontal resizing reads the source lines in place and
+	// saves the two transpositions. It requires the vector code and an
+	// output format handled by the Scaler.
+	_direct_h_flag = (
+		   _resize_flag [Dir_H]
+		&& _sse2_flag
+		&& (_dst_type == SplFmt_FLOAT || _dst_type == SplFmt_INT16)
+		&& Scaler::eval_h_efficiency (
+			_dst_size [Dir_H], _win_size [Dir_H],
+			*(_kernel_ptr_arr [Dir_H]), _kernel_scale [Dir_H]
+		)
+	);
+
 	// Builds a roadmap
 	_buffer_flag = false;
 	int					rm_pos = 0;
@@ -185,7 +211,13 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 		_roadmap [rm_pos] = PassType_RESIZE;
 		++ rm_pos;
 	}
-	if (_resize_flag [Dir_H])
+	if (_direct_h_flag)
+	{
+		_buffer_flag = _resize_flag [Dir_V];
+		_roadmap [rm_pos] = PassType_RESIZE_H;
+		++ rm_pos;
+	}
+	else if (_resize_flag [Dir_H])
 	{
 		_buffer_flag = true;
 		_roadmap [rm_pos    ] = PassType_TRANSPOSE;
@@ -310,7 +342,7 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 				}
 
 				// Limits the destination size
-				if (! vert_last_flag)	// If we use a buffer for the last step
+				if (! vert_last_flag && ! _direct_h_flag)	// If we use a buffer for the last step
 				{
 					const double   area_final = double (tile_dst_w) * double (tile_dst_h);
 					assert (area_final > 0);
@@ -400,6 +432,21 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 
 	if (_nbr_passes > 0)
 	{
+		// Bitdepth of the data read by the resizer in charge of the bitdepth
+		// change. Unless it runs the first pass, it reads a buffer which has
+		// been converted to 16 bits. Only a first transposition keeps the
+		// input bitdepth in the buffer, see process_tile_resize().
+		int            bd_chg_src_res = _src_res;
+		const bool     bd_chg_first_flag =
+			   (_roadmap [0] == PassType_RESIZE   && _bd_chg_dir == Dir_V)
+			|| (_roadmap [0] == PassType_RESIZE_H && _bd_chg_dir == Dir_H);
+		if (   ! bd_chg_first_flag
+		    && ! (   _roadmap [0] == PassType_TRANSPOSE
+		          && _src_res > 8 && _src_res < 16))
+		{
+			bd_chg_src_res = 16;
+		}
+
 		for (int dir = 0; dir < Dir_NBR_ELT; ++dir)
 		{
 			assert (_resize_flag [dir] || _bd_chg_dir != dir);
@@ -411,11 +458,13 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 				// When using integer operations, we want to cancel the scaling
 				// intended to change the bitdepth. Indeed, this scaling is
 				// performed by a bitshift in the resizing function.
+				// The gain applies to data already scaled by the previous
+				// passes, but the additive constant is scaled by the bitshift
+				// of the data actually read.
 				if (_int_flag && dir == _bd_chg_dir)
 				{
-					const double   inv_scale = pow (2.0, _src_res - _dst_res);
-					dir_gain *= inv_scale;
-					dir_acst *= inv_scale;
+					dir_gain *= pow (2.0, _src_res       - _dst_res);
+					dir_acst *= pow (2.0, bd_chg_src_res - _dst_res);
 				}
 
 				_scaler_uptr [dir] = std::unique_ptr <Scaler> (new Scaler (
@@ -424,8 +473,13 @@ FilterResize::FilterResize (const ResampleSpecPlane &spec, ContFirInterface &ker
 					*(_kernel_ptr_arr [dir]), _kernel_scale [dir],
 					_norm_flag, _norm_val [dir],
 					_center_pos_src [dir], _center_pos_dst [dir],
-					dir_gain, dir_acst, _int_flag, _sse2_flag, _avx2_flag
+					dir_gain, dir_acst, _int_flag, _sse2_flag, _avx2_flag,
+					_avx512_flag
 				));
+				if (dir == Dir_H && _direct_h_flag)
+				{
+					_scaler_uptr [dir]->setup_h ();
+				}
 			}
 		}
 	}
@@ -440,25 +494,103 @@ void	FilterResize::process_plane (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrd
 	assert (stride_dst > 0);
 	assert (stride_src > 0);
 
+	if (_src_fp16_flag || _dst_fp16_flag)
+	{
+		process_plane_fp16 (
+			dst_ptr, src_ptr, stride_dst, stride_src, chroma_flag
+		);
+	}
+	else
+	{
+		process_plane_dispatch (
+			dst_ptr, src_ptr, stride_dst, stride_src, chroma_flag
+		);
+	}
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	FilterResize::process_plane_dispatch (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag)
+{
+	const int64_t  nbr_pix = int64_t (_dst_size [Dir_H]) * _dst_size [Dir_V];
 	if (_nbr_passes <= 0)
 	{
+		PerfTrace::Scope  perf_scope ("FilterResize.bypass", _perf_simd_rsz, nbr_pix);
 		process_plane_bypass (
 			dst_ptr, src_ptr, stride_dst, stride_src, chroma_flag
 		);
 	}
 	else
 	{
+		PerfTrace::Scope  perf_scope ("FilterResize.plane", _perf_simd_rsz, nbr_pix);
 		process_plane_normal (dst_ptr, src_ptr, stride_dst, stride_src);
 	}
 }
 
 
 
-/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+// Half-float planes are converted to or from temporary float planes, the
+// processing itself is done in float.
+void	FilterResize::process_plane_fp16 (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag)
+{
+	assert (_src_fp16_flag || _dst_fp16_flag);
 
+	// Line lengths are rounded to 64 bytes
+	const auto     calc_stride = [] (int w)
+	{
+		return ptrdiff_t (((w + 15) & ~15) * sizeof (float));
+	};
 
+	Fp16Conv::BufFlt  buf_src;
+	Fp16Conv::BufFlt  buf_dst;
 
-/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+	if (_src_fp16_flag)
+	{
+		const int      w          = _src_size [Dir_H];
+		const int      h          = _src_size [Dir_V];
+		const ptrdiff_t stride_flt = calc_stride (w);
+		buf_src.resize (stride_flt * h / sizeof (float));
+		uint8_t *      buf_ptr    = reinterpret_cast <uint8_t *> (buf_src.data ());
+		_blitter.bitblt (
+			SplFmt_FLOAT  , 32, buf_ptr, stride_flt,
+			SplFmt_FLOAT16, 16, src_ptr, stride_src,
+			w, h
+		);
+		src_ptr    = buf_ptr;
+		stride_src = stride_flt;
+	}
+
+	uint8_t *      dst_fp16_ptr    = dst_ptr;
+	const ptrdiff_t stride_dst_fp16 = stride_dst;
+	if (_dst_fp16_flag)
+	{
+		const int      h = _dst_size [Dir_V];
+		stride_dst = calc_stride (_dst_size [Dir_H]);
+		buf_dst.resize (stride_dst * h / sizeof (float));
+		dst_ptr = reinterpret_cast <uint8_t *> (buf_dst.data ());
+	}
+
+	process_plane_dispatch (
+		dst_ptr, src_ptr, stride_dst, stride_src, chroma_flag
+	);
+
+	if (_dst_fp16_flag)
+	{
+		_blitter.bitblt (
+			SplFmt_FLOAT16, 16, dst_fp16_ptr, stride_dst_fp16,
+			SplFmt_FLOAT  , 32, dst_ptr     , stride_dst,
+			_dst_size [Dir_H], _dst_size [Dir_V]
+		);
+	}
+}
 
 
 
@@ -523,6 +655,7 @@ void	FilterResize::process_plane_normal (uint8_t *dst_ptr, const uint8_t *src_pt
 		_crop_pos [Dir_V] * stride_src + _crop_pos [Dir_H] * trg._src_bpp;
 	trg._stride_dst_pix = stride_dst / trg._dst_bpp;
 	trg._stride_src_pix = stride_src / trg._src_bpp;
+	trg._capture_ptr    = PerfTrace::get_thread_capture ();
 	assert (stride_dst % trg._dst_bpp == 0);
 	assert (stride_src % trg._src_bpp == 0);
 
@@ -635,6 +768,9 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 	const TaskRszGlobal& trg = *(tr._glob_data_ptr);
 	assert (trg._this_ptr == this);
 
+	// The tile may be processed by a pool thread
+	PerfTrace::ThreadLink   perf_link (trg._capture_ptr);
+
 	ResizeData *   rd_ptr = 0;
 	if (_buffer_flag)
 	{
@@ -663,6 +799,17 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 
 	for (int pass = 0; pass < _nbr_passes; ++pass)
 	{
+		// Pixel count: output area of the tile, so the throughputs of all
+		// the passes are comparable.
+		PerfTrace::Scope  perf_scope (
+			  (_roadmap [pass] == PassType_TRANSPOSE) ? "FilterResize.transpose"
+			: (_roadmap [pass] == PassType_RESIZE_H)  ? "FilterResize.resize_h_direct"
+			: (cur_dir == Dir_V)                      ? "FilterResize.resize_v"
+			:                                           "FilterResize.resize_h",
+			(_roadmap [pass] == PassType_TRANSPOSE) ? _perf_simd_tr : _perf_simd_rsz,
+			  int64_t (tr._work_dst [Dir_H]) * tr._work_dst [Dir_V]
+		);
+
 		switch (_roadmap [pass])
 		{
 		case	PassType_RESIZE:
@@ -671,6 +818,12 @@ void	FilterResize::process_tile (TaskRszCell &tr_cell)
 			);
 			break;
 
+		case	PassType_RESIZE_H:
+			process_tile_resize_h (
+				tr, trg, *rd_ptr, stride_buf, pass, cur_buf, cur_size
+			);
+			break;
+
 		case	PassType_TRANSPOSE:
 			if (_int_flag)
 			{
@@ -902,6 +1055,158 @@ void	FilterResize::process_tile_resize (const TaskRsz &tr, const TaskRszGlobal&
 
 
 
+// Horizontal resize of the tile lines, without leaving the vertical
+// orientation (cur_dir == Dir_V).
+void	FilterResize::process_tile_resize_h (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, ptrdiff_t stride_buf [2], const int pass, int &cur_buf, int cur_size [Dir_NBR_ELT])
+{
+	assert (_direct_h_flag);
+
+	const float *     src_flt_ptr = 0;
+	const uint16_t *  src_i16_ptr = 0;
+	const uint8_t *   src_i08_ptr = 0;
+	ptrdiff_t         src_stride  = 0;  // Pixels
+	SplFmt            src_fmt_loc = SplFmt_ILLEGAL;
+	int               src_res_loc = 0;
+
+	float *           dst_flt_ptr = 0;
+	uint16_t *        dst_i16_ptr = 0;
+	ptrdiff_t         dst_stride  = 0;  // Pixels
+	SplFmt            dst_fmt_loc = SplFmt_ILLEGAL;
+
+	// The Scaler works with absolute column positions, so the source pointers
+	// are located on the column 0 of the cropped source.
+
+	// Source is the input
+	if (pass == 0)
+	{
+		const auto     offset_src =
+				trg._offset_crop
+			+ tr._src_beg [Dir_V] * trg._stride_src;
+
+		const uint8_t *  src_ofs_ptr = trg._src_ptr + offset_src;
+
+		src_flt_ptr = reinterpret_cast <const float *> (src_ofs_ptr);
+		src_i16_ptr = reinterpret_cast <const uint16_t *> (src_ofs_ptr);
+		src_i08_ptr = src_ofs_ptr;
+		src_stride  = trg._stride_src_pix;
+		src_fmt_loc = _src_type;
+		src_res_loc = _src_res;
+	}
+
+	// Source is a buffer
+	else
+	{
+		assert (_buffer_flag);
+
+		const auto     offset_src = -tr._src_beg [Dir_H];
+		src_flt_ptr = rd.use_buf <const float> (cur_buf) + offset_src;
+		src_i16_ptr = rd.use_buf <uint16_t   > (cur_buf) + offset_src;
+		src_stride  = stride_buf [cur_buf];
+		src_fmt_loc = (_int_flag) ? SplFmt_INT16 : SplFmt_FLOAT;
+		src_res_loc = (_int_flag) ? 16           : 32;
+	}
+
+	// Destination is a buffer
+	if (has_buf_dst (pass))
+	{
+		assert (_buffer_flag);
+
+		const int      dst_buf = (pass == 0) ? cur_buf : 1 - cur_buf;
+		stride_buf [dst_buf] =
+			(tr._work_dst [Dir_H] + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
+		assert (cur_size [Dir_V] * stride_buf [dst_buf] <= _buf_size);
+
+		dst_flt_ptr = rd.use_buf <float   > (dst_buf);
+		dst_i16_ptr = rd.use_buf <uint16_t> (dst_buf);
+		dst_stride  = stride_buf [dst_buf];
+		dst_fmt_loc = (_int_flag) ? SplFmt_INT16 : SplFmt_FLOAT;
+
+		cur_buf = dst_buf;
+	}
+
+	// Destination is the output
+	else
+	{
+		assert (cur_size [Dir_V] == tr._work_dst [Dir_V]);
+
+		const auto     offset_dst =
+			  tr._dst_beg [Dir_V] * trg._stride_dst
+			+ tr._dst_beg [Dir_H] * trg._dst_bpp;
+
+		uint8_t *      dst_ofs_ptr = trg._dst_ptr + offset_dst;
+
+		dst_flt_ptr = reinterpret_cast <float *> (dst_ofs_ptr);
+		dst_i16_ptr = reinterpret_cast <uint16_t *> (dst_ofs_ptr);
+		dst_stride  = trg._stride_dst_pix;
+		dst_fmt_loc = _dst_type;
+	}
+
+#define fmtc_FilterResize_PROC_HF(DF, DP, SF, SP) \
+	case	((SplFmt_##DF << 2) + SplFmt_##SF): \
+		_scaler_uptr [Dir_H]->process_plane_h_flt ( \
+			dst_##DP##_ptr, \
+			src_##SP##_ptr, \
+			dst_stride, \
+			src_stride, \
+			cur_size [Dir_V], \
+			tr._dst_beg [Dir_H], \
+			tr._dst_beg [Dir_H] + tr._work_dst [Dir_H] \
+		); \
+		break;
+
+#define fmtc_FilterResize_PROC_HI(DF, DP, SF, SP, SB, FN) \
+	case	((fmtc_FilterResize_SHORT_BD (SB) << 4) + (SplFmt_##DF << 2) + SplFmt_##SF): \
+		_scaler_uptr [Dir_H]->process_plane_h_int_##FN ( \
+			dst_##DP##_ptr, \
+			src_##SP##_ptr, \
+			dst_stride, \
+			src_stride, \
+			cur_size [Dir_V], \
+			tr._dst_beg [Dir_H], \
+			tr._dst_beg [Dir_H] + tr._work_dst [Dir_H] \
+		); \
+		break;
+
+	if (_int_flag)
+	{
+		switch (  (fmtc_FilterResize_SHORT_BD (src_res_loc) << 4)
+		        + (dst_fmt_loc << 2) + src_fmt_loc)
+		{
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT16  , i16, 16, i16_i16)
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT16  , i16, 14, i16_i14)
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT16  , i16, 12, i16_i12)
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT16  , i16, 10, i16_i10)
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT16  , i16,  9, i16_i09)
+		fmtc_FilterResize_PROC_HI (INT16  , i16, INT8   , i08,  8, i16_i08)
+		default:
+			assert (false);
+			throw std::logic_error ("Unexpected pixel format (int)");
+		}
+	}
+	else
+	{
+		switch ((dst_fmt_loc << 2) + src_fmt_loc)
+		{
+		fmtc_FilterResize_PROC_HF (FLOAT  , flt, FLOAT  , flt)
+		fmtc_FilterResize_PROC_HF (FLOAT  , flt, INT16  , i16)
+		fmtc_FilterResize_PROC_HF (FLOAT  , flt, INT8   , i08)
+		fmtc_FilterResize_PROC_HF (INT16  , i16, FLOAT  , flt)
+		fmtc_FilterResize_PROC_HF (INT16  , i16, INT16  , i16)
+		fmtc_FilterResize_PROC_HF (INT16  , i16, INT8   , i08)
+		default:
+			assert (false);
+			throw std::logic_error ("Unexpected pixel format (flt)");
+		}
+	}
+
+#undef fmtc_FilterResize_PROC_HF
+#undef fmtc_FilterResize_PROC_HI
+
+	cur_size [Dir_H] = tr._work_dst [Dir_H];
+}
+
+
+
 template <typename T, SplFmt BUFT>
 void	FilterResize::process_tile_transpose (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, ptrdiff_t stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT])
 {
@@ -951,34 +1256,50 @@ void	FilterResize::process_tile_transpose (const TaskRsz &tr, const TaskRszGloba
 		}
 	}
 
-	// Preliminary pass: converts input in buffer type if required
+	// Transposition. The input is converted to the buffer type on the fly,
+	// if required.
 	if (! src_buf_flag && _src_type != BUFT)
 	{
-		stride_src =
-			(cur_size [Dir_H] + Scaler::SRC_ALIGN - 1) & -Scaler::SRC_ALIGN;
-		assert (cur_size [Dir_V] * stride_src <= _buf_size);
+		const uint8_t *   src_ofs_ptr = trg._src_ptr + offset_src;
 
-		_blitter.bitblt (
-			BUFT, int (sizeof (T) * CHAR_BIT),
-			rd.use_buf <uint8_t> (cur_buf),
-			stride_src * sizeof (T),
-			_src_type, _src_res,
-			trg._src_ptr + offset_src,
-			trg._stride_src,
+		switch (_src_type)
+		{
+		case	SplFmt_INT16:
+			transpose (
+				ptr_dst,
+				reinterpret_cast <const uint16_t *> (src_ofs_ptr),
+				cur_size [Dir_H], cur_size [Dir_V],
+				stride_dst,
+				trg._stride_src_pix
+			);
+			break;
+
+		case	SplFmt_INT8:
+			transpose (
+				ptr_dst,
+				src_ofs_ptr,
+				cur_size [Dir_H], cur_size [Dir_V],
+				stride_dst,
+				trg._stride_src_pix
+			);
+			break;
+
+		default:
+			assert (false);
+			break;
+		}
+	}
+	else
+	{
+		transpose (
+			ptr_dst,
+			ptr_src,
 			cur_size [Dir_H], cur_size [Dir_V],
-			0
+			stride_dst,
+			stride_src
 		);
 	}
 
-	// Transposition
-	transpose (
-		ptr_dst,
-		ptr_src,
-		cur_size [Dir_H], cur_size [Dir_V],
-		stride_dst,
-		stride_src
-	);
-
 	cur_dir = (cur_dir == Dir_V) ? Dir_H : Dir_V;
 	std::swap (cur_size [Dir_H], cur_size [Dir_V]);
 
@@ -1002,9 +1323,69 @@ void	FilterResize::process_tile_transpose (const TaskRsz &tr, const TaskRszGloba
 
 
 
+// Pixel conversions from the input format to the buffer format, same
+// results as the BitBltConv conversions without scaling.
+static inline void	FilterResize_conv_pix (float &dst, float src)
+{
+	dst = src;
+}
+
+static inline void	FilterResize_conv_pix (float &dst, uint16_t src)
+{
+	dst = float (src);
+}
+
+static inline void	FilterResize_conv_pix (float &dst, uint8_t src)
+{
+	dst = float (src);
+}
+
+static inline void	FilterResize_conv_pix (uint16_t &dst, uint16_t src)
+{
+	dst = src;
+}
+
+static inline void	FilterResize_conv_pix (uint16_t &dst, uint8_t src)
+{
+	dst = uint16_t (src << 8);
+}
+
+
+
 // w and h are related to the source.
-template <typename T>
-void	FilterResize::transpose (T *dst_ptr, const T *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+// The source data is converted to the destination type.
+template <typename TD, typename TS>
+void	FilterResize::transpose (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (h > 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != nullptr);
+	assert (stride_dst > 0);
+
+	// Cache-blocked traversal: the picture is split into square super-blocks,
+	// small enough to keep both the source and destination lines in the L1
+	// cache. Because TRANSP_SBLK is a multiple of all the SIMD block sizes,
+	// partial blocks are found only on the right and bottom super-blocks.
+	for (int y = 0; y < h; y += TRANSP_SBLK)
+	{
+		const int      hs = std::min (h - y, int (TRANSP_SBLK));
+		for (int x = 0; x < w; x += TRANSP_SBLK)
+		{
+			const int      ws = std::min (w - x, int (TRANSP_SBLK));
+			transpose_sblk (
+				dst_ptr + x * stride_dst + y, src_ptr + y * stride_src + x,
+				ws, hs, stride_dst, stride_src
+			);
+		}
+	}
+}
+
+
+
+template <typename TD, typename TS>
+void	FilterResize::transpose_sblk (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
 {
 	assert (src_ptr != nullptr);
 	assert (w > 0);
@@ -1014,7 +1395,36 @@ void	FilterResize::transpose (T *dst_ptr, const T *src_ptr, int w, int h, ptrdif
 	assert (stride_dst > 0);
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-	if (_sse2_flag)
+	if (_avx2_flag)
+	{
+		// The AVX2 code handles only full blocks, the remaining stripes on the
+		// right and at the bottom are processed with SSE2.
+		const int      blk = int (32 / sizeof (TD));
+		const int      wb  = w & -blk;
+		const int      hb  = h & -blk;
+		if (hb > 0)
+		{
+			if (wb > 0)
+			{
+				transpose_avx (dst_ptr, src_ptr, wb, hb, stride_dst, stride_src);
+			}
+			if (wb < w)
+			{
+				transpose_sse2 (
+					dst_ptr + wb * stride_dst, src_ptr + wb,
+					w - wb, hb, stride_dst, stride_src
+				);
+			}
+		}
+		if (hb < h)
+		{
+			transpose_sse2 (
+				dst_ptr + hb, src_ptr + hb * stride_src,
+				w, h - hb, stride_dst, stride_src
+			);
+		}
+	}
+	else if (_sse2_flag)
 	{
 		transpose_sse2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
 	}
@@ -1027,8 +1437,8 @@ void	FilterResize::transpose (T *dst_ptr, const T *src_ptr, int w, int h, ptrdif
 
 
 
-template <typename T>
-void	FilterResize::transpose_cpp (T *dst_ptr, const T *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+template <typename TD, typename TS>
+void	FilterResize::transpose_cpp (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
 {
 	assert (src_ptr != nullptr);
 	assert (w > 0);
@@ -1039,11 +1449,11 @@ void	FilterResize::transpose_cpp (T *dst_ptr, const T *src_ptr, int w, int h, pt
 
 	for (int y = 0; y < h; ++y)
 	{
-		T *            dst_2_ptr = dst_ptr + y;
+		TD *           dst_2_ptr = dst_ptr + y;
 
 		for (int x = 0; x < w; ++x)
 		{
-			*dst_2_ptr = src_ptr [x];
+			FilterResize_conv_pix (*dst_2_ptr, src_ptr [x]);
 			dst_2_ptr += stride_dst;
 		}
 
@@ -1055,7 +1465,84 @@ void	FilterResize::transpose_cpp (T *dst_ptr, const T *src_ptr, int w, int h, pt
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 
-void	FilterResize::transpose_sse2 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+// Loads 8 pixels and converts them to float
+static fstb_FORCEINLINE void	FilterResize_load_8_flt_sse2 (__m128 &lo, __m128 &hi, const float *ptr, const __m128i &/*zero*/)
+{
+	lo = _mm_loadu_ps (ptr    );
+	hi = _mm_loadu_ps (ptr + 4);
+}
+
+static fstb_FORCEINLINE void	FilterResize_load_8_flt_sse2 (__m128 &lo, __m128 &hi, const uint16_t *ptr, const __m128i &zero)
+{
+	const __m128i  src = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr));
+	lo = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (src, zero));
+	hi = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (src, zero));
+}
+
+static fstb_FORCEINLINE void	FilterResize_load_8_flt_sse2 (__m128 &lo, __m128 &hi, const uint8_t *ptr, const __m128i &zero)
+{
+	const __m128i  src = _mm_unpacklo_epi8 (
+		_mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr)), zero
+	);
+	lo = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (src, zero));
+	hi = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (src, zero));
+}
+
+
+
+// Loads 8 pixels and converts them to 16 bits
+static fstb_FORCEINLINE __m128i	FilterResize_load_8_i16_sse2 (const uint16_t *ptr, const __m128i &/*zero*/)
+{
+	return (_mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr)));
+}
+
+static fstb_FORCEINLINE __m128i	FilterResize_load_8_i16_sse2 (const uint8_t *ptr, const __m128i &zero)
+{
+	return (_mm_unpacklo_epi8 (
+		zero, _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr))
+	));
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_transpose_4x4_sse2 (__m128 &a0, __m128 &a1, __m128 &a2, __m128 &a3)
+{
+	const __m128   b0 = _mm_shuffle_ps (a0, a1, 0x44);
+	const __m128   b2 = _mm_shuffle_ps (a0, a1, 0xEE);
+	const __m128   b1 = _mm_shuffle_ps (a2, a3, 0x44);
+	const __m128   b3 = _mm_shuffle_ps (a2, a3, 0xEE);
+
+	a0 = _mm_shuffle_ps (b0, b1, 0x88);
+	a1 = _mm_shuffle_ps (b0, b1, 0xDD);
+	a2 = _mm_shuffle_ps (b2, b3, 0x88);
+	a3 = _mm_shuffle_ps (b2, b3, 0xDD);
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_store_4x4_sse2 (float *dst_ptr, ptrdiff_t stride_dst, __m128 a0, __m128 a1, __m128 a2, __m128 a3, bool dst_align_flag)
+{
+	if (dst_align_flag)
+	{
+		_mm_store_ps (dst_ptr                 , a0);
+		_mm_store_ps (dst_ptr + stride_dst    , a1);
+		_mm_store_ps (dst_ptr + stride_dst * 2, a2);
+		_mm_store_ps (dst_ptr + stride_dst * 3, a3);
+	}
+	else
+	{
+		_mm_storeu_ps (dst_ptr                 , a0);
+		_mm_storeu_ps (dst_ptr + stride_dst    , a1);
+		_mm_storeu_ps (dst_ptr + stride_dst * 2, a2);
+		_mm_storeu_ps (dst_ptr + stride_dst * 3, a3);
+	}
+}
+
+
+
+// Processes blocks of 8x4 source pixels, as two 4x4 transpositions
+template <typename TS>
+void	FilterResize::transpose_sse2 (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
 {
 	assert (src_ptr != nullptr);
 	assert (w > 0);
@@ -1064,56 +1551,53 @@ void	FilterResize::transpose_sse2 (float *dst_ptr, const float *src_ptr, int w,
 	assert (dst_ptr != nullptr);
 	assert (stride_dst > 0);
 
-	const int      w4 = w & -4;
-	const int      w3 = w - w4;
+	const int      w8 = w & -8;
+	const int      w7 = w - w8;
 	const int      h4 = h & -4;
 	const int      h3 = h - h4;
 
+	const __m128i  zero = _mm_setzero_si128 ();
 	const bool     dst_align_flag =
-		((reinterpret_cast <ptrdiff_t> (dst_ptr) & 15) == 0);
+		(   (reinterpret_cast <ptrdiff_t> (dst_ptr) & 15) == 0
+		 && (stride_dst & 3) == 0);
 
 	for (int y = 0; y < h4; y += 4)
 	{
 		float *        dst_2_ptr = dst_ptr + y;
 
-		for (int x = 0; x < w4; x += 4)
+		for (int x = 0; x < w8; x += 8)
 		{
-			__m128         a0 = _mm_loadu_ps (src_ptr                  + x);
-			__m128         a1 = _mm_loadu_ps (src_ptr + stride_src     + x);
-			__m128         a2 = _mm_loadu_ps (src_ptr + stride_src * 2 + x);
-			__m128         a3 = _mm_loadu_ps (src_ptr + stride_src * 3 + x);
-
-			const __m128   b0 = _mm_shuffle_ps (a0, a1, 0x44);
-			const __m128   b2 = _mm_shuffle_ps (a0, a1, 0xEE);
-			const __m128   b1 = _mm_shuffle_ps (a2, a3, 0x44);
-			const __m128   b3 = _mm_shuffle_ps (a2, a3, 0xEE);
-
-			a0 = _mm_shuffle_ps (b0, b1, 0x88);
-			a1 = _mm_shuffle_ps (b0, b1, 0xDD);
-			a2 = _mm_shuffle_ps (b2, b3, 0x88);
-			a3 = _mm_shuffle_ps (b2, b3, 0xDD);
-
-			if (dst_align_flag)
-			{
-				_mm_store_ps (dst_2_ptr                 , a0);
-				_mm_store_ps (dst_2_ptr + stride_dst    , a1);
-				_mm_store_ps (dst_2_ptr + stride_dst * 2, a2);
-				_mm_store_ps (dst_2_ptr + stride_dst * 3, a3);
-			}
-			else
-			{
-				_mm_storeu_ps (dst_2_ptr                 , a0);
-				_mm_storeu_ps (dst_2_ptr + stride_dst    , a1);
-				_mm_storeu_ps (dst_2_ptr + stride_dst * 2, a2);
-				_mm_storeu_ps (dst_2_ptr + stride_dst * 3, a3);
-			}
+			__m128         a0;
+			__m128         a1;
+			__m128         a2;
+			__m128         a3;
+			__m128         e0;
+			__m128         e1;
+			__m128         e2;
+			__m128         e3;
+			FilterResize_load_8_flt_sse2 (a0, e0, src_ptr                  + x, zero);
+			FilterResize_load_8_flt_sse2 (a1, e1, src_ptr + stride_src     + x, zero);
+			FilterResize_load_8_flt_sse2 (a2, e2, src_ptr + stride_src * 2 + x, zero);
+			FilterResize_load_8_flt_sse2 (a3, e3, src_ptr + stride_src * 3 + x, zero);
+
+			FilterResize_transpose_4x4_sse2 (a0, a1, a2, a3);
+			FilterResize_transpose_4x4_sse2 (e0, e1, e2, e3);
+
+			FilterResize_store_4x4_sse2 (
+				dst_2_ptr                 , stride_dst, a0, a1, a2, a3,
+				dst_align_flag
+			);
+			FilterResize_store_4x4_sse2 (
+				dst_2_ptr + stride_dst * 4, stride_dst, e0, e1, e2, e3,
+				dst_align_flag
+			);
 
-			dst_2_ptr += stride_dst * 4;
+			dst_2_ptr += stride_dst * 8;
 		}
 
-		if (w3 > 0)
+		if (w7 > 0)
 		{
-			transpose_cpp (dst_2_ptr, src_ptr + w4, w3, 4, stride_dst, stride_src);
+			transpose_cpp (dst_2_ptr, src_ptr + w8, w7, 4, stride_dst, stride_src);
 		}
 
 		src_ptr += stride_src * 4;
@@ -1127,7 +1611,8 @@ void	FilterResize::transpose_sse2 (float *dst_ptr, const float *src_ptr, int w,
 
 
 
-void	FilterResize::transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+template <typename TS>
+void	FilterResize::transpose_sse2 (uint16_t *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
 {
 	assert (src_ptr != nullptr);
 	assert (w > 0);
@@ -1141,8 +1626,10 @@ void	FilterResize::transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, i
 	const int      h8 = h & -8;
 	const int      h7 = h - h8;
 
+	const __m128i  zero = _mm_setzero_si128 ();
 	const bool     dst_align_flag =
-		((reinterpret_cast <ptrdiff_t> (dst_ptr) & 15) == 0);
+		(   (reinterpret_cast <ptrdiff_t> (dst_ptr) & 15) == 0
+		 && (stride_dst & 7) == 0);
 
 	for (int y = 0; y < h8; y += 8)
 	{
@@ -1153,14 +1640,14 @@ void	FilterResize::transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, i
 			// Based on a piece of code published by Stephen Thomas
 			// http://stackoverflow.com/questions/2517584/transpose-for-8-registers-of-16-bit-elements-on-sse2-ssse3
 
-			const __m128i a = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr                  + x));
-			const __m128i b = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src     + x));
-			const __m128i c = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 2 + x));
-			const __m128i d = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 3 + x));
-			const __m128i e = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 4 + x));
-			const __m128i f = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 5 + x));
-			const __m128i g = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 6 + x));
-			const __m128i i = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr + stride_src * 7 + x));
+			const __m128i a = FilterResize_load_8_i16_sse2 (src_ptr                  + x, zero);
+			const __m128i b = FilterResize_load_8_i16_sse2 (src_ptr + stride_src     + x, zero);
+			const __m128i c = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 2 + x, zero);
+			const __m128i d = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 3 + x, zero);
+			const __m128i e = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 4 + x, zero);
+			const __m128i f = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 5 + x, zero);
+			const __m128i g = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 6 + x, zero);
+			const __m128i i = FilterResize_load_8_i16_sse2 (src_ptr + stride_src * 7 + x, zero);
 
 			const __m128i a03b03 = _mm_unpacklo_epi16 (a, b);
 			const __m128i c03d03 = _mm_unpacklo_epi16 (c, d);
@@ -1229,6 +1716,59 @@ void	FilterResize::transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, i
 	}
 }
 
+
+
+// w and h must be multiples of 8.
+// AVX-512 processes the 16x16 blocks, AVX2 the remaining 8-pixel stripes.
+template <typename TS>
+void	FilterResize::transpose_avx (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	assert ((w & 7) == 0);
+	assert ((h & 7) == 0);
+
+	int            wb = 0;
+	int            hb = 0;
+	if (_avx512_flag)
+	{
+		wb = w & -16;
+		hb = h & -16;
+		if (wb > 0 && hb > 0)
+		{
+			transpose_avx512 (dst_ptr, src_ptr, wb, hb, stride_dst, stride_src);
+		}
+		else
+		{
+			wb = 0;
+			hb = 0;
+		}
+	}
+
+	if (wb < w && hb > 0)
+	{
+		transpose_avx2 (
+			dst_ptr + wb * stride_dst, src_ptr + wb,
+			w - wb, hb, stride_dst, stride_src
+		);
+	}
+	if (hb < h)
+	{
+		transpose_avx2 (
+			dst_ptr + hb, src_ptr + hb * stride_src,
+			w, h - hb, stride_dst, stride_src
+		);
+	}
+}
+
+
+
+// w and h must be multiples of 16.
+// There is no AVX-512 version yet.
+template <typename TS>
+void	FilterResize::transpose_avx (uint16_t *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	transpose_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
 #endif
 
 
@@ -1304,6 +1844,17 @@ void	FilterResize::compute_req_src_tile_size (int &tw, int &th, int dw, int dh)
 			);
 			break;
 
+		case	PassType_RESIZE_H:
+			tw = Scaler::eval_lower_bound_of_src_tile_height (
+				tw,
+				_dst_size [Dir_H],
+				_win_size [Dir_H],
+				*(_kernel_ptr_arr [Dir_H]),
+				_kernel_scale [Dir_H],
+				_src_size [Dir_H]
+			);
+			break;
+
 		case	PassType_TRANSPOSE:
 			std::swap (tw, th);
 			cur_dir = (cur_dir == Dir_V) ? Dir_H : Dir_V;
@@ -30,6 +30,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fstb/def.h"
 #include "conc/ObjPool.h"
 #include "fmtcl/BitBltConv.h"
+#include "fmtcl/Fp16Conv.h"
+#include "fmtcl/PerfTrace.h"
 #include "fmtcl/SplFmt.h"
 #include "fmtcl/ResizeData.h"
 #include "fmtcl/ResizeDataFactory.h"
@@ -70,7 +72,7 @@ public:
 
 	typedef	FilterResize	ThisType;
 
-	explicit       FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag);
+	explicit       FilterResize (const ResampleSpecPlane &spec, ContFirInterface &kernel_fnc_h, ContFirInterface &kernel_fnc_v, bool norm_flag, double norm_val_h, double norm_val_v, double gain, SplFmt src_type, int src_res, SplFmt dst_type, int dst_res, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag);
 	virtual        ~FilterResize () {}
 
 	void           process_plane (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag);
@@ -91,6 +93,7 @@ private:
 	{
 		PassType_NONE = 0,
 		PassType_RESIZE,
+		PassType_RESIZE_H,               // Horizontal resize without transposition
 		PassType_TRANSPOSE,
 
 		PassType_NBR_ELT
@@ -99,6 +102,7 @@ private:
 	static const int  MAX_NBR_PASSES = 4;                 // 2 * (transpose + resize)
 	static const int  BUF_SIZE       = 65536;             // Number of pixels (float or int16_t)
 	static const int  MAX_BUF_SIZE   = BUF_SIZE * 1024;   // Number of pixels (float or int16_t)
+	static const int  TRANSP_SBLK    = 32;                // Super-block size for the transpositions, in pixels. Multiple of all SIMD block sizes
 
 	class TaskRszGlobal
 	{
@@ -114,6 +118,8 @@ private:
 		ptrdiff_t      _offset_crop;    // Bytes
 		ptrdiff_t      _stride_dst_pix; // Pixels
 		ptrdiff_t      _stride_src_pix; // Pixels
+		PerfTrace::FrameCapture *       // Capture of the calling thread, may be 0
+		               _capture_ptr;
 	};
 
 	class TaskRsz
@@ -129,23 +135,46 @@ private:
 
 	typedef	conc::LockFreeCell <TaskRsz>	TaskRszCell;
 
+	void           process_plane_dispatch (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag);
 	void           process_plane_bypass (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag);
 	void           process_plane_normal (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           process_plane_fp16 (uint8_t *dst_ptr, const uint8_t *src_ptr, ptrdiff_t stride_dst, ptrdiff_t stride_src, bool chroma_flag);
 	void           process_tile (TaskRszCell &tr_cell);
 	void           process_tile_resize (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, ptrdiff_t stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT]);
+	void           process_tile_resize_h (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, ptrdiff_t stride_buf [2], const int pass, int &cur_buf, int cur_size [Dir_NBR_ELT]);
 
 	template <typename T, SplFmt BUFT>
 	void           process_tile_transpose (const TaskRsz &tr, const TaskRszGlobal& trg, ResizeData &rd, ptrdiff_t stride_buf [2], const int pass, Dir &cur_dir, int &cur_buf, int cur_size [Dir_NBR_ELT]);
 
-	template <typename T>
-	void           transpose (T *dst_ptr, const T *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	template <typename TD, typename TS>
+	void           transpose (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
 
-	template <typename T>
-	void           transpose_cpp (T *dst_ptr, const T *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	template <typename TD, typename TS>
+	void           transpose_sblk (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+
+	template <typename TD, typename TS>
+	void           transpose_cpp (TD *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
-	void           transpose_sse2 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
-	void           transpose_sse2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	template <typename TS>
+	void           transpose_sse2 (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	template <typename TS>
+	void           transpose_sse2 (uint16_t *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+
+	void           transpose_avx2 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx2 (float *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx2 (float *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx2 (uint16_t *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+
+	template <typename TS>
+	void           transpose_avx (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	template <typename TS>
+	void           transpose_avx (uint16_t *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+
+	void           transpose_avx512 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx512 (float *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
+	void           transpose_avx512 (float *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src);
 #endif
 
 	bool           is_kernel_neutral (Dir di) const;
@@ -156,6 +185,8 @@ private:
 
 	static void    redirect_task_resize (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
 
+	AvstpWrapper::PoolRef
+	               _avstp_ref;
 	AvstpWrapper & _avstp;
 	conc::CellPool <TaskRsz>
 	               _task_rsz_pool;
@@ -178,10 +209,17 @@ private:
 	int            _src_res;
 	SplFmt         _dst_type;
 	int            _dst_res;
+	bool           _src_fp16_flag;   // Half-float planes are converted and processed as float. _src_type and _dst_type are set to float in this case.
+	bool           _dst_fp16_flag;
 	Dir            _bd_chg_dir;      // The resizer in charge of the bitdepth conversion.
 	bool           _int_flag;        // Use 16-bit int as temporary data instead of float, if possible
 	bool           _sse2_flag;
 	bool           _avx2_flag;
+	bool           _avx512_flag;     // AVX-512F and BW. Transpositions and vertical resizing only
+	PerfTrace::Simd                  // Paths reported by the performance traces
+	               _perf_simd_rsz;
+	PerfTrace::Simd
+	               _perf_simd_tr;
 
 	conc::ObjPool <ResizeData>
 						_pool;
@@ -196,6 +234,7 @@ private:
 	BitBltConv     _blitter;
 
 	bool           _resize_flag [Dir_NBR_ELT];
+	bool           _direct_h_flag;   // Horizontal resize with PassType_RESIZE_H instead of transpositions
 	PassType       _roadmap [MAX_NBR_PASSES];
 	int            _tile_size_dst [Dir_NBR_ELT];
 	int            _nbr_passes;      // 0 = bypass
@@ -0,0 +1,314 @@
+/*****************************************************************************
+
+        FilterResize_avx2.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX2 in order to avoid SSE/AVX state switch
+slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fmtcl/FilterResize.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+// Loads 8 pixels and converts them to float
+static fstb_FORCEINLINE __m256	FilterResize_load_8_flt_avx2 (const float *ptr)
+{
+	return (_mm256_loadu_ps (ptr));
+}
+
+static fstb_FORCEINLINE __m256	FilterResize_load_8_flt_avx2 (const uint16_t *ptr)
+{
+	return (_mm256_cvtepi32_ps (_mm256_cvtepu16_epi32 (
+		_mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr))
+	)));
+}
+
+static fstb_FORCEINLINE __m256	FilterResize_load_8_flt_avx2 (const uint8_t *ptr)
+{
+	return (_mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (
+		_mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr))
+	)));
+}
+
+
+
+// Loads 16 pixels and converts them to 16 bits
+static fstb_FORCEINLINE __m256i	FilterResize_load_16_i16_avx2 (const uint16_t *ptr)
+{
+	return (_mm256_loadu_si256 (reinterpret_cast <const __m256i *> (ptr)));
+}
+
+static fstb_FORCEINLINE __m256i	FilterResize_load_16_i16_avx2 (const uint8_t *ptr)
+{
+	return (_mm256_slli_epi16 (_mm256_cvtepu8_epi16 (
+		_mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr))
+	), 8));
+}
+
+
+
+// w and h must be multiples of 8.
+template <typename TS>
+static void	FilterResize_transpose_flt_avx2 (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (h > 0);
+	assert ((w & 7) == 0);
+	assert ((h & 7) == 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != nullptr);
+	assert (stride_dst > 0);
+
+	for (int y = 0; y < h; y += 8)
+	{
+		float *        dst_2_ptr = dst_ptr + y;
+
+		for (int x = 0; x < w; x += 8)
+		{
+			const TS *     s_ptr = src_ptr + x;
+			const __m256   a0 = FilterResize_load_8_flt_avx2 (s_ptr                 );
+			const __m256   a1 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src    );
+			const __m256   a2 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 2);
+			const __m256   a3 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 3);
+			const __m256   a4 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 4);
+			const __m256   a5 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 5);
+			const __m256   a6 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 6);
+			const __m256   a7 = FilterResize_load_8_flt_avx2 (s_ptr + stride_src * 7);
+
+			const __m256   b0 = _mm256_unpacklo_ps (a0, a1);
+			const __m256   b1 = _mm256_unpackhi_ps (a0, a1);
+			const __m256   b2 = _mm256_unpacklo_ps (a2, a3);
+			const __m256   b3 = _mm256_unpackhi_ps (a2, a3);
+			const __m256   b4 = _mm256_unpacklo_ps (a4, a5);
+			const __m256   b5 = _mm256_unpackhi_ps (a4, a5);
+			const __m256   b6 = _mm256_unpacklo_ps (a6, a7);
+			const __m256   b7 = _mm256_unpackhi_ps (a6, a7);
+
+			const __m256   c0 = _mm256_shuffle_ps (b0, b2, 0x44);
+			const __m256   c1 = _mm256_shuffle_ps (b0, b2, 0xEE);
+			const __m256   c2 = _mm256_shuffle_ps (b1, b3, 0x44);
+			const __m256   c3 = _mm256_shuffle_ps (b1, b3, 0xEE);
+			const __m256   c4 = _mm256_shuffle_ps (b4, b6, 0x44);
+			const __m256   c5 = _mm256_shuffle_ps (b4, b6, 0xEE);
+			const __m256   c6 = _mm256_shuffle_ps (b5, b7, 0x44);
+			const __m256   c7 = _mm256_shuffle_ps (b5, b7, 0xEE);
+
+			_mm256_storeu_ps (dst_2_ptr                 , _mm256_permute2f128_ps (c0, c4, 0x20));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst    , _mm256_permute2f128_ps (c1, c5, 0x20));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 2, _mm256_permute2f128_ps (c2, c6, 0x20));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 3, _mm256_permute2f128_ps (c3, c7, 0x20));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 4, _mm256_permute2f128_ps (c0, c4, 0x31));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 5, _mm256_permute2f128_ps (c1, c5, 0x31));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 6, _mm256_permute2f128_ps (c2, c6, 0x31));
+			_mm256_storeu_ps (dst_2_ptr + stride_dst * 7, _mm256_permute2f128_ps (c3, c7, 0x31));
+
+			dst_2_ptr += stride_dst * 8;
+		}
+
+		src_ptr += stride_src * 8;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+static fstb_FORCEINLINE void	FilterResize_store_16_i16_avx2 (uint16_t *ptr, __m256i val)
+{
+	_mm256_storeu_si256 (reinterpret_cast <__m256i *> (ptr), val);
+}
+
+
+
+// Transposes two 8x8 blocks, one in each lane.
+// Output register k contains the columns k and k + 8 of the source rows.
+static fstb_FORCEINLINE void	FilterResize_transpose_8x8x2_i16_avx2 (__m256i &a, __m256i &b, __m256i &c, __m256i &d, __m256i &e, __m256i &f, __m256i &g, __m256i &i)
+{
+	const __m256i  a03b03 = _mm256_unpacklo_epi16 (a, b);
+	const __m256i  c03d03 = _mm256_unpacklo_epi16 (c, d);
+	const __m256i  e03f03 = _mm256_unpacklo_epi16 (e, f);
+	const __m256i  g03i03 = _mm256_unpacklo_epi16 (g, i);
+	const __m256i  a47b47 = _mm256_unpackhi_epi16 (a, b);
+	const __m256i  c47d47 = _mm256_unpackhi_epi16 (c, d);
+	const __m256i  e47f47 = _mm256_unpackhi_epi16 (e, f);
+	const __m256i  g47i47 = _mm256_unpackhi_epi16 (g, i);
+
+	const __m256i  a01b01c01d01 = _mm256_unpacklo_epi32 (a03b03, c03d03);
+	const __m256i  a23b23c23d23 = _mm256_unpackhi_epi32 (a03b03, c03d03);
+	const __m256i  e01f01g01i01 = _mm256_unpacklo_epi32 (e03f03, g03i03);
+	const __m256i  e23f23g23i23 = _mm256_unpackhi_epi32 (e03f03, g03i03);
+	const __m256i  a45b45c45d45 = _mm256_unpacklo_epi32 (a47b47, c47d47);
+	const __m256i  a67b67c67d67 = _mm256_unpackhi_epi32 (a47b47, c47d47);
+	const __m256i  e45f45g45i45 = _mm256_unpacklo_epi32 (e47f47, g47i47);
+	const __m256i  e67f67g67i67 = _mm256_unpackhi_epi32 (e47f47, g47i47);
+
+	a = _mm256_unpacklo_epi64 (a01b01c01d01, e01f01g01i01);
+	b = _mm256_unpackhi_epi64 (a01b01c01d01, e01f01g01i01);
+	c = _mm256_unpacklo_epi64 (a23b23c23d23, e23f23g23i23);
+	d = _mm256_unpackhi_epi64 (a23b23c23d23, e23f23g23i23);
+	e = _mm256_unpacklo_epi64 (a45b45c45d45, e45f45g45i45);
+	f = _mm256_unpackhi_epi64 (a45b45c45d45, e45f45g45i45);
+	g = _mm256_unpacklo_epi64 (a67b67c67d67, e67f67g67i67);
+	i = _mm256_unpackhi_epi64 (a67b67c67d67, e67f67g67i67);
+}
+
+
+
+// w and h must be multiples of 16.
+template <typename TS>
+static void	FilterResize_transpose_i16_avx2 (uint16_t *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (h > 0);
+	assert ((w & 15) == 0);
+	assert ((h & 15) == 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != nullptr);
+	assert (stride_dst > 0);
+
+	for (int y = 0; y < h; y += 16)
+	{
+		uint16_t *     dst_2_ptr = dst_ptr + y;
+
+		for (int x = 0; x < w; x += 16)
+		{
+			// Rows 0-7 in the r0x registers, rows 8-15 in the r1x registers
+			const TS *     s0_ptr = src_ptr + x;
+			const TS *     s1_ptr = s0_ptr + stride_src * 8;
+			__m256i        r00 = FilterResize_load_16_i16_avx2 (s0_ptr                 );
+			__m256i        r01 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src    );
+			__m256i        r02 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 2);
+			__m256i        r03 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 3);
+			__m256i        r04 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 4);
+			__m256i        r05 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 5);
+			__m256i        r06 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 6);
+			__m256i        r07 = FilterResize_load_16_i16_avx2 (s0_ptr + stride_src * 7);
+			__m256i        r10 = FilterResize_load_16_i16_avx2 (s1_ptr                 );
+			__m256i        r11 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src    );
+			__m256i        r12 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 2);
+			__m256i        r13 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 3);
+			__m256i        r14 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 4);
+			__m256i        r15 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 5);
+			__m256i        r16 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 6);
+			__m256i        r17 = FilterResize_load_16_i16_avx2 (s1_ptr + stride_src * 7);
+
+			FilterResize_transpose_8x8x2_i16_avx2 (r00, r01, r02, r03, r04, r05, r06, r07);
+			FilterResize_transpose_8x8x2_i16_avx2 (r10, r11, r12, r13, r14, r15, r16, r17);
+
+			uint16_t *     d0_ptr = dst_2_ptr;
+			uint16_t *     d1_ptr = d0_ptr + stride_dst * 8;
+			FilterResize_store_16_i16_avx2 (d0_ptr                 , _mm256_permute2x128_si256 (r00, r10, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst    , _mm256_permute2x128_si256 (r01, r11, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 2, _mm256_permute2x128_si256 (r02, r12, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 3, _mm256_permute2x128_si256 (r03, r13, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 4, _mm256_permute2x128_si256 (r04, r14, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 5, _mm256_permute2x128_si256 (r05, r15, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 6, _mm256_permute2x128_si256 (r06, r16, 0x20));
+			FilterResize_store_16_i16_avx2 (d0_ptr + stride_dst * 7, _mm256_permute2x128_si256 (r07, r17, 0x20));
+			FilterResize_store_16_i16_avx2 (d1_ptr                 , _mm256_permute2x128_si256 (r00, r10, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst    , _mm256_permute2x128_si256 (r01, r11, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 2, _mm256_permute2x128_si256 (r02, r12, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 3, _mm256_permute2x128_si256 (r03, r13, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 4, _mm256_permute2x128_si256 (r04, r14, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 5, _mm256_permute2x128_si256 (r05, r15, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 6, _mm256_permute2x128_si256 (r06, r16, 0x31));
+			FilterResize_store_16_i16_avx2 (d1_ptr + stride_dst * 7, _mm256_permute2x128_si256 (r07, r17, 0x31));
+
+			dst_2_ptr += stride_dst * 16;
+		}
+
+		src_ptr += stride_src * 16;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// The AVX2 transpositions process only full blocks: w and h must be
+// multiples of 8 for float and 16 for uint16_t.
+void	FilterResize::transpose_avx2 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx2 (float *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx2 (float *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx2 (uint16_t *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_i16_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx2 (uint16_t *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_i16_avx2 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
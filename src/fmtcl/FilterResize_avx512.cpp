@@ -0,0 +1,188 @@
+/*****************************************************************************
+
+        FilterResize_avx512.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX512 (AVX-512F is enough) in order to avoid
+SSE/AVX state switch slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fstb/ToolsAvx512.h"
+#include "fmtcl/FilterResize.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+// Loads 16 pixels and converts them to float
+static fstb_FORCEINLINE __m512	FilterResize_load_16_flt_avx512 (const float *ptr)
+{
+	return (_mm512_loadu_ps (ptr));
+}
+
+static fstb_FORCEINLINE __m512	FilterResize_load_16_flt_avx512 (const uint16_t *ptr)
+{
+	return (_mm512_cvtepi32_ps (_mm512_cvtepu16_epi32 (
+		_mm256_loadu_si256 (reinterpret_cast <const __m256i *> (ptr))
+	)));
+}
+
+static fstb_FORCEINLINE __m512	FilterResize_load_16_flt_avx512 (const uint8_t *ptr)
+{
+	return (_mm512_cvtepi32_ps (_mm512_cvtepu8_epi32 (
+		_mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr))
+	)));
+}
+
+
+
+// Transposes the 4x4 matrix of 128-bit lanes made of a0-a3 and stores the
+// resulting rows. Lane l of register g goes to lane g of output row l.
+static fstb_FORCEINLINE void	FilterResize_transpose_store_4x4_lanes_avx512 (float *dst_ptr, ptrdiff_t stride_dst, __m512 a0, __m512 a1, __m512 a2, __m512 a3)
+{
+	const __m512   b0 = _mm512_shuffle_f32x4 (a0, a1, 0x44);
+	const __m512   b1 = _mm512_shuffle_f32x4 (a0, a1, 0xEE);
+	const __m512   b2 = _mm512_shuffle_f32x4 (a2, a3, 0x44);
+	const __m512   b3 = _mm512_shuffle_f32x4 (a2, a3, 0xEE);
+
+	_mm512_storeu_ps (dst_ptr                 , _mm512_shuffle_f32x4 (b0, b2, 0x88));
+	_mm512_storeu_ps (dst_ptr + stride_dst    , _mm512_shuffle_f32x4 (b0, b2, 0xDD));
+	_mm512_storeu_ps (dst_ptr + stride_dst * 2, _mm512_shuffle_f32x4 (b1, b3, 0x88));
+	_mm512_storeu_ps (dst_ptr + stride_dst * 3, _mm512_shuffle_f32x4 (b1, b3, 0xDD));
+}
+
+
+
+// w and h must be multiples of 16.
+template <typename TS>
+static void	FilterResize_transpose_flt_avx512 (float *dst_ptr, const TS *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	assert (src_ptr != nullptr);
+	assert (w > 0);
+	assert (h > 0);
+	assert ((w & 15) == 0);
+	assert ((h & 15) == 0);
+	assert (stride_src > 0);
+	assert (dst_ptr != nullptr);
+	assert (stride_dst > 0);
+
+	for (int y = 0; y < h; y += 16)
+	{
+		float *        dst_2_ptr = dst_ptr + y;
+
+		for (int x = 0; x < w; x += 16)
+		{
+			// 4x4 transpositions within each 128-bit lane, one group of 4 rows
+			// at a time. Lane l of c[g*4+k] contains column l*4+k of the
+			// source rows g*4 to g*4+3.
+			__m512         c [16];
+			const TS *     s_ptr = src_ptr + x;
+			for (int g = 0; g < 16; g += 4)
+			{
+				const __m512   a0 = FilterResize_load_16_flt_avx512 (s_ptr                 );
+				const __m512   a1 = FilterResize_load_16_flt_avx512 (s_ptr + stride_src    );
+				const __m512   a2 = FilterResize_load_16_flt_avx512 (s_ptr + stride_src * 2);
+				const __m512   a3 = FilterResize_load_16_flt_avx512 (s_ptr + stride_src * 3);
+
+				const __m512   b0 = _mm512_unpacklo_ps (a0, a1);
+				const __m512   b1 = _mm512_unpackhi_ps (a0, a1);
+				const __m512   b2 = _mm512_unpacklo_ps (a2, a3);
+				const __m512   b3 = _mm512_unpackhi_ps (a2, a3);
+
+				c [g    ] = _mm512_shuffle_ps (b0, b2, 0x44);
+				c [g + 1] = _mm512_shuffle_ps (b0, b2, 0xEE);
+				c [g + 2] = _mm512_shuffle_ps (b1, b3, 0x44);
+				c [g + 3] = _mm512_shuffle_ps (b1, b3, 0xEE);
+
+				s_ptr += stride_src * 4;
+			}
+
+			// Now gathers the lanes. Output row l*4+k is made of the lanes l
+			// of c[k], c[k+4], c[k+8] and c[k+12].
+			for (int k = 0; k < 4; ++k)
+			{
+				FilterResize_transpose_store_4x4_lanes_avx512 (
+					dst_2_ptr + k * stride_dst, stride_dst * 4,
+					c [k], c [k + 4], c [k + 8], c [k + 12]
+				);
+			}
+
+			dst_2_ptr += stride_dst * 16;
+		}
+
+		src_ptr += stride_src * 16;
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// The AVX-512 transpositions process only full 16x16 blocks: w and h must
+// be multiples of 16.
+void	FilterResize::transpose_avx512 (float *dst_ptr, const float *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx512 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx512 (float *dst_ptr, const uint16_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx512 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+void	FilterResize::transpose_avx512 (float *dst_ptr, const uint8_t *src_ptr, int w, int h, ptrdiff_t stride_dst, ptrdiff_t stride_src)
+{
+	FilterResize_transpose_flt_avx512 (dst_ptr, src_ptr, w, h, stride_dst, stride_src);
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,235 @@
+/*****************************************************************************
+
+        Fp16Conv.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Fp16Conv.h"
+#include "fstb/CpuId.h"
+#include "fstb/fnc.h"
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fstb/ToolsSse2.h"
+	#include <emmintrin.h>
+#endif
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+Fp16Conv::Fp16Conv (bool sse2_flag, bool avx2_flag) noexcept
+{
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	if (sse2_flag)
+	{
+		_to_flt_ptr  = &conv_to_flt_sse2;
+		_to_fp16_ptr = &conv_to_fp16_sse2;
+	}
+	if (avx2_flag && fstb::CpuId ()._f16c_flag)
+	{
+		_to_flt_ptr  = &conv_to_flt_avx2;
+		_to_fp16_ptr = &conv_to_fp16_avx2;
+	}
+#else
+	fstb::unused (sse2_flag, avx2_flag);
+#endif
+}
+
+
+
+void	Fp16Conv::conv_to_flt (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) const noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (nbr_spl > 0);
+
+	_to_flt_ptr (dst_ptr, src_ptr, nbr_spl);
+}
+
+
+
+void	Fp16Conv::conv_to_fp16 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) const noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (nbr_spl > 0);
+
+	_to_fp16_ptr (dst_ptr, src_ptr, nbr_spl);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	Fp16Conv::conv_to_flt_cpp (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_flt (src_ptr [pos]);
+	}
+}
+
+
+
+void	Fp16Conv::conv_to_fp16_cpp (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_fp16 (src_ptr [pos]);
+	}
+}
+
+
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// Same algorithm as conv_spl_to_flt(), 8 samples at once.
+// The remaining samples are converted with the scalar code.
+void	Fp16Conv::conv_to_flt_sse2 (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept
+{
+	const __m128i  zero      = _mm_setzero_si128 ();
+	const __m128i  mask_abs  = _mm_set1_epi32 (0x7FFF);
+	const __m128i  mask_sign = _mm_set1_epi32 (0x8000);
+	const __m128i  exp_mask  = _mm_set1_epi32 (0x7C00 << 13);
+	const __m128i  rebias    = _mm_set1_epi32 ((127 - 15) << 23);
+	const __m128i  dnz_exp   = _mm_set1_epi32 (1 << 23);
+	const __m128   magic_dnz = _mm_set1_ps (1.0f / (1 << 14));
+
+	const auto     conv_4 = [&] (__m128i h)
+	{
+		__m128i        u      = _mm_slli_epi32 (_mm_and_si128 (h, mask_abs), 13);
+		const __m128i  e      = _mm_and_si128 (u, exp_mask);
+		const __m128i  inf_m  = _mm_cmpeq_epi32 (e, exp_mask);
+		const __m128i  dnz_m  = _mm_cmpeq_epi32 (e, zero);
+		u = _mm_add_epi32 (u, rebias);
+		u = _mm_add_epi32 (u, _mm_and_si128 (inf_m, rebias));
+		u = _mm_add_epi32 (u, _mm_and_si128 (dnz_m, dnz_exp));
+		__m128         f      = _mm_castsi128_ps (u);
+		f = _mm_sub_ps (f, _mm_and_ps (_mm_castsi128_ps (dnz_m), magic_dnz));
+		const __m128i  sign   = _mm_slli_epi32 (_mm_and_si128 (h, mask_sign), 16);
+		return _mm_or_ps (f, _mm_castsi128_ps (sign));
+	};
+
+	const int      nbr_spl_m8 = nbr_spl & ~7;
+	for (int pos = 0; pos < nbr_spl_m8; pos += 8)
+	{
+		const __m128i  h = _mm_loadu_si128 (
+			reinterpret_cast <const __m128i *> (src_ptr + pos)
+		);
+		_mm_storeu_ps (dst_ptr + pos    , conv_4 (_mm_unpacklo_epi16 (h, zero)));
+		_mm_storeu_ps (dst_ptr + pos + 4, conv_4 (_mm_unpackhi_epi16 (h, zero)));
+	}
+
+	for (int pos = nbr_spl_m8; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_flt (src_ptr [pos]);
+	}
+}
+
+
+
+// Same algorithm as conv_spl_to_fp16(), 8 samples at once.
+void	Fp16Conv::conv_to_fp16_sse2 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept
+{
+	const __m128i  one       = _mm_set1_epi32 (1);
+	const __m128i  mask_abs  = _mm_set1_epi32 (0x7FFFFFFF);
+	const __m128i  mask_sign = _mm_set1_epi32 (int (0x80000000U));
+	const __m128i  infty_f   = _mm_set1_epi32 (0xFF << 23);
+	const __m128i  max_f_m1  = _mm_set1_epi32 (((127 + 16) << 23) - 1);
+	const __m128i  dnz_lim   = _mm_set1_epi32 ((127 - 14) << 23);
+	const __m128i  dnz_bits  = _mm_set1_epi32 ((127 -  1) << 23);
+	const __m128i  rebias    = _mm_set1_epi32 (int ((uint32_t (15 - 127) << 23) + 0xFFF));
+	const __m128i  h_inf     = _mm_set1_epi32 (0x7C00);
+	const __m128i  h_qnan    = _mm_set1_epi32 (0x0200);
+	const __m128   half      = _mm_set1_ps (0.5f);
+
+	const auto     conv_4 = [&] (__m128 f)
+	{
+		const __m128i  x      = _mm_castps_si128 (f);
+		const __m128i  sign   = _mm_srli_epi32 (_mm_and_si128 (x, mask_sign), 16);
+		const __m128i  u      = _mm_and_si128 (x, mask_abs);
+
+		const __m128i  odd    = _mm_and_si128 (_mm_srli_epi32 (u, 13), one);
+		const __m128i  h_nrm  = _mm_srli_epi32 (
+			_mm_add_epi32 (_mm_add_epi32 (u, rebias), odd), 13
+		);
+		const __m128   f_dnz  = _mm_add_ps (_mm_castsi128_ps (u), half);
+		const __m128i  h_dnz  = _mm_sub_epi32 (_mm_castps_si128 (f_dnz), dnz_bits);
+		const __m128i  nan_m  = _mm_cmpgt_epi32 (u, infty_f);
+		const __m128i  h_spc  = _mm_or_si128 (h_inf, _mm_and_si128 (nan_m, h_qnan));
+
+		const __m128i  ovf_m  = _mm_cmpgt_epi32 (u, max_f_m1);
+		const __m128i  dnz_m  = _mm_cmpgt_epi32 (dnz_lim, u);
+		__m128i        h      = fstb::ToolsSse2::select (dnz_m, h_dnz, h_nrm);
+		h = fstb::ToolsSse2::select (ovf_m, h_spc, h);
+		h = _mm_or_si128 (h, sign);
+
+		// Sign-extends the 16-bit values so the saturated packing keeps them
+		return _mm_srai_epi32 (_mm_slli_epi32 (h, 16), 16);
+	};
+
+	const int      nbr_spl_m8 = nbr_spl & ~7;
+	for (int pos = 0; pos < nbr_spl_m8; pos += 8)
+	{
+		const __m128i  h_03 = conv_4 (_mm_loadu_ps (src_ptr + pos    ));
+		const __m128i  h_47 = conv_4 (_mm_loadu_ps (src_ptr + pos + 4));
+		_mm_storeu_si128 (
+			reinterpret_cast <__m128i *> (dst_ptr + pos),
+			_mm_packs_epi32 (h_03, h_47)
+		);
+	}
+
+	for (int pos = nbr_spl_m8; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_fp16 (src_ptr [pos]);
+	}
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,130 @@
+/*****************************************************************************
+
+        Fp16Conv.h
+        Author: Laurent de Soras, 2024
+
+Conversions between IEEE 754 half-precision (SplFmt_FLOAT16) and single
+precision floating point data.
+
+Half-float planes are generally not processed as is. The engines convert
+them to float on input and back to half on output, so the rest of the
+processing remains the same as for the 32-bit float data.
+
+Conversion to half rounds to the nearest value, ties to even. Values out of
+the half range become infinities, NaN are kept as quiet NaN. Denormals are
+supported in both directions. All the code paths give exactly the same
+results, NaN payloads excepted.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_Fp16Conv_HEADER_INCLUDED)
+#define fmtcl_Fp16Conv_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fstb/AllocAlign.h"
+
+#include <vector>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+class Fp16Conv
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	// Temporary storage for the converted data
+	typedef std::vector <float, fstb::AllocAlign <float, 64> > BufFlt;
+
+	// The AVX2 path requires the F16C instructions too, they are checked
+	// here.
+	explicit       Fp16Conv (bool sse2_flag, bool avx2_flag) noexcept;
+	               Fp16Conv (const Fp16Conv &other) = default;
+	               ~Fp16Conv () = default;
+	Fp16Conv &     operator = (const Fp16Conv &other) = default;
+
+	void           conv_to_flt (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) const noexcept;
+	void           conv_to_fp16 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) const noexcept;
+
+	static inline float
+	               conv_spl_to_flt (uint16_t x) noexcept;
+	static inline uint16_t
+	               conv_spl_to_fp16 (float x) noexcept;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	typedef void (*ToFltPtr) (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl);
+	typedef void (*ToFp16Ptr) (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl);
+
+	static void    conv_to_flt_cpp (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept;
+	static void    conv_to_fp16_cpp (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	static void    conv_to_flt_sse2 (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept;
+	static void    conv_to_fp16_sse2 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept;
+	static void    conv_to_flt_avx2 (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept;
+	static void    conv_to_fp16_avx2 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept;
+#endif   // fstb_ARCHI_X86
+
+	ToFltPtr       _to_flt_ptr  = &conv_to_flt_cpp;
+	ToFp16Ptr      _to_fp16_ptr = &conv_to_fp16_cpp;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               Fp16Conv ()                               = delete;
+	bool           operator == (const Fp16Conv &other) const = delete;
+	bool           operator != (const Fp16Conv &other) const = delete;
+
+}; // class Fp16Conv
+
+
+
+}  // namespace fmtcl
+
+
+
+#include "fmtcl/Fp16Conv.hpp"
+
+
+
+#endif   // fmtcl_Fp16Conv_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
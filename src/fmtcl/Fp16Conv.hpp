@@ -0,0 +1,127 @@
+/*****************************************************************************
+
+        Fp16Conv.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_Fp16Conv_CODEHEADER_INCLUDED)
+#define fmtcl_Fp16Conv_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cstring>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Moves the exponent and mantissa to their float positions, then rebiases
+// the exponent. Denormals are normalised with a float subtraction, and
+// Inf/NaN get the maximum exponent.
+float	Fp16Conv::conv_spl_to_flt (uint16_t x) noexcept
+{
+	constexpr uint32_t   exp_mask_f = 0x7C00U << 13;
+	constexpr float      magic_dnz  = 1.0f / (1 << 14); // 2^-14
+
+	uint32_t       u   = uint32_t (x & 0x7FFF) << 13;
+	const uint32_t e   = u & exp_mask_f;
+	u += uint32_t (127 - 15) << 23;
+	float          f;
+	if (e == exp_mask_f)
+	{
+		u += uint32_t (128 - 16) << 23;
+		memcpy (&f, &u, sizeof (f));
+	}
+	else if (e == 0)
+	{
+		u += uint32_t (1) << 23;
+		memcpy (&f, &u, sizeof (f));
+		f -= magic_dnz;
+	}
+	else
+	{
+		memcpy (&f, &u, sizeof (f));
+	}
+
+	return (x & 0x8000) ? -f : f;
+}
+
+
+
+// The rounding of the normal values is done on the integer representation.
+// Denormal results are rounded by a float addition with a magic value
+// aligning the half LSB on the float LSB.
+uint16_t	Fp16Conv::conv_spl_to_fp16 (float x) noexcept
+{
+	constexpr uint32_t   infty_f  = 0xFFU << 23;
+	constexpr uint32_t   max_f    = uint32_t (127 + 16) << 23; // 65536
+	constexpr uint32_t   dnz_lim  = uint32_t (127 - 14) << 23; // 2^-14
+	constexpr uint32_t   dnz_bits = uint32_t (127 -  1) << 23; // 0.5
+
+	uint32_t       u;
+	memcpy (&u, &x, sizeof (u));
+	const uint32_t sign = (u >> 16) & 0x8000;
+	u &= 0x7FFFFFFFU;
+
+	uint32_t       h;
+	if (u >= max_f)
+	{
+		h = (u > infty_f) ? 0x7E00 : 0x7C00;
+	}
+	else if (u < dnz_lim)
+	{
+		float          f;
+		memcpy (&f, &u, sizeof (f));
+		f += 0.5f;
+		memcpy (&u, &f, sizeof (u));
+		h = u - dnz_bits;
+	}
+	else
+	{
+		const uint32_t odd = (u >> 13) & 1;
+		u += (uint32_t (15 - 127) << 23) + 0xFFF + odd;
+		h = u >> 13;
+	}
+
+	return uint16_t (h | sign);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}  // namespace fmtcl
+
+
+
+#endif   // fmtcl_Fp16Conv_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,105 @@
+/*****************************************************************************
+
+        Fp16Conv_avx2.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX2 in order to avoid SSE/AVX state switch
+slowdown. The conversions use the F16C instructions, GCC and Clang require
+-mf16c in addition to -mavx2.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Fp16Conv.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	Fp16Conv::conv_to_flt_avx2 (float dst_ptr [], const uint16_t src_ptr [], int nbr_spl) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+
+	const int      nbr_spl_m8 = nbr_spl & ~7;
+	for (int pos = 0; pos < nbr_spl_m8; pos += 8)
+	{
+		const __m128i  h = _mm_loadu_si128 (
+			reinterpret_cast <const __m128i *> (src_ptr + pos)
+		);
+		_mm256_storeu_ps (dst_ptr + pos, _mm256_cvtph_ps (h));
+	}
+
+	for (int pos = nbr_spl_m8; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_flt (src_ptr [pos]);
+	}
+}
+
+
+
+void	Fp16Conv::conv_to_fp16_avx2 (uint16_t dst_ptr [], const float src_ptr [], int nbr_spl) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+
+	const int      nbr_spl_m8 = nbr_spl & ~7;
+	for (int pos = 0; pos < nbr_spl_m8; pos += 8)
+	{
+		const __m256   f = _mm256_loadu_ps (src_ptr + pos);
+		_mm_storeu_si128 (
+			reinterpret_cast <__m128i *> (dst_ptr + pos),
+			_mm256_cvtps_ph (f, _MM_FROUND_TO_NEAREST_INT)
+		);
+	}
+
+	for (int pos = nbr_spl_m8; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = conv_spl_to_fp16 (src_ptr [pos]);
+	}
+}
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
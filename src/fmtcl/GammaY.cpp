@@ -29,12 +29,19 @@ http://www.wtfpl.net/ for more details.
 #include "fstb/def.h"
 #include "fstb/fnc.h"
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fstb/ToolsSse2.h"
+	#include <emmintrin.h>
+#endif
+
 #include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <type_traits>
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 
 
 
@@ -43,11 +50,158 @@ namespace fmtcl
 
 
 
-constexpr inline int	GammaY_encode (SplFmt src_fmt, SplFmt src_dst, bool flt_flag, int shft) noexcept
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// Loads 4 integer pixels as 16-bit values in the lower half of the register
+static fstb_FORCEINLINE __m128i	GammaY_load_4_u16_sse2 (const uint8_t *ptr) noexcept
+{
+	int32_t        tmp;
+	memcpy (&tmp, ptr, sizeof (tmp));
+
+	return _mm_unpacklo_epi8 (_mm_cvtsi32_si128 (tmp), _mm_setzero_si128 ());
+}
+
+static fstb_FORCEINLINE __m128i	GammaY_load_4_u16_sse2 (const uint16_t *ptr) noexcept
+{
+	return _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr));
+}
+
+// Loads 4 integer pixels as 32-bit values
+template <typename T>
+static fstb_FORCEINLINE __m128i	GammaY_load_4_s32_sse2 (const T *ptr) noexcept
 {
-	return (src_fmt << 11) + (src_dst << 8) + (shft << 1) + (flt_flag ? 1 : 0);
+	return _mm_unpacklo_epi16 (GammaY_load_4_u16_sse2 (ptr), _mm_setzero_si128 ());
 }
 
+// Loads 4 pixels as float
+static fstb_FORCEINLINE __m128	GammaY_load_4_f32_sse2 (const float *ptr) noexcept
+{
+	return _mm_loadu_ps (ptr);
+}
+
+template <typename T>
+static fstb_FORCEINLINE __m128	GammaY_load_4_f32_sse2 (const T *ptr) noexcept
+{
+	return _mm_cvtepi32_ps (GammaY_load_4_s32_sse2 (ptr));
+}
+
+// Clips the 32-bit values to [0 ; 65535] and stores them
+static fstb_FORCEINLINE void	GammaY_store_4_sse2 (uint16_t *ptr, __m128i val) noexcept
+{
+	const __m128i  bias_s32 = _mm_set1_epi32 (0x8000);
+	const __m128i  bias_s16 = _mm_set1_epi16 (-0x8000);
+	val = _mm_andnot_si128 (_mm_srai_epi32 (val, 31), val);
+	val = _mm_sub_epi32 (val, bias_s32);
+	val = _mm_packs_epi32 (val, val);
+	val = _mm_xor_si128 (val, bias_s16);
+	_mm_storel_epi64 (reinterpret_cast <__m128i *> (ptr), val);
+}
+
+static fstb_FORCEINLINE void	GammaY_store_4_sse2 (uint16_t *ptr, __m128 val) noexcept
+{
+	GammaY_store_4_sse2 (ptr, _mm_cvtps_epi32 (val));
+}
+
+static fstb_FORCEINLINE void	GammaY_store_4_sse2 (float *ptr, __m128 val) noexcept
+{
+	_mm_storeu_ps (ptr, val);
+}
+
+
+
+// Luma from float RGB. len is a multiple of 4.
+template <int CRES>
+static void	GammaY_compute_luma_sse2 (float *luma_ptr, const float *r_ptr, const float *g_ptr, const float *b_ptr, int len, float c_r, float c_g, float c_b) noexcept
+{
+	const __m128   cr = _mm_set1_ps (c_r);
+	const __m128   cg = _mm_set1_ps (c_g);
+	const __m128   cb = _mm_set1_ps (c_b);
+
+	for (int x = 0; x < len; x += 4)
+	{
+		const __m128   r = GammaY_load_4_f32_sse2 (r_ptr + x);
+		const __m128   g = GammaY_load_4_f32_sse2 (g_ptr + x);
+		const __m128   b = GammaY_load_4_f32_sse2 (b_ptr + x);
+		const __m128   l = _mm_add_ps (
+			_mm_add_ps (_mm_mul_ps (r, cr), _mm_mul_ps (g, cg)),
+			_mm_mul_ps (b, cb)
+		);
+		_mm_store_ps (luma_ptr + x, l);
+	}
+}
+
+// Luma from integer RGB, coefficients with CRES fractional bits.
+template <int CRES, typename TS>
+static void	GammaY_compute_luma_sse2 (uint16_t *luma_ptr, const TS *r_ptr, const TS *g_ptr, const TS *b_ptr, int len, int c_r, int c_g, int c_b) noexcept
+{
+	const __m128i  cr   = _mm_set1_epi32 (c_r);
+	const __m128i  cg   = _mm_set1_epi32 (c_g);
+	const __m128i  cb   = _mm_set1_epi32 (c_b);
+	const __m128i  bias = _mm_set1_epi32 (1 << (CRES - 1));
+
+	for (int x = 0; x < len; x += 4)
+	{
+		const __m128i  r = GammaY_load_4_s32_sse2 (r_ptr + x);
+		const __m128i  g = GammaY_load_4_s32_sse2 (g_ptr + x);
+		const __m128i  b = GammaY_load_4_s32_sse2 (b_ptr + x);
+		__m128i        l = _mm_add_epi32 (
+			_mm_add_epi32 (
+				fstb::ToolsSse2::mullo_epi32 (r, cr),
+				fstb::ToolsSse2::mullo_epi32 (g, cg)
+			),
+			fstb::ToolsSse2::mullo_epi32 (b, cb)
+		);
+		l = _mm_srai_epi32 (_mm_add_epi32 (l, bias), CRES);
+		GammaY_store_4_sse2 (luma_ptr + x, l);
+	}
+}
+
+
+
+// Amplification with a float gain
+template <int SHFT, typename TD, typename TS>
+static void	GammaY_amplify_sse2 (TD *d0_ptr, TD *d1_ptr, TD *d2_ptr, const TS *s0_ptr, const TS *s1_ptr, const TS *s2_ptr, const float *gain_ptr, int len) noexcept
+{
+	for (int x = 0; x < len; x += 4)
+	{
+		const __m128   m = _mm_load_ps (gain_ptr + x);
+		GammaY_store_4_sse2 (d0_ptr + x, _mm_mul_ps (GammaY_load_4_f32_sse2 (s0_ptr + x), m));
+		GammaY_store_4_sse2 (d1_ptr + x, _mm_mul_ps (GammaY_load_4_f32_sse2 (s1_ptr + x), m));
+		GammaY_store_4_sse2 (d2_ptr + x, _mm_mul_ps (GammaY_load_4_f32_sse2 (s2_ptr + x), m));
+	}
+}
+
+// Amplification with an integer gain, result scaled by 2^-SHFT
+template <int SHFT, typename TS>
+static fstb_FORCEINLINE __m128i	GammaY_amplify_4_sse2 (const TS *src_ptr, __m128i m) noexcept
+{
+	const __m128i  bias = _mm_set1_epi32 (1 << (SHFT - 1));
+	const __m128i  s    = GammaY_load_4_u16_sse2 (src_ptr);
+	const __m128i  lo   = _mm_mullo_epi16 (s, m);
+	const __m128i  hi   = _mm_mulhi_epu16 (s, m);
+	const __m128i  p    = _mm_unpacklo_epi16 (lo, hi);
+
+	return _mm_srai_epi32 (_mm_add_epi32 (p, bias), SHFT);
+}
+
+template <int SHFT, typename TS>
+static void	GammaY_amplify_sse2 (uint16_t *d0_ptr, uint16_t *d1_ptr, uint16_t *d2_ptr, const TS *s0_ptr, const TS *s1_ptr, const TS *s2_ptr, const uint16_t *gain_ptr, int len) noexcept
+{
+	for (int x = 0; x < len; x += 4)
+	{
+		const __m128i  m = GammaY_load_4_u16_sse2 (gain_ptr + x);
+		GammaY_store_4_sse2 (d0_ptr + x, GammaY_amplify_4_sse2 <SHFT> (s0_ptr + x, m));
+		GammaY_store_4_sse2 (d1_ptr + x, GammaY_amplify_4_sse2 <SHFT> (s1_ptr + x, m));
+		GammaY_store_4_sse2 (d2_ptr + x, GammaY_amplify_4_sse2 <SHFT> (s2_ptr + x, m));
+	}
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
 
 
 /*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -58,7 +212,7 @@ constexpr int	GammaY::_nbr_planes;
 
 
 
-GammaY::GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double gamma, double alpha, bool sse2_flag, bool avx2_flag)
+GammaY::GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double gamma, double alpha, bool sse2_flag, bool avx2_flag, bool avx512_flag)
 {
 	assert (src_fmt == SplFmt_FLOAT || src_fmt == SplFmt_INT16 || src_fmt == SplFmt_INT8);
 	assert (dst_fmt == SplFmt_FLOAT || dst_fmt == SplFmt_INT16);
@@ -139,15 +293,26 @@ GammaY::GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double
 		op, (luma_fmt == SplFmt_FLOAT),
 		luma_fmt   , luma_res   , true,
 		lut_out_fmt, lut_out_res, true,
-		sse2_flag, avx2_flag
+		sse2_flag, avx2_flag, avx512_flag
 	);
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+ #define fmtcl_GammaY_CASE_SSE2( st, dt, fa_flag, sh) \
+		if (sse2_flag) \
+		{ \
+			_process_plane_ptr = &GammaY::process_plane_sse2 <st, dt, fa_flag, sh>; \
+		}
+#else
+ #define fmtcl_GammaY_CASE_SSE2( st, dt, fa_flag, sh)
+#endif
 #define fmtcl_GammaY_CASE( sf, st, df, dt, fa_flag, sh) \
-	case GammaY_encode (SplFmt_##sf, SplFmt_##df, fa_flag, sh): \
+	case encode_sel (SplFmt_##sf, SplFmt_##df, fa_flag, sh): \
 		_process_plane_ptr = &GammaY::process_plane_cpp <st, dt, fa_flag, sh>; \
+		fmtcl_GammaY_CASE_SSE2 (st, dt, fa_flag, sh) \
 		break;
 
-	switch (GammaY_encode (src_fmt, dst_fmt, flt_amp_flag, shft))
+	const int      sel = encode_sel (src_fmt, dst_fmt, flt_amp_flag, shft);
+	switch (sel)
 	{
 	fmtcl_GammaY_CASE (FLOAT, float   , FLOAT, float   , false, 0)
 	fmtcl_GammaY_CASE (FLOAT, float   , INT16, uint16_t, false, 0)
@@ -171,6 +336,14 @@ GammaY::GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double
 	}
 
 #undef fmtcl_GammaY_CASE
+#undef fmtcl_GammaY_CASE_SSE2
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	if (avx2_flag)
+	{
+		init_proc_fnc_avx2 (sel);
+	}
+#endif
 }
 
 
@@ -228,6 +401,13 @@ TransOpInterface::LinInfo	GammaY::Op::do_get_info () const
 
 
 
+std::string	GammaY::Op::do_get_desc () const
+{
+	return build_desc ("GammaY", { _gamma, _alpha });
+}
+
+
+
 template <typename TD, typename TA, int SHFT>
 TD	GammaY::Conv <TD, TA, SHFT>::conv (TA x) noexcept
 {
@@ -337,6 +517,122 @@ void	GammaY::process_plane_cpp (Frame <> dst_arr, FrameRO <> src_arr, int w, int
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+template <typename TS, typename TD, bool FLT_FLAG, int SHFT>
+void	GammaY::process_plane_sse2 (Frame <> dst_arr, FrameRO <> src_arr, int w, int h) const noexcept
+{
+	typedef typename std::conditional <
+		std::is_floating_point <TS>::value, float, int
+	>::type LumaTmpType;
+	typedef typename std::conditional <
+		std::is_floating_point <TS>::value, float, uint16_t
+	>::type LumaType;
+	typedef typename std::conditional <
+		   std::is_floating_point <TS>::value
+		|| std::is_floating_point <TD>::value
+		|| FLT_FLAG,
+		float, uint16_t
+	>::type GainType;
+
+	constexpr int  vec_len = 4;
+
+	const auto     c_r = LumaTmpType (
+		std::is_floating_point <TS>::value ? _r2y_f : float (_r2y_i)
+	);
+	const auto     c_g = LumaTmpType (
+		std::is_floating_point <TS>::value ? _g2y_f : float (_g2y_i)
+	);
+	const auto     c_b = LumaTmpType (
+		std::is_floating_point <TS>::value ? _b2y_f : float (_b2y_i)
+	);
+
+	alignas (64) std::array <GainType, _buf_size> gain;
+	alignas (64) std::array <LumaType, _buf_size> luma;
+
+	// Copies of the incomplete vectors at the end of the blocks, so we never
+	// access the pixels located after the end of the lines.
+	alignas (16) std::array <std::array <TS, vec_len>, _nbr_planes> tail_s {};
+	alignas (16) std::array <std::array <TD, vec_len>, _nbr_planes> tail_d {};
+
+	for (int y = 0; y < h; ++y)
+	{
+		FrameRO <TS>   s_arr { src_arr };
+		Frame <TD>     d_arr { dst_arr };
+
+		for (int x_blk = 0; x_blk < w; x_blk += _buf_size)
+		{
+			const auto     blk_len  = std::min <int> (w - x_blk, _buf_size);
+			const auto     len_main = blk_len & -vec_len;
+			const auto     len_tail = blk_len - len_main;
+
+			// Computes Y (luminance) from the RGB data
+			GammaY_compute_luma_sse2 <_coef_res> (
+				luma.data (), s_arr [0]._ptr, s_arr [1]._ptr, s_arr [2]._ptr,
+				len_main, c_r, c_g, c_b
+			);
+			if (len_tail > 0)
+			{
+				for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+				{
+					std::copy_n (
+						s_arr [p_idx]._ptr + len_main, len_tail,
+						tail_s [p_idx].data ()
+					);
+				}
+				GammaY_compute_luma_sse2 <_coef_res> (
+					luma.data () + len_main,
+					tail_s [0].data (), tail_s [1].data (), tail_s [2].data (),
+					vec_len, c_r, c_g, c_b
+				);
+			}
+
+			// Computes the component gain: alpha * pow (Y, gamma - 1)
+			_pow_uptr->process_plane (
+				Plane <> {   reinterpret_cast <      uint8_t *> (gain.data ()), 0 },
+				PlaneRO <> { reinterpret_cast <const uint8_t *> (luma.data ()), 0 },
+				blk_len, 1
+			);
+
+			// Amplifies each component
+			GammaY_amplify_sse2 <SHFT> (
+				d_arr [0]._ptr, d_arr [1]._ptr, d_arr [2]._ptr,
+				s_arr [0]._ptr, s_arr [1]._ptr, s_arr [2]._ptr,
+				gain.data (), len_main
+			);
+			if (len_tail > 0)
+			{
+				GammaY_amplify_sse2 <SHFT> (
+					tail_d [0].data (), tail_d [1].data (), tail_d [2].data (),
+					tail_s [0].data (), tail_s [1].data (), tail_s [2].data (),
+					gain.data () + len_main, vec_len
+				);
+				for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+				{
+					std::copy_n (
+						tail_d [p_idx].data (), len_tail,
+						d_arr [p_idx]._ptr + len_main
+					);
+				}
+			}
+
+			s_arr.step_pix (blk_len);
+			d_arr.step_pix (blk_len);
+		}
+
+		src_arr.step_line ();
+		dst_arr.step_line ();
+	}
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
+
 uint16_t	GammaY::compute_luma (int r, int g, int b) const noexcept
 {
 	const auto     l = r * _r2y_i + g * _g2y_i + b * _b2y_i;
@@ -34,6 +34,8 @@ http://www.wtfpl.net/ for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include "fstb/def.h"
+
 #include "fmtcl/Frame.h"
 #include "fmtcl/FrameRO.h"
 #include "fmtcl/SplFmt.h"
@@ -62,7 +64,7 @@ public:
 
 	typedef GammaY ThisType;
 
-	explicit       GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double gamma, double alpha, bool sse2_flag, bool avx2_flag);
+	explicit       GammaY (SplFmt src_fmt, int src_res, SplFmt dst_fmt, int dst_res, double gamma, double alpha, bool sse2_flag, bool avx2_flag, bool avx512_flag);
 	               ~GammaY () = default;
 
 	void           process_plane (const Frame <> &dst_arr, const FrameRO <> &src_arr, int w, int h) const noexcept;
@@ -96,6 +98,7 @@ private:
 	protected:
 		double         do_convert (double x) const override;
 		LinInfo        do_get_info () const override;
+		std::string    do_get_desc () const override;
 	private:
 		double         _gamma = 1;
 		double         _alpha = 1;
@@ -114,8 +117,21 @@ private:
 		static inline uint16_t conv (float x) noexcept;
 	};
 
+	static constexpr int
+	               encode_sel (SplFmt src_fmt, SplFmt dst_fmt, bool flt_flag, int shft) noexcept
+	{
+		return (src_fmt << 11) + (dst_fmt << 8) + (shft << 1) + (flt_flag ? 1 : 0);
+	}
+
 	template <typename TS, typename TD, bool FLT_FLAG, int SHFT>
 	void           process_plane_cpp (Frame <> dst_arr, FrameRO <> src_arr, int w, int h) const noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	template <typename TS, typename TD, bool FLT_FLAG, int SHFT>
+	void           process_plane_sse2 (Frame <> dst_arr, FrameRO <> src_arr, int w, int h) const noexcept;
+	template <typename TS, typename TD, bool FLT_FLAG, int SHFT>
+	void           process_plane_avx2 (Frame <> dst_arr, FrameRO <> src_arr, int w, int h) const noexcept;
+	void           init_proc_fnc_avx2 (int sel) noexcept;
+#endif
 
 	inline uint16_t
 	               compute_luma (int r, int g, int b) const noexcept;
@@ -0,0 +1,343 @@
+/*****************************************************************************
+
+        GammaY_avx2.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include "fmtcl/GammaY.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+// Loads 8 integer pixels as 32-bit values
+static fstb_FORCEINLINE __m256i	GammaY_load_8_s32_avx2 (const uint8_t *ptr) noexcept
+{
+	return _mm256_cvtepu8_epi32 (
+		_mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr))
+	);
+}
+
+static fstb_FORCEINLINE __m256i	GammaY_load_8_s32_avx2 (const uint16_t *ptr) noexcept
+{
+	return _mm256_cvtepu16_epi32 (
+		_mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr))
+	);
+}
+
+// Loads 8 pixels as float
+static fstb_FORCEINLINE __m256	GammaY_load_8_f32_avx2 (const float *ptr) noexcept
+{
+	return _mm256_loadu_ps (ptr);
+}
+
+template <typename T>
+static fstb_FORCEINLINE __m256	GammaY_load_8_f32_avx2 (const T *ptr) noexcept
+{
+	return _mm256_cvtepi32_ps (GammaY_load_8_s32_avx2 (ptr));
+}
+
+// Clips the 32-bit values to [0 ; 65535] and stores them
+static fstb_FORCEINLINE void	GammaY_store_8_avx2 (uint16_t *ptr, __m256i val) noexcept
+{
+	val = _mm256_packus_epi32 (val, val);
+	val = _mm256_permute4x64_epi64 (val, (0<<0) | (2<<2));
+	_mm_storeu_si128 (
+		reinterpret_cast <__m128i *> (ptr), _mm256_castsi256_si128 (val)
+	);
+}
+
+static fstb_FORCEINLINE void	GammaY_store_8_avx2 (uint16_t *ptr, __m256 val) noexcept
+{
+	GammaY_store_8_avx2 (ptr, _mm256_cvtps_epi32 (val));
+}
+
+static fstb_FORCEINLINE void	GammaY_store_8_avx2 (float *ptr, __m256 val) noexcept
+{
+	_mm256_storeu_ps (ptr, val);
+}
+
+
+
+// Luma from float RGB. len is a multiple of 8.
+template <int CRES>
+static void	GammaY_compute_luma_avx2 (float *luma_ptr, const float *r_ptr, const float *g_ptr, const float *b_ptr, int len, float c_r, float c_g, float c_b) noexcept
+{
+	const __m256   cr = _mm256_set1_ps (c_r);
+	const __m256   cg = _mm256_set1_ps (c_g);
+	const __m256   cb = _mm256_set1_ps (c_b);
+
+	for (int x = 0; x < len; x += 8)
+	{
+		const __m256   r = GammaY_load_8_f32_avx2 (r_ptr + x);
+		const __m256   g = GammaY_load_8_f32_avx2 (g_ptr + x);
+		const __m256   b = GammaY_load_8_f32_avx2 (b_ptr + x);
+		const __m256   l = _mm256_add_ps (
+			_mm256_add_ps (_mm256_mul_ps (r, cr), _mm256_mul_ps (g, cg)),
+			_mm256_mul_ps (b, cb)
+		);
+		_mm256_store_ps (luma_ptr + x, l);
+	}
+}
+
+// Luma from integer RGB, coefficients with CRES fractional bits.
+template <int CRES, typename TS>
+static void	GammaY_compute_luma_avx2 (uint16_t *luma_ptr, const TS *r_ptr, const TS *g_ptr, const TS *b_ptr, int len, int c_r, int c_g, int c_b) noexcept
+{
+	const __m256i  cr   = _mm256_set1_epi32 (c_r);
+	const __m256i  cg   = _mm256_set1_epi32 (c_g);
+	const __m256i  cb   = _mm256_set1_epi32 (c_b);
+	const __m256i  bias = _mm256_set1_epi32 (1 << (CRES - 1));
+
+	for (int x = 0; x < len; x += 8)
+	{
+		const __m256i  r = GammaY_load_8_s32_avx2 (r_ptr + x);
+		const __m256i  g = GammaY_load_8_s32_avx2 (g_ptr + x);
+		const __m256i  b = GammaY_load_8_s32_avx2 (b_ptr + x);
+		__m256i        l = _mm256_add_epi32 (
+			_mm256_add_epi32 (
+				_mm256_mullo_epi32 (r, cr),
+				_mm256_mullo_epi32 (g, cg)
+			),
+			_mm256_mullo_epi32 (b, cb)
+		);
+		l = _mm256_srai_epi32 (_mm256_add_epi32 (l, bias), CRES);
+		GammaY_store_8_avx2 (luma_ptr + x, l);
+	}
+}
+
+
+
+// Amplification with a float gain
+template <int SHFT, typename TD, typename TS>
+static void	GammaY_amplify_avx2 (TD *d0_ptr, TD *d1_ptr, TD *d2_ptr, const TS *s0_ptr, const TS *s1_ptr, const TS *s2_ptr, const float *gain_ptr, int len) noexcept
+{
+	for (int x = 0; x < len; x += 8)
+	{
+		const __m256   m = _mm256_load_ps (gain_ptr + x);
+		GammaY_store_8_avx2 (d0_ptr + x, _mm256_mul_ps (GammaY_load_8_f32_avx2 (s0_ptr + x), m));
+		GammaY_store_8_avx2 (d1_ptr + x, _mm256_mul_ps (GammaY_load_8_f32_avx2 (s1_ptr + x), m));
+		GammaY_store_8_avx2 (d2_ptr + x, _mm256_mul_ps (GammaY_load_8_f32_avx2 (s2_ptr + x), m));
+	}
+}
+
+// Amplification with an integer gain, result scaled by 2^-SHFT
+template <int SHFT, typename TS>
+static fstb_FORCEINLINE __m256i	GammaY_amplify_8_avx2 (const TS *src_ptr, __m256i m) noexcept
+{
+	const __m256i  bias = _mm256_set1_epi32 (1 << (SHFT - 1));
+	const __m256i  s    = GammaY_load_8_s32_avx2 (src_ptr);
+	const __m256i  p    = _mm256_mullo_epi32 (s, m);
+
+	return _mm256_srai_epi32 (_mm256_add_epi32 (p, bias), SHFT);
+}
+
+template <int SHFT, typename TS>
+static void	GammaY_amplify_avx2 (uint16_t *d0_ptr, uint16_t *d1_ptr, uint16_t *d2_ptr, const TS *s0_ptr, const TS *s1_ptr, const TS *s2_ptr, const uint16_t *gain_ptr, int len) noexcept
+{
+	for (int x = 0; x < len; x += 8)
+	{
+		const __m256i  m = GammaY_load_8_s32_avx2 (gain_ptr + x);
+		GammaY_store_8_avx2 (d0_ptr + x, GammaY_amplify_8_avx2 <SHFT> (s0_ptr + x, m));
+		GammaY_store_8_avx2 (d1_ptr + x, GammaY_amplify_8_avx2 <SHFT> (s1_ptr + x, m));
+		GammaY_store_8_avx2 (d2_ptr + x, GammaY_amplify_8_avx2 <SHFT> (s2_ptr + x, m));
+	}
+}
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// sel is the encode_sel() value of the format combination
+void	GammaY::init_proc_fnc_avx2 (int sel) noexcept
+{
+#define fmtcl_GammaY_CASE( sf, st, df, dt, fa_flag, sh) \
+	case encode_sel (SplFmt_##sf, SplFmt_##df, fa_flag, sh): \
+		_process_plane_ptr = &GammaY::process_plane_avx2 <st, dt, fa_flag, sh>; \
+		break;
+
+	switch (sel)
+	{
+	fmtcl_GammaY_CASE (FLOAT, float   , FLOAT, float   , false, 0)
+	fmtcl_GammaY_CASE (FLOAT, float   , INT16, uint16_t, false, 0)
+	fmtcl_GammaY_CASE (INT16, uint16_t, FLOAT, float   , false, 0)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+16-16)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+14-16)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+12-16)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+11-16)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+10-16)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, false, _coef_res+ 9-16)
+	fmtcl_GammaY_CASE (INT8 , uint8_t , FLOAT, float   , false, 0)
+	fmtcl_GammaY_CASE (INT8 , uint8_t , INT16, uint16_t, false, _coef_res+ 8-16)
+	fmtcl_GammaY_CASE (FLOAT, float   , INT16, uint16_t, true , 0)
+	fmtcl_GammaY_CASE (INT16, uint16_t, FLOAT, float   , true , 0)
+	fmtcl_GammaY_CASE (INT16, uint16_t, INT16, uint16_t, true , 0)
+	fmtcl_GammaY_CASE (INT8 , uint8_t , FLOAT, float   , true , 0)
+	fmtcl_GammaY_CASE (INT8 , uint8_t , INT16, uint16_t, true , 0)
+	default:
+		assert (false);
+		break;
+	}
+
+#undef fmtcl_GammaY_CASE
+}
+
+
+
+template <typename TS, typename TD, bool FLT_FLAG, int SHFT>
+void	GammaY::process_plane_avx2 (Frame <> dst_arr, FrameRO <> src_arr, int w, int h) const noexcept
+{
+	typedef typename std::conditional <
+		std::is_floating_point <TS>::value, float, int
+	>::type LumaTmpType;
+	typedef typename std::conditional <
+		std::is_floating_point <TS>::value, float, uint16_t
+	>::type LumaType;
+	typedef typename std::conditional <
+		   std::is_floating_point <TS>::value
+		|| std::is_floating_point <TD>::value
+		|| FLT_FLAG,
+		float, uint16_t
+	>::type GainType;
+
+	constexpr int  vec_len = 8;
+
+	const auto     c_r = LumaTmpType (
+		std::is_floating_point <TS>::value ? _r2y_f : float (_r2y_i)
+	);
+	const auto     c_g = LumaTmpType (
+		std::is_floating_point <TS>::value ? _g2y_f : float (_g2y_i)
+	);
+	const auto     c_b = LumaTmpType (
+		std::is_floating_point <TS>::value ? _b2y_f : float (_b2y_i)
+	);
+
+	alignas (64) std::array <GainType, _buf_size> gain;
+	alignas (64) std::array <LumaType, _buf_size> luma;
+
+	// Copies of the incomplete vectors at the end of the blocks
+	alignas (32) std::array <std::array <TS, vec_len>, _nbr_planes> tail_s {};
+	alignas (32) std::array <std::array <TD, vec_len>, _nbr_planes> tail_d {};
+
+	for (int y = 0; y < h; ++y)
+	{
+		FrameRO <TS>   s_arr { src_arr };
+		Frame <TD>     d_arr { dst_arr };
+
+		for (int x_blk = 0; x_blk < w; x_blk += _buf_size)
+		{
+			const auto     blk_len  = std::min <int> (w - x_blk, _buf_size);
+			const auto     len_main = blk_len & -vec_len;
+			const auto     len_tail = blk_len - len_main;
+
+			// Computes Y (luminance) from the RGB data
+			GammaY_compute_luma_avx2 <_coef_res> (
+				luma.data (), s_arr [0]._ptr, s_arr [1]._ptr, s_arr [2]._ptr,
+				len_main, c_r, c_g, c_b
+			);
+			if (len_tail > 0)
+			{
+				for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+				{
+					std::copy_n (
+						s_arr [p_idx]._ptr + len_main, len_tail,
+						tail_s [p_idx].data ()
+					);
+				}
+				GammaY_compute_luma_avx2 <_coef_res> (
+					luma.data () + len_main,
+					tail_s [0].data (), tail_s [1].data (), tail_s [2].data (),
+					vec_len, c_r, c_g, c_b
+				);
+			}
+
+			// Computes the component gain: alpha * pow (Y, gamma - 1)
+			_pow_uptr->process_plane (
+				Plane <> {   reinterpret_cast <      uint8_t *> (gain.data ()), 0 },
+				PlaneRO <> { reinterpret_cast <const uint8_t *> (luma.data ()), 0 },
+				blk_len, 1
+			);
+
+			// Amplifies each component
+			GammaY_amplify_avx2 <SHFT> (
+				d_arr [0]._ptr, d_arr [1]._ptr, d_arr [2]._ptr,
+				s_arr [0]._ptr, s_arr [1]._ptr, s_arr [2]._ptr,
+				gain.data (), len_main
+			);
+			if (len_tail > 0)
+			{
+				GammaY_amplify_avx2 <SHFT> (
+					tail_d [0].data (), tail_d [1].data (), tail_d [2].data (),
+					tail_s [0].data (), tail_s [1].data (), tail_s [2].data (),
+					gain.data () + len_main, vec_len
+				);
+				for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+				{
+					std::copy_n (
+						tail_d [p_idx].data (), len_tail,
+						d_arr [p_idx]._ptr + len_main
+					);
+				}
+			}
+
+			s_arr.step_pix (blk_len);
+			d_arr.step_pix (blk_len);
+		}
+
+		src_arr.step_line ();
+		dst_arr.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
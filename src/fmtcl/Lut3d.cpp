@@ -0,0 +1,375 @@
+/*****************************************************************************
+
+        Lut3d.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Lut3d.h"
+#include "fmtcl/PlaneRO.h"
+#include "fmtcl/ProcComp3Arg.h"
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fstb/ToolsSse2.h"
+	#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// v_min and v_max: input domain covered by the LUT, for each plane.
+// fnc is only called during the construction.
+Lut3d::Lut3d (int res, const Vec3 &v_min, const Vec3 &v_max, const SampleFnc &fnc, bool sse2_flag, bool avx2_flag)
+:	_res (res)
+,	_proc_ptr (&ThisType::process_cpp)
+{
+	assert (res >= _min_res);
+	assert (res <= _max_res);
+	assert (fnc);
+
+	for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+	{
+		assert (v_max [p_idx] > v_min [p_idx]);
+		const double   mul = (res - 1) / (v_max [p_idx] - v_min [p_idx]);
+		_mul [p_idx] = float (mul);
+		_add [p_idx] = float (-v_min [p_idx] * mul);
+	}
+	_step [0] = 1;
+	_step [1] = res;
+	_step [2] = res * res;
+
+	sample (fnc, v_min, v_max);
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	if (sse2_flag)
+	{
+		_proc_ptr  = &ThisType::process_sse2;
+		_perf_simd = PerfTrace::Simd_SSE2;
+	}
+	if (avx2_flag)
+	{
+		_proc_ptr  = &ThisType::process_avx2;
+		_perf_simd = PerfTrace::Simd_AVX2;
+	}
+#else
+	fstb::unused (sse2_flag, avx2_flag);
+#endif
+}
+
+
+
+void	Lut3d::process (const ProcComp3Arg &arg) const noexcept
+{
+	assert (_proc_ptr != nullptr);
+	assert (arg.is_valid ());
+
+	PerfTrace::Scope  perf_scope (
+		"Lut3d", _perf_simd, int64_t (arg._w) * arg._h
+	);
+
+	(this->*_proc_ptr) (arg._dst, arg._src, arg._w, arg._h);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Builds a frame with the node coordinates, processes it and stores the
+// results in the LUT.
+void	Lut3d::sample (const SampleFnc &fnc, const Vec3 &v_min, const Vec3 &v_max)
+{
+	const int      w          = _res;
+	const int      h          = _res * _res;
+	const int      stride_flt = (w + 15) & ~15;
+	const int      stride     = stride_flt * int (sizeof (float));
+
+	std::array <BufFlt, _nbr_planes> buf_arr;
+	ProcComp3Arg   pa;
+	pa._w = w;
+	pa._h = h;
+	for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+	{
+		auto &         buf = buf_arr [p_idx];
+		buf.resize (size_t (stride_flt) * size_t (h));
+		uint8_t *      ptr = reinterpret_cast <uint8_t *> (buf.data ());
+		pa._dst [p_idx] = Plane <> (ptr, stride);
+		pa._src [p_idx] = PlaneRO <> (ptr, stride);
+	}
+
+	for (int y = 0; y < h; ++y)
+	{
+		const std::array <int, _nbr_planes> pos_arr {{ 0, y % _res, y / _res }};
+		for (int x = 0; x < w; ++x)
+		{
+			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+			{
+				const int      pos = (p_idx == 0) ? x : pos_arr [p_idx];
+				const double   dif = v_max [p_idx] - v_min [p_idx];
+				buf_arr [p_idx] [y * stride_flt + x] =
+					float (v_min [p_idx] + pos * dif / (_res - 1));
+			}
+		}
+	}
+
+	fnc (pa);
+
+	_lut.resize (size_t (_step [2]) * size_t (_res) * _node_len, 0.f);
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			float *        node_ptr = &_lut [(y * w + x) * _node_len];
+			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+			{
+				node_ptr [p_idx] = buf_arr [p_idx] [y * stride_flt + x];
+			}
+		}
+	}
+}
+
+
+
+void	Lut3d::process_cpp (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	const float    c_max    = float (_res - 1);
+	const float    i_max    = float (_res - 2);
+	const int      step_all = _step [0] + _step [1] + _step [2];
+	const float *  lut_ptr  = _lut.data ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		const FrameRO <float>   s { src };
+		const Frame <float>     d { dst };
+
+		for (int x = 0; x < w; ++x)
+		{
+			// Node coordinates, lower node index and fractional parts
+			std::array <float, _nbr_planes> f;
+			int            idx = 0;
+			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+			{
+				float          c = s [p_idx]._ptr [x] * _mul [p_idx] + _add [p_idx];
+				c = std::min (std::max (0.f, c), c_max); // NaN -> 0
+				const int      i = int (std::min (c, i_max));
+				f [p_idx] = c - float (i);
+				idx += i * _step [p_idx];
+			}
+
+			// Finds the tetrahedron. The path goes from the lower node to the
+			// upper one, along the axes sorted by decreasing fractional part.
+			const bool     m01   = (f [0] >= f [1]);
+			const bool     m12   = (f [1] >= f [2]);
+			const bool     m02   = (f [0] >= f [2]);
+			const int      s_a   =
+				  (m01 && m02) ? _step [0]
+				: (m12       ) ? _step [1]
+				:                _step [2];
+			const int      s_c   =
+				  (m12 && m02) ? _step [2]
+				: (m01       ) ? _step [1]
+				:                _step [0];
+			const float    f_max = std::max (std::max (f [0], f [1]), f [2]);
+			const float    f_min = std::min (std::min (f [0], f [1]), f [2]);
+			const float    f_mid = std::max (
+				std::min (f [0], f [1]), std::min (std::max (f [0], f [1]), f [2])
+			);
+
+			const float *  n0_ptr = lut_ptr + (idx                 ) * _node_len;
+			const float *  n1_ptr = lut_ptr + (idx + s_a           ) * _node_len;
+			const float *  n2_ptr = lut_ptr + (idx + step_all - s_c) * _node_len;
+			const float *  n3_ptr = lut_ptr + (idx + step_all      ) * _node_len;
+			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+			{
+				const float    n0 = n0_ptr [p_idx];
+				const float    n1 = n1_ptr [p_idx];
+				const float    n2 = n2_ptr [p_idx];
+				const float    n3 = n3_ptr [p_idx];
+				d [p_idx]._ptr [x] =
+					  n0
+					+ f_max * (n1 - n0)
+					+ f_mid * (n2 - n1)
+					+ f_min * (n3 - n2);
+			}
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// Same algorithm as process_cpp(). The node indexes are computed in float
+// (exact up to 2^24), then the nodes are fetched pixel by pixel, each one
+// in a single register. The results are transposed back to planar.
+void	Lut3d::process_sse2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	const __m128   zero     = _mm_setzero_ps ();
+	const __m128   c_max    = _mm_set1_ps (float (_res - 1));
+	const __m128   i_max    = _mm_set1_ps (float (_res - 2));
+	const __m128   mul0     = _mm_set1_ps (_mul [0]);
+	const __m128   mul1     = _mm_set1_ps (_mul [1]);
+	const __m128   mul2     = _mm_set1_ps (_mul [2]);
+	const __m128   add0     = _mm_set1_ps (_add [0]);
+	const __m128   add1     = _mm_set1_ps (_add [1]);
+	const __m128   add2     = _mm_set1_ps (_add [2]);
+	const __m128   stp0     = _mm_set1_ps (float (_step [0]));
+	const __m128   stp1     = _mm_set1_ps (float (_step [1]));
+	const __m128   stp2     = _mm_set1_ps (float (_step [2]));
+	const __m128   stp_all  = _mm_set1_ps (float (_step [0] + _step [1] + _step [2]));
+	const float *  lut_ptr  = _lut.data ();
+
+	const auto     split    = [&] (__m128 &f, __m128 v, __m128 mul, __m128 add)
+	{
+		__m128         c = _mm_add_ps (_mm_mul_ps (v, mul), add);
+		c = _mm_min_ps (_mm_max_ps (c, zero), c_max); // NaN -> 0
+		const __m128   i = _mm_cvtepi32_ps (_mm_cvttps_epi32 (_mm_min_ps (c, i_max)));
+		f = _mm_sub_ps (c, i);
+		return i;
+	};
+
+	fstb::ToolsSse2::VectI32   idx_arr [4];
+	fstb::ToolsSse2::VectF32   f_arr [3];
+
+	for (int y = 0; y < h; ++y)
+	{
+		const FrameRO <float>   s { src };
+		const Frame <float>     d { dst };
+
+		for (int x = 0; x < w; x += 4)
+		{
+			__m128         f0;
+			__m128         f1;
+			__m128         f2;
+			const __m128   i0 = split (f0, _mm_load_ps (s [0]._ptr + x), mul0, add0);
+			const __m128   i1 = split (f1, _mm_load_ps (s [1]._ptr + x), mul1, add1);
+			const __m128   i2 = split (f2, _mm_load_ps (s [2]._ptr + x), mul2, add2);
+			const __m128   idx = _mm_add_ps (
+				_mm_add_ps (_mm_mul_ps (i0, stp0), _mm_mul_ps (i1, stp1)),
+				_mm_mul_ps (i2, stp2)
+			);
+
+			const __m128   m01   = _mm_cmpge_ps (f0, f1);
+			const __m128   m12   = _mm_cmpge_ps (f1, f2);
+			const __m128   m02   = _mm_cmpge_ps (f0, f2);
+			const __m128   s_a   = fstb::ToolsSse2::select (
+				_mm_and_ps (m01, m02), stp0,
+				fstb::ToolsSse2::select (m12, stp1, stp2)
+			);
+			const __m128   s_c   = fstb::ToolsSse2::select (
+				_mm_and_ps (m12, m02), stp2,
+				fstb::ToolsSse2::select (m01, stp1, stp0)
+			);
+			const __m128   f_max = _mm_max_ps (_mm_max_ps (f0, f1), f2);
+			const __m128   f_min = _mm_min_ps (_mm_min_ps (f0, f1), f2);
+			const __m128   f_mid = _mm_max_ps (
+				_mm_min_ps (f0, f1), _mm_min_ps (_mm_max_ps (f0, f1), f2)
+			);
+
+			const __m128   idx3  = _mm_add_ps (idx, stp_all);
+			_mm_store_si128 (
+				reinterpret_cast <__m128i *> (idx_arr [0]), _mm_cvttps_epi32 (idx)
+			);
+			_mm_store_si128 (
+				reinterpret_cast <__m128i *> (idx_arr [1]),
+				_mm_cvttps_epi32 (_mm_add_ps (idx, s_a))
+			);
+			_mm_store_si128 (
+				reinterpret_cast <__m128i *> (idx_arr [2]),
+				_mm_cvttps_epi32 (_mm_sub_ps (idx3, s_c))
+			);
+			_mm_store_si128 (
+				reinterpret_cast <__m128i *> (idx_arr [3]), _mm_cvttps_epi32 (idx3)
+			);
+			_mm_store_ps (f_arr [0], f_max);
+			_mm_store_ps (f_arr [1], f_mid);
+			_mm_store_ps (f_arr [2], f_min);
+
+			__m128         r_arr [4];
+			for (int k = 0; k < 4; ++k)
+			{
+				const __m128   n0 = _mm_load_ps (lut_ptr + idx_arr [0] [k] * _node_len);
+				const __m128   n1 = _mm_load_ps (lut_ptr + idx_arr [1] [k] * _node_len);
+				const __m128   n2 = _mm_load_ps (lut_ptr + idx_arr [2] [k] * _node_len);
+				const __m128   n3 = _mm_load_ps (lut_ptr + idx_arr [3] [k] * _node_len);
+				r_arr [k] = _mm_add_ps (_mm_add_ps (_mm_add_ps (
+					n0,
+					_mm_mul_ps (_mm_set1_ps (f_arr [0] [k]), _mm_sub_ps (n1, n0))),
+					_mm_mul_ps (_mm_set1_ps (f_arr [1] [k]), _mm_sub_ps (n2, n1))),
+					_mm_mul_ps (_mm_set1_ps (f_arr [2] [k]), _mm_sub_ps (n3, n2))
+				);
+			}
+			_MM_TRANSPOSE4_PS (r_arr [0], r_arr [1], r_arr [2], r_arr [3]);
+
+			_mm_store_ps (d [0]._ptr + x, r_arr [0]);
+			_mm_store_ps (d [1]._ptr + x, r_arr [1]);
+			_mm_store_ps (d [2]._ptr + x, r_arr [2]);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,161 @@
+/*****************************************************************************
+
+        Lut3d.h
+        Author: Laurent de Soras, 2024
+
+Applies any point-wise 3-plane float processing with a 3D LUT, in a single
+pass. The LUT is sampled once at construction time, by running the
+processing on a grid covering the input domain. Then the pixels are
+interpolated from the 4 nodes of the tetrahedron enclosing them.
+
+Input and output are 3 planes in 32-bit float. The input values are
+clipped to the domain covered by the LUT, and NaN are mapped to its lower
+bound. The output values are not clipped.
+
+As for MatrixProc, the SIMD code processes the rows by full vectors and
+may read and write a few pixels past the end of the rows. The strides must
+be large enough.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_Lut3d_HEADER_INCLUDED)
+#define fmtcl_Lut3d_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fmtcl/Frame.h"
+#include "fmtcl/FrameRO.h"
+#include "fmtcl/PerfTrace.h"
+#include "fmtcl/Vec3.h"
+#include "fstb/AllocAlign.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+
+
+namespace fmtcl
+{
+
+
+
+class ProcComp3Arg;
+
+class Lut3d
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	typedef Lut3d ThisType;
+
+	static constexpr int _nbr_planes = 3;
+
+	// Number of nodes per dimension
+	static constexpr int _min_res = 2;
+	static constexpr int _max_res = 129;
+
+	// Processes the 3 float planes of arg, in place (same _dst and _src).
+	// For the sampling, the input frame is res pixels wide and res^2 pixels
+	// high. Node (i0, i1, i2) is located at x = i0, y = i2 * res + i1.
+	typedef std::function <void (const ProcComp3Arg &arg)> SampleFnc;
+
+	explicit       Lut3d (int res, const Vec3 &v_min, const Vec3 &v_max, const SampleFnc &fnc, bool sse2_flag, bool avx2_flag);
+	               ~Lut3d () = default;
+
+	// All stride values are in bytes. In-place processing is allowed.
+	void           process (const ProcComp3Arg &arg) const noexcept;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// Floats per node. The 4th one is padding, so a node can be loaded at
+	// once in a 128-bit register.
+	static constexpr int _node_len = 4;
+
+	typedef std::vector <float, fstb::AllocAlign <float, 64> > BufFlt;
+
+	void           sample (const SampleFnc &fnc, const Vec3 &v_min, const Vec3 &v_max);
+
+	void           process_cpp (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	void           process_sse2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	void           process_avx2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+#endif   // fstb_ARCHI_X86
+
+	int            _res = 0;
+
+	// Maps the input values to the node coordinates: c = v * mul + add
+	std::array <float, _nbr_planes>
+	               _mul {};
+	std::array <float, _nbr_planes>
+	               _add {};
+
+	// Distance between two consecutive nodes of a dimension, in nodes.
+	std::array <int, _nbr_planes>
+	               _step {};
+
+	// Nodes, _node_len floats each
+	BufFlt         _lut;
+
+	void (ThisType::*
+	               _proc_ptr) (Frame <> dst, FrameRO <> src, int w, int h) const noexcept = nullptr;
+	PerfTrace::Simd                  // Path of _proc_ptr, for the performance traces
+	               _perf_simd = PerfTrace::Simd_CPP;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               Lut3d ()                               = delete;
+	               Lut3d (const Lut3d &other)             = delete;
+	               Lut3d (Lut3d &&other)                  = delete;
+	Lut3d &        operator = (const Lut3d &other)        = delete;
+	Lut3d &        operator = (Lut3d &&other)             = delete;
+	bool           operator == (const Lut3d &other) const = delete;
+	bool           operator != (const Lut3d &other) const = delete;
+
+}; // class Lut3d
+
+
+
+}  // namespace fmtcl
+
+
+
+//#include "fmtcl/Lut3d.hpp"
+
+
+
+#endif   // fmtcl_Lut3d_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,168 @@
+/*****************************************************************************
+
+        Lut3d_avx2.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX2 in order to avoid SSE/AVX state switch
+slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Lut3d.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Same algorithm as process_cpp(), the node components are gathered for 8
+// pixels at once.
+void	Lut3d::process_avx2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_node_len == 4, "Index scaling is hardcoded");
+
+	const __m256   zero     = _mm256_setzero_ps ();
+	const __m256   c_max    = _mm256_set1_ps (float (_res - 1));
+	const __m256   i_max    = _mm256_set1_ps (float (_res - 2));
+	const __m256   mul0     = _mm256_set1_ps (_mul [0]);
+	const __m256   mul1     = _mm256_set1_ps (_mul [1]);
+	const __m256   mul2     = _mm256_set1_ps (_mul [2]);
+	const __m256   add0     = _mm256_set1_ps (_add [0]);
+	const __m256   add1     = _mm256_set1_ps (_add [1]);
+	const __m256   add2     = _mm256_set1_ps (_add [2]);
+	const __m256   stp0     = _mm256_set1_ps (float (_step [0]));
+	const __m256   stp1     = _mm256_set1_ps (float (_step [1]));
+	const __m256   stp2     = _mm256_set1_ps (float (_step [2]));
+	const __m256   stp_all  = _mm256_set1_ps (float (_step [0] + _step [1] + _step [2]));
+	const float *  lut_ptr  = _lut.data ();
+
+	const auto     split    = [&] (__m256 &f, __m256 v, __m256 mul, __m256 add)
+	{
+		__m256         c = _mm256_add_ps (_mm256_mul_ps (v, mul), add);
+		c = _mm256_min_ps (_mm256_max_ps (c, zero), c_max); // NaN -> 0
+		const __m256   i = _mm256_cvtepi32_ps (
+			_mm256_cvttps_epi32 (_mm256_min_ps (c, i_max))
+		);
+		f = _mm256_sub_ps (c, i);
+		return i;
+	};
+
+	// Node index to float index for the gathers
+	const auto     conv_idx = [] (__m256 idx)
+	{
+		return _mm256_slli_epi32 (_mm256_cvttps_epi32 (idx), 2);
+	};
+
+	for (int y = 0; y < h; ++y)
+	{
+		const FrameRO <float>   s { src };
+		const Frame <float>     d { dst };
+
+		for (int x = 0; x < w; x += 8)
+		{
+			__m256         f0;
+			__m256         f1;
+			__m256         f2;
+			const __m256   i0 = split (f0, _mm256_load_ps (s [0]._ptr + x), mul0, add0);
+			const __m256   i1 = split (f1, _mm256_load_ps (s [1]._ptr + x), mul1, add1);
+			const __m256   i2 = split (f2, _mm256_load_ps (s [2]._ptr + x), mul2, add2);
+			const __m256   idx = _mm256_add_ps (
+				_mm256_add_ps (_mm256_mul_ps (i0, stp0), _mm256_mul_ps (i1, stp1)),
+				_mm256_mul_ps (i2, stp2)
+			);
+
+			const __m256   m01   = _mm256_cmp_ps (f0, f1, _CMP_GE_OQ);
+			const __m256   m12   = _mm256_cmp_ps (f1, f2, _CMP_GE_OQ);
+			const __m256   m02   = _mm256_cmp_ps (f0, f2, _CMP_GE_OQ);
+			const __m256   s_a   = _mm256_blendv_ps (
+				_mm256_blendv_ps (stp2, stp1, m12), stp0, _mm256_and_ps (m01, m02)
+			);
+			const __m256   s_c   = _mm256_blendv_ps (
+				_mm256_blendv_ps (stp0, stp1, m01), stp2, _mm256_and_ps (m12, m02)
+			);
+			const __m256   f_max = _mm256_max_ps (_mm256_max_ps (f0, f1), f2);
+			const __m256   f_min = _mm256_min_ps (_mm256_min_ps (f0, f1), f2);
+			const __m256   f_mid = _mm256_max_ps (
+				_mm256_min_ps (f0, f1),
+				_mm256_min_ps (_mm256_max_ps (f0, f1), f2)
+			);
+
+			const __m256   idx3  = _mm256_add_ps (idx, stp_all);
+			const __m256i  ofs0  = conv_idx (idx);
+			const __m256i  ofs1  = conv_idx (_mm256_add_ps (idx, s_a));
+			const __m256i  ofs2  = conv_idx (_mm256_sub_ps (idx3, s_c));
+			const __m256i  ofs3  = conv_idx (idx3);
+
+			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+			{
+				const float *  comp_ptr = lut_ptr + p_idx;
+				const __m256   n0 = _mm256_i32gather_ps (comp_ptr, ofs0, 4);
+				const __m256   n1 = _mm256_i32gather_ps (comp_ptr, ofs1, 4);
+				const __m256   n2 = _mm256_i32gather_ps (comp_ptr, ofs2, 4);
+				const __m256   n3 = _mm256_i32gather_ps (comp_ptr, ofs3, 4);
+				const __m256   r  = _mm256_add_ps (_mm256_add_ps (_mm256_add_ps (
+					n0,
+					_mm256_mul_ps (f_max, _mm256_sub_ps (n1, n0))),
+					_mm256_mul_ps (f_mid, _mm256_sub_ps (n2, n1))),
+					_mm256_mul_ps (f_min, _mm256_sub_ps (n3, n2))
+				);
+				_mm256_store_ps (d [p_idx]._ptr + x, r);
+			}
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
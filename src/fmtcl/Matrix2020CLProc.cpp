@@ -3,9 +3,6 @@
         Matrix2020CLProc.cpp
         Author: Laurent de Soras, 2015
 
-TO DO:
-	- AVX2 optimizations
-
 --- Legal stuff ---
 
 This program is free software. It comes without any warranty, to
@@ -36,6 +33,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/TransOpLinPow.h"
 #include "fstb/fnc.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
+	#include "fmtcl/ProxyRwSse2.h"
 	#include "fstb/ToolsSse2.h"
 #endif   // fstb_ARCHI_X86
 
@@ -67,6 +65,75 @@ constexpr double	Matrix2020CLProc::_gam_pow;
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+
+
+// Multiplies unsigned 16-bit values, giving 32-bit results
+static fstb_FORCEINLINE void	Matrix2020CLProc_mul_u16_sse2 (__m128i &dst0, __m128i &dst1, __m128i src, __m128i coef) noexcept
+{
+	const __m128i  hi = _mm_mulhi_epu16 (src, coef);
+	const __m128i  lo = _mm_mullo_epi16 (src, coef);
+
+	dst0 = _mm_unpacklo_epi16 (lo, hi);
+	dst1 = _mm_unpackhi_epi16 (lo, hi);
+}
+
+// Sum of the 3 unsigned 16-bit inputs weighted with signed 16-bit coefficients
+// c_01 contains the interleaved coefficients for a and b, c_2 the coefficient
+// for c in the low words. cst accounts for the 0x8000 offset of the inputs
+// and should contain the rounding constant.
+static fstb_FORCEINLINE void	Matrix2020CLProc_mac3_sse2 (__m128i &dst0, __m128i &dst1, __m128i a, __m128i b, __m128i c, __m128i c_01, __m128i c_2, __m128i cst, __m128i sign_bit) noexcept
+{
+	a = _mm_xor_si128 (a, sign_bit);
+	b = _mm_xor_si128 (b, sign_bit);
+	c = _mm_xor_si128 (c, sign_bit);
+	const __m128i  zero  = _mm_setzero_si128 ();
+	const __m128i  ab_0  = _mm_unpacklo_epi16 (a, b);
+	const __m128i  ab_1  = _mm_unpackhi_epi16 (a, b);
+	const __m128i  c_0   = _mm_unpacklo_epi16 (c, zero);
+	const __m128i  c_1   = _mm_unpackhi_epi16 (c, zero);
+	dst0 = _mm_add_epi32 (
+		_mm_add_epi32 (_mm_madd_epi16 (ab_0, c_01), _mm_madd_epi16 (c_0, c_2)),
+		cst
+	);
+	dst1 = _mm_add_epi32 (
+		_mm_add_epi32 (_mm_madd_epi16 (ab_1, c_01), _mm_madd_epi16 (c_1, c_2)),
+		cst
+	);
+}
+
+// Packs signed 32-bit values to 16 bits, saturated to [0 ; 65535]. The
+// result is offset by -0x8000 (sign bit toggled).
+static fstb_FORCEINLINE __m128i	Matrix2020CLProc_pack_ofs_sse2 (__m128i src0, __m128i src1) noexcept
+{
+	const __m128i  ofs = _mm_set1_epi32 (0x8000);
+
+	return _mm_packs_epi32 (_mm_sub_epi32 (src0, ofs), _mm_sub_epi32 (src1, ofs));
+}
+
+// Gamma map lookup for 8 unsigned 16-bit values. SSE2 has no gather
+// instruction, so we go through the general-purpose registers.
+static fstb_FORCEINLINE __m128i	Matrix2020CLProc_map_sse2 (const uint16_t *map_ptr, __m128i idx) noexcept
+{
+	__m128i        val = _mm_cvtsi32_si128 (map_ptr [_mm_extract_epi16 (idx, 0)]);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 1)], 1);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 2)], 2);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 3)], 3);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 4)], 4);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 5)], 5);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 6)], 6);
+	val = _mm_insert_epi16 (val, map_ptr [_mm_extract_epi16 (idx, 7)], 7);
+
+	return val;
+}
+
+
+
+#endif   // fstb_ARCHI_X86
+
+
+
 /*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -76,13 +143,14 @@ constexpr int	Matrix2020CLProc::_rgb_int_bits;
 
 
 
-Matrix2020CLProc::Matrix2020CLProc (bool sse2_flag, bool avx2_flag)
+Matrix2020CLProc::Matrix2020CLProc (bool sse2_flag, bool avx2_flag, bool avx512_flag)
 :	_src_fmt (SplFmt_ILLEGAL)
 ,	_src_bits (0)
 ,	_dst_fmt (SplFmt_ILLEGAL)
 ,	_dst_bits (0)
 ,	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
 ,	_to_yuv_flag (false)
 ,	_b12_flag (false)
 ,	_flt_flag (false)
@@ -126,6 +194,13 @@ Matrix2020CLProc::Err	Matrix2020CLProc::configure (bool to_yuv_flag, SplFmt src_
 		ret_val = setup_ycbcr_2_rgb ();
 	}
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	if (ret_val == Err_OK && _avx2_flag)
+	{
+		init_proc_fnc_avx2 ();
+	}
+#endif   // fstb_ARCHI_X86
+
 	return (ret_val);
 }
 
@@ -156,6 +231,21 @@ constexpr int	Matrix2020CLProc::_buf_len;
 
 
 
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+	#define fmtcl_Matrix2020CLProc_SET_SSE2(fnc, DF, DB, SF, SB) \
+			if (_sse2_flag) \
+			{ \
+				_proc_ptr = &ThisType::fnc < \
+					ProxyRwSse2 <fmtcl::SplFmt_##DF>, DB, \
+					ProxyRwSse2 <fmtcl::SplFmt_##SF>, SB \
+				>; \
+			}
+#else    // fstb_ARCHI_X86
+	#define fmtcl_Matrix2020CLProc_SET_SSE2(fnc, DF, DB, SF, SB)
+#endif   // fstb_ARCHI_X86
+
+
+
 Matrix2020CLProc::Err	Matrix2020CLProc::setup_rgb_2_ycbcr ()
 {
 	Err            ret_val = Err_OK;
@@ -179,7 +269,7 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_rgb_2_ycbcr ()
 				*curve_uptr, false,
 				SplFmt_FLOAT, 32, true,
 				SplFmt_FLOAT, 32, _full_range_flag,
-				_sse2_flag, _avx2_flag
+				_sse2_flag, _avx2_flag, _avx512_flag
 			));
 		}
 #endif   // fstb_ARCHI_X86
@@ -194,6 +284,7 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_rgb_2_ycbcr ()
 				ProxyRwCpp <fmtcl::SplFmt_##DF>, DB, \
 				ProxyRwCpp <fmtcl::SplFmt_##SF>, SB \
 			>; \
+			fmtcl_Matrix2020CLProc_SET_SSE2 (conv_rgb_2_ycbcr_sse2_int, DF, DB, SF, SB) \
 			break;
 
 		switch (
@@ -299,7 +390,7 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_ycbcr_2_rgb ()
 				*curve_uptr, false,
 				SplFmt_FLOAT, 32, _full_range_flag,
 				SplFmt_FLOAT, 32, true,
-				_sse2_flag, _avx2_flag
+				_sse2_flag, _avx2_flag, _avx512_flag
 			));
 		}
 #endif   // fstb_ARCHI_X86
@@ -314,6 +405,7 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_ycbcr_2_rgb ()
 				ProxyRwCpp <fmtcl::SplFmt_##DF>, DB, \
 				ProxyRwCpp <fmtcl::SplFmt_##SF>, SB \
 			>; \
+			fmtcl_Matrix2020CLProc_SET_SSE2 (conv_ycbcr_2_rgb_sse2_int, DF, DB, SF, SB) \
 			break;
 
 		switch (
@@ -391,6 +483,10 @@ Matrix2020CLProc::Err	Matrix2020CLProc::setup_ycbcr_2_rgb ()
 
 
 
+#undef fmtcl_Matrix2020CLProc_SET_SSE2
+
+
+
 template <typename DST, int DB, class SRC, int SB>
 void	Matrix2020CLProc::conv_rgb_2_ycbcr_cpp_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
 {
@@ -641,6 +737,149 @@ void	Matrix2020CLProc::conv_ycbcr_2_rgb_cpp_flt (Frame <> dst, FrameRO <> src, i
 
 
 
+template <typename DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+
+	constexpr int  shft2 = _shift_int + _rgb_int_bits - DB;
+	constexpr int  cst_r = 1 << (_shift_int - 1);
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  mi       = sign_bit;
+	const __m128i  ma       = _mm_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+
+	const __m128i  c_rg     = _mm_set1_epi32 (
+		  (_coef_rgby_int [Col_R] & 0xFFFF)
+		+ (_coef_rgby_int [Col_G] << 16)
+	);
+	const __m128i  c_b      = _mm_set1_epi32 (_coef_rgby_int [Col_B] & 0xFFFF);
+	const __m128i  cst_y    = _mm_set1_epi32 (
+		  0x8000 * (  _coef_rgby_int [Col_R]
+		            + _coef_rgby_int [Col_G]
+		            + _coef_rgby_int [Col_B])
+		+ cst_r
+	);
+
+	const __m128i  c_yg_a   = _mm_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m128i  c_yg_b   = _mm_set1_epi32 (_coef_yg_b_int);
+	const __m128i  c_cb_a0  = _mm_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m128i  c_cb_a1  = _mm_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m128i  c_cr_a0  = _mm_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m128i  c_cr_a1  = _mm_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m128i  c_cbcr_b = _mm_set1_epi32 (_coef_cbcr_b_int);
+
+	const uint16_t *  map_ptr = _map_gamma_int.data ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src [0]._ptr);
+		SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src [1]._ptr);
+		SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src [2]._ptr);
+		DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst [0]._ptr);
+		DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst [1]._ptr);
+		DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst [2]._ptr);
+
+		for (int x = 0; x < w; x += 8)
+		{
+			const __m128i  rl = SRC::read_i16 (src_0_ptr, zero);
+			const __m128i  gl = SRC::read_i16 (src_1_ptr, zero);
+			const __m128i  bl = SRC::read_i16 (src_2_ptr, zero);
+
+			__m128i        yl_0;
+			__m128i        yl_1;
+			Matrix2020CLProc_mac3_sse2 (
+				yl_0, yl_1, rl, gl, bl, c_rg, c_b, cst_y, sign_bit
+			);
+			yl_0 = _mm_srai_epi32 (yl_0, _shift_int);
+			yl_1 = _mm_srai_epi32 (yl_1, _shift_int);
+			const __m128i  yl = _mm_xor_si128 (
+				Matrix2020CLProc_pack_ofs_sse2 (yl_0, yl_1), sign_bit
+			);
+
+			const __m128i  yg = Matrix2020CLProc_map_sse2 (map_ptr, yl);
+			const __m128i  bg = Matrix2020CLProc_map_sse2 (map_ptr, bl);
+			const __m128i  rg = Matrix2020CLProc_map_sse2 (map_ptr, rl);
+
+			// Chroma signs: cb < 0 <=> bg < yg
+			const __m128i  yg_s = _mm_xor_si128 (yg, sign_bit);
+			const __m128i  cb_n = _mm_cmplt_epi16 (_mm_xor_si128 (bg, sign_bit), yg_s);
+			const __m128i  cr_n = _mm_cmplt_epi16 (_mm_xor_si128 (rg, sign_bit), yg_s);
+			const __m128i  c_cb = fstb::ToolsSse2::select (cb_n, c_cb_a1, c_cb_a0);
+			const __m128i  c_cr = fstb::ToolsSse2::select (cr_n, c_cr_a1, c_cr_a0);
+
+			// cb * a = bg * a - yg * a, with 32-bit wrap-around
+			__m128i        dy_0;
+			__m128i        dy_1;
+			__m128i        bga_0;
+			__m128i        bga_1;
+			__m128i        ygb_0;
+			__m128i        ygb_1;
+			__m128i        rga_0;
+			__m128i        rga_1;
+			__m128i        ygr_0;
+			__m128i        ygr_1;
+			Matrix2020CLProc_mul_u16_sse2 (dy_0 , dy_1 , yg, c_yg_a);
+			Matrix2020CLProc_mul_u16_sse2 (bga_0, bga_1, bg, c_cb  );
+			Matrix2020CLProc_mul_u16_sse2 (ygb_0, ygb_1, yg, c_cb  );
+			Matrix2020CLProc_mul_u16_sse2 (rga_0, rga_1, rg, c_cr  );
+			Matrix2020CLProc_mul_u16_sse2 (ygr_0, ygr_1, yg, c_cr  );
+
+			dy_0 = _mm_srai_epi32 (_mm_add_epi32 (dy_0, c_yg_b), shft2);
+			dy_1 = _mm_srai_epi32 (_mm_add_epi32 (dy_1, c_yg_b), shft2);
+			const __m128i  dcb_0 = _mm_srai_epi32 (_mm_add_epi32 (
+				_mm_sub_epi32 (bga_0, ygb_0), c_cbcr_b
+			), shft2);
+			const __m128i  dcb_1 = _mm_srai_epi32 (_mm_add_epi32 (
+				_mm_sub_epi32 (bga_1, ygb_1), c_cbcr_b
+			), shft2);
+			const __m128i  dcr_0 = _mm_srai_epi32 (_mm_add_epi32 (
+				_mm_sub_epi32 (rga_0, ygr_0), c_cbcr_b
+			), shft2);
+			const __m128i  dcr_1 = _mm_srai_epi32 (_mm_add_epi32 (
+				_mm_sub_epi32 (rga_1, ygr_1), c_cbcr_b
+			), shft2);
+
+			typedef typename DST::template S16 <true, true> DstS16;
+			DstS16::write_clip (
+				dst_0_ptr, Matrix2020CLProc_pack_ofs_sse2 (dy_0 , dy_1 ),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_1_ptr, Matrix2020CLProc_pack_ofs_sse2 (dcb_0, dcb_1),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_2_ptr, Matrix2020CLProc_pack_ofs_sse2 (dcr_0, dcr_1),
+				mask_lsb, mi, ma, sign_bit
+			);
+
+			SRC::PtrConst::jump (src_0_ptr, 8);
+			SRC::PtrConst::jump (src_1_ptr, 8);
+			SRC::PtrConst::jump (src_2_ptr, 8);
+
+			DST::Ptr::jump (dst_0_ptr, 8);
+			DST::Ptr::jump (dst_1_ptr, 8);
+			DST::Ptr::jump (dst_2_ptr, 8);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
 void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
 {
 	assert (_lut_uptr.get () != 0);
@@ -735,6 +974,156 @@ void	Matrix2020CLProc::conv_rgb_2_ycbcr_sse2_flt (Frame <> dst, FrameRO <> src,
 
 
 
+template <typename DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_sse2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	// Chroma coefficients are used in signed multiplications
+	assert (_coef_cb_a_int [0] < 0x8000);
+	assert (_coef_cb_a_int [1] < 0x8000);
+	assert (_coef_cr_a_int [0] < 0x8000);
+	assert (_coef_cr_a_int [1] < 0x8000);
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+
+	constexpr int  shft2     = _shift_int + SB - _rgb_int_bits;
+	constexpr int  cst_r     = 1 << (_shift_int - 1);
+	constexpr int  ofs_grey  = 1 << (SB - 1);
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  mi       = sign_bit;
+	const __m128i  ma       = _mm_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+	const __m128i  c_grey   = _mm_set1_epi16 (int16_t (ofs_grey));
+
+	const __m128i  c_ry     = _mm_set1_epi32 (
+		  (_coef_rgby_int [Col_R] & 0xFFFF)
+		+ (_coef_rgby_int [Col_G] << 16)
+	);
+	const __m128i  c_b      = _mm_set1_epi32 (_coef_rgby_int [Col_B] & 0xFFFF);
+	const __m128i  cst_g    = _mm_set1_epi32 (
+		  0x8000 * (  _coef_rgby_int [Col_R]
+		            + _coef_rgby_int [Col_G]
+		            + _coef_rgby_int [Col_B])
+		+ cst_r
+	);
+
+	const __m128i  c_yg_a   = _mm_set1_epi16 (int16_t (_coef_yg_a_int));
+	const __m128i  c_yg_b   = _mm_set1_epi32 (_coef_yg_b_int);
+	const __m128i  c_cb_a0  = _mm_set1_epi16 (int16_t (_coef_cb_a_int [0]));
+	const __m128i  c_cb_a1  = _mm_set1_epi16 (int16_t (_coef_cb_a_int [1]));
+	const __m128i  c_cr_a0  = _mm_set1_epi16 (int16_t (_coef_cr_a_int [0]));
+	const __m128i  c_cr_a1  = _mm_set1_epi16 (int16_t (_coef_cr_a_int [1]));
+	const __m128i  c_cbcr_b = _mm_set1_epi32 (_coef_cbcr_b_int);
+
+	const uint16_t *  map_ptr = _map_gamma_int.data ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src [0]._ptr);
+		SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src [1]._ptr);
+		SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src [2]._ptr);
+		DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst [0]._ptr);
+		DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst [1]._ptr);
+		DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst [2]._ptr);
+
+		for (int x = 0; x < w; x += 8)
+		{
+			const __m128i  dy   = SRC::read_i16 (src_0_ptr, zero);
+			const __m128i  dcb  = SRC::read_i16 (src_1_ptr, zero);
+			const __m128i  dcr  = SRC::read_i16 (src_2_ptr, zero);
+
+			const __m128i  dcb0 = _mm_sub_epi16 (dcb, c_grey);
+			const __m128i  dcr0 = _mm_sub_epi16 (dcr, c_grey);
+
+			const __m128i  c_cb = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (dcb0, zero), c_cb_a1, c_cb_a0
+			);
+			const __m128i  c_cr = fstb::ToolsSse2::select (
+				_mm_cmplt_epi16 (dcr0, zero), c_cr_a1, c_cr_a0
+			);
+
+			__m128i        yg_0;
+			__m128i        yg_1;
+			__m128i        cb_0;
+			__m128i        cb_1;
+			__m128i        cr_0;
+			__m128i        cr_1;
+			Matrix2020CLProc_mul_u16_sse2 (yg_0, yg_1, dy, c_yg_a);
+			fstb::ToolsSse2::mul_s16_s16_s32 (cb_0, cb_1, dcb0, c_cb);
+			fstb::ToolsSse2::mul_s16_s16_s32 (cr_0, cr_1, dcr0, c_cr);
+
+			yg_0 = _mm_srai_epi32 (_mm_add_epi32 (yg_0, c_yg_b  ), shft2);
+			yg_1 = _mm_srai_epi32 (_mm_add_epi32 (yg_1, c_yg_b  ), shft2);
+			cb_0 = _mm_srai_epi32 (_mm_add_epi32 (cb_0, c_cbcr_b), shft2);
+			cb_1 = _mm_srai_epi32 (_mm_add_epi32 (cb_1, c_cbcr_b), shft2);
+			cr_0 = _mm_srai_epi32 (_mm_add_epi32 (cr_0, c_cbcr_b), shft2);
+			cr_1 = _mm_srai_epi32 (_mm_add_epi32 (cr_1, c_cbcr_b), shft2);
+
+			const __m128i  bg = _mm_xor_si128 (Matrix2020CLProc_pack_ofs_sse2 (
+				_mm_add_epi32 (cb_0, yg_0), _mm_add_epi32 (cb_1, yg_1)
+			), sign_bit);
+			const __m128i  rg = _mm_xor_si128 (Matrix2020CLProc_pack_ofs_sse2 (
+				_mm_add_epi32 (cr_0, yg_0), _mm_add_epi32 (cr_1, yg_1)
+			), sign_bit);
+			const __m128i  yg = _mm_xor_si128 (
+				Matrix2020CLProc_pack_ofs_sse2 (yg_0, yg_1), sign_bit
+			);
+
+			const __m128i  yl = Matrix2020CLProc_map_sse2 (map_ptr, yg);
+			const __m128i  bl = Matrix2020CLProc_map_sse2 (map_ptr, bg);
+			const __m128i  rl = Matrix2020CLProc_map_sse2 (map_ptr, rg);
+
+			__m128i        gl_0;
+			__m128i        gl_1;
+			Matrix2020CLProc_mac3_sse2 (
+				gl_0, gl_1, rl, yl, bl, c_ry, c_b, cst_g, sign_bit
+			);
+			gl_0 = _mm_srai_epi32 (gl_0, _shift_int);
+			gl_1 = _mm_srai_epi32 (gl_1, _shift_int);
+			gl_0 = _mm_andnot_si128 (_mm_srai_epi32 (gl_0, 31), gl_0);
+			gl_1 = _mm_andnot_si128 (_mm_srai_epi32 (gl_1, 31), gl_1);
+
+			// Keeps only the 16 LSBs, like the reference implementation
+			gl_0 = _mm_srai_epi32 (_mm_slli_epi32 (gl_0, 16), 16);
+			gl_1 = _mm_srai_epi32 (_mm_slli_epi32 (gl_1, 16), 16);
+			const __m128i  gl = _mm_xor_si128 (_mm_packs_epi32 (gl_0, gl_1), sign_bit);
+
+			typedef typename DST::template S16 <true, true> DstS16;
+			DstS16::write_clip (
+				dst_0_ptr, _mm_xor_si128 (rl, sign_bit), mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_1_ptr, gl                          , mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_2_ptr, _mm_xor_si128 (bl, sign_bit), mask_lsb, mi, ma, sign_bit
+			);
+
+			SRC::PtrConst::jump (src_0_ptr, 8);
+			SRC::PtrConst::jump (src_1_ptr, 8);
+			SRC::PtrConst::jump (src_2_ptr, 8);
+
+			DST::Ptr::jump (dst_0_ptr, 8);
+			DST::Ptr::jump (dst_1_ptr, 8);
+			DST::Ptr::jump (dst_2_ptr, 8);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
 void	Matrix2020CLProc::conv_ycbcr_2_rgb_sse2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
 {
 	assert (_lut_uptr.get () != 0);
@@ -34,6 +34,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/SplFmt.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	#include "fmtcl/TransLut.h"
+	#include "AvstpWrapper.h"
 #endif   // fstb_ARCHI_X86
 #include "fstb/ArrayAlign.h"
 
@@ -71,7 +72,7 @@ public:
 	static constexpr int _nbr_planes   =  3;
 	static constexpr int _rgb_int_bits = 16;
 
-	explicit        Matrix2020CLProc (bool sse2_flag, bool avx2_flag);
+	explicit        Matrix2020CLProc (bool sse2_flag, bool avx2_flag, bool avx512_flag);
 	virtual        ~Matrix2020CLProc () {}
 
 	Err            configure (bool to_yuv_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool full_flag);
@@ -118,8 +119,20 @@ private:
 	void           conv_ycbcr_2_rgb_cpp_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
+	template <typename DST, int DB, class SRC, int SB>
+	void           conv_rgb_2_ycbcr_sse2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 	void           conv_rgb_2_ycbcr_sse2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	template <typename DST, int DB, class SRC, int SB>
+	void           conv_ycbcr_2_rgb_sse2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 	void           conv_ycbcr_2_rgb_sse2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+
+	void           init_proc_fnc_avx2 () noexcept;
+	template <typename DST, int DB, class SRC, int SB>
+	void           conv_rgb_2_ycbcr_avx2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	void           conv_rgb_2_ycbcr_avx2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	template <typename DST, int DB, class SRC, int SB>
+	void           conv_ycbcr_2_rgb_avx2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	void           conv_ycbcr_2_rgb_avx2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 #endif   // fstb_ARCHI_X86
 
 	template <typename T>
@@ -136,6 +149,7 @@ private:
 
 	bool           _sse2_flag   = false;
 	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false; // For the TransLut only
 
 	bool           _to_yuv_flag = false;
 	bool           _b12_flag    = false;
@@ -144,7 +158,7 @@ private:
 
 	std::array <int16_t, _nbr_planes>
 	               _coef_rgby_int;
-	std::array <uint16_t, 1 << _rgb_int_bits>
+	std::array <uint16_t, (1 << _rgb_int_bits) + 1> // +1 for the 32-bit AVX2 gathers
 	               _map_gamma_int;
 	uint16_t       _coef_yg_a_int = 0;
 	int32_t        _coef_yg_b_int = 0;
@@ -155,6 +169,9 @@ private:
 	int32_t        _coef_cbcr_b_int = 0;
 
 #if (fstb_ARCHI == fstb_ARCHI_X86)
+	// Keeps the thread pool alive while the LUT is generated
+	AvstpWrapper::PoolRef
+	               _avstp_ref;
 	std::unique_ptr <TransLut>
 	               _lut_uptr;
 #endif   // fstb_ARCHI_X86
@@ -0,0 +1,615 @@
+/*****************************************************************************
+
+        Matrix2020CLProc_avx2.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include "fmtcl/Matrix2020CLProc.h"
+#include "fmtcl/Matrix2020CLProc_macro.h"
+#include "fmtcl/ProxyRwAvx2.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+// Zero-extends the low (k = 0) or high (k = 1) 16-bit words of each 128-bit
+// lane to 32 bits. _mm256_packus_epi32 restores the original order.
+static fstb_FORCEINLINE __m256i	Matrix2020CLProc_unpack_avx2 (__m256i val, int k) noexcept
+{
+	const __m256i  zero = _mm256_setzero_si256 ();
+
+	return (k == 0)
+		? _mm256_unpacklo_epi16 (val, zero)
+		: _mm256_unpackhi_epi16 (val, zero);
+}
+
+// Gamma map lookup for 32-bit indexes in [0 ; 65535]. The gather reads
+// 32 bits, so the table needs one extra element.
+static fstb_FORCEINLINE __m256i	Matrix2020CLProc_map_avx2 (const uint16_t *map_ptr, __m256i idx) noexcept
+{
+	const __m256i  val = _mm256_i32gather_epi32 (
+		reinterpret_cast <const int *> (map_ptr), idx, 2
+	);
+
+	return _mm256_and_si256 (val, _mm256_set1_epi32 (0xFFFF));
+}
+
+// Packs signed 32-bit values to 16 bits, saturated to [0 ; 65535], then
+// offset by -0x8000 for the S16 write functions.
+static fstb_FORCEINLINE __m256i	Matrix2020CLProc_pack_ofs_avx2 (__m256i src0, __m256i src1) noexcept
+{
+	return _mm256_xor_si256 (
+		_mm256_packus_epi32 (src0, src1), _mm256_set1_epi16 (-0x8000)
+	);
+}
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Requires the formats and the coefficients to be already set.
+void	Matrix2020CLProc::init_proc_fnc_avx2 () noexcept
+{
+	if (_flt_flag)
+	{
+		assert (_lut_uptr.get () != nullptr);
+		_proc_ptr =
+			  (_to_yuv_flag)
+			? &ThisType::conv_rgb_2_ycbcr_avx2_flt
+			: &ThisType::conv_ycbcr_2_rgb_avx2_flt;
+		return;
+	}
+
+	const int      sel =
+		  (_dst_fmt  << 17)
+		+ (_dst_bits << 10)
+		+ (_src_fmt  <<  7)
+		+ (_src_bits      );
+
+#define fmtcl_Matrix2020CLProc_CASE_INT(DF, DB, SF, SB) \
+	case   (fmtcl::SplFmt_##DF << 17) + (DB << 10) \
+	     + (fmtcl::SplFmt_##SF <<  7) + (SB      ): \
+		_proc_ptr = &ThisType::fmtcl_Matrix2020CLProc_FNC < \
+			ProxyRwAvx2 <fmtcl::SplFmt_##DF>, DB, \
+			ProxyRwAvx2 <fmtcl::SplFmt_##SF>, SB \
+		>; \
+		break;
+
+	if (_to_yuv_flag)
+	{
+#define fmtcl_Matrix2020CLProc_FNC conv_rgb_2_ycbcr_avx2_int
+		switch (sel)
+		{
+		fmtcl_Matrix2020CLProc_TO_YUV_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+		default:
+			assert (false);
+			break;
+		}
+#undef fmtcl_Matrix2020CLProc_FNC
+	}
+	else
+	{
+#define fmtcl_Matrix2020CLProc_FNC conv_ycbcr_2_rgb_avx2_int
+		switch (sel)
+		{
+		fmtcl_Matrix2020CLProc_TO_RGB_SPAN_I (fmtcl_Matrix2020CLProc_CASE_INT)
+		default:
+			assert (false);
+			break;
+		}
+#undef fmtcl_Matrix2020CLProc_FNC
+	}
+
+#undef fmtcl_Matrix2020CLProc_CASE_INT
+}
+
+
+
+template <typename DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_avx2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename DST::template S16 <true, true> DstS16;
+
+	constexpr int  shft2 = _shift_int + _rgb_int_bits - DB;
+	constexpr int  cst_r = 1 << (_shift_int - 1);
+	constexpr int  ma_int = (1 << _rgb_int_bits) - 1;
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  mi       = sign_bit;
+	const __m256i  ma       = _mm256_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+	const __m256i  c_max    = _mm256_set1_epi32 (ma_int);
+	const __m256i  c_rnd    = _mm256_set1_epi32 (cst_r);
+
+	const __m256i  c_yr     = _mm256_set1_epi32 (_coef_rgby_int [Col_R]);
+	const __m256i  c_yg     = _mm256_set1_epi32 (_coef_rgby_int [Col_G]);
+	const __m256i  c_yb     = _mm256_set1_epi32 (_coef_rgby_int [Col_B]);
+
+	const __m256i  c_yg_a   = _mm256_set1_epi32 (_coef_yg_a_int);
+	const __m256i  c_yg_b   = _mm256_set1_epi32 (_coef_yg_b_int);
+	const __m256i  c_cb_a0  = _mm256_set1_epi32 (_coef_cb_a_int [0]);
+	const __m256i  c_cb_a1  = _mm256_set1_epi32 (_coef_cb_a_int [1]);
+	const __m256i  c_cr_a0  = _mm256_set1_epi32 (_coef_cr_a_int [0]);
+	const __m256i  c_cr_a1  = _mm256_set1_epi32 (_coef_cr_a_int [1]);
+	const __m256i  c_cbcr_b = _mm256_set1_epi32 (_coef_cbcr_b_int);
+
+	const uint16_t *  map_ptr = _map_gamma_int.data ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src [0]._ptr);
+		SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src [1]._ptr);
+		SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src [2]._ptr);
+		DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst [0]._ptr);
+		DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst [1]._ptr);
+		DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst [2]._ptr);
+
+		for (int x = 0; x < w; x += 16)
+		{
+			const __m256i  rl_16 = SRC::read_i16 (src_0_ptr, zero);
+			const __m256i  gl_16 = SRC::read_i16 (src_1_ptr, zero);
+			const __m256i  bl_16 = SRC::read_i16 (src_2_ptr, zero);
+
+			__m256i        dy [2];
+			__m256i        dcb [2];
+			__m256i        dcr [2];
+			for (int k = 0; k < 2; ++k)
+			{
+				const __m256i  rl = Matrix2020CLProc_unpack_avx2 (rl_16, k);
+				const __m256i  gl = Matrix2020CLProc_unpack_avx2 (gl_16, k);
+				const __m256i  bl = Matrix2020CLProc_unpack_avx2 (bl_16, k);
+
+				__m256i        yl = _mm256_add_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (rl, c_yr),
+					_mm256_mullo_epi32 (gl, c_yg)),
+					_mm256_mullo_epi32 (bl, c_yb)
+				);
+				yl = _mm256_srai_epi32 (_mm256_add_epi32 (yl, c_rnd), _shift_int);
+				yl = _mm256_min_epi32 (_mm256_max_epi32 (yl, zero), c_max);
+
+				const __m256i  yg = Matrix2020CLProc_map_avx2 (map_ptr, yl);
+				const __m256i  bg = Matrix2020CLProc_map_avx2 (map_ptr, bl);
+				const __m256i  rg = Matrix2020CLProc_map_avx2 (map_ptr, rl);
+
+				const __m256i  cb = _mm256_sub_epi32 (bg, yg);
+				const __m256i  cr = _mm256_sub_epi32 (rg, yg);
+
+				const __m256i  c_cb = _mm256_blendv_epi8 (
+					c_cb_a0, c_cb_a1, _mm256_cmpgt_epi32 (zero, cb)
+				);
+				const __m256i  c_cr = _mm256_blendv_epi8 (
+					c_cr_a0, c_cr_a1, _mm256_cmpgt_epi32 (zero, cr)
+				);
+
+				dy [k]  = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (yg, c_yg_a), c_yg_b
+				), shft2);
+				dcb [k] = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (cb, c_cb), c_cbcr_b
+				), shft2);
+				dcr [k] = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (cr, c_cr), c_cbcr_b
+				), shft2);
+			}
+
+			DstS16::write_clip (
+				dst_0_ptr, Matrix2020CLProc_pack_ofs_avx2 (dy [0] , dy [1] ),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_1_ptr, Matrix2020CLProc_pack_ofs_avx2 (dcb [0], dcb [1]),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_2_ptr, Matrix2020CLProc_pack_ofs_avx2 (dcr [0], dcr [1]),
+				mask_lsb, mi, ma, sign_bit
+			);
+
+			SRC::PtrConst::jump (src_0_ptr, 16);
+			SRC::PtrConst::jump (src_1_ptr, 16);
+			SRC::PtrConst::jump (src_2_ptr, 16);
+
+			DST::Ptr::jump (dst_0_ptr, 16);
+			DST::Ptr::jump (dst_1_ptr, 16);
+			DST::Ptr::jump (dst_2_ptr, 16);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+void	Matrix2020CLProc::conv_rgb_2_ycbcr_avx2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (_lut_uptr.get () != 0);
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	BufAlign       tmp_buf_arr;
+
+	const __m256   c_yr   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_R]));
+	const __m256   c_yg   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_G]));
+	const __m256   c_yb   = _mm256_set1_ps (float (_coef_rgb_to_y_dbl [Col_B]));
+
+	const __m256   c_cb_n = _mm256_set1_ps (float (1 / _coef_cb_neg));
+	const __m256   c_cb_p = _mm256_set1_ps (float (1 / _coef_cb_pos));
+	const __m256   c_cr_n = _mm256_set1_ps (float (1 / _coef_cr_neg));
+	const __m256   c_cr_p = _mm256_set1_ps (float (1 / _coef_cr_pos));
+
+	const __m256   zero   = _mm256_setzero_ps ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		FrameRO <float>   s { src };
+		Frame <float>     d { dst };
+
+		for (int x_buf = 0; x_buf < w; x_buf += _buf_len)
+		{
+			const int      w_work = std::min <int> (w - x_buf, _buf_len);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   rl = _mm256_loadu_ps (s [0]._ptr + x);
+				const __m256   gl = _mm256_loadu_ps (s [1]._ptr + x);
+				const __m256   bl = _mm256_loadu_ps (s [2]._ptr + x);
+				const __m256   yl = _mm256_add_ps (_mm256_add_ps (
+					_mm256_mul_ps (rl, c_yr),
+					_mm256_mul_ps (gl, c_yg)),
+					_mm256_mul_ps (bl, c_yb)
+				);
+				_mm256_store_ps (&tmp_buf_arr [0] [x], yl);
+			}
+
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (d [0]._ptr), 0 },
+				{ reinterpret_cast <const uint8_t *> (tmp_buf_arr [0].data ()), 0 },
+				w_work, 1
+			);
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (tmp_buf_arr [1].data ()), 0 },
+				{ reinterpret_cast <const uint8_t *> (s [2]._ptr), 0 },
+				w_work, 1
+			);
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (tmp_buf_arr [2].data ()), 0 },
+				{ reinterpret_cast <const uint8_t *> (s [0]._ptr), 0 },
+				w_work, 1
+			);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yg   = _mm256_loadu_ps (d [0]._ptr + x);
+				const __m256   bg   = _mm256_load_ps (&tmp_buf_arr [1] [x]);
+				const __m256   rg   = _mm256_load_ps (&tmp_buf_arr [2] [x]);
+
+				const __m256   cb   = _mm256_sub_ps (bg, yg);
+				const __m256   cr   = _mm256_sub_ps (rg, yg);
+
+				const __m256   cb_n = _mm256_cmp_ps (cb, zero, _CMP_LT_OQ);
+				const __m256   cr_n = _mm256_cmp_ps (cr, zero, _CMP_LT_OQ);
+
+				const __m256   c_cb = _mm256_blendv_ps (c_cb_p, c_cb_n, cb_n);
+				const __m256   c_cr = _mm256_blendv_ps (c_cr_p, c_cr_n, cr_n);
+
+				const __m256   dcb  = _mm256_mul_ps (cb, c_cb);
+				const __m256   dcr  = _mm256_mul_ps (cr, c_cr);
+
+				_mm256_storeu_ps (d [1]._ptr + x, dcb);
+				_mm256_storeu_ps (d [2]._ptr + x, dcr);
+			}
+
+			s.step_pix (_buf_len);
+			d.step_pix (_buf_len);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <typename DST, int DB, class SRC, int SB>
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_avx2_int (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+	typedef typename DST::template S16 <true, true> DstS16;
+
+	constexpr int  shft2     = _shift_int + SB - _rgb_int_bits;
+	constexpr int  cst_r     = 1 << (_shift_int - 1);
+	constexpr int  ma_int    = (1 << _rgb_int_bits) - 1;
+	constexpr int  ofs_grey  = 1 << (SB - 1);
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  mi       = sign_bit;
+	const __m256i  ma       = _mm256_set1_epi16 (int16_t ((1 << DB) - 1 - 0x8000));
+	const __m256i  c_max    = _mm256_set1_epi32 (ma_int);
+	const __m256i  c_rnd    = _mm256_set1_epi32 (cst_r);
+	const __m256i  c_grey   = _mm256_set1_epi32 (ofs_grey);
+
+	const __m256i  c_gr     = _mm256_set1_epi32 (_coef_rgby_int [Col_R]);
+	const __m256i  c_gy     = _mm256_set1_epi32 (_coef_rgby_int [Col_G]);
+	const __m256i  c_gb     = _mm256_set1_epi32 (_coef_rgby_int [Col_B]);
+
+	const __m256i  c_yg_a   = _mm256_set1_epi32 (_coef_yg_a_int);
+	const __m256i  c_yg_b   = _mm256_set1_epi32 (_coef_yg_b_int);
+	const __m256i  c_cb_a0  = _mm256_set1_epi32 (_coef_cb_a_int [0]);
+	const __m256i  c_cb_a1  = _mm256_set1_epi32 (_coef_cb_a_int [1]);
+	const __m256i  c_cr_a0  = _mm256_set1_epi32 (_coef_cr_a_int [0]);
+	const __m256i  c_cr_a1  = _mm256_set1_epi32 (_coef_cr_a_int [1]);
+	const __m256i  c_cbcr_b = _mm256_set1_epi32 (_coef_cbcr_b_int);
+
+	const uint16_t *  map_ptr = _map_gamma_int.data ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src [0]._ptr);
+		SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src [1]._ptr);
+		SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src [2]._ptr);
+		DstPtr         dst_0_ptr = DST::Ptr::make_ptr (dst [0]._ptr);
+		DstPtr         dst_1_ptr = DST::Ptr::make_ptr (dst [1]._ptr);
+		DstPtr         dst_2_ptr = DST::Ptr::make_ptr (dst [2]._ptr);
+
+		for (int x = 0; x < w; x += 16)
+		{
+			const __m256i  dy_16  = SRC::read_i16 (src_0_ptr, zero);
+			const __m256i  dcb_16 = SRC::read_i16 (src_1_ptr, zero);
+			const __m256i  dcr_16 = SRC::read_i16 (src_2_ptr, zero);
+
+			__m256i        rl [2];
+			__m256i        gl [2];
+			__m256i        bl [2];
+			for (int k = 0; k < 2; ++k)
+			{
+				const __m256i  dy   = Matrix2020CLProc_unpack_avx2 (dy_16, k);
+				const __m256i  dcb0 = _mm256_sub_epi32 (
+					Matrix2020CLProc_unpack_avx2 (dcb_16, k), c_grey
+				);
+				const __m256i  dcr0 = _mm256_sub_epi32 (
+					Matrix2020CLProc_unpack_avx2 (dcr_16, k), c_grey
+				);
+
+				const __m256i  c_cb = _mm256_blendv_epi8 (
+					c_cb_a0, c_cb_a1, _mm256_cmpgt_epi32 (zero, dcb0)
+				);
+				const __m256i  c_cr = _mm256_blendv_epi8 (
+					c_cr_a0, c_cr_a1, _mm256_cmpgt_epi32 (zero, dcr0)
+				);
+
+				__m256i        yg = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (dy, c_yg_a), c_yg_b
+				), shft2);
+				const __m256i  cb = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (dcb0, c_cb), c_cbcr_b
+				), shft2);
+				const __m256i  cr = _mm256_srai_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (dcr0, c_cr), c_cbcr_b
+				), shft2);
+
+				const __m256i  bg = _mm256_max_epi32 (_mm256_min_epi32 (
+					_mm256_add_epi32 (cb, yg), c_max
+				), zero);
+				const __m256i  rg = _mm256_max_epi32 (_mm256_min_epi32 (
+					_mm256_add_epi32 (cr, yg), c_max
+				), zero);
+				yg = _mm256_max_epi32 (_mm256_min_epi32 (yg, c_max), zero);
+
+				const __m256i  yl = Matrix2020CLProc_map_avx2 (map_ptr, yg);
+				bl [k] = Matrix2020CLProc_map_avx2 (map_ptr, bg);
+				rl [k] = Matrix2020CLProc_map_avx2 (map_ptr, rg);
+
+				__m256i        g = _mm256_add_epi32 (_mm256_add_epi32 (
+					_mm256_mullo_epi32 (rl [k], c_gr),
+					_mm256_mullo_epi32 (yl    , c_gy)),
+					_mm256_mullo_epi32 (bl [k], c_gb)
+				);
+				g = _mm256_srai_epi32 (_mm256_add_epi32 (g, c_rnd), _shift_int);
+				g = _mm256_max_epi32 (g, zero);
+
+				// Keeps only the 16 LSBs, like the reference implementation
+				gl [k] = _mm256_and_si256 (g, c_max);
+			}
+
+			DstS16::write_clip (
+				dst_0_ptr, Matrix2020CLProc_pack_ofs_avx2 (rl [0], rl [1]),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_1_ptr, Matrix2020CLProc_pack_ofs_avx2 (gl [0], gl [1]),
+				mask_lsb, mi, ma, sign_bit
+			);
+			DstS16::write_clip (
+				dst_2_ptr, Matrix2020CLProc_pack_ofs_avx2 (bl [0], bl [1]),
+				mask_lsb, mi, ma, sign_bit
+			);
+
+			SRC::PtrConst::jump (src_0_ptr, 16);
+			SRC::PtrConst::jump (src_1_ptr, 16);
+			SRC::PtrConst::jump (src_2_ptr, 16);
+
+			DST::Ptr::jump (dst_0_ptr, 16);
+			DST::Ptr::jump (dst_1_ptr, 16);
+			DST::Ptr::jump (dst_2_ptr, 16);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+void	Matrix2020CLProc::conv_ycbcr_2_rgb_avx2_flt (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (_lut_uptr.get () != 0);
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	BufAlign       tmp_buf_arr;
+
+	const __m256   c_rl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_R]));
+	const __m256   c_gl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_G]));
+	const __m256   c_bl   = _mm256_set1_ps (float (_coef_ryb_to_g_dbl [Col_B]));
+
+	const __m256   c_cb_n = _mm256_set1_ps (float (_coef_cb_neg));
+	const __m256   c_cb_p = _mm256_set1_ps (float (_coef_cb_pos));
+	const __m256   c_cr_n = _mm256_set1_ps (float (_coef_cr_neg));
+	const __m256   c_cr_p = _mm256_set1_ps (float (_coef_cr_pos));
+
+	const __m256   zero   = _mm256_setzero_ps ();
+
+	for (int y = 0; y < h; ++y)
+	{
+		FrameRO <float>   s { src };
+		Frame <float>     d { dst };
+
+		for (int x_buf = 0; x_buf < w; x_buf += _buf_len)
+		{
+			const int      w_work = std::min <int> (w - x_buf, _buf_len);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yg   = _mm256_loadu_ps (s [0]._ptr + x);
+				const __m256   dcb  = _mm256_loadu_ps (s [1]._ptr + x);
+				const __m256   dcr  = _mm256_loadu_ps (s [2]._ptr + x);
+
+				const __m256   cb_n = _mm256_cmp_ps (dcb, zero, _CMP_LT_OQ);
+				const __m256   cr_n = _mm256_cmp_ps (dcr, zero, _CMP_LT_OQ);
+
+				const __m256   c_cb = _mm256_blendv_ps (c_cb_p, c_cb_n, cb_n);
+				const __m256   c_cr = _mm256_blendv_ps (c_cr_p, c_cr_n, cr_n);
+
+				const __m256   cb   = _mm256_mul_ps (dcb, c_cb);
+				const __m256   cr   = _mm256_mul_ps (dcr, c_cr);
+
+				const __m256   bg   = _mm256_add_ps (cb, yg);
+				const __m256   rg   = _mm256_add_ps (cr, yg);
+
+				_mm256_store_ps (&tmp_buf_arr [1] [x], bg);
+				_mm256_store_ps (&tmp_buf_arr [2] [x], rg);
+			}
+
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (tmp_buf_arr [0].data ()), 0 },
+				{ reinterpret_cast <const uint8_t *> (s [0]._ptr), 0 },
+				w_work, 1
+			);
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (d [2]._ptr), 0 },
+				{ reinterpret_cast <const uint8_t *> (tmp_buf_arr [1].data ()), 0 },
+				w_work, 1
+			);
+			_lut_uptr->process_plane (
+				{ reinterpret_cast <      uint8_t *> (d [0]._ptr), 0 },
+				{ reinterpret_cast <const uint8_t *> (tmp_buf_arr [2].data ()), 0 },
+				w_work, 1
+			);
+
+			for (int x = 0; x < w_work; x += 8)
+			{
+				const __m256   yl = _mm256_load_ps (&tmp_buf_arr [0] [x]);
+				const __m256   bl = _mm256_loadu_ps (d [2]._ptr + x);
+				const __m256   rl = _mm256_loadu_ps (d [0]._ptr + x);
+				const __m256   gl = _mm256_add_ps (_mm256_add_ps (
+					_mm256_mul_ps (yl, c_gl),
+					_mm256_mul_ps (bl, c_bl)),
+					_mm256_mul_ps (rl, c_rl)
+				);
+				_mm256_storeu_ps (d [1]._ptr + x, gl);
+			}
+
+			s.step_pix (_buf_len);
+			d.step_pix (_buf_len);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
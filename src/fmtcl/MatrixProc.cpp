@@ -41,6 +41,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fstb/fnc.h"
 
 #include <algorithm>
+#include <array>
 
 #include <cassert>
 #include <climits>
@@ -56,11 +57,13 @@ namespace fmtcl
 
 
 
-MatrixProc::MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag)
+MatrixProc::MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag)
 :	_sse_flag (sse_flag)
 ,	_sse2_flag (sse2_flag)
 ,	_avx_flag (avx_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_fp16_conv (sse2_flag, avx2_flag)
 {
 	// Nothing
 }
@@ -79,13 +82,28 @@ MatrixProc::Err	MatrixProc::configure (const Mat4 &m, bool int_proc_flag, SplFmt
 	assert (dst_bits >= 8);
 	assert (dst_bits <= 32);
 	assert (plane_out < _nbr_planes);
-	assert (   (dst_fmt == SplFmt_FLOAT && src_fmt == SplFmt_FLOAT)
-	        || (dst_fmt != SplFmt_FLOAT && src_fmt != SplFmt_FLOAT));
+	assert (SplFmt_is_float (dst_fmt) == SplFmt_is_float (src_fmt));
 
 	Err            ret_val = Err_OK;
 	_proc_ptr          = nullptr;
+	_proc_flt_ptr      = nullptr;
+	_perf_simd         = PerfTrace::Simd_CPP;
 	_single_plane_flag = (plane_out >= 0);
 
+	// Half-float data is processed as float
+	_src_fp16_flag     = (src_fmt == SplFmt_FLOAT16);
+	_dst_fp16_flag     = (dst_fmt == SplFmt_FLOAT16);
+	if (_src_fp16_flag)
+	{
+		src_fmt  = SplFmt_FLOAT;
+		src_bits = 32;
+	}
+	if (_dst_fp16_flag)
+	{
+		dst_fmt  = SplFmt_FLOAT;
+		dst_bits = 32;
+	}
+
 	// Integer
 	if (int_proc_flag)
 	{
@@ -145,46 +163,87 @@ MatrixProc::Err	MatrixProc::configure (const Mat4 &m, bool int_proc_flag, SplFmt
 	{
 		if (_sse_flag)
 		{
+			const auto     proc_old_ptr = _proc_ptr;
 			setup_fnc_sse (
 				int_proc_flag,
 				src_fmt, src_bits,
 				dst_fmt, dst_bits,
 				_single_plane_flag
 			);
+			if (_proc_ptr != proc_old_ptr)
+			{
+				_perf_simd = PerfTrace::Simd_SSE;
+			}
 		}
 
 		if (_sse2_flag)
 		{
+			const auto     proc_old_ptr = _proc_ptr;
 			setup_fnc_sse2 (
 				int_proc_flag,
 				src_fmt, src_bits,
 				dst_fmt, dst_bits,
 				_single_plane_flag
 			);
+			if (_proc_ptr != proc_old_ptr)
+			{
+				_perf_simd = PerfTrace::Simd_SSE2;
+			}
 		}
 
 		if (_avx_flag)
 		{
+			const auto     proc_old_ptr = _proc_ptr;
 			setup_fnc_avx (
 				int_proc_flag,
 				src_fmt, src_bits,
 				dst_fmt, dst_bits,
 				_single_plane_flag
 			);
+			if (_proc_ptr != proc_old_ptr)
+			{
+				_perf_simd = PerfTrace::Simd_AVX;
+			}
 		}
 
 		if (_avx2_flag)
 		{
+			const auto     proc_old_ptr = _proc_ptr;
 			setup_fnc_avx2 (
 				int_proc_flag,
 				src_fmt, src_bits,
 				dst_fmt, dst_bits,
 				_single_plane_flag
 			);
+			if (_proc_ptr != proc_old_ptr)
+			{
+				_perf_simd = PerfTrace::Simd_AVX2;
+			}
+		}
+
+		if (_avx512_flag)
+		{
+			const auto     proc_old_ptr = _proc_ptr;
+			setup_fnc_avx512 (
+				int_proc_flag,
+				src_fmt, src_bits,
+				dst_fmt, dst_bits,
+				_single_plane_flag
+			);
+			if (_proc_ptr != proc_old_ptr)
+			{
+				_perf_simd = PerfTrace::Simd_AVX512;
+			}
 		}
 	}
 #endif   // fstb_ARCHI_X86
 
+	if (ret_val == Err_OK && (_src_fp16_flag || _dst_fp16_flag))
+	{
+		_proc_flt_ptr = _proc_ptr;
+		_proc_ptr     = &ThisType::process_fp16;
+	}
+
 	return (ret_val);
 }
 
@@ -195,6 +254,20 @@ void	MatrixProc::process (const ProcComp3Arg &arg) const
 	assert (_proc_ptr != nullptr);
 	assert (arg.is_valid (_single_plane_flag));
 
+	PerfTrace::Scope  perf_scope (
+		"MatrixProc", _perf_simd, int64_t (arg._w) * arg._h
+	);
+
+	(this->*_proc_ptr) (arg._dst, arg._src, arg._w, arg._h);
+}
+
+
+
+void	MatrixProc::process_chunk (const ProcComp3Arg &arg) const noexcept
+{
+	assert (_proc_ptr != nullptr);
+	assert (arg.is_valid (_single_plane_flag));
+
 	(this->*_proc_ptr) (arg._dst, arg._src, arg._w, arg._h);
 }
 
@@ -311,9 +384,11 @@ MatrixProc::Err	MatrixProc::set_matrix_int (const Mat4 &m, int plane_out, int sr
 				// Multiplicative coefficient
 				if (! add_flag)
 				{
+					// The bias must use the quantized coefficient to cancel
+					// exactly the sign offset of the source.
 					if (src_bits == 16)
 					{
-						bias_flt += c;
+						bias_flt += c_int / cintsc;
 					}
 
 					if (c_sse2 < -0x8000 || c_sse2 > 0x7FFF)
@@ -606,6 +681,78 @@ void	MatrixProc::process_1_flt_cpp (Frame <> dst, FrameRO <> src, int w, int h)
 
 
 
+// Converts the half-float lines by chunks into temporary buffers and
+// processes them with the float function.
+void	MatrixProc::process_fp16 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (w > 0);
+	assert (h > 0);
+	assert (_proc_flt_ptr != nullptr);
+
+	// Multiple of the SIMD vector length, the float functions process the
+	// lines by full vectors.
+	constexpr int  chunk_len    = 512;
+	typedef std::array <float, chunk_len> Buf;
+	alignas (64) std::array <Buf, _nbr_planes> buf_s_arr;
+	alignas (64) std::array <Buf, _nbr_planes> buf_d_arr;
+	const int      nbr_planes_d = (_single_plane_flag) ? 1 : _nbr_planes;
+
+	for (int y = 0; y < h; ++y)
+	{
+		const FrameRO <uint16_t>   s16 { src };
+		const Frame <uint16_t>     d16 { dst };
+		const FrameRO <float>      s32 { src };
+		const Frame <float>        d32 { dst };
+		FrameRO <float>            s_chk { src };
+		Frame <float>              d_chk { dst };
+
+		for (int x = 0; x < w; x += chunk_len)
+		{
+			const int      len = std::min (w - x, chunk_len);
+
+			for (int p = 0; p < _nbr_planes; ++p)
+			{
+				if (_src_fp16_flag)
+				{
+					_fp16_conv.conv_to_flt (
+						buf_s_arr [p].data (), s16 [p]._ptr + x, len
+					);
+					s_chk [p]._ptr = buf_s_arr [p].data ();
+				}
+				else
+				{
+					s_chk [p]._ptr = s32 [p]._ptr + x;
+				}
+			}
+			for (int p = 0; p < nbr_planes_d; ++p)
+			{
+				d_chk [p]._ptr =
+					(_dst_fp16_flag) ? buf_d_arr [p].data () : d32 [p]._ptr + x;
+			}
+
+			(this->*_proc_flt_ptr) (d_chk, s_chk, len, 1);
+
+			if (_dst_fp16_flag)
+			{
+				for (int p = 0; p < nbr_planes_d; ++p)
+				{
+					_fp16_conv.conv_to_fp16 (
+						d16 [p]._ptr + x, buf_d_arr [p].data (), len
+					);
+				}
+			}
+		}
+
+		src.step_line ();
+		for (int p = 0; p < nbr_planes_d; ++p)
+		{
+			dst [p].step_line ();
+		}
+	}
+}
+
+
+
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 
 
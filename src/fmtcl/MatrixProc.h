@@ -29,9 +29,11 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fstb/def.h"
 #include "fmtcl/CoefArrInt.h"
+#include "fmtcl/Fp16Conv.h"
 #include "fmtcl/Frame.h"
 #include "fmtcl/FrameRO.h"
 #include "fmtcl/Mat4.h"
+#include "fmtcl/PerfTrace.h"
 #include "fmtcl/SplFmt.h"
 
 #include <vector>
@@ -67,7 +69,9 @@ public:
 	static constexpr int _nbr_planes = 3;
 	static constexpr int _mat_size   = _nbr_planes + 1;
 
-	explicit       MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag);
+	// avx512_flag requires AVX-512F and AVX-512BW, and is used only with
+	// avx2_flag.
+	explicit       MatrixProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag);
 	virtual        ~MatrixProc () {}
 
 	Err            configure (const Mat4 &m, bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, int plane_out);
@@ -77,6 +81,10 @@ public:
 	/*** To do: remove this stack16 constraint ***/
 	void           process (const ProcComp3Arg &arg) const;
 
+	// Same as process(), without performance trace. For the engines calling
+	// the matrix on small chunks of a frame and reporting it as a whole.
+	void           process_chunk (const ProcComp3Arg &arg) const noexcept;
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -99,6 +107,7 @@ private:
 	void           setup_fnc_sse2 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 	void           setup_fnc_avx (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 	void           setup_fnc_avx2 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
+	void           setup_fnc_avx512 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag);
 #endif   // fstb_ARCHI_X86
 
 	template <typename DST, int DB, class SRC, int SB>
@@ -109,6 +118,8 @@ private:
 	void           process_3_flt_cpp (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 	void           process_1_flt_cpp (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 
+	void           process_fp16 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	template <class DST, int DB, class SRC, int SB, int NP>
 	void           process_n_int_sse2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
@@ -119,17 +130,32 @@ private:
 	void           process_n_int_avx2 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 	void           process_3_flt_avx (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 	void           process_1_flt_avx (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+
+	template <class DST, int DB, class SRC, int SB, int NP>
+	void           process_n_int_avx512 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
+	void           process_3_flt_avx512 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept;
 #endif   // fstb_ARCHI_X86
 
-	bool           _sse_flag  = false;
-	bool           _sse2_flag = false;
-	bool           _avx_flag  = false;
-	bool           _avx2_flag = false;
+	bool           _sse_flag    = false;
+	bool           _sse2_flag   = false;
+	bool           _avx_flag    = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false;
 
 	bool           _single_plane_flag = false;
 
+	// Half-float input or output. The processing is done in float by
+	// _proc_flt_ptr, on converted data.
+	bool           _src_fp16_flag = false;
+	bool           _dst_fp16_flag = false;
+	Fp16Conv       _fp16_conv;
+
 	void (ThisType::*                   // 0 = not set
 	               _proc_ptr) (Frame <> dst, FrameRO <> src, int w, int h) const noexcept = nullptr;
+	void (ThisType::*
+	               _proc_flt_ptr) (Frame <> dst, FrameRO <> src, int w, int h) const noexcept = nullptr;
+	PerfTrace::Simd                  // Path of _proc_ptr, for the performance traces
+	               _perf_simd = PerfTrace::Simd_CPP;
 
 	std::vector <float>
 	               _coef_flt_arr;
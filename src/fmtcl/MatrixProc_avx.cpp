@@ -152,7 +152,7 @@ void	MatrixProc::process_1_flt_avx (Frame <> dst, FrameRO <> src, int w, int h)
 		const FrameRO <float>   s { src };
 		const Plane <float>     d { dst [0] };
 
-		for (int x = 0; x < w; x += 4)
+		for (int x = 0; x < w; x += 8)
 		{
 			const __m256   s0 = _mm256_load_ps (s [0]._ptr + x);
 			const __m256   s1 = _mm256_load_ps (s [1]._ptr + x);
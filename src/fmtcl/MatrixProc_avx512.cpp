@@ -0,0 +1,273 @@
+/*****************************************************************************
+
+        MatrixProc_avx512.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX512 (AVX-512F and AVX-512BW) in order to avoid
+SSE/AVX state switch slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/MatrixProc_macro.h"
+#include "fmtcl/ProxyRwAvx512.h"
+#include "fstb/ToolsAvx512.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Requires the AVX2 layout for the integer coefficients
+void	MatrixProc::setup_fnc_avx512 (bool int_proc_flag, SplFmt src_fmt, int src_bits, SplFmt dst_fmt, int dst_bits, bool single_plane_flag)
+{
+	// Integer
+	if (int_proc_flag)
+	{
+#define fmtcl_MatrixProc_CASE_INT(DF, DB, SF, SB) \
+		case   (fmtcl::SplFmt_##DF << 18) + (DB << 11) \
+		     + (fmtcl::SplFmt_##SF <<  8) + (SB <<  1) + 0: \
+			_proc_ptr = &ThisType::process_n_int_avx512 < \
+				ProxyRwAvx512 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx512 <fmtcl::SplFmt_##SF>, SB, 3 \
+			>; \
+			break; \
+		case   (fmtcl::SplFmt_##DF << 18) + (DB << 11) \
+		     + (fmtcl::SplFmt_##SF <<  8) + (SB <<  1) + 1: \
+			_proc_ptr = &ThisType::process_n_int_avx512 < \
+				ProxyRwAvx512 <fmtcl::SplFmt_##DF>, DB, \
+				ProxyRwAvx512 <fmtcl::SplFmt_##SF>, SB, 1 \
+			>; \
+			break;
+
+		switch (
+			  (dst_fmt  << 18)
+			+ (dst_bits << 11)
+			+ (src_fmt  <<  8)
+			+ (src_bits <<  1)
+			+ (single_plane_flag ? 1 : 0)
+		)
+		{
+		fmtcl_MatrixProc_SPAN_I (fmtcl_MatrixProc_CASE_INT)
+		// No default, format combination is already checked
+		// and the C++ code fills all the possibilities.
+		}
+#undef fmtcl_MatrixProc_CASE_INT
+	}
+
+	// Float. The single-plane version remains AVX.
+	else if (! single_plane_flag)
+	{
+		_proc_ptr = &ThisType::process_3_flt_avx512;
+	}
+}
+
+
+
+// DST and SRC are ProxyRwAvx512 classes
+// Same calculations as process_n_int_avx2(), 32 pixels at once. The end of
+// the lines is processed with masked loads and stores.
+template <class DST, int DB, class SRC, int SB, int NP>
+void	MatrixProc::process_n_int_avx512 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (NP         , h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	typedef typename SRC::PtrConst::Type SrcPtr;
+	typedef typename DST::Ptr::Type      DstPtr;
+
+	typedef typename SRC::template S16 <false     , (SB == 16)> SrcS16R;
+	typedef typename DST::template S16 <(DB != 16), (DB == 16)> DstS16W;
+
+	const int      packsize = 32;
+
+	const __m512i  zero     = _mm512_setzero_si512 ();
+	const __m512i  sign_bit = _mm512_set1_epi16 (-0x8000);
+	const __m512i  ma       = _mm512_set1_epi16 (int16_t (uint16_t ((1 << DB) - 1)));
+
+	// The AVX2 vectors have the same content in both 128-bit lanes.
+	const __m256i* coef_ptr = reinterpret_cast <const __m256i *> (
+		_coef_simd_arr.use_vect_avx2 (0)
+	);
+	__m512i        coef_arr [_nbr_planes * _mat_size];
+	for (int k = 0; k < _nbr_planes * _mat_size; ++k)
+	{
+		coef_arr [k] = _mm512_broadcast_i64x4 (_mm256_load_si256 (coef_ptr + k));
+	}
+
+	const int      w32    = w & -packsize;
+	const int      w31    = w - w32;
+	const __mmask32   m_full = ProxyRwAvx512Mask::make_32 (packsize);
+	const __mmask32   m_last = ProxyRwAvx512Mask::make_32 (w31);
+
+	for (int y = 0; y < h; ++y)
+	{
+		// Looping over lines then over planes helps keeping input data
+		// in the cache.
+		for (int plane_index = 0; plane_index < NP; ++ plane_index)
+		{
+			SrcPtr         src_0_ptr = SRC::PtrConst::make_ptr (src [0]._ptr);
+			SrcPtr         src_1_ptr = SRC::PtrConst::make_ptr (src [1]._ptr);
+			SrcPtr         src_2_ptr = SRC::PtrConst::make_ptr (src [2]._ptr);
+
+			DstPtr         dst_ptr   = DST::Ptr::make_ptr (dst [plane_index]._ptr);
+			const __m512i* c_ptr     = coef_arr + plane_index * _mat_size;
+
+			for (int x = 0; x < w; x += packsize)
+			{
+				const __mmask32   m = (x < w32) ? m_full : m_last;
+
+				const __m512i  s0 = SrcS16R::read (src_0_ptr, sign_bit, m);
+				const __m512i  s1 = SrcS16R::read (src_1_ptr, sign_bit, m);
+				const __m512i  s2 = SrcS16R::read (src_2_ptr, sign_bit, m);
+
+				__m512i        d0 = c_ptr [_nbr_planes];
+				__m512i        d1 = d0;
+
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s0, c_ptr [0]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s1, c_ptr [1]);
+				fstb::ToolsAvx512::mac_s16_s16_s32 (d0, d1, s2, c_ptr [2]);
+
+				d0 = _mm512_srai_epi32 (d0, _shift_int + SB - DB);
+				d1 = _mm512_srai_epi32 (d1, _shift_int + SB - DB);
+
+				const __m512i  val = _mm512_packs_epi32 (d0, d1);
+
+				DstS16W::write_clip (dst_ptr, val, zero, ma, sign_bit, m);
+
+				SRC::PtrConst::jump (src_0_ptr, packsize);
+				SRC::PtrConst::jump (src_1_ptr, packsize);
+				SRC::PtrConst::jump (src_2_ptr, packsize);
+
+				DST::Ptr::jump (dst_ptr, packsize);
+			}
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+// Same operation order as process_3_flt_avx()
+void	MatrixProc::process_3_flt_avx512 (Frame <> dst, FrameRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (_nbr_planes, h));
+	assert (src.is_valid (_nbr_planes, h));
+	assert (w > 0);
+	assert (h > 0);
+
+	static_assert (_nbr_planes == 3, "Code is hardcoded for 3 planes");
+
+	const __m512   c00 = _mm512_set1_ps (_coef_flt_arr [ 0]);
+	const __m512   c01 = _mm512_set1_ps (_coef_flt_arr [ 1]);
+	const __m512   c02 = _mm512_set1_ps (_coef_flt_arr [ 2]);
+	const __m512   c03 = _mm512_set1_ps (_coef_flt_arr [ 3]);
+	const __m512   c04 = _mm512_set1_ps (_coef_flt_arr [ 4]);
+	const __m512   c05 = _mm512_set1_ps (_coef_flt_arr [ 5]);
+	const __m512   c06 = _mm512_set1_ps (_coef_flt_arr [ 6]);
+	const __m512   c07 = _mm512_set1_ps (_coef_flt_arr [ 7]);
+	const __m512   c08 = _mm512_set1_ps (_coef_flt_arr [ 8]);
+	const __m512   c09 = _mm512_set1_ps (_coef_flt_arr [ 9]);
+	const __m512   c10 = _mm512_set1_ps (_coef_flt_arr [10]);
+	const __m512   c11 = _mm512_set1_ps (_coef_flt_arr [11]);
+
+	const int      w16    = w & -16;
+	const int      w15    = w - w16;
+	const __mmask16   m_full = ProxyRwAvx512Mask::make_16 (16);
+	const __mmask16   m_last = ProxyRwAvx512Mask::make_16 (w15);
+
+	typedef ProxyRwAvx512 <SplFmt_FLOAT> PFlt;
+
+	for (int y = 0; y < h; ++y)
+	{
+		const FrameRO <float>   s { src };
+		const Frame <float>     d { dst };
+
+		for (int x = 0; x < w; x += 16)
+		{
+			const __mmask16   m = (x < w16) ? m_full : m_last;
+
+			const __m512   s0 = PFlt::read_flt (s [0]._ptr + x, m);
+			const __m512   s1 = PFlt::read_flt (s [1]._ptr + x, m);
+			const __m512   s2 = PFlt::read_flt (s [2]._ptr + x, m);
+
+			const __m512   d0 = _mm512_add_ps (_mm512_add_ps (_mm512_add_ps (
+				_mm512_mul_ps (s0, c00),
+				_mm512_mul_ps (s1, c01)),
+				_mm512_mul_ps (s2, c02)),
+				                   c03);
+			const __m512   d1 = _mm512_add_ps (_mm512_add_ps (_mm512_add_ps (
+				_mm512_mul_ps (s0, c04),
+				_mm512_mul_ps (s1, c05)),
+				_mm512_mul_ps (s2, c06)),
+				                   c07);
+			const __m512   d2 = _mm512_add_ps (_mm512_add_ps (_mm512_add_ps (
+				_mm512_mul_ps (s0, c08),
+				_mm512_mul_ps (s1, c09)),
+				_mm512_mul_ps (s2, c10)),
+				                   c11);
+
+			PFlt::write_flt (d [0]._ptr + x, d0, m);
+			PFlt::write_flt (d [1]._ptr + x, d1, m);
+			PFlt::write_flt (d [2]._ptr + x, d2, m);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,433 @@
+/*****************************************************************************
+
+        PerfTrace.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+	#pragma warning (disable : 4996) // getenv
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/PerfTrace.h"
+
+#include <chrono>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Records the accumulated duration as an event starting at t_pos, and moves
+// t_pos to the end of the event. This way, the stages of an interleaved
+// processing are displayed one after the other within the parent stage.
+void	PerfTrace::Acc::commit (int64_t &t_pos) noexcept
+{
+	assert (_t_beg < 0);
+
+	// t_pos is negative if the recording has been enabled during the stage
+	if (t_pos >= 0 && (_dur > 0 || _nbr_pix > 0))
+	{
+		use_instance ().add_event (_name_0, _simd, t_pos, _dur, _nbr_pix);
+		t_pos += _dur;
+	}
+	_dur     = 0;
+	_nbr_pix = 0;
+}
+
+
+
+// filter_name_0 is used to record the whole request duration as a stage.
+// The capture does nothing if the recording is disabled.
+PerfTrace::FrameCapture::FrameCapture (const char *filter_name_0) noexcept
+:	_filter_name_0 (filter_name_0)
+{
+	assert (filter_name_0 != nullptr);
+
+	if (is_enabled ())
+	{
+		_t_beg       = get_time_ns ();
+		_prev_ptr    = _capture_ptr;
+		_capture_ptr = this;
+	}
+}
+
+
+
+// Detaches the capture without recording the request, in case stop() has
+// not been called (exception...)
+PerfTrace::FrameCapture::~FrameCapture ()
+{
+	if (is_active ())
+	{
+		assert (_capture_ptr == this);
+		_capture_ptr = _prev_ptr;
+	}
+}
+
+
+
+bool	PerfTrace::FrameCapture::is_active () const noexcept
+{
+	return (_t_beg >= 0);
+}
+
+
+
+// Records the request duration and detaches the capture from the thread.
+// The entries can be read afterwards.
+void	PerfTrace::FrameCapture::stop () noexcept
+{
+	if (is_active ())
+	{
+		assert (_capture_ptr == this);
+		const int64_t  t_end = get_time_ns ();
+		use_instance ().add_event (
+			_filter_name_0, Simd_NONE, _t_beg, t_end - _t_beg, 0
+		);
+		_capture_ptr = _prev_ptr;
+		_t_beg       = -1;
+	}
+}
+
+
+
+// Stages are summed by name and SIMD path, in order of first appearance.
+std::vector <PerfTrace::FrameCapture::Entry>	PerfTrace::FrameCapture::get_entries () const
+{
+	std::lock_guard <std::mutex>  autolock (_mtx);
+
+	return _entry_arr;
+}
+
+
+
+PerfTrace::ThreadLink::ThreadLink (FrameCapture *capture_ptr) noexcept
+{
+	if (capture_ptr != nullptr)
+	{
+		_prev_ptr    = _capture_ptr;
+		_capture_ptr = capture_ptr;
+		_link_flag   = true;
+	}
+}
+
+
+
+PerfTrace::ThreadLink::~ThreadLink ()
+{
+	if (_link_flag)
+	{
+		_capture_ptr = _prev_ptr;
+	}
+}
+
+
+
+PerfTrace::~PerfTrace ()
+{
+	if (! _trace_pathname.empty ())
+	{
+		write_chrome_trace (_trace_pathname);
+	}
+}
+
+
+
+PerfTrace &	PerfTrace::use_instance ()
+{
+	static PerfTrace  instance;
+
+	return instance;
+}
+
+
+
+void	PerfTrace::set_enabled (bool flag) noexcept
+{
+	_enabled_flag.store (flag);
+}
+
+
+
+// Monotonic time, in nanoseconds
+int64_t	PerfTrace::get_time_ns () noexcept
+{
+	typedef std::chrono::steady_clock Clock;
+	static const Clock::time_point   t_origin = Clock::now ();
+
+	return int64_t (std::chrono::duration_cast <std::chrono::nanoseconds> (
+		Clock::now () - t_origin
+	).count ());
+}
+
+
+
+const char *	PerfTrace::get_simd_name (Simd simd) noexcept
+{
+	assert (simd >= 0);
+	assert (simd < Simd_NBR_ELT);
+
+	static const char *  name_0_arr [Simd_NBR_ELT] =
+	{
+		"", "cpp", "sse", "sse2", "avx", "avx2", "avx512"
+	};
+
+	return name_0_arr [simd];
+}
+
+
+
+// Returns null if there is no capture attached to the current thread.
+PerfTrace::FrameCapture *	PerfTrace::get_thread_capture () noexcept
+{
+	return _capture_ptr;
+}
+
+
+
+// t_beg_ns is the value returned by get_time_ns() at the stage beginning.
+// Can be called from noexcept functions: the event is dropped if memory
+// cannot be allocated.
+void	PerfTrace::add_event (const char *name_0, Simd simd, int64_t t_beg_ns, int64_t dur_ns, int64_t nbr_pix) noexcept
+{
+	assert (name_0 != nullptr);
+	assert (simd >= 0);
+	assert (simd < Simd_NBR_ELT);
+	assert (dur_ns >= 0);
+	assert (nbr_pix >= 0);
+
+	const int      tid = get_thread_id ();
+
+	try
+	{
+		{
+			std::lock_guard <std::mutex>  autolock (_mtx);
+
+			Stat &         stat = _stat_map [std::make_pair (name_0, simd)];
+			++ stat._nbr_calls;
+			stat._dur_ns  += dur_ns;
+			stat._nbr_pix += nbr_pix;
+
+			if (_evt_arr.size () < _max_nbr_evt)
+			{
+				_evt_arr.push_back (Event { name_0, simd, tid, t_beg_ns, dur_ns, nbr_pix });
+			}
+			else
+			{
+				++ _nbr_lost_evt;
+			}
+		}
+
+		FrameCapture * capture_ptr = _capture_ptr;
+		if (capture_ptr != nullptr)
+		{
+			capture_ptr->add (name_0, simd, dur_ns, nbr_pix);
+		}
+	}
+	catch (...)
+	{
+		// Nothing
+	}
+}
+
+
+
+std::vector <PerfTrace::StageStat>	PerfTrace::get_stats () const
+{
+	std::map <std::pair <std::string, Simd>, Stat>  merged_map;
+	{
+		std::lock_guard <std::mutex>  autolock (_mtx);
+		for (const auto &node : _stat_map)
+		{
+			Stat &         stat = merged_map [std::make_pair (
+				std::string (node.first.first), node.first.second
+			)];
+			stat._nbr_calls += node.second._nbr_calls;
+			stat._dur_ns    += node.second._dur_ns;
+			stat._nbr_pix   += node.second._nbr_pix;
+		}
+	}
+
+	std::vector <StageStat> stat_arr;
+	for (const auto &node : merged_map)
+	{
+		StageStat      st;
+		st._name      = node.first.first;
+		st._simd      = node.first.second;
+		st._nbr_calls = node.second._nbr_calls;
+		st._dur_ns    = node.second._dur_ns;
+		st._nbr_pix   = node.second._nbr_pix;
+		stat_arr.push_back (st);
+	}
+
+	return stat_arr;
+}
+
+
+
+// Chrome trace event format, complete events ("ph":"X").
+// Returns false on failure.
+bool	PerfTrace::write_chrome_trace (const std::string &pathname) const
+{
+	auto           f_ptr = fopen (pathname.c_str (), "w");
+	if (f_ptr == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard <std::mutex>  autolock (_mtx);
+
+	bool           ok_flag = (fprintf (f_ptr, "{\"traceEvents\":[\n") >= 0);
+	for (size_t pos = 0; pos < _evt_arr.size () && ok_flag; ++pos)
+	{
+		const Event &  evt = _evt_arr [pos];
+		ok_flag = (fprintf (
+			f_ptr,
+			"%s{\"name\":\"%s\",\"cat\":\"fmtconv\",\"ph\":\"X\","
+			"\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,"
+			"\"args\":{\"simd\":\"%s\",\"pix\":%lld}}",
+			(pos > 0) ? ",\n" : "",
+			evt._name_0,
+			double (evt._t_beg) * 1e-3,
+			double (evt._dur) * 1e-3,
+			evt._tid,
+			get_simd_name (evt._simd),
+			static_cast <long long> (evt._nbr_pix)
+		) >= 0);
+	}
+
+	if (ok_flag)
+	{
+		ok_flag = (fprintf (
+			f_ptr,
+			"\n],\n\"displayTimeUnit\":\"ns\",\n"
+			"\"otherData\":{\"lost_events\":\"%lld\"}}\n",
+			static_cast <long long> (_nbr_lost_evt)
+		) >= 0);
+	}
+
+	if (fclose (f_ptr) != 0)
+	{
+		ok_flag = false;
+	}
+
+	return ok_flag;
+}
+
+
+
+void	PerfTrace::clear ()
+{
+	std::lock_guard <std::mutex>  autolock (_mtx);
+
+	_evt_arr.clear ();
+	_stat_map.clear ();
+	_nbr_lost_evt = 0;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+void	PerfTrace::FrameCapture::add (const char *name_0, Simd simd, int64_t dur_ns, int64_t nbr_pix)
+{
+	std::lock_guard <std::mutex>  autolock (_mtx);
+
+	for (auto &entry : _entry_arr)
+	{
+		if (entry._name_0 == name_0 && entry._simd == simd)
+		{
+			entry._dur_ns  += dur_ns;
+			entry._nbr_pix += nbr_pix;
+			return;
+		}
+	}
+
+	_entry_arr.push_back (Entry { name_0, simd, dur_ns, nbr_pix });
+}
+
+
+
+PerfTrace::PerfTrace ()
+{
+	const char *   path_0 = std::getenv ("FMTCONV_PERF_TRACE");
+	if (path_0 != nullptr)
+	{
+		_trace_pathname = path_0;
+	}
+}
+
+
+
+bool	PerfTrace::read_env_enabled ()
+{
+	const char *   perf_0 = std::getenv ("FMTCONV_PERF");
+	if (   perf_0 != nullptr
+	    && perf_0 [0] != '\0'
+	    && std::strtol (perf_0, nullptr, 10) != 0)
+	{
+		return true;
+	}
+
+	const char *   path_0 = std::getenv ("FMTCONV_PERF_TRACE");
+
+	return (path_0 != nullptr && path_0 [0] != '\0');
+}
+
+
+
+// Small thread identifiers, in order of first recording
+int	PerfTrace::get_thread_id () noexcept
+{
+	static thread_local int tid = ++ _tid_count;
+
+	return tid;
+}
+
+
+
+constexpr size_t	PerfTrace::_max_nbr_evt;
+std::atomic <bool>	PerfTrace::_enabled_flag { PerfTrace::read_env_enabled () };
+std::atomic <int>	PerfTrace::_tid_count { 0 };
+thread_local PerfTrace::FrameCapture *	PerfTrace::_capture_ptr = nullptr;
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
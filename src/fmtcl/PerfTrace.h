@@ -0,0 +1,284 @@
+/*****************************************************************************
+
+        PerfTrace.h
+        Author: Laurent de Soras, 2024
+
+Opt-in instrumentation of the processing stages. Each recorded stage gives
+its duration, the number of processed pixels and the SIMD path selected for
+the processing.
+
+Recording is disabled by default and costs a single atomic read per stage.
+It is enabled by setting one of these environment variables before loading
+the plug-in:
+
+- FMTCONV_PERF=1: records the stage statistics and attaches the timings to
+	the output frames (Vapoursynth frame properties, Avisynth+ frame
+	properties if supported).
+- FMTCONV_PERF_TRACE=<path>: same, and writes all the events to <path> in
+	the Chrome trace event format (chrome://tracing, ui.perfetto.dev) when
+	the process exits.
+
+Stage names are string literals with static storage duration.
+
+This is a singleton, use use_instance() to access it. All the public
+functions are thread-safe.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_PerfTrace_HEADER_INCLUDED)
+#define fmtcl_PerfTrace_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+class PerfTrace
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	enum Simd
+	{
+		Simd_NONE = 0, // Not relevant
+		Simd_CPP,
+		Simd_SSE,
+		Simd_SSE2,
+		Simd_AVX,
+		Simd_AVX2,
+		Simd_AVX512,
+
+		Simd_NBR_ELT
+	};
+
+	// Aggregated statistics for a stage and a SIMD path
+	class StageStat
+	{
+	public:
+		std::string    _name;
+		Simd           _simd      = Simd_NONE;
+		int64_t        _nbr_calls = 0;
+		int64_t        _dur_ns    = 0;
+		int64_t        _nbr_pix   = 0;
+	};
+
+	// Records a stage from the object construction to its destruction.
+	class Scope
+	{
+	public:
+		inline         Scope (const char *name_0, Simd simd, int64_t nbr_pix) noexcept;
+		inline         ~Scope ();
+		inline int64_t get_t_beg () const noexcept;
+	private:
+		const char *   _name_0  = nullptr;
+		Simd           _simd    = Simd_NONE;
+		int64_t        _nbr_pix = 0;
+		int64_t        _t_beg   = -1;    // Negative: disabled
+		               Scope (const Scope &other)             = delete;
+		Scope &        operator = (const Scope &other)        = delete;
+	};
+
+	// Sums the durations of a stage processed in several chunks interleaved
+	// with other stages, and records it as a single event.
+	// Durations are not measured when the recording is disabled.
+	class Acc
+	{
+	public:
+		inline explicit
+		               Acc (const char *name_0, Simd simd) noexcept;
+		inline void    start () noexcept;
+		inline void    stop (int64_t nbr_pix) noexcept;
+		void           commit (int64_t &t_pos) noexcept;
+	private:
+		const char *   _name_0  = nullptr;
+		Simd           _simd    = Simd_NONE;
+		int64_t        _nbr_pix = 0;
+		int64_t        _dur     = 0;
+		int64_t        _t_beg   = -1;    // Negative: disabled
+	};
+
+	// Collects the stages recorded during a frame request, for export as
+	// frame properties. It is attached to the current thread during its
+	// lifetime. Threads working on behalf of the request can be attached
+	// with a ThreadLink.
+	class FrameCapture
+	{
+	public:
+		class Entry
+		{
+		public:
+			const char *   _name_0  = nullptr;
+			Simd           _simd    = Simd_NONE;
+			int64_t        _dur_ns  = 0;
+			int64_t        _nbr_pix = 0;
+		};
+		explicit       FrameCapture (const char *filter_name_0) noexcept;
+		               ~FrameCapture ();
+		bool           is_active () const noexcept;
+		void           stop () noexcept;
+		std::vector <Entry>
+		               get_entries () const;
+	private:
+		friend class PerfTrace;
+		void           add (const char *name_0, Simd simd, int64_t dur_ns, int64_t nbr_pix);
+		const char *   _filter_name_0 = nullptr;
+		FrameCapture * _prev_ptr      = nullptr;
+		int64_t        _t_beg         = -1;    // Negative: inactive
+		mutable std::mutex
+		               _mtx;
+		std::vector <Entry>
+		               _entry_arr;
+		               FrameCapture (const FrameCapture &other)       = delete;
+		FrameCapture & operator = (const FrameCapture &other)       = delete;
+	};
+
+	// Attaches an existing capture to the current thread during the object
+	// lifetime. capture_ptr may be null.
+	class ThreadLink
+	{
+	public:
+		explicit       ThreadLink (FrameCapture *capture_ptr) noexcept;
+		               ~ThreadLink ();
+	private:
+		FrameCapture * _prev_ptr = nullptr;
+		bool           _link_flag = false;
+		               ThreadLink (const ThreadLink &other)           = delete;
+		ThreadLink &   operator = (const ThreadLink &other)           = delete;
+	};
+
+	               ~PerfTrace ();
+
+	static PerfTrace &
+	               use_instance ();
+
+	static inline bool
+	               is_enabled () noexcept;
+	static void    set_enabled (bool flag) noexcept;
+	static int64_t get_time_ns () noexcept;
+	static const char *
+	               get_simd_name (Simd simd) noexcept;
+	static FrameCapture *
+	               get_thread_capture () noexcept;
+
+	void           add_event (const char *name_0, Simd simd, int64_t t_beg_ns, int64_t dur_ns, int64_t nbr_pix) noexcept;
+	std::vector <StageStat>
+	               get_stats () const;
+	bool           write_chrome_trace (const std::string &pathname) const;
+	void           clear ();
+
+	static constexpr size_t
+	               _max_nbr_evt = size_t (1) << 20;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	class Event
+	{
+	public:
+		const char *   _name_0;
+		Simd           _simd;
+		int            _tid;
+		int64_t        _t_beg;  // ns
+		int64_t        _dur;    // ns
+		int64_t        _nbr_pix;
+	};
+
+	class Stat
+	{
+	public:
+		int64_t        _nbr_calls = 0;
+		int64_t        _dur_ns    = 0;
+		int64_t        _nbr_pix   = 0;
+	};
+
+	// Keys on the name address. Identical literals from different
+	// translation units are merged when the statistics are read.
+	typedef std::map <std::pair <const char *, Simd>, Stat> StatMap;
+
+	               PerfTrace ();
+
+	static bool    read_env_enabled ();
+	static int     get_thread_id () noexcept;
+
+	mutable std::mutex
+	               _mtx;                   // Protects all the data below
+	std::vector <Event>
+	               _evt_arr;
+	StatMap        _stat_map;
+	int64_t        _nbr_lost_evt = 0;      // Events beyond _max_nbr_evt
+	std::string    _trace_pathname;        // Written on destruction. Empty: no file
+
+	static std::atomic <bool>
+	               _enabled_flag;
+	static std::atomic <int>
+	               _tid_count;
+	static thread_local FrameCapture *
+	               _capture_ptr;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               PerfTrace (const PerfTrace &other)           = delete;
+	               PerfTrace (PerfTrace &&other)                = delete;
+	PerfTrace &    operator = (const PerfTrace &other)          = delete;
+	PerfTrace &    operator = (PerfTrace &&other)               = delete;
+	bool           operator == (const PerfTrace &other) const   = delete;
+	bool           operator != (const PerfTrace &other) const   = delete;
+
+};	// class PerfTrace
+
+
+
+}	// namespace fmtcl
+
+
+
+#include "fmtcl/PerfTrace.hpp"
+
+
+
+#endif	// fmtcl_PerfTrace_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,135 @@
+/*****************************************************************************
+
+        PerfTrace.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_PerfTrace_CODEHEADER_INCLUDED)
+#define	fmtcl_PerfTrace_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+PerfTrace::Scope::Scope (const char *name_0, Simd simd, int64_t nbr_pix) noexcept
+:	_name_0 (name_0)
+,	_simd (simd)
+,	_nbr_pix (nbr_pix)
+{
+	assert (name_0 != nullptr);
+	assert (simd >= 0);
+	assert (simd < Simd_NBR_ELT);
+	assert (nbr_pix >= 0);
+
+	if (is_enabled ())
+	{
+		_t_beg = get_time_ns ();
+	}
+}
+
+
+
+PerfTrace::Scope::~Scope ()
+{
+	if (_t_beg >= 0)
+	{
+		const int64_t  t_end = get_time_ns ();
+		use_instance ().add_event (
+			_name_0, _simd, _t_beg, t_end - _t_beg, _nbr_pix
+		);
+	}
+}
+
+
+
+// Negative if the recording is disabled
+int64_t	PerfTrace::Scope::get_t_beg () const noexcept
+{
+	return _t_beg;
+}
+
+
+
+PerfTrace::Acc::Acc (const char *name_0, Simd simd) noexcept
+:	_name_0 (name_0)
+,	_simd (simd)
+{
+	assert (name_0 != nullptr);
+	assert (simd >= 0);
+	assert (simd < Simd_NBR_ELT);
+}
+
+
+
+void	PerfTrace::Acc::start () noexcept
+{
+	if (is_enabled ())
+	{
+		_t_beg = get_time_ns ();
+	}
+}
+
+
+
+void	PerfTrace::Acc::stop (int64_t nbr_pix) noexcept
+{
+	assert (nbr_pix >= 0);
+
+	if (_t_beg >= 0)
+	{
+		_dur     += get_time_ns () - _t_beg;
+		_nbr_pix += nbr_pix;
+		_t_beg    = -1;
+	}
+}
+
+
+
+bool	PerfTrace::is_enabled () noexcept
+{
+	return _enabled_flag.load (std::memory_order_relaxed);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_PerfTrace_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
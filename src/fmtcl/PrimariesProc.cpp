@@ -0,0 +1,323 @@
+/*****************************************************************************
+
+        PrimariesProc.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/fnc.h"
+#include "fmtcl/PrimariesProc.h"
+#include "fmtcl/TransOpLogC.h"
+#include "fmtcl/TransUtil.h"
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+PrimariesProc::PrimariesProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag)
+:	_avstp_ref ()
+,	_sse2_flag (sse2_flag)
+,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_mat_proc (sse_flag, sse2_flag, avx_flag, avx2_flag, avx512_flag)
+{
+	_perf_simd =
+		  (_avx512_flag) ? PerfTrace::Simd_AVX512
+		: (avx2_flag   ) ? PerfTrace::Simd_AVX2
+		: (sse2_flag   ) ? PerfTrace::Simd_SSE2
+		:                  PerfTrace::Simd_CPP;
+}
+
+
+
+int	PrimariesProc::configure (const Mat4 &mat, const PicFmt &dst_fmt, TransCurve curve_d, const PicFmt &src_fmt, TransCurve curve_s, int lut3d_res)
+{
+	assert (dst_fmt.is_valid ());
+	assert (dst_fmt._col_fam == ColorFamily_RGB);
+	assert (curve_d == TransCurve_UNDEF || TransCurve_is_valid (curve_d));
+	assert (src_fmt.is_valid ());
+	assert (src_fmt._col_fam == ColorFamily_RGB);
+	assert (curve_s == TransCurve_UNDEF || TransCurve_is_valid (curve_s));
+	assert (
+		   lut3d_res == 0
+		|| (lut3d_res >= Lut3d::_min_res && lut3d_res <= Lut3d::_max_res)
+	);
+
+	const PicFmt   lin_fmt { SplFmt_FLOAT, 32, ColorFamily_RGB, true };
+
+	_lut3d_uptr.reset ();
+	if (lut3d_res > 0)
+	{
+		return configure_lut3d (
+			mat, dst_fmt, curve_d, src_fmt, curve_s, lut3d_res
+		);
+	}
+	PicFmt         mat_dst_fmt = dst_fmt;
+	PicFmt         mat_src_fmt = src_fmt;
+
+	const bool     lin_s_flag =
+		(curve_s == TransCurve_UNDEF || curve_s == TransCurve_LINEAR);
+	const bool     lin_d_flag =
+		(curve_d == TransCurve_UNDEF || curve_d == TransCurve_LINEAR);
+
+	_lut_s_uptr.reset ();
+	_lut_d_uptr.reset ();
+	const bool     mix_flag =
+		(SplFmt_is_float (src_fmt._sf) != SplFmt_is_float (dst_fmt._sf));
+	if (! lin_s_flag || ! lin_d_flag || mix_flag)
+	{
+		// The matrix cannot mix integer and float data, so a linear side is
+		// converted to float too, if required.
+		if (! lin_s_flag || src_fmt._sf != SplFmt_FLOAT)
+		{
+			_lut_s_uptr = build_lut (
+				(lin_s_flag) ? TransCurve_LINEAR : curve_s, true,
+				lin_fmt, src_fmt, _sse2_flag, _avx2_flag, _avx512_flag
+			);
+			mat_src_fmt = lin_fmt;
+		}
+		if (! lin_d_flag || dst_fmt._sf != SplFmt_FLOAT)
+		{
+			_lut_d_uptr = build_lut (
+				(lin_d_flag) ? TransCurve_LINEAR : curve_d, false,
+				dst_fmt, lin_fmt, _sse2_flag, _avx2_flag, _avx512_flag
+			);
+			mat_dst_fmt = lin_fmt;
+		}
+	}
+
+	_bps_s = SplFmt_get_unit_size (src_fmt._sf);
+	_bps_d = SplFmt_get_unit_size (dst_fmt._sf);
+	assert (_bps_s <= int (sizeof (float)));
+	assert (_bps_d <= int (sizeof (float)));
+
+	return prepare_matrix_coef (
+		_mat_proc, mat, mat_dst_fmt, mat_src_fmt, ColorSpaceH265_RGB, -1
+	);
+}
+
+
+
+void	PrimariesProc::process (const ProcComp3Arg &arg) const noexcept
+{
+	assert (arg.is_valid (false));
+
+	// Already linear, nothing to chain
+	if (_lut_s_uptr.get () == nullptr && _lut_d_uptr.get () == nullptr)
+	{
+		if (_lut3d_uptr.get () != nullptr)
+		{
+			_lut3d_uptr->process (arg);
+		}
+		else
+		{
+			_mat_proc.process (arg);
+		}
+		return;
+	}
+
+	PerfTrace::Scope  perf_scope (
+		"PrimariesProc", _perf_simd, int64_t (arg._w) * arg._h
+	);
+
+	auto           line_src = arg._src;
+	auto           line_dst = arg._dst;
+	ProcComp3Arg   seg_arg;
+	seg_arg._h = 1;
+
+	for (int y = 0; y < arg._h; ++y)
+	{
+		seg_arg._src = line_src;
+		seg_arg._dst = line_dst;
+
+		for (int x = 0; x < arg._w; x += _max_len)
+		{
+			seg_arg._w = std::min (arg._w - x, _max_len);
+			process_seg (seg_arg);
+
+			seg_arg._src.step_pix (_max_len * _bps_s);
+			seg_arg._dst.step_pix (_max_len * _bps_d);
+		}
+
+		line_src.step_line ();
+		line_dst.step_line ();
+	}
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+constexpr int	PrimariesProc::_nbr_planes;
+constexpr int	PrimariesProc::_max_seg_len;
+constexpr int	PrimariesProc::_max_len;
+
+
+
+// The whole float processing is sampled into the 3D LUT. The source and
+// destination are converted from and to float if required, keeping their
+// transfer curve.
+int	PrimariesProc::configure_lut3d (const Mat4 &mat, const PicFmt &dst_fmt, TransCurve curve_d, const PicFmt &src_fmt, TransCurve curve_s, int lut3d_res)
+{
+	const PicFmt   flt_fmt { SplFmt_FLOAT, 32, ColorFamily_RGB, true };
+
+	PrimariesProc  proc_flt (
+		_sse2_flag, _sse2_flag, _avx2_flag, _avx2_flag, _avx512_flag
+	);
+	const int      ret_val =
+		proc_flt.configure (mat, flt_fmt, curve_d, flt_fmt, curve_s, 0);
+	if (ret_val != MatrixProc::Err_OK)
+	{
+		return ret_val;
+	}
+
+	_lut3d_uptr = std::make_unique <Lut3d> (
+		lut3d_res, Vec3 (0, 0, 0), Vec3 (1, 1, 1),
+		[&proc_flt] (const ProcComp3Arg &arg) { proc_flt.process (arg); },
+		_sse2_flag, _avx2_flag
+	);
+
+	_lut_s_uptr.reset ();
+	_lut_d_uptr.reset ();
+	if (src_fmt._sf != SplFmt_FLOAT)
+	{
+		_lut_s_uptr = build_lut (
+			TransCurve_LINEAR, true,
+			flt_fmt, src_fmt, _sse2_flag, _avx2_flag, _avx512_flag
+		);
+	}
+	if (dst_fmt._sf != SplFmt_FLOAT)
+	{
+		_lut_d_uptr = build_lut (
+			TransCurve_LINEAR, false,
+			dst_fmt, flt_fmt, _sse2_flag, _avx2_flag, _avx512_flag
+		);
+	}
+
+	_bps_s = SplFmt_get_unit_size (src_fmt._sf);
+	_bps_d = SplFmt_get_unit_size (dst_fmt._sf);
+
+	return MatrixProc::Err_OK;
+}
+
+
+
+// inv_flag: the LUT converts from the curve to linear.
+// The LUT range selection follows TransModel.
+std::unique_ptr <TransLut>	PrimariesProc::build_lut (TransCurve curve, bool inv_flag, const PicFmt &dst_fmt, const PicFmt &src_fmt, bool sse2_flag, bool avx2_flag, bool avx512_flag)
+{
+	const auto     op_sptr = TransUtil::conv_curve_to_op (
+		curve, inv_flag, TransOpLogC::ExpIdx_800, 6.5, 0.5
+	);
+
+	bool           loglut_flag = TransLut::is_loglut_req (*op_sptr);
+	if (inv_flag)
+	{
+		loglut_flag |= (curve == TransCurve_SIGMOID || curve == TransCurve_ACESCC);
+	}
+	else
+	{
+		loglut_flag |=
+			(op_sptr->get_info ()._range == TransOpInterface::Range::HDR);
+	}
+
+	return std::make_unique <TransLut> (
+		*op_sptr, loglut_flag,
+		src_fmt._sf, src_fmt._res, src_fmt._full_flag,
+		dst_fmt._sf, dst_fmt._res, dst_fmt._full_flag,
+		sse2_flag, avx2_flag, avx512_flag
+	);
+}
+
+
+
+// A single line segment. The intermediate linear data stays in a float
+// buffer on the stack. The matrix works in place on it if both curves are
+// set.
+void	PrimariesProc::process_seg (const ProcComp3Arg &arg) const noexcept
+{
+	assert (arg._w <= _max_len);
+	assert (arg._h == 1);
+
+	alignas (64) SegArray   tmp_seg;
+	const Frame <> tmp {
+		Plane <> { tmp_seg [0].data (), 0 },
+		Plane <> { tmp_seg [1].data (), 0 },
+		Plane <> { tmp_seg [2].data (), 0 }
+	};
+
+	ProcComp3Arg   mat_arg { arg };
+	if (_lut_s_uptr.get () != nullptr)
+	{
+		for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+		{
+			_lut_s_uptr->process_plane (tmp [p_idx], arg._src [p_idx], arg._w, 1);
+		}
+		mat_arg._src = tmp;
+	}
+	if (_lut_d_uptr.get () != nullptr)
+	{
+		mat_arg._dst = tmp;
+	}
+
+	if (_lut3d_uptr.get () != nullptr)
+	{
+		_lut3d_uptr->process (mat_arg);
+	}
+	else
+	{
+		_mat_proc.process_chunk (mat_arg);
+	}
+
+	if (_lut_d_uptr.get () != nullptr)
+	{
+		for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
+		{
+			_lut_d_uptr->process_plane (arg._dst [p_idx], tmp [p_idx], arg._w, 1);
+		}
+	}
+}
+
+
+
+}  // namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,167 @@
+/*****************************************************************************
+
+        PrimariesProc.h
+        Author: Laurent de Soras, 2024
+
+Converts the primaries of an RGB picture. The conversion is a 3x3 matrix
+on linear RGB. When the source or destination picture are not linear, the
+transfer curves are decoded and encoded around the matrix, within the same
+pass. The pictures are processed by segments small enough to keep the
+intermediate data in the L1 cache.
+
+The curves are applied as they are, without any luminance matching or
+OOTF. When the source and destination curves differ, the linear data is
+passed unchanged from one curve to the other. TransModel should be used
+for the more complex cases.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_PrimariesProc_HEADER_INCLUDED)
+#define fmtcl_PrimariesProc_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Lut3d.h"
+#include "fmtcl/Mat4.h"
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/PerfTrace.h"
+#include "fmtcl/PicFmt.h"
+#include "fmtcl/ProcComp3Arg.h"
+#include "fmtcl/TransCurve.h"
+#include "fmtcl/TransLut.h"
+#include "AvstpWrapper.h"
+
+#include <array>
+#include <memory>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+class PrimariesProc
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static constexpr int _nbr_planes = ProcComp3Arg::_nbr_planes;
+
+	explicit       PrimariesProc (bool sse_flag, bool sse2_flag, bool avx_flag, bool avx2_flag, bool avx512_flag);
+
+	// mat is the conversion matrix on linear RGB.
+	// TransCurve_UNDEF or TransCurve_LINEAR: the picture is linear.
+	// lut3d_res: 0, or number of nodes per dimension of a 3D LUT replacing
+	// the curves and the matrix. The LUT input is clipped to [0 ; 1].
+	// Returns a MatrixProc::Err code.
+	int            configure (const Mat4 &mat, const PicFmt &dst_fmt, TransCurve curve_d, const PicFmt &src_fmt, TransCurve curve_s, int lut3d_res);
+
+	// All stride values are in bytes
+	void           process (const ProcComp3Arg &arg) const noexcept;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// Maximum segment length in bytes. Multiple of 64.
+	static constexpr int _max_seg_len = 4096;
+
+	// Segment length in pixels, for the float intermediate data.
+	static constexpr int _max_len     = _max_seg_len / int (sizeof (float));
+
+	typedef std::array <uint8_t, _max_seg_len> Segment;
+	typedef std::array <Segment, _nbr_planes> SegArray;
+
+	int            configure_lut3d (const Mat4 &mat, const PicFmt &dst_fmt, TransCurve curve_d, const PicFmt &src_fmt, TransCurve curve_s, int lut3d_res);
+
+	static std::unique_ptr <TransLut>
+	               build_lut (TransCurve curve, bool inv_flag, const PicFmt &dst_fmt, const PicFmt &src_fmt, bool sse2_flag, bool avx2_flag, bool avx512_flag);
+	void           process_seg (const ProcComp3Arg &arg) const noexcept;
+
+	// Keeps the thread pool alive while the LUTs are generated, so each
+	// table doesn't start and join it again.
+	AvstpWrapper::PoolRef
+	               _avstp_ref;
+
+	bool           _sse2_flag   = false;
+	bool           _avx2_flag   = false;
+	bool           _avx512_flag = false; // AVX-512F and BW
+
+	MatrixProc     _mat_proc;
+
+	// Curve -> linear and linear -> curve. nullptr if the picture is linear.
+	// With the 3D LUT, they only convert from and to float.
+	std::unique_ptr <TransLut>
+	               _lut_s_uptr;
+	std::unique_ptr <TransLut>
+	               _lut_d_uptr;
+
+	// Replaces the matrix if set
+	std::unique_ptr <Lut3d>
+	               _lut3d_uptr;
+
+	int            _bps_s = 0;       // Bytes per sample
+	int            _bps_d = 0;
+
+	PerfTrace::Simd                  // Path reported by the performance traces
+	               _perf_simd = PerfTrace::Simd_CPP;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               PrimariesProc ()                               = delete;
+	               PrimariesProc (const PrimariesProc &other)     = delete;
+	               PrimariesProc (PrimariesProc &&other)          = delete;
+	PrimariesProc &
+	               operator = (const PrimariesProc &other)        = delete;
+	PrimariesProc &
+	               operator = (PrimariesProc &&other)             = delete;
+	bool           operator == (const PrimariesProc &other) const = delete;
+	bool           operator != (const PrimariesProc &other) const = delete;
+
+}; // class PrimariesProc
+
+
+
+}  // namespace fmtcl
+
+
+
+//#include "fmtcl/PrimariesProc.hpp"
+
+
+
+#endif   // fmtcl_PrimariesProc_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
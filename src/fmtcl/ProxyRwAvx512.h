@@ -0,0 +1,153 @@
+/*****************************************************************************
+
+        ProxyRwAvx512.h
+        Author: Laurent de Soras, 2024
+
+Pixel access for the AVX-512 code. Requires AVX-512F and AVX-512BW.
+
+All the functions take a mask indicating the pixels to process. Masked
+pixels are neither read (they are set to 0) nor written, so the same code
+is used for the main loop and for the end of the lines.
+
+Rounding and saturation are the same as in ProxyRwAvx2. Only the functions
+required by the AVX-512 kernels are implemented.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_ProxyRwAvx512_HEADER_INCLUDED)
+#define	fmtcl_ProxyRwAvx512_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fstb/ToolsAvx512.h"
+#include "fmtcl/Proxy.h"
+#include "fmtcl/SplFmt.h"
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+template <SplFmt PT> class ProxyRwAvx512 {};
+
+
+
+// Masks for the first len elements
+class ProxyRwAvx512Mask
+{
+public:
+	// len in [0 ; 16]
+	static fstb_FORCEINLINE __mmask16
+	               make_16 (int len);
+	// len in [0 ; 32]
+	static fstb_FORCEINLINE __mmask32
+	               make_32 (int len);
+};
+
+
+
+// 16 pixels for the float functions
+template <>
+class ProxyRwAvx512 <SplFmt_FLOAT>
+{
+public:
+	typedef	Proxy::PtrFloat          Ptr;
+	typedef	Proxy::PtrFloatConst     PtrConst;
+	enum {         ALIGN_R =  4 };
+	enum {         ALIGN_W =  4 };
+	static fstb_FORCEINLINE __m512
+	               read_flt (const PtrConst::Type &ptr, __mmask16 m);
+	static fstb_FORCEINLINE void
+	               write_flt (const Ptr::Type &ptr, const __m512 &src, __mmask16 m);
+};
+
+// 16 pixels for the float functions, 32 pixels for the integer ones
+template <>
+class ProxyRwAvx512 <SplFmt_INT8>
+{
+public:
+	typedef	Proxy::PtrInt8           Ptr;
+	typedef	Proxy::PtrInt8Const      PtrConst;
+	enum {         ALIGN_R =  1 };
+	enum {         ALIGN_W =  1 };
+	static fstb_FORCEINLINE __m512
+	               read_flt (const PtrConst::Type &ptr, __mmask16 m);
+
+	template <bool CLIP_FLAG, bool SIGN_FLAG>
+	class S16
+	{
+	public:
+		static fstb_FORCEINLINE __m512i
+		               read (const PtrConst::Type &ptr, const __m512i &sign_bit, __mmask32 m);
+		static fstb_FORCEINLINE void
+		               write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, __mmask32 m);
+	};
+};
+
+// 16 pixels for the float functions, 32 pixels for the integer ones
+template <>
+class ProxyRwAvx512 <SplFmt_INT16>
+{
+public:
+	typedef	Proxy::PtrInt16          Ptr;
+	typedef	Proxy::PtrInt16Const     PtrConst;
+	enum {         ALIGN_R =  2 };
+	enum {         ALIGN_W =  2 };
+	static fstb_FORCEINLINE __m512
+	               read_flt (const PtrConst::Type &ptr, __mmask16 m);
+	static fstb_FORCEINLINE void
+	               write_flt (const Ptr::Type &ptr, const __m512 &src, __mmask16 m);
+
+	template <bool CLIP_FLAG, bool SIGN_FLAG>
+	class S16
+	{
+	public:
+		static fstb_FORCEINLINE __m512i
+		               read (const PtrConst::Type &ptr, const __m512i &sign_bit, __mmask32 m);
+		static fstb_FORCEINLINE void
+		               write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, __mmask32 m);
+
+		static fstb_FORCEINLINE __m512i
+		               prepare_write_clip (const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit);
+	};
+};
+
+
+
+}	// namespace fmtcl
+
+
+
+#include "fmtcl/ProxyRwAvx512.hpp"
+
+
+
+#endif	// fmtcl_ProxyRwAvx512_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,183 @@
+/*****************************************************************************
+
+        ProxyRwAvx512.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED)
+#define	fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+__mmask16	ProxyRwAvx512Mask::make_16 (int len)
+{
+	assert (len >= 0);
+	assert (len <= 16);
+
+	return (__mmask16 ((uint32_t (1) << len) - 1));
+}
+
+__mmask32	ProxyRwAvx512Mask::make_32 (int len)
+{
+	assert (len >= 0);
+	assert (len <= 32);
+
+	return (__mmask32 ((uint64_t (1) << len) - 1));
+}
+
+
+
+__m512	ProxyRwAvx512 <SplFmt_FLOAT>::read_flt (const PtrConst::Type &ptr, __mmask16 m)
+{
+	return (_mm512_maskz_loadu_ps (m, ptr));
+}
+
+void	ProxyRwAvx512 <SplFmt_FLOAT>::write_flt (const Ptr::Type &ptr, const __m512 &src, __mmask16 m)
+{
+	_mm512_mask_storeu_ps (ptr, m, src);
+}
+
+
+
+__m512	ProxyRwAvx512 <SplFmt_INT8>::read_flt (const PtrConst::Type &ptr, __mmask16 m)
+{
+	const __m512i  src = _mm512_maskz_loadu_epi8 (__mmask64 (m), ptr);
+
+	return (_mm512_cvtepi32_ps (_mm512_cvtepu8_epi32 (
+		_mm512_castsi512_si128 (src)
+	)));
+}
+
+
+
+// Sign is ignored here
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::read (const PtrConst::Type &ptr, const __m512i &sign_bit, __mmask32 m)
+{
+	fstb::unused (sign_bit);
+
+	const __m512i  src = _mm512_maskz_loadu_epi8 (__mmask64 (m), ptr);
+
+	return (_mm512_cvtepu8_epi16 (_mm512_castsi512_si256 (src)));
+}
+
+// Keeps only the LSB of the clipped data
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT8>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, __mmask32 m)
+{
+	const __m512i  val =
+		ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (
+			src, mi, ma, sign_bit
+		);
+	_mm512_mask_cvtepi16_storeu_epi8 (ptr, m, val);
+}
+
+
+
+__m512	ProxyRwAvx512 <SplFmt_INT16>::read_flt (const PtrConst::Type &ptr, __mmask16 m)
+{
+	const __m512i  src = _mm512_maskz_loadu_epi16 (__mmask32 (m), ptr);
+
+	return (_mm512_cvtepi32_ps (_mm512_cvtepu16_epi32 (
+		_mm512_castsi512_si256 (src)
+	)));
+}
+
+// The data is shifted to the signed range before the conversion, so the
+// signed saturation clips it to [0 ; 65535] once shifted back.
+void	ProxyRwAvx512 <SplFmt_INT16>::write_flt (const Ptr::Type &ptr, const __m512 &src, __mmask16 m)
+{
+	const __m512i  val_i = _mm512_cvtps_epi32 (
+		_mm512_add_ps (src, _mm512_set1_ps (-32768))
+	);
+	const __m256i  val   = _mm256_xor_si256 (
+		_mm512_cvtsepi32_epi16 (val_i), _mm256_set1_epi16 (-0x8000)
+	);
+	_mm512_mask_storeu_epi16 (ptr, __mmask32 (m), _mm512_castsi256_si512 (val));
+}
+
+
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::read (const PtrConst::Type &ptr, const __m512i &sign_bit, __mmask32 m)
+{
+	__m512i        val = _mm512_maskz_loadu_epi16 (m, ptr);
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+void	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::write_clip (const Ptr::Type &ptr, const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit, __mmask32 m)
+{
+	const __m512i  val = prepare_write_clip (src, mi, ma, sign_bit);
+	_mm512_mask_storeu_epi16 (ptr, m, val);
+}
+
+template <bool CLIP_FLAG, bool SIGN_FLAG>
+__m512i	ProxyRwAvx512 <SplFmt_INT16>::S16 <CLIP_FLAG, SIGN_FLAG>::prepare_write_clip (const __m512i &src, const __m512i &mi, const __m512i &ma, const __m512i &sign_bit)
+{
+	__m512i        val = src;
+	if (CLIP_FLAG)
+	{
+		val = _mm512_min_epi16 (val, ma);
+		val = _mm512_max_epi16 (val, mi);
+	}
+	if (SIGN_FLAG)
+	{
+		val = _mm512_xor_si512 (val, sign_bit);
+	}
+
+	return (val);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_ProxyRwAvx512_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
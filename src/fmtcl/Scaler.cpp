@@ -31,6 +31,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/ContFirInterface.h"
 #include "fmtcl/ProxyRwCpp.h"
 #include "fmtcl/Scaler.h"
+#include "fmtcl/ScalerCache.h"
 #include "fmtcl/ScalerCopy.h"
 #include "fstb/fnc.h"
 #if (fstb_ARCHI == fstb_ARCHI_X86)
@@ -69,6 +70,18 @@ namespace fmtcl
 #define fmtcl_Scaler_INIT_I_SSE2(DT, ST, DE, SE, DB, SB, FN) \
 	_process_plane_int_##FN##_ptr = &ThisType::process_plane_int_sse2 <ProxyRwSse2 <SplFmt_##DE>, DB, ProxyRwSse2 <SplFmt_##SE>, SB>;
 
+#define fmtcl_Scaler_INIT_HF_CPP(DT, ST, DE, SE, FN) \
+,	_process_plane_h_flt_##FN##_ptr (&ThisType::process_plane_h_flt_cpp <ProxyRwCpp <SplFmt_##DE>, ProxyRwCpp <SplFmt_##SE> >)
+
+#define fmtcl_Scaler_INIT_HF_SSE2(DT, ST, DE, SE, FN) \
+	_process_plane_h_flt_##FN##_ptr = &ThisType::process_plane_h_flt_sse2 <ProxyRwSse2 <SplFmt_##DE>, ProxyRwSse2 <SplFmt_##SE> >;
+
+#define fmtcl_Scaler_INIT_HI_CPP(DT, ST, DE, SE, DB, SB, FN) \
+,	_process_plane_h_int_##FN##_ptr (&ThisType::process_plane_h_int_cpp <ProxyRwCpp <SplFmt_##DE>, DB, ProxyRwCpp <SplFmt_##SE>, SB>)
+
+#define fmtcl_Scaler_INIT_HI_SSE2(DT, ST, DE, SE, DB, SB, FN) \
+	_process_plane_h_int_##FN##_ptr = &ThisType::process_plane_h_int_sse2 <ProxyRwSse2 <SplFmt_##DE>, DB, ProxyRwSse2 <SplFmt_##SE>, SB>;
+
 /*
 gain and add_cst are MAC constants to match different bitdepths and ranges.
 When scaling in integer, the bitdepth difference is handled with internal
@@ -91,13 +104,15 @@ Integer path (SSE2):
 - Convolution products are done in 32 bits signed with signed input at its
 	natural depth and coefficients scaled to 12 bits (SHIFT_INT)
 - The convolution is summed to _add_cst_int, then scaled down from
-	SHIFT_INT + the in/out bitdepth difference.
+	SHIFT_INT + the in/out bitdepth difference. With 16-bit input, the
+	summing constant also compensates the input offset for coefficients not
+	summing to 1 (KernelInfo::_sign_cst_int).
 - 16-bit data have their 15th bit flipped back to make them unsigned by the
 	write proxy. 2-byte bitdepths below 16 bits are not saturated to their
 	logical limits.
 */
 
-Scaler::Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag)
+Scaler::Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag)
 :	_src_height (src_height)
 ,	_dst_height (dst_height)
 ,	_win_top (win_top)
@@ -118,12 +133,20 @@ Scaler::Scaler (int src_height, int dst_height, double win_top, double win_heigh
 		add_cst * (1 << SHIFT_INT)
 #endif
 	))
-,	_fir_len (0)
-,	_kernel_info_arr (dst_height)
-,	_coef_flt_arr ()
-,	_coef_int_arr ()
+,	_coef_data_sptr (use_coef_data (sse2_flag && avx2_flag))
+,	_fir_len (_coef_data_sptr->_fir_len)
+,	_kernel_info_arr (_coef_data_sptr->_kernel_info_arr)
+,	_coef_flt_arr (_coef_data_sptr->_coef_flt_arr)
+,	_coef_int_arr (_coef_data_sptr->_coef_int_arr)
+,	_h_len (0)
+,	_h_start_arr ()
+,	_h_sign_cst_arr ()
+,	_coef_h_flt_arr ()
+,	_coef_h_int_arr ()
 fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_CPP)
 fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_CPP)
+fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_HF_CPP)
+fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_HI_CPP)
 {
 	assert (src_height > 0);
 	assert (dst_height > 0);
@@ -136,24 +159,35 @@ fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_CPP)
 	{
 		fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_SSE)
 		fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_SSE2)
+		fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_HF_SSE2)
+#if ! defined (fmtcl_Scaler_SSE2_16BITS)
+		fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_HI_SSE2)
+#endif
 
 		if (avx2_flag)
 		{
-			_coef_int_arr.set_avx2_mode (true);
 			setup_avx2 ();
+
+			// Only the vertical kernels have an AVX-512 version.
+			if (avx512_flag)
+			{
+				setup_avx512 ();
+			}
 		}
 	}
 #else
-	fstb::unused (sse2_flag, avx2_flag);
+	fstb::unused (sse2_flag, avx2_flag, avx512_flag);
 #endif
-
-	build_scale_data ();
 }
 
 #undef fmtcl_Scaler_INIT_F_CPP
 #undef fmtcl_Scaler_INIT_F_SSE
 #undef fmtcl_Scaler_INIT_I_CPP
 #undef fmtcl_Scaler_INIT_I_SSE2
+#undef fmtcl_Scaler_INIT_HF_CPP
+#undef fmtcl_Scaler_INIT_HF_SSE2
+#undef fmtcl_Scaler_INIT_HI_CPP
+#undef fmtcl_Scaler_INIT_HI_SSE2
 
 
 
@@ -191,6 +225,53 @@ int	Scaler::get_fir_len () const
 
 
 
+// Builds the coefficient tables for the horizontal processing. The scaler
+// dimensions are then related to the picture width.
+// Each destination column gets its own padded kernel, so the vector code
+// can read a fixed number of contiguous source pixels.
+void	Scaler::setup_h ()
+{
+	int            max_len = 1;
+	for (const auto &ki : _kernel_info_arr)
+	{
+		max_len = std::max (max_len, ki._kernel_size);
+	}
+	_h_len = (max_len + H_GRAN - 1) & -H_GRAN;
+
+	const int      nbr_col = _dst_height + H_COL_PAD;
+	const size_t   arr_len = size_t (nbr_col) * size_t (_h_len);
+	_h_start_arr.resize (nbr_col);
+	_coef_h_flt_arr.assign (arr_len, 0.f);
+	if (_can_int_flag)
+	{
+		_h_sign_cst_arr.resize (nbr_col);
+		_coef_h_int_arr.assign (arr_len, int16_t (0));
+	}
+
+	for (int x = 0; x < nbr_col; ++x)
+	{
+		const KernelInfo &   ki  =
+			_kernel_info_arr [std::min (x, _dst_height - 1)];
+		const size_t         pos = size_t (x) * size_t (_h_len);
+		_h_start_arr [x] = ki._start_line;
+		if (_can_int_flag)
+		{
+			_h_sign_cst_arr [x] = ki._sign_cst_int;
+		}
+		for (int k = 0; k < ki._kernel_size; ++k)
+		{
+			_coef_h_flt_arr [pos + k] = _coef_flt_arr [ki._coef_index + k];
+			if (_can_int_flag)
+			{
+				_coef_h_int_arr [pos + k] =
+					int16_t (_coef_int_arr.get_coef (ki._coef_index + k));
+			}
+		}
+	}
+}
+
+
+
 // src_ptr is the top-left corner of the full source frame
 // dst_ptr is the top-left corner of the destination tile
 #define fmtcl_Scaler_DEFINE_F(DT, ST, DE, SE, FN) \
@@ -209,11 +290,36 @@ void	Scaler::process_plane_int_##FN (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##S
 	);	\
 }
 
+// src_ptr is the top-left corner of the source tile, on the column 0 of the
+// full source frame
+// dst_ptr is the top-left corner of the destination tile
+#define fmtcl_Scaler_DEFINE_HF(DT, ST, DE, SE, FN) \
+void	Scaler::process_plane_h_flt (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const	\
+{	\
+	assert (_h_len > 0);	\
+	(this->*_process_plane_h_flt_##FN##_ptr) (	\
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end	\
+	);	\
+}
+
+#define fmtcl_Scaler_DEFINE_HI(DT, ST, DE, SE, DB, SB, FN) \
+void	Scaler::process_plane_h_int_##FN (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const	\
+{	\
+	assert (_h_len > 0);	\
+	(this->*_process_plane_h_int_##FN##_ptr) (	\
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end	\
+	);	\
+}
+
 fmtcl_Scaler_SPAN_F (fmtcl_Scaler_DEFINE_F)
 fmtcl_Scaler_SPAN_I (fmtcl_Scaler_DEFINE_I)
+fmtcl_Scaler_SPAN_F (fmtcl_Scaler_DEFINE_HF)
+fmtcl_Scaler_SPAN_I (fmtcl_Scaler_DEFINE_HI)
 
 #undef fmtcl_Scaler_DEFINE_F
 #undef fmtcl_Scaler_DEFINE_I
+#undef fmtcl_Scaler_DEFINE_HF
+#undef fmtcl_Scaler_DEFINE_HI
 
 
 
@@ -314,6 +420,33 @@ int	Scaler::eval_lower_bound_of_src_tile_height (int tile_height_dst, int dst_he
 
 
 
+// Tells if the horizontal processing (setup_h()) is expected to be faster
+// than a vertical processing on transposed data.
+// The kernels are padded to a multiple of H_GRAN taps. Upscaling with short
+// kernels wastes a large part of the computations, so the transpositions
+// are cheaper.
+bool	Scaler::eval_h_efficiency (int dst_width, double win_width, ContFirInterface &kernel_fnc, double kernel_scale)
+{
+	assert (dst_width > 0);
+	assert (win_width > 0);
+	assert (kernel_scale > 0);
+
+	const BasicInfo   bi (
+		fstb::ceil_int (win_width), dst_width, 0, win_width,
+		kernel_fnc, kernel_scale, 0, 0
+	);
+	if (bi._src_step >= 1)
+	{
+		return (true);
+	}
+
+	const int      len_pad = (bi._fir_len + H_GRAN - 1) & -H_GRAN;
+
+	return (bi._fir_len * 8 >= len_pad * 7);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -406,14 +539,9 @@ void	Scaler::process_plane_int_cpp (typename DST::Ptr::Type dst_ptr, typename SR
 	// Rounding constant for the final shift
 	const int      r_cst    = 1 << (SHIFT_INT + SB - DB - 1);
 
-	// Sign constants: when we have 16-bit data at one end only,
-	// we need to make data signed at the oposite end. This sign
-	// constant is reported on the summing constant.
-	const int      s_in     = (SB < 16) ? -(0x8000 << (SHIFT_INT + SB - DB)) : 0;
-	const int      s_out    = (DB < 16) ?   0x8000 << (SHIFT_INT + SB - DB)  : 0;
-	const int      s_cst    = s_in + s_out;
-
-	const int      add_cst  = _add_cst_int + s_cst + r_cst;
+	// Unlike the SIMD code, data are read and written unsigned, so there is
+	// no sign constant.
+	const int      add_cst  = _add_cst_int + r_cst;
 
 	for (int y = y_dst_beg; y < y_dst_end; ++y)
 	{
@@ -425,9 +553,9 @@ void	Scaler::process_plane_int_cpp (typename DST::Ptr::Type dst_ptr, typename SR
 		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
 		typename DST::Ptr::Type       col_dst_ptr = dst_ptr;
 
-		typedef ScalerCopy <DST, 0, SRC, 0> ScCopy;
+		typedef ScalerCopy <DST, DB, SRC, SB> ScCopy;
 
-		if (ScCopy::can_copy (kernel_info._copy_flt_flag))
+		if (ScCopy::can_copy (kernel_info._copy_int_flag))
 		{
 			ScCopy::copy (col_dst_ptr, col_src_ptr, width);
 		}
@@ -464,6 +592,107 @@ void	Scaler::process_plane_int_cpp (typename DST::Ptr::Type dst_ptr, typename SR
 
 
 
+// Horizontal versions. Stride offsets in pixels.
+// The odd last column is written as a pair, like in the vertical code.
+template <class DST, class SRC>
+void	Scaler::process_plane_h_flt_cpp (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (DST::Ptr::check_ptr (dst_ptr));
+	assert (SRC::PtrConst::check_ptr (src_ptr));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	const float    add_cst = float (_add_cst_flt);
+	const int      x_last  = x_dst_end - 1;
+
+	for (int y = 0; y < height; ++y)
+	{
+		typename DST::Ptr::Type       col_dst_ptr = dst_ptr;
+
+		for (int x = x_dst_beg; x < x_dst_end; x += 2)
+		{
+			float          sum [2] = { add_cst, add_cst };
+
+			for (int c = 0; c < 2; ++c)
+			{
+				const KernelInfo& kernel_info   =
+					_kernel_info_arr [std::min (x + c, x_last)];
+				const int         kernel_size   = kernel_info._kernel_size;
+				const float *     coef_base_ptr = &_coef_flt_arr [kernel_info._coef_index];
+
+				typename SRC::PtrConst::Type  pix_ptr = src_ptr;
+				SRC::PtrConst::jump (pix_ptr, kernel_info._start_line);
+				for (int k = 0; k < kernel_size; ++k)
+				{
+					sum [c] += float (pix_ptr [k]) * coef_base_ptr [k];
+				}
+			}
+
+			DST::write (col_dst_ptr, sum [0], sum [1]);
+
+			DST::Ptr::jump (col_dst_ptr, 2);
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+		SRC::PtrConst::jump (src_ptr, src_stride);
+	}
+}
+
+
+
+// Data are read and written unsigned, there is no sign constant.
+template <class DST, int DB, class SRC, int SB>
+void	Scaler::process_plane_h_int_cpp (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (DST::Ptr::check_ptr (dst_ptr));
+	assert (SRC::PtrConst::check_ptr (src_ptr));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	// Rounding constant for the final shift
+	const int      r_cst    = 1 << (SHIFT_INT + SB - DB - 1);
+	const int      add_cst  = _add_cst_int + r_cst;
+
+	for (int y = 0; y < height; ++y)
+	{
+		typename DST::Ptr::Type       col_dst_ptr = dst_ptr;
+
+		for (int x = x_dst_beg; x < x_dst_end; ++x)
+		{
+			const KernelInfo& kernel_info   = _kernel_info_arr [x];
+			const int         kernel_size   = kernel_info._kernel_size;
+
+			typename SRC::PtrConst::Type  pix_ptr = src_ptr;
+			SRC::PtrConst::jump (pix_ptr, kernel_info._start_line);
+
+			int            sum = add_cst;
+			for (int k = 0; k < kernel_size; ++k)
+			{
+				const int      coef =
+					_coef_int_arr.get_coef (kernel_info._coef_index + k);
+				sum += int (pix_ptr [k]) * coef;
+			}
+
+			sum >>= SHIFT_INT + SB - DB;
+
+			DST::template write_clip <DB> (col_dst_ptr, sum);
+
+			DST::Ptr::jump (col_dst_ptr, 1);
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+		SRC::PtrConst::jump (src_ptr, src_stride);
+	}
+}
+
+
+
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 
 
@@ -695,7 +924,7 @@ void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 #if defined (fmtcl_Scaler_SSE2_16BITS)
 	const __m128i  add_cst  = _mm_set1_epi16 (_add_cst_int + s_cst        );
 #else
-	const __m128i  add_cst  = _mm_set1_epi32 (_add_cst_int + s_cst + r_cst);
+	const int      add_cst_base = _add_cst_int + s_cst + r_cst;
 #endif
 
 	const int      w8 = width & -8;
@@ -709,6 +938,11 @@ void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 		const __m128i *      coef_base_ptr = reinterpret_cast <const __m128i *> (
 			_coef_int_arr.use_vect_sse2 (kernel_info._coef_index)
 		);
+#if ! defined (fmtcl_Scaler_SSE2_16BITS)
+		const __m128i        add_cst       = _mm_set1_epi32 (
+			add_cst_base + ((SB == 16) ? kernel_info._sign_cst_int : 0)
+		);
+#endif
 
 		typename SRC::PtrConst::Type  col_src_ptr = src_ptr;
 		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
@@ -778,21 +1012,339 @@ void	Scaler::process_plane_int_sse2 (typename DST::Ptr::Type dst_ptr, typename S
 
 
 
+// Dot products of 4 destination columns. The result is in column order.
+// ofs_ptr: source positions of the columns, relative to src_ofs.
+// coef_ptr: coefficients of the first column, the next ones follow.
+// NB: number of 8-tap blocks, or 0 to use len.
+template <class SRC, int NB>
+static fstb_FORCEINLINE __m128	Scaler_process_vect_h_flt_sse2 (typename SRC::PtrConst::Type src_ptr, int src_ofs, const int ofs_ptr [4], const float *coef_ptr, int len, const __m128i &zero)
+{
+	if (NB > 0)
+	{
+		len = NB * 8;
+	}
+
+	// One column at a time, so the accumulators stay in registers
+	__m128         sum [4];
+	for (int c = 0; c < 4; ++c)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = src_ptr + (ofs_ptr [c] - src_ofs);
+		const float *  coef_c_ptr = coef_ptr + c * len;
+		__m128         sum0       = _mm_setzero_ps ();
+		__m128         sum1       = _mm_setzero_ps ();
+		for (int k = 0; k < len; k += 8)
+		{
+			__m128         src0;
+			__m128         src1;
+			SRC::read_flt (pix_ptr + k, src0, src1, zero);
+			const __m128   coef0 = _mm_load_ps (coef_c_ptr + k    );
+			const __m128   coef1 = _mm_load_ps (coef_c_ptr + k + 4);
+			sum0 = _mm_add_ps (sum0, _mm_mul_ps (src0, coef0));
+			sum1 = _mm_add_ps (sum1, _mm_mul_ps (src1, coef1));
+		}
+		sum [c] = _mm_add_ps (sum0, sum1);
+	}
+
+	// Horizontal sums
+	const __m128   t0 = _mm_add_ps (
+		_mm_unpacklo_ps (sum [0], sum [1]), _mm_unpackhi_ps (sum [0], sum [1])
+	);
+	const __m128   t1 = _mm_add_ps (
+		_mm_unpacklo_ps (sum [2], sum [3]), _mm_unpackhi_ps (sum [2], sum [3])
+	);
+
+	return (_mm_add_ps (_mm_movelh_ps (t0, t1), _mm_movehl_ps (t1, t0)));
+}
+
+
+
+template <class SRC, int SB, int NB>
+static fstb_FORCEINLINE __m128i	Scaler_process_vect_h_int_sse2 (typename SRC::PtrConst::Type src_ptr, int src_ofs, const int ofs_ptr [4], const int16_t *coef_ptr, int len, const __m128i &zero, const __m128i &sign_bit)
+{
+	typedef typename SRC::template S16 <false, (SB == 16)> SrcS16R;
+
+	if (NB > 0)
+	{
+		len = NB * 8;
+	}
+
+	__m128i        sum [4];
+	for (int c = 0; c < 4; ++c)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = src_ptr + (ofs_ptr [c] - src_ofs);
+		const __m128i* coef_c_ptr =
+			reinterpret_cast <const __m128i *> (coef_ptr + c * len);
+		__m128i        sum_c      = _mm_setzero_si128 ();
+		for (int k = 0; k < len; k += 8)
+		{
+			const __m128i  src  = SrcS16R::read (pix_ptr + k, zero, sign_bit);
+			const __m128i  coef = _mm_load_si128 (coef_c_ptr + (k >> 3));
+			sum_c = _mm_add_epi32 (sum_c, _mm_madd_epi16 (src, coef));
+		}
+		sum [c] = sum_c;
+	}
+
+	const __m128i  t0 = _mm_add_epi32 (
+		_mm_unpacklo_epi32 (sum [0], sum [1]),
+		_mm_unpackhi_epi32 (sum [0], sum [1])
+	);
+	const __m128i  t1 = _mm_add_epi32 (
+		_mm_unpacklo_epi32 (sum [2], sum [3]),
+		_mm_unpackhi_epi32 (sum [2], sum [3])
+	);
+
+	return (_mm_add_epi32 (
+		_mm_unpacklo_epi64 (t0, t1), _mm_unpackhi_epi64 (t0, t1)
+	));
+}
+
+
+
+// Horizontal processing, 8 destination columns per iteration.
+// DST and SRC are ProxyRwSse2 classes
+// Stride offsets in pixels
+template <class DST, class SRC>
+void	Scaler::process_plane_h_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	static const RowHFncPtr <DST, SRC>  row_fnc_arr [H_NB_MAX + 1] =
+	{
+		&ThisType::process_row_h_flt_sse2 <DST, SRC, 0>,
+		&ThisType::process_row_h_flt_sse2 <DST, SRC, 1>,
+		&ThisType::process_row_h_flt_sse2 <DST, SRC, 2>
+	};
+
+	process_plane_h_split <DST, SRC> (
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end,
+		8, row_fnc_arr
+	);
+}
+
+
+
+template <class DST, int DB, class SRC, int SB>
+void	Scaler::process_plane_h_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (_can_int_flag);
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	static const RowHFncPtr <DST, SRC>  row_fnc_arr [H_NB_MAX + 1] =
+	{
+		&ThisType::process_row_h_int_sse2 <DST, DB, SRC, SB, 0>,
+		&ThisType::process_row_h_int_sse2 <DST, DB, SRC, SB, 1>,
+		&ThisType::process_row_h_int_sse2 <DST, DB, SRC, SB, 2>
+	};
+
+	process_plane_h_split <DST, SRC> (
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end,
+		8, row_fnc_arr
+	);
+}
+
+
+
+template <class DST, class SRC, int NB>
+void	Scaler::process_row_h_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const
+{
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128   offset   = _mm_set1_ps (float (DST::OFFSET));
+	const __m128   add_cst  = _mm_set1_ps (float (_add_cst_flt));
+
+	const int      len      = (NB > 0) ? NB * H_GRAN : _h_len;
+	assert (len == _h_len);
+
+	for (int x = x_beg; x < x_end; x += 8)
+	{
+		const int *    ofs_ptr  = &_h_start_arr [x];
+		const float *  coef_ptr = &_coef_h_flt_arr [size_t (x) * size_t (len)];
+
+		const __m128   sum0 = _mm_add_ps (add_cst, Scaler_process_vect_h_flt_sse2 <SRC, NB> (
+			src_ptr, src_ofs, ofs_ptr    , coef_ptr          , len, zero
+		));
+		const __m128   sum1 = _mm_add_ps (add_cst, Scaler_process_vect_h_flt_sse2 <SRC, NB> (
+			src_ptr, src_ofs, ofs_ptr + 4, coef_ptr + 4 * len, len, zero
+		));
+
+		const int      w = x_end - x;
+		if (w >= 8)
+		{
+			DST::write_flt (
+				dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
+			);
+		}
+		else
+		{
+			DST::write_flt_partial (
+				dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w
+			);
+		}
+
+		DST::Ptr::jump (dst_ptr, 8);
+	}
+}
+
+
+
+// Same constants as process_plane_int_sse2()
+template <class DST, int DB, class SRC, int SB, int NB>
+void	Scaler::process_row_h_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const
+{
+	typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
+
+	const int      r_cst    = 1 << (SHIFT_INT + SB - DB - 1);
+	const int      s_in     = (SB < 16) ? -(0x8000 << (SHIFT_INT + SB - DB)) : 0;
+	const int      s_out    = (DB < 16) ?   0x8000 << (SHIFT_INT + SB - DB)  : 0;
+	const int      s_cst    = s_in + s_out;
+
+	const __m128i  zero     = _mm_setzero_si128 ();
+	const __m128i  mask_lsb = _mm_set1_epi16 (0x00FF);
+	const __m128i  sign_bit = _mm_set1_epi16 (-0x8000);
+	const __m128i  ma       = _mm_set1_epi16 (int16_t (uint16_t ((1 << DB) - 1)));
+	const __m128i  add_cst  = _mm_set1_epi32 (_add_cst_int + s_cst + r_cst);
+
+	const int      len      = (NB > 0) ? NB * H_GRAN : _h_len;
+	assert (len == _h_len);
+
+	for (int x = x_beg; x < x_end; x += 8)
+	{
+		const int *    ofs_ptr  = &_h_start_arr [x];
+		const int16_t* coef_ptr = &_coef_h_int_arr [size_t (x) * size_t (len)];
+
+		__m128i        sum0 = _mm_add_epi32 (add_cst, Scaler_process_vect_h_int_sse2 <SRC, SB, NB> (
+			src_ptr, src_ofs, ofs_ptr    , coef_ptr          , len, zero, sign_bit
+		));
+		__m128i        sum1 = _mm_add_epi32 (add_cst, Scaler_process_vect_h_int_sse2 <SRC, SB, NB> (
+			src_ptr, src_ofs, ofs_ptr + 4, coef_ptr + 4 * len, len, zero, sign_bit
+		));
+		if (SB == 16)
+		{
+			const int32_t* sc_ptr = &_h_sign_cst_arr [x];
+			sum0 = _mm_add_epi32 (sum0, _mm_loadu_si128 (
+				reinterpret_cast <const __m128i *> (sc_ptr    )
+			));
+			sum1 = _mm_add_epi32 (sum1, _mm_loadu_si128 (
+				reinterpret_cast <const __m128i *> (sc_ptr + 4)
+			));
+		}
+		sum0 = _mm_srai_epi32 (sum0, SHIFT_INT + SB - DB);
+		sum1 = _mm_srai_epi32 (sum1, SHIFT_INT + SB - DB);
+		const __m128i  val = _mm_packs_epi32 (sum0, sum1);
+
+		const int      w = x_end - x;
+		if (w >= 8)
+		{
+			DstS16W::write_clip (dst_ptr, val, mask_lsb, zero, ma, sign_bit);
+		}
+		else
+		{
+			DstS16W::write_clip_partial (
+				dst_ptr, val, mask_lsb, zero, ma, sign_bit, w
+			);
+		}
+
+		DST::Ptr::jump (dst_ptr, 8);
+	}
+}
+
+
+
 #endif   // fstb_ARCHI_X86
 
 
 
-void	Scaler::build_scale_data ()
+// Finds the coefficients in the process-wide cache, or builds them.
+// Requires all the construction parameters already set.
+std::shared_ptr <const Scaler::CoefData>	Scaler::use_coef_data (bool avx2_flag) const
+{
+	ScalerCache::Key  key;
+	key._src_height     = _src_height;
+	key._dst_height     = _dst_height;
+	key._win_top        = _win_top;
+	key._win_height     = _win_height;
+	key._kernel_scale   = _kernel_scale;
+	key._norm_val       = (_norm_flag) ? _norm_val : 0;
+	key._center_pos_src = _center_pos_src;
+	key._center_pos_dst = _center_pos_dst;
+	key._gain           = _gain;
+	key._norm_flag      = _norm_flag;
+	key._int_flag       = _can_int_flag;
+	key._avx2_flag      = (_can_int_flag && avx2_flag);
+	sample_kernel (key._kernel_arr);
+
+	return ScalerCache::use_instance ().use_coef_data (
+		key,
+		[this, &key] (CoefData &cd)
+		{
+			build_scale_data (cd, key._avx2_flag, key._kernel_arr);
+		}
+	);
+}
+
+
+
+// Evaluates the kernel at the positions required by each destination line,
+// _fir_len values per line.
+void	Scaler::sample_kernel (std::vector <double> &kernel_arr) const
+{
+	BasicInfo      bi (
+		_src_height, _dst_height, _win_top, _win_height,
+		_kernel_fnc, _kernel_scale, _center_pos_src, _center_pos_dst
+	);
+
+	kernel_arr.clear ();
+	kernel_arr.reserve (size_t (_dst_height) * size_t (bi._fir_len));
+	for (int y = 0; y < _dst_height; ++y)
+	{
+		const int      src_pos_beg =
+			fstb::floor_int (bi._src_pos + bi._support) - bi._fir_len + 1;
+		for (int k = 0; k < bi._fir_len; ++k)
+		{
+			const int      p          = src_pos_beg + k;
+			const double   pos_in_fir = (bi._src_pos - p) * bi._imp_step;
+			kernel_arr.push_back (_kernel_fnc.get_val (pos_in_fir));
+		}
+
+		bi._src_pos += bi._src_step;
+	}
+}
+
+
+
+// Results are stored in cd, which should be empty.
+// avx2_flag selects the layout of the integer coefficient vectors.
+// kernel_arr contains the kernel values, as returned by sample_kernel().
+void	Scaler::build_scale_data (CoefData &cd, bool avx2_flag, const std::vector <double> &kernel_arr) const
 {
-	_coef_flt_arr.clear ();
-	_coef_int_arr.clear ();
+	assert (cd._kernel_info_arr.empty ());
+
+	cd._kernel_info_arr.resize (_dst_height);
+	if (avx2_flag)
+	{
+		cd._coef_int_arr.set_avx2_mode (true);
+	}
 
 	BasicInfo      bi (
 		_src_height, _dst_height, _win_top, _win_height,
 		_kernel_fnc, _kernel_scale, _center_pos_src, _center_pos_dst
 	);
 
-	_fir_len = bi._fir_len;
+	cd._fir_len = bi._fir_len;
+	assert (kernel_arr.size () == size_t (_dst_height) * size_t (bi._fir_len));
 
 	class ValPos { public: int _val; int _idx; };
 	std::vector <ValPos> coef_rank;
@@ -811,9 +1363,7 @@ void	Scaler::build_scale_data ()
 		double         sum = 0;
 		for (int k = 0; k < bi._fir_len; ++k)
 		{
-			const int      p          = src_pos_beg + k;
-			const double   pos_in_fir = (bi._src_pos - p) * bi._imp_step;
-			const double   val        = _kernel_fnc.get_val (pos_in_fir);
+			const double   val = kernel_arr [y * bi._fir_len + k];
 
 			coef_tmp.push_back (val);
 			sum += val;
@@ -854,10 +1404,10 @@ void	Scaler::build_scale_data ()
 		amp *= _gain;
 
 		// Second pass: builds the actual FIR, handling picture edge conditions.
-		KernelInfo &   info = _kernel_info_arr [y];
+		KernelInfo &   info = cd._kernel_info_arr [y];
 		double         accu = 0;
 		info._kernel_size   = 0;
-		info._coef_index    = int (_coef_flt_arr.size ());
+		info._coef_index    = int (cd._coef_flt_arr.size ());
 		info._start_line    = fstb::limit (src_pos_beg, 0, last_line);
 		info._copy_flt_flag = false;
 		info._copy_int_flag = false;
@@ -871,12 +1421,12 @@ void	Scaler::build_scale_data ()
 				++ info._kernel_size;
 
 				// Float part
-				_coef_flt_arr.push_back (float (accu));
+				cd._coef_flt_arr.push_back (float (accu));
 
 				// Integer part
 				if (_can_int_flag)
 				{
-					push_back_int_coef (accu);
+					push_back_int_coef (cd._coef_int_arr, accu);
 				}
 
 				accu = 0;
@@ -891,12 +1441,12 @@ void	Scaler::build_scale_data ()
 			++ info._kernel_size;
 
 			// Float part
-			_coef_flt_arr.push_back (float (accu));
+			cd._coef_flt_arr.push_back (float (accu));
 
 			// Integer part
 			if (_can_int_flag)
 			{
-				push_back_int_coef (accu);
+				push_back_int_coef (cd._coef_int_arr, accu);
 			}
 		}
 
@@ -907,7 +1457,7 @@ void	Scaler::build_scale_data ()
 			const int      nbr_coef = info._kernel_size;
 			for (int k = 0; k < nbr_coef; ++k)
 			{
-				sum_i += _coef_int_arr.get_coef (info._coef_index + k);
+				sum_i += cd._coef_int_arr.get_coef (info._coef_index + k);
 			}
 
 			const int      target = fstb::round_int (sum * amp * (1 << SHIFT_INT));
@@ -924,7 +1474,7 @@ void	Scaler::build_scale_data ()
 				{
 					const int      idx = info._coef_index + k;
 					coef_rank.emplace_back (ValPos {
-						std::abs (_coef_int_arr.get_coef (idx)), idx
+						std::abs (cd._coef_int_arr.get_coef (idx)), idx
 					});
 				}
 				std::sort (
@@ -941,8 +1491,8 @@ void	Scaler::build_scale_data ()
 					for (int i = 0; i < count; ++i)
 					{
 						const int      index = coef_rank [i]._idx;
-						const int      fixed = _coef_int_arr.get_coef (index) + unit;
-						_coef_int_arr.set_coef (index, fixed);
+						const int      fixed = cd._coef_int_arr.get_coef (index) + unit;
+						cd._coef_int_arr.set_coef (index, fixed);
 					}
 				}
 
@@ -955,11 +1505,11 @@ void	Scaler::build_scale_data ()
 					for (int i = 0; i < nbr_coef && rem > 0; ++i)
 					{
 						const int      index = coef_rank [i]._idx;
-						const int      old   = _coef_int_arr.get_coef (index);
+						const int      old   = cd._coef_int_arr.get_coef (index);
 						int            fixed = old + rem * unit;
 						fixed = fstb::limit <int> (fixed, INT16_MIN, INT16_MAX);
 						rem  -= std::abs (fixed - old);
-						_coef_int_arr.set_coef (index, fixed);
+						cd._coef_int_arr.set_coef (index, fixed);
 					}
 					assert (rem == 0);
 				}
@@ -967,12 +1517,14 @@ void	Scaler::build_scale_data ()
 		}
 
 		// Finally, trivial kernel optimization (removes null coefficients
-		// on the sides)
+		// on the sides). The integer coefficients must be null too, the sum
+		// fix may have changed some of them.
 		const float    thr_0_flt = float (_gain * 1e-6f);
 		while (info._kernel_size > 1)
 		{
 			const int      index_last = info._coef_index + info._kernel_size - 1;
-			if (fabs (_coef_flt_arr [index_last]) > thr_0_flt)
+			if (   fabs (cd._coef_flt_arr [index_last]) > thr_0_flt
+			    || (_can_int_flag && cd._coef_int_arr.get_coef (index_last) != 0))
 			{
 				break;
 			}
@@ -980,7 +1532,9 @@ void	Scaler::build_scale_data ()
 		}
 		while (info._kernel_size > 1)
 		{
-			if (fabs (_coef_flt_arr [info._coef_index]) > thr_0_flt)
+			const int      index_first = info._coef_index;
+			if (   fabs (cd._coef_flt_arr [index_first]) > thr_0_flt
+			    || (_can_int_flag && cd._coef_int_arr.get_coef (index_first) != 0))
 			{
 				break;
 			}
@@ -989,16 +1543,31 @@ void	Scaler::build_scale_data ()
 			-- info._kernel_size;
 		}
 
+		// With 16-bit input, the vector integer code computes the sum of
+		// c * (x - 0x8000) then flips the sign bit of the result. The result
+		// is exact only if the coefficients sum to 1, so the difference is
+		// added to the summing constant.
+		info._sign_cst_int = 0;
+		if (_can_int_flag)
+		{
+			int            sum_i = 0;
+			for (int k = 0; k < info._kernel_size; ++k)
+			{
+				sum_i += cd._coef_int_arr.get_coef (info._coef_index + k);
+			}
+			info._sign_cst_int = 0x8000 * (sum_i - (1 << SHIFT_INT));
+		}
+
 		// Single, unit coefficient: we can copy the line
 		const float    thr_1_flt = 1e-5f;
 		if (info._kernel_size == 1)
 		{
-			const float    d_flt = fabsf (_coef_flt_arr [info._coef_index] - 1.0f);
+			const float    d_flt = fabsf (cd._coef_flt_arr [info._coef_index] - 1.0f);
 			info._copy_flt_flag = (d_flt <= thr_1_flt);
 
 			if (_can_int_flag)
 			{
-				const int      c_int = _coef_int_arr.get_coef (info._coef_index);
+				const int      c_int = cd._coef_int_arr.get_coef (info._coef_index);
 				const int      unit  = 1 << SHIFT_INT;
 				info._copy_int_flag = (c_int == unit);
 			}
@@ -1011,7 +1580,7 @@ void	Scaler::build_scale_data ()
 
 
 
-void	Scaler::push_back_int_coef (double coef)
+void	Scaler::push_back_int_coef (CoefArrInt &coef_int_arr, double coef)
 {
 	const double   cintsc   = double ((uint64_t (1)) << SHIFT_INT);
 	double         coef_mul = coef * cintsc;
@@ -1019,9 +1588,9 @@ void	Scaler::push_back_int_coef (double coef)
 	const int      coef_int = fstb::round_int (coef_mul);
 	assert (coef_int >= INT16_MIN && coef_int <= INT16_MAX);
 
-	const size_t   ci_pos   = _coef_int_arr.get_size ();
-	_coef_int_arr.resize (int (ci_pos + 1));
-	_coef_int_arr.set_coef (int (ci_pos), coef_int);
+	const size_t   ci_pos   = coef_int_arr.get_size ();
+	coef_int_arr.resize (int (ci_pos + 1));
+	coef_int_arr.set_coef (int (ci_pos), coef_int);
 }
 
 
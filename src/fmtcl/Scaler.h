@@ -33,6 +33,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fmtcl/CoefArrInt.h"
 #include "fstb/AllocAlign.h"
 
+#include <memory>
 #include <vector>
 
 #include <cstddef>
@@ -107,11 +108,39 @@ public:
 	static const int  SHIFT_INT   = 12; // Number of bits for the fractional part
 #endif   // fmtcl_Scaler_SSE2_16BITS
 
-	explicit       Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag);
+	class KernelInfo
+	{
+	public:
+		int            _start_line;	   // Y position of the first line of the kernel
+		int            _coef_index;
+		int            _kernel_size;
+		bool           _copy_flt_flag;
+		bool           _copy_int_flag;
+
+		// Vector integer code: 16-bit input data are made signed, so their
+		// offset has to be compensated depending on the coefficient sum.
+		int            _sign_cst_int;
+	};
+
+	// Coefficient tables. They depend only on the construction parameters
+	// and are shared between Scaler objects through ScalerCache.
+	class CoefData
+	{
+	public:
+		int            _fir_len = 0;
+		std::vector <KernelInfo>            // For each destination line
+		               _kernel_info_arr;
+		std::vector <float, fstb::AllocAlign <float, 16> > // All kernel coefs, for all lines.
+		               _coef_flt_arr;       // Beware, kernels may not be contiguous.
+		CoefArrInt     _coef_int_arr;       // Same here
+	};
+
+	explicit       Scaler (int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, bool norm_flag, double norm_val, double center_pos_src, double center_pos_dst, double gain, double add_cst, bool int_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag);
 	virtual        ~Scaler () {}
 
 	void           get_src_boundaries (int &y_src_beg, int &y_src_end, int y_dst_beg, int y_dst_end) const;
 	int            get_fir_len () const;
+	void           setup_h ();
 
 #define fmtcl_Scaler_DECLARE_F(DT, ST, DE, SE, FN) \
 	void           process_plane_flt (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
@@ -119,15 +148,27 @@ public:
 #define fmtcl_Scaler_DECLARE_I(DT, ST, DE, SE, DB, SB, FN) \
 	void           process_plane_int_##FN (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
+// Horizontal processing. Requires a prior call to setup_h().
+#define fmtcl_Scaler_DECLARE_HF(DT, ST, DE, SE, FN) \
+	void           process_plane_h_flt (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+#define fmtcl_Scaler_DECLARE_HI(DT, ST, DE, SE, DB, SB, FN) \
+	void           process_plane_h_int_##FN (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
 	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_DECLARE_F)
 	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_DECLARE_I)
+	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_DECLARE_HF)
+	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_DECLARE_HI)
 
 #undef fmtcl_Scaler_DECLARE_F
 #undef fmtcl_Scaler_DECLARE_I
+#undef fmtcl_Scaler_DECLARE_HF
+#undef fmtcl_Scaler_DECLARE_HI
 
 	static void    eval_req_src_area (int &work_top, int &work_height, int src_height, int dst_height, double win_top, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, double center_pos_src, double center_pos_dst);
 	static int     eval_lower_bound_of_dst_tile_height (int tile_height_src, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, int src_height);
 	static int     eval_lower_bound_of_src_tile_height (int tile_height_dst, int dst_height, double win_height, ContFirInterface &kernel_fnc, double kernel_scale, int src_height);
+	static bool    eval_h_efficiency (int dst_width, double win_width, ContFirInterface &kernel_fnc, double kernel_scale);
 
 
 
@@ -141,6 +182,10 @@ protected:
 
 private:
 
+	static const int  H_GRAN      = 8;  // Granularity of the horizontal kernel length
+	static const int  H_COL_PAD   = 16; // Max number of columns per vector iteration
+	static const int  H_NB_MAX    = 2;  // Max H_GRAN-tap block count with a dedicated row function
+
 	class BasicInfo
 	{
 	public:
@@ -154,18 +199,9 @@ private:
 		int            _fir_len;
 	};
 
-	class KernelInfo
-	{
-	public:
-		int            _start_line;	   // Y position of the first line of the kernel
-		int            _coef_index;
-		int            _kernel_size;
-		bool           _copy_flt_flag;
-		bool           _copy_int_flag;
-	};
-
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	void           setup_avx2 ();
+	void           setup_avx512 ();
 #endif
 
 	template <class DST, class SRC>
@@ -188,10 +224,61 @@ private:
 	template <class DST, int DB, class SRC, int SB>
 	void           process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
+	template <class DST, class SRC>
+	void           process_plane_flt_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
+
+	template <class DST, int DB, class SRC, int SB>
+	void           process_plane_int_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
+
 #endif   // fstb_ARCHI_X86
 
-	void           build_scale_data ();
-	void           push_back_int_coef (double coef);
+	template <class DST, class SRC>
+	void           process_plane_h_flt_cpp (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+	template <class DST, int DB, class SRC, int SB>
+	void           process_plane_h_int_cpp (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+
+	template <class DST, class SRC>
+	void           process_plane_h_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+	template <class DST, int DB, class SRC, int SB>
+	void           process_plane_h_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+	template <class DST, class SRC>
+	void           process_plane_h_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+	template <class DST, int DB, class SRC, int SB>
+	void           process_plane_h_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+	// NB is the number of H_GRAN-tap blocks per column, 0 for any length.
+	template <class DST, class SRC, int NB>
+	void           process_row_h_flt_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const;
+
+	template <class DST, int DB, class SRC, int SB, int NB>
+	void           process_row_h_int_sse2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const;
+
+	template <class DST, class SRC, int NB>
+	void           process_row_h_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const;
+
+	template <class DST, int DB, class SRC, int SB, int NB>
+	void           process_row_h_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const;
+
+#endif   // fstb_ARCHI_X86
+
+	template <class DST, class SRC>
+	using RowHFncPtr = void (ThisType::*) (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const;
+
+	template <class DST, class SRC>
+	void           process_plane_h_split (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end, int grp_len, const RowHFncPtr <DST, SRC> row_fnc_arr [H_NB_MAX + 1]) const;
+
+	std::shared_ptr <const CoefData>
+	               use_coef_data (bool avx2_flag) const;
+	void           sample_kernel (std::vector <double> &kernel_arr) const;
+	void           build_scale_data (CoefData &cd, bool avx2_flag, const std::vector <double> &kernel_arr) const;
+
+	static void    push_back_int_coef (CoefArrInt &coef_int_arr, double coef);
 
 	int            _src_height;
 	int            _dst_height;
@@ -208,13 +295,32 @@ private:
 	double         _gain;
 	double         _add_cst_flt;
 	int32_t        _add_cst_int;
-	int            _fir_len;
 
-	std::vector <KernelInfo>            // For each destination line
+	std::shared_ptr <const CoefData>    // Shared, never modified
+	               _coef_data_sptr;
+	int            _fir_len;
+	const std::vector <KernelInfo> &    // Shortcuts to the _coef_data_sptr content
 	               _kernel_info_arr;
-	std::vector <float, fstb::AllocAlign <float, 16> > // All kernel coefs, for all lines.
-	               _coef_flt_arr;       // Beware, kernels may not be contiguous.
-	CoefArrInt     _coef_int_arr;       // Same here
+	const std::vector <float, fstb::AllocAlign <float, 16> > &
+	               _coef_flt_arr;
+	const CoefArrInt &
+	               _coef_int_arr;
+
+	// Horizontal processing: each destination column has _h_len contiguous
+	// coefficients starting at _h_start_arr [x], zero-padded after the
+	// actual kernel. _h_len is a multiple of H_GRAN, 0 if setup_h() has not
+	// been called. The tables are padded with H_COL_PAD copies of the last
+	// column, so the vector code can process full groups of columns.
+	// _h_sign_cst_arr holds the KernelInfo::_sign_cst_int of each column.
+	int            _h_len;
+	std::vector <int>
+	               _h_start_arr;
+	std::vector <int32_t, fstb::AllocAlign <int32_t, 32> >
+	               _h_sign_cst_arr;
+	std::vector <float, fstb::AllocAlign <float, 32> >
+	               _coef_h_flt_arr;
+	std::vector <int16_t, fstb::AllocAlign <int16_t, 32> >
+	               _coef_h_int_arr;
 
 #define fmtcl_Scaler_FNCPTR_F(DT, ST, DE, SE, FN) \
 	void (ThisType::* \
@@ -224,11 +330,23 @@ private:
 	void (ThisType::* \
 	               _process_plane_int_##FN##_ptr) (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const;
 
+#define fmtcl_Scaler_FNCPTR_HF(DT, ST, DE, SE, FN) \
+	void (ThisType::* \
+	               _process_plane_h_flt_##FN##_ptr) (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
+#define fmtcl_Scaler_FNCPTR_HI(DT, ST, DE, SE, DB, SB, FN) \
+	void (ThisType::* \
+	               _process_plane_h_int_##FN##_ptr) (Proxy::Ptr##DT::Type dst_ptr, Proxy::Ptr##ST##Const::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const;
+
 	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_FNCPTR_F)
 	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_FNCPTR_I)
+	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_FNCPTR_HF)
+	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_FNCPTR_HI)
 
 #undef fmtcl_Scaler_FNCPTR_F
 #undef fmtcl_Scaler_FNCPTR_I
+#undef fmtcl_Scaler_FNCPTR_HF
+#undef fmtcl_Scaler_FNCPTR_HI
 
 
 
@@ -250,7 +368,7 @@ private:
 
 
 
-//#include "fmtcl/Scaler.hpp"
+#include "fmtcl/Scaler.hpp"
 
 
 
@@ -0,0 +1,148 @@
+/*****************************************************************************
+
+        Scaler.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_Scaler_CODEHEADER_INCLUDED)
+#define	fmtcl_Scaler_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <algorithm>
+#include <vector>
+
+#include <cassert>
+#include <climits>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Common line loop for the vector horizontal kernels, which read _h_len
+// contiguous source pixels per destination column.
+// Columns are processed by groups of grp_len. The last groups, whose taps
+// could be read outside the source area, are computed from a zero-padded
+// copy of the end of the line. The results of the columns located after
+// x_dst_end are discarded.
+// row_fnc_arr contains the row functions indexed by the number of H_GRAN-tap
+// blocks, index 0 being the generic version.
+// A row function (dst_ptr, src_ptr, src_ofs, x_beg, x_end) processes a
+// single line. dst_ptr points to column x_beg and src_ptr to column src_ofs.
+// Here src_ptr is the left of the full source line, dst_ptr is the top-left
+// corner of the destination tile.
+template <class DST, class SRC>
+void	Scaler::process_plane_h_split (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end, int grp_len, const RowHFncPtr <DST, SRC> row_fnc_arr [H_NB_MAX + 1]) const
+{
+	assert (_h_len > 0);
+	assert (height > 0);
+	assert (grp_len > 0);
+	assert (grp_len <= H_COL_PAD);
+
+	typedef typename SRC::Ptr::DataType SrcType;
+
+	const int      nb = _h_len / H_GRAN;
+	const RowHFncPtr <DST, SRC>   row_fnc_ptr =
+		row_fnc_arr [(nb <= H_NB_MAX) ? nb : 0];
+
+	int            x_src_beg;
+	int            x_src_end;
+	get_src_boundaries (x_src_beg, x_src_end, x_dst_beg, x_dst_end);
+
+	int            x_tail = x_dst_beg;
+	while (   x_tail < x_dst_end
+	       && _h_start_arr [x_tail] >= x_src_beg
+	       && _h_start_arr [x_tail] + _h_len <= x_src_end)
+	{
+		++ x_tail;
+	}
+	x_tail = x_dst_beg + (x_tail - x_dst_beg) / grp_len * grp_len;
+
+	// Source area required by the tail, including the unused columns of the
+	// last group
+	const int      x_tail_end =
+		x_tail + (x_dst_end - x_tail + grp_len - 1) / grp_len * grp_len;
+	int            tail_src_beg = INT_MAX;
+	int            tail_src_end = INT_MIN;
+	for (int x = x_tail; x < x_tail_end; ++x)
+	{
+		tail_src_beg = std::min (tail_src_beg, _h_start_arr [x]);
+		tail_src_end = std::max (tail_src_end, _h_start_arr [x] + _h_len);
+	}
+	const int      copy_beg = std::max (tail_src_beg, x_src_beg);
+	const int      copy_len = x_src_end - copy_beg;
+	std::vector <SrcType> tail_arr;
+	if (x_tail < x_dst_end)
+	{
+		assert (copy_len > 0);
+		tail_arr.resize (tail_src_end - tail_src_beg, SrcType (0));
+	}
+
+	for (int y = 0; y < height; ++y)
+	{
+		if (x_tail > x_dst_beg)
+		{
+			(this->*row_fnc_ptr) (dst_ptr, src_ptr, 0, x_dst_beg, x_tail);
+		}
+
+		if (x_tail < x_dst_end)
+		{
+			typename SRC::PtrConst::Type  copy_src_ptr = src_ptr;
+			SRC::PtrConst::jump (copy_src_ptr, copy_beg);
+			SRC::Ptr::copy (
+				tail_arr.data () + (copy_beg - tail_src_beg),
+				copy_src_ptr,
+				copy_len
+			);
+
+			typename DST::Ptr::Type       tail_dst_ptr = dst_ptr;
+			DST::Ptr::jump (tail_dst_ptr, x_tail - x_dst_beg);
+			(this->*row_fnc_ptr) (
+				tail_dst_ptr, tail_arr.data (), tail_src_beg, x_tail, x_dst_end
+			);
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+		SRC::PtrConst::jump (src_ptr, src_stride);
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_Scaler_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,127 @@
+/*****************************************************************************
+
+        ScalerCache.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ScalerCache.h"
+
+#include <tuple>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+bool	ScalerCache::Key::operator < (const Key &other) const
+{
+	return std::tie (
+		_src_height,
+		_dst_height,
+		_win_top,
+		_win_height,
+		_kernel_scale,
+		_norm_val,
+		_center_pos_src,
+		_center_pos_dst,
+		_gain,
+		_norm_flag,
+		_int_flag,
+		_avx2_flag,
+		_kernel_arr
+	) < std::tie (
+		other._src_height,
+		other._dst_height,
+		other._win_top,
+		other._win_height,
+		other._kernel_scale,
+		other._norm_val,
+		other._center_pos_src,
+		other._center_pos_dst,
+		other._gain,
+		other._norm_flag,
+		other._int_flag,
+		other._avx2_flag,
+		other._kernel_arr
+	);
+}
+
+
+
+ScalerCache &	ScalerCache::use_instance ()
+{
+	static ScalerCache   instance;
+
+	return instance;
+}
+
+
+
+// build_fnc is called only if the tables are not already in memory.
+// The returned tables are never modified afterwards and can be shared.
+ScalerCache::CoefDataSPtr	ScalerCache::use_coef_data (const Key &key, const BuildFnc &build_fnc)
+{
+	assert (build_fnc);
+
+	return _cache.use_data (
+		key,
+		[&build_fnc] ()
+		{
+			auto           cd_sptr = std::make_shared <Scaler::CoefData> ();
+			build_fnc (*cd_sptr);
+			return CoefDataSPtr (cd_sptr);
+		}
+	);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+ScalerCache::ScalerCache ()
+:	_cache (false)
+{
+	// Nothing
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
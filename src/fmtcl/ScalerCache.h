@@ -0,0 +1,137 @@
+/*****************************************************************************
+
+        ScalerCache.h
+        Author: Laurent de Soras, 2024
+
+Process-wide storage for the Scaler coefficient tables. Scalers built with
+the same geometry, kernel and normalisation parameters share a single set
+of tables, whatever the filter instance, plane or direction they belong to.
+
+Tables are reference-counted: they are released with the last Scaler using
+them. Storage is handled by SharedCache.
+
+This is a singleton, use use_instance() to access it. All the public
+functions are thread-safe.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_ScalerCache_HEADER_INCLUDED)
+#define fmtcl_ScalerCache_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/Scaler.h"
+#include "fmtcl/SharedCache.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+
+namespace fmtcl
+{
+
+
+
+class ScalerCache
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	typedef std::shared_ptr <const Scaler::CoefData> CoefDataSPtr;
+
+	// Fills an empty Scaler::CoefData object
+	typedef std::function <void (Scaler::CoefData &cd)> BuildFnc;
+
+	// All the Scaler parameters involved in the coefficient calculation.
+	// The kernel is identified by the values actually used to build the
+	// tables, so the key doesn't rely on any caller-supplied identifier.
+	class Key
+	{
+	public:
+		bool           operator < (const Key &other) const;
+
+		int            _src_height     = 0;
+		int            _dst_height     = 0;
+		double         _win_top        = 0;
+		double         _win_height     = 0;
+		double         _kernel_scale   = 0;
+		double         _norm_val       = 0;
+		double         _center_pos_src = 0;
+		double         _center_pos_dst = 0;
+		double         _gain           = 0;
+		bool           _norm_flag      = false;
+		bool           _int_flag       = false;
+		bool           _avx2_flag      = false; // Layout of the integer coefficients
+		std::vector <double>                    // Kernel samples for each line
+		               _kernel_arr;
+	};
+
+	static ScalerCache &
+	               use_instance ();
+
+	CoefDataSPtr   use_coef_data (const Key &key, const BuildFnc &build_fnc);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               ScalerCache ();
+
+	SharedCache <Key, Scaler::CoefData>
+	               _cache;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               ScalerCache (const ScalerCache &other)         = delete;
+	               ScalerCache (ScalerCache &&other)              = delete;
+	ScalerCache &  operator = (const ScalerCache &other)          = delete;
+	ScalerCache &  operator = (ScalerCache &&other)               = delete;
+	bool           operator == (const ScalerCache &other) const   = delete;
+	bool           operator != (const ScalerCache &other) const   = delete;
+
+};	// class ScalerCache
+
+
+
+}	// namespace fmtcl
+
+
+
+//#include "fmtcl/ScalerCache.hpp"
+
+
+
+#endif	// fmtcl_ScalerCache_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
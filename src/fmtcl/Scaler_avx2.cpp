@@ -64,16 +64,26 @@ namespace fmtcl
 #define fmtcl_Scaler_INIT_I_AVX2(DT, ST, DE, SE, DB, SB, FN) \
 	_process_plane_int_##FN##_ptr = &ThisType::process_plane_int_avx2 <ProxyRwAvx2 <SplFmt_##DE>, DB, ProxyRwAvx2 <SplFmt_##SE>, SB>;
 
+#define fmtcl_Scaler_INIT_HF_AVX2(DT, ST, DE, SE, FN) \
+	_process_plane_h_flt_##FN##_ptr = &ThisType::process_plane_h_flt_avx2 <ProxyRwAvx2 <SplFmt_##DE>, ProxyRwAvx2 <SplFmt_##SE> >;
+
+#define fmtcl_Scaler_INIT_HI_AVX2(DT, ST, DE, SE, DB, SB, FN) \
+	_process_plane_h_int_##FN##_ptr = &ThisType::process_plane_h_int_avx2 <ProxyRwAvx2 <SplFmt_##DE>, DB, ProxyRwAvx2 <SplFmt_##SE>, SB>;
+
 void  Scaler::setup_avx2 ()
 {
 	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_AVX2)
+	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_HF_AVX2)
 #if ! defined (fmtcl_Scaler_SSE2_16BITS)
 	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_AVX2)
+	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_HI_AVX2)
 #endif
 }
 
 #undef fmtcl_Scaler_INIT_F_AVX2
 #undef fmtcl_Scaler_INIT_I_AVX2
+#undef fmtcl_Scaler_INIT_HF_AVX2
+#undef fmtcl_Scaler_INIT_HI_AVX2
 
 
 
@@ -255,7 +265,7 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
 	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
 	const __m256i  ma       = _mm256_set1_epi16 (int16_t (uint16_t ((1 << DB) - 1)));
-	const __m256i  add_cst  = _mm256_set1_epi32 (_add_cst_int + s_cst + r_cst);
+	const int      add_cst_base = _add_cst_int + s_cst + r_cst;
 
 	const int      w16 = width & -16;
 	const int      w15 = width - w16;
@@ -268,6 +278,9 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 		const __m256i *      coef_base_ptr = reinterpret_cast <const __m256i *> (
 			_coef_int_arr.use_vect_avx2 (kernel_info._coef_index)
 		);
+		const __m256i        add_cst       = _mm256_set1_epi32 (
+			add_cst_base + ((SB == 16) ? kernel_info._sign_cst_int : 0)
+		);
 
 		typename SRC::PtrConst::Type  col_src_ptr = src_ptr;
 		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
@@ -337,6 +350,314 @@ void	Scaler::process_plane_int_avx2 (typename DST::Ptr::Type dst_ptr, typename S
 
 
 
+// Horizontal processing
+
+// Loads 8 contiguous pixels as float
+static fstb_FORCEINLINE __m256	Scaler_load_h_flt_avx2 (const float *ptr)
+{
+	return (_mm256_loadu_ps (ptr));
+}
+
+static fstb_FORCEINLINE __m256	Scaler_load_h_flt_avx2 (const uint16_t *ptr)
+{
+	const __m128i  src = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr));
+
+	return (_mm256_cvtepi32_ps (_mm256_cvtepu16_epi32 (src)));
+}
+
+static fstb_FORCEINLINE __m256	Scaler_load_h_flt_avx2 (const uint8_t *ptr)
+{
+	const __m128i  src = _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr));
+
+	return (_mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (src)));
+}
+
+
+
+// Loads 8 contiguous pixels from each pointer, one per 128-bit lane.
+static fstb_FORCEINLINE __m256i	Scaler_load_h_i16_avx2 (const uint16_t *ptr0, const uint16_t *ptr1)
+{
+	const __m128i  src0 = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr0));
+	const __m128i  src1 = _mm_loadu_si128 (reinterpret_cast <const __m128i *> (ptr1));
+
+	return (_mm256_inserti128_si256 (_mm256_castsi128_si256 (src0), src1, 1));
+}
+
+static fstb_FORCEINLINE __m256i	Scaler_load_h_i16_avx2 (const uint8_t *ptr0, const uint8_t *ptr1)
+{
+	const __m128i  src0 = _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr0));
+	const __m128i  src1 = _mm_loadl_epi64 (reinterpret_cast <const __m128i *> (ptr1));
+
+	return (_mm256_cvtepu8_epi16 (_mm_unpacklo_epi64 (src0, src1)));
+}
+
+
+
+// Dot products of 8 destination columns. The result is in column order.
+// ofs_ptr: source positions of the columns, relative to src_ofs.
+// coef_ptr: coefficients of the first column, the next ones follow.
+// NB: number of 8-tap blocks, or 0 to use len.
+template <class SRC, int NB>
+static fstb_FORCEINLINE __m256	Scaler_process_vect_h_flt_avx2 (typename SRC::PtrConst::Type src_ptr, int src_ofs, const int ofs_ptr [8], const float *coef_ptr, int len)
+{
+	if (NB > 0)
+	{
+		len = NB * 8;
+	}
+
+	// One column at a time, so the accumulators stay in registers
+	__m256         sum [8];
+	for (int c = 0; c < 8; ++c)
+	{
+		typename SRC::PtrConst::Type  pix_ptr = src_ptr + (ofs_ptr [c] - src_ofs);
+		const float *  coef_c_ptr = coef_ptr + c * len;
+		__m256         sum_c      = _mm256_setzero_ps ();
+		for (int k = 0; k < len; k += 8)
+		{
+			const __m256   src  = Scaler_load_h_flt_avx2 (pix_ptr + k);
+			const __m256   coef = _mm256_load_ps (coef_c_ptr + k);
+			sum_c = _mm256_add_ps (sum_c, _mm256_mul_ps (src, coef));
+		}
+		sum [c] = sum_c;
+	}
+
+	// Horizontal sums. Lanes: { 0 1 2 3 | 0 1 2 3 } then { 4 5 6 7 | 4 5 6 7 }
+	const __m256   t0 = _mm256_hadd_ps (sum [0], sum [1]);
+	const __m256   t1 = _mm256_hadd_ps (sum [2], sum [3]);
+	const __m256   t2 = _mm256_hadd_ps (sum [4], sum [5]);
+	const __m256   t3 = _mm256_hadd_ps (sum [6], sum [7]);
+	const __m256   u0 = _mm256_hadd_ps (t0, t1);
+	const __m256   u1 = _mm256_hadd_ps (t2, t3);
+
+	return (_mm256_add_ps (
+		_mm256_permute2f128_ps (u0, u1, 0x20),
+		_mm256_permute2f128_ps (u0, u1, 0x31)
+	));
+}
+
+
+
+// Columns c and c + 4 are processed in the same register, one per lane.
+template <class SRC, int SB, int NB>
+static fstb_FORCEINLINE __m256i	Scaler_process_vect_h_int_avx2 (typename SRC::PtrConst::Type src_ptr, int src_ofs, const int ofs_ptr [8], const int16_t *coef_ptr, int len, const __m256i &sign_bit)
+{
+	if (NB > 0)
+	{
+		len = NB * 8;
+	}
+
+	__m256i        sum [4];
+	for (int c = 0; c < 4; ++c)
+	{
+		typename SRC::PtrConst::Type  pix0_ptr = src_ptr + (ofs_ptr [c    ] - src_ofs);
+		typename SRC::PtrConst::Type  pix1_ptr = src_ptr + (ofs_ptr [c + 4] - src_ofs);
+		const int16_t* coef0_ptr = coef_ptr +  c      * len;
+		const int16_t* coef1_ptr = coef_ptr + (c + 4) * len;
+		__m256i        sum_c     = _mm256_setzero_si256 ();
+		for (int k = 0; k < len; k += 8)
+		{
+			__m256i        src = Scaler_load_h_i16_avx2 (pix0_ptr + k, pix1_ptr + k);
+			if (SB == 16)
+			{
+				src = _mm256_xor_si256 (src, sign_bit);
+			}
+			const __m256i  coef = _mm256_inserti128_si256 (
+				_mm256_castsi128_si256 (_mm_load_si128 (
+					reinterpret_cast <const __m128i *> (coef0_ptr + k)
+				)),
+				_mm_load_si128 (reinterpret_cast <const __m128i *> (coef1_ptr + k)),
+				1
+			);
+			sum_c = _mm256_add_epi32 (sum_c, _mm256_madd_epi16 (src, coef));
+		}
+		sum [c] = sum_c;
+	}
+
+	const __m256i  t0 = _mm256_add_epi32 (
+		_mm256_unpacklo_epi32 (sum [0], sum [1]),
+		_mm256_unpackhi_epi32 (sum [0], sum [1])
+	);
+	const __m256i  t1 = _mm256_add_epi32 (
+		_mm256_unpacklo_epi32 (sum [2], sum [3]),
+		_mm256_unpackhi_epi32 (sum [2], sum [3])
+	);
+
+	return (_mm256_add_epi32 (
+		_mm256_unpacklo_epi64 (t0, t1), _mm256_unpackhi_epi64 (t0, t1)
+	));
+}
+
+
+
+// 16 destination columns per iteration.
+// DST and SRC are ProxyRwAvx2 classes
+// Stride offsets in pixels
+template <class DST, class SRC>
+void	Scaler::process_plane_h_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	static const RowHFncPtr <DST, SRC>  row_fnc_arr [H_NB_MAX + 1] =
+	{
+		&ThisType::process_row_h_flt_avx2 <DST, SRC, 0>,
+		&ThisType::process_row_h_flt_avx2 <DST, SRC, 1>,
+		&ThisType::process_row_h_flt_avx2 <DST, SRC, 2>
+	};
+
+	process_plane_h_split <DST, SRC> (
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end,
+		16, row_fnc_arr
+	);
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <class DST, int DB, class SRC, int SB>
+void	Scaler::process_plane_h_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int height, int x_dst_beg, int x_dst_end) const
+{
+	assert (_can_int_flag);
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert (dst_stride != 0);
+	assert (height > 0);
+	assert (x_dst_beg >= 0);
+	assert (x_dst_beg < x_dst_end);
+	assert (x_dst_end <= _dst_height);
+
+	static const RowHFncPtr <DST, SRC>  row_fnc_arr [H_NB_MAX + 1] =
+	{
+		&ThisType::process_row_h_int_avx2 <DST, DB, SRC, SB, 0>,
+		&ThisType::process_row_h_int_avx2 <DST, DB, SRC, SB, 1>,
+		&ThisType::process_row_h_int_avx2 <DST, DB, SRC, SB, 2>
+	};
+
+	process_plane_h_split <DST, SRC> (
+		dst_ptr, src_ptr, dst_stride, src_stride, height, x_dst_beg, x_dst_end,
+		16, row_fnc_arr
+	);
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <class DST, class SRC, int NB>
+void	Scaler::process_row_h_flt_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const
+{
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256   offset   = _mm256_set1_ps (float (DST::OFFSET));
+	const __m256   add_cst  = _mm256_set1_ps (float (_add_cst_flt));
+
+	const int      len      = (NB > 0) ? NB * H_GRAN : _h_len;
+	assert (len == _h_len);
+
+	for (int x = x_beg; x < x_end; x += 16)
+	{
+		const int *    ofs_ptr  = &_h_start_arr [x];
+		const float *  coef_ptr = &_coef_h_flt_arr [size_t (x) * size_t (len)];
+
+		const __m256   sum0 = _mm256_add_ps (add_cst, Scaler_process_vect_h_flt_avx2 <SRC, NB> (
+			src_ptr, src_ofs, ofs_ptr    , coef_ptr          , len
+		));
+		const __m256   sum1 = _mm256_add_ps (add_cst, Scaler_process_vect_h_flt_avx2 <SRC, NB> (
+			src_ptr, src_ofs, ofs_ptr + 8, coef_ptr + 8 * len, len
+		));
+
+		const int      w = x_end - x;
+		if (w >= 16)
+		{
+			DST::write_flt (
+				dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset
+			);
+		}
+		else
+		{
+			DST::write_flt_partial (
+				dst_ptr, sum0, sum1, mask_lsb, sign_bit, offset, w
+			);
+		}
+
+		DST::Ptr::jump (dst_ptr, 16);
+	}
+}
+
+
+
+// Same constants as process_plane_int_avx2()
+template <class DST, int DB, class SRC, int SB, int NB>
+void	Scaler::process_row_h_int_avx2 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, int src_ofs, int x_beg, int x_end) const
+{
+	typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
+
+	const int      r_cst    = 1 << (SHIFT_INT + SB - DB - 1);
+	const int      s_in     = (SB < 16) ? -(0x8000 << (SHIFT_INT + SB - DB)) : 0;
+	const int      s_out    = (DB < 16) ?   0x8000 << (SHIFT_INT + SB - DB)  : 0;
+	const int      s_cst    = s_in + s_out;
+
+	const __m256i  zero     = _mm256_setzero_si256 ();
+	const __m256i  mask_lsb = _mm256_set1_epi16 (0x00FF);
+	const __m256i  sign_bit = _mm256_set1_epi16 (-0x8000);
+	const __m256i  ma       = _mm256_set1_epi16 (int16_t (uint16_t ((1 << DB) - 1)));
+	const __m256i  add_cst  = _mm256_set1_epi32 (_add_cst_int + s_cst + r_cst);
+
+	const int      len      = (NB > 0) ? NB * H_GRAN : _h_len;
+	assert (len == _h_len);
+
+	for (int x = x_beg; x < x_end; x += 16)
+	{
+		const int *    ofs_ptr  = &_h_start_arr [x];
+		const int16_t* coef_ptr = &_coef_h_int_arr [size_t (x) * size_t (len)];
+
+		__m256i        sum0 = _mm256_add_epi32 (add_cst, Scaler_process_vect_h_int_avx2 <SRC, SB, NB> (
+			src_ptr, src_ofs, ofs_ptr    , coef_ptr          , len, sign_bit
+		));
+		__m256i        sum1 = _mm256_add_epi32 (add_cst, Scaler_process_vect_h_int_avx2 <SRC, SB, NB> (
+			src_ptr, src_ofs, ofs_ptr + 8, coef_ptr + 8 * len, len, sign_bit
+		));
+		if (SB == 16)
+		{
+			const int32_t* sc_ptr = &_h_sign_cst_arr [x];
+			sum0 = _mm256_add_epi32 (sum0, _mm256_loadu_si256 (
+				reinterpret_cast <const __m256i *> (sc_ptr    )
+			));
+			sum1 = _mm256_add_epi32 (sum1, _mm256_loadu_si256 (
+				reinterpret_cast <const __m256i *> (sc_ptr + 8)
+			));
+		}
+		sum0 = _mm256_srai_epi32 (sum0, SHIFT_INT + SB - DB);
+		sum1 = _mm256_srai_epi32 (sum1, SHIFT_INT + SB - DB);
+
+		// packs works on each lane separately, puts the columns back in order.
+		__m256i        val = _mm256_packs_epi32 (sum0, sum1);
+		val = _mm256_permute4x64_epi64 (val, (0 << 0) + (2 << 2) + (1 << 4) + (3 << 6));
+
+		const int      w = x_end - x;
+		if (w >= 16)
+		{
+			DstS16W::write_clip (dst_ptr, val, mask_lsb, zero, ma, sign_bit);
+		}
+		else
+		{
+			DstS16W::write_clip_partial (
+				dst_ptr, val, mask_lsb, zero, ma, sign_bit, w
+			);
+		}
+
+		DST::Ptr::jump (dst_ptr, 16);
+	}
+}
+
+
+
 }	// namespace fmtcl
 
 
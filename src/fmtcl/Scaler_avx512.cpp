@@ -0,0 +1,318 @@
+/*****************************************************************************
+
+        Scaler_avx512.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX512 (AVX-512F and AVX-512BW) in order to avoid
+SSE/AVX state switch slowdown.
+
+Only the vertical kernels are implemented here. The horizontal ones keep
+their AVX2 version.
+
+The integer results are the same as the AVX2 code: the sums are packed in
+the same order, lane by lane.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ProxyRwAvx512.h"
+#include "fmtcl/Scaler.h"
+#include "fmtcl/ScalerCopy.h"
+#include "fstb/fnc.h"
+#include "fstb/ToolsAvx512.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+#define fmtcl_Scaler_INIT_F_AVX512(DT, ST, DE, SE, FN) \
+	_process_plane_flt_##FN##_ptr = &ThisType::process_plane_flt_avx512 <ProxyRwAvx512 <SplFmt_##DE>, ProxyRwAvx512 <SplFmt_##SE> >;
+
+#define fmtcl_Scaler_INIT_I_AVX512(DT, ST, DE, SE, DB, SB, FN) \
+	_process_plane_int_##FN##_ptr = &ThisType::process_plane_int_avx512 <ProxyRwAvx512 <SplFmt_##DE>, DB, ProxyRwAvx512 <SplFmt_##SE>, SB>;
+
+// Requires the AVX2 layout for the integer coefficients
+void  Scaler::setup_avx512 ()
+{
+	fmtcl_Scaler_SPAN_F (fmtcl_Scaler_INIT_F_AVX512)
+#if ! defined (fmtcl_Scaler_SSE2_16BITS)
+	fmtcl_Scaler_SPAN_I (fmtcl_Scaler_INIT_I_AVX512)
+#endif
+}
+
+#undef fmtcl_Scaler_INIT_F_AVX512
+#undef fmtcl_Scaler_INIT_I_AVX512
+
+
+
+template <class SRC>
+static fstb_FORCEINLINE void	Scaler_process_vect_flt_avx512 (__m512 &sum0, __m512 &sum1, int kernel_size, const float *coef_base_ptr, typename SRC::PtrConst::Type pix_ptr, ptrdiff_t src_stride, const __m512 &add_cst, __mmask16 m0, __mmask16 m1)
+{
+	sum0 = add_cst;
+	sum1 = add_cst;
+
+	for (int k = 0; k < kernel_size; ++k)
+	{
+		const __m512   coef = _mm512_set1_ps (coef_base_ptr [k]);
+		const __m512   src0 = SRC::read_flt (pix_ptr     , m0);
+		const __m512   src1 = SRC::read_flt (pix_ptr + 16, m1);
+		const __m512   val0 = _mm512_mul_ps (src0, coef);
+		const __m512   val1 = _mm512_mul_ps (src1, coef);
+		sum0 = _mm512_add_ps (sum0, val0);
+		sum1 = _mm512_add_ps (sum1, val1);
+
+		SRC::PtrConst::jump (pix_ptr, src_stride);
+	}
+}
+
+
+
+// DST and SRC are ProxyRwAvx512 classes
+// Stride offsets in pixels
+// Source pointer may be unaligned.
+// 32 pixels per iteration. The end of the line is processed with masked
+// loads and stores, so nothing is written beyond the width.
+template <class DST, class SRC>
+void	Scaler::process_plane_flt_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const
+{
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert ((dst_stride & 15) == 0);
+	assert ((src_stride & 3) == 0);
+	assert (width > 0);
+	assert (y_dst_beg >= 0);
+	assert (y_dst_beg < y_dst_end);
+	assert (y_dst_end <= _dst_height);
+	assert (width <= dst_stride);
+	assert (width <= src_stride);
+
+	const __m512   add_cst = _mm512_set1_ps (float (_add_cst_flt));
+
+	const int      w32    = width & -32;
+	const int      w31    = width - w32;
+	const __mmask16   m_full = ProxyRwAvx512Mask::make_16 (16);
+	const __mmask16   m_0    = ProxyRwAvx512Mask::make_16 (std::min (w31, 16));
+	const __mmask16   m_1    = ProxyRwAvx512Mask::make_16 (std::max (w31 - 16, 0));
+
+	for (int y = y_dst_beg; y < y_dst_end; ++y)
+	{
+		const KernelInfo& kernel_info   = _kernel_info_arr [y];
+		const int         kernel_size   = kernel_info._kernel_size;
+		const float *     coef_base_ptr = &_coef_flt_arr [kernel_info._coef_index];
+		const int         ofs_y         = kernel_info._start_line;
+
+		typename SRC::PtrConst::Type  col_src_ptr = src_ptr;
+		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
+		typename DST::Ptr::Type       col_dst_ptr = dst_ptr;
+
+		typedef ScalerCopy <DST, 0, SRC, 0> ScCopy;
+
+		if (ScCopy::can_copy (kernel_info._copy_flt_flag))
+		{
+			ScCopy::copy (col_dst_ptr, col_src_ptr, width);
+		}
+
+		else
+		{
+			__m512         sum0;
+			__m512         sum1;
+
+			for (int x = 0; x < w32; x += 32)
+			{
+				Scaler_process_vect_flt_avx512 <SRC> (
+					sum0, sum1, kernel_size, coef_base_ptr,
+					col_src_ptr, src_stride, add_cst, m_full, m_full
+				);
+				DST::write_flt (col_dst_ptr     , sum0, m_full);
+				DST::write_flt (col_dst_ptr + 16, sum1, m_full);
+
+				DST::Ptr::jump (col_dst_ptr, 32);
+				SRC::PtrConst::jump (col_src_ptr, 32);
+			}
+
+			if (w31 > 0)
+			{
+				Scaler_process_vect_flt_avx512 <SRC> (
+					sum0, sum1, kernel_size, coef_base_ptr,
+					col_src_ptr, src_stride, add_cst, m_0, m_1
+				);
+				DST::write_flt (col_dst_ptr     , sum0, m_0);
+				DST::write_flt (col_dst_ptr + 16, sum1, m_1);
+			}
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+template <class DST, int DB, class SRC, int SB>
+static fstb_FORCEINLINE __m512i	Scaler_process_vect_int_avx512 (const __m512i &add_cst, int kernel_size, const __m256i coef_base_ptr [], typename SRC::PtrConst::Type pix_ptr, ptrdiff_t src_stride, const __m512i &sign_bit, __mmask32 m)
+{
+	typedef typename SRC::template S16 <false, (SB == 16)> SrcS16R;
+
+	__m512i        sum0 = add_cst;
+	__m512i        sum1 = add_cst;
+
+	for (int k = 0; k < kernel_size; ++k)
+	{
+		// The AVX2 vectors contain the same coefficient in all their words.
+		const __m512i  coef = _mm512_broadcast_i64x4 (
+			_mm256_load_si256 (coef_base_ptr + k)
+		);
+		const __m512i  src  = SrcS16R::read (pix_ptr, sign_bit, m);
+
+		fstb::ToolsAvx512::mac_s16_s16_s32 (sum0, sum1, src, coef);
+
+		SRC::PtrConst::jump (pix_ptr, src_stride);
+	}
+
+	sum0 = _mm512_srai_epi32 (sum0, Scaler::SHIFT_INT + SB - DB);
+	sum1 = _mm512_srai_epi32 (sum1, Scaler::SHIFT_INT + SB - DB);
+
+	const __m512i  val = _mm512_packs_epi32 (sum0, sum1);
+
+	return (val);
+}
+
+
+
+// 32 pixels per iteration
+template <class DST, int DB, class SRC, int SB>
+void	Scaler::process_plane_int_avx512 (typename DST::Ptr::Type dst_ptr, typename SRC::PtrConst::Type src_ptr, ptrdiff_t dst_stride, ptrdiff_t src_stride, int width, int y_dst_beg, int y_dst_end) const
+{
+	assert (_can_int_flag);
+	assert (DST::Ptr::check_ptr (dst_ptr, DST::ALIGN_W));
+	assert (SRC::PtrConst::check_ptr (src_ptr, SRC::ALIGN_R));
+	assert ((dst_stride & 15) == 0);
+	assert (width > 0);
+	assert (y_dst_beg >= 0);
+	assert (y_dst_beg < y_dst_end);
+	assert (y_dst_end <= _dst_height);
+	assert (width <= dst_stride);
+	assert (width <= src_stride);
+
+	// Rounding constant for the final shift
+	const int      r_cst    = 1 << (SHIFT_INT + SB - DB - 1);
+
+	// Sign constants, see process_plane_int_avx2()
+	const int      s_in     = (SB < 16) ? -(0x8000 << (SHIFT_INT + SB - DB)) : 0;
+	const int      s_out    = (DB < 16) ?   0x8000 << (SHIFT_INT + SB - DB)  : 0;
+	const int      s_cst    = s_in + s_out;
+
+	const __m512i  zero     = _mm512_setzero_si512 ();
+	const __m512i  sign_bit = _mm512_set1_epi16 (-0x8000);
+	const __m512i  ma       = _mm512_set1_epi16 (int16_t (uint16_t ((1 << DB) - 1)));
+	const int      add_cst_base = _add_cst_int + s_cst + r_cst;
+
+	const int      w32    = width & -32;
+	const int      w31    = width - w32;
+	const __mmask32   m_full = ProxyRwAvx512Mask::make_32 (32);
+	const __mmask32   m_last = ProxyRwAvx512Mask::make_32 (w31);
+
+	for (int y = y_dst_beg; y < y_dst_end; ++y)
+	{
+		const KernelInfo&    kernel_info   = _kernel_info_arr [y];
+		const int            kernel_size   = kernel_info._kernel_size;
+		const int            ofs_y         = kernel_info._start_line;
+		const __m256i *      coef_base_ptr = reinterpret_cast <const __m256i *> (
+			_coef_int_arr.use_vect_avx2 (kernel_info._coef_index)
+		);
+		const __m512i        add_cst       = _mm512_set1_epi32 (
+			add_cst_base + ((SB == 16) ? kernel_info._sign_cst_int : 0)
+		);
+
+		typename SRC::PtrConst::Type  col_src_ptr = src_ptr;
+		SRC::PtrConst::jump (col_src_ptr, src_stride * ofs_y);
+		typename DST::Ptr::Type       col_dst_ptr = dst_ptr;
+
+		typedef ScalerCopy <DST, DB, SRC, SB> ScCopy;
+
+		if (ScCopy::can_copy (kernel_info._copy_int_flag))
+		{
+			ScCopy::copy (col_dst_ptr, col_src_ptr, width);
+		}
+
+		else
+		{
+			typedef typename DST::template S16 <false, (DB == 16)> DstS16W;
+
+			for (int x = 0; x < w32; x += 32)
+			{
+				const __m512i  val = Scaler_process_vect_int_avx512 <
+					DST, DB, SRC, SB
+				> (
+					add_cst, kernel_size, coef_base_ptr,
+					col_src_ptr, src_stride, sign_bit, m_full
+				);
+				DstS16W::write_clip (col_dst_ptr, val, zero, ma, sign_bit, m_full);
+
+				DST::Ptr::jump (col_dst_ptr, 32);
+				SRC::PtrConst::jump (col_src_ptr, 32);
+			}
+
+			if (w31 > 0)
+			{
+				const __m512i  val = Scaler_process_vect_int_avx512 <
+					DST, DB, SRC, SB
+				> (
+					add_cst, kernel_size, coef_base_ptr,
+					col_src_ptr, src_stride, sign_bit, m_last
+				);
+				DstS16W::write_clip (col_dst_ptr, val, zero, ma, sign_bit, m_last);
+			}
+		}
+
+		DST::Ptr::jump (dst_ptr, dst_stride);
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
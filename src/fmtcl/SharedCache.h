@@ -0,0 +1,137 @@
+/*****************************************************************************
+
+        SharedCache.h
+        Author: Laurent de Soras, 2024
+
+Generic storage for read-only data shared by several objects, for example
+precalculated tables. Data are identified by a key and built only once,
+on the first request.
+
+Depending on the keep_flag construction parameter, data are either kept
+until the cache destruction, or reference-counted and released with their
+last user. In the latter case, the cache only keeps weak references.
+
+All the public functions are thread-safe.
+
+Template parameters:
+
+- K: the key type. Requires a strict weak ordering with operator <.
+
+- T: the data type.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_SharedCache_HEADER_INCLUDED)
+#define fmtcl_SharedCache_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+
+namespace fmtcl
+{
+
+
+
+template <class K, class T>
+class SharedCache
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	typedef K KeyType;
+	typedef T DataType;
+	typedef std::shared_ptr <const T> DataSPtr;
+
+	// Returns the newly built data, never empty
+	typedef std::function <DataSPtr ()> BuildFnc;
+
+	explicit       SharedCache (bool keep_flag);
+	               ~SharedCache () = default;
+
+	DataSPtr       use_data (const K &key, const BuildFnc &build_fnc);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// The entry mutex is held during the data creation, so concurrent
+	// requests for the same data wait for a single calculation while
+	// the other entries remain accessible.
+	class Entry
+	{
+	public:
+		std::mutex     _mtx;
+		std::weak_ptr <const T>
+		               _data_wptr;
+		DataSPtr       _data_sptr;          // Only with _keep_flag
+	};
+	typedef std::shared_ptr <Entry> EntrySPtr;
+
+	typedef std::map <K, EntrySPtr> EntryMap;
+
+	void           collect_garbage ();
+
+	const bool     _keep_flag;
+	std::mutex     _map_mtx;               // Protects _entry_map
+	EntryMap       _entry_map;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               SharedCache ()                                 = delete;
+	               SharedCache (const SharedCache &other)         = delete;
+	               SharedCache (SharedCache &&other)              = delete;
+	SharedCache &  operator = (const SharedCache &other)          = delete;
+	SharedCache &  operator = (SharedCache &&other)               = delete;
+	bool           operator == (const SharedCache &other) const   = delete;
+	bool           operator != (const SharedCache &other) const   = delete;
+
+};	// class SharedCache
+
+
+
+}	// namespace fmtcl
+
+
+
+#include "fmtcl/SharedCache.hpp"
+
+
+
+#endif	// fmtcl_SharedCache_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,128 @@
+/*****************************************************************************
+
+        SharedCache.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_SharedCache_CODEHEADER_INCLUDED)
+#define fmtcl_SharedCache_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// keep_flag: data are kept until the cache destruction instead of being
+// released with their last user.
+template <class K, class T>
+SharedCache <K, T>::SharedCache (bool keep_flag)
+:	_keep_flag (keep_flag)
+,	_map_mtx ()
+,	_entry_map ()
+{
+	// Nothing
+}
+
+
+
+// build_fnc is called only if the data are not already in memory.
+// The returned data are never modified afterwards and can be shared.
+template <class K, class T>
+typename SharedCache <K, T>::DataSPtr	SharedCache <K, T>::use_data (const K &key, const BuildFnc &build_fnc)
+{
+	assert (build_fnc);
+
+	EntrySPtr      entry_sptr;
+	{
+		std::lock_guard <std::mutex>  autolock (_map_mtx);
+		if (! _keep_flag)
+		{
+			collect_garbage ();
+		}
+		auto &         e_sptr = _entry_map [key];
+		if (e_sptr.get () == nullptr)
+		{
+			e_sptr = std::make_shared <Entry> ();
+		}
+		entry_sptr = e_sptr;
+	}
+
+	std::lock_guard <std::mutex>  autolock (entry_sptr->_mtx);
+	DataSPtr       data_sptr = entry_sptr->_data_wptr.lock ();
+	if (data_sptr.get () == nullptr)
+	{
+		data_sptr = build_fnc ();
+		assert (data_sptr.get () != nullptr);
+		entry_sptr->_data_wptr = data_sptr;
+		if (_keep_flag)
+		{
+			entry_sptr->_data_sptr = data_sptr;
+		}
+	}
+
+	return data_sptr;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Removes the entries whose data have been released.
+// _map_mtx must be locked. An entry only referenced by the map cannot be
+// in use by another thread, so its weak pointer can be checked safely.
+template <class K, class T>
+void	SharedCache <K, T>::collect_garbage ()
+{
+	for (auto it = _entry_map.begin (); it != _entry_map.end (); )
+	{
+		if (it->second.use_count () == 1 && it->second->_data_wptr.expired ())
+		{
+			it = _entry_map.erase (it);
+		}
+		else
+		{
+			++ it;
+		}
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_SharedCache_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -41,6 +41,7 @@ enum SplFmt
 	SplFmt_FLOAT = 0,
 	SplFmt_INT16,
 	SplFmt_INT8,
+	SplFmt_FLOAT16,   // IEEE 754 half-precision, processed as float
 
 	SplFmt_NBR_ELT
 
@@ -40,7 +40,7 @@ bool	SplFmt_is_float (SplFmt fmt)
 	assert (fmt >= 0);
 	assert (fmt < SplFmt_NBR_ELT);
 
-	return (fmt == SplFmt_FLOAT);
+	return (fmt == SplFmt_FLOAT || fmt == SplFmt_FLOAT16);
 }
 
 
@@ -50,7 +50,7 @@ bool	SplFmt_is_int (SplFmt fmt)
 	assert (fmt >= 0);
 	assert (fmt < SplFmt_NBR_ELT);
 
-	return (fmt != SplFmt_FLOAT);
+	return (! SplFmt_is_float (fmt));
 }
 
 
@@ -65,7 +65,7 @@ int	SplFmt_get_data_size (SplFmt fmt)
 	assert (fmt >= 0);
 	assert (fmt < SplFmt_NBR_ELT);
 
-	static const int  size_arr [SplFmt_NBR_ELT] = { 4, 2, 1 };
+	static const int  size_arr [SplFmt_NBR_ELT] = { 4, 2, 1, 2 };
 	assert (size_arr [SplFmt_NBR_ELT - 1] > 0);
 
 	return (size_arr [fmt]);
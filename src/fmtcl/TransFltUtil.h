@@ -0,0 +1,133 @@
+/*****************************************************************************
+
+        TransFltUtil.h
+        Author: Laurent de Soras, 2024
+
+Vectorised helpers for the transfer operators evaluating their curve
+directly on single-precision data, without table.
+
+pow_pos(), log10() and exp10() are built on fstb::log2() and fstb::exp2().
+The exp2() input is clipped to the normal float exponent range, so
+results never wrap to garbage on underflow or overflow.
+
+Measured relative error of pow_pos() on ]0 ; 1], compared to the double
+precision pow():
+	Exponent     Max error
+	  0.0127      1.6 ulp
+	  0.159       2.5 ulp
+	  0.45        5.0 ulp
+	  2.4        28   ulp (3.3e-6)
+	  6.28       57   ulp (6.8e-6)
+	 78.8       192   ulp (2.3e-5)
+The error is roughly proportional to |p * log2 (x)|.
+
+log2_1p() and exp2_m1() are accurate within a few ulp around 0, where the
+plain log2() and exp2() would lose most of the significant bits.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_TransFltUtil_HEADER_INCLUDED)
+#define fmtcl_TransFltUtil_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "fstb/Vf32.h"
+
+
+
+namespace fmtcl
+{
+
+
+
+class TransFltUtil
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	// fnc: fstb::Vf32 (fstb::Vf32 x), called on groups of 4 samples.
+	// dst_ptr and src_ptr may be the same. No alignment requirement.
+	template <typename F>
+	static fstb_FORCEINLINE void
+	               process_block (float dst_ptr [], const float src_ptr [], int nbr_spl, F fnc) noexcept;
+
+	// x^p for x > 0, 0 for x <= 0
+	static fstb_FORCEINLINE fstb::Vf32
+	               pow_pos (fstb::Vf32 x, fstb::Vf32 p) noexcept;
+
+	// x must be > 0
+	static fstb_FORCEINLINE fstb::Vf32
+	               log10 (fstb::Vf32 x) noexcept;
+	static fstb_FORCEINLINE fstb::Vf32
+	               exp10 (fstb::Vf32 x) noexcept;
+
+	static fstb_FORCEINLINE fstb::Vf32
+	               exp2_clip (fstb::Vf32 x) noexcept;
+
+	// log2 (1 + x) and 2^x - 1, keeping the relative accuracy for small x.
+	// Required where the result is close to 1 and gets amplified by a
+	// large exponent or a subtraction.
+	static fstb_FORCEINLINE fstb::Vf32
+	               log2_1p (fstb::Vf32 x) noexcept;
+	static fstb_FORCEINLINE fstb::Vf32
+	               exp2_m1 (fstb::Vf32 x) noexcept;
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               TransFltUtil ()                               = delete;
+	               TransFltUtil (const TransFltUtil &other)      = delete;
+	               TransFltUtil (TransFltUtil &&other)           = delete;
+	TransFltUtil & operator = (const TransFltUtil &other)        = delete;
+	TransFltUtil & operator = (TransFltUtil &&other)             = delete;
+	bool           operator == (const TransFltUtil &other) const = delete;
+	bool           operator != (const TransFltUtil &other) const = delete;
+
+};	// class TransFltUtil
+
+
+
+}	// namespace fmtcl
+
+
+
+#include "fmtcl/TransFltUtil.hpp"
+
+
+
+#endif	// fmtcl_TransFltUtil_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
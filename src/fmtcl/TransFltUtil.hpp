@@ -0,0 +1,163 @@
+/*****************************************************************************
+
+        TransFltUtil.hpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if ! defined (fmtcl_TransFltUtil_CODEHEADER_INCLUDED)
+#define fmtcl_TransFltUtil_CODEHEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include <cassert>
+#include <cfloat>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+template <typename F>
+void	TransFltUtil::process_block (float dst_ptr [], const float src_ptr [], int nbr_spl, F fnc) noexcept
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (nbr_spl > 0);
+
+	const int      nbr_spl_m4 = nbr_spl & ~3;
+	for (int pos = 0; pos < nbr_spl_m4; pos += 4)
+	{
+		const auto     x = fstb::Vf32::loadu (src_ptr + pos);
+		fnc (x).storeu (dst_ptr + pos);
+	}
+
+	const int      rem = nbr_spl - nbr_spl_m4;
+	if (rem > 0)
+	{
+		const auto     x = fstb::Vf32::loadu_part (src_ptr + nbr_spl_m4, rem);
+		fnc (x).storeu_part (dst_ptr + nbr_spl_m4, rem);
+	}
+}
+
+
+
+fstb::Vf32	TransFltUtil::pow_pos (fstb::Vf32 x, fstb::Vf32 p) noexcept
+{
+	const auto     zero = fstb::Vf32::zero ();
+	const auto     xs   = max (x, fstb::Vf32 (FLT_MIN));
+	const auto     y    = exp2_clip (fstb::log2 (xs) * p);
+
+	return select (x > zero, y, zero);
+}
+
+
+
+fstb::Vf32	TransFltUtil::log10 (fstb::Vf32 x) noexcept
+{
+	return fstb::log2 (x) * fstb::Vf32 (float (fstb::LOG10_2));
+}
+
+
+
+fstb::Vf32	TransFltUtil::exp10 (fstb::Vf32 x) noexcept
+{
+	return exp2_clip (x * fstb::Vf32 (float (fstb::LOG2_10)));
+}
+
+
+
+// fstb::exp2() works directly on the float exponent bits, so its input
+// must stay in the range of the normal numbers.
+fstb::Vf32	TransFltUtil::exp2_clip (fstb::Vf32 x) noexcept
+{
+	x = min (max (x, fstb::Vf32 (-126.f)), fstb::Vf32 (127.f));
+
+	return fstb::exp2 (x);
+}
+
+
+
+// Uses the log1p trick (Goldberg, 1991): the rounding error of 1 + x is
+// compensated by the ratio between x and the actually represented value.
+fstb::Vf32	TransFltUtil::log2_1p (fstb::Vf32 x) noexcept
+{
+	const auto     one  = fstb::Vf32 (1.f);
+	const auto     w    = x + one;
+	const auto     d    = w - one;
+	const auto     l_w  = fstb::log2 (max (w, fstb::Vf32 (FLT_MIN)));
+	const auto     l_x  = x * fstb::Vf32 (float (fstb::LOG2_E));
+	const auto     zero = fstb::Vf32::zero ();
+	const auto     d_nz = select (d == zero, one, d);
+
+	return select (d == zero, l_x, l_w * (x / d_nz));
+}
+
+
+
+// Taylor series on [-0.5 ; 0.5], relative error < 1e-8 before rounding.
+// Regular exp2() outside, where the subtraction is harmless.
+fstb::Vf32	TransFltUtil::exp2_m1 (fstb::Vf32 x) noexcept
+{
+	// ln (2) ^ k / k!
+	const auto     c1 = fstb::Vf32 (6.9314718056e-01f);
+	const auto     c2 = fstb::Vf32 (2.4022650696e-01f);
+	const auto     c3 = fstb::Vf32 (5.5504108665e-02f);
+	const auto     c4 = fstb::Vf32 (9.6181291076e-03f);
+	const auto     c5 = fstb::Vf32 (1.3333558146e-03f);
+	const auto     c6 = fstb::Vf32 (1.5403530393e-04f);
+	const auto     c7 = fstb::Vf32 (1.5252733804e-05f);
+	const auto     c8 = fstb::Vf32 (1.3215486790e-06f);
+
+	auto           p = fma (c8, x, c7);
+	p = fma (p, x, c6);
+	p = fma (p, x, c5);
+	p = fma (p, x, c4);
+	p = fma (p, x, c3);
+	p = fma (p, x, c2);
+	p = fma (p, x, c1);
+	p *= x;
+
+	const auto     one   = fstb::Vf32 (1.f);
+	const auto     y_big = exp2_clip (x) - one;
+
+	return select (abs (x) <= fstb::Vf32 (0.5f), p, y_big);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+}	// namespace fmtcl
+
+
+
+#endif	// fmtcl_TransFltUtil_CODEHEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -29,9 +29,11 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fstb/def.h"
 
+#include "AvstpWrapper.h"
 #include "fmtcl/Cst.h"
 #include "fmtcl/fnc.h"
 #include "fmtcl/TransLut.h"
+#include "fmtcl/TransLutCache.h"
 #include "fmtcl/TransOpInterface.h"
 #include "fstb/fnc.h"
 
@@ -40,7 +42,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #endif
 
 #include <algorithm>
+#include <array>
 #include <memory>
+#include <vector>
 
 #include <cassert>
 #include <cmath>
@@ -60,6 +64,7 @@ public:
 	explicit       TransLut_PostScaleInt (const TransOpInterface &op, double mul, double add, int res) noexcept;
 protected:
 	double         do_convert (double x) const override;
+	void           do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const override;
 private:
 	const TransOpInterface &
 		            _op;
@@ -84,6 +89,94 @@ double	TransLut_PostScaleInt::do_convert (double x) const
 	return fstb::limit (_op (x) * _mul + _add, 0.0, _max_val);
 }
 
+void	TransLut_PostScaleInt::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	_op.convert_block (dst_ptr, src_ptr, nbr_spl);
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = fstb::limit (dst_ptr [pos] * _mul + _add, 0.0, _max_val);
+	}
+}
+
+
+
+// Splits the generation of a table into tasks for the thread pool.
+// F is a functor processing a range of table positions: (beg, end)
+template <class F>
+class TransLut_GenMt
+{
+public:
+	// Number of table entries per task
+	static constexpr int _task_len = 4096;
+
+	static void    run (int lut_size, const F &fill_fnc);
+private:
+	class Task
+	{
+	public:
+		const F *      _fnc_ptr = nullptr;
+		int            _beg     = 0;
+		int            _end     = 0;
+	};
+	static void    redirect_task (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr);
+};
+
+template <class F>
+void	TransLut_GenMt <F>::run (int lut_size, const F &fill_fnc)
+{
+	assert (lut_size > 0);
+
+	// Small tables are not worth the dispatch
+	if (lut_size <= _task_len)
+	{
+		fill_fnc (0, lut_size);
+		return;
+	}
+
+	// The owner of the table should hold a reference, so the pool is not
+	// started and joined for each table.
+	const AvstpWrapper::PoolRef   pool_ref;
+	AvstpWrapper & avstp = AvstpWrapper::use_instance ();
+
+	// Nothing to gain from a single worker
+	if (avstp.get_nbr_threads () <= 1)
+	{
+		fill_fnc (0, lut_size);
+		return;
+	}
+
+	const int      nbr_tasks = (lut_size + _task_len - 1) / _task_len;
+	std::vector <Task> task_arr (nbr_tasks);
+
+	avstp_TaskDispatcher *	task_dispatcher_ptr = avstp.create_dispatcher ();
+	for (int task_idx = 0; task_idx < nbr_tasks; ++task_idx)
+	{
+		Task &         task = task_arr [task_idx];
+		task._fnc_ptr = &fill_fnc;
+		task._beg     = task_idx * _task_len;
+		task._end     = std::min (task._beg + _task_len, lut_size);
+		avstp.enqueue_task (task_dispatcher_ptr, &redirect_task, &task);
+	}
+	avstp.wait_completion (task_dispatcher_ptr);
+	avstp.destroy_dispatcher (task_dispatcher_ptr);
+}
+
+template <class F>
+void	TransLut_GenMt <F>::redirect_task (avstp_TaskDispatcher *dispatcher_ptr, void *data_ptr)
+{
+	fstb::unused (dispatcher_ptr);
+
+#if (fstb_ARCHI == fstb_ARCHI_X86)
+ #if ! defined (_WIN64) && ! defined (__64BIT__) && ! defined (__amd64__) && ! defined (__x86_64__)
+	// We don't know the state of the FP/MMX registers in the pool threads
+	_mm_empty ();
+ #endif
+#endif
+
+	const Task &   task = *reinterpret_cast <const Task *> (data_ptr);
+	(*task._fnc_ptr) (task._beg, task._end);
+}
+
 
 
 
@@ -129,7 +222,13 @@ void	TransLut_FindIndexSse2 <TransLut::MapperLin>::find_index (const TransLut::F
 	__m128         val_scl   = _mm_mul_ps (v, scale);
 	val_scl = _mm_min_ps (val_scl, val_max);
 	val_scl = _mm_max_ps (val_scl, val_min);
-	const __m128i  index_raw = _mm_cvtps_epi32 (val_scl);
+	// floor(), as in the C++ code. The conversion truncates towards 0, so the
+	// negative non-integer values are adjusted (the mask is -1 for them).
+	const __m128i  index_trc = _mm_cvttps_epi32 (val_scl);
+	const __m128i  index_raw = _mm_add_epi32 (
+		index_trc,
+		_mm_castps_si128 (_mm_cmpgt_ps (_mm_cvtepi32_ps (index_trc), val_scl))
+	);
 	index     = _mm_add_epi32 (index_raw, offset_ps);
 	frac      = _mm_sub_ps (val_scl, _mm_cvtepi32_ps (index_raw));
 }
@@ -284,15 +383,18 @@ constexpr int	TransLut::LOGLUT_MAX_L2;
 constexpr int	TransLut::LOGLUT_RES_L2;
 constexpr int	TransLut::LOGLUT_HSIZE;
 constexpr int	TransLut::LOGLUT_SIZE;
+constexpr int	TransLut::LUTINT_PAD;
 
 
 
-TransLut::TransLut (const TransOpInterface &curve, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool sse2_flag, bool avx2_flag)
+TransLut::TransLut (const TransOpInterface &curve, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag)
 :	_loglut_flag (log_flag)
 ,	_fmt_s ({ src_fmt, src_bits, ColorFamily_RGB, src_full_flag })
 ,	_fmt_d ({ dst_fmt, dst_bits, ColorFamily_RGB, dst_full_flag })
 ,	_sse2_flag (sse2_flag)
 ,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_fp16_conv (sse2_flag, avx2_flag)
 {
 	assert (src_fmt >= 0);
 	assert (src_fmt < SplFmt_NBR_ELT);
@@ -301,11 +403,86 @@ TransLut::TransLut (const TransOpInterface &curve, bool log_flag, SplFmt src_fmt
 	assert (dst_fmt < SplFmt_NBR_ELT);
 	assert (dst_bits >= 8);
 
-	generate_lut (curve);
+	// Float to half-float is processed as float to float, the result is
+	// converted afterwards.
+	if (_fmt_s._sf == SplFmt_FLOAT && _fmt_d._sf == SplFmt_FLOAT16)
+	{
+		_dst_fp16_flag = true;
+		_fmt_d._sf     = SplFmt_FLOAT;
+		_fmt_d._res    = 32;
+	}
+
+	// Log LUTs are only for float input
+	if (_fmt_s._sf != SplFmt_FLOAT)
+	{
+		_loglut_flag = false;
+	}
+
+	init_lut (curve);
 	init_proc_fnc ();
 
+	if (_dst_fp16_flag)
+	{
+		_process_plane_flt_ptr = _process_plane_ptr;
+		_process_plane_ptr     = &ThisType::process_plane_to_fp16;
+	}
+
 	// Mutes unused member variable warning for non-x86 architectures
-	fstb::unused (_sse2_flag, _avx2_flag);
+	fstb::unused (_sse2_flag, _avx2_flag, _avx512_flag);
+}
+
+
+
+TransLut::TransLut (std::shared_ptr <const TransOpInterface> curve_sptr, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool direct_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag)
+:	_loglut_flag (log_flag)
+,	_fmt_s ({ src_fmt, src_bits, ColorFamily_RGB, src_full_flag })
+,	_fmt_d ({ dst_fmt, dst_bits, ColorFamily_RGB, dst_full_flag })
+,	_sse2_flag (sse2_flag)
+,	_avx2_flag (avx2_flag)
+,	_avx512_flag (avx2_flag && avx512_flag)
+,	_fp16_conv (sse2_flag, avx2_flag)
+{
+	assert (curve_sptr.get () != nullptr);
+	assert (src_fmt >= 0);
+	assert (src_fmt < SplFmt_NBR_ELT);
+	assert (src_bits >= 8);
+	assert (dst_fmt >= 0);
+	assert (dst_fmt < SplFmt_NBR_ELT);
+	assert (dst_bits >= 8);
+
+	if (_fmt_s._sf == SplFmt_FLOAT && _fmt_d._sf == SplFmt_FLOAT16)
+	{
+		_dst_fp16_flag = true;
+		_fmt_d._sf     = SplFmt_FLOAT;
+		_fmt_d._res    = 32;
+	}
+
+	if (   direct_flag
+	    && _fmt_s._sf == SplFmt_FLOAT
+	    && _fmt_d._sf == SplFmt_FLOAT
+	    && curve_sptr->has_direct_flt ())
+	{
+		_loglut_flag       = false;
+		_curve_sptr        = curve_sptr;
+		_process_plane_ptr = &ThisType::process_plane_direct;
+	}
+	else
+	{
+		if (_fmt_s._sf != SplFmt_FLOAT)
+		{
+			_loglut_flag = false;
+		}
+		init_lut (*curve_sptr);
+		init_proc_fnc ();
+	}
+
+	if (_dst_fp16_flag)
+	{
+		_process_plane_flt_ptr = _process_plane_ptr;
+		_process_plane_ptr     = &ThisType::process_plane_to_fp16;
+	}
+
+	fstb::unused (_sse2_flag, _avx2_flag, _avx512_flag);
 }
 
 
@@ -323,6 +500,14 @@ void	TransLut::process_plane (const Plane <> &dst, const PlaneRO <> &src, int w,
 
 
 
+// Indicates that the curve is evaluated without table
+bool	TransLut::is_direct () const noexcept
+{
+	return (_curve_sptr.get () != nullptr);
+}
+
+
+
 TransLut::MapperLin::MapperLin (int lut_size, double range_beg, double range_lst) noexcept
 :	_lut_size (lut_size)
 ,	_range_beg (range_beg)
@@ -507,7 +692,36 @@ float	TransLut::Convert <float>::cast (float val) noexcept
 
 
 
-void	TransLut::generate_lut (const TransOpInterface &curve)
+// Tables are shared across instances when the curve can be identified
+void	TransLut::init_lut (const TransOpInterface &curve)
+{
+	TransLutCache::Key   key;
+	key._curve_desc = curve.get_desc ();
+	if (key._curve_desc.empty ())
+	{
+		auto           lut_sptr = std::make_shared <ArrayMultiType> ();
+		generate_lut (*lut_sptr, curve);
+		_lut_sptr = lut_sptr;
+	}
+	else
+	{
+		key._src_sf        = _fmt_s._sf;
+		key._src_res       = _fmt_s._res;
+		key._src_full_flag = _fmt_s._full_flag;
+		key._dst_sf        = _fmt_d._sf;
+		key._dst_res       = _fmt_d._res;
+		key._dst_full_flag = _fmt_d._full_flag;
+		key._loglut_flag   = _loglut_flag;
+		_lut_sptr = TransLutCache::use_instance ().use_lut (
+			key,
+			[this, &curve] (ArrayMultiType &lut) { generate_lut (lut, curve); }
+		);
+	}
+}
+
+
+
+void	TransLut::generate_lut (ArrayMultiType &lut, const TransOpInterface &curve) const
 {
 	if (_fmt_s._sf == SplFmt_FLOAT)
 	{
@@ -515,7 +729,7 @@ void	TransLut::generate_lut (const TransOpInterface &curve)
 		// so we can interpolate it easily and obtain the exact values.
 		// If the target data type is int, we quantize the interpolated
 		// values as a second step.
-		_lut.set_type <float> ();
+		lut.set_type <float> ();
 
 		// When the target data type is integer, scales the result
 		const double   mul = compute_pix_scale (_fmt_d, 0);
@@ -526,30 +740,44 @@ void	TransLut::generate_lut (const TransOpInterface &curve)
 
 		if (_loglut_flag)
 		{
-			_lut.resize (LOGLUT_SIZE);
+			lut.resize (LOGLUT_SIZE);
 			MapperLog   mapper;
-			generate_lut_flt <float> (*curve_final_ptr, mapper);
+			generate_lut_flt <float> (lut, *curve_final_ptr, mapper);
 		}
 		else
 		{
-			_lut.resize (LINLUT_SIZE_F);
+			lut.resize (LINLUT_SIZE_F);
 			MapperLin   mapper (LINLUT_SIZE_F, LINLUT_MIN_F, LINLUT_MAX_F);
-			generate_lut_flt <float> (*curve_final_ptr, mapper);
+			generate_lut_flt <float> (lut, *curve_final_ptr, mapper);
 		}
 	}
 
+	// Half-float input: the table is indexed by the raw data
+	else if (_fmt_s._sf == SplFmt_FLOAT16)
+	{
+		assert (! _loglut_flag);
+
+		lut.resize ((1 << 16) + LUTINT_PAD);
+		generate_lut_dst (lut, curve, 1 << 16, [] (int pos)
+		{
+			// NaN are mapped to 0 and infinities to the largest finite values
+			const double   x = Fp16Conv::conv_spl_to_flt (uint16_t (pos));
+			return (std::isnan (x)) ? 0.0 : fstb::limit (x, -65504.0, 65504.0);
+		});
+	}
+
 	else
 	{
-		_loglut_flag = false;
+		assert (! _loglut_flag);
 
 		int            range = 1 << _fmt_s._res;
 		if (_fmt_s._sf == SplFmt_INT8)
 		{
-			_lut.resize (1 << 8);
+			lut.resize ((1 << 8) + LUTINT_PAD);
 		}
 		else
 		{
-			_lut.resize (1 << 16);
+			lut.resize ((1 << 16) + LUTINT_PAD);
 		}
 		constexpr auto b16f  = Cst::_rtv_lum_blk << 8;
 		constexpr auto w16f  = Cst::_rtv_lum_wht << 8;
@@ -560,67 +788,121 @@ void	TransLut::generate_lut (const TransOpInterface &curve)
 		const int      sdif  = swn - sbn;
 		const double   r_beg = double (0         - sbn) / sdif;
 		const double   r_lst = double (range - 1 - sbn) / sdif;
-		if (_fmt_d._sf == SplFmt_FLOAT)
+		const double   scale = (r_lst - r_beg) / (range - 1);
+		generate_lut_dst (
+			lut, curve, range,
+			[r_beg, scale] (int pos) { return r_beg + pos * scale; }
+		);
+	}
+}
+
+
+
+// Integer or half-float input, any output.
+// X: functor returning the curve input for a table position.
+template <class X>
+void	TransLut::generate_lut_dst (ArrayMultiType &lut, const TransOpInterface &curve, int lut_size, const X &x_fnc) const
+{
+	assert (lut_size > 1);
+
+	if (_fmt_d._sf == SplFmt_FLOAT)
+	{
+		lut.set_type <float> ();
+		fill_lut (
+			curve, lut_size, x_fnc,
+			[&lut] (int pos, double y) { lut.use <float> (pos) = float (y); }
+		);
+	}
+	else if (_fmt_d._sf == SplFmt_FLOAT16)
+	{
+		lut.set_type <uint16_t> ();
+		fill_lut (
+			curve, lut_size, x_fnc,
+			[&lut] (int pos, double y)
+			{
+				lut.use <uint16_t> (pos) = Fp16Conv::conv_spl_to_fp16 (float (y));
+			}
+		);
+	}
+	else
+	{
+		const double   mul = compute_pix_scale (_fmt_d, 0);
+		const double   add = get_pix_min (_fmt_d, 0);
+		if (_fmt_d._res > 8)
 		{
-			_lut.set_type <float> ();
-			MapperLin      mapper (range, r_beg, r_lst);
-			generate_lut_flt <float> (curve, mapper);
+			lut.set_type <uint16_t> ();
+			generate_lut_int <uint16_t> (lut, curve, lut_size, x_fnc, mul, add);
 		}
 		else
 		{
-			const double   mul  = compute_pix_scale (_fmt_d, 0);
-			const double   add  = get_pix_min (_fmt_d, 0);
-			if (_fmt_d._res > 8)
-			{
-				_lut.set_type <uint16_t> ();
-				generate_lut_int <uint16_t> (
-					curve, range, r_beg, r_lst, mul, add
-				);
-			}
-			else
-			{
-				_lut.set_type <uint8_t> ();
-				generate_lut_int <uint8_t> (
-					curve, range, r_beg, r_lst, mul, add
-				);
-			}
+			lut.set_type <uint8_t> ();
+			generate_lut_int <uint8_t> (lut, curve, lut_size, x_fnc, mul, add);
 		}
 	}
 }
 
 
 
-// T = LUT data type (int or float)
-template <class T>
-void	TransLut::generate_lut_int (const TransOpInterface &curve, int lut_size, double range_beg, double range_lst, double mul, double add)
+// T = LUT data type (int)
+template <class T, class X>
+void	TransLut::generate_lut_int (ArrayMultiType &lut, const TransOpInterface &curve, int lut_size, const X &x_fnc, double mul, double add) const
 {
-	assert (_fmt_d._sf != SplFmt_FLOAT);
+	assert (SplFmt_is_int (_fmt_d._sf));
 	assert (lut_size > 1);
-	assert (range_beg < range_lst);
 
-	const double   scale   = (range_lst - range_beg) / (lut_size - 1);
 	const int      max_val = (1 << _fmt_d._res) - 1;
-	for (int pos = 0; pos < lut_size; ++pos)
-	{
-		const double   x = range_beg + pos * scale;
-		const double   y = curve (x) * mul + add;
-		_lut.use <T> (pos) = T (fstb::limit (fstb::round_int (y), 0, max_val));
-	}
+	fill_lut (
+		curve, lut_size, x_fnc,
+		[&lut, mul, add, max_val] (int pos, double y)
+		{
+			y = y * mul + add;
+			lut.use <T> (pos) = T (fstb::limit (fstb::round_int (y), 0, max_val));
+		}
+	);
 }
 
 
 
 // T = float
 template <class T, class M>
-void	TransLut::generate_lut_flt (const TransOpInterface &curve, const M &mapper)
+void	TransLut::generate_lut_flt (ArrayMultiType &lut, const TransOpInterface &curve, const M &mapper)
 {
-	const int      lut_size = mapper.get_lut_size ();
-	for (int pos = 0; pos < lut_size; ++pos)
+	fill_lut (
+		curve, mapper.get_lut_size (),
+		[&mapper] (int pos) { return mapper.find_val (pos); },
+		[&lut] (int pos, double y) { lut.use <T> (pos) = T (y); }
+	);
+}
+
+
+
+// Evaluates the curve for all the table positions, by blocks and in
+// parallel.
+// X: functor returning the curve input for a table position.
+// S: functor storing the curve output at a table position.
+template <class X, class S>
+void	TransLut::fill_lut (const TransOpInterface &curve, int lut_size, const X &x_fnc, const S &store_fnc)
+{
+	const auto     fill_range = [&curve, &x_fnc, &store_fnc] (int pos_beg, int pos_end)
 	{
-		const double   x = mapper.find_val (pos);
-		const double   y = curve (x);
-		_lut.use <T> (pos) = T (y);
-	}
+		constexpr int  blk_len_max = 256;
+		std::array <double, blk_len_max> buf;
+		for (int blk_beg = pos_beg; blk_beg < pos_end; blk_beg += blk_len_max)
+		{
+			const int      blk_len = std::min (pos_end - blk_beg, blk_len_max);
+			for (int k = 0; k < blk_len; ++k)
+			{
+				buf [k] = x_fnc (blk_beg + k);
+			}
+			curve.convert_block (buf.data (), buf.data (), blk_len);
+			for (int k = 0; k < blk_len; ++k)
+			{
+				store_fnc (blk_beg + k, buf [k]);
+			}
+		}
+	};
+
+	TransLut_GenMt <decltype (fill_range)>::run (lut_size, fill_range);
 }
 
 
@@ -663,6 +945,7 @@ void	TransLut::init_proc_fnc ()
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	init_proc_fnc_sse2 (selector);
 	init_proc_fnc_avx2 (selector);
+	init_proc_fnc_avx512 (selector);
 #endif
 }
 
@@ -694,6 +977,66 @@ void	TransLut::init_proc_fnc_sse2 (int selector)
 
 
 
+// Float to float only. The curve handles the vectorisation itself.
+void	TransLut::process_plane_direct (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (h));
+	assert (src.is_valid (h));
+	assert (w > 0);
+	assert (h > 0);
+	assert (_curve_sptr.get () != nullptr);
+
+	for (int y = 0; y < h; ++y)
+	{
+		const PlaneRO <float>   s { src };
+		const Plane <float>     d { dst };
+		_curve_sptr->convert_block_flt (d._ptr, s._ptr, w);
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
+// Float input, half-float output. The float results are computed by chunks
+// in a temporary buffer, then converted.
+void	TransLut::process_plane_to_fp16 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (h));
+	assert (src.is_valid (h));
+	assert (w > 0);
+	assert (h > 0);
+	assert (_process_plane_flt_ptr != nullptr);
+
+	// Multiple of the SIMD vector length, the processing functions may write
+	// a few extra samples past the end of the requested width.
+	constexpr int  chunk_len = 1024;
+	alignas (64) std::array <float, chunk_len> buf;
+
+	for (int y = 0; y < h; ++y)
+	{
+		const PlaneRO <float>   s { src };
+		const Plane <uint16_t>  d { dst };
+
+		for (int x = 0; x < w; x += chunk_len)
+		{
+			const int      len = std::min (w - x, chunk_len);
+			(this->*_process_plane_flt_ptr) (
+				Plane <float> (buf.data (), 0),
+				PlaneRO <float> (s._ptr + x, 0),
+				len, 1
+			);
+			_fp16_conv.conv_to_fp16 (d._ptr + x, buf.data (), len);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+}
+
+
+
 template <class TS, class TD>
 void	TransLut::process_plane_int_any_cpp (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept
 {
@@ -702,6 +1045,8 @@ void	TransLut::process_plane_int_any_cpp (Plane <> dst, PlaneRO <> src, int w, i
 	assert (w > 0);
 	assert (h > 0);
 
+	const ArrayMultiType &  lut = *_lut_sptr;
+
 	for (int y = 0; y < h; ++y)
 	{
 		const PlaneRO <TS>   s { src };
@@ -710,7 +1055,7 @@ void	TransLut::process_plane_int_any_cpp (Plane <> dst, PlaneRO <> src, int w, i
 		for (int x = 0; x < w; ++x)
 		{
 			const int          index = s._ptr [x];
-			d._ptr [x] = _lut.use <TD> (index);
+			d._ptr [x] = lut.use <TD> (index);
 		}
 
 		src.step_line ();
@@ -728,6 +1073,8 @@ void	TransLut::process_plane_flt_any_cpp (Plane <> dst, PlaneRO <> src, int w, i
 	assert (w > 0);
 	assert (h > 0);
 
+	const ArrayMultiType &  lut = *_lut_sptr;
+
 	for (int y = 0; y < h; ++y)
 	{
 		const PlaneRO <FloatIntMix>   s { src };
@@ -738,8 +1085,8 @@ void	TransLut::process_plane_flt_any_cpp (Plane <> dst, PlaneRO <> src, int w, i
 			int                index;
 			float              lerp;
 			M::find_index (s._ptr [x], index, lerp);
-			const float        p_0  = _lut.use <float> (index    );
-			const float        p_1  = _lut.use <float> (index + 1);
+			const float        p_0  = lut.use <float> (index    );
+			const float        p_1  = lut.use <float> (index + 1);
 			const float        dif  = p_1 - p_0;
 			const float        val  = p_0 + lerp * dif;
 			d._ptr [x] = Convert <TD>::cast (val);
@@ -764,6 +1111,8 @@ void	TransLut::process_plane_flt_any_sse2 (Plane <> dst, PlaneRO <> src, int w,
 	assert (w > 0);
 	assert (h > 0);
 
+	const ArrayMultiType &  lut = *_lut_sptr;
+
 	for (int y = 0; y < h; ++y)
 	{
 		const PlaneRO <FloatIntMix>   s { src };
@@ -779,16 +1128,16 @@ void	TransLut::process_plane_flt_any_sse2 (Plane <> dst, PlaneRO <> src, int w,
 			__m128             lerp;
 			TransLut_FindIndexSse2 <M>::find_index (s._ptr + x, index._vect, lerp);
 			__m128             val = _mm_set_ps (
-				_lut.use <float> (index._scal [3]    ),
-				_lut.use <float> (index._scal [2]    ),
-				_lut.use <float> (index._scal [1]    ),
-				_lut.use <float> (index._scal [0]    )
+				lut.use <float> (index._scal [3]    ),
+				lut.use <float> (index._scal [2]    ),
+				lut.use <float> (index._scal [1]    ),
+				lut.use <float> (index._scal [0]    )
 			);
 			__m128             va2 = _mm_set_ps (
-				_lut.use <float> (index._scal [3] + 1),
-				_lut.use <float> (index._scal [2] + 1),
-				_lut.use <float> (index._scal [1] + 1),
-				_lut.use <float> (index._scal [0] + 1)
+				lut.use <float> (index._scal [3] + 1),
+				lut.use <float> (index._scal [2] + 1),
+				lut.use <float> (index._scal [1] + 1),
+				lut.use <float> (index._scal [0] + 1)
 			);
 			const __m128       dif = _mm_sub_ps (va2, val);
 			val = _mm_add_ps (val, _mm_mul_ps (dif, lerp));
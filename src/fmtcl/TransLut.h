@@ -30,11 +30,14 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fstb/def.h"
 
 #include "fmtcl/ArrayMultiType.h"
+#include "fmtcl/Fp16Conv.h"
 #include "fmtcl/PicFmt.h"
 #include "fmtcl/Plane.h"
 #include "fmtcl/PlaneRO.h"
 #include "fmtcl/SplFmt.h"
 
+#include <memory>
+
 #include <cstdint>
 
 
@@ -69,6 +72,10 @@ public:
 	static constexpr int LOGLUT_HSIZE   = ((LOGLUT_MAX_L2 - LOGLUT_MIN_L2) << LOGLUT_RES_L2) + 1; // Table made of half-open segments (and whitout x=0) + 1 more value for LOGLUT_MAX, closing the last segment.
 	static constexpr int LOGLUT_SIZE    = 2 * LOGLUT_HSIZE + 1;   // Negative + 0 + positive
 
+	// Extra elements at the end of the LUTs for integer input, so 32-bit
+	// gathers on 8- or 16-bit tables never read past the allocated memory.
+	static constexpr int LUTINT_PAD     = 4;
+
 	union FloatIntMix
 	{
 		float          _f;
@@ -98,10 +105,16 @@ public:
 		               find_index (const FloatIntMix &val, int &index, float &frac) noexcept;
 	};
 
-	explicit       TransLut (const TransOpInterface &curve, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool sse2_flag, bool avx2_flag);
+	explicit       TransLut (const TransOpInterface &curve, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag);
+	// Same as above. With direct_flag, float-to-float conversions are
+	// evaluated directly without table when the curve supports it
+	// (has_direct_flt()). The curve is then kept for the lifetime of the
+	// TransLut object.
+	explicit       TransLut (std::shared_ptr <const TransOpInterface> curve_sptr, bool log_flag, SplFmt src_fmt, int src_bits, bool src_full_flag, SplFmt dst_fmt, int dst_bits, bool dst_full_flag, bool direct_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag);
 	virtual			~TransLut () {}
 
 	void           process_plane (const Plane <> &dst, const PlaneRO <> &src, int w, int h) const noexcept;
+	bool           is_direct () const noexcept;
 
 	static bool    is_loglut_req (const TransOpInterface &curve);
 
@@ -125,18 +138,26 @@ private:
 		               cast (float val) noexcept;
 	};
 
-	void           generate_lut (const TransOpInterface &curve);
-	template <class T>
-	void           generate_lut_int (const TransOpInterface &curve, int lut_size, double range_beg, double range_lst, double mul, double add);
+	void           init_lut (const TransOpInterface &curve);
+	void           generate_lut (ArrayMultiType &lut, const TransOpInterface &curve) const;
+	template <class X>
+	void           generate_lut_dst (ArrayMultiType &lut, const TransOpInterface &curve, int lut_size, const X &x_fnc) const;
+	template <class T, class X>
+	void           generate_lut_int (ArrayMultiType &lut, const TransOpInterface &curve, int lut_size, const X &x_fnc, double mul, double add) const;
 	template <class T, class M>
-	void           generate_lut_flt (const TransOpInterface &curve, const M &mapper);
+	static void    generate_lut_flt (ArrayMultiType &lut, const TransOpInterface &curve, const M &mapper);
+	template <class X, class S>
+	static void    fill_lut (const TransOpInterface &curve, int lut_size, const X &x_fnc, const S &store_fnc);
 
 	void           init_proc_fnc ();
 #if (fstb_ARCHI == fstb_ARCHI_X86)
 	void           init_proc_fnc_sse2 (int selector);
 	void           init_proc_fnc_avx2 (int selector);
+	void           init_proc_fnc_avx512 (int selector);
 #endif
 
+	void           process_plane_direct (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
+	void           process_plane_to_fp16 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
 	template <class TS, class TD>
 	void           process_plane_int_any_cpp (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
 	template <class TD, class M>
@@ -146,6 +167,10 @@ private:
 	void           process_plane_flt_any_sse2 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
 	template <class TD, class M>
 	void           process_plane_flt_any_avx2 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
+	template <class TS, class TD>
+	void           process_plane_int_any_avx2 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
+	template <class TD, class M>
+	void           process_plane_flt_any_avx512 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept;
 #endif
 
 	bool           _loglut_flag   = false;
@@ -155,14 +180,33 @@ private:
 
 	bool           _sse2_flag     = false;
 	bool           _avx2_flag     = false;
+	bool           _avx512_flag   = false; // AVX-512F and BW
+
+	// Float to half-float conversion: _fmt_d is set to float and the
+	// processing function writes to a temporary buffer.
+	bool           _dst_fp16_flag = false;
+	Fp16Conv       _fp16_conv;
 
 	void (ThisType:: *
 	               _process_plane_ptr) (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept = nullptr;
 
+	// Float-to-float processing function, when _dst_fp16_flag is set
+	void (ThisType:: *
+	               _process_plane_flt_ptr) (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept = nullptr;
+
 	// Opaque array, contains uint8_t, uint16_t or float depending on the
-	// output datatype. Table size is always 256, 65536 or 65536*3+1
-	// (float input, covering -1 to +2 range inclusive).
-	ArrayMultiType _lut;
+	// output datatype (uint16_t for half-float). Table size is always 256,
+	// 65536 (+ LUTINT_PAD) or 65536*3+1 (float input, covering -1 to +2
+	// range inclusive). Half-float input uses the 65536-entry table, indexed
+	// by the raw data.
+	// Possibly shared with other TransLut objects, see TransLutCache.
+	std::shared_ptr <const ArrayMultiType>
+	               _lut_sptr;
+
+	// Curve evaluated on the fly. Only set in direct mode, _lut_sptr is
+	// empty in this case.
+	std::shared_ptr <const TransOpInterface>
+	               _curve_sptr;
 
 
 
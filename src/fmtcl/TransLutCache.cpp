@@ -0,0 +1,118 @@
+/*****************************************************************************
+
+        TransLutCache.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/TransLutCache.h"
+
+#include <tuple>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+bool	TransLutCache::Key::operator < (const Key &other) const
+{
+	return std::tie (
+		_src_sf,
+		_src_res,
+		_src_full_flag,
+		_dst_sf,
+		_dst_res,
+		_dst_full_flag,
+		_loglut_flag,
+		_curve_desc
+	) < std::tie (
+		other._src_sf,
+		other._src_res,
+		other._src_full_flag,
+		other._dst_sf,
+		other._dst_res,
+		other._dst_full_flag,
+		other._loglut_flag,
+		other._curve_desc
+	);
+}
+
+
+
+TransLutCache &	TransLutCache::use_instance ()
+{
+	static TransLutCache instance;
+
+	return instance;
+}
+
+
+
+// build_fnc is called only if the table is not already in memory.
+// The returned table is never modified afterwards and can be shared.
+TransLutCache::LutSPtr	TransLutCache::use_lut (const Key &key, const BuildFnc &build_fnc)
+{
+	assert (! key._curve_desc.empty ());
+	assert (build_fnc);
+
+	return _cache.use_data (
+		key,
+		[&build_fnc] ()
+		{
+			auto           lut_sptr = std::make_shared <ArrayMultiType> ();
+			build_fnc (*lut_sptr);
+			return LutSPtr (lut_sptr);
+		}
+	);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+TransLutCache::TransLutCache ()
+:	_cache (false)
+{
+	// Nothing
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
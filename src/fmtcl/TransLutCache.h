@@ -0,0 +1,134 @@
+/*****************************************************************************
+
+        TransLutCache.h
+        Author: Laurent de Soras, 2024
+
+Process-wide storage for the TransLut tables. TransLut objects built with
+the same transfer function and the same source and destination formats
+share a single table, whatever the filter instance they belong to.
+
+The transfer function is identified by its canonical description, as
+returned by TransOpInterface::get_desc(). Functions without description
+cannot be cached.
+
+Tables are reference-counted: they are released with the last TransLut
+using them. Storage is handled by SharedCache.
+
+This is a singleton, use use_instance() to access it. All the public
+functions are thread-safe.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_TransLutCache_HEADER_INCLUDED)
+#define fmtcl_TransLutCache_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ArrayMultiType.h"
+#include "fmtcl/SharedCache.h"
+#include "fmtcl/SplFmt.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+
+
+namespace fmtcl
+{
+
+
+
+class TransLutCache
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	typedef std::shared_ptr <const ArrayMultiType> LutSPtr;
+
+	// Fills an empty ArrayMultiType object
+	typedef std::function <void (ArrayMultiType &lut)> BuildFnc;
+
+	// All the TransLut parameters involved in the table calculation
+	class Key
+	{
+	public:
+		bool           operator < (const Key &other) const;
+
+		std::string    _curve_desc;
+		SplFmt         _src_sf        = SplFmt_ILLEGAL;
+		int            _src_res       = 0;
+		bool           _src_full_flag = false;
+		SplFmt         _dst_sf        = SplFmt_ILLEGAL;
+		int            _dst_res       = 0;
+		bool           _dst_full_flag = false;
+		bool           _loglut_flag   = false; // Mapper for float input
+	};
+
+	static TransLutCache &
+	               use_instance ();
+
+	LutSPtr        use_lut (const Key &key, const BuildFnc &build_fnc);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               TransLutCache ();
+
+	SharedCache <Key, ArrayMultiType>
+	               _cache;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               TransLutCache (const TransLutCache &other)     = delete;
+	               TransLutCache (TransLutCache &&other)          = delete;
+	TransLutCache& operator = (const TransLutCache &other)        = delete;
+	TransLutCache& operator = (TransLutCache &&other)             = delete;
+	bool           operator == (const TransLutCache &other) const = delete;
+	bool           operator != (const TransLutCache &other) const = delete;
+
+};	// class TransLutCache
+
+
+
+}	// namespace fmtcl
+
+
+
+//#include "fmtcl/TransLutCache.hpp"
+
+
+
+#endif	// fmtcl_TransLutCache_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -89,7 +89,7 @@ void	TransLut_FindIndexAvx2 <TransLut::MapperLin>::find_index (const TransLut::F
 	const __m256   v         =
 		_mm256_load_ps (reinterpret_cast <const float *> (val_arr));
 	const __m256   val_scl   = _mm256_mul_ps (v, scale);
-	const __m256i  index_raw = _mm256_cvtps_epi32 (val_scl);
+	const __m256i  index_raw = _mm256_cvtps_epi32 (_mm256_floor_ps (val_scl));
 	__m256i        index_tmp = _mm256_add_epi32 (index_raw, offset);
 	index_tmp = _mm256_min_epi32 (index_tmp, val_max);
 	index     = _mm256_max_epi32 (index_tmp, val_min);
@@ -205,8 +205,9 @@ static fstb_FORCEINLINE void	TransLut_store_avx2 (uint8_t *dst_ptr, __m256 val)
 {
 	const auto     val_i32 = _mm256_cvtps_epi32 (val);
 	const auto     val_i16 = _mm256_packs_epi32 (val_i32, val_i32);
-	const auto     val_u8  = _mm256_permute4x64_epi64 (
-		_mm256_packus_epi16 (val_i16, val_i16), (0<<0) | (2<<2)
+	const auto     val_u8  = _mm256_permutevar8x32_epi32 (
+		_mm256_packus_epi16 (val_i16, val_i16),
+		_mm256_setr_epi32 (0, 4, 0, 4, 0, 4, 0, 4)
 	);
 #if 0
 	_mm_storeu_si64 (dst_ptr, _mm256_extracti128_si256 (val_u8, 0));
@@ -228,6 +229,66 @@ static fstb_FORCEINLINE void	TransLut_store_avx2 (float *dst_ptr, __m256 val) no
 
 
 
+// Loads 8 integer pixels as 32-bit indexes
+static fstb_FORCEINLINE __m256i	TransLut_load_index_avx2 (const uint8_t *src_ptr) noexcept
+{
+	return _mm256_cvtepu8_epi32 (
+		_mm_loadl_epi64 (reinterpret_cast <const __m128i *> (src_ptr))
+	);
+}
+
+static fstb_FORCEINLINE __m256i	TransLut_load_index_avx2 (const uint16_t *src_ptr) noexcept
+{
+	return _mm256_cvtepu16_epi32 (
+		_mm_loadu_si128 (reinterpret_cast <const __m128i *> (src_ptr))
+	);
+}
+
+
+
+// Gathers 8 LUT entries and stores them. The integer tables are read with
+// 32-bit gathers, the upper bits belong to the following entries and are
+// discarded. This is why the tables require LUTINT_PAD extra elements.
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (uint8_t *dst_ptr, const uint8_t *lut_ptr, __m256i index) noexcept
+{
+	const __m256i  mask_u8 = _mm256_set1_epi32 (0xFF);
+	const __m256i  perm    = _mm256_setr_epi32 (0, 4, 0, 4, 0, 4, 0, 4);
+	__m256i        val     = _mm256_i32gather_epi32 (
+		reinterpret_cast <const int *> (lut_ptr), index, 1
+	);
+	val = _mm256_and_si256 (val, mask_u8);
+	val = _mm256_packus_epi32 (val, val);
+	val = _mm256_packus_epi16 (val, val);
+	val = _mm256_permutevar8x32_epi32 (val, perm);
+	_mm_storel_epi64 (
+		reinterpret_cast <__m128i *> (dst_ptr),
+		_mm256_castsi256_si128 (val)
+	);
+}
+
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (uint16_t *dst_ptr, const uint16_t *lut_ptr, __m256i index) noexcept
+{
+	const __m256i  mask_u16 = _mm256_set1_epi32 (0xFFFF);
+	__m256i        val      = _mm256_i32gather_epi32 (
+		reinterpret_cast <const int *> (lut_ptr), index, 2
+	);
+	val = _mm256_and_si256 (val, mask_u16);
+	val = _mm256_packus_epi32 (val, val);
+	val = _mm256_permute4x64_epi64 (val, (0<<0) | (2<<2));
+	_mm_storeu_si128 (
+		reinterpret_cast <__m128i *> (dst_ptr),
+		_mm256_castsi256_si128 (val)
+	);
+}
+
+static fstb_FORCEINLINE void	TransLut_lookup_store_avx2 (float *dst_ptr, const float *lut_ptr, __m256i index) noexcept
+{
+	const __m256   val = _mm256_i32gather_ps (lut_ptr, index, 4);
+	_mm256_storeu_ps (dst_ptr, val);
+}
+
+
+
 /*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -252,6 +313,12 @@ void	TransLut::init_proc_fnc_avx2 (int selector)
 		case 1*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint16_t, MapperLin>; break;
 		case 2*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint8_t , MapperLog>; break;
 		case 2*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx2 <uint8_t , MapperLin>; break;
+		case 0*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, float    >; break;
+		case 0*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , float    >; break;
+		case 1*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, uint16_t >; break;
+		case 1*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , uint16_t >; break;
+		case 2*4+2:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint16_t, uint8_t  >; break;
+		case 2*4+3:	_process_plane_ptr = &ThisType::process_plane_int_any_avx2 <uint8_t , uint8_t  >; break;
 
 		default:
 			// Nothing
@@ -270,6 +337,8 @@ void	TransLut::process_plane_flt_any_avx2 (Plane <> dst, PlaneRO <> src, int w,
 	assert (w > 0);
 	assert (h > 0);
 
+	const ArrayMultiType &  lut = *_lut_sptr;
+
 	for (int y = 0; y < h; ++y)
 	{
 		const PlaneRO <FloatIntMix>   s { src };
@@ -287,31 +356,31 @@ void	TransLut::process_plane_flt_any_avx2 (Plane <> dst, PlaneRO <> src, int w,
 #if 1	// Looks as fast as _mm256_set_ps
 			// G++ complains about sizeof() as argument
 			__m256             val = _mm256_i32gather_ps (
-				&_lut.use <float> (0), index._vect, 4  // 4 == sizeof (float)
+				&lut.use <float> (0), index._vect, 4  // 4 == sizeof (float)
 			);
 			const __m256       va2 = _mm256_i32gather_ps (
-				&_lut.use <float> (1), index._vect, 4  // 4 == sizeof (float)
+				&lut.use <float> (1), index._vect, 4  // 4 == sizeof (float)
 			);
 #else
 			__m256             val = _mm256_set_ps (
-				_lut.use <float> (index._scal [7]    ),
-				_lut.use <float> (index._scal [6]    ),
-				_lut.use <float> (index._scal [5]    ),
-				_lut.use <float> (index._scal [4]    ),
-				_lut.use <float> (index._scal [3]    ),
-				_lut.use <float> (index._scal [2]    ),
-				_lut.use <float> (index._scal [1]    ),
-				_lut.use <float> (index._scal [0]    )
+				lut.use <float> (index._scal [7]    ),
+				lut.use <float> (index._scal [6]    ),
+				lut.use <float> (index._scal [5]    ),
+				lut.use <float> (index._scal [4]    ),
+				lut.use <float> (index._scal [3]    ),
+				lut.use <float> (index._scal [2]    ),
+				lut.use <float> (index._scal [1]    ),
+				lut.use <float> (index._scal [0]    )
 			);
 			const __m256       va2 = _mm256_set_ps (
-				_lut.use <float> (index._scal [7] + 1),
-				_lut.use <float> (index._scal [6] + 1),
-				_lut.use <float> (index._scal [5] + 1),
-				_lut.use <float> (index._scal [4] + 1),
-				_lut.use <float> (index._scal [3] + 1),
-				_lut.use <float> (index._scal [2] + 1),
-				_lut.use <float> (index._scal [1] + 1),
-				_lut.use <float> (index._scal [0] + 1)
+				lut.use <float> (index._scal [7] + 1),
+				lut.use <float> (index._scal [6] + 1),
+				lut.use <float> (index._scal [5] + 1),
+				lut.use <float> (index._scal [4] + 1),
+				lut.use <float> (index._scal [3] + 1),
+				lut.use <float> (index._scal [2] + 1),
+				lut.use <float> (index._scal [1] + 1),
+				lut.use <float> (index._scal [0] + 1)
 			);
 #endif
 			const __m256       dif = _mm256_sub_ps (va2, val);
@@ -328,6 +397,39 @@ void	TransLut::process_plane_flt_any_avx2 (Plane <> dst, PlaneRO <> src, int w,
 
 
 
+template <class TS, class TD>
+void	TransLut::process_plane_int_any_avx2 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (h));
+	assert (src.is_valid (h));
+	assert (w > 0);
+	assert (h > 0);
+
+	const ArrayMultiType &  lut = *_lut_sptr;
+	assert (lut.get_size () >= (size_t (1) << (sizeof (TS) * 8)) + LUTINT_PAD);
+
+	const TD *     lut_ptr = &lut.use <TD> (0);
+
+	for (int y = 0; y < h; ++y)
+	{
+		const PlaneRO <TS>   s { src };
+		const Plane <TD>     d { dst };
+
+		for (int x = 0; x < w; x += 8)
+		{
+			const __m256i      index = TransLut_load_index_avx2 (s._ptr + x);
+			TransLut_lookup_store_avx2 (d._ptr + x, lut_ptr, index);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
 }	// namespace fmtcl
 
 
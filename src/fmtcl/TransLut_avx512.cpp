@@ -0,0 +1,284 @@
+/*****************************************************************************
+
+        TransLut_avx512.cpp
+        Author: Laurent de Soras, 2024
+
+To be compiled with /arch:AVX512 (AVX-512F and AVX-512BW) in order to avoid
+SSE/AVX state switch slowdown.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+#include "fmtcl/ProxyRwAvx512.h"
+#include "fmtcl/TransLut.h"
+
+#include <immintrin.h>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+// Same calculations as TransLut_FindIndexAvx2, on 16 values.
+// The comparisons produce masks instead of full vectors.
+template <class M>
+class TransLut_FindIndexAvx512
+{
+public:
+	static constexpr int LINLUT_RES_L2 = TransLut::LINLUT_RES_L2;
+	static constexpr int LINLUT_MIN_F  = TransLut::LINLUT_MIN_F;
+	static constexpr int LINLUT_MAX_F  = TransLut::LINLUT_MAX_F;
+	static constexpr int LINLUT_SIZE_F = TransLut::LINLUT_SIZE_F;
+
+	static constexpr int LOGLUT_MIN_L2 = TransLut::LOGLUT_MIN_L2;
+	static constexpr int LOGLUT_MAX_L2 = TransLut::LOGLUT_MAX_L2;
+	static constexpr int LOGLUT_RES_L2 = TransLut::LOGLUT_RES_L2;
+	static constexpr int LOGLUT_HSIZE  = TransLut::LOGLUT_HSIZE;
+	static constexpr int LOGLUT_SIZE   = TransLut::LOGLUT_SIZE;
+
+	static inline void
+		            find_index (__m512i val_i, __m512i &index, __m512 &frac) noexcept;
+};
+
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LINLUT_RES_L2;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LINLUT_MIN_F;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LINLUT_MAX_F;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LINLUT_SIZE_F;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LOGLUT_MIN_L2;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LOGLUT_MAX_L2;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LOGLUT_RES_L2;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LOGLUT_HSIZE;
+template <class M> constexpr int	TransLut_FindIndexAvx512 <M>::LOGLUT_SIZE;
+
+
+
+// val_i contains the float data, as integers
+template <>
+void	TransLut_FindIndexAvx512 <TransLut::MapperLin>::find_index (__m512i val_i, __m512i &index, __m512 &frac) noexcept
+{
+	const __m512   scale     = _mm512_set1_ps (1 << LINLUT_RES_L2);
+	const __m512i  offset    =
+		_mm512_set1_epi32 (-LINLUT_MIN_F * (1 << LINLUT_RES_L2));
+	const __m512i  val_min   = _mm512_setzero_si512 ();
+	const __m512i  val_max   = _mm512_set1_epi32 (LINLUT_SIZE_F - 2);
+
+	const __m512   v         = _mm512_castsi512_ps (val_i);
+	const __m512   val_scl   = _mm512_mul_ps (v, scale);
+	const __m512i  index_raw = _mm512_cvtps_epi32 (_mm512_roundscale_ps (
+		val_scl, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC
+	));
+	__m512i        index_tmp = _mm512_add_epi32 (index_raw, offset);
+	index_tmp = _mm512_min_epi32 (index_tmp, val_max);
+	index     = _mm512_max_epi32 (index_tmp, val_min);
+	frac      = _mm512_sub_ps (val_scl, _mm512_cvtepi32_ps (index_raw));
+}
+
+
+
+template <>
+void	TransLut_FindIndexAvx512 <TransLut::MapperLog>::find_index (__m512i val_i, __m512i &index, __m512 &frac) noexcept
+{
+	// Constants
+	constexpr int        mant_size = 23;
+	constexpr int        exp_bias  = 127;
+	constexpr uint32_t   base      = (exp_bias + LOGLUT_MIN_L2) << mant_size;
+	constexpr float      val_min   = 1.0f / (int64_t (1) << -LOGLUT_MIN_L2);
+	constexpr int        frac_size = mant_size - LOGLUT_RES_L2;
+	constexpr uint32_t   frac_mask = (1 << frac_size) - 1;
+
+	const __m512   zero_f     = _mm512_setzero_ps ();
+	const __m512   one_f      = _mm512_set1_ps (1);
+	const __m512   frac_mul   = _mm512_set1_ps (1.0f / (1 << frac_size));
+	const __m512   mul_eps    = _mm512_set1_ps (1.0f / val_min);
+
+	const __m512i  zero_i          = _mm512_setzero_si512 ();
+	const __m512i  mask_abs_epi32  = _mm512_set1_epi32 (0x7FFFFFFF);
+	const __m512i  one_epi32       = _mm512_set1_epi32 (1);
+	const __m512i  base_epi32      = _mm512_set1_epi32 (int (base));
+	const __m512i  frac_mask_epi32 = _mm512_set1_epi32 (frac_mask);
+	const __m512i  val_min_epi32   =
+		_mm512_set1_epi32 ((LOGLUT_MIN_L2 + exp_bias) << mant_size);
+	const __m512i  val_max_epi32   =
+		_mm512_set1_epi32 ((LOGLUT_MAX_L2 + exp_bias) << mant_size);
+	const __m512i  index_max_epi32 =
+		_mm512_set1_epi32 ((LOGLUT_MAX_L2 - LOGLUT_MIN_L2) << LOGLUT_RES_L2);
+	const __m512i  hsize_epi32     = _mm512_set1_epi32 (LOGLUT_HSIZE);
+	const __m512i  mirror_epi32    = _mm512_set1_epi32 (LOGLUT_HSIZE - 1);
+
+	// It really starts here. _mm512_and_ps() requires AVX-512DQ, so the
+	// absolute value is computed on the integer side.
+	const __m512i  val_u = _mm512_and_si512 (val_i, mask_abs_epi32);
+	const __m512   val_a = _mm512_castsi512_ps (val_u);
+
+	// Standard path
+	__m512i        index_std = _mm512_sub_epi32 (val_u, base_epi32);
+	index_std = _mm512_srli_epi32 (index_std, frac_size);
+	index_std = _mm512_add_epi32 (index_std, one_epi32);
+	__m512i        frac_stdi = _mm512_and_si512 (val_u, frac_mask_epi32);
+	__m512         frac_std  = _mm512_cvtepi32_ps (frac_stdi);
+	frac_std  = _mm512_mul_ps (frac_std, frac_mul);
+
+	// Epsilon path
+	__m512         frac_eps  = _mm512_max_ps (val_a, zero_f);
+	frac_eps = _mm512_mul_ps (frac_eps, mul_eps);
+
+	// Range cases
+	const __mmask16   eps_flag = _mm512_cmplt_epi32_mask (val_u, val_min_epi32);
+	const __mmask16   std_flag = _mm512_cmplt_epi32_mask (val_u, val_max_epi32);
+	__m512i        index_tmp =
+		_mm512_mask_blend_epi32 (std_flag, index_max_epi32, index_std);
+	__m512         frac_tmp  =
+		_mm512_mask_blend_ps (std_flag, one_f, frac_std);
+	index_tmp = _mm512_mask_blend_epi32 (eps_flag, index_tmp, zero_i);
+	frac_tmp  = _mm512_mask_blend_ps (eps_flag, frac_tmp, frac_eps);
+
+	// Sign cases
+	const __mmask16   neg_flag = _mm512_cmplt_epi32_mask (val_i, zero_i);
+	const __m512i  index_neg = _mm512_sub_epi32 (mirror_epi32, index_tmp);
+	const __m512i  index_pos = _mm512_add_epi32 (hsize_epi32, index_tmp);
+	const __m512   frac_neg  = _mm512_sub_ps (one_f, frac_tmp);
+	index = _mm512_mask_blend_epi32 (neg_flag, index_pos, index_neg);
+	frac  = _mm512_mask_blend_ps (neg_flag, frac_tmp, frac_neg);
+}
+
+
+
+// Same rounding and saturation as TransLut_store_avx2()
+static fstb_FORCEINLINE void	TransLut_store_avx512 (uint16_t *dst_ptr, __m512 val, __mmask16 m) noexcept
+{
+	_mm512_mask_cvtepi32_storeu_epi16 (dst_ptr, m, _mm512_cvtps_epi32 (val));
+}
+
+static fstb_FORCEINLINE void	TransLut_store_avx512 (uint8_t *dst_ptr, __m512 val, __mmask16 m) noexcept
+{
+	const __m512i  val_i32 = _mm512_max_epi32 (
+		_mm512_cvtps_epi32 (val), _mm512_setzero_si512 ()
+	);
+	_mm512_mask_cvtusepi32_storeu_epi8 (dst_ptr, m, val_i32);
+}
+
+static fstb_FORCEINLINE void	TransLut_store_avx512 (float *dst_ptr, __m512 val, __mmask16 m) noexcept
+{
+	_mm512_mask_storeu_ps (dst_ptr, m, val);
+}
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// Integer input remains on the AVX2 code
+void	TransLut::init_proc_fnc_avx512 (int selector)
+{
+	if (_avx512_flag)
+	{
+		switch (selector)
+		{
+		case 0*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <float   , MapperLog>; break;
+		case 0*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <float   , MapperLin>; break;
+		case 1*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <uint16_t, MapperLog>; break;
+		case 1*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <uint16_t, MapperLin>; break;
+		case 2*4+0:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <uint8_t , MapperLog>; break;
+		case 2*4+1:	_process_plane_ptr = &ThisType::process_plane_flt_any_avx512 <uint8_t , MapperLin>; break;
+
+		default:
+			// Nothing
+			break;
+		}
+	}
+}
+
+
+
+// 16 pixels at once. The end of the lines is processed with masked loads
+// and stores. Masked input pixels are read as 0, which is always mapped to
+// a valid index.
+template <class TD, class M>
+void	TransLut::process_plane_flt_any_avx512 (Plane <> dst, PlaneRO <> src, int w, int h) const noexcept
+{
+	assert (dst.is_valid (h));
+	assert (src.is_valid (h));
+	assert (w > 0);
+	assert (h > 0);
+
+	const ArrayMultiType &  lut = *_lut_sptr;
+	const float *  lut_ptr = &lut.use <float> (0);
+
+	const int      w16    = w & -16;
+	const int      w15    = w - w16;
+	const __mmask16   m_full = ProxyRwAvx512Mask::make_16 (16);
+	const __mmask16   m_last = ProxyRwAvx512Mask::make_16 (w15);
+
+	for (int y = 0; y < h; ++y)
+	{
+		const PlaneRO <FloatIntMix>   s { src };
+		const Plane <TD>              d { dst };
+
+		for (int x = 0; x < w; x += 16)
+		{
+			const __mmask16   m = (x < w16) ? m_full : m_last;
+
+			const __m512i  val_i = _mm512_maskz_loadu_epi32 (m, s._ptr + x);
+			__m512i        index;
+			__m512         lerp;
+			TransLut_FindIndexAvx512 <M>::find_index (val_i, index, lerp);
+
+			// G++ complains about sizeof() as argument
+			__m512         val = _mm512_i32gather_ps (
+				index, lut_ptr    , 4  // 4 == sizeof (float)
+			);
+			const __m512   va2 = _mm512_i32gather_ps (
+				index, lut_ptr + 1, 4  // 4 == sizeof (float)
+			);
+			const __m512   dif = _mm512_sub_ps (va2, val);
+			val = _mm512_add_ps (val, _mm512_mul_ps (dif, lerp));
+			TransLut_store_avx512 (&d._ptr [x], val, m);
+		}
+
+		src.step_line ();
+		dst.step_line ();
+	}
+
+	_mm256_zeroupper ();	// Back to SSE state
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -55,7 +55,8 @@ constexpr double	TransModel::_min_luminance;
 
 
 
-TransModel::TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx logc_ei_d, PicFmt src_fmt, TransCurve curve_s, TransOpLogC::ExpIdx logc_ei_s, double contrast, double gcor, double lb, double lws, double lwd, double lamb, bool scene_flag, LumMatch match, GyProc gy_proc, double sig_curve, double sig_thr, bool sse2_flag, bool avx2_flag)
+TransModel::TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx logc_ei_d, PicFmt src_fmt, TransCurve curve_s, TransOpLogC::ExpIdx logc_ei_s, double contrast, double gcor, double lb, double lws, double lwd, double lamb, bool scene_flag, LumMatch match, GyProc gy_proc, double sig_curve, double sig_thr, bool direct_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag)
+:	_avstp_ref ()
 {
 	assert (dst_fmt.is_valid ());
 	assert (TransCurve_is_valid (curve_d));
@@ -428,16 +429,19 @@ TransModel::TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx
 	{
 		bool           loglut_flag = TransLut::is_loglut_req (*op_s);
 		loglut_flag |= large_range_s_flag;
-		_dbg_txt += ", lut_s = ";
-		_dbg_txt += (loglut_flag) ? "log" : "lin";
 
 		const bool     fulld_flag = (dst_fmt._full_flag || gammay_flag);
 		_lut_s_uptr = std::make_unique <TransLut> (
-			*op_s, loglut_flag,
+			op_s, loglut_flag,
 			src_fmt._sf, src_fmt._res, src_fmt._full_flag,
 			dst_fmt._sf, dst_fmt._res, fulld_flag,
-			sse2_flag, avx2_flag
+			direct_flag, sse2_flag, avx2_flag, avx512_flag
 		);
+		_dbg_txt += ", lut_s = ";
+		_dbg_txt +=
+			  (_lut_s_uptr->is_direct ()) ? "direct"
+			: (loglut_flag              ) ? "log"
+			:                               "lin";
 		src_fmt = dst_fmt;
 	}
 	if (gammay_flag)
@@ -446,7 +450,7 @@ TransModel::TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx
 			src_fmt._sf, src_fmt._res,
 			dst_fmt._sf, dst_fmt._res,
 			gamma, gain,
-			sse2_flag, avx2_flag
+			sse2_flag, avx2_flag, avx512_flag
 		);
 		src_fmt = dst_fmt;
 	}
@@ -454,18 +458,27 @@ TransModel::TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx
 	{
 		bool           loglut_flag = TransLut::is_loglut_req (*op_d);
 		loglut_flag |= large_range_d_flag;
-		_dbg_txt += ", lut_d = ";
-		_dbg_txt += (loglut_flag) ? "log" : "lin";
 
 		const bool     fulls_flag = (src_fmt._full_flag || gammay_flag);
 		_lut_d_uptr = std::make_unique <TransLut> (
-			*op_d, loglut_flag,
+			op_d, loglut_flag,
 			src_fmt._sf, src_fmt._res, fulls_flag,
 			dst_fmt._sf, dst_fmt._res, dst_fmt._full_flag,
-			sse2_flag, avx2_flag
+			direct_flag, sse2_flag, avx2_flag, avx512_flag
 		);
+		_dbg_txt += ", lut_d = ";
+		_dbg_txt +=
+			  (_lut_d_uptr->is_direct ()) ? "direct"
+			: (loglut_flag              ) ? "log"
+			:                               "lin";
 		src_fmt = dst_fmt;
 	}
+
+	_perf_simd =
+		  (avx2_flag && avx512_flag) ? PerfTrace::Simd_AVX512
+		: (avx2_flag             ) ? PerfTrace::Simd_AVX2
+		: (sse2_flag             ) ? PerfTrace::Simd_SSE2
+		:                            PerfTrace::Simd_CPP;
 }
 
 
@@ -502,6 +515,10 @@ void	TransModel::process_frame_direct (const ProcComp3Arg &arg) const noexcept
 {
 	assert (_lut_s_uptr.get () != nullptr);
 
+	PerfTrace::Scope  perf_scope (
+		"TransModel.direct", _perf_simd, int64_t (arg._w) * arg._h
+	);
+
 	for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
 	{
 		_lut_s_uptr->process_plane (
@@ -528,6 +545,12 @@ void	TransModel::process_frame_sg (const ProcComp3Arg &arg) const noexcept
 		Plane <> { tmp_seg [2].data (), 0 }
 	};
 
+	PerfTrace::Scope  perf_scope (
+		"TransModel.sg", _perf_simd, int64_t (arg._w) * arg._h
+	);
+	PerfTrace::Acc    perf_lut_s ("TransModel.lut_s", _perf_simd);
+	PerfTrace::Acc    perf_gamma_y ("TransModel.gamma_y", _perf_simd);
+
 	for (int y = 0; y < arg._h; ++y)
 	{
 		auto           src = line_src;
@@ -537,12 +560,16 @@ void	TransModel::process_frame_sg (const ProcComp3Arg &arg) const noexcept
 		{
 			const int      work_w = std::min (arg._w - x, _max_len);
 
+			perf_lut_s.start ();
 			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
 			{
 				_lut_s_uptr->process_plane (tmp [p_idx], src [p_idx], work_w, 1);
 			}
+			perf_lut_s.stop (work_w);
 
+			perf_gamma_y.start ();
 			_gamma_y_uptr->process_plane (dst, tmp, work_w, 1);
+			perf_gamma_y.stop (work_w);
 
 			src.step_pix (_max_seg_len);
 			dst.step_pix (_max_seg_len);
@@ -551,6 +578,10 @@ void	TransModel::process_frame_sg (const ProcComp3Arg &arg) const noexcept
 		line_src.step_line ();
 		line_dst.step_line ();
 	}
+
+	int64_t        perf_t = perf_scope.get_t_beg ();
+	perf_lut_s.commit (perf_t);
+	perf_gamma_y.commit (perf_t);
 }
 
 
@@ -571,6 +602,12 @@ void	TransModel::process_frame_gd (const ProcComp3Arg &arg) const noexcept
 		Plane <> { tmp_seg [2].data (), 0 }
 	};
 
+	PerfTrace::Scope  perf_scope (
+		"TransModel.gd", _perf_simd, int64_t (arg._w) * arg._h
+	);
+	PerfTrace::Acc    perf_gamma_y ("TransModel.gamma_y", _perf_simd);
+	PerfTrace::Acc    perf_lut_d ("TransModel.lut_d", _perf_simd);
+
 	for (int y = 0; y < arg._h; ++y)
 	{
 		auto           src = line_src;
@@ -580,12 +617,16 @@ void	TransModel::process_frame_gd (const ProcComp3Arg &arg) const noexcept
 		{
 			const int      work_w = std::min (arg._w - x, _max_len);
 
+			perf_gamma_y.start ();
 			_gamma_y_uptr->process_plane (tmp, src, work_w, 1);
+			perf_gamma_y.stop (work_w);
 
+			perf_lut_d.start ();
 			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
 			{
 				_lut_d_uptr->process_plane (dst [p_idx], tmp [p_idx], work_w, 1);
 			}
+			perf_lut_d.stop (work_w);
 
 			src.step_pix (_max_seg_len);
 			dst.step_pix (_max_seg_len);
@@ -594,6 +635,10 @@ void	TransModel::process_frame_gd (const ProcComp3Arg &arg) const noexcept
 		line_src.step_line ();
 		line_dst.step_line ();
 	}
+
+	int64_t        perf_t = perf_scope.get_t_beg ();
+	perf_gamma_y.commit (perf_t);
+	perf_lut_d.commit (perf_t);
 }
 
 
@@ -621,6 +666,13 @@ void	TransModel::process_frame_sgd (const ProcComp3Arg &arg) const noexcept
 		Plane <> { tmp_seg_d [2].data (), 0 }
 	};
 
+	PerfTrace::Scope  perf_scope (
+		"TransModel.sgd", _perf_simd, int64_t (arg._w) * arg._h
+	);
+	PerfTrace::Acc    perf_lut_s ("TransModel.lut_s", _perf_simd);
+	PerfTrace::Acc    perf_gamma_y ("TransModel.gamma_y", _perf_simd);
+	PerfTrace::Acc    perf_lut_d ("TransModel.lut_d", _perf_simd);
+
 	for (int y = 0; y < arg._h; ++y)
 	{
 		auto           src = line_src;
@@ -630,17 +682,23 @@ void	TransModel::process_frame_sgd (const ProcComp3Arg &arg) const noexcept
 		{
 			const int      work_w = std::min (arg._w - x, _max_len);
 
+			perf_lut_s.start ();
 			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
 			{
 				_lut_s_uptr->process_plane (tmp_s [p_idx], src [p_idx], work_w, 1);
 			}
+			perf_lut_s.stop (work_w);
 
+			perf_gamma_y.start ();
 			_gamma_y_uptr->process_plane (tmp_d, tmp_s, work_w, 1);
+			perf_gamma_y.stop (work_w);
 
+			perf_lut_d.start ();
 			for (int p_idx = 0; p_idx < _nbr_planes; ++p_idx)
 			{
 				_lut_d_uptr->process_plane (dst [p_idx], tmp_d [p_idx], work_w, 1);
 			}
+			perf_lut_d.stop (work_w);
 
 			src.step_pix (_max_seg_len);
 			dst.step_pix (_max_seg_len);
@@ -649,6 +707,11 @@ void	TransModel::process_frame_sgd (const ProcComp3Arg &arg) const noexcept
 		line_src.step_line ();
 		line_dst.step_line ();
 	}
+
+	int64_t        perf_t = perf_scope.get_t_beg ();
+	perf_lut_s.commit (perf_t);
+	perf_gamma_y.commit (perf_t);
+	perf_lut_d.commit (perf_t);
 }
 
 
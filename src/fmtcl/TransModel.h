@@ -27,12 +27,14 @@ http://www.wtfpl.net/ for more details.
 #include "fmtcl/FrameRO.h"
 #include "fmtcl/GammaY.h"
 #include "fmtcl/LumMatch.h"
+#include "fmtcl/PerfTrace.h"
 #include "fmtcl/PicFmt.h"
 #include "fmtcl/ProcComp3Arg.h"
 #include "fmtcl/TransCurve.h"
 #include "fmtcl/TransLut.h"
 #include "fmtcl/TransOpLogC.h"
 #include "fmtcl/TransUtil.h"
+#include "AvstpWrapper.h"
 
 #include <memory>
 
@@ -67,7 +69,7 @@ public:
 		ON
 	};
 
-	explicit       TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx logc_ei_d, PicFmt src_fmt, TransCurve curve_s, TransOpLogC::ExpIdx logc_ei_s, double contrast, double gcor, double lb, double lws, double lwd, double lamb, bool scene_flag, LumMatch match, GyProc gy_proc, double sig_curve, double sig_thr, bool sse2_flag, bool avx2_flag);
+	explicit       TransModel (PicFmt dst_fmt, TransCurve curve_d, TransOpLogC::ExpIdx logc_ei_d, PicFmt src_fmt, TransCurve curve_s, TransOpLogC::ExpIdx logc_ei_s, double contrast, double gcor, double lb, double lws, double lwd, double lamb, bool scene_flag, LumMatch match, GyProc gy_proc, double sig_curve, double sig_thr, bool direct_flag, bool sse2_flag, bool avx2_flag, bool avx512_flag);
 
 	const std::string &
 	               get_debug_text () const noexcept;
@@ -110,6 +112,11 @@ private:
 	static OpSPtr  build_pq_ootf_inv ();
 	static double  compute_pq_sceneref_range_709 ();
 
+	// Keeps the thread pool alive while the LUTs are generated, so each
+	// table doesn't start and join it again.
+	AvstpWrapper::PoolRef
+	               _avstp_ref;
+
 	Proc           _proc_mode  = Proc::DIRECT;
 	int            _max_len    = 0; // Pixels
 	int            _nbr_planes = _max_nbr_planes;
@@ -125,6 +132,9 @@ private:
 	// Contains debugging information about what is done
 	std::string    _dbg_txt;
 
+	PerfTrace::Simd                  // Path reported by the performance traces
+	               _perf_simd = PerfTrace::Simd_CPP;
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
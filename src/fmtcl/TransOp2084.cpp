@@ -25,9 +25,11 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOp2084.h"
+#include "fmtcl/TransFltUtil.h"
 #include "fstb/fnc.h"
 
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 
 
@@ -59,12 +61,6 @@ double	TransOp2084::do_convert (double x) const
 	x = fstb::limit (x, 0.0, 1.0);
 	double         y = x;
 
-	constexpr double  c1 =   1.0  * 3424 / 4096;
-	constexpr double  c2 =  32.0  * 2413 / 4096;
-	constexpr double  c3 =  32.0  * 2392 / 4096;
-	constexpr double  m  = 128.0  * 2523 / 4096;
-	constexpr double  n  =   0.25 * 2610 / 4096;
-
 	// Makes sure that f(0) = 0
 	if (x > 0)
 	{
@@ -74,21 +70,21 @@ double	TransOp2084::do_convert (double x) const
 			// Scott Miller, Mahdi Nezamabadi, Scott Daly
 			// Perceptual Signal Coding for More Efficient Usage of Bit Codes, p. 5
 			// Presentation for 2012 SMPTE Annual Technical Conference & Exhibition
-			const double   xp = pow (x, 1 / m);
-			const double   r  = (xp - c1) / (c2 - c3 * xp);
+			const double   xp = pow (x, 1 / _m);
+			const double   r  = (xp - _c1) / (_c2 - _c3 * xp);
 			if (r < 0)
 			{
 				y = 0;
 			}
 			else
 			{
-				y = pow (r, 1 / n);
+				y = pow (r, 1 / _n);
 			}
 		}
 		else
 		{
-			const double   xp = pow (x, n);
-			y = pow ((c1 + c2 * xp) / (1 + c3 * xp), m);
+			const double   xp = pow (x, _n);
+			y = pow ((_c1 + _c2 * xp) / (1 + _c3 * xp), _m);
 		}
 	}
 
@@ -97,6 +93,63 @@ double	TransOp2084::do_convert (double x) const
 
 
 
+void	TransOp2084::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = TransOp2084::do_convert (src_ptr [pos]);
+	}
+}
+
+
+
+// Both directions involve an intermediate value close to 1, which is then
+// raised to a large power or subtracted. It is handled as an offset from 1
+// to keep the float precision.
+void	TransOp2084::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const auto     zero = fstb::Vf32::zero ();
+	const auto     one  = fstb::Vf32 (1.f);
+	const auto     c3   = fstb::Vf32 (float (_c3));
+
+	if (_inv_flag)
+	{
+		// xp = x ^ (1 / m) = u + 1
+		// r  = (xp - c1) / (c2 - c3 * xp)
+		//    = (u + (1 - c1)) / ((c2 - c3) - c3 * u)
+		const auto     m_i    = fstb::Vf32 (float (1 / _m));
+		const auto     n_i    = fstb::Vf32 (float (1 / _n));
+		const auto     c1c    = fstb::Vf32 (float (1 - _c1));
+		const auto     c2mc3  = fstb::Vf32 (float (_c2 - _c3));
+		const auto     x_min  = fstb::Vf32 (FLT_MIN);
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, x_min), one);
+			const auto     u = TransFltUtil::exp2_m1 (fstb::log2 (x) * m_i);
+			const auto     r = (u + c1c) / (c2mc3 - c3 * u);
+			return TransFltUtil::pow_pos (r, n_i);
+		});
+	}
+	else
+	{
+		// y = ((c1 + c2 * xp) / (1 + c3 * xp)) ^ m
+		//   = (1 + v) ^ m
+		// v = ((c1 - 1) + (c2 - c3) * xp) / (1 + c3 * xp)
+		const auto     m      = fstb::Vf32 (float (_m));
+		const auto     n      = fstb::Vf32 (float (_n));
+		const auto     c1m1   = fstb::Vf32 (float (_c1 - 1));
+		const auto     c2mc3  = fstb::Vf32 (float (_c2 - _c3));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, zero), one);
+			const auto     xp = TransFltUtil::pow_pos (x, n);
+			const auto     v  = fma (c2mc3, xp, c1m1) / fma (c3, xp, one);
+			const auto     y  = TransFltUtil::exp2_clip (TransFltUtil::log2_1p (v) * m);
+			return select (x > zero, y, zero);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOp2084::do_get_info () const
 {
 	constexpr double  w_peak = 10'000.0; // cd/m^2
@@ -110,6 +163,13 @@ TransOpInterface::LinInfo	TransOp2084::do_get_info () const
 
 
 
+std::string	TransOp2084::do_get_desc () const
+{
+	return build_desc ("2084", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -55,7 +55,11 @@ protected:
 
 	// TransOpInterface
 	double         do_convert (double x) const override;
+	void           do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const override;
+	bool           do_has_direct_flt () const override { return true; }
+	void           do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const override;
 	LinInfo        do_get_info () const override;
+	std::string    do_get_desc () const override;
 
 
 
@@ -65,6 +69,12 @@ private:
 
 	const bool     _inv_flag;
 
+	static constexpr double _c1 =   1.0  * 3424 / 4096;
+	static constexpr double _c2 =  32.0  * 2413 / 4096;
+	static constexpr double _c3 =  32.0  * 2392 / 4096;
+	static constexpr double _m  = 128.0  * 2523 / 4096;
+	static constexpr double _n  =   0.25 * 2610 / 4096;
+
 
 
 /*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -103,6 +103,13 @@ TransOpInterface::LinInfo	TransOpAcesCc::do_get_info () const
 
 
 
+std::string	TransOpAcesCc::do_get_desc () const
+{
+	return build_desc ("AcesCc", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -91,6 +91,13 @@ TransOpInterface::LinInfo	TransOpAcesCct::do_get_info () const
 
 
 
+std::string	TransOpAcesCct::do_get_desc () const
+{
+	return build_desc ("AcesCct", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
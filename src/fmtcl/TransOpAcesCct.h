@@ -52,6 +52,7 @@ protected:
 	// TransOpInterface
 	double         do_convert (double x) const override;
 	LinInfo        do_get_info () const override;
+	std::string    do_get_desc () const override;
 
 
 
@@ -60,6 +60,35 @@ double	TransOpAffine::do_convert (double x) const
 
 
 
+void	TransOpAffine::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = src_ptr [pos] * _a + _b;
+	}
+}
+
+
+
+void	TransOpAffine::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const float    a = float (_a);
+	const float    b = float (_b);
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = src_ptr [pos] * a + b;
+	}
+}
+
+
+
+std::string	TransOpAffine::do_get_desc () const
+{
+	return build_desc ("Affine", { _a, _b });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -55,7 +55,11 @@ protected:
 
 	// TransOpInterface
 	double         do_convert (double x) const override;
+	void           do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const override;
+	bool           do_has_direct_flt () const override { return true; }
+	void           do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const override;
 	LinInfo        do_get_info () const override { return _unbounded; }
+	std::string    do_get_desc () const override;
 
 
 
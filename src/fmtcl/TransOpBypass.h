@@ -29,6 +29,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include "fmtcl/TransOpInterface.h"
 
+#include <algorithm>
+
 
 
 namespace fmtcl
@@ -56,6 +58,15 @@ protected:
 	// TransOpInterface
 	double         do_convert (double x) const override { return x; }
 	LinInfo        do_get_info () const override { return _unbounded; }
+	std::string    do_get_desc () const override { return build_desc ("Bypass", {}); }
+	bool           do_has_direct_flt () const override { return true; }
+	void           do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const override
+	{
+		if (dst_ptr != src_ptr)
+		{
+			std::copy (src_ptr, src_ptr + nbr_spl, dst_ptr);
+		}
+	}
 
 
 
@@ -83,6 +83,13 @@ TransOpInterface::LinInfo	TransOpCanonLog::do_get_info () const
 
 
 
+std::string	TransOpCanonLog::do_get_desc () const
+{
+	return build_desc ("CanonLog", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -59,6 +59,43 @@ double	TransOpCompose::do_convert (double x) const
 
 
 
+void	TransOpCompose::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	_op_1_sptr->convert_block (dst_ptr, src_ptr, nbr_spl);
+	_op_2_sptr->convert_block (dst_ptr, dst_ptr, nbr_spl);
+}
+
+
+
+bool	TransOpCompose::do_has_direct_flt () const
+{
+	return (_op_1_sptr->has_direct_flt () && _op_2_sptr->has_direct_flt ());
+}
+
+
+
+void	TransOpCompose::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	_op_1_sptr->convert_block_flt (dst_ptr, src_ptr, nbr_spl);
+	_op_2_sptr->convert_block_flt (dst_ptr, dst_ptr, nbr_spl);
+}
+
+
+
+std::string	TransOpCompose::do_get_desc () const
+{
+	const std::string desc_1 = _op_1_sptr->get_desc ();
+	const std::string desc_2 = _op_2_sptr->get_desc ();
+	if (desc_1.empty () || desc_2.empty ())
+	{
+		return std::string ();
+	}
+
+	return "Compose(" + desc_1 + "," + desc_2 + ")";
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -56,7 +56,12 @@ protected:
 
 	// TransOpInterface
 	inline double  do_convert (double x) const override;
+	inline void    do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const override;
+	inline bool    do_has_direct_flt () const override;
+	inline void    do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const override;
 	LinInfo        do_get_info () const override { return _unbounded; }
+	inline std::string
+	               do_get_desc () const override;
 
 
 
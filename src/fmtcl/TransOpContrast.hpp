@@ -54,6 +54,41 @@ double	TransOpContrast::do_convert (double x) const
 
 
 
+void	TransOpContrast::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = src_ptr [pos] * _cont;
+	}
+}
+
+
+
+bool	TransOpContrast::do_has_direct_flt () const
+{
+	return true;
+}
+
+
+
+void	TransOpContrast::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const float    cont = float (_cont);
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = src_ptr [pos] * cont;
+	}
+}
+
+
+
+std::string	TransOpContrast::do_get_desc () const
+{
+	return build_desc ("Contrast", { _cont });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
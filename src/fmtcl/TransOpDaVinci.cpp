@@ -84,6 +84,13 @@ TransOpInterface::LinInfo  TransOpDaVinci::do_get_info () const
 
 
 
+std::string  TransOpDaVinci::do_get_desc () const
+{
+	return build_desc ("DaVinci", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -113,6 +113,13 @@ TransOpInterface::LinInfo	TransOpErimm::do_get_info () const
 
 
 
+std::string	TransOpErimm::do_get_desc () const
+{
+	return build_desc ("Erimm", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -99,6 +99,13 @@ TransOpInterface::LinInfo	TransOpFilmStream::do_get_info () const
 
 
 
+std::string	TransOpFilmStream::do_get_desc () const
+{
+	return build_desc ("FilmStream", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -25,9 +25,11 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpHlg.h"
+#include "fmtcl/TransFltUtil.h"
 #include "fstb/fnc.h"
 
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 
 
@@ -71,6 +73,73 @@ double	TransOpHlg::do_convert (double x) const
 
 
 
+void	TransOpHlg::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	if (_inv_flag)
+	{
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			const double   x = compute_inverse (fstb::limit (src_ptr [pos], 0.0, 1.0));
+			dst_ptr [pos] = fstb::limit (x, 0.0, 1.0);
+		}
+	}
+	else
+	{
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			const double   x = compute_direct (fstb::limit (src_ptr [pos], 0.0, 1.0));
+			dst_ptr [pos] = fstb::limit (x, 0.0, 1.0);
+		}
+	}
+}
+
+
+
+void	TransOpHlg::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const auto     zero = fstb::Vf32::zero ();
+	const auto     one  = fstb::Vf32 (1.f);
+	const auto     a    = fstb::Vf32 (float (_a));
+	const auto     b    = fstb::Vf32 (float (_b));
+	const auto     c    = fstb::Vf32 (float (_c));
+
+	if (_inv_flag)
+	{
+		const auto     half    = fstb::Vf32 (0.5f);
+		const auto     third   = fstb::Vf32 (float (1.0 / 3));
+		const auto     twelfth = fstb::Vf32 (float (1.0 / 12));
+		// exp ((x - c) / a) = 2 ^ ((x - c) * log2 (e) / a)
+		const auto     mul     = fstb::Vf32 (float (fstb::LOG2_E / _a));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, zero), one);
+			const auto     y_lo = x * x * third;
+			const auto     y_hi =
+				(TransFltUtil::exp2_clip ((x - c) * mul) + b) * twelfth;
+			const auto     y    = select (x <= half, y_lo, y_hi);
+			return min (max (y, zero), one);
+		});
+	}
+	else
+	{
+		const auto     three   = fstb::Vf32 (3.f);
+		const auto     twelve  = fstb::Vf32 (12.f);
+		const auto     twelfth = fstb::Vf32 (float (1.0 / 12));
+		// a * log (v) = a * ln (2) * log2 (v)
+		const auto     a_ln2   = fstb::Vf32 (float (_a * fstb::LN2));
+		const auto     v_min   = fstb::Vf32 (FLT_MIN);
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, zero), one);
+			const auto     y_lo = fstb::sqrt (x * three);
+			const auto     v    = max (x * twelve - b, v_min);
+			const auto     y_hi = fma (fstb::log2 (v), a_ln2, c);
+			const auto     y    = select (x <= twelfth, y_lo, y_hi);
+			return min (max (y, zero), one);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOpHlg::do_get_info () const
 {
 	const double   w_ref = compute_inverse (0.75);
@@ -81,6 +150,13 @@ TransOpInterface::LinInfo	TransOpHlg::do_get_info () const
 
 
 
+std::string	TransOpHlg::do_get_desc () const
+{
+	return build_desc ("Hlg", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
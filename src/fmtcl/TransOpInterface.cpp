@@ -25,6 +25,7 @@ http://www.wtfpl.net/ for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpInterface.h"
+#include "fstb/fnc.h"
 
 #include <cassert>
 
@@ -50,6 +51,35 @@ double	TransOpInterface::operator () (double x) const
 
 
 
+void	TransOpInterface::convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (nbr_spl > 0);
+
+	do_convert_block (dst_ptr, src_ptr, nbr_spl);
+}
+
+
+
+bool	TransOpInterface::has_direct_flt () const
+{
+	return do_has_direct_flt ();
+}
+
+
+
+void	TransOpInterface::convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	assert (dst_ptr != nullptr);
+	assert (src_ptr != nullptr);
+	assert (nbr_spl > 0);
+
+	do_convert_block_flt (dst_ptr, src_ptr, nbr_spl);
+}
+
+
+
 TransOpInterface::LinInfo	TransOpInterface::get_info () const
 {
 	const auto     info = do_get_info ();
@@ -64,10 +94,64 @@ TransOpInterface::LinInfo	TransOpInterface::get_info () const
 
 
 
+std::string	TransOpInterface::get_desc () const
+{
+	return do_get_desc ();
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
 
+// Default implementation, one virtual call per sample. Operators used in
+// long chains or with a costly dispatch should override it.
+void	TransOpInterface::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = do_convert (src_ptr [pos]);
+	}
+}
+
+
+
+void	TransOpInterface::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = float (do_convert (src_ptr [pos]));
+	}
+}
+
+
+
+// Parameters are printed with all their significant digits, so different
+// values always give different descriptions.
+std::string	TransOpInterface::build_desc (const char *name_0, std::initializer_list <double> param_list)
+{
+	assert (name_0 != nullptr);
+
+	std::string    desc { name_0 };
+	desc += "(";
+	char           txt_0 [31+1];
+	bool           first_flag = true;
+	for (const double param : param_list)
+	{
+		fstb::snprintf4all (
+			txt_0, sizeof (txt_0), "%s%.17g", (first_flag) ? "" : ",", param
+		);
+		desc += txt_0;
+		first_flag = false;
+	}
+	desc += ")";
+
+	return desc;
+}
+
+
+
 }  // namespace fmtcl
 
 
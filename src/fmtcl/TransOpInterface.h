@@ -27,6 +27,9 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include <initializer_list>
+#include <string>
+
 
 
 namespace fmtcl
@@ -87,8 +90,25 @@ public:
 	// (input domain or spec requirement).
 	double         operator () (double x) const;
 
+	// Converts a block of values. dst_ptr and src_ptr may be the same.
+	void           convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const;
+
+	// Indicates that convert_block_flt() evaluates the curve directly with
+	// a precision suitable for single-precision data, and is fast enough to
+	// replace a lookup table.
+	bool           has_direct_flt () const;
+
+	// Single-precision version of convert_block(). Always available, but
+	// falls back on do_convert() when has_direct_flt() is false.
+	void           convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const;
+
 	LinInfo        get_info () const;
 
+	// Canonical description of the operator with all its parameters, for
+	// the LUT cache. Operators with the same description give the same
+	// results. An empty string means the operator cannot be identified.
+	std::string    get_desc () const;
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -96,8 +116,16 @@ public:
 protected:
 
 	virtual double do_convert (double x) const = 0;
+	virtual void   do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const;
+	virtual bool   do_has_direct_flt () const { return false; }
+	virtual void   do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const;
 	virtual LinInfo
 	               do_get_info () const { return { }; }
+	virtual std::string
+	               do_get_desc () const { return std::string (); }
+
+	static std::string
+	               build_desc (const char *name_0, std::initializer_list <double> param_list);
 
 
 
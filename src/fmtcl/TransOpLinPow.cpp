@@ -25,6 +25,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpLinPow.h"
+#include "fmtcl/TransFltUtil.h"
 #include "fstb/fnc.h"
 
 #include <cassert>
@@ -142,6 +143,82 @@ double	TransOpLinPow::do_convert (double x) const
 
 
 
+void	TransOpLinPow::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = TransOpLinPow::do_convert (src_ptr [pos]);
+	}
+}
+
+
+
+// Both power segments share a single pow() evaluation. The negative segment
+// mask stays empty when the clipping bounds make it unreachable.
+void	TransOpLinPow::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const bool     lin_flag   = fstb::is_eq (_p2, 1.0);
+	const auto     alpha_m1   = fstb::Vf32 (float (_alpha_m1));
+	const auto     scneg_m    = fstb::Vf32 (float (-_scneg));
+	const auto     scneg_m_i  = fstb::Vf32 (float (-1 / _scneg));
+
+	if (_inv_flag)
+	{
+		const auto     lb        = fstb::Vf32 (float (_lb_i));
+		const auto     ub        = fstb::Vf32 (float (_ub_i));
+		const auto     beta      = fstb::Vf32 (float (_beta_i));
+		const auto     beta_n    = fstb::Vf32 (float (_beta_in));
+		const auto     alpha_inv = fstb::Vf32 (float (1 / _alpha));
+		const auto     slope_inv = fstb::Vf32 (float (1 / _slope));
+		const auto     p1_i      = fstb::Vf32 (float (_p1_i));
+		const auto     p2_i      = fstb::Vf32 (float (_p2_i));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, lb), ub);
+			auto           y_mid = x;
+			if (! lin_flag)
+			{
+				y_mid = TransFltUtil::pow_pos (abs (x), p2_i) | x.signbit ();
+			}
+			y_mid *= slope_inv;
+			const auto     neg_mask = (x <= beta_n);
+			const auto     base     =
+				select (neg_mask, fma (x, scneg_m, alpha_m1), x + alpha_m1);
+			auto           y_pow    =
+				TransFltUtil::pow_pos (base * alpha_inv, p1_i);
+			y_pow = select (neg_mask, y_pow * scneg_m_i, y_pow);
+			return select ((x >= beta) | neg_mask, y_pow, y_mid);
+		});
+	}
+
+	else
+	{
+		const auto     lb        = fstb::Vf32 (float (_lb));
+		const auto     ub        = fstb::Vf32 (float (_ub));
+		const auto     beta      = fstb::Vf32 (float (_beta));
+		const auto     beta_n    = fstb::Vf32 (float (_beta_n));
+		const auto     alpha     = fstb::Vf32 (float (_alpha));
+		const auto     slope     = fstb::Vf32 (float (_slope));
+		const auto     p1        = fstb::Vf32 (float (_p1));
+		const auto     p2        = fstb::Vf32 (float (_p2));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, lb), ub);
+			auto           y_mid = x * slope;
+			if (! lin_flag)
+			{
+				y_mid = TransFltUtil::pow_pos (abs (y_mid), p2) | y_mid.signbit ();
+			}
+			const auto     neg_mask = (x <= beta_n);
+			const auto     base     = select (neg_mask, x * scneg_m, x);
+			auto           y_pow    =
+				fms (alpha, TransFltUtil::pow_pos (base, p1), alpha_m1);
+			y_pow = select (neg_mask, y_pow * scneg_m_i, y_pow);
+			return select ((x >= beta) | neg_mask, y_pow, y_mid);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOpLinPow::do_get_info () const
 {
 	return { Type::UNDEF, Range::UNDEF, 1.0, 1.0, _scale_cdm2, _wpeak_cdm2 };
@@ -149,6 +226,16 @@ TransOpInterface::LinInfo	TransOpLinPow::do_get_info () const
 
 
 
+std::string	TransOpLinPow::do_get_desc () const
+{
+	return build_desc ("LinPow", {
+		double (_inv_flag), _alpha, _beta, _p1, _slope, _lb, _ub, _scneg, _p2,
+		_scale_cdm2, _wpeak_cdm2
+	});
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
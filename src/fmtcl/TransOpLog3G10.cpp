@@ -61,6 +61,13 @@ TransOpInterface::LinInfo	TransOpLog3G10::do_get_info () const
 
 
 
+std::string	TransOpLog3G10::do_get_desc () const
+{
+	return build_desc ("Log3G10", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -25,10 +25,12 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpLogC.h"
+#include "fmtcl/TransFltUtil.h"
 
 #include <algorithm>
 
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 
 
@@ -96,6 +98,67 @@ double	TransOpLogC::do_convert (double x) const
 
 
 
+void	TransOpLogC::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	if (_inv_flag)
+	{
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			dst_ptr [pos] = compute_inverse (src_ptr [pos]);
+		}
+	}
+	else
+	{
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			dst_ptr [pos] = compute_direct (src_ptr [pos]);
+		}
+	}
+}
+
+
+
+void	TransOpLogC::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const auto     one = fstb::Vf32 (1.f);
+	const auto     n   = fstb::Vf32 (float (_n));
+	const auto     b   = fstb::Vf32 (float (_curve._b));
+	const auto     d   = fstb::Vf32 (float (_curve._d));
+	const auto     f   = fstb::Vf32 (float (_curve._f));
+
+	if (_inv_flag)
+	{
+		const auto     cut_i = fstb::Vf32 (float (_curve._cut_i));
+		const auto     a_inv = fstb::Vf32 (float (1 / _curve._a));
+		const auto     c_inv = fstb::Vf32 (float (1 / _curve._c));
+		const auto     e_inv = fstb::Vf32 (float (1 / _curve._e));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (x, one);
+			const auto     y_log =
+				(TransFltUtil::exp10 ((x - d) * c_inv) - b) * a_inv;
+			const auto     y_lin = (x - f) * e_inv;
+			return max (select (x > cut_i, y_log, y_lin), n);
+		});
+	}
+	else
+	{
+		const auto     cut   = fstb::Vf32 (float (_curve._cut));
+		const auto     a     = fstb::Vf32 (float (_curve._a));
+		const auto     c     = fstb::Vf32 (float (_curve._c));
+		const auto     e     = fstb::Vf32 (float (_curve._e));
+		const auto     v_min = fstb::Vf32 (FLT_MIN);
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = max (x, n);
+			const auto     v     = max (fma (a, x, b), v_min);
+			const auto     y_log = fma (c, TransFltUtil::log10 (v), d);
+			const auto     y_lin = fma (e, x, f);
+			return min (select (x > cut, y_log, y_lin), one);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOpLogC::do_get_info () const
 {
 	const double  grey18 = compute_inverse (400.0 / 1023.0);
@@ -106,6 +169,19 @@ TransOpInterface::LinInfo	TransOpLogC::do_get_info () const
 
 
 
+std::string	TransOpLogC::do_get_desc () const
+{
+	// The curve type and the exposure index are fully defined by the noise
+	// margin and the curve coefficients.
+	return build_desc ("LogC", {
+		double (_inv_flag), _n,
+		_curve._cut, _curve._a, _curve._b, _curve._c, _curve._d, _curve._e,
+		_curve._f, _curve._cut_i
+	});
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -81,6 +81,13 @@ double	TransOpLogTrunc::do_convert (double x) const
 
 
 
+std::string	TransOpLogTrunc::do_get_desc () const
+{
+	return build_desc ("LogTrunc", { double (_inv_flag), _alpha, _beta });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -55,6 +55,7 @@ protected:
 
 	// TransOpInterface
 	double         do_convert (double x) const override;
+	std::string    do_get_desc () const override;
 
 
 
@@ -25,6 +25,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpPow.h"
+#include "fmtcl/TransFltUtil.h"
 
 #include <algorithm>
 
@@ -83,6 +84,43 @@ double	TransOpPow::do_convert (double x) const
 
 
 
+void	TransOpPow::do_convert_block (double dst_ptr [], const double src_ptr [], int nbr_spl) const
+{
+	for (int pos = 0; pos < nbr_spl; ++pos)
+	{
+		dst_ptr [pos] = TransOpPow::do_convert (src_ptr [pos]);
+	}
+}
+
+
+
+void	TransOpPow::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const auto     zero    = fstb::Vf32::zero ();
+	const auto     val_max = fstb::Vf32 (float (_val_max));
+
+	if (_inv_flag)
+	{
+		const auto     alpha_inv = fstb::Vf32 (float (1 / _alpha));
+		const auto     p_i       = fstb::Vf32 (float (_p_i));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			const auto     y = TransFltUtil::pow_pos (x * alpha_inv, p_i);
+			return min (y, val_max);
+		});
+	}
+	else
+	{
+		const auto     alpha = fstb::Vf32 (float (_alpha));
+		const auto     p     = fstb::Vf32 (float (_p));
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = min (max (x, zero), val_max);
+			return alpha * TransFltUtil::pow_pos (x, p);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOpPow::do_get_info () const
 {
 	return { Type::UNDEF, Range::SDR, _val_max, 1.0, _scale_cdm2, _wpeak_cdm2 };
@@ -90,6 +128,15 @@ TransOpInterface::LinInfo	TransOpPow::do_get_info () const
 
 
 
+std::string	TransOpPow::do_get_desc () const
+{
+	return build_desc ("Pow", {
+		double (_inv_flag), _p_i, _alpha, _val_max, _scale_cdm2, _wpeak_cdm2
+	});
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -72,6 +72,13 @@ TransOpInterface::LinInfo	TransOpPowOfs::do_get_info () const
 
 
 
+std::string	TransOpPowOfs::do_get_desc () const
+{
+	return build_desc ("PowOfs", { double (_inv_flag), _kx, _kw, _kl });
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
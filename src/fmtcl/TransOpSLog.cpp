@@ -76,6 +76,13 @@ TransOpInterface::LinInfo	TransOpSLog::do_get_info () const
 
 
 
+std::string	TransOpSLog::do_get_desc () const
+{
+	return build_desc ("SLog", { double (_inv_flag), double (_slog2_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
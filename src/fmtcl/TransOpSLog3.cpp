@@ -25,6 +25,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fmtcl/TransOpSLog3.h"
+#include "fmtcl/TransFltUtil.h"
 
 #include <algorithm>
 
@@ -63,6 +64,51 @@ double	TransOpSLog3::do_convert (double x) const
 
 
 
+// Same formulas as log_to_lin() and lin_to_log()
+void	TransOpSLog3::do_convert_block_flt (float dst_ptr [], const float src_ptr [], int nbr_spl) const
+{
+	const auto     zero = fstb::Vf32::zero ();
+
+	if (_inv_flag)
+	{
+		const auto     cut   = fstb::Vf32 (float (171.2102946929 / 1023.0));
+		const auto     lin_a = fstb::Vf32 (float (1023.0 * 0.01125000 / (171.2102946929 - 95.0)));
+		const auto     lin_b = fstb::Vf32 (float (-95.0 * 0.01125000 / (171.2102946929 - 95.0)));
+		const auto     log_a = fstb::Vf32 (float (1023.0 / 261.5));
+		const auto     log_b = fstb::Vf32 (float (-420.0 / 261.5));
+		const auto     scale = fstb::Vf32 (float (0.18 + 0.01));
+		const auto     ofs   = fstb::Vf32 (0.01f);
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = max (x, zero);
+			const auto     y_lin = fma (x, lin_a, lin_b);
+			const auto     y_log = fms (
+				TransFltUtil::exp10 (fma (x, log_a, log_b)), scale, ofs
+			);
+			return select (x < cut, y_lin, y_log);
+		});
+	}
+	else
+	{
+		const auto     cut   = fstb::Vf32 (0.01125000f);
+		const auto     lin_a = fstb::Vf32 (float ((171.2102946929 - 95.0) / 0.01125000 / 1023.0));
+		const auto     lin_b = fstb::Vf32 (float (95.0 / 1023.0));
+		const auto     log_a = fstb::Vf32 (float (261.5 / 1023.0));
+		const auto     log_b = fstb::Vf32 (float (420.0 / 1023.0));
+		const auto     scale = fstb::Vf32 (float (1 / (0.18 + 0.01)));
+		const auto     ofs   = fstb::Vf32 (0.01f);
+		TransFltUtil::process_block (dst_ptr, src_ptr, nbr_spl, [&] (fstb::Vf32 x) {
+			x = max (x, zero);
+			const auto     y_lin = fma (x, lin_a, lin_b);
+			const auto     y_log = fma (
+				TransFltUtil::log10 ((x + ofs) * scale), log_a, log_b
+			);
+			return select (x < cut, y_lin, y_log);
+		});
+	}
+}
+
+
+
 TransOpInterface::LinInfo	TransOpSLog3::do_get_info () const
 {
 	return {
@@ -76,6 +122,13 @@ TransOpInterface::LinInfo	TransOpSLog3::do_get_info () const
 
 
 
+std::string	TransOpSLog3::do_get_desc () const
+{
+	return build_desc ("SLog3", { double (_inv_flag) });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -68,6 +68,13 @@ double	TransOpSigmoid::do_convert (double x) const
 
 
 
+std::string	TransOpSigmoid::do_get_desc () const
+{
+	return build_desc ("Sigmoid", { double (_inv_flag), _c, _t });
+}
+
+
+
 /*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
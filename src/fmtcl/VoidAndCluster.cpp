@@ -28,7 +28,10 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 #include "fstb/fnc.h"
 #include "fstb/Hash.h"
 
+#include <algorithm>
+#include <future>
 #include <limits>
+#include <tuple>
 
 #include <cassert>
 #include <cmath>
@@ -51,6 +54,15 @@ void	VoidAndCluster::set_aztec_mode (bool flag)
 
 
 
+// Computes the ranks below and above the initial pattern in two threads.
+// Results are the same in both modes.
+void	VoidAndCluster::set_mt_mode (bool flag)
+{
+	_mt_flag = flag;
+}
+
+
+
 void	VoidAndCluster::create_matrix (MatrixWrap <Rank> &vnc)
 {
 	const int      w   = vnc.get_w ();
@@ -58,6 +70,7 @@ void	VoidAndCluster::create_matrix (MatrixWrap <Rank> &vnc)
 	assert (w * h <= std::numeric_limits <Rank>::max ());
 	const int      ks  = _kernel_def_rad * 2 + 1;
 	create_kernel (ks, ks, 1.5);
+	fold_kernel (w, h);
 
 	_base._pat      = Monochrome { w, h };
 	_base._pat_filt = Filtered { w, h };
@@ -67,28 +80,20 @@ void	VoidAndCluster::create_matrix (MatrixWrap <Rank> &vnc)
 	vnc.clear ();
 
 	const int      rank_base = count_elt (_base._pat, 1);
-	std::vector <Coord>  coord_arr;
 
-	int            rank = rank_base;
-	_cur = _base;
-	while (rank > 0)
+	if (_mt_flag)
 	{
-		-- rank;
-		_cur.find_cluster (coord_arr);
-		const auto &   c = pick_one (coord_arr, uint32_t (rank));
-		set_pix <0> (_cur, c);
-		vnc.at (c._x, c._y) = Rank (rank);
+		auto           down_fut = std::async (
+			std::launch::async,
+			[this, &vnc, rank_base] () { rank_down (vnc, rank_base); }
+		);
+		rank_up (vnc, rank_base);
+		down_fut.get ();
 	}
-
-	rank = rank_base;
-	_cur = _base;
-	while (rank < w * h)
+	else
 	{
-		_cur.find_void (coord_arr);
-		const auto &   v = pick_one (coord_arr, uint32_t (rank));
-		set_pix <1> (_cur, v);
-		vnc.at (v._x, v._y) = Rank (rank);
-		++ rank;
+		rank_down (vnc, rank_base);
+		rank_up (vnc, rank_base);
 	}
 }
 
@@ -104,6 +109,7 @@ void	VoidAndCluster::create_matrix (MatrixWrap <Rank> &vnc)
 
 constexpr int	VoidAndCluster::_kernel_def_rad;
 constexpr VoidAndCluster::SampleType	VoidAndCluster::_kscale;
+constexpr int	VoidAndCluster::SearchTree::_blk_len_l2;
 
 
 
@@ -124,6 +130,368 @@ bool	VoidAndCluster::Coord::operator < (const Coord &other) const
 
 
 
+void	VoidAndCluster::SearchTree::init (const Monochrome &pat, const Filtered &filt)
+{
+	const auto     nbr_pix    = Index (pat.get_w ()) * Index (pat.get_h ());
+	const int      nbr_pix_l2 = fstb::get_next_pow_2 (uint32_t (nbr_pix));
+	assert (nbr_pix == Index (1) << nbr_pix_l2);
+
+	_blk_len_cur_l2 = std::min (int (_blk_len_l2), nbr_pix_l2);
+	_nbr_leaves     = nbr_pix >> _blk_len_cur_l2;
+	_node_arr.resize (_nbr_leaves * 2);
+	for (Index blk = 0; blk < _nbr_leaves; ++blk)
+	{
+		scan_side (0, blk, pat, filt);
+		scan_side (1, blk, pat, filt);
+	}
+	for (Index pos = _nbr_leaves - 1; pos > 0; --pos)
+	{
+		update_node (pos);
+	}
+}
+
+
+
+// Stops maintaining the other side, its data becomes invalid. Used when
+// the search is done on a single side until the end.
+void	VoidAndCluster::SearchTree::restrict_to_side (int side)
+{
+	assert (is_active (side));
+
+	_side_beg = side;
+	_side_end = side + 1;
+}
+
+
+
+bool	VoidAndCluster::SearchTree::is_active (int side) const
+{
+	return (side >= _side_beg && side < _side_end);
+}
+
+
+
+// Call it after a colour change of a pixel, pat being already updated.
+// black_flag is the new colour. Ancestors are not updated.
+void	VoidAndCluster::SearchTree::flip_pix (Index idx, bool black_flag, SampleType val, const Monochrome &pat, const Filtered &filt)
+{
+	const auto     blk  = idx >> _blk_len_cur_l2;
+	const int      side = (black_flag) ? 1 : 0;
+	if (is_active (1 - side))
+	{
+		remove_val (1 - side, blk, val, pat, filt);
+	}
+	if (is_active (side))
+	{
+		add_val (side, blk, val);
+	}
+}
+
+
+
+// Applies op (val, coef) to the filtered values of the pixels in
+// [beg ; beg + len[, without wrapping, and updates the leaves.
+// Each block is updated at once: the pixels leaving the extremum are counted
+// first, so the block is scanned again only if none remains there. The
+// loops are branchless, pixel colours are not predictable.
+// Ancestors are not updated.
+template <typename F>
+void	VoidAndCluster::SearchTree::splat_seg (Index beg, int len, const SampleType *coef_ptr, F op, const Monochrome &pat, Filtered &filt)
+{
+	assert (len > 0);
+	assert (coef_ptr != nullptr);
+
+	const auto     end = beg + Index (len);
+	while (beg < end)
+	{
+		const auto     blk     = beg >> _blk_len_cur_l2;
+		const auto     blk_end = std::min (end, (blk + 1) << _blk_len_cur_l2);
+		const int      seg_len = int (blk_end - beg);
+		const auto *   pat_ptr = &pat.at (beg);
+		auto *         flt_ptr = &filt.at (beg);
+		auto &         leaf    = _node_arr [_nbr_leaves + blk];
+
+		std::array <int32_t, 2> hit_arr {{ 0, 0 }};
+		for (int k = 0; k < seg_len; ++k)
+		{
+			const int      side = pat_ptr [k];
+			hit_arr [side] += int32_t (flt_ptr [k] == leaf._val [side]);
+		}
+
+		// The values of the inactive side are updated too, it's faster
+		// than testing the colour and they are not used anyway.
+		for (int k = 0; k < seg_len; ++k)
+		{
+			flt_ptr [k] = op (flt_ptr [k], coef_ptr [k]);
+		}
+		coef_ptr += seg_len;
+
+		for (int side = _side_beg; side < _side_end; ++side)
+		{
+			const auto     nbr_hit = hit_arr [side];
+			if (nbr_hit == 0 || nbr_hit < leaf._nbr [side])
+			{
+				// Extremum of the segment, merged with the remaining pixels
+				const auto     neutral = get_neutral (side);
+				auto           ext     = neutral;
+				for (int k = 0; k < seg_len; ++k)
+				{
+					const auto     msk = SampleType (pat_ptr [k] ^ side) - 1;
+					const auto     val = (flt_ptr [k] & msk) | (neutral & ~msk);
+					ext = (side != 0) ? std::max (ext, val) : std::min (ext, val);
+				}
+				int32_t        nbr     = 0;
+				for (int k = 0; k < seg_len; ++k)
+				{
+					nbr +=
+						  int32_t (pat_ptr [k] == side)
+						& int32_t (flt_ptr [k] == ext);
+				}
+				leaf._nbr [side] -= nbr_hit;
+				if (is_before (side, ext, leaf._val [side]))
+				{
+					leaf._val [side] = ext;
+					leaf._nbr [side] = nbr;
+				}
+				else if (ext == leaf._val [side])
+				{
+					leaf._nbr [side] += nbr;
+				}
+			}
+			else
+			{
+				scan_side (side, blk, pat, filt);
+			}
+		}
+
+		beg = blk_end;
+	}
+}
+
+
+
+// Updates the ancestors of the blocks containing the pixels in [beg ; end[,
+// stopping as soon as they are not modified anymore.
+void	VoidAndCluster::SearchTree::propagate (Index beg, Index end)
+{
+	assert (beg < end);
+	assert (end <= _nbr_leaves << _blk_len_cur_l2);
+
+	Index          lo = (_nbr_leaves + ( beg      >> _blk_len_cur_l2)) >> 1;
+	Index          hi = (_nbr_leaves + ((end - 1) >> _blk_len_cur_l2)) >> 1;
+	while (lo > 0)
+	{
+		Index          lo_chg = hi + 1;
+		Index          hi_chg = 0;
+		for (Index pos = lo; pos <= hi; ++pos)
+		{
+			if (update_node (pos))
+			{
+				lo_chg = std::min (lo_chg, pos);
+				hi_chg = pos;
+			}
+		}
+		if (lo_chg > hi_chg)
+		{
+			break;
+		}
+		lo = lo_chg >> 1;
+		hi = hi_chg >> 1;
+	}
+}
+
+
+
+int	VoidAndCluster::SearchTree::count_voids () const
+{
+	return _node_arr [1]._nbr [0];
+}
+
+
+
+int	VoidAndCluster::SearchTree::count_clusters () const
+{
+	return _node_arr [1]._nbr [1];
+}
+
+
+
+// Ties are ordered by increasing index.
+// pos: position within the ties, in [0 ; count_voids () - 1]
+VoidAndCluster::Index	VoidAndCluster::SearchTree::find_void (int pos, const Monochrome &pat, const Filtered &filt) const
+{
+	return find_top (0, pos, pat, filt);
+}
+
+
+
+// Ties are ordered by decreasing index, like the reverse traversal of the
+// former std::set, so the elected pixels remain the same.
+// pos: position within the ties, in [0 ; count_clusters () - 1]
+VoidAndCluster::Index	VoidAndCluster::SearchTree::find_cluster (int pos, const Monochrome &pat, const Filtered &filt) const
+{
+	return find_top (1, pos, pat, filt);
+}
+
+
+
+bool	VoidAndCluster::SearchTree::is_before (int side, SampleType a, SampleType b)
+{
+	return (side != 0) ? (a > b) : (a < b);
+}
+
+
+
+// Value never reached by the side extremum
+VoidAndCluster::SampleType	VoidAndCluster::SearchTree::get_neutral (int side)
+{
+	return (side != 0)
+		? std::numeric_limits <SampleType>::min ()
+		: std::numeric_limits <SampleType>::max ();
+}
+
+
+
+VoidAndCluster::Index	VoidAndCluster::SearchTree::find_top (int side, int pos, const Monochrome &pat, const Filtered &filt) const
+{
+	assert (is_active (side));
+	const auto     val_ref = _node_arr [1]._val [side];
+	assert (pos >= 0);
+	assert (pos < _node_arr [1]._nbr [side]);
+
+	// Finds the block. The cluster side is browsed backward.
+	Index          node_pos = 1;
+	while (node_pos < _nbr_leaves)
+	{
+		const auto     first = node_pos * 2 + Index (side);
+		const auto &   node  = _node_arr [first];
+		if (node._val [side] == val_ref)
+		{
+			if (pos < node._nbr [side])
+			{
+				node_pos = first;
+				continue;
+			}
+			pos -= node._nbr [side];
+		}
+		node_pos = first ^ 1;
+	}
+
+	// Then the pixel within the block
+	const int      blk_len = 1 << _blk_len_cur_l2;
+	const auto     idx_beg = (node_pos - _nbr_leaves) << _blk_len_cur_l2;
+	for (int k = 0; k < blk_len; ++k)
+	{
+		const auto     idx = idx_beg + Index ((side != 0) ? blk_len - 1 - k : k);
+		if (pat.at (idx) == side && filt.at (idx) == val_ref)
+		{
+			if (pos == 0)
+			{
+				return idx;
+			}
+			-- pos;
+		}
+	}
+	assert (false);
+
+	return idx_beg;
+}
+
+
+
+void	VoidAndCluster::SearchTree::add_val (int side, Index blk, SampleType val)
+{
+	auto &         leaf = _node_arr [_nbr_leaves + blk];
+	auto &         ext  = leaf._val [side];
+	if (is_before (side, val, ext))
+	{
+		ext = val;
+		leaf._nbr [side] = 1;
+	}
+	else if (val == ext)
+	{
+		++ leaf._nbr [side];
+	}
+}
+
+
+
+// pat and filt should already reflect the removal, in case the block has to
+// be scanned again.
+void	VoidAndCluster::SearchTree::remove_val (int side, Index blk, SampleType val, const Monochrome &pat, const Filtered &filt)
+{
+	auto &         leaf = _node_arr [_nbr_leaves + blk];
+	if (val == leaf._val [side])
+	{
+		if (leaf._nbr [side] > 1)
+		{
+			-- leaf._nbr [side];
+		}
+		else
+		{
+			scan_side (side, blk, pat, filt);
+		}
+	}
+}
+
+
+
+// Two branchless passes: extremum first, then the ties.
+void	VoidAndCluster::SearchTree::scan_side (int side, Index blk, const Monochrome &pat, const Filtered &filt)
+{
+	const int      blk_len = 1 << _blk_len_cur_l2;
+	const auto     idx_beg = blk << _blk_len_cur_l2;
+	const auto *   pat_ptr = &pat.at (idx_beg);
+	const auto *   flt_ptr = &filt.at (idx_beg);
+	const auto     neutral = get_neutral (side);
+
+	auto           ext     = neutral;
+	for (int k = 0; k < blk_len; ++k)
+	{
+		// Pixels of the other colour are replaced with the neutral value
+		const auto     msk = SampleType (pat_ptr [k] ^ side) - 1;
+		const auto     val = (flt_ptr [k] & msk) | (neutral & ~msk);
+		ext = (side != 0) ? std::max (ext, val) : std::min (ext, val);
+	}
+
+	int32_t        nbr     = 0;
+	for (int k = 0; k < blk_len; ++k)
+	{
+		nbr += int32_t (pat_ptr [k] == side) & int32_t (flt_ptr [k] == ext);
+	}
+
+	auto &         leaf    = _node_arr [_nbr_leaves + blk];
+	leaf._val [side] = ext;
+	leaf._nbr [side] = nbr;
+}
+
+
+
+// Returns true if the node has been modified
+bool	VoidAndCluster::SearchTree::update_node (Index pos)
+{
+	const auto &   c0   = _node_arr [pos * 2    ];
+	const auto &   c1   = _node_arr [pos * 2 + 1];
+	auto &         node = _node_arr [pos];
+	bool           chg_flag = false;
+	for (int side = _side_beg; side < _side_end; ++side)
+	{
+		const auto     v0  = c0._val [side];
+		const auto     v1  = c1._val [side];
+		const auto     ext = is_before (side, v1, v0) ? v1 : v0;
+		const auto     nbr =
+			  ((v0 == ext) ? c0._nbr [side] : 0)
+			+ ((v1 == ext) ? c1._nbr [side] : 0);
+		chg_flag |= (ext != node._val [side] || nbr != node._nbr [side]);
+		node._val [side] = ext;
+		node._nbr [side] = nbr;
+	}
+
+	return chg_flag;
+}
+
+
+
 void	VoidAndCluster::create_kernel (int w, int h, double sigma)
 {
 	const auto     w2 = 1 << fstb::get_next_pow_2 (w);
@@ -152,6 +520,31 @@ void	VoidAndCluster::create_kernel (int w, int h, double sigma)
 
 
 
+// w and h are the pattern size. In aztec mode, the coefficients on the axes
+// are skipped, except the center.
+void	VoidAndCluster::fold_kernel (int w, int h)
+{
+	const int      kw2 = (_kernel._w - 1) / 2;
+	const int      kh2 = (_kernel._h - 1) / 2;
+	_kernel._fold_w = std::min (_kernel._w, w);
+	_kernel._fold_h = std::min (_kernel._h, h);
+	_kernel._fold.assign (size_t (_kernel._fold_w * _kernel._fold_h), 0);
+	for (int j = -kh2; j <= kh2; ++j)
+	{
+		for (int i = -kw2; i <= kw2; ++i)
+		{
+			if (! _aztec_flag || (i == 0) == (j == 0))
+			{
+				const int      fx = (i + kw2) & (w - 1);
+				const int      fy = (j + kh2) & (h - 1);
+				_kernel._fold [fy * _kernel._fold_w + fx] += _kernel._m (i, j);
+			}
+		}
+	}
+}
+
+
+
 void	VoidAndCluster::generate_initial_mat ()
 {
 	constexpr double  thr = 0.1;
@@ -198,16 +591,13 @@ void	VoidAndCluster::homogenize_initial_mat ()
 	Coord          c { 0, 0 };
 	Coord          v { 0, 0 };
 	uint32_t       count = 0;
-	std::vector <Coord> coord_arr;
 	do
 	{
-		_base.find_cluster (coord_arr);
-		c = pick_one (coord_arr, count);
+		c = _base.pick_cluster (count);
 		set_pix <0> (_base, c);
 		++ count;
 
-		_base.find_void (coord_arr);
-		v = pick_one (coord_arr, count);
+		v = _base.pick_void (count);
 		set_pix <1> (_base, v);
 		++ count;
 	}
@@ -219,7 +609,6 @@ void	VoidAndCluster::homogenize_initial_mat ()
 void	VoidAndCluster::filter_pat (PatState &state)
 {
 	state._pat_filt.clear ();
-	state._histo.clear ();
 
 	const int      w = state._pat.get_w ();
 	const int      h = state._pat.get_h ();
@@ -253,78 +642,67 @@ void	VoidAndCluster::filter_pat (PatState &state)
 				}
 			}
 			state._pat_filt (x, y) = sum;
-			const auto     index = state._pat_filt.encode_coord (x, y);
-			state._histo.insert (std::make_tuple (sum, index));
 		}
 	}
-}
-
 
-
-void	VoidAndCluster::PatState::find_cluster (std::vector <Coord> &pos_arr) const
-{
-	find_void_or_cluster <1> (pos_arr, _histo.rbegin (), _histo.rend ());
+	state._tree.init (state._pat, state._pat_filt);
 }
 
 
 
-void	VoidAndCluster::PatState::find_void (std::vector <Coord> &pos_arr) const
+// Ranks from rank_base - 1 down to 0, by removing the clusters
+void	VoidAndCluster::rank_down (MatrixWrap <Rank> &vnc, int rank_base)
 {
-	find_void_or_cluster <0> (pos_arr, _histo.begin (), _histo.end ());
+	PatState       state = _base;
+	state._tree.restrict_to_side (1);
+
+	int            rank = rank_base;
+	while (rank > 0)
+	{
+		-- rank;
+		const auto     c = state.pick_cluster (uint32_t (rank));
+		set_pix <0> (state, c);
+		vnc.at (c._x, c._y) = Rank (rank);
+	}
 }
 
 
 
-template <typename VoidAndCluster::Monochrome::DataType V, class IT>
-void VoidAndCluster::PatState::find_void_or_cluster (std::vector <Coord> &pos_arr, IT it_beg, IT it_end) const
+// Ranks from rank_base up to the pattern area - 1, by filling the voids
+void	VoidAndCluster::rank_up (MatrixWrap <Rank> &vnc, int rank_base)
 {
-	pos_arr.clear ();
+	PatState       state = _base;
+	state._tree.restrict_to_side (0);
 
-	auto           it = it_beg;
-	while (_pat.at (std::get <1> (*it)) != V)
+	const int      area = vnc.get_w () * vnc.get_h ();
+	int            rank = rank_base;
+	while (rank < area)
 	{
-		++ it;
-		assert (it != it_end);
+		const auto     v = state.pick_void (uint32_t (rank));
+		set_pix <1> (state, v);
+		vnc.at (v._x, v._y) = Rank (rank);
+		++ rank;
 	}
-	const auto     val_ref = std::get <0> (*it);
+}
 
-	do
-	{
-		const auto     val_tst = std::get <0> (*it);
-		if (val_tst != val_ref)
-		{
-			break;
-		}
-		const auto     idx = std::get <1> (*it);
-		if (_pat.at (idx) == V)
-		{
-			const auto     x = _pat_filt.decode_x (idx);
-			const auto     y = _pat_filt.decode_y (idx);
-			pos_arr.push_back ({ x, y });
-		}
 
-		++ it;
-	}
-	while (it != it_end);
 
-	assert (! pos_arr.empty ());
+VoidAndCluster::Coord	VoidAndCluster::PatState::pick_cluster (uint32_t seed) const
+{
+	const int      pos = pick_one (_tree.count_clusters (), seed);
+	const auto     idx = _tree.find_cluster (pos, _pat, _pat_filt);
+
+	return Coord { _pat.decode_x (idx), _pat.decode_y (idx) };
 }
 
 
 
-const VoidAndCluster::Coord &	VoidAndCluster::pick_one (std::vector <Coord> &pos_arr, uint32_t seed) const
+VoidAndCluster::Coord	VoidAndCluster::PatState::pick_void (uint32_t seed) const
 {
-	assert (! pos_arr.empty ());
+	const int      pos = pick_one (_tree.count_voids (), seed);
+	const auto     idx = _tree.find_void (pos, _pat, _pat_filt);
 
-	const auto     nbr_elt = int (pos_arr.size ());
-	if (nbr_elt == 1)
-	{
-		return pos_arr.front ();
-	}
-
-	const auto     pos = fstb::Hash::hash (seed) % nbr_elt;
-
-	return pos_arr [pos];
+	return Coord { _pat.decode_x (idx), _pat.decode_y (idx) };
 }
 
 
@@ -332,9 +710,14 @@ const VoidAndCluster::Coord &	VoidAndCluster::pick_one (std::vector <Coord> &pos
 template <typename VoidAndCluster::Monochrome::DataType V>
 void	VoidAndCluster::set_pix (PatState &state, Coord pos)
 {
-	assert (V != state._pat (pos._x, pos._y));
-
-	state._pat (pos._x, pos._y) = V;
+	const auto     index = state._pat.encode_coord (pos._x, pos._y);
+	assert (V != state._pat.at (index));
+
+	state._pat.at (index) = V;
+	state._tree.flip_pix (
+		index, (V != 0), state._pat_filt.at (index),
+		state._pat, state._pat_filt
+	);
 	if (V > 0)
 	{
 		apply_kernel (
@@ -347,6 +730,7 @@ void	VoidAndCluster::set_pix (PatState &state, Coord pos)
 			state, pos, [] (SampleType a, SampleType b) { return a - b; }
 		);
 	}
+	update_tree (state, pos);
 }
 
 
@@ -354,51 +738,66 @@ void	VoidAndCluster::set_pix (PatState &state, Coord pos)
 template <typename F>
 void	VoidAndCluster::apply_kernel (PatState &state, Coord pos, F op) const
 {
-	const int      kw2 = (_kernel._w - 1) / 2;
-	const int      kh2 = (_kernel._h - 1) / 2;
-
-	update_filtered (state, pos, op, _kernel._m.at (0, 0));
-	for (int j = 1; j <= kh2; ++j)
+	const int      w     = state._pat.get_w ();
+	const int      fw    = _kernel._fold_w;
+	const int      x_beg = state._pat.wrap_x (pos._x - (_kernel._w - 1) / 2);
+	const int      y_beg = pos._y - (_kernel._h - 1) / 2;
+	const int      len_1 = std::min (fw, w - x_beg);
+	const int      len_2 = fw - len_1;
+	for (int j = 0; j < _kernel._fold_h; ++j)
 	{
-		if (! _aztec_flag)
+		const int      y        = state._pat.wrap_y (y_beg + j);
+		const auto     base     = state._pat.encode_coord (0, y);
+		const auto *   coef_ptr = &_kernel._fold [j * fw];
+		state._tree.splat_seg (
+			base + x_beg, len_1, coef_ptr, op, state._pat, state._pat_filt
+		);
+		if (len_2 > 0)
 		{
-			const auto     vx = _kernel._m.at (j, 0);
-			const auto     vy = _kernel._m.at (0, j);
-			update_filtered (state, { pos._x + j, pos._y     }, op, vx);
-			update_filtered (state, { pos._x - j, pos._y     }, op, vx);
-			update_filtered (state, { pos._x    , pos._y + j }, op, vy);
-			update_filtered (state, { pos._x    , pos._y - j }, op, vy);
+			state._tree.splat_seg (
+				base, len_2, coef_ptr + len_1, op, state._pat, state._pat_filt
+			);
 		}
-		for (int i = 1; i <= kw2; ++i)
+	}
+}
+
+
+
+// Propagates the leaf changes caused by a kernel splat centered on pos,
+// one row segment at a time.
+void	VoidAndCluster::update_tree (PatState &state, Coord pos) const
+{
+	const int      w     = state._pat.get_w ();
+	const int      len   = _kernel._fold_w;
+	const int      x_beg = state._pat.wrap_x (pos._x - (_kernel._w - 1) / 2);
+	const int      y_beg = pos._y - (_kernel._h - 1) / 2;
+	const int      len_1 = std::min (len, w - x_beg);
+	const int      len_2 = len - len_1;
+	for (int j = 0; j < _kernel._fold_h; ++j)
+	{
+		const int      y    = state._pat.wrap_y (y_beg + j);
+		const auto     base = state._pat.encode_coord (0, y);
+		state._tree.propagate (base + x_beg, base + x_beg + len_1);
+		if (len_2 > 0)
 		{
-			const auto     vk = _kernel._m.at (i, j);
-			update_filtered (state, { pos._x + i, pos._y + j }, op, vk);
-			update_filtered (state, { pos._x - i, pos._y + j }, op, vk);
-			update_filtered (state, { pos._x + i, pos._y - j }, op, vk);
-			update_filtered (state, { pos._x - i, pos._y - j }, op, vk);
+			state._tree.propagate (base, base + len_2);
 		}
 	}
 }
 
 
 
-template <typename F>
-void	VoidAndCluster::update_filtered (PatState &state, Coord pos, F op, SampleType delta) const
-{
-	const auto     x       = state._pat_filt.wrap_x (pos._x);
-	const auto     y       = state._pat_filt.wrap_y (pos._y);
-	const auto     index   = state._pat_filt.encode_coord (x, y);
-
-	const auto     val_old = state._pat_filt.at (index);
-	const auto     key_old = std::make_tuple (val_old, index);
-	const auto     it_old  = state._histo.find (key_old);
-	assert (it_old != state._histo.end ());
-	state._histo.erase (it_old);
-
-	const auto     val_new = op (val_old, delta);
-	state._pat_filt.at (index) = val_new;
-	const auto     key_new = std::make_tuple (val_new, index);
-	state._histo.insert (key_new);
+// Returns a position in [0 ; nbr_elt - 1]
+int	VoidAndCluster::pick_one (int nbr_elt, uint32_t seed)
+{
+	assert (nbr_elt > 0);
+
+	if (nbr_elt == 1)
+	{
+		return 0;
+	}
+
+	return int (fstb::Hash::hash (seed) % uint32_t (nbr_elt));
 }
 
 
@@ -17,10 +17,21 @@ location before testing it. This optimisation is particularly interesting for
 larger kernels, the complexity component caused by the filtering goes from
 O(s_k^2) to O(1), s_k being the kernel size.
 
-- An ordered list (std::set) is also maintained, using the filtered values
-as key. The matrix update is more costly but peaking the minimum or maximum
-is achievable in O(1) instead of O(s_p^2), s_p being the pattern size. This
-is a huge gain for large patterns.
+- The filtered values are also summarised in a binary tree giving the minimum
+of the white pixels (void) and the maximum of the black pixels (cluster),
+with the number of pixels reaching them. The elected pixel is found among the
+ties by descending the tree in O(log(s_p)), s_p being the pattern size,
+without listing them. After a kernel splat, the leaves are updated
+incrementally and the ancestors only as long as they change. This is much
+faster than the former ordered list (std::set) for large patterns, and gives
+the same results.
+
+- The kernel splat is applied one row segment at a time and each block leaf
+is updated once per segment, without branches on the pixel colours. When
+ranking, only the side searched for is maintained in the tree.
+
+- Optionally, the ranks below and above the initial pattern are computed in
+parallel, as they are independent.
 
 *** TO DO: implement:
 Hakan Ancin, Anoop K. Bhattacharjya, Joseph Shou-Pyng Shu,
@@ -56,9 +67,8 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 #include <cstdint>
 
+#include <array>
 #include <memory>
-#include <set>
-#include <tuple>
 #include <vector>
 
 
@@ -81,6 +91,7 @@ public:
 	virtual			~VoidAndCluster () {}
 
 	void           set_aztec_mode (bool flag);
+	void           set_mt_mode (bool flag);
 	void           create_matrix (MatrixWrap <Rank> &vnc);
 
 
@@ -116,8 +127,54 @@ private:
 	typedef MatrixWrap <SampleType> Filtered;
 
 	typedef typename Filtered::PosType Index;
-	typedef std::tuple <SampleType, Index> HistoKey;
-	typedef std::set <HistoKey> Histogram;
+
+	// Complete binary tree over blocks of consecutive pixel indexes. For each
+	// subtree, a node holds the minimum filtered value of the white pixels
+	// (void side) and the maximum of the black pixels (cluster side), as well
+	// as the number of pixels reaching them. Pixels within a block are
+	// scanned linearly, keeping the tree small enough to stay in the cache.
+	// Block nodes are updated incrementally, a full scan is required only
+	// when the last pixel reaching an extremum moves away from it.
+	class SearchTree
+	{
+	public:
+		void           init (const Monochrome &pat, const Filtered &filt);
+		void           restrict_to_side (int side);
+		inline bool    is_active (int side) const;
+		inline void    flip_pix (Index idx, bool black_flag, SampleType val, const Monochrome &pat, const Filtered &filt);
+		template <typename F>
+		inline void    splat_seg (Index beg, int len, const SampleType *coef_ptr, F op, const Monochrome &pat, Filtered &filt);
+		void           propagate (Index beg, Index end);
+		inline int     count_voids () const;
+		inline int     count_clusters () const;
+		Index          find_void (int pos, const Monochrome &pat, const Filtered &filt) const;
+		Index          find_cluster (int pos, const Monochrome &pat, const Filtered &filt) const;
+	private:
+		static constexpr int _blk_len_l2 = 5;
+		class Node
+		{
+		public:
+			std::array <SampleType, 2> // [0] = void side, [1] = cluster side
+			               _val;
+			std::array <int32_t, 2>
+			               _nbr;
+		};
+		static inline bool
+		               is_before (int side, SampleType a, SampleType b);
+		static inline SampleType
+		               get_neutral (int side);
+		Index          find_top (int side, int pos, const Monochrome &pat, const Filtered &filt) const;
+		inline void    add_val (int side, Index blk, SampleType val);
+		inline void    remove_val (int side, Index blk, SampleType val, const Monochrome &pat, const Filtered &filt);
+		void           scan_side (int side, Index blk, const Monochrome &pat, const Filtered &filt);
+		inline bool    update_node (Index pos);
+		std::vector <Node>         // Root at 1, one leaf per block from _nbr_leaves
+		               _node_arr;
+		Index          _nbr_leaves = 0; // Power of 2
+		int            _blk_len_cur_l2 = 0;
+		int            _side_beg   = 0; // Maintained sides: [_side_beg ; _side_end[
+		int            _side_end   = 2;
+	};
 
 	class Kernel
 	{
@@ -125,40 +182,48 @@ private:
 		KernelData     _m;
 		int            _w = 0; // Kernel width, odd. 0 = not initialized
 		int            _h = 0; // Kernel height, odd. 0 = not initialized
+
+		// Coefficients folded on the pattern size, so a splat reaches each
+		// pixel only once. _fold_w * _fold_h, in reading order, starting at
+		// the top-left corner of the kernel.
+		std::vector <SampleType>
+		               _fold;
+		int            _fold_w = 0;
+		int            _fold_h = 0;
 	};
 
 	class PatState
 	{
 	public:
-		void           find_cluster (std::vector <Coord> &pos_arr) const;
-		void           find_void (std::vector <Coord> &pos_arr) const;
-		template <typename Monochrome::DataType V, class IT>
-		void           find_void_or_cluster (std::vector <Coord> &pos_arr, IT it_beg, IT it_end) const;
+		Coord          pick_cluster (uint32_t seed) const;
+		Coord          pick_void (uint32_t seed) const;
 		Monochrome     _pat;
 		Filtered       _pat_filt;
-		Histogram      _histo;
+		SearchTree     _tree;
 	};
 
 	void           create_kernel (int w, int h, double sigma);
+	void           fold_kernel (int w, int h);
 	void           generate_initial_mat ();
 	void           homogenize_initial_mat ();
 	void           filter_pat (PatState &state);
+	void           rank_down (MatrixWrap <Rank> &vnc, int rank_base);
+	void           rank_up (MatrixWrap <Rank> &vnc, int rank_base);
 
-	const Coord &  pick_one (std::vector <Coord> &pos_arr, uint32_t seed) const;
 	template <typename Monochrome::DataType V>
 	void           set_pix (PatState &state, Coord pos);
 	template <typename F>
 	inline void    apply_kernel (PatState &state, Coord pos, F op) const;
-	template <typename F>
-	inline void    update_filtered (PatState &state, Coord pos, F op, SampleType delta) const;
+	void           update_tree (PatState &state, Coord pos) const;
 
+	static int     pick_one (int nbr_elt, uint32_t seed);
 	static int     count_elt (const Monochrome &m, int val);
 
 	Kernel         _kernel;
 	PatState       _base;
-	PatState       _cur;
 
 	bool           _aztec_flag = false;
+	bool           _mt_flag    = false;
 
 
 
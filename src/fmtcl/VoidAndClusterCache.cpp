@@ -0,0 +1,156 @@
+/*****************************************************************************
+
+        VoidAndClusterCache.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/VoidAndClusterCache.h"
+#include "fmtcl/VoidAndClusterPrecalc.h"
+#include "fstb/fnc.h"
+
+#include <array>
+
+#include <cassert>
+
+
+
+namespace fmtcl
+{
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+VoidAndClusterCache &	VoidAndClusterCache::use_instance ()
+{
+	static VoidAndClusterCache instance;
+
+	return instance;
+}
+
+
+
+// size must be a power of 2 in [4 ; 1024]
+// The returned pattern is never modified afterwards and can be shared.
+VoidAndClusterCache::PatternSPtr	VoidAndClusterCache::use_pattern (int size, bool aztec_flag)
+{
+	assert (size >= 4);
+	assert (size <= 1024);
+	assert (fstb::is_pow_2 (size));
+
+	return _cache.use_data (
+		Key { size, aztec_flag },
+		[size, aztec_flag] ()
+		{
+			auto           pat_sptr = std::make_shared <Pattern> (size, size);
+			decode_precalc (*pat_sptr, size, aztec_flag);
+			return PatternSPtr (pat_sptr);
+		}
+	);
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+VoidAndClusterCache::VoidAndClusterCache ()
+:	_cache (true)
+{
+	// Nothing
+}
+
+
+
+void	VoidAndClusterCache::decode_precalc (Pattern &pat, int size, bool aztec_flag)
+{
+	assert (pat.get_w () == size);
+	assert (pat.get_h () == size);
+
+	const std::array <const uint64_t *, 10+1> std_arr =
+	{
+		nullptr,
+		nullptr,
+		VoidAndClusterPrecalc::_pat_2_std.data (),
+		VoidAndClusterPrecalc::_pat_3_std.data (),
+		VoidAndClusterPrecalc::_pat_4_std.data (),
+		VoidAndClusterPrecalc::_pat_5_std.data (),
+		VoidAndClusterPrecalc::_pat_6_std.data (),
+		VoidAndClusterPrecalc::_pat_7_std.data (),
+		VoidAndClusterPrecalc::_pat_8_std.data (),
+		VoidAndClusterPrecalc::_pat_9_std.data (),
+		VoidAndClusterPrecalc::_pat_10_std.data ()
+	};
+	const std::array <const uint64_t *, 10+1> alt_arr =
+	{
+		nullptr,
+		nullptr,
+		VoidAndClusterPrecalc::_pat_2_alt.data (),
+		VoidAndClusterPrecalc::_pat_3_alt.data (),
+		VoidAndClusterPrecalc::_pat_4_alt.data (),
+		VoidAndClusterPrecalc::_pat_5_alt.data (),
+		VoidAndClusterPrecalc::_pat_6_alt.data (),
+		VoidAndClusterPrecalc::_pat_7_alt.data (),
+		VoidAndClusterPrecalc::_pat_8_alt.data (),
+		VoidAndClusterPrecalc::_pat_9_alt.data (),
+		VoidAndClusterPrecalc::_pat_10_alt.data ()
+	};
+	const auto     size_l2 = fstb::get_prev_pow_2 (uint32_t (size));
+	assert (size_l2 < int (std_arr.size ()));
+	const auto     src_ptr =
+		(aztec_flag) ? alt_arr [size_l2] : std_arr [size_l2];
+	assert (src_ptr != nullptr);
+
+	constexpr int  block_size = 8;
+	int            pos_block  = 0;
+	int            pos_byte   = 0;
+	uint64_t       val        = 0;
+	for (int y = 0; y < size; ++y)
+	{
+		for (int x = 0; x < size; ++x)
+		{
+			if (pos_byte == 0)
+			{
+				val = src_ptr [pos_block];
+				++ pos_block;
+			}
+			pat (x, y) = uint8_t (val >> (pos_byte * 8));
+			pos_byte = (pos_byte + 1) & (block_size - 1);
+		}
+	}
+}
+
+
+
+}	// namespace fmtcl
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
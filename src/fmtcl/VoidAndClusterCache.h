@@ -0,0 +1,117 @@
+/*****************************************************************************
+
+        VoidAndClusterCache.h
+        Author: Laurent de Soras, 2024
+
+Process-wide storage for the void-and-cluster dither patterns. A pattern is
+decoded only once per process from the precalculated tables, which cover all
+the sizes from 4 to 1024 in both modes.
+
+This is a singleton, use use_instance() to access it. All the public
+functions are thread-safe.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://sam.zoy.org/wtfpl/COPYING for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fmtcl_VoidAndClusterCache_HEADER_INCLUDED)
+#define fmtcl_VoidAndClusterCache_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/MatrixWrap.h"
+#include "fmtcl/SharedCache.h"
+
+#include <memory>
+#include <utility>
+
+#include <cstdint>
+
+
+
+namespace fmtcl
+{
+
+
+
+class VoidAndClusterCache
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	// Levels in [0 ; 255], rank * 256 / area
+	typedef MatrixWrap <uint8_t> Pattern;
+	typedef std::shared_ptr <const Pattern> PatternSPtr;
+
+	static VoidAndClusterCache &
+	               use_instance ();
+
+	PatternSPtr    use_pattern (int size, bool aztec_flag);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	// Pattern size and aztec flag
+	typedef std::pair <int, bool> Key;
+
+	               VoidAndClusterCache ();
+
+	static void    decode_precalc (Pattern &pat, int size, bool aztec_flag);
+
+	SharedCache <Key, Pattern>             // Patterns are never released
+	               _cache;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               VoidAndClusterCache (const VoidAndClusterCache &other) = delete;
+	               VoidAndClusterCache (VoidAndClusterCache &&other)      = delete;
+	VoidAndClusterCache &
+	               operator = (const VoidAndClusterCache &other)        = delete;
+	VoidAndClusterCache &
+	               operator = (VoidAndClusterCache &&other)             = delete;
+	bool           operator == (const VoidAndClusterCache &other) const = delete;
+	bool           operator != (const VoidAndClusterCache &other) const = delete;
+
+};	// class VoidAndClusterCache
+
+
+
+}	// namespace fmtcl
+
+
+
+//#include "fmtcl/VoidAndClusterCache.hpp"
+
+
+
+#endif	// fmtcl_VoidAndClusterCache_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
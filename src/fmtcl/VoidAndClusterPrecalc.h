@@ -24,5 +24,6 @@ static const std::array <uint64_t, 64*64 / 8> _pat_6_alt;
 static const std::array <uint64_t, 128*128 / 8> _pat_7_alt;
 static const std::array <uint64_t, 256*256 / 8> _pat_8_alt;
 static const std::array <uint64_t, 512*512 / 8> _pat_9_alt;
+static const std::array <uint64_t, 1024*1024 / 8> _pat_10_alt;
 };
 }
@@ -174,7 +174,7 @@ double	compute_pix_scale (const PicFmt &fmt, int plane_index)
 
 	double         scale = 1.0;
 
-	if (fmt._sf != SplFmt_FLOAT)
+	if (! SplFmt_is_float (fmt._sf))
 	{
 		const int      bps_m8 = fmt._res - 8;
 		if (fmt._full_flag || plane_index == 3)
@@ -205,7 +205,7 @@ double	get_pix_min (const PicFmt &fmt, int plane_index)
 	double         add_val     = 0;
 	const bool     chroma_flag = is_chroma_plane (fmt._col_fam, plane_index);
 
-	if (fmt._sf == SplFmt_FLOAT)
+	if (SplFmt_is_float (fmt._sf))
 	{
 		if (chroma_flag)
 		{
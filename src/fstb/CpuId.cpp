@@ -85,6 +85,7 @@ CpuId::CpuId ()
 		_avx2_flag    = ((ebx & (1L <<  5)) != 0);
 		_bmi2_flag    = ((ebx & (1L <<  8)) != 0);
 		_avx512f_flag = ((ebx & (1L << 16)) != 0);
+		_avx512bw_flag = ((ebx & (1L << 30)) != 0);
 	}
 
 	// Extended Processor Info and Feature Bits
@@ -68,6 +68,7 @@ public:
 	bool           _avx_flag     = false;
 	bool           _avx2_flag    = false;
 	bool           _avx512f_flag = false;
+	bool           _avx512bw_flag = false; // Byte and word instructions
 	bool           _f16c_flag    = false;  // Half-precision FP
 	bool           _cx16_flag    = false;  // CMPXCHG16B
 	bool           _abm_flag     = false;  // POPCNT + LZCNT
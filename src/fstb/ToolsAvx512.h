@@ -0,0 +1,107 @@
+/*****************************************************************************
+
+        ToolsAvx512.h
+        Author: Laurent de Soras, 2024
+
+Requires AVX-512F and AVX-512BW.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (fstb_ToolsAvx512_HEADER_INCLUDED)
+#define	fstb_ToolsAvx512_HEADER_INCLUDED
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4250)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+
+// GCC 12 reports the self-initialised variables of the _mm512_undefined_*
+// functions as uninitialized (GCC bug 105593). They are used internally by
+// most AVX-512 intrinsics, whatever the initialisation of their arguments,
+// so the warnings are disabled for the intrinsic headers only.
+// AVX-512 code should include this file before any other <immintrin.h>.
+#if defined (__GNUC__) && ! defined (__clang__)
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wuninitialized"
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined (__GNUC__) && ! defined (__clang__)
+	#pragma GCC diagnostic pop
+#endif
+
+
+
+namespace fstb
+{
+
+
+
+class ToolsAvx512
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static fstb_FORCEINLINE void
+	               mac_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src, __m512i coef);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               ToolsAvx512 ()                               = delete;
+	               ToolsAvx512 (const ToolsAvx512 &other)       = delete;
+	virtual        ~ToolsAvx512 ()                              = delete;
+	ToolsAvx512 &  operator = (const ToolsAvx512 &other)        = delete;
+	bool           operator == (const ToolsAvx512 &other) const = delete;
+	bool           operator != (const ToolsAvx512 &other) const = delete;
+
+};	// class ToolsAvx512
+
+
+
+}	// namespace fstb
+
+
+
+#include "fstb/ToolsAvx512.hpp"
+
+
+
+#endif	// fstb_ToolsAvx512_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
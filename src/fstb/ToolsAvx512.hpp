@@ -1,7 +1,7 @@
 /*****************************************************************************
 
-        ConvStep.cpp
-        Author: Laurent de Soras, 2014
+        ToolsAvx512.hpp
+        Author: Laurent de Soras, 2024
 
 --- Legal stuff ---
 
@@ -9,28 +9,22 @@ This program is free software. It comes without any warranty, to
 the extent permitted by applicable law. You can redistribute it
 and/or modify it under the terms of the Do What The Fuck You Want
 To Public License, Version 2, as published by Sam Hocevar. See
-http://sam.zoy.org/wtfpl/COPYING for more details.
+http://www.wtfpl.net/ for more details.
 
 *Tab=3***********************************************************************/
 
 
 
-#if defined (_MSC_VER)
-	#pragma warning (1 : 4130 4223 4705 4706)
-	#pragma warning (4 : 4355 4786 4800)
-#endif
+#if ! defined (fstb_ToolsAvx512_CODEHEADER_INCLUDED)
+#define	fstb_ToolsAvx512_CODEHEADER_INCLUDED
 
 
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
-#include "fmtc/ConvStep.h"
 
-#include <cassert>
 
-
-
-namespace fmtc
+namespace fstb
 {
 
 
@@ -39,6 +33,23 @@ namespace fmtc
 
 
 
+// Same as ToolsAvx2::mac_s16_s16_s32(), on each 128-bit lane. The results
+// are in the same order, so _mm512_packs_epi32 (dst0, dst1) gives them back
+// in the source order.
+void	ToolsAvx512::mac_s16_s16_s32 (__m512i &dst0, __m512i &dst1, __m512i src, __m512i coef)
+{
+	const __m512i  hi = _mm512_mulhi_epi16 (src, coef);
+	const __m512i  lo = _mm512_mullo_epi16 (src, coef);
+
+	const __m512i  res0 = _mm512_unpacklo_epi16 (lo, hi);
+	const __m512i  res1 = _mm512_unpackhi_epi16 (lo, hi);
+
+	dst0 = _mm512_add_epi32 (dst0, res0);
+	dst1 = _mm512_add_epi32 (dst1, res1);
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -47,7 +58,11 @@ namespace fmtc
 
 
 
-}	// namespace fmtc
+}	// namespace fstb
+
+
+
+#endif	// fstb_ToolsAvx512_CODEHEADER_INCLUDED
 
 
 
@@ -1547,7 +1547,7 @@ Vf32	Vf32::loadu_part (const MEM *ptr, int n) noexcept
 			_mm_unpacklo_ps (_mm_load_ss (f_ptr), _mm_load_ss (f_ptr + 1)),
 # endif
 			_mm_load_ss (f_ptr + 2),
-			(0<<0) + (1<<2) + (2<<4)
+			(0<<0) + (1<<2) + (0<<4)
 		);
 	default:
 		// Keeps the compiler happy with (un)initialisation
@@ -56,6 +56,7 @@ const char * __stdcall	AvisynthPluginInit3 (::IScriptEnvironment *env_ptr, const
 		"[fulls]b"   "[fulld]b" "[dmode]i"       "[ampo]f"     //  4
 		"[ampn]f"    "[dyn]b"   "[staticnoise]b" "[cpuopt]i"   //  8
 		"[patsize]i" "[tpdfo]b" "[tpdfn]b"       "[corplane]b" // 12
+		"[ed3p]b"                                              // 16
 		, &main_avs_create <fmtcavs::Bitdepth>, nullptr
 	);
 	env_ptr->AddFunction (fmtcavs_MATRIX,
@@ -70,10 +71,10 @@ const char * __stdcall	AvisynthPluginInit3 (::IScriptEnvironment *env_ptr, const
 		, &main_avs_create <fmtcavs::Matrix2020CL>, nullptr
 	);
 	env_ptr->AddFunction (fmtcavs_PRIMARIES,
-		"c"      "[rs].+"   "[gs].+"   "[bs].+"    // 0
-		"[ws].+" "[rd].+"   "[gd].+"   "[bd].+"    // 4
-		"[wd].+" "[prims]s" "[primd]s" "[wconv]b"  // 8
-		"[cpuopt]i"                                // 12
+		"c"         "[rs].+"    "[gs].+"    "[bs].+"   // 0
+		"[ws].+"    "[rd].+"    "[gd].+"    "[bd].+"   // 4
+		"[wd].+"    "[prims]s"  "[primd]s"  "[wconv]b" // 8
+		"[cpuopt]i" "[transs]s" "[transd]s" "[lut3d]i" // 12
 		, &main_avs_create <fmtcavs::Primaries>, nullptr
 	);
 	env_ptr->AddFunction (fmtcavs_RESAMPLE,
@@ -100,6 +101,7 @@ const char * __stdcall	AvisynthPluginInit3 (::IScriptEnvironment *env_ptr, const
 		"[blacklvl]f" "[sceneref]b" "[lb]f"      "[lw]f"     // 12
 		"[lws]f"      "[lwd]f"      "[ambient]f" "[match]i"  // 16
 		"[gy]b"       "[debug]i"    "[sig_c]f"   "[sig_t]f"  // 20
+		"[direct]b"                                          // 24
 		, &main_avs_create <fmtcavs::Transfer>, nullptr
 	);
 
@@ -16,9 +16,7 @@ http://sam.zoy.org/wtfpl/COPYING for more details.
 
 
 #include "fmtc/Bitdepth.h"
-#if 0
-	#include "fmtc/Convert.h"
-#endif
+#include "fmtc/Convert.h"
 #include "fmtc/Matrix.h"
 #include "fmtc/Matrix2020CL.h"
 #include "fmtc/NativeToStack16.h"
@@ -335,6 +333,8 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit2 (::VSPlugin *plugin_ptr, const ::V
 		"tpdfo:int:opt;"
 		"tpdfn:int:opt;"
 		"corplane:int:opt;"
+		"mt:int:opt;"
+		"ed3p:int:opt;"
 	,	"clip:vnode;"
 	,	&vsutl::Redirect <fmtc::Bitdepth>::create, nullptr, plugin_ptr
 	);
@@ -364,6 +364,7 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit2 (::VSPlugin *plugin_ptr, const ::V
 		"debug:int:opt;"
 		"sig_c:float:opt;"
 		"sig_t:float:opt;"
+		"direct:int:opt;"
 	,	"clip:vnode;"
 	,	&vsutl::Redirect <fmtc::Transfer>::create, nullptr, plugin_ptr
 	);
@@ -382,11 +383,13 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit2 (::VSPlugin *plugin_ptr, const ::V
 		"primd:data:opt;"
 		"wconv:int:opt;"
 		"cpuopt:int:opt;"
+		"transs:data:opt;"
+		"transd:data:opt;"
+		"lut3d:int:opt;"
 	,	"clip:vnode;"
 	,	&vsutl::Redirect <fmtc::Primaries>::create, nullptr, plugin_ptr
 	);
 
-#if 0
 	api_ptr->registerFunction ("convert",
 		"clip:vnode;"
 		"w:int:opt;"
@@ -406,14 +409,21 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit2 (::VSPlugin *plugin_ptr, const ::V
 		"impulsev:float[]:opt;"
 		"taps:int[]:opt;"
 		"tapsh:int[]:opt;"
-		"tapsh:int[]:opt;"
+		"tapsv:int[]:opt;"
 		"a1:float[]:opt;"
 		"a2:float[]:opt;"
 		"a3:float[]:opt;"
+		"a1h:float[]:opt;"
+		"a2h:float[]:opt;"
+		"a3h:float[]:opt;"
+		"a1v:float[]:opt;"
+		"a2v:float[]:opt;"
+		"a3v:float[]:opt;"
 		"kovrspl:int[]:opt;"
 		"fh:float[]:opt;"
 		"fv:float[]:opt;"
 		"cnorm:int[]:opt;"
+		"total:float[]:opt;"
 		"totalh:float[]:opt;"
 		"totalv:float[]:opt;"
 		"invks:int[]:opt;"
@@ -433,27 +443,32 @@ VS_EXTERNAL_API (void) VapourSynthPluginInit2 (::VSPlugin *plugin_ptr, const ::V
 		"ampn:float:opt;"
 		"dyn:int:opt;"
 		"staticnoise:int:opt;"
+		"patsize:int:opt;"
+		"corplane:int:opt;"
+		"tpdfo:int:opt;"
+		"tpdfn:int:opt;"
 		"cplace:data:opt;"
 		"mat:data:opt;"
-		"coef:float[]:opt;"
 		"interlaced:int:opt;"
 		"tff:int:opt;"
-		"useflt:int:opt;"
 		"fulls:int:opt;"
 		"cplaces:data:opt;"
 		"mats:data:opt;"
 		"fulld:int:opt;"
 		"cplaced:data:opt;"
 		"matd:data:opt;"
-		"transs:data[]:opt;"
-		"transd:data[]:opt;"
-		"gcor:float:opt;"
+		"transs:data:opt;"
+		"transd:data:opt;"
+		"gcors:float:opt;"
+		"gcord:float:opt;"
 		"cont:float:opt;"
+		"prims:data:opt;"
+		"primd:data:opt;"
+		"wconv:int:opt;"
 		"cpuopt:int:opt;"
 	,	"clip:vnode;"
 	,	&vsutl::Redirect <fmtc::Convert>::create, nullptr, plugin_ptr
 	);
-#endif
 
 	api_ptr->registerFunction ("stack16tonative",
 		"clip:vnode;"
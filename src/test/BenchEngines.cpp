@@ -0,0 +1,995 @@
+/*****************************************************************************
+
+        BenchEngines.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/BitBltConv.h"
+#include "fmtcl/ContFirSpline36.h"
+#include "fmtcl/Dither.h"
+#include "fmtcl/FilterResize.h"
+#include "fmtcl/Frame.h"
+#include "fmtcl/GammaY.h"
+#include "fmtcl/Mat4.h"
+#include "fmtcl/Matrix2020CLProc.h"
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/ProcComp3Arg.h"
+#include "fmtcl/ResampleSpecPlane.h"
+#include "fmtcl/Scaler.h"
+#include "fmtcl/TransLut.h"
+#include "fmtcl/TransOpLinPow.h"
+#include "fstb/fnc.h"
+#include "test/BenchEngines.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <random>
+
+#include <cassert>
+#include <cstdio>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+int	BenchEngines::perform_bench (const char *filter_0, double min_dur)
+{
+	assert (filter_0 != nullptr);
+	assert (min_dur > 0);
+
+	Context        ctx;
+	ctx._filter  = filter_0;
+	ctx._min_dur = min_dur;
+
+	typedef int (*BenchFnc) (const Context &ctx);
+	class Engine
+	{
+	public:
+		const char *   _name_0;
+		BenchFnc       _fnc_ptr;
+	};
+	static const std::array <Engine, 8> engine_arr
+	{{
+		{ "Scaler"          , &bench_scaler        },
+		{ "FilterResize"    , &bench_filter_resize },
+		{ "MatrixProc"      , &bench_matrix        },
+		{ "Matrix2020CLProc", &bench_matrix_2020cl },
+		{ "TransLut"        , &bench_translut      },
+		{ "GammaY"          , &bench_gammay        },
+		{ "Dither"          , &bench_dither        },
+		{ "BitBltConv"      , &bench_bitblt        }
+	}};
+
+	int            ret_val = 0;
+
+	printf ("engine,config,path,width,height,mpix_s\n");
+	fflush (stdout);
+
+	for (const auto &engine : engine_arr)
+	{
+		if (   ret_val == 0
+		    && std::string (engine._name_0).find (ctx._filter) != std::string::npos)
+		{
+			ret_val = engine._fnc_ptr (ctx);
+		}
+	}
+
+	return ret_val;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+BenchEngines::PlaneBuf::PlaneBuf (int w, int h, fmtcl::SplFmt fmt, int res)
+:	_unit_sz (fmtcl::SplFmt_get_unit_size (fmt))
+{
+	assert (w > 0);
+	assert (h > 0);
+	assert (fmt >= 0);
+	assert (fmt < fmtcl::SplFmt_NBR_ELT);
+	assert (res > 0);
+
+	const int      lw = w * _unit_sz + _margin_b * 2;
+	_stride = (lw + 63) & -64;
+	_offset = _stride * _margin_l + _margin_b;
+	_buf.resize (size_t (_stride) * size_t (h + _margin_l * 2));
+
+	// Random content within the nominal range. Margins are filled too, so
+	// they don't contain denormals or NaN.
+	std::minstd_rand  gen;
+	const int      nbr_spl = int (_buf.size () / size_t (_unit_sz));
+	switch (fmt)
+	{
+	case fmtcl::SplFmt_FLOAT:
+		{
+			std::uniform_real_distribution <float> dist (0.f, 1.f);
+			float *        data_ptr = reinterpret_cast <float *> (_buf.data ());
+			for (int pos = 0; pos < nbr_spl; ++pos)
+			{
+				data_ptr [pos] = dist (gen);
+			}
+		}
+		break;
+	case fmtcl::SplFmt_INT16:
+		{
+			std::uniform_int_distribution <int> dist (0, (1 << res) - 1);
+			uint16_t *     data_ptr = reinterpret_cast <uint16_t *> (_buf.data ());
+			for (int pos = 0; pos < nbr_spl; ++pos)
+			{
+				data_ptr [pos] = uint16_t (dist (gen));
+			}
+		}
+		break;
+	case fmtcl::SplFmt_INT8:
+		{
+			std::uniform_int_distribution <int> dist (0, (1 << res) - 1);
+			for (int pos = 0; pos < nbr_spl; ++pos)
+			{
+				_buf [pos] = uint8_t (dist (gen));
+			}
+		}
+		break;
+	default:
+		assert (false);
+		break;
+	}
+}
+
+
+
+uint8_t *	BenchEngines::PlaneBuf::get_ptr () noexcept
+{
+	return _buf.data () + _offset;
+}
+
+
+
+ptrdiff_t	BenchEngines::PlaneBuf::get_stride () const noexcept
+{
+	return _stride;
+}
+
+
+
+ptrdiff_t	BenchEngines::PlaneBuf::get_stride_pix () const noexcept
+{
+	return _stride / _unit_sz;
+}
+
+
+
+// Vertical and direct horizontal resizing, single pass, 2/3 downscale.
+int	BenchEngines::bench_scaler (const Context &ctx)
+{
+	enum class Proc { F32_F32, I16_I16_FLT, I16_I16_INT };
+	class Config
+	{
+	public:
+		const char *   _name_0;
+		Proc           _proc;
+		fmtcl::SplFmt  _fmt;
+		int            _res;
+	};
+	static const std::array <Config, 3> config_arr
+	{{
+		{ "f32->f32"          , Proc::F32_F32    , fmtcl::SplFmt_FLOAT, 32 },
+		{ "i16_16->i16_16"    , Proc::I16_I16_FLT, fmtcl::SplFmt_INT16, 16 },
+		{ "i16_16->i16_16 int", Proc::I16_I16_INT, fmtcl::SplFmt_INT16, 16 }
+	}};
+
+	fmtcl::ContFirSpline36  kernel;
+
+	for (const auto &size : _size_arr)
+	{
+		for (int dir = 0; dir < 2; ++dir)
+		{
+			const bool     h_flag = (dir == 0);
+			const int      w_src  = size._w;
+			const int      h_src  = size._h;
+			const int      w_dst  = (h_flag) ? w_src * 2 / 3 : w_src;
+			const int      h_dst  = (h_flag) ? h_src : h_src * 2 / 3;
+			const int      len_src = (h_flag) ? w_src : h_src;
+			const int      len_dst = (h_flag) ? w_dst : h_dst;
+
+			for (const auto &config : config_arr)
+			{
+				PlaneBuf       src (w_src, h_src, config._fmt, config._res);
+				PlaneBuf       dst (w_dst, h_dst, config._fmt, config._res);
+				const bool     int_flag = (config._proc == Proc::I16_I16_INT);
+				const std::string cfg_name =
+					std::string ((h_flag) ? "h " : "v ") + config._name_0;
+
+				for (const auto &path : _path_arr)
+				{
+					fmtcl::CpuOptBase cpu;
+					if (! setup_path (cpu, path))
+					{
+						continue;
+					}
+
+					fmtcl::Scaler  scaler (
+						len_src, len_dst, 0, len_src, kernel, 1,
+						true, 1, 0, 0, 1, 0,
+						int_flag, cpu.has_sse2 (), cpu.has_avx2 (),
+						cpu.has_avx512bw ()
+					);
+					if (h_flag)
+					{
+						scaler.setup_h ();
+					}
+
+					const auto     s_f32 = reinterpret_cast <const float *> (src.get_ptr ());
+					const auto     s_i16 = reinterpret_cast <const uint16_t *> (src.get_ptr ());
+					const auto     d_f32 = reinterpret_cast <float *> (dst.get_ptr ());
+					const auto     d_i16 = reinterpret_cast <uint16_t *> (dst.get_ptr ());
+					const auto     ss    = src.get_stride_pix ();
+					const auto     ds    = dst.get_stride_pix ();
+
+					const double   mpix_s = measure (
+						ctx, int64_t (w_dst) * h_dst,
+						[&] ()
+						{
+							switch (config._proc)
+							{
+							case Proc::F32_F32:
+								if (h_flag)
+								{
+									scaler.process_plane_h_flt (d_f32, s_f32, ds, ss, h_dst, 0, w_dst);
+								}
+								else
+								{
+									scaler.process_plane_flt (d_f32, s_f32, ds, ss, w_dst, 0, h_dst);
+								}
+								break;
+							case Proc::I16_I16_FLT:
+								if (h_flag)
+								{
+									scaler.process_plane_h_flt (d_i16, s_i16, ds, ss, h_dst, 0, w_dst);
+								}
+								else
+								{
+									scaler.process_plane_flt (d_i16, s_i16, ds, ss, w_dst, 0, h_dst);
+								}
+								break;
+							case Proc::I16_I16_INT:
+								if (h_flag)
+								{
+									scaler.process_plane_h_int_i16_i16 (d_i16, s_i16, ds, ss, h_dst, 0, w_dst);
+								}
+								else
+								{
+									scaler.process_plane_int_i16_i16 (d_i16, s_i16, ds, ss, w_dst, 0, h_dst);
+								}
+								break;
+							}
+						}
+					);
+					print_result ("Scaler", cfg_name, path, w_dst, h_dst, mpix_s);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+// Full 2D resizing, 2/3 downscale and 3/2 upscale.
+int	BenchEngines::bench_filter_resize (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+		bool           _int_flag;
+	};
+	static const std::array <Config, 5> config_arr
+	{{
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32, false },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT16, 16, false },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT16, 16, true  },
+		{ fmtcl::SplFmt_INT8 ,  8, fmtcl::SplFmt_INT16, 16, true  },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_FLOAT, 32, false }
+	}};
+
+	fmtcl::ContFirSpline36  kernel;
+
+	for (const auto &size : _size_arr)
+	{
+		for (int ratio = 0; ratio < 2; ++ratio)
+		{
+			const bool     up_flag = (ratio != 0);
+			const int      w_src   = size._w;
+			const int      h_src   = size._h;
+			const int      w_dst   = (up_flag) ? w_src * 3 / 2 : w_src * 2 / 3;
+			const int      h_dst   = (up_flag) ? h_src * 3 / 2 : h_src * 2 / 3;
+
+			fmtcl::ResampleSpecPlane   spec;
+			spec._src_width        = w_src;
+			spec._src_height       = h_src;
+			spec._dst_width        = w_dst;
+			spec._dst_height       = h_dst;
+			spec._win_x            = 0;
+			spec._win_y            = 0;
+			spec._win_w            = w_src;
+			spec._win_h            = h_src;
+			spec._center_pos_src_h = 0;
+			spec._center_pos_src_v = 0;
+			spec._center_pos_dst_h = 0;
+			spec._center_pos_dst_v = 0;
+			spec._kernel_scale_h   = 1;
+			spec._kernel_scale_v   = 1;
+			spec._add_cst          = 0;
+			spec._kernel_hash_h    = 0;
+			spec._kernel_hash_v    = 0;
+
+			for (const auto &config : config_arr)
+			{
+				PlaneBuf       src (w_src, h_src, config._fmt_src, config._res_src);
+				PlaneBuf       dst (w_dst, h_dst, config._fmt_dst, config._res_dst);
+				const std::string cfg_name =
+					  std::string ((up_flag) ? "up " : "down ")
+					+ build_fmt_name (config._fmt_src, config._res_src) + "->"
+					+ build_fmt_name (config._fmt_dst, config._res_dst)
+					+ ((config._int_flag) ? " int" : "");
+
+				for (const auto &path : _path_arr)
+				{
+					fmtcl::CpuOptBase cpu;
+					if (! setup_path (cpu, path))
+					{
+						continue;
+					}
+
+					fmtcl::FilterResize  filter (
+						spec, kernel, kernel, true, 1, 1, 1,
+						config._fmt_src, config._res_src,
+						config._fmt_dst, config._res_dst,
+						config._int_flag, cpu.has_sse2 (), cpu.has_avx2 (),
+						cpu.has_avx512bw ()
+					);
+
+					const double   mpix_s = measure (
+						ctx, int64_t (w_dst) * h_dst,
+						[&] ()
+						{
+							filter.process_plane (
+								dst.get_ptr (), src.get_ptr (),
+								dst.get_stride (), src.get_stride (), false
+							);
+						}
+					);
+					print_result ("FilterResize", cfg_name, path, w_dst, h_dst, mpix_s);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+// 3x3 matrix on 3 planes, YCbCr to RGB style coefficients.
+int	BenchEngines::bench_matrix (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt;
+		int            _res;
+	};
+	static const std::array <Config, 4> config_arr
+	{{
+		{ fmtcl::SplFmt_INT8 ,  8 },
+		{ fmtcl::SplFmt_INT16, 10 },
+		{ fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_FLOAT, 32 }
+	}};
+
+	static const double  mat_content [fmtcl::Mat4::VECT_SIZE] [fmtcl::Mat4::VECT_SIZE] =
+	{
+		{ 1,  0     ,  1.5748, -0.7874 },
+		{ 1, -0.1873, -0.4681,  0.3277 },
+		{ 1,  1.8556,  0     , -0.9278 },
+		{ 0,  0     ,  0     ,  1      }
+	};
+	const fmtcl::Mat4 mat (mat_content);
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (const auto &config : config_arr)
+		{
+			std::vector <std::unique_ptr <PlaneBuf> > buf_arr;
+			for (int k = 0; k < fmtcl::ProcComp3Arg::_nbr_planes * 2; ++k)
+			{
+				buf_arr.emplace_back (
+					std::make_unique <PlaneBuf> (w, h, config._fmt, config._res)
+				);
+			}
+			fmtcl::ProcComp3Arg  arg;
+			arg._w = w;
+			arg._h = h;
+			for (int p = 0; p < fmtcl::ProcComp3Arg::_nbr_planes; ++p)
+			{
+				auto &         buf_s = *buf_arr [p];
+				auto &         buf_d = *buf_arr [p + fmtcl::ProcComp3Arg::_nbr_planes];
+				arg._src [p] = fmtcl::PlaneRO <> (buf_s.get_ptr (), int (buf_s.get_stride ()));
+				arg._dst [p] = fmtcl::Plane <> (buf_d.get_ptr (), int (buf_d.get_stride ()));
+			}
+			const bool     int_flag = (config._fmt != fmtcl::SplFmt_FLOAT);
+			const std::string cfg_name =
+				  build_fmt_name (config._fmt, config._res) + "->"
+				+ build_fmt_name (config._fmt, config._res);
+
+			for (const auto &path : _path_arr)
+			{
+				fmtcl::CpuOptBase cpu;
+				if (! setup_path (cpu, path))
+				{
+					continue;
+				}
+
+				fmtcl::MatrixProc mat_proc (
+					cpu.has_sse (), cpu.has_sse2 (), cpu.has_avx (), cpu.has_avx2 (),
+					cpu.has_avx512bw ()
+				);
+				const auto     err = mat_proc.configure (
+					mat, int_flag,
+					config._fmt, config._res, config._fmt, config._res, -1
+				);
+				if (err != fmtcl::MatrixProc::Err_OK)
+				{
+					printf ("*** MatrixProc: configuration failed (%d) ***\n", int (err));
+					return -1;
+				}
+
+				const double   mpix_s = measure (
+					ctx, int64_t (w) * h,
+					[&] ()
+					{
+						mat_proc.process (arg);
+					}
+				);
+				print_result ("MatrixProc", cfg_name, path, w, h, mpix_s);
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+int	BenchEngines::bench_matrix_2020cl (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+	};
+	static const std::array <Config, 2> config_arr
+	{{
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT16, 10 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32 }
+	}};
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (int dir = 0; dir < 2; ++dir)
+		{
+			const bool     to_yuv_flag = (dir == 0);
+
+			for (const auto &c : config_arr)
+			{
+				// Integer YCbCr is always on the small bitdepth side
+				const auto     fmt_src = (to_yuv_flag) ? c._fmt_src : c._fmt_dst;
+				const auto     res_src = (to_yuv_flag) ? c._res_src : c._res_dst;
+				const auto     fmt_dst = (to_yuv_flag) ? c._fmt_dst : c._fmt_src;
+				const auto     res_dst = (to_yuv_flag) ? c._res_dst : c._res_src;
+
+				std::vector <std::unique_ptr <PlaneBuf> > buf_arr;
+				for (int p = 0; p < fmtcl::ProcComp3Arg::_nbr_planes; ++p)
+				{
+					buf_arr.emplace_back (
+						std::make_unique <PlaneBuf> (w, h, fmt_src, res_src)
+					);
+				}
+				for (int p = 0; p < fmtcl::ProcComp3Arg::_nbr_planes; ++p)
+				{
+					buf_arr.emplace_back (
+						std::make_unique <PlaneBuf> (w, h, fmt_dst, res_dst)
+					);
+				}
+				fmtcl::ProcComp3Arg  arg;
+				arg._w = w;
+				arg._h = h;
+				for (int p = 0; p < fmtcl::ProcComp3Arg::_nbr_planes; ++p)
+				{
+					auto &         buf_s = *buf_arr [p];
+					auto &         buf_d = *buf_arr [p + fmtcl::ProcComp3Arg::_nbr_planes];
+					arg._src [p] = fmtcl::PlaneRO <> (buf_s.get_ptr (), int (buf_s.get_stride ()));
+					arg._dst [p] = fmtcl::Plane <> (buf_d.get_ptr (), int (buf_d.get_stride ()));
+				}
+				const std::string cfg_name =
+					  std::string ((to_yuv_flag) ? "rgb->yuv " : "yuv->rgb ")
+					+ build_fmt_name (fmt_src, res_src) + "->"
+					+ build_fmt_name (fmt_dst, res_dst);
+
+				for (const auto &path : _path_arr)
+				{
+					fmtcl::CpuOptBase cpu;
+					if (! setup_path (cpu, path))
+					{
+						continue;
+					}
+
+					fmtcl::Matrix2020CLProc mat_proc (
+						cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+					);
+					const auto     err = mat_proc.configure (
+						to_yuv_flag, fmt_src, res_src, fmt_dst, res_dst, false
+					);
+					if (err != fmtcl::Matrix2020CLProc::Err_OK)
+					{
+						printf ("*** Matrix2020CLProc: configuration failed (%d) ***\n", int (err));
+						return -1;
+					}
+
+					const double   mpix_s = measure (
+						ctx, int64_t (w) * h,
+						[&] ()
+						{
+							mat_proc.process (arg);
+						}
+					);
+					print_result ("Matrix2020CLProc", cfg_name, path, w, h, mpix_s);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+// BT.709 transfer curve, linear to gamma
+int	BenchEngines::bench_translut (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+	};
+	static const std::array <Config, 5> config_arr
+	{{
+		{ fmtcl::SplFmt_INT8 ,  8, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_FLOAT, 32 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_INT16, 16 }
+	}};
+
+	const fmtcl::TransOpLinPow curve (true, 1.099, 0.018, 0.45, 4.5);
+	const bool     loglut_flag = fmtcl::TransLut::is_loglut_req (curve);
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (const auto &config : config_arr)
+		{
+			PlaneBuf       src (w, h, config._fmt_src, config._res_src);
+			PlaneBuf       dst (w, h, config._fmt_dst, config._res_dst);
+			const fmtcl::PlaneRO <> plane_src (src.get_ptr (), int (src.get_stride ()));
+			const fmtcl::Plane <>   plane_dst (dst.get_ptr (), int (dst.get_stride ()));
+			const std::string cfg_name =
+				  build_fmt_name (config._fmt_src, config._res_src) + "->"
+				+ build_fmt_name (config._fmt_dst, config._res_dst);
+
+			for (const auto &path : _path_arr)
+			{
+				fmtcl::CpuOptBase cpu;
+				if (! setup_path (cpu, path))
+				{
+					continue;
+				}
+
+				fmtcl::TransLut   lut (
+					curve, loglut_flag,
+					config._fmt_src, config._res_src, true,
+					config._fmt_dst, config._res_dst, true,
+					cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+				);
+
+				const double   mpix_s = measure (
+					ctx, int64_t (w) * h,
+					[&] ()
+					{
+						lut.process_plane (plane_dst, plane_src, w, h);
+					}
+				);
+				print_result ("TransLut", cfg_name, path, w, h, mpix_s);
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+int	BenchEngines::bench_gammay (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+	};
+	static const std::array <Config, 5> config_arr
+	{{
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32 },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT16, 10, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT8 ,  8, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_FLOAT, 32 }
+	}};
+	constexpr int  nbr_planes = fmtcl::GammaY::_nbr_planes;
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (const auto &config : config_arr)
+		{
+			std::vector <std::unique_ptr <PlaneBuf> > buf_arr;
+			fmtcl::Frame <>   frame_dst;
+			fmtcl::FrameRO <> frame_src;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				buf_arr.emplace_back (std::make_unique <PlaneBuf> (
+					w, h, config._fmt_src, config._res_src
+				));
+				auto &         buf_s = *buf_arr.back ();
+				frame_src [p] = fmtcl::PlaneRO <> (buf_s.get_ptr (), int (buf_s.get_stride ()));
+				buf_arr.emplace_back (std::make_unique <PlaneBuf> (
+					w, h, config._fmt_dst, config._res_dst
+				));
+				auto &         buf_d = *buf_arr.back ();
+				frame_dst [p] = fmtcl::Plane <> (buf_d.get_ptr (), int (buf_d.get_stride ()));
+			}
+			const std::string cfg_name =
+				  build_fmt_name (config._fmt_src, config._res_src) + "->"
+				+ build_fmt_name (config._fmt_dst, config._res_dst);
+
+			for (const auto &path : _path_arr)
+			{
+				fmtcl::CpuOptBase cpu;
+				if (! setup_path (cpu, path))
+				{
+					continue;
+				}
+
+				fmtcl::GammaY  gammay (
+					config._fmt_src, config._res_src,
+					config._fmt_dst, config._res_dst,
+					1.2, 1.0,
+					cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+				);
+
+				const double   mpix_s = measure (
+					ctx, int64_t (w) * h,
+					[&] ()
+					{
+						gammay.process_plane (frame_dst, frame_src, w, h);
+					}
+				);
+				print_result ("GammaY", cfg_name, path, w, h, mpix_s);
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+// All the dithering methods, on a single plane
+int	BenchEngines::bench_dither (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+	};
+	static const std::array <Config, 2> config_arr
+	{{
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_INT8 ,  8 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_INT16, 10 }
+	}};
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (const auto &config : config_arr)
+		{
+			PlaneBuf       src (w, h, config._fmt_src, config._res_src);
+			PlaneBuf       dst (w, h, config._fmt_dst, config._res_dst);
+
+			for (int dmode = 0; dmode < fmtcl::Dither::DMode_NBR_ELT; ++dmode)
+			{
+				char           txt_0 [64];
+				fstb::snprintf4all (txt_0, sizeof (txt_0), " dmode=%d", dmode);
+				const std::string cfg_name =
+					  build_fmt_name (config._fmt_src, config._res_src) + "->"
+					+ build_fmt_name (config._fmt_dst, config._res_dst) + txt_0;
+
+				for (const auto &path : _path_arr)
+				{
+					fmtcl::CpuOptBase cpu;
+					if (! setup_path (cpu, path))
+					{
+						continue;
+					}
+
+					fmtcl::Dither  dither (
+						config._fmt_src, config._res_src, true,
+						config._fmt_dst, config._res_dst, true,
+						fmtcl::ColorFamily_YUV, 1, w,
+						fmtcl::Dither::DMode (dmode), 32, 1.0, 0.0,
+						false, false, false, false, false,
+						cpu.has_sse2 (), cpu.has_avx2 ()
+					);
+
+					int            frame_index = 0;
+					const double   mpix_s = measure (
+						ctx, int64_t (w) * h,
+						[&] ()
+						{
+							dither.process_plane (
+								dst.get_ptr (), dst.get_stride (),
+								src.get_ptr (), src.get_stride (),
+								w, h, frame_index, 0
+							);
+							++ frame_index;
+						}
+					);
+					print_result ("Dither", cfg_name, path, w, h, mpix_s);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+int	BenchEngines::bench_bitblt (const Context &ctx)
+{
+	class Config
+	{
+	public:
+		fmtcl::SplFmt  _fmt_src;
+		int            _res_src;
+		fmtcl::SplFmt  _fmt_dst;
+		int            _res_dst;
+	};
+	static const std::array <Config, 6> config_arr
+	{{
+		{ fmtcl::SplFmt_INT8 ,  8, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT16, 10, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_INT8 ,  8, fmtcl::SplFmt_FLOAT, 32 },
+		{ fmtcl::SplFmt_INT16, 16, fmtcl::SplFmt_FLOAT, 32 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_INT16, 16 },
+		{ fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32 }  // Plain copy
+	}};
+
+	for (const auto &size : _size_arr)
+	{
+		const int      w = size._w;
+		const int      h = size._h;
+
+		for (const auto &config : config_arr)
+		{
+			PlaneBuf       src (w, h, config._fmt_src, config._res_src);
+			PlaneBuf       dst (w, h, config._fmt_dst, config._res_dst);
+			const std::string cfg_name =
+				  build_fmt_name (config._fmt_src, config._res_src) + "->"
+				+ build_fmt_name (config._fmt_dst, config._res_dst);
+
+			for (const auto &path : _path_arr)
+			{
+				fmtcl::CpuOptBase cpu;
+				if (! setup_path (cpu, path))
+				{
+					continue;
+				}
+
+				fmtcl::BitBltConv blitter (
+					cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+				);
+
+				const double   mpix_s = measure (
+					ctx, int64_t (w) * h,
+					[&] ()
+					{
+						blitter.bitblt (
+							config._fmt_dst, config._res_dst,
+							dst.get_ptr (), dst.get_stride (),
+							config._fmt_src, config._res_src,
+							src.get_ptr (), src.get_stride (),
+							w, h
+						);
+					}
+				);
+				print_result ("BitBltConv", cfg_name, path, w, h, mpix_s);
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+
+// Returns false if the path is not available on this CPU
+bool	BenchEngines::setup_path (fmtcl::CpuOptBase &cpu, const Path &path)
+{
+	cpu.set_level (path._level);
+
+	switch (path._level)
+	{
+	case fmtcl::CpuOptBase::Level_NO_OPT:  return true;
+	case fmtcl::CpuOptBase::Level_SSE2:    return cpu.has_sse2 ();
+	case fmtcl::CpuOptBase::Level_AVX2:    return cpu.has_avx2 ();
+	case fmtcl::CpuOptBase::Level_AVX512F: return cpu.has_avx512bw ();
+	default:
+		assert (false);
+		break;
+	}
+
+	return false;
+}
+
+
+
+// Calls fnc repeatedly during at least the minimum duration, after a first
+// warm-up call. Returns the throughput in megapixels per second.
+template <typename F>
+double	BenchEngines::measure (const Context &ctx, int64_t nbr_pix, F fnc)
+{
+	assert (nbr_pix > 0);
+
+	typedef std::chrono::steady_clock Clock;
+
+	fnc ();
+
+	int64_t        nbr_it = 0;
+	double         dur    = 0;
+	const auto     t_beg  = Clock::now ();
+	do
+	{
+		fnc ();
+		++ nbr_it;
+		dur = std::chrono::duration <double> (Clock::now () - t_beg).count ();
+	}
+	while (dur < ctx._min_dur);
+
+	return double (nbr_pix) * double (nbr_it) / (dur * 1e6);
+}
+
+
+
+void	BenchEngines::print_result (const char *engine_0, const std::string &config, const Path &path, int w, int h, double mpix_s)
+{
+	assert (engine_0 != nullptr);
+
+	printf (
+		"%s,%s,%s,%d,%d,%.1f\n",
+		engine_0, config.c_str (), path._name_0, w, h, mpix_s
+	);
+	fflush (stdout);
+}
+
+
+
+std::string	BenchEngines::build_fmt_name (fmtcl::SplFmt fmt, int res)
+{
+	char           txt_0 [63+1];
+	switch (fmt)
+	{
+	case fmtcl::SplFmt_FLOAT:
+		fstb::snprintf4all (txt_0, sizeof (txt_0), "f%d", res);
+		break;
+	case fmtcl::SplFmt_INT16:
+		fstb::snprintf4all (txt_0, sizeof (txt_0), "i16_%d", res);
+		break;
+	case fmtcl::SplFmt_INT8:
+		fstb::snprintf4all (txt_0, sizeof (txt_0), "i08_%d", res);
+		break;
+	default:
+		assert (false);
+		txt_0 [0] = '\0';
+		break;
+	}
+
+	return txt_0;
+}
+
+
+
+const std::vector <BenchEngines::Path>	BenchEngines::_path_arr
+{
+	{ "cpp"   , fmtcl::CpuOptBase::Level_NO_OPT  },
+	{ "sse2"  , fmtcl::CpuOptBase::Level_SSE2    },
+	{ "avx2"  , fmtcl::CpuOptBase::Level_AVX2    },
+	{ "avx512", fmtcl::CpuOptBase::Level_AVX512F }
+};
+
+const std::vector <BenchEngines::Size>	BenchEngines::_size_arr
+{
+	{ 1920, 1080 },
+	{ 3840, 2160 }
+};
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,159 @@
+/*****************************************************************************
+
+        BenchEngines.h
+        Author: Laurent de Soras, 2024
+
+Throughput measurement of the fmtcl processing engines, for all the
+available code paths (C++, SSE2, AVX2). The paths are forced through
+CpuOptBase, like the cpuopt parameter of the filters.
+
+Results are printed on stdout as CSV, one line per configuration:
+engine,config,path,width,height,mpix_s
+width and height are the output frame size, mpix_s is the throughput in
+megapixels per second, counted on the output pixels of a single plane.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (BenchEngines_HEADER_INCLUDED)
+#define BenchEngines_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/CpuOptBase.h"
+#include "fmtcl/SplFmt.h"
+#include "fstb/AllocAlign.h"
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+
+
+class BenchEngines
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	// filter_0: only the engines whose name contains this string are
+	// measured. Empty string: all engines.
+	// min_dur: minimum measurement duration for each configuration, s.
+	static int     perform_bench (const char *filter_0, double min_dur);
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	class Context
+	{
+	public:
+		std::string    _filter;
+		double         _min_dur = 0.1;
+	};
+
+	class Path
+	{
+	public:
+		const char *   _name_0;
+		fmtcl::CpuOptBase::Level
+		               _level;
+	};
+
+	class Size
+	{
+	public:
+		int            _w;
+		int            _h;
+	};
+
+	// Plane with random content, matching the sample format and bitdepth.
+	// There are margins on each side, so SIMD code can safely read or write
+	// a bit outside the picture.
+	class PlaneBuf
+	{
+	public:
+		explicit       PlaneBuf (int w, int h, fmtcl::SplFmt fmt, int res);
+		uint8_t *      get_ptr () noexcept;
+		ptrdiff_t      get_stride () const noexcept; // Bytes
+		ptrdiff_t      get_stride_pix () const noexcept;
+	private:
+		static constexpr int _margin_b = 128; // Bytes, beginning and end of lines
+		static constexpr int _margin_l = 16;  // Lines, top and bottom
+		std::vector <uint8_t, fstb::AllocAlign <uint8_t, 64> >
+		               _buf;
+		ptrdiff_t      _stride  = 0;
+		int            _unit_sz = 0;
+		ptrdiff_t      _offset  = 0;
+	};
+
+	static int     bench_scaler (const Context &ctx);
+	static int     bench_filter_resize (const Context &ctx);
+	static int     bench_matrix (const Context &ctx);
+	static int     bench_matrix_2020cl (const Context &ctx);
+	static int     bench_translut (const Context &ctx);
+	static int     bench_gammay (const Context &ctx);
+	static int     bench_dither (const Context &ctx);
+	static int     bench_bitblt (const Context &ctx);
+
+	static bool    setup_path (fmtcl::CpuOptBase &cpu, const Path &path);
+	template <typename F>
+	static double  measure (const Context &ctx, int64_t nbr_pix, F fnc);
+	static void    print_result (const char *engine_0, const std::string &config, const Path &path, int w, int h, double mpix_s);
+	static std::string
+	               build_fmt_name (fmtcl::SplFmt fmt, int res);
+
+	static const std::vector <Path>
+	               _path_arr;
+	static const std::vector <Size>
+	               _size_arr;
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               BenchEngines ()                               = delete;
+	               BenchEngines (const BenchEngines &other)      = delete;
+	               BenchEngines (BenchEngines &&other)           = delete;
+	BenchEngines & operator = (const BenchEngines &other)        = delete;
+	BenchEngines & operator = (BenchEngines &&other)             = delete;
+	bool           operator == (const BenchEngines &other) const = delete;
+	bool           operator != (const BenchEngines &other) const = delete;
+
+}; // class BenchEngines
+
+
+
+//#include "test/BenchEngines.hpp"
+
+
+
+#endif   // BenchEngines_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
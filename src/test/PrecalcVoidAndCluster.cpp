@@ -25,12 +25,16 @@ http://www.wtfpl.net/ for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "test/PrecalcVoidAndCluster.h"
+#include "fmtcl/Dither.h"
 #include "fmtcl/MatrixWrap.h"
 #include "fmtcl/VoidAndCluster.h"
+#include "fmtcl/VoidAndClusterCache.h"
 #include "fstb/fnc.h"
 
+#include <array>
 #include <chrono>
 #include <future>
+#include <vector>
 
 #include <cassert>
 #include <cstdio>
@@ -56,41 +60,43 @@ PrecalcVoidAndCluster::HdrCode &	PrecalcVoidAndCluster::HdrCode::operator += (co
 
 
 
+// Generates all the power-of-2 sizes up to fmtcl::Dither::_pat_max_size, in
+// both standard and aztec modes. The largest patterns are the slowest ones,
+// they are started first in separate threads.
 PrecalcVoidAndCluster::HdrCode	PrecalcVoidAndCluster::build_all ()
 {
-	auto           files = print_beg ();
+	constexpr int  size_l2_min = 2;
+	int            size_l2_max = size_l2_min;
+	while ((2 << size_l2_max) <= fmtcl::Dither::_pat_max_size)
+	{
+		++ size_l2_max;
+	}
+	constexpr int  size_l2_async = 8;
 
-	auto           s10 = std::async (
-		std::launch::async, generate_mat, 10, false
-	);
-	auto           a8 = std::async (
-		std::launch::async, generate_mat, 8, true
-	);
-	auto           a9 = std::async (
-		std::launch::async, generate_mat, 9, true
-	);
-	files += generate_mat (2, false);
-	files += generate_mat (3, false);
-	files += generate_mat (4, false);
-	files += generate_mat (5, false);
-	files += generate_mat (6, false);
-	files += generate_mat (7, false);
-	files += generate_mat (8, false);
-	files += generate_mat (9, false);
-	s10.wait ();
-	files += s10.get ();
-
-	files += generate_mat (2, true);
-	files += generate_mat (3, true);
-	files += generate_mat (4, true);
-	files += generate_mat (5, true);
-	files += generate_mat (6, true);
-	files += generate_mat (7, true);
-	a8.wait ();
-	files += a8.get ();
-	a9.wait ();
-	files += a9.get ();
+	std::array <std::vector <std::future <HdrCode> >, 2> fut_arr;
+	for (int alt = 0; alt < 2; ++alt)
+	{
+		for (int size_l2 = size_l2_min; size_l2 <= size_l2_max; ++size_l2)
+		{
+			const auto     policy =
+				  (size_l2 >= size_l2_async)
+				? std::launch::async
+				: std::launch::deferred;
+			fut_arr [alt].push_back (std::async (
+				policy, generate_mat, size_l2, (alt != 0)
+			));
+		}
+	}
 
+	// Results are collected in the table order
+	auto           files = print_beg ();
+	for (auto &fut_list : fut_arr)
+	{
+		for (auto &fut : fut_list)
+		{
+			files += fut.get ();
+		}
+	}
 	files += print_end ();
 
 	return files;
@@ -124,7 +130,8 @@ PrecalcVoidAndCluster::HdrCode	PrecalcVoidAndCluster::print_beg ()
 
 
 // Values are stored as unsigned 8-bit int, grouped by 8 in uint64_t words,
-// each byte stored in reading order (byte 0 is the MSB, byte 7 is the LSB).
+// each byte stored in reading order (byte 0 is the LSB, byte 7 is the MSB),
+// as expected by VoidAndClusterCache::decode_precalc().
 PrecalcVoidAndCluster::HdrCode	PrecalcVoidAndCluster::generate_mat (int size_l2, bool alt_flag)
 {
 	assert (size_l2 >= 2);
@@ -170,9 +177,8 @@ PrecalcVoidAndCluster::HdrCode	PrecalcVoidAndCluster::generate_mat (int size_l2,
 	{
 		for (int x = 0; x < w; ++x)
 		{
-			const auto     v = uint8_t (pat (x, y) * 256 / area /* - 128 */);
-			block <<= 8;
-			block += v;
+			const auto     v = quantize (pat (x, y), area);
+			block |= (unsigned long long) (v) << ((count & (block_size - 1)) * 8);
 			++ count;
 			if ((count & (block_size - 1)) == 0)
 			{
@@ -201,6 +207,60 @@ PrecalcVoidAndCluster::HdrCode	PrecalcVoidAndCluster::print_end ()
 
 
 
+// Generates a pattern and compares it with the shipped table, to make sure
+// the generator changes don't alter the results. Returns 0 if they match.
+int	PrecalcVoidAndCluster::check_mat (int size_l2, bool alt_flag)
+{
+	assert (size_l2 >= 2);
+	assert ((1 << size_l2) <= fmtcl::Dither::_pat_max_size);
+
+	const int      w    = 1 << size_l2;
+	const int      h    = 1 << size_l2;
+	const int      area = w * h;
+	printf (
+		"Checking void-and-cluster pattern %dx%d, %s... ",
+		w, h, (alt_flag) ? "alt" : "std"
+	);
+	fflush (stdout);
+
+	fmtcl::VoidAndCluster   vc_gen;
+	vc_gen.set_aztec_mode (alt_flag);
+	vc_gen.set_mt_mode (true);
+	fmtcl::MatrixWrap <fmtcl::VoidAndCluster::Rank> pat (w, h);
+
+	typedef std::chrono::high_resolution_clock Clock;
+	const auto     t_beg = Clock::now ();
+	vc_gen.create_matrix (pat);
+	const auto     t_end = Clock::now ();
+	const std::chrono::duration <double> dur = t_end - t_beg;
+
+	const auto     ref_sptr =
+		fmtcl::VoidAndClusterCache::use_instance ().use_pattern (w, alt_flag);
+	int            nbr_diff = 0;
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			if (quantize (pat (x, y), area) != (*ref_sptr) (x, y))
+			{
+				++ nbr_diff;
+			}
+		}
+	}
+
+	printf ("%.3f s, ", dur.count ());
+	if (nbr_diff > 0)
+	{
+		printf ("*** %d levels differ from the table. ***\n", nbr_diff);
+		return -1;
+	}
+	printf ("OK\n");
+
+	return 0;
+}
+
+
+
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 
@@ -229,4 +289,11 @@ std::string	PrecalcVoidAndCluster::print_var_name (int size_l2, bool alt_flag, b
 
 
 
+uint8_t	PrecalcVoidAndCluster::quantize (fmtcl::VoidAndCluster::Rank rank, int area)
+{
+	return uint8_t (rank * 256 / area /* - 128 */);
+}
+
+
+
 /*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
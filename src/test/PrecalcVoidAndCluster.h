@@ -23,8 +23,12 @@ http://www.wtfpl.net/ for more details.
 
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
+#include "fmtcl/VoidAndCluster.h"
+
 #include <string>
 
+#include <cstdint>
+
 
 
 class PrecalcVoidAndCluster
@@ -37,7 +41,7 @@ public:
 	static constexpr const char *
 	               _namespace_0 = "fmtcl";
 	static constexpr const char *
-	               _classname_0 = "VoidAndClusterPreCalc";
+	               _classname_0 = "VoidAndClusterPrecalc";
 
 	class HdrCode
 	{
@@ -53,6 +57,8 @@ public:
 	static HdrCode  generate_mat (int size_l2, bool alt_flag);
 	static HdrCode  print_end (); 
 
+	static int      check_mat (int size_l2, bool alt_flag);
+
 
 
 /*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -67,6 +73,8 @@ private:
 
 	static std::string
 	               print_var_name (int size_l2, bool alt_flag, bool header_flag);
+	static inline uint8_t
+	               quantize (fmtcl::VoidAndCluster::Rank rank, int area);
 
 
 
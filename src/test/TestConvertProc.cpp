@@ -0,0 +1,726 @@
+/*****************************************************************************
+
+        TestConvertProc.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ColorSpaceH265.h"
+#include "fmtcl/Dither.h"
+#include "fmtcl/FilterResize.h"
+#include "fmtcl/fnc.h"
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/MatrixUtil.h"
+#include "fmtcl/PrimUtil.h"
+#include "fmtcl/ResampleUtil.h"
+#include "fmtcl/RgbSystem.h"
+#include "fmtcl/TransModel.h"
+#include "fstb/CpuId.h"
+#include "fstb/fnc.h"
+#include "test/TestConvertProc.h"
+
+#include <algorithm>
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+int	TestConvertProc::perform_test ()
+{
+	int            ret_val = 0;
+
+	printf ("Testing ConvertProc...\n");
+	fflush (stdout);
+
+	if (ret_val == 0)
+	{
+		ret_val = test_analytic ();
+	}
+	if (ret_val == 0)
+	{
+		ret_val = test_gray ();
+	}
+	if (ret_val == 0)
+	{
+		Rng            rng;
+		ret_val = test_chain (rng);
+	}
+
+	if (ret_val == 0)
+	{
+		printf ("Done.\n");
+	}
+
+	return ret_val;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+constexpr int	TestConvertProc::_max_nbr_planes;
+
+
+
+// Lines are padded to 64 bytes, and there is one more line at the end for
+// the SIMD code reading past the picture.
+TestConvertProc::Pic::Pic (int w, int h, int ss_h, int ss_v, fmtcl::ColorFamily cf, int bps)
+:	_nbr_planes ((cf == fmtcl::ColorFamily_GRAY) ? 1 : _max_nbr_planes)
+,	_bps (bps)
+{
+	assert (w > 0);
+	assert (h > 0);
+	assert (bps == 1 || bps == 2 || bps == 4);
+
+	for (int plane_index = 0; plane_index < _nbr_planes; ++plane_index)
+	{
+		const int      pw = fmtcl::compute_plane_width (cf, ss_h, w, plane_index);
+		const int      ph = fmtcl::compute_plane_height (cf, ss_v, h, plane_index);
+		const ptrdiff_t   stride = (pw * bps + 63) & -64;
+		_w_arr [plane_index]      = pw;
+		_h_arr [plane_index]      = ph;
+		_stride_arr [plane_index] = stride;
+		_data_arr [plane_index].resize (size_t (stride * (ph + 1)), 0);
+	}
+}
+
+
+
+fmtcl::Frame <>	TestConvertProc::Pic::get_frame () noexcept
+{
+	fmtcl::Frame <>   frame;
+	for (int plane_index = 0; plane_index < _nbr_planes; ++plane_index)
+	{
+		frame [plane_index]._ptr    = _data_arr [plane_index].data ();
+		frame [plane_index]._stride = _stride_arr [plane_index];
+	}
+
+	return frame;
+}
+
+
+
+fmtcl::FrameRO <>	TestConvertProc::Pic::get_frame_ro () const noexcept
+{
+	fmtcl::FrameRO <> frame;
+	for (int plane_index = 0; plane_index < _nbr_planes; ++plane_index)
+	{
+		frame [plane_index]._ptr    = _data_arr [plane_index].data ();
+		frame [plane_index]._stride = _stride_arr [plane_index];
+	}
+
+	return frame;
+}
+
+
+
+double	TestConvertProc::Pic::get_spl (int plane_index, int x, int y) const noexcept
+{
+	const uint8_t* ptr =
+		_data_arr [plane_index].data () + y * _stride_arr [plane_index];
+	switch (_bps)
+	{
+	case 1:  return double (ptr [x]);
+	case 2:  return double (reinterpret_cast <const uint16_t *> (ptr) [x]);
+	default: return double (reinterpret_cast <const float *> (ptr) [x]);
+	}
+}
+
+
+
+void	TestConvertProc::Pic::set_spl (int plane_index, int x, int y, double val) noexcept
+{
+	uint8_t *      ptr =
+		_data_arr [plane_index].data () + y * _stride_arr [plane_index];
+	switch (_bps)
+	{
+	case 1:
+		ptr [x] = uint8_t (val);
+		break;
+	case 2:
+		reinterpret_cast <uint16_t *> (ptr) [x] = uint16_t (val);
+		break;
+	default:
+		reinterpret_cast <float *> (ptr) [x] = float (val);
+		break;
+	}
+}
+
+
+
+// Constant pictures with known results
+int	TestConvertProc::test_analytic ()
+{
+	const fstb::CpuId cpu;
+	const bool     avx512_flag = (cpu._avx512f_flag && cpu._avx512bw_flag);
+	double         dev = 0;
+
+	// Mid-gray YUV 4:2:0 8 bits (TV range), upscaled to RGB 4:4:4 8 bits
+	// (full range): (126 - 16) / 219 * 255 = 128.08
+	{
+		constexpr int  w_s = 16;
+		constexpr int  h_s = 8;
+		constexpr int  w_d = 24;
+		constexpr int  h_d = 12;
+
+		fmtcl::ConvertProc::Param  param;
+		auto &         s = param._src;
+		auto &         d = param._dst;
+		s._fmt  = fmtcl::PicFmt {
+			fmtcl::SplFmt_INT8, 8, fmtcl::ColorFamily_YUV, false
+		};
+		s._w    = w_s;
+		s._h    = h_s;
+		s._ss_h = 1;
+		s._ss_v = 1;
+		fmtcl::MatrixUtil::make_mat_from_str (s._mat, "601", true);
+		d._fmt  = fmtcl::PicFmt {
+			fmtcl::SplFmt_INT8, 8, fmtcl::ColorFamily_RGB, true
+		};
+		d._w    = w_d;
+		d._h    = h_d;
+		init_kernels (param._rsz_in);
+		init_kernels (param._rsz_out);
+		param._dmode = fmtcl::Dither::DMode_ROUND;
+
+		fmtcl::ConvertProc   proc (
+			std::move (param),
+			cpu._sse_flag, cpu._sse2_flag, cpu._avx_flag, cpu._avx2_flag,
+			avx512_flag
+		);
+
+		Pic            src (w_s, h_s, 1, 1, fmtcl::ColorFamily_YUV, 1);
+		for (int plane_index = 0; plane_index < src._nbr_planes; ++plane_index)
+		{
+			for (int y = 0; y < src._h_arr [plane_index]; ++y)
+			{
+				for (int x = 0; x < src._w_arr [plane_index]; ++x)
+				{
+					src.set_spl (plane_index, x, y, (plane_index == 0) ? 126 : 128);
+				}
+			}
+		}
+		Pic            dst (w_d, h_d, 0, 0, fmtcl::ColorFamily_RGB, 1);
+		proc.process_frame (
+			dst.get_frame (), src.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+		);
+
+		for (int plane_index = 0; plane_index < dst._nbr_planes; ++plane_index)
+		{
+			for (int y = 0; y < h_d; ++y)
+			{
+				for (int x = 0; x < w_d; ++x)
+				{
+					const double   v = dst.get_spl (plane_index, x, y);
+					dev = std::max (dev, fabs (v - 128));
+				}
+			}
+		}
+	}
+	if (report ("YUV->RGB", dev, 0) != 0)
+	{
+		return -1;
+	}
+
+	// Same colorimetry, only the size, subsampling and bitdepth change: the
+	// planes are resampled directly to their final size.
+	dev = 0;
+	{
+		constexpr int  w_s = 16;
+		constexpr int  h_s = 8;
+		constexpr int  w_d = 12;
+		constexpr int  h_d = 10;
+
+		fmtcl::ConvertProc::Param  param;
+		auto &         s = param._src;
+		auto &         d = param._dst;
+		s._fmt  = fmtcl::PicFmt {
+			fmtcl::SplFmt_INT8, 8, fmtcl::ColorFamily_YUV, false
+		};
+		s._w    = w_s;
+		s._h    = h_s;
+		s._ss_h = 1;
+		s._ss_v = 1;
+		d._fmt  = fmtcl::PicFmt {
+			fmtcl::SplFmt_INT16, 10, fmtcl::ColorFamily_YUV, false
+		};
+		d._w    = w_d;
+		d._h    = h_d;
+		d._ss_h = 1;
+		init_kernels (param._rsz_in);
+		init_kernels (param._rsz_out);
+		param._dmode = fmtcl::Dither::DMode_ROUND;
+
+		fmtcl::ConvertProc   proc (
+			std::move (param),
+			cpu._sse_flag, cpu._sse2_flag, cpu._avx_flag, cpu._avx2_flag,
+			avx512_flag
+		);
+
+		Pic            src (w_s, h_s, 1, 1, fmtcl::ColorFamily_YUV, 1);
+		for (int plane_index = 0; plane_index < src._nbr_planes; ++plane_index)
+		{
+			for (int y = 0; y < src._h_arr [plane_index]; ++y)
+			{
+				for (int x = 0; x < src._w_arr [plane_index]; ++x)
+				{
+					src.set_spl (plane_index, x, y, (plane_index == 0) ? 126 : 100);
+				}
+			}
+		}
+		Pic            dst (w_d, h_d, 1, 0, fmtcl::ColorFamily_YUV, 2);
+		proc.process_frame (
+			dst.get_frame (), src.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+		);
+
+		for (int plane_index = 0; plane_index < dst._nbr_planes; ++plane_index)
+		{
+			const double   expected = (plane_index == 0) ? 126 * 4 : 100 * 4;
+			for (int y = 0; y < dst._h_arr [plane_index]; ++y)
+			{
+				for (int x = 0; x < dst._w_arr [plane_index]; ++x)
+				{
+					const double   v = dst.get_spl (plane_index, x, y);
+					dev = std::max (dev, fabs (v - expected));
+				}
+			}
+		}
+	}
+	if (report ("Direct", dev, 0) != 0)
+	{
+		return -1;
+	}
+
+	// Linear gray 0.5 to sRGB: 1.055 * 0.5 ^ (1 / 2.4) - 0.055
+	dev = 0;
+	{
+		constexpr int  w = 20;
+		constexpr int  h = 6;
+		const fmtcl::PicFmt  fmt {
+			fmtcl::SplFmt_FLOAT, 32, fmtcl::ColorFamily_GRAY, true
+		};
+
+		fmtcl::ConvertProc::Param  param;
+		auto &         s = param._src;
+		auto &         d = param._dst;
+		s._fmt   = fmt;
+		s._w     = w;
+		s._h     = h;
+		s._curve = fmtcl::TransCurve_LINEAR;
+		d._fmt   = fmt;
+		d._w     = w;
+		d._h     = h;
+		d._curve = fmtcl::TransCurve_SRGB;
+		param._lin_flag = true;
+		init_kernels (param._rsz_in);
+		init_kernels (param._rsz_out);
+
+		fmtcl::ConvertProc   proc (
+			std::move (param),
+			cpu._sse_flag, cpu._sse2_flag, cpu._avx_flag, cpu._avx2_flag,
+			avx512_flag
+		);
+
+		Pic            src (w, h, 0, 0, fmtcl::ColorFamily_GRAY, 4);
+		for (int y = 0; y < h; ++y)
+		{
+			for (int x = 0; x < w; ++x)
+			{
+				src.set_spl (0, x, y, 0.5);
+			}
+		}
+		Pic            dst (w, h, 0, 0, fmtcl::ColorFamily_GRAY, 4);
+		proc.process_frame (
+			dst.get_frame (), src.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+		);
+
+		const double   expected = 1.055 * pow (0.5, 1 / 2.4) - 0.055;
+		for (int y = 0; y < h; ++y)
+		{
+			for (int x = 0; x < w; ++x)
+			{
+				dev = std::max (dev, fabs (dst.get_spl (0, x, y) - expected));
+			}
+		}
+	}
+
+	return report ("Linear->sRGB", dev, 1e-4);
+}
+
+
+
+// Gray to RGB, then back to gray through the luma. Both conversions are
+// lossless at the same bitdepth.
+int	TestConvertProc::test_gray ()
+{
+	const fstb::CpuId cpu;
+	const bool     avx512_flag = (cpu._avx512f_flag && cpu._avx512bw_flag);
+	constexpr int  w = 37;
+	constexpr int  h = 11;
+
+	Pic            src (w, h, 0, 0, fmtcl::ColorFamily_GRAY, 1);
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			src.set_spl (0, x, y, (x * 7 + y * 31) & 255);
+		}
+	}
+
+	const auto     build_param = [w, h] (fmtcl::ColorFamily cf_s, fmtcl::ColorFamily cf_d)
+	{
+		fmtcl::ConvertProc::Param  param;
+		auto &         s = param._src;
+		auto &         d = param._dst;
+		s._fmt = fmtcl::PicFmt { fmtcl::SplFmt_INT8, 8, cf_s, true };
+		s._w   = w;
+		s._h   = h;
+		d._fmt = fmtcl::PicFmt { fmtcl::SplFmt_INT8, 8, cf_d, true };
+		d._w   = w;
+		d._h   = h;
+		init_kernels (param._rsz_in);
+		init_kernels (param._rsz_out);
+		param._dmode = fmtcl::Dither::DMode_ROUND;
+		return param;
+	};
+
+	auto           param_rgb =
+		build_param (fmtcl::ColorFamily_GRAY, fmtcl::ColorFamily_RGB);
+	fmtcl::ConvertProc   proc_rgb (
+		std::move (param_rgb),
+		cpu._sse_flag, cpu._sse2_flag, cpu._avx_flag, cpu._avx2_flag,
+		avx512_flag
+	);
+	Pic            rgb (w, h, 0, 0, fmtcl::ColorFamily_RGB, 1);
+	proc_rgb.process_frame (
+		rgb.get_frame (), src.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+	);
+
+	auto           param_gray =
+		build_param (fmtcl::ColorFamily_RGB, fmtcl::ColorFamily_GRAY);
+	fmtcl::MatrixUtil::make_mat_from_str (param_gray._dst._mat, "601", false);
+	fmtcl::ConvertProc   proc_gray (
+		std::move (param_gray),
+		cpu._sse_flag, cpu._sse2_flag, cpu._avx_flag, cpu._avx2_flag,
+		avx512_flag
+	);
+	Pic            gray (w, h, 0, 0, fmtcl::ColorFamily_GRAY, 1);
+	proc_gray.process_frame (
+		gray.get_frame (), rgb.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+	);
+
+	double         dev = 0;
+	for (int y = 0; y < h; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			const double   v = src.get_spl (0, x, y);
+			for (int plane_index = 0; plane_index < rgb._nbr_planes; ++plane_index)
+			{
+				dev = std::max (dev, fabs (rgb.get_spl (plane_index, x, y) - v));
+			}
+			dev = std::max (dev, fabs (gray.get_spl (0, x, y) - v));
+		}
+	}
+
+	return report ("Gray<->RGB", dev, 0);
+}
+
+
+
+// Resizing, subsampling, matrices, curves and primaries at once. The
+// reference runs each engine separately on whole frames, with the
+// intermediate results in separate buffers. Rounding without dithering
+// gives the same results.
+int	TestConvertProc::test_chain (Rng &rng)
+{
+	const fstb::CpuId cpu;
+	const bool     sse_flag    = cpu._sse_flag;
+	const bool     sse2_flag   = cpu._sse2_flag;
+	const bool     avx_flag    = cpu._avx_flag;
+	const bool     avx2_flag   = cpu._avx2_flag;
+	const bool     avx512_flag = (cpu._avx512f_flag && cpu._avx512bw_flag);
+
+	constexpr int  w_s = 40;
+	constexpr int  h_s = 30;
+	constexpr int  w_d = 58;
+	constexpr int  h_d = 42;
+	const auto     cf  = fmtcl::ColorFamily_YUV;
+	const auto     cp  = fmtcl::ChromaPlacement_MPEG2;
+	const fmtcl::PicFmt  fmt_s { fmtcl::SplFmt_INT8 , 8 , cf, false };
+	const fmtcl::PicFmt  fmt_d { fmtcl::SplFmt_INT16, 10, cf, false };
+	const fmtcl::PicFmt  fmt_yuv { fmtcl::SplFmt_FLOAT, 32, cf, true };
+	const fmtcl::PicFmt  fmt_rgb {
+		fmtcl::SplFmt_FLOAT, 32, fmtcl::ColorFamily_RGB, true
+	};
+	fmtcl::Mat4    mat_s;
+	fmtcl::Mat4    mat_d;
+	fmtcl::MatrixUtil::make_mat_from_str (mat_s, "709" , true );
+	fmtcl::MatrixUtil::make_mat_from_str (mat_d, "2020", false);
+
+	Pic            src (w_s, h_s, 1, 1, cf, 1);
+	for (int plane_index = 0; plane_index < src._nbr_planes; ++plane_index)
+	{
+		std::uniform_int_distribution <int> dist (
+			16, (plane_index == 0) ? 235 : 240
+		);
+		for (int y = 0; y < src._h_arr [plane_index]; ++y)
+		{
+			for (int x = 0; x < src._w_arr [plane_index]; ++x)
+			{
+				src.set_spl (plane_index, x, y, dist (rng));
+			}
+		}
+	}
+
+	// Fused conversion
+	fmtcl::ConvertProc::Param  param;
+	auto &         s = param._src;
+	auto &         d = param._dst;
+	s._fmt   = fmt_s;
+	s._w     = w_s;
+	s._h     = h_s;
+	s._ss_h  = 1;
+	s._ss_v  = 1;
+	s._mat   = mat_s;
+	s._curve = fmtcl::TransCurve_709;
+	s._prim  = fmtcl::PrimariesPreset_BT709;
+	d._fmt   = fmt_d;
+	d._w     = w_d;
+	d._h     = h_d;
+	d._ss_h  = 1;
+	d._ss_v  = 1;
+	d._mat   = mat_d;
+	d._curve = fmtcl::TransCurve_2020_10;
+	d._prim  = fmtcl::PrimariesPreset_BT2020;
+	param._lin_flag = true;
+	init_kernels (param._rsz_in);
+	init_kernels (param._rsz_out);
+	param._dmode = fmtcl::Dither::DMode_ROUND;
+
+	fmtcl::ConvertProc   proc (
+		std::move (param),
+		sse_flag, sse2_flag, avx_flag, avx2_flag, avx512_flag
+	);
+	Pic            dst (w_d, h_d, 1, 1, cf, 2);
+	proc.process_frame (
+		dst.get_frame (), src.get_frame_ro (), 0, fmtcl::InterlacingType_FRAME
+	);
+
+	// Reference: 4:4:4 float at the destination size
+	Pic            pic_a (w_d, h_d, 0, 0, cf, 4);
+	Pic            pic_b (w_d, h_d, 0, 0, cf, 4);
+	fmtcl::ConvertProc::PlaneDataArray  pd_arr;
+	init_kernels (pd_arr);
+	for (int plane_index = 0; plane_index < src._nbr_planes; ++plane_index)
+	{
+		auto &         pd = pd_arr [plane_index];
+		pd._win._w = w_s;
+		pd._win._h = h_s;
+		fmtcl::compute_fmt_mac_cst (
+			pd._gain, pd._add_cst, fmt_yuv, fmt_s, plane_index
+		);
+		fmtcl::ResampleUtil::create_plane_specs (
+			pd, plane_index,
+			cf, w_s, 1, h_s, 1, cp,
+			cf, w_d, 0, h_d, 0, cp
+		);
+		fmtcl::FilterResize  rsz (
+			pd._spec_arr [0] [0],
+			*(pd._kernel_arr [fmtcl::FilterResize::Dir_H]._k_uptr),
+			*(pd._kernel_arr [fmtcl::FilterResize::Dir_V]._k_uptr),
+			true, 0, 0, pd._gain,
+			fmt_s._sf, fmt_s._res, fmtcl::SplFmt_FLOAT, 32,
+			false, sse2_flag, avx2_flag, avx512_flag
+		);
+		rsz.process_plane (
+			pic_a._data_arr [plane_index].data (),
+			src._data_arr [plane_index].data (),
+			pic_a._stride_arr [plane_index],
+			src._stride_arr [plane_index],
+			(plane_index > 0)
+		);
+	}
+
+	const auto     run_mat = [&] (const fmtcl::Mat4 &m, Pic &pic_dst, const fmtcl::PicFmt &pf_dst, const Pic &pic_src, const fmtcl::PicFmt &pf_src)
+	{
+		fmtcl::MatrixProc mat_proc (
+			sse_flag, sse2_flag, avx_flag, avx2_flag, avx512_flag
+		);
+		fmtcl::prepare_matrix_coef (
+			mat_proc, m, pf_dst, pf_src, fmtcl::ColorSpaceH265_UNSPECIFIED, -1
+		);
+		fmtcl::ProcComp3Arg  pa;
+		pa._dst = pic_dst.get_frame ();
+		pa._src = pic_src.get_frame_ro ();
+		pa._w   = w_d;
+		pa._h   = h_d;
+		mat_proc.process (pa);
+	};
+	const auto     run_trans = [&] (fmtcl::TransCurve curve_d, fmtcl::TransCurve curve_s, Pic &pic_dst, const Pic &pic_src)
+	{
+		const auto     logc_ei = fmtcl::TransOpLogC::ExpIdx_800;
+		fmtcl::TransModel trans (
+			fmt_rgb, curve_d, logc_ei, fmt_rgb, curve_s, logc_ei,
+			1, 1, 0, 0, 0, 5, false, fmtcl::LumMatch_REF_WHITE,
+			fmtcl::TransModel::GyProc::UNDEF, 6.5, 0.5, false,
+			sse2_flag, avx2_flag, avx512_flag
+		);
+		fmtcl::ProcComp3Arg  pa;
+		pa._dst = pic_dst.get_frame ();
+		pa._src = pic_src.get_frame_ro ();
+		pa._w   = w_d;
+		pa._h   = h_d;
+		trans.process_frame (pa);
+	};
+
+	fmtcl::RgbSystem  prim_s;
+	fmtcl::RgbSystem  prim_d;
+	prim_s.set (fmtcl::PrimariesPreset_BT709);
+	prim_d.set (fmtcl::PrimariesPreset_BT2020);
+	fmtcl::Mat4    mat_prim;
+	mat_prim.insert3 (
+		fmtcl::PrimUtil::compute_conversion_matrix (prim_s, prim_d, false)
+	);
+	mat_prim.clean3 (1);
+
+	run_mat (mat_s, pic_b, fmt_rgb, pic_a, fmt_yuv);
+	run_trans (fmtcl::TransCurve_LINEAR, fmtcl::TransCurve_709, pic_a, pic_b);
+	run_mat (mat_prim, pic_b, fmt_rgb, pic_a, fmt_rgb);
+	run_trans (fmtcl::TransCurve_2020_10, fmtcl::TransCurve_LINEAR, pic_a, pic_b);
+	run_mat (mat_d, pic_b, fmt_yuv, pic_a, fmt_rgb);
+
+	// Reference: chroma subsampling and bitdepth
+	Pic            sub (w_d, h_d, 1, 1, cf, 4);
+	Pic            ref (w_d, h_d, 1, 1, cf, 2);
+	fmtcl::ConvertProc::PlaneDataArray  pd_out_arr;
+	init_kernels (pd_out_arr);
+	fmtcl::Dither  dither (
+		fmtcl::SplFmt_FLOAT, 32, true,
+		fmt_d._sf, fmt_d._res, fmt_d._full_flag,
+		cf, ref._nbr_planes, w_d,
+		fmtcl::Dither::DMode_ROUND, 32, 1, 0,
+		false, false, false, false, false,
+		sse2_flag, avx2_flag
+	);
+	for (int plane_index = 0; plane_index < ref._nbr_planes; ++plane_index)
+	{
+		const uint8_t* src_ptr    = pic_b._data_arr [plane_index].data ();
+		ptrdiff_t      stride_src = pic_b._stride_arr [plane_index];
+		if (plane_index > 0)
+		{
+			auto &         pd = pd_out_arr [plane_index];
+			pd._win._w = w_d;
+			pd._win._h = h_d;
+			fmtcl::ResampleUtil::create_plane_specs (
+				pd, plane_index,
+				cf, w_d, 0, h_d, 0, cp,
+				cf, w_d, 1, h_d, 1, cp
+			);
+			fmtcl::FilterResize  rsz (
+				pd._spec_arr [0] [0],
+				*(pd._kernel_arr [fmtcl::FilterResize::Dir_H]._k_uptr),
+				*(pd._kernel_arr [fmtcl::FilterResize::Dir_V]._k_uptr),
+				true, 0, 0, 1,
+				fmtcl::SplFmt_FLOAT, 32, fmtcl::SplFmt_FLOAT, 32,
+				false, sse2_flag, avx2_flag, avx512_flag
+			);
+			rsz.process_plane (
+				sub._data_arr [plane_index].data (), src_ptr,
+				sub._stride_arr [plane_index], stride_src, true
+			);
+			src_ptr    = sub._data_arr [plane_index].data ();
+			stride_src = sub._stride_arr [plane_index];
+		}
+		dither.process_plane (
+			ref._data_arr [plane_index].data (), ref._stride_arr [plane_index],
+			src_ptr, stride_src,
+			ref._w_arr [plane_index], ref._h_arr [plane_index],
+			0, plane_index
+		);
+	}
+
+	double         dev = 0;
+	for (int plane_index = 0; plane_index < ref._nbr_planes; ++plane_index)
+	{
+		for (int y = 0; y < ref._h_arr [plane_index]; ++y)
+		{
+			for (int x = 0; x < ref._w_arr [plane_index]; ++x)
+			{
+				const double   v_ref = ref.get_spl (plane_index, x, y);
+				const double   v_tst = dst.get_spl (plane_index, x, y);
+				dev = std::max (dev, fabs (v_tst - v_ref));
+			}
+		}
+	}
+
+	return report ("Full chain", dev, 0);
+}
+
+
+
+void	TestConvertProc::init_kernels (fmtcl::ConvertProc::PlaneDataArray &pd_arr)
+{
+	for (auto &pd : pd_arr)
+	{
+		for (auto &kernel : pd._kernel_arr)
+		{
+			kernel.create_kernel (
+				"spline36", std::vector <double> (), 4,
+				false, 0, false, 0, false, 0, 0, false, 4
+			);
+		}
+	}
+}
+
+
+
+int	TestConvertProc::report (const char *name_0, double dev, double tol)
+{
+	assert (name_0 != nullptr);
+	assert (tol >= 0);
+
+	const bool     ok_flag = (dev <= tol);
+	printf (
+		"%-13s: max deviation %.3g (tol %.3g). %s\n",
+		name_0, dev, tol, (ok_flag) ? "OK" : "*** FAILED ***"
+	);
+	fflush (stdout);
+
+	return (ok_flag) ? 0 : -1;
+}
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,126 @@
+/*****************************************************************************
+
+        TestConvertProc.h
+        Author: Laurent de Soras, 2024
+
+Checks the fused conversion against known values, and against the same
+engines run one after the other on whole frames.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (TestConvertProc_HEADER_INCLUDED)
+#define TestConvertProc_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/ColorFamily.h"
+#include "fmtcl/ConvertProc.h"
+#include "fmtcl/Frame.h"
+#include "fmtcl/FrameRO.h"
+#include "fstb/AllocAlign.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+
+
+class TestConvertProc
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static int     perform_test ();
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	typedef std::minstd_rand Rng;
+
+	static constexpr int _max_nbr_planes = fmtcl::ConvertProc::_max_nbr_planes;
+
+	// Planar picture. Integer samples are stored in the smallest type.
+	class Pic
+	{
+	public:
+		explicit       Pic (int w, int h, int ss_h, int ss_v, fmtcl::ColorFamily cf, int bps);
+		fmtcl::Frame <>
+		               get_frame () noexcept;
+		fmtcl::FrameRO <>
+		               get_frame_ro () const noexcept;
+		double         get_spl (int plane_index, int x, int y) const noexcept;
+		void           set_spl (int plane_index, int x, int y, double val) noexcept;
+		int            _nbr_planes = 0;
+		int            _bps        = 0; // Bytes per sample
+		std::array <int, _max_nbr_planes>
+		               _w_arr {};
+		std::array <int, _max_nbr_planes>
+		               _h_arr {};
+		std::array <ptrdiff_t, _max_nbr_planes>
+		               _stride_arr {}; // Bytes
+		std::array <std::vector <uint8_t, fstb::AllocAlign <uint8_t, 64> >, _max_nbr_planes>
+		               _data_arr;
+	};
+
+	static int     test_analytic ();
+	static int     test_gray ();
+	static int     test_chain (Rng &rng);
+
+	static void    init_kernels (fmtcl::ConvertProc::PlaneDataArray &pd_arr);
+	static int     report (const char *name_0, double dev, double tol);
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               TestConvertProc ()                               = delete;
+	               TestConvertProc (const TestConvertProc &other)   = delete;
+	               TestConvertProc (TestConvertProc &&other)        = delete;
+	TestConvertProc &
+	               operator = (const TestConvertProc &other)        = delete;
+	TestConvertProc &
+	               operator = (TestConvertProc &&other)             = delete;
+	bool           operator == (const TestConvertProc &other) const = delete;
+	bool           operator != (const TestConvertProc &other) const = delete;
+
+}; // class TestConvertProc
+
+
+
+//#include "test/TestConvertProc.hpp"
+
+
+
+#endif   // TestConvertProc_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -26,10 +26,14 @@ http://www.wtfpl.net/ for more details.
 
 #include "fmtcl/PlaneRO.h"
 #include "fmtcl/GammaY.h"
+#include "fstb/CpuId.h"
 #include "fstb/fnc.h"
 #include "test/TestGammaY.h"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <random>
 #include <type_traits>
 #include <vector>
 
@@ -178,6 +182,35 @@ int	TestGammaY::perform_test ()
 		{
 			ret_val = test_achrom_row <uint16_t, float   > (16, 32, gamma);
 		}
+
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <float   , float   > (32, 32, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <uint16_t, uint16_t> (16, 16, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <uint16_t, uint16_t> (10, 16, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <uint8_t , uint16_t> ( 8, 16, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <uint8_t , float   > ( 8, 32, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <float   , uint16_t> (32, 16, gamma);
+		}
+		if (ret_val == 0)
+		{
+			ret_val = test_simd <uint16_t, float   > (16, 32, gamma);
+		}
 	}
 
 	printf ("Done.\n"); fflush (stdout);
@@ -247,7 +280,7 @@ int	TestGammaY::test_achrom_row (int src_res, int dst_res, double gamma)
 		get_splfmt <TS> (), src_res,
 		get_splfmt <TD> (), dst_res,
 		gamma, alpha,
-		false, false
+		false, false, false
 	);
 
 	fmtcl::Frame <uint8_t> dst_arr {
@@ -357,4 +390,104 @@ int	TestGammaY::test_achrom_row (int src_res, int dst_res, double gamma)
 
 
 
+// Compares the SIMD implementations with the reference C++ code, on
+// random colored data.
+template <typename TS, typename TD>
+int	TestGammaY::test_simd (int src_res, int dst_res, double gamma)
+{
+	constexpr double  alpha = 1.0;
+	constexpr int     nbr_planes = fmtcl::GammaY::_nbr_planes;
+	int            ret_val = 0;
+
+	printf (
+		"SIMD, %2d -> %2d bits: ", src_res, dst_res
+	);
+
+	// Not a multiple of the vector size, and longer than the internal buffer
+	const int      w = 2345;
+	const int      h = 1;
+	constexpr double  mi = -0.25;
+	constexpr double  ma =  1.25;
+	std::minstd_rand  gen;
+	std::uniform_real_distribution <double> dist (mi, ma);
+	std::array <std::vector <TS>, nbr_planes>  src_row_arr;
+	for (auto &row : src_row_arr)
+	{
+		row.resize (w);
+		for (auto &v : row)
+		{
+			v = conv_val <TS> (dist (gen), src_res);
+		}
+	}
+	const fmtcl::Frame <const uint8_t> src_arr {
+		{ reinterpret_cast <const uint8_t *> (src_row_arr [0].data ()), 0 },
+		{ reinterpret_cast <const uint8_t *> (src_row_arr [1].data ()), 0 },
+		{ reinterpret_cast <const uint8_t *> (src_row_arr [2].data ()), 0 }
+	};
+
+	const fstb::CpuId cpu;
+	const double   tol = (std::is_floating_point <TD>::value) ? 1e-5 : 1;
+	std::array <std::array <std::vector <TD>, nbr_planes>, 3> dst_row_arr_arr;
+	for (int impl = 0; impl < 3 && ret_val == 0; ++impl)
+	{
+		const bool     sse2_flag = (impl >= 1);
+		const bool     avx2_flag = (impl >= 2);
+		if ((sse2_flag && ! cpu._sse2_flag) || (avx2_flag && ! cpu._avx2_flag))
+		{
+			continue;
+		}
+
+		auto &         dst_row_arr = dst_row_arr_arr [impl];
+		for (auto &row : dst_row_arr)
+		{
+			row.assign (w, conv_val <TD> (0, dst_res));
+		}
+		fmtcl::Frame <uint8_t> dst_arr {
+			{ reinterpret_cast <uint8_t *> (dst_row_arr [0].data ()), 0 },
+			{ reinterpret_cast <uint8_t *> (dst_row_arr [1].data ()), 0 },
+			{ reinterpret_cast <uint8_t *> (dst_row_arr [2].data ()), 0 }
+		};
+
+		fmtcl::GammaY  gammay (
+			get_splfmt <TS> (), src_res,
+			get_splfmt <TD> (), dst_res,
+			gamma, alpha,
+			sse2_flag, avx2_flag, false
+		);
+		gammay.process_plane (dst_arr, src_arr, w, h);
+
+		if (impl == 0)
+		{
+			continue;
+		}
+
+		double         err_max = 0;
+		for (int p_idx = 0; p_idx < nbr_planes; ++p_idx)
+		{
+			for (int x = 0; x < w; ++x)
+			{
+				const double   v_ref = double (dst_row_arr_arr [0] [p_idx] [x]);
+				const double   v_tst = double (dst_row_arr [p_idx] [x]);
+				double         err   = fabs (v_tst - v_ref);
+				if (std::is_floating_point <TD>::value)
+				{
+					err /= std::max (fabs (v_ref), 1.0);
+				}
+				err_max = std::max (err_max, err);
+			}
+		}
+		printf ("%s max err = %g ", (avx2_flag) ? "AVX2" : "SSE2", err_max);
+		if (err_max > tol)
+		{
+			printf ("\n*** SIMD and C++ results differ. ***");
+			ret_val = -1;
+		}
+	}
+	printf ("\n");
+
+	return ret_val;
+}
+
+
+
 /*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
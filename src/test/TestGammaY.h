@@ -48,6 +48,8 @@ private:
 
 	template <typename TS, typename TD>
 	static int     test_achrom_row (int src_res, int dst_res, double gamma);
+	template <typename TS, typename TD>
+	static int     test_simd (int src_res, int dst_res, double gamma);
 
 
 
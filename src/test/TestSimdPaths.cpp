@@ -0,0 +1,1803 @@
+/*****************************************************************************
+
+        TestSimdPaths.cpp
+        Author: Laurent de Soras, 2024
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (1 : 4130 4223 4705 4706)
+	#pragma warning (4 : 4355 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/BitBltConv.h"
+#include "fmtcl/ContFirCubic.h"
+#include "fmtcl/ContFirLanczos.h"
+#include "fmtcl/ContFirSpline36.h"
+#include "fmtcl/Dither.h"
+#include "fmtcl/FilterResize.h"
+#include "fmtcl/Fp16Conv.h"
+#include "fmtcl/GammaY.h"
+#include "fmtcl/Lut3d.h"
+#include "fmtcl/Mat4.h"
+#include "fmtcl/Matrix2020CLProc.h"
+#include "fmtcl/MatrixProc.h"
+#include "fmtcl/PrimariesProc.h"
+#include "fmtcl/ProcComp3Arg.h"
+#include "fmtcl/ResampleSpecPlane.h"
+#include "fmtcl/TransLut.h"
+#include "fmtcl/TransOp2084.h"
+#include "fmtcl/TransOpHlg.h"
+#include "fmtcl/TransOpLinPow.h"
+#include "fmtcl/TransOpLogC.h"
+#include "fmtcl/TransOpPow.h"
+#include "fmtcl/TransOpSLog3.h"
+#include "fstb/fnc.h"
+#include "test/TestSimdPaths.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+int	TestSimdPaths::perform_test ()
+{
+	int            ret_val = 0;
+
+	printf ("Testing SIMD code paths against C++...\n");
+	fflush (stdout);
+
+	// Each engine has its own generator so a failing engine can be tested
+	// alone without changing the configurations.
+	typedef int (*TestFnc) (Rng &rng);
+	static const std::array <TestFnc, 11> fnc_arr
+	{{
+		&test_bitblt, &test_scaler, &test_resize, &test_matrix,
+		&test_m2020cl, &test_translut, &test_transdirect, &test_dither,
+		&test_lut3d, &test_primaries, &test_gammay
+	}};
+	for (const auto fnc_ptr : fnc_arr)
+	{
+		Rng            rng;
+		const int      ret_loc = fnc_ptr (rng);
+		if (ret_loc != 0)
+		{
+			ret_val = ret_loc;
+		}
+	}
+
+	if (ret_val == 0)
+	{
+		printf ("Done.\n");
+	}
+
+	return ret_val;
+}
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+// The line stride gets up to 4 additional blocks of padding, and the
+// beginning of the picture is moved by up to 3 blocks to the left.
+TestSimdPaths::PlaneBuf::PlaneBuf (Rng &rng, int w, int h, fmtcl::SplFmt fmt, int res)
+:	_w (w)
+,	_h (h)
+,	_fmt (fmt)
+,	_res (res)
+,	_unit_sz (fmtcl::SplFmt_get_unit_size (fmt))
+{
+	assert (w > 0);
+	assert (h > 0);
+	assert (fmt >= 0);
+	assert (fmt < fmtcl::SplFmt_NBR_ELT);
+	assert (res > 0);
+
+	const int      lw  = (w * _unit_sz + _align - 1) & -_align;
+	const int      pad = gen_int (rng, 0, 4);
+	const int      ofs = gen_int (rng, 0, 3);
+	_stride = lw + _margin_b * 2 + pad * _align;
+	_offset = _stride * _margin_l + _margin_b - ofs * _align;
+	_buf.resize (size_t (_stride) * size_t (h + _margin_l * 2));
+}
+
+
+
+// For integer formats, the range is given relative to the maximum value and
+// the result is clipped to the format range. The whole buffer is filled, so
+// the SIMD code reading outside the picture doesn't get denormals or NaN.
+// Half-float data is clipped to the finite range.
+void	TestSimdPaths::PlaneBuf::fill_rnd (Rng &rng, double v_min, double v_max)
+{
+	assert (v_min <= v_max);
+
+	const int      nbr_spl = int (_buf.size () / size_t (_unit_sz));
+	if (_fmt == fmtcl::SplFmt_FLOAT)
+	{
+		const float    v_min_f = float (v_min);
+		const float    v_max_f = float (v_max);
+		std::uniform_real_distribution <float> dist (v_min_f, v_max_f);
+		float *        data_ptr = reinterpret_cast <float *> (_buf.data ());
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			data_ptr [pos] = dist (rng);
+		}
+	}
+	else if (_fmt == fmtcl::SplFmt_FLOAT16)
+	{
+		const float    v_min_f = float (std::max (v_min, -65504.0));
+		const float    v_max_f = float (std::min (v_max, +65504.0));
+		std::uniform_real_distribution <float> dist (v_min_f, v_max_f);
+		uint16_t *     data_ptr = reinterpret_cast <uint16_t *> (_buf.data ());
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			data_ptr [pos] = fmtcl::Fp16Conv::conv_spl_to_fp16 (dist (rng));
+		}
+	}
+	else
+	{
+		const int      v_max_fmt = (1 << _res) - 1;
+		const int      v_min_i   = fstb::round_int (v_min * v_max_fmt);
+		const int      v_max_i   = fstb::round_int (v_max * v_max_fmt);
+		std::uniform_int_distribution <int> dist (v_min_i, v_max_i);
+		for (int pos = 0; pos < nbr_spl; ++pos)
+		{
+			const int      val = fstb::limit (dist (rng), 0, v_max_fmt);
+			if (_fmt == fmtcl::SplFmt_INT16)
+			{
+				reinterpret_cast <uint16_t *> (_buf.data ()) [pos] = uint16_t (val);
+			}
+			else
+			{
+				_buf [pos] = uint8_t (val);
+			}
+		}
+	}
+}
+
+
+
+void	TestSimdPaths::PlaneBuf::fill_cst (uint8_t val)
+{
+	std::fill (_buf.begin (), _buf.end (), val);
+}
+
+
+
+// Integer formats only. Fills the picture area with a sample value.
+void	TestSimdPaths::PlaneBuf::fill_int (int val)
+{
+	assert (_fmt == fmtcl::SplFmt_INT8 || _fmt == fmtcl::SplFmt_INT16);
+	assert (val >= 0);
+	assert (val < (1 << _res));
+
+	for (int y = 0; y < _h; ++y)
+	{
+		uint8_t *      line_ptr = get_ptr () + y * _stride;
+		for (int x = 0; x < _w; ++x)
+		{
+			if (_fmt == fmtcl::SplFmt_INT8)
+			{
+				line_ptr [x] = uint8_t (val);
+			}
+			else
+			{
+				reinterpret_cast <uint16_t *> (line_ptr) [x] = uint16_t (val);
+			}
+		}
+	}
+}
+
+
+
+uint8_t *	TestSimdPaths::PlaneBuf::get_ptr () noexcept
+{
+	return _buf.data () + _offset;
+}
+
+
+
+const uint8_t *	TestSimdPaths::PlaneBuf::get_ptr () const noexcept
+{
+	return _buf.data () + _offset;
+}
+
+
+
+ptrdiff_t	TestSimdPaths::PlaneBuf::get_stride () const noexcept
+{
+	return _stride;
+}
+
+
+
+ptrdiff_t	TestSimdPaths::PlaneBuf::get_stride_pix () const noexcept
+{
+	return _stride / _unit_sz;
+}
+
+
+
+// Only the picture area is compared. A NaN in a single output counts as an
+// infinite deviation. For half-float data, a difference of a single rounding
+// step is inherent to the format and is not counted.
+void	TestSimdPaths::Result::update (const PlaneBuf &ref, const PlaneBuf &tst)
+{
+	assert (ref.get_w () == tst.get_w ());
+	assert (ref.get_h () == tst.get_h ());
+	assert (ref.get_fmt () == tst.get_fmt ());
+
+	const int      w = ref.get_w ();
+	const int      h = ref.get_h ();
+	for (int y = 0; y < h; ++y)
+	{
+		const uint8_t* ref_ptr = ref.get_ptr () + y * ref.get_stride ();
+		const uint8_t* tst_ptr = tst.get_ptr () + y * tst.get_stride ();
+		switch (ref.get_fmt ())
+		{
+		case fmtcl::SplFmt_FLOAT:
+			for (int x = 0; x < w; ++x)
+			{
+				const float    v_ref = reinterpret_cast <const float *> (ref_ptr) [x];
+				const float    v_tst = reinterpret_cast <const float *> (tst_ptr) [x];
+				double         dev   = 0;
+				if (std::isnan (v_ref) != std::isnan (v_tst))
+				{
+					dev = std::numeric_limits <double>::infinity ();
+				}
+				else if (! std::isnan (v_ref))
+				{
+					dev = fabs (double (v_tst) - double (v_ref));
+				}
+				_dev_flt = std::max (_dev_flt, dev);
+			}
+			break;
+		case fmtcl::SplFmt_FLOAT16:
+			for (int x = 0; x < w; ++x)
+			{
+				const uint16_t h_ref = reinterpret_cast <const uint16_t *> (ref_ptr) [x];
+				const uint16_t h_tst = reinterpret_cast <const uint16_t *> (tst_ptr) [x];
+				const double   v_ref = fmtcl::Fp16Conv::conv_spl_to_flt (h_ref);
+				const double   v_tst = fmtcl::Fp16Conv::conv_spl_to_flt (h_tst);
+				double         dev   = 0;
+				if (std::isnan (v_ref) != std::isnan (v_tst))
+				{
+					dev = std::numeric_limits <double>::infinity ();
+				}
+				else if (! std::isnan (v_ref) && h_tst != h_ref)
+				{
+					const uint16_t h_max =
+						uint16_t (std::max (h_ref & 0x7FFF, h_tst & 0x7FFF));
+					dev = std::max (fabs (v_tst - v_ref) - get_fp16_step (h_max), 0.0);
+				}
+				_dev_flt = std::max (_dev_flt, dev);
+			}
+			break;
+		case fmtcl::SplFmt_INT16:
+			for (int x = 0; x < w; ++x)
+			{
+				const int      v_ref = reinterpret_cast <const uint16_t *> (ref_ptr) [x];
+				const int      v_tst = reinterpret_cast <const uint16_t *> (tst_ptr) [x];
+				_dev_int = std::max (_dev_int, std::abs (v_tst - v_ref));
+			}
+			break;
+		case fmtcl::SplFmt_INT8:
+			for (int x = 0; x < w; ++x)
+			{
+				_dev_int = std::max (_dev_int, std::abs (tst_ptr [x] - ref_ptr [x]));
+			}
+			break;
+		default:
+			assert (false);
+			break;
+		}
+	}
+
+	_nbr_cmp += w * h;
+}
+
+
+
+// Distance between the given positive half-float value and the next one
+double	TestSimdPaths::Result::get_fp16_step (uint16_t x) noexcept
+{
+	assert (x < 0x8000);
+
+	const int      e = std::max (x >> 10, 1);
+
+	return ldexp (1.0, e - 25);
+}
+
+
+
+int	TestSimdPaths::Result::report (const char *engine_0, int tol_int, double tol_flt) const
+{
+	assert (engine_0 != nullptr);
+	assert (tol_int >= 0);
+	assert (tol_flt >= 0);
+
+	const bool     ok_flag = (_dev_int <= tol_int && _dev_flt <= tol_flt);
+	printf (
+		"%-13s: %8d pixels, max deviation %d LSB (tol %d) / %.3g (tol %.3g). %s\n",
+		engine_0, _nbr_cmp, _dev_int, tol_int, _dev_flt, tol_flt,
+		(ok_flag) ? "OK" : "*** FAILED ***"
+	);
+	fflush (stdout);
+
+	return (ok_flag) ? 0 : -1;
+}
+
+
+
+int	TestSimdPaths::test_bitblt (Rng &rng)
+{
+	Result         result;
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		fmtcl::SplFmt  fmt_src = fmtcl::SplFmt_FLOAT;
+		int            res_src = 32;
+		fmtcl::SplFmt  fmt_dst = fmtcl::SplFmt_FLOAT;
+		int            res_dst = 32;
+		bool           scale_flag = false;
+		switch (gen_int (rng, 0, 3))
+		{
+		// Integer bitdepth increase
+		case 0:
+			res_src = pick (rng, { 8, 9, 10, 12, 14 });
+			do
+			{
+				res_dst = pick (rng, { 9, 10, 12, 14, 16 });
+			}
+			while (res_dst <= res_src);
+			fmt_src = get_int_fmt (res_src);
+			fmt_dst = get_int_fmt (res_dst);
+			break;
+		// Integer to float
+		case 1:
+			res_src    = pick (rng, { 8, 9, 10, 12, 14, 16 });
+			fmt_src    = get_int_fmt (res_src);
+			scale_flag = (gen_int (rng, 0, 1) != 0);
+			pick_fp16 (rng, fmt_dst, res_dst);
+			break;
+		// Float to integer, only 16 bits are supported
+		case 2:
+			res_dst    = 16;
+			fmt_dst    = fmtcl::SplFmt_INT16;
+			scale_flag = (gen_int (rng, 0, 1) != 0);
+			pick_fp16 (rng, fmt_src, res_src);
+			break;
+		// Float to float, at least one side in half-float, as in fmtc.bitdepth
+		case 3:
+			scale_flag = (gen_int (rng, 0, 1) != 0);
+			if (gen_int (rng, 0, 1) != 0)
+			{
+				fmt_src = fmtcl::SplFmt_FLOAT16;
+				res_src = 16;
+				pick_fp16 (rng, fmt_dst, res_dst);
+			}
+			else
+			{
+				fmt_dst = fmtcl::SplFmt_FLOAT16;
+				res_dst = 16;
+				pick_fp16 (rng, fmt_src, res_src);
+			}
+			break;
+		default:
+			assert (false);
+			break;
+		}
+
+		fmtcl::BitBltConv::ScaleInfo  scale_info;
+		if (scale_flag)
+		{
+			scale_info._gain    = gen_flt (rng, 0.5, 2.0);
+			scale_info._add_cst = gen_flt (rng, -0.25, 0.25);
+			if (! fmtcl::SplFmt_is_float (fmt_dst))
+			{
+				scale_info._gain    *= 65535;
+				scale_info._add_cst *= 65535;
+			}
+			else if (! fmtcl::SplFmt_is_float (fmt_src))
+			{
+				scale_info._gain /= double ((1 << res_src) - 1);
+			}
+		}
+		const auto     si_ptr = (scale_flag) ? &scale_info : nullptr;
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+		// Without scaling, float data is converted as is to integer
+		const double   src_scale = (
+			   fmtcl::SplFmt_is_float (fmt_src)
+			&& ! fmtcl::SplFmt_is_float (fmt_dst)
+			&& ! scale_flag
+		) ? 65535 : 1;
+		PlaneBuf       src (rng, w, h, fmt_src, res_src);
+		src.fill_rnd (rng, -0.25 * src_scale, 1.25 * src_scale);
+
+		PlaneBuf       dst_ref (rng, w, h, fmt_dst, res_dst);
+		dst_ref.fill_cst (0);
+		fmtcl::BitBltConv blitter_ref (false, false, false);
+		blitter_ref.bitblt (
+			fmt_dst, res_dst, dst_ref.get_ptr (), dst_ref.get_stride (),
+			fmt_src, res_src, src.get_ptr (), src.get_stride (),
+			w, h, si_ptr
+		);
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			PlaneBuf       dst_tst (rng, w, h, fmt_dst, res_dst);
+			dst_tst.fill_cst (0);
+			fmtcl::BitBltConv blitter (
+				cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			blitter.bitblt (
+				fmt_dst, res_dst, dst_tst.get_ptr (), dst_tst.get_stride (),
+				fmt_src, res_src, src.get_ptr (), src.get_stride (),
+				w, h, si_ptr
+			);
+			result.update (dst_ref, dst_tst);
+		}
+	}
+
+	return result.report ("BitBltConv", 1, 1e-6);
+}
+
+
+
+// Single pass, horizontal or vertical, random resizing ratio
+int	TestSimdPaths::test_scaler (Rng &rng)
+{
+	Result         result;
+
+	fmtcl::ContFirSpline36  kernel_s36;
+	fmtcl::ContFirLanczos   kernel_l4 (4);
+	fmtcl::ContFirCubic     kernel_bic (1.0 / 3, 1.0 / 3);
+	const std::array <fmtcl::ContFirInterface *, 3> kernel_arr
+	{{
+		&kernel_s36, &kernel_l4, &kernel_bic
+	}};
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const bool     h_flag   = (gen_int (rng, 0, 1) != 0);
+		const bool     int_flag = (gen_int (rng, 0, 1) != 0);
+		fmtcl::SplFmt  fmt_src  = fmtcl::SplFmt_INT16;
+		int            res_src  = 16;
+		fmtcl::SplFmt  fmt_dst  = fmtcl::SplFmt_INT16;
+		int            res_dst  = 16;
+		if (int_flag)
+		{
+			res_src = pick (rng, { 8, 9, 10, 12, 14, 16 });
+			fmt_src = get_int_fmt (res_src);
+		}
+		else
+		{
+			res_src = pick (rng, { 8, 16, 32 });
+			fmt_src = (res_src == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_src);
+			res_dst = pick (rng, { 16, 32 });
+			fmt_dst = (res_dst == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_dst);
+		}
+
+		// Gain for the bitdepth conversion, as done by FilterResize
+		double         gain = 1;
+		if (! int_flag)
+		{
+			const double   mul_s = (fmt_src == fmtcl::SplFmt_FLOAT) ? 1.0 : double (1 << res_src);
+			const double   mul_d = (fmt_dst == fmtcl::SplFmt_FLOAT) ? 1.0 : double (1 << res_dst);
+			gain = mul_d / mul_s;
+		}
+
+		const int      kernel_idx = gen_int (rng, 0, int (kernel_arr.size ()) - 1);
+		auto &         kernel     = *kernel_arr [kernel_idx];
+		const int      len_src    = gen_int (rng, 4, 150);
+		const int      len_dst    = gen_int (rng, 4, 150);
+		const int      len_other  = gen_int (rng, 1, 150);
+		const int      w_src = (h_flag) ? len_src : len_other;
+		const int      h_src = (h_flag) ? len_other : len_src;
+		const int      w_dst = (h_flag) ? len_dst : len_other;
+		const int      h_dst = (h_flag) ? len_other : len_dst;
+
+		PlaneBuf       src (rng, w_src, h_src, fmt_src, res_src);
+		src.fill_rnd (rng, -0.25, 1.25);
+
+		PlaneBuf       dst_ref (rng, w_dst, h_dst, fmt_dst, res_dst);
+		dst_ref.fill_cst (0);
+		{
+			fmtcl::Scaler  scaler (
+				len_src, len_dst, 0, len_src, kernel, 1,
+				true, 0, 0, 0, gain, 0,
+				int_flag, false, false, false
+			);
+			if (h_flag)
+			{
+				scaler.setup_h ();
+			}
+			run_scaler (scaler, h_flag, int_flag, dst_ref, src);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			PlaneBuf       dst_tst (rng, w_dst, h_dst, fmt_dst, res_dst);
+			dst_tst.fill_cst (0);
+			fmtcl::Scaler  scaler (
+				len_src, len_dst, 0, len_src, kernel, 1,
+				true, 0, 0, 0, gain, 0,
+				int_flag, cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			if (h_flag)
+			{
+				scaler.setup_h ();
+			}
+			run_scaler (scaler, h_flag, int_flag, dst_tst, src);
+			result.update (dst_ref, dst_tst);
+		}
+	}
+
+	return result.report ("Scaler", 1, 1e-5);
+}
+
+
+
+// Full FilterResize chain with integer processing, so the transpositions
+// and the direct horizontal passes are both exercised. The gains cover the
+// range conversions, the 16-bit buffers are then scaled by coefficients
+// not summing to 1.
+// The reference path is also checked on a flat picture against the exact
+// range conversion, to catch offset errors common to all the paths. The
+// tolerance covers the quantization of the integer coefficients.
+int	TestSimdPaths::test_resize (Rng &rng)
+{
+	Result         result;
+	Result         result_dc;
+
+	fmtcl::ContFirSpline36  kernel_s36;
+	fmtcl::ContFirLanczos   kernel_l4 (4);
+	fmtcl::ContFirCubic     kernel_bic (1.0 / 3, 1.0 / 3);
+	const std::array <fmtcl::ContFirInterface *, 3> kernel_arr
+	{{
+		&kernel_s36, &kernel_l4, &kernel_bic
+	}};
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const int      res_src  = pick (rng, { 8, 9, 10, 12, 14, 16 });
+		const auto     fmt_src  = get_int_fmt (res_src);
+		const bool     full_s   = (gen_int (rng, 0, 1) != 0);
+		const bool     full_d   = (gen_int (rng, 0, 1) != 0);
+		const double   mul_s    = (full_s)
+			? double ((1 << res_src) - 1) : double (219 << (res_src - 8));
+		const double   mul_d    = (full_d) ? 65535.0 : double (219 << 8);
+		const double   gain     = mul_d / mul_s;
+		const double   ofs_s    = (full_s) ? 0.0 : double (16 << (res_src - 8));
+		const double   ofs_d    = (full_d) ? 0.0 : double (16 << 8);
+
+		const int      kernel_idx = gen_int (rng, 0, int (kernel_arr.size ()) - 1);
+		auto &         kernel     = *kernel_arr [kernel_idx];
+
+		fmtcl::ResampleSpecPlane   spec {};
+		spec._src_width      = gen_int (rng, 4, 150);
+		spec._src_height     = gen_int (rng, 4, 150);
+		spec._dst_width      = gen_int (rng, 4, 300);
+		spec._dst_height     = gen_int (rng, 4, 300);
+		spec._win_w          = spec._src_width;
+		spec._win_h          = spec._src_height;
+		spec._kernel_scale_h = 1;
+		spec._kernel_scale_v = 1;
+		spec._add_cst        = ofs_d - ofs_s * gain;
+		spec._kernel_hash_h  = uint32_t (kernel_idx + 1);
+		spec._kernel_hash_v  = uint32_t (kernel_idx + 1);
+
+		PlaneBuf       src (
+			rng, spec._src_width, spec._src_height, fmt_src, res_src
+		);
+		src.fill_rnd (rng, -0.25, 1.25);
+
+		PlaneBuf       dst_ref (
+			rng, spec._dst_width, spec._dst_height, fmtcl::SplFmt_INT16, 16
+		);
+		dst_ref.fill_cst (0);
+		{
+			fmtcl::FilterResize  filter (
+				spec, kernel, kernel, true, 0, 0, gain,
+				fmt_src, res_src, fmtcl::SplFmt_INT16, 16,
+				true, false, false, false
+			);
+
+			// Flat picture first
+			const int      val_s = int (ofs_s) + gen_int (rng, 0, int (mul_s));
+			const int      val_d = fstb::limit (
+				fstb::round_int ((val_s - ofs_s) * gain + ofs_d), 0, 65535
+			);
+			PlaneBuf       src_dc (
+				rng, spec._src_width, spec._src_height, fmt_src, res_src
+			);
+			src_dc.fill_int (val_s);
+			PlaneBuf       dst_exp (
+				rng, spec._dst_width, spec._dst_height, fmtcl::SplFmt_INT16, 16
+			);
+			dst_exp.fill_int (val_d);
+			filter.process_plane (
+				dst_ref.get_ptr (), src_dc.get_ptr (),
+				dst_ref.get_stride (), src_dc.get_stride (), false
+			);
+			result_dc.update (dst_exp, dst_ref);
+
+			filter.process_plane (
+				dst_ref.get_ptr (), src.get_ptr (),
+				dst_ref.get_stride (), src.get_stride (), false
+			);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			PlaneBuf       dst_tst (
+				rng, spec._dst_width, spec._dst_height, fmtcl::SplFmt_INT16, 16
+			);
+			dst_tst.fill_cst (0);
+			fmtcl::FilterResize  filter (
+				spec, kernel, kernel, true, 0, 0, gain,
+				fmt_src, res_src, fmtcl::SplFmt_INT16, 16,
+				true, cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			filter.process_plane (
+				dst_tst.get_ptr (), src.get_ptr (),
+				dst_tst.get_stride (), src.get_stride (), false
+			);
+			result.update (dst_ref, dst_tst);
+		}
+	}
+
+	int            ret_val = result.report ("FilterResize", 1, 0);
+	if (result_dc.report ("FilterRes DC", 8, 0) != 0)
+	{
+		ret_val = -1;
+	}
+
+	return ret_val;
+}
+
+
+
+// Random matrices around the BT.709 YCbCr to RGB conversion, 1 or 3 output
+// planes
+int	TestSimdPaths::test_matrix (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::ProcComp3Arg::_nbr_planes;
+
+	Result         result;
+
+	static const double  mat_base [fmtcl::Mat4::VECT_SIZE] [fmtcl::Mat4::VECT_SIZE] =
+	{
+		{ 1,  0     ,  1.5748, -0.7874 },
+		{ 1, -0.1873, -0.4681,  0.3277 },
+		{ 1,  1.8556,  0     , -0.9278 },
+		{ 0,  0     ,  0     ,  1      }
+	};
+
+	int            nbr_skipped = 0;
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const bool     int_flag = (gen_int (rng, 0, 3) != 0);
+		int            res_src  = 32;
+		int            res_dst  = 32;
+		if (int_flag)
+		{
+			res_src = pick (rng, { 8, 9, 10, 12, 14, 16 });
+			res_dst = pick (rng, { 8, 9, 10, 12, 14, 16 });
+		}
+		auto           fmt_src = (int_flag) ? get_int_fmt (res_src) : fmtcl::SplFmt_FLOAT;
+		auto           fmt_dst = (int_flag) ? get_int_fmt (res_dst) : fmtcl::SplFmt_FLOAT;
+		pick_fp16 (rng, fmt_src, res_src);
+		pick_fp16 (rng, fmt_dst, res_dst);
+		const int      plane_out = gen_int (rng, -1, nbr_planes - 1);
+		const int      nbr_planes_out = (plane_out < 0) ? nbr_planes : 1;
+
+		fmtcl::Mat4    mat (mat_base);
+		for (int y = 0; y < nbr_planes; ++y)
+		{
+			for (int x = 0; x < fmtcl::Mat4::VECT_SIZE; ++x)
+			{
+				mat [y] [x] += gen_flt (rng, -0.1, 0.1);
+			}
+		}
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		fmtcl::ProcComp3Arg  arg_ref;
+		arg_ref._w = w;
+		arg_ref._h = h;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_src, res_src)
+			);
+			auto &         buf = *src_arr.back ();
+			buf.fill_rnd (rng, -0.25, 1.25);
+			arg_ref._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+		auto           arg_tst = arg_ref;
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		for (int p = 0; p < nbr_planes_out; ++p)
+		{
+			dst_ref_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+			);
+			auto &         buf = *dst_ref_arr.back ();
+			buf.fill_cst (0);
+			arg_ref._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		fmtcl::MatrixProc mat_proc_ref (false, false, false, false, false);
+		const auto     err = mat_proc_ref.configure (
+			mat, int_flag, fmt_src, res_src, fmt_dst, res_dst, plane_out
+		);
+		if (err != fmtcl::MatrixProc::Err_OK)
+		{
+			// Unsupported format combination or too large coefficients
+			++ nbr_skipped;
+			continue;
+		}
+		mat_proc_ref.process (arg_ref);
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes_out; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+				);
+				auto &         buf = *dst_tst_arr.back ();
+				buf.fill_cst (0);
+				arg_tst._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+			}
+
+			fmtcl::MatrixProc mat_proc (
+				cpu.has_sse (), cpu.has_sse2 (), cpu.has_avx (), cpu.has_avx2 (),
+				cpu.has_avx512bw ()
+			);
+			mat_proc.configure (
+				mat, int_flag, fmt_src, res_src, fmt_dst, res_dst, plane_out
+			);
+			mat_proc.process (arg_tst);
+
+			for (int p = 0; p < nbr_planes_out; ++p)
+			{
+				result.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+		}
+	}
+
+	if (nbr_skipped > 0)
+	{
+		printf ("MatrixProc: %d unsupported configurations skipped.\n", nbr_skipped);
+	}
+
+	return result.report ("MatrixProc", 1, 1e-5);
+}
+
+
+
+// Both directions. On the YCbCr side, integer data may have any of the
+// supported bitdepths, the RGB side is always 16 bits.
+// The float SIMD code evaluates the transfer curve with a LUT which is
+// valid only for the nominal RGB range, so the float YCbCr input is made
+// of converted RGB data.
+int	TestSimdPaths::test_m2020cl (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::Matrix2020CLProc::_nbr_planes;
+
+	Result         result;
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const bool     to_yuv_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     full_flag   = (gen_int (rng, 0, 1) != 0);
+		const bool     int_flag    = (gen_int (rng, 0, 3) != 0);
+		int            res_yuv     = 32;
+		int            res_rgb     = 32;
+		if (int_flag)
+		{
+			res_yuv = pick (rng, { 8, 9, 10, 11, 12, 14, 16 });
+			res_rgb = fmtcl::Matrix2020CLProc::_rgb_int_bits;
+		}
+		const int      res_src = (to_yuv_flag) ? res_rgb : res_yuv;
+		const int      res_dst = (to_yuv_flag) ? res_yuv : res_rgb;
+		const auto     fmt_src =
+			(int_flag) ? get_int_fmt (res_src) : fmtcl::SplFmt_FLOAT;
+		const auto     fmt_dst =
+			(int_flag) ? get_int_fmt (res_dst) : fmtcl::SplFmt_FLOAT;
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		fmtcl::ProcComp3Arg  arg_ref;
+		arg_ref._w = w;
+		arg_ref._h = h;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_src, res_src)
+			);
+			auto &         buf = *src_arr.back ();
+			buf.fill_rnd (rng, 0, 1);
+			arg_ref._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		if (! int_flag && ! to_yuv_flag)
+		{
+			std::vector <std::unique_ptr <PlaneBuf> > rgb_arr;
+			fmtcl::ProcComp3Arg  arg_rgb;
+			arg_rgb._w = w;
+			arg_rgb._h = h;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				rgb_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_src, res_src)
+				);
+				auto &         buf = *rgb_arr.back ();
+				buf.fill_rnd (rng, 0, 1);
+				arg_rgb._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+				arg_rgb._dst [p] = fmtcl::Plane <> (
+					src_arr [p]->get_ptr (), int (src_arr [p]->get_stride ())
+				);
+			}
+			fmtcl::Matrix2020CLProc proc_rgb (false, false, false);
+			proc_rgb.configure (
+				true, fmt_src, res_src, fmt_src, res_src, full_flag
+			);
+			proc_rgb.process (arg_rgb);
+		}
+		auto           arg_tst = arg_ref;
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			dst_ref_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+			);
+			auto &         buf = *dst_ref_arr.back ();
+			buf.fill_cst (0);
+			arg_ref._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		{
+			fmtcl::Matrix2020CLProc proc_ref (false, false, false);
+			const auto     err = proc_ref.configure (
+				to_yuv_flag, fmt_src, res_src, fmt_dst, res_dst, full_flag
+			);
+			assert (err == fmtcl::Matrix2020CLProc::Err_OK);
+			fstb::unused (err);
+			proc_ref.process (arg_ref);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+				);
+				auto &         buf = *dst_tst_arr.back ();
+				buf.fill_cst (0);
+				arg_tst._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+			}
+
+			fmtcl::Matrix2020CLProc proc (
+				cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			proc.configure (
+				to_yuv_flag, fmt_src, res_src, fmt_dst, res_dst, full_flag
+			);
+			proc.process (arg_tst);
+
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				result.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+		}
+	}
+
+	return result.report ("M2020CLProc", 0, 1e-5);
+}
+
+
+
+int	TestSimdPaths::test_translut (Rng &rng)
+{
+	Result         result;
+
+	const fmtcl::TransOpLinPow curve_709_d (false, 1.099, 0.018, 0.45, 4.5);
+	const fmtcl::TransOpLinPow curve_709_i (true , 1.099, 0.018, 0.45, 4.5);
+	const fmtcl::TransOpPow    curve_pow_d (false, 2.2);
+	const fmtcl::TransOp2084   curve_pq_i (true);
+	const std::array <const fmtcl::TransOpInterface *, 4> curve_arr
+	{{
+		&curve_709_d, &curve_709_i, &curve_pow_d, &curve_pq_i
+	}};
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const auto &   curve =
+			*curve_arr [gen_int (rng, 0, int (curve_arr.size ()) - 1)];
+		const bool     loglut_flag = fmtcl::TransLut::is_loglut_req (curve);
+		int            res_src = pick (rng, { 8, 9, 10, 12, 16, 32 });
+		int            res_dst = pick (rng, { 8, 10, 16, 32 });
+		auto           fmt_src =
+			(res_src == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_src);
+		auto           fmt_dst =
+			(res_dst == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_dst);
+		pick_fp16 (rng, fmt_src, res_src);
+		pick_fp16 (rng, fmt_dst, res_dst);
+		const bool     full_src_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     full_dst_flag = (gen_int (rng, 0, 1) != 0);
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+		PlaneBuf       src (rng, w, h, fmt_src, res_src);
+		src.fill_rnd (rng, -0.25, 1.25);
+		const fmtcl::PlaneRO <> plane_src (src.get_ptr (), int (src.get_stride ()));
+
+		PlaneBuf       dst_ref (rng, w, h, fmt_dst, res_dst);
+		dst_ref.fill_cst (0);
+		{
+			fmtcl::TransLut   lut (
+				curve, loglut_flag,
+				fmt_src, res_src, full_src_flag,
+				fmt_dst, res_dst, full_dst_flag,
+				false, false, false
+			);
+			lut.process_plane (
+				fmtcl::Plane <> (dst_ref.get_ptr (), int (dst_ref.get_stride ())),
+				plane_src, w, h
+			);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			PlaneBuf       dst_tst (rng, w, h, fmt_dst, res_dst);
+			dst_tst.fill_cst (0);
+			fmtcl::TransLut   lut (
+				curve, loglut_flag,
+				fmt_src, res_src, full_src_flag,
+				fmt_dst, res_dst, full_dst_flag,
+				cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			lut.process_plane (
+				fmtcl::Plane <> (dst_tst.get_ptr (), int (dst_tst.get_stride ())),
+				plane_src, w, h
+			);
+			result.update (dst_ref, dst_tst);
+		}
+	}
+
+	return result.report ("TransLut", 0, 1e-5);
+}
+
+
+
+// Float to float only. The curves are selected to keep their output in a
+// range where an absolute tolerance makes sense.
+int	TestSimdPaths::test_transdirect (Rng &rng)
+{
+	typedef std::shared_ptr <const fmtcl::TransOpInterface> OpSPtr;
+
+	Result         result;
+
+	const std::array <OpSPtr, 10> curve_arr
+	{{
+		std::make_shared <fmtcl::TransOpLinPow> (false, 1.099, 0.018, 0.45, 4.5),
+		std::make_shared <fmtcl::TransOpLinPow> (true , 1.099, 0.018, 0.45, 4.5),
+		std::make_shared <fmtcl::TransOpLinPow> (
+			false, 1.055, 0.0031308, 1 / 2.4, 12.92, -1, 2, 1
+		),
+		std::make_shared <fmtcl::TransOpPow> (false, 2.2),
+		std::make_shared <fmtcl::TransOp2084> (false),
+		std::make_shared <fmtcl::TransOp2084> (true),
+		std::make_shared <fmtcl::TransOpHlg> (false),
+		std::make_shared <fmtcl::TransOpHlg> (true),
+		std::make_shared <fmtcl::TransOpLogC> (
+			false, fmtcl::TransOpLogC::LType_LOGC_V3,
+			fmtcl::TransOpLogC::ExpIdx_800
+		),
+		std::make_shared <fmtcl::TransOpSLog3> (false)
+	}};
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const auto &   curve_sptr =
+			curve_arr [gen_int (rng, 0, int (curve_arr.size ()) - 1)];
+		const auto     fmt = fmtcl::SplFmt_FLOAT;
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+		PlaneBuf       src (rng, w, h, fmt, 32);
+		src.fill_rnd (rng, -0.25, 1.25);
+
+		PlaneBuf       dst_ref (rng, w, h, fmt, 32);
+		dst_ref.fill_cst (0);
+		for (int y = 0; y < h; ++y)
+		{
+			const auto     s_ptr = reinterpret_cast <const float *> (
+				src.get_ptr () + y * src.get_stride ()
+			);
+			const auto     d_ptr = reinterpret_cast <float *> (
+				dst_ref.get_ptr () + y * dst_ref.get_stride ()
+			);
+			for (int x = 0; x < w; ++x)
+			{
+				d_ptr [x] = float ((*curve_sptr) (double (s_ptr [x])));
+			}
+		}
+
+		PlaneBuf       dst_tst (rng, w, h, fmt, 32);
+		dst_tst.fill_cst (0);
+		fmtcl::TransLut   lut (
+			curve_sptr, false, fmt, 32, true, fmt, 32, true, true,
+			true, false, false
+		);
+		assert (lut.is_direct ());
+		lut.process_plane (
+			fmtcl::Plane <> (dst_tst.get_ptr (), int (dst_tst.get_stride ())),
+			fmtcl::PlaneRO <> (src.get_ptr (), int (src.get_stride ())),
+			w, h
+		);
+		result.update (dst_ref, dst_tst);
+	}
+
+	return result.report ("TransDirect", 0, 1e-5);
+}
+
+
+
+// All the dithering methods, on 3 YUV planes. When possible, the SIMD paths
+// randomly use the 3-plane error diffusion.
+int	TestSimdPaths::test_dither (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::ProcComp3Arg::_nbr_planes;
+
+	Result         result_ord;
+	Result         result_ed;
+	Result         result_simd;
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const auto     dmode   = fmtcl::Dither::DMode (
+			it % fmtcl::Dither::DMode_NBR_ELT
+		);
+		const bool     errdif_flag = (
+			   dmode >= fmtcl::Dither::DMode_FILTERLITE
+			&& dmode <= fmtcl::Dither::DMode_OSTRO
+		);
+		int            res_src = pick (rng, { 9, 10, 12, 14, 16, 32 });
+		int            res_dst = 0;
+		do
+		{
+			res_dst = pick (rng, { 8, 9, 10, 12 });
+		}
+		while (res_dst >= res_src);
+		auto           fmt_src =
+			(res_src == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_src);
+		pick_fp16 (rng, fmt_src, res_src);
+		const auto     fmt_dst = get_int_fmt (res_dst);
+		const bool     full_src_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     full_dst_flag = (gen_int (rng, 0, 1) != 0);
+		const int      pat_size  = pick (rng, { 8, 16, 32, 64 });
+		const double   ampo      = gen_flt (rng, 0, 2);
+		const double   ampn      = (gen_int (rng, 0, 1) != 0) ? gen_flt (rng, 0, 1) : 0;
+		const bool     dyn_flag  = (gen_int (rng, 0, 1) != 0);
+		const bool     stat_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     corr_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     tpdfo_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     tpdfn_flag = (gen_int (rng, 0, 1) != 0);
+		const bool     use_3p_flag = (gen_int (rng, 0, 1) != 0);
+		const int      frame_index = gen_int (rng, 0, 1000);
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_src, res_src)
+			);
+			src_arr.back ()->fill_rnd (rng, -0.25, 1.25);
+		}
+
+		auto           create_dither = [&] (bool sse2_flag, bool avx2_flag)
+		{
+			return std::make_unique <fmtcl::Dither> (
+				fmt_src, res_src, full_src_flag,
+				fmt_dst, res_dst, full_dst_flag,
+				fmtcl::ColorFamily_YUV, nbr_planes, w,
+				dmode, pat_size, ampo, ampn,
+				dyn_flag, stat_flag, corr_flag, tpdfo_flag, tpdfn_flag,
+				sse2_flag, avx2_flag
+			);
+		};
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		{
+			auto           dither_uptr = create_dither (false, false);
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_ref_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+				);
+				auto &         dst = *dst_ref_arr.back ();
+				const auto &   src = *src_arr [p];
+				dst.fill_cst (0);
+				dither_uptr->process_plane (
+					dst.get_ptr (), dst.get_stride (),
+					src.get_ptr (), src.get_stride (),
+					w, h, frame_index, p
+				);
+			}
+		}
+
+		// Output of the first SIMD path (SSE2), the other ones must match it
+		// exactly.
+		std::vector <std::unique_ptr <PlaneBuf> > dst_sse2_arr;
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			auto           dither_uptr =
+				create_dither (cpu.has_sse2 (), cpu.has_avx2 ());
+			fmtcl::ProcComp3Arg  arg;
+			arg._w = w;
+			arg._h = h;
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+				);
+				auto &         dst = *dst_tst_arr.back ();
+				const auto &   src = *src_arr [p];
+				dst.fill_cst (0);
+				arg._dst [p] = fmtcl::Plane <> (dst.get_ptr (), int (dst.get_stride ()));
+				arg._src [p] = fmtcl::PlaneRO <> (src.get_ptr (), int (src.get_stride ()));
+			}
+
+			if (use_3p_flag && dither_uptr->can_process_3_planes ())
+			{
+				dither_uptr->process_3_planes (arg, frame_index);
+			}
+			else
+			{
+				for (int p = 0; p < nbr_planes; ++p)
+				{
+					dither_uptr->process_plane (
+						arg._dst [p]._ptr, arg._dst [p]._stride,
+						arg._src [p]._ptr, arg._src [p]._stride,
+						w, h, frame_index, p
+					);
+				}
+			}
+
+			Result &       result_cpp = (errdif_flag) ? result_ed : result_ord;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				result_cpp.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+			if (dst_sse2_arr.empty ())
+			{
+				dst_sse2_arr = std::move (dst_tst_arr);
+			}
+			else
+			{
+				for (int p = 0; p < nbr_planes; ++p)
+				{
+					result_simd.update (*dst_sse2_arr [p], *dst_tst_arr [p]);
+				}
+			}
+		}
+	}
+
+	const int      ret_ord  = result_ord.report ("Dither", 1, 0);
+	const int      ret_ed   = result_ed.report ("DitherErrDif", 0, 0);
+	const int      ret_simd = result_simd.report ("DitherSIMD", 0, 0);
+
+	return (ret_ord != 0) ? ret_ord : (ret_ed != 0) ? ret_ed : ret_simd;
+}
+
+
+// The LUT is sampled from a nonlinear processing: a matrix followed by a
+// power curve. The input planes exceed the LUT domain to check the clipping.
+int	TestSimdPaths::test_lut3d (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::Lut3d::_nbr_planes;
+
+	Result         result;
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const int      res = gen_int (rng, fmtcl::Lut3d::_min_res, 65);
+		fmtcl::Vec3    v_min;
+		fmtcl::Vec3    v_max;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			v_min [p] = gen_flt (rng, -0.5, 0.25);
+			v_max [p] = v_min [p] + gen_flt (rng, 0.25, 1.5);
+		}
+		std::array <std::array <float, nbr_planes>, nbr_planes> mat;
+		for (auto &row : mat)
+		{
+			for (auto &coef : row)
+			{
+				coef = float (gen_flt (rng, -1, 1));
+			}
+		}
+		const float    expo = float (gen_flt (rng, 0.4, 3.0));
+
+		const auto     fnc = [&mat, expo] (const fmtcl::ProcComp3Arg &arg)
+		{
+			fmtcl::Frame <float> d { arg._dst };
+			for (int y = 0; y < arg._h; ++y)
+			{
+				for (int x = 0; x < arg._w; ++x)
+				{
+					const std::array <float, nbr_planes> v
+					{{ d [0]._ptr [x], d [1]._ptr [x], d [2]._ptr [x] }};
+					for (int p = 0; p < nbr_planes; ++p)
+					{
+						const float    r =
+							mat [p] [0] * v [0] + mat [p] [1] * v [1] + mat [p] [2] * v [2];
+						d [p]._ptr [x] = std::copysign (std::pow (std::abs (r), expo), r);
+					}
+				}
+				d.step_line ();
+			}
+		};
+
+		const int      w = gen_int (rng, 1, 300);
+		const int      h = gen_int (rng, 1, 16);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		fmtcl::ProcComp3Arg  arg_ref;
+		arg_ref._w = w;
+		arg_ref._h = h;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmtcl::SplFmt_FLOAT, 32)
+			);
+			auto &         buf = *src_arr.back ();
+			buf.fill_rnd (rng, v_min [p] - 0.25, v_max [p] + 0.25);
+			arg_ref._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+		auto           arg_tst = arg_ref;
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			dst_ref_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmtcl::SplFmt_FLOAT, 32)
+			);
+			auto &         buf = *dst_ref_arr.back ();
+			buf.fill_cst (0);
+			arg_ref._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		const fmtcl::Lut3d   lut_ref (res, v_min, v_max, fnc, false, false);
+		lut_ref.process (arg_ref);
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmtcl::SplFmt_FLOAT, 32)
+				);
+				auto &         buf = *dst_tst_arr.back ();
+				buf.fill_cst (0);
+				arg_tst._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+			}
+
+			const fmtcl::Lut3d   lut (
+				res, v_min, v_max, fnc, cpu.has_sse2 (), cpu.has_avx2 ()
+			);
+			lut.process (arg_tst);
+
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				result.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+		}
+	}
+
+	return result.report ("Lut3d", 0, 1e-5);
+}
+
+
+// Random curve pairs, some of them linear. The width is large enough to
+// span several segments. Some iterations go through a 3D LUT.
+int	TestSimdPaths::test_primaries (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::PrimariesProc::_nbr_planes;
+
+	Result         result;
+
+	const std::array <fmtcl::TransCurve, 5> curve_arr
+	{{
+		fmtcl::TransCurve_UNDEF, fmtcl::TransCurve_LINEAR,
+		fmtcl::TransCurve_709, fmtcl::TransCurve_SRGB, fmtcl::TransCurve_2084
+	}};
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const auto     curve_s =
+			curve_arr [gen_int (rng, 0, int (curve_arr.size ()) - 1)];
+		const auto     curve_d =
+			curve_arr [gen_int (rng, 1, int (curve_arr.size ()) - 1)];
+		const int      res_src = pick (rng, { 16, 32 });
+		const int      res_dst = pick (rng, { 16, 32 });
+		const fmtcl::PicFmt  fmt_src {
+			(res_src == 32) ? fmtcl::SplFmt_FLOAT : fmtcl::SplFmt_INT16,
+			res_src, fmtcl::ColorFamily_RGB, true
+		};
+		const fmtcl::PicFmt  fmt_dst {
+			(res_dst == 32) ? fmtcl::SplFmt_FLOAT : fmtcl::SplFmt_INT16,
+			res_dst, fmtcl::ColorFamily_RGB, true
+		};
+		fmtcl::Mat4    mat (1.0, fmtcl::Mat4::Preset_DIAGONAL);
+		for (int y = 0; y < nbr_planes; ++y)
+		{
+			for (int x = 0; x < nbr_planes; ++x)
+			{
+				mat [y] [x] = (x == y) ? gen_flt (rng, 0.5, 1) : gen_flt (rng, -0.1, 0.25);
+			}
+		}
+
+		const int      lut3d_res =
+			(gen_int (rng, 0, 3) == 0) ? gen_int (rng, 17, 65) : 0;
+
+		const int      w = gen_int (rng, 1, 2500);
+		const int      h = gen_int (rng, 1, 4);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		fmtcl::ProcComp3Arg  arg_ref;
+		arg_ref._w = w;
+		arg_ref._h = h;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_src._sf, res_src)
+			);
+			auto &         buf = *src_arr.back ();
+			buf.fill_rnd (rng, 0, 1);
+			arg_ref._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+		auto           arg_tst = arg_ref;
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			dst_ref_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_dst._sf, res_dst)
+			);
+			auto &         buf = *dst_ref_arr.back ();
+			buf.fill_cst (0);
+			arg_ref._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		{
+			fmtcl::PrimariesProc proc_ref (false, false, false, false, false);
+			proc_ref.configure (
+				mat, fmt_dst, curve_d, fmt_src, curve_s, lut3d_res
+			);
+			proc_ref.process (arg_ref);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst._sf, res_dst)
+				);
+				auto &         buf = *dst_tst_arr.back ();
+				buf.fill_cst (0);
+				arg_tst._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+			}
+
+			fmtcl::PrimariesProc proc (
+				cpu.has_sse (), cpu.has_sse2 (), cpu.has_avx (), cpu.has_avx2 (),
+				cpu.has_avx512bw ()
+			);
+			proc.configure (
+				mat, fmt_dst, curve_d, fmt_src, curve_s, lut3d_res
+			);
+			proc.process (arg_tst);
+
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				result.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+		}
+	}
+
+	return result.report ("PrimariesProc", 1, 1e-5);
+}
+
+
+
+// Random gamma and alpha, covering the integer and the float amplitude
+// paths. Negative float input checks the sign handling.
+int	TestSimdPaths::test_gammay (Rng &rng)
+{
+	constexpr int  nbr_planes = fmtcl::GammaY::_nbr_planes;
+
+	Result         result;
+
+	for (int it = 0; it < _nbr_iter; ++it)
+	{
+		const int      res_src = pick (rng, { 8, 9, 10, 11, 12, 14, 16, 32 });
+		const int      res_dst = pick (rng, { 16, 32 });
+		const auto     fmt_src =
+			(res_src == 32) ? fmtcl::SplFmt_FLOAT : get_int_fmt (res_src);
+		const auto     fmt_dst =
+			(res_dst == 32) ? fmtcl::SplFmt_FLOAT : fmtcl::SplFmt_INT16;
+		const double   gamma   = gen_flt (rng, 0.75, 1.5);
+		const double   alpha   = gen_flt (rng, 0.25, 3.0);
+		const double   v_min   = (res_src == 32) ? -0.25 : 0.0;
+
+		const int      w = gen_int (rng, 1, 2500);
+		const int      h = gen_int (rng, 1, 4);
+
+		std::vector <std::unique_ptr <PlaneBuf> > src_arr;
+		fmtcl::ProcComp3Arg  arg_ref;
+		arg_ref._w = w;
+		arg_ref._h = h;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			src_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_src, res_src)
+			);
+			auto &         buf = *src_arr.back ();
+			buf.fill_rnd (rng, v_min, 1);
+			arg_ref._src [p] = fmtcl::PlaneRO <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+		auto           arg_tst = arg_ref;
+
+		std::vector <std::unique_ptr <PlaneBuf> > dst_ref_arr;
+		for (int p = 0; p < nbr_planes; ++p)
+		{
+			dst_ref_arr.emplace_back (
+				std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+			);
+			auto &         buf = *dst_ref_arr.back ();
+			buf.fill_cst (0);
+			arg_ref._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+		}
+
+		{
+			fmtcl::GammaY  proc_ref (
+				fmt_src, res_src, fmt_dst, res_dst, gamma, alpha,
+				false, false, false
+			);
+			proc_ref.process_plane (arg_ref._dst, arg_ref._src, w, h);
+		}
+
+		for (const auto &path : _path_arr)
+		{
+			fmtcl::CpuOptBase cpu;
+			if (! setup_path (cpu, path))
+			{
+				continue;
+			}
+
+			std::vector <std::unique_ptr <PlaneBuf> > dst_tst_arr;
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				dst_tst_arr.emplace_back (
+					std::make_unique <PlaneBuf> (rng, w, h, fmt_dst, res_dst)
+				);
+				auto &         buf = *dst_tst_arr.back ();
+				buf.fill_cst (0);
+				arg_tst._dst [p] = fmtcl::Plane <> (buf.get_ptr (), int (buf.get_stride ()));
+			}
+
+			fmtcl::GammaY  proc (
+				fmt_src, res_src, fmt_dst, res_dst, gamma, alpha,
+				cpu.has_sse2 (), cpu.has_avx2 (), cpu.has_avx512bw ()
+			);
+			proc.process_plane (arg_tst._dst, arg_tst._src, w, h);
+
+			for (int p = 0; p < nbr_planes; ++p)
+			{
+				result.update (*dst_ref_arr [p], *dst_tst_arr [p]);
+			}
+		}
+	}
+
+	return result.report ("GammaY", 0, 0);
+}
+
+
+
+void	TestSimdPaths::run_scaler (const fmtcl::Scaler &scaler, bool h_flag, bool int_flag, PlaneBuf &dst, const PlaneBuf &src)
+{
+	if (int_flag)
+	{
+		run_scaler_int (scaler, h_flag, dst, src);
+		return;
+	}
+
+	switch ((dst.get_fmt () << 4) + src.get_fmt ())
+	{
+	case (fmtcl::SplFmt_FLOAT << 4) + fmtcl::SplFmt_FLOAT:
+		run_scaler_flt <float   , float   > (scaler, h_flag, dst, src);
+		break;
+	case (fmtcl::SplFmt_FLOAT << 4) + fmtcl::SplFmt_INT16:
+		run_scaler_flt <float   , uint16_t> (scaler, h_flag, dst, src);
+		break;
+	case (fmtcl::SplFmt_FLOAT << 4) + fmtcl::SplFmt_INT8:
+		run_scaler_flt <float   , uint8_t > (scaler, h_flag, dst, src);
+		break;
+	case (fmtcl::SplFmt_INT16 << 4) + fmtcl::SplFmt_FLOAT:
+		run_scaler_flt <uint16_t, float   > (scaler, h_flag, dst, src);
+		break;
+	case (fmtcl::SplFmt_INT16 << 4) + fmtcl::SplFmt_INT16:
+		run_scaler_flt <uint16_t, uint16_t> (scaler, h_flag, dst, src);
+		break;
+	case (fmtcl::SplFmt_INT16 << 4) + fmtcl::SplFmt_INT8:
+		run_scaler_flt <uint16_t, uint8_t > (scaler, h_flag, dst, src);
+		break;
+	default:
+		assert (false);
+		break;
+	}
+}
+
+
+
+template <typename TD, typename TS>
+void	TestSimdPaths::run_scaler_flt (const fmtcl::Scaler &scaler, bool h_flag, PlaneBuf &dst, const PlaneBuf &src)
+{
+	const auto     d_ptr = reinterpret_cast <TD *> (dst.get_ptr ());
+	const auto     s_ptr = reinterpret_cast <const TS *> (src.get_ptr ());
+	const auto     ds    = dst.get_stride_pix ();
+	const auto     ss    = src.get_stride_pix ();
+	if (h_flag)
+	{
+		scaler.process_plane_h_flt (d_ptr, s_ptr, ds, ss, dst.get_h (), 0, dst.get_w ());
+	}
+	else
+	{
+		scaler.process_plane_flt (d_ptr, s_ptr, ds, ss, dst.get_w (), 0, dst.get_h ());
+	}
+}
+
+
+
+// Output is always 16 bits
+void	TestSimdPaths::run_scaler_int (const fmtcl::Scaler &scaler, bool h_flag, PlaneBuf &dst, const PlaneBuf &src)
+{
+	assert (dst.get_fmt () == fmtcl::SplFmt_INT16);
+	assert (dst.get_res () == 16);
+
+	const auto     d_ptr = reinterpret_cast <uint16_t *> (dst.get_ptr ());
+	const auto     ds    = dst.get_stride_pix ();
+	const auto     ss    = src.get_stride_pix ();
+	const int      w     = dst.get_w ();
+	const int      h     = dst.get_h ();
+
+#define TestSimdPaths_CASE(SB, ST, FN) \
+	case SB: \
+		if (h_flag) \
+		{ \
+			scaler.process_plane_h_int_##FN ( \
+				d_ptr, reinterpret_cast <const ST *> (src.get_ptr ()), \
+				ds, ss, h, 0, w \
+			); \
+		} \
+		else \
+		{ \
+			scaler.process_plane_int_##FN ( \
+				d_ptr, reinterpret_cast <const ST *> (src.get_ptr ()), \
+				ds, ss, w, 0, h \
+			); \
+		} \
+		break;
+
+	switch (src.get_res ())
+	{
+	TestSimdPaths_CASE (16, uint16_t, i16_i16)
+	TestSimdPaths_CASE (14, uint16_t, i16_i14)
+	TestSimdPaths_CASE (12, uint16_t, i16_i12)
+	TestSimdPaths_CASE (10, uint16_t, i16_i10)
+	TestSimdPaths_CASE ( 9, uint16_t, i16_i09)
+	TestSimdPaths_CASE ( 8, uint8_t , i16_i08)
+	default:
+		assert (false);
+		break;
+	}
+
+#undef TestSimdPaths_CASE
+}
+
+
+
+// Returns false if the path is not available on this CPU
+bool	TestSimdPaths::setup_path (fmtcl::CpuOptBase &cpu, const Path &path)
+{
+	cpu.set_level (path._level);
+
+	switch (path._level)
+	{
+	case fmtcl::CpuOptBase::Level_SSE2:    return cpu.has_sse2 ();
+	case fmtcl::CpuOptBase::Level_AVX2:    return cpu.has_avx2 ();
+	case fmtcl::CpuOptBase::Level_AVX512F: return cpu.has_avx512bw ();
+	default:
+		assert (false);
+		break;
+	}
+
+	return false;
+}
+
+
+
+// Both bounds included
+int	TestSimdPaths::gen_int (Rng &rng, int v_min, int v_max)
+{
+	assert (v_min <= v_max);
+
+	std::uniform_int_distribution <int> dist (v_min, v_max);
+
+	return dist (rng);
+}
+
+
+
+double	TestSimdPaths::gen_flt (Rng &rng, double v_min, double v_max)
+{
+	assert (v_min <= v_max);
+
+	std::uniform_real_distribution <double> dist (v_min, v_max);
+
+	return dist (rng);
+}
+
+
+
+int	TestSimdPaths::pick (Rng &rng, const std::vector <int> &val_arr)
+{
+	assert (! val_arr.empty ());
+
+	return val_arr [gen_int (rng, 0, int (val_arr.size ()) - 1)];
+}
+
+
+
+fmtcl::SplFmt	TestSimdPaths::get_int_fmt (int res)
+{
+	assert (res >= 8);
+	assert (res <= 16);
+
+	return (res > 8) ? fmtcl::SplFmt_INT16 : fmtcl::SplFmt_INT8;
+}
+
+
+
+// Turns one third of the float configurations into half-float ones.
+// Other formats are left untouched.
+void	TestSimdPaths::pick_fp16 (Rng &rng, fmtcl::SplFmt &fmt, int &res)
+{
+	if (fmt == fmtcl::SplFmt_FLOAT && gen_int (rng, 0, 2) == 0)
+	{
+		fmt = fmtcl::SplFmt_FLOAT16;
+		res = 16;
+	}
+}
+
+
+
+// The C++ path is the reference and is not listed here
+const std::vector <TestSimdPaths::Path>	TestSimdPaths::_path_arr
+{
+	{ "sse2"  , fmtcl::CpuOptBase::Level_SSE2    },
+	{ "avx2"  , fmtcl::CpuOptBase::Level_AVX2    },
+	{ "avx512", fmtcl::CpuOptBase::Level_AVX512F }
+};
+
+constexpr int	TestSimdPaths::_nbr_iter;
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
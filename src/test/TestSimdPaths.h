@@ -0,0 +1,213 @@
+/*****************************************************************************
+
+        TestSimdPaths.h
+        Author: Laurent de Soras, 2024
+
+Checks that the SSE2, AVX2 and AVX-512 implementations of the engines match
+the C++ reference code. Each engine is run on randomized sample formats, sizes,
+strides and plane alignments, with a fixed seed so failures can be
+reproduced.
+
+Plane pointers and strides are multiples of 64 bytes, like the frame planes
+allocated by VapourSynth and AviSynth+. Within this constraint, the stride
+padding and the plane position in the buffer are random. The float Scaler
+AVX2 code requires strides multiple of 16 pixels. The AVX-512 path enables
+the AVX-512 code where it exists and AVX2 elsewhere.
+
+Deviations are measured against the C++ path output. The tolerances are:
+- Integer output: in LSB of the output bitdepth.
+- Floating point output: absolute, relative to the nominal [0 ; 1] range.
+
+	Engine       Integer  Float
+	BitBltConv      1      1e-6
+	Scaler          1      1e-5
+	MatrixProc      1      1e-5
+	TransLut        0      1e-5
+	TransDirect     -      1e-5
+	Dither          1        -
+	DitherErrDif    0        -
+	DitherSIMD      0        -
+	Lut3d           -      1e-5
+	PrimariesProc   1      1e-5
+
+The 1 LSB integer deviations are expected. The SIMD float-to-integer
+conversions round ties to even, and the SIMD dithering draws its noise
+in a different order from the same generator.
+
+Dither covers the ordered and noise-based methods. DitherErrDif covers the
+error diffusion methods. Their SIMD code (3 planes at once) follows the
+pixel order and arithmetic of the C++ code, so a single LSB of divergence
+would propagate and must be caught.
+
+DitherSIMD compares the AVX2 and AVX-512 dithering outputs with the SSE2
+one. The AVX2 kernels consume the noise generator per group of 8 pixels,
+exactly like the SSE2 code, so these outputs must be identical.
+
+TransDirect is the table-free float mode of TransLut. It has no C++
+counterpart and is checked against the double precision transfer curves.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#pragma once
+#if ! defined (TestSimdPaths_HEADER_INCLUDED)
+#define TestSimdPaths_HEADER_INCLUDED
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fmtcl/CpuOptBase.h"
+#include "fmtcl/Scaler.h"
+#include "fmtcl/SplFmt.h"
+#include "fstb/AllocAlign.h"
+
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+
+
+class TestSimdPaths
+{
+
+/*\\\ PUBLIC \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+public:
+
+	static int     perform_test ();
+
+
+
+/*\\\ PROTECTED \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+protected:
+
+
+
+/*\\\ PRIVATE \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	typedef std::minstd_rand Rng;
+
+	class Path
+	{
+	public:
+		const char *   _name_0;
+		fmtcl::CpuOptBase::Level
+		               _level;
+	};
+
+	// Plane with a random alignment offset and stride padding
+	class PlaneBuf
+	{
+	public:
+		explicit       PlaneBuf (Rng &rng, int w, int h, fmtcl::SplFmt fmt, int res);
+		void           fill_rnd (Rng &rng, double v_min, double v_max);
+		void           fill_cst (uint8_t val);
+		void           fill_int (int val);
+		uint8_t *      get_ptr () noexcept;
+		const uint8_t* get_ptr () const noexcept;
+		ptrdiff_t      get_stride () const noexcept; // Bytes
+		ptrdiff_t      get_stride_pix () const noexcept;
+		int            get_w () const noexcept { return _w; }
+		int            get_h () const noexcept { return _h; }
+		fmtcl::SplFmt  get_fmt () const noexcept { return _fmt; }
+		int            get_res () const noexcept { return _res; }
+	private:
+		static constexpr int _align    = 64;  // Bytes
+		static constexpr int _margin_b = 256; // Bytes, beginning and end of lines
+		static constexpr int _margin_l = 8;   // Lines, top and bottom
+		std::vector <uint8_t, fstb::AllocAlign <uint8_t, 64> >
+		               _buf;
+		int            _w       = 0;
+		int            _h       = 0;
+		fmtcl::SplFmt  _fmt     = fmtcl::SplFmt_ILLEGAL;
+		int            _res     = 0;
+		int            _unit_sz = 0;
+		ptrdiff_t      _stride  = 0;
+		ptrdiff_t      _offset  = 0;
+	};
+
+	// Maximum deviations for an engine
+	class Result
+	{
+	public:
+		void           update (const PlaneBuf &ref, const PlaneBuf &tst);
+		int            report (const char *engine_0, int tol_int, double tol_flt) const;
+		static double  get_fp16_step (uint16_t x) noexcept;
+		int            _nbr_cmp  = 0;
+		int            _dev_int  = 0;
+		double         _dev_flt  = 0;
+	};
+
+	static int     test_bitblt (Rng &rng);
+	static int     test_scaler (Rng &rng);
+	static int     test_resize (Rng &rng);
+	static int     test_matrix (Rng &rng);
+	static int     test_m2020cl (Rng &rng);
+	static int     test_translut (Rng &rng);
+	static int     test_transdirect (Rng &rng);
+	static int     test_dither (Rng &rng);
+	static int     test_lut3d (Rng &rng);
+	static int     test_primaries (Rng &rng);
+	static int     test_gammay (Rng &rng);
+
+	static void    run_scaler (const fmtcl::Scaler &scaler, bool h_flag, bool int_flag, PlaneBuf &dst, const PlaneBuf &src);
+	template <typename TD, typename TS>
+	static void    run_scaler_flt (const fmtcl::Scaler &scaler, bool h_flag, PlaneBuf &dst, const PlaneBuf &src);
+	static void    run_scaler_int (const fmtcl::Scaler &scaler, bool h_flag, PlaneBuf &dst, const PlaneBuf &src);
+
+	static bool    setup_path (fmtcl::CpuOptBase &cpu, const Path &path);
+	static int     gen_int (Rng &rng, int v_min, int v_max);
+	static double  gen_flt (Rng &rng, double v_min, double v_max);
+	static int     pick (Rng &rng, const std::vector <int> &val_arr);
+	static fmtcl::SplFmt
+	               get_int_fmt (int res);
+	static void    pick_fp16 (Rng &rng, fmtcl::SplFmt &fmt, int &res);
+
+	static const std::vector <Path>
+	               _path_arr;
+	static constexpr int
+	               _nbr_iter = 40;  // Random configurations per engine
+
+
+
+/*\\\ FORBIDDEN MEMBER FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+private:
+
+	               TestSimdPaths ()                               = delete;
+	               TestSimdPaths (const TestSimdPaths &other)     = delete;
+	               TestSimdPaths (TestSimdPaths &&other)          = delete;
+	TestSimdPaths &
+	               operator = (const TestSimdPaths &other)        = delete;
+	TestSimdPaths &
+	               operator = (TestSimdPaths &&other)             = delete;
+	bool           operator == (const TestSimdPaths &other) const = delete;
+	bool           operator != (const TestSimdPaths &other) const = delete;
+
+}; // class TestSimdPaths
+
+
+
+//#include "test/TestSimdPaths.hpp"
+
+
+
+#endif   // TestSimdPaths_HEADER_INCLUDED
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,85 @@
+/*****************************************************************************
+
+        main-bench.cpp
+        Author: Laurent de Soras, 2024
+
+Entry point for the engine benchmark.
+
+Usage: fmtclbench [engine_filter [min_duration_s]]
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "test/BenchEngines.h"
+
+#include <exception>
+#include <iostream>
+
+#include <cstdlib>
+
+
+
+/*\\\ FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+int main (int argc, char *argv [])
+{
+	const char *   filter_0 = "";
+	double         min_dur  = 0.1;
+	if (argc > 1)
+	{
+		filter_0 = argv [1];
+	}
+	if (argc > 2)
+	{
+		min_dur = atof (argv [2]);
+		if (min_dur <= 0)
+		{
+			std::cerr << "*** Minimum duration must be positive. ***" << std::endl;
+			return -1;
+		}
+	}
+
+	int            ret_val = 0;
+
+	try
+	{
+		ret_val = BenchEngines::perform_bench (filter_0, min_dur);
+	}
+
+	catch (std::exception &e)
+	{
+		std::cerr << "*** main() : Exception (std::exception) : " << e.what () << std::endl;
+		ret_val = -1;
+	}
+
+	catch (...)
+	{
+		std::cerr << "*** main() : Undefined exception" << std::endl;
+		ret_val = -1;
+	}
+
+	return ret_val;
+}
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
@@ -0,0 +1,75 @@
+/*****************************************************************************
+
+        main-simdtest.cpp
+        Author: Laurent de Soras, 2024
+
+Entry point for the SIMD path consistency test.
+
+Returns 0 if all the SIMD paths match the C++ reference.
+
+--- Legal stuff ---
+
+This program is free software. It comes without any warranty, to
+the extent permitted by applicable law. You can redistribute it
+and/or modify it under the terms of the Do What The Fuck You Want
+To Public License, Version 2, as published by Sam Hocevar. See
+http://www.wtfpl.net/ for more details.
+
+*Tab=3***********************************************************************/
+
+
+
+#if defined (_MSC_VER)
+	#pragma warning (4 : 4786 4800)
+#endif
+
+
+
+/*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+#include "fstb/def.h"
+#include "test/TestConvertProc.h"
+#include "test/TestSimdPaths.h"
+
+#include <exception>
+#include <iostream>
+
+
+
+/*\\\ FUNCTIONS \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+
+
+
+int main (int argc, char *argv [])
+{
+	fstb::unused (argc, argv);
+
+	int            ret_val = 0;
+
+	try
+	{
+		ret_val = TestSimdPaths::perform_test ();
+		if (ret_val == 0)
+		{
+			ret_val = TestConvertProc::perform_test ();
+		}
+	}
+
+	catch (std::exception &e)
+	{
+		std::cerr << "*** main() : Exception (std::exception) : " << e.what () << std::endl;
+		ret_val = -1;
+	}
+
+	catch (...)
+	{
+		std::cerr << "*** main() : Undefined exception" << std::endl;
+		ret_val = -1;
+	}
+
+	return ret_val;
+}
+
+
+
+/*\\\ EOF \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
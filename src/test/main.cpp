@@ -24,9 +24,12 @@ http://www.wtfpl.net/ for more details.
 /*\\\ INCLUDE FILES \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 
 #include "fstb/def.h"
+#include "test/BenchEngines.h"
 #include "test/GenTestPat.h"
 #include "test/PrecalcVoidAndCluster.h"
+#include "test/TestConvertProc.h"
 #include "test/TestGammaY.h"
+#include "test/TestSimdPaths.h"
 
 #if defined (_MSC_VER)
 #include <crtdbg.h>
@@ -178,6 +181,10 @@ int main (int argc, char *argv [])
 		auto           files = PrecalcVoidAndCluster::build_all ();
 		printf ("%s\n%s\n", files._header.c_str (), files._code.c_str ());
 
+#elif 0
+		// Engine benchmark. The unix build has a dedicated fmtclbench target.
+		if (ret_val == 0) { ret_val = BenchEngines::perform_bench ("", 0.1); }
+
 #elif 1
 
 		// Test patterns
@@ -186,7 +193,11 @@ int main (int argc, char *argv [])
 #else
 		// Standard tests
 		if (ret_val == 0) { ret_val = TestGammaY::perform_test (); }
+		if (ret_val == 0) { ret_val = TestSimdPaths::perform_test (); }
+		if (ret_val == 0) { ret_val = TestConvertProc::perform_test (); }
 		if (ret_val == 0) { PrecalcVoidAndCluster::generate_mat (6, false); }
+		if (ret_val == 0) { ret_val = PrecalcVoidAndCluster::check_mat (10, false); }
+		if (ret_val == 0) { ret_val = PrecalcVoidAndCluster::check_mat (10, true); }
 
 #endif
 